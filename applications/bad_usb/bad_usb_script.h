@@ -26,6 +26,7 @@ typedef struct {
     uint16_t line_nb;
     uint32_t delay_remain;
     uint16_t error_line;
+    uint16_t char_rate; // Measured STRING typing rate, chars per second
 } BadUsbState;
 
 BadUsbScript* bad_usb_script_open(string_t file_path);
@@ -0,0 +1,480 @@
+#include "ducky_bytecode.h"
+#include <furi.h>
+#include <furi_hal_usb_hid.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DUCKY_WORD_LEN_MAX 15
+#define DUCKY_PARAM_LEN_MAX 31
+#define DUCKY_STRING_LEN_MAX UINT16_MAX
+#define DUCKY_CODE_SIZE_INIT 256
+#define DUCKY_CODE_SIZE_MAX (32 * 1024)
+
+typedef struct {
+    const char* name;
+    DuckyOp op;
+    uint16_t keycode;
+} DuckyKeyword;
+
+static const DuckyKeyword ducky_keywords[] = {
+    {"DELAY", DuckyOpDelay, 0},
+    {"STRING", DuckyOpString, 0},
+    {"DEFAULT_DELAY", DuckyOpDefaultDelay, 0},
+    {"DEFAULTDELAY", DuckyOpDefaultDelay, 0},
+    {"REPEAT", DuckyOpRepeat, 0},
+    {"ALTCHAR", DuckyOpAltChar, 0},
+    {"ALTSTRING", DuckyOpAltString, 0},
+    {"ALTCODE", DuckyOpAltString, 0},
+    {"STRING_DELAY", DuckyOpStringDelay, 0},
+    {"STRINGDELAY", DuckyOpStringDelay, 0},
+
+    {"CTRL-ALT", DuckyOpKey, KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_ALT},
+    {"CTRL-SHIFT", DuckyOpKey, KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_SHIFT},
+    {"ALT-SHIFT", DuckyOpKey, KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_SHIFT},
+    {"ALT-GUI", DuckyOpKey, KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_GUI},
+
+    {"CTRL", DuckyOpKey, KEY_MOD_LEFT_CTRL},
+    {"CONTROL", DuckyOpKey, KEY_MOD_LEFT_CTRL},
+    {"SHIFT", DuckyOpKey, KEY_MOD_LEFT_SHIFT},
+    {"ALT", DuckyOpKey, KEY_MOD_LEFT_ALT},
+    {"GUI", DuckyOpKey, KEY_MOD_LEFT_GUI},
+    {"WINDOWS", DuckyOpKey, KEY_MOD_LEFT_GUI},
+
+    {"DOWNARROW", DuckyOpKey, KEY_DOWN_ARROW},
+    {"DOWN", DuckyOpKey, KEY_DOWN_ARROW},
+    {"LEFTARROW", DuckyOpKey, KEY_LEFT_ARROW},
+    {"LEFT", DuckyOpKey, KEY_LEFT_ARROW},
+    {"RIGHTARROW", DuckyOpKey, KEY_RIGHT_ARROW},
+    {"RIGHT", DuckyOpKey, KEY_RIGHT_ARROW},
+    {"UPARROW", DuckyOpKey, KEY_UP_ARROW},
+    {"UP", DuckyOpKey, KEY_UP_ARROW},
+
+    {"ENTER", DuckyOpKey, KEY_ENTER},
+    {"BREAK", DuckyOpKey, KEY_PAUSE},
+    {"PAUSE", DuckyOpKey, KEY_PAUSE},
+    {"CAPSLOCK", DuckyOpKey, KEY_CAPS_LOCK},
+    {"DELETE", DuckyOpKey, KEY_DELETE},
+    {"BACKSPACE", DuckyOpKey, KEY_BACKSPACE},
+    {"END", DuckyOpKey, KEY_END},
+    {"ESC", DuckyOpKey, KEY_ESC},
+    {"ESCAPE", DuckyOpKey, KEY_ESC},
+    {"HOME", DuckyOpKey, KEY_HOME},
+    {"INSERT", DuckyOpKey, KEY_INSERT},
+    {"NUMLOCK", DuckyOpKey, KEY_NUM_LOCK},
+    {"PAGEUP", DuckyOpKey, KEY_PAGE_UP},
+    {"PAGEDOWN", DuckyOpKey, KEY_PAGE_DOWN},
+    {"PRINTSCREEN", DuckyOpKey, KEY_PRINT},
+    {"SCROLLOCK", DuckyOpKey, KEY_SCROLL_LOCK},
+    {"SPACE", DuckyOpKey, KEY_SPACE},
+    {"TAB", DuckyOpKey, KEY_TAB},
+    {"MENU", DuckyOpKey, KEY_APPLICATION},
+    {"APP", DuckyOpKey, KEY_APPLICATION},
+
+    {"F1", DuckyOpKey, KEY_F1},
+    {"F2", DuckyOpKey, KEY_F2},
+    {"F3", DuckyOpKey, KEY_F3},
+    {"F4", DuckyOpKey, KEY_F4},
+    {"F5", DuckyOpKey, KEY_F5},
+    {"F6", DuckyOpKey, KEY_F6},
+    {"F7", DuckyOpKey, KEY_F7},
+    {"F8", DuckyOpKey, KEY_F8},
+    {"F9", DuckyOpKey, KEY_F9},
+    {"F10", DuckyOpKey, KEY_F10},
+    {"F11", DuckyOpKey, KEY_F11},
+    {"F12", DuckyOpKey, KEY_F12},
+};
+
+/* Perfect hash: top byte of FNV-1a with this offset basis has no collisions for
+ * the keywords above. Seed and table must be regenerated when keywords change,
+ * ducky_bytecode_test checks that every keyword is found. */
+#define DUCKY_KEYWORD_HASH_SEED 467
+
+// Keyword index + 1 by hash, 0 for empty slot
+static const uint8_t ducky_keyword_table[256] = {
+    [0x74] = 1, // DELAY
+    [0xCA] = 2, // STRING
+    [0xB2] = 3, // DEFAULT_DELAY
+    [0xC1] = 4, // DEFAULTDELAY
+    [0xFE] = 5, // REPEAT
+    [0x3E] = 6, // ALTCHAR
+    [0x11] = 7, // ALTSTRING
+    [0x2F] = 8, // ALTCODE
+    [0x07] = 9, // STRING_DELAY
+    [0x1B] = 10, // STRINGDELAY
+    [0x42] = 11, // CTRL-ALT
+    [0x18] = 12, // CTRL-SHIFT
+    [0x3B] = 13, // ALT-SHIFT
+    [0xD9] = 14, // ALT-GUI
+    [0x73] = 15, // CTRL
+    [0x5F] = 16, // CONTROL
+    [0x8C] = 17, // SHIFT
+    [0xA9] = 18, // ALT
+    [0x28] = 19, // GUI
+    [0xA6] = 20, // WINDOWS
+    [0xFC] = 21, // DOWNARROW
+    [0xC7] = 22, // DOWN
+    [0xEB] = 23, // LEFTARROW
+    [0x1C] = 24, // LEFT
+    [0xB4] = 25, // RIGHTARROW
+    [0x80] = 26, // RIGHT
+    [0x9A] = 27, // UPARROW
+    [0x97] = 28, // UP
+    [0xF2] = 29, // ENTER
+    [0x64] = 30, // BREAK
+    [0xA4] = 31, // PAUSE
+    [0x5A] = 32, // CAPSLOCK
+    [0x5D] = 33, // DELETE
+    [0x40] = 34, // BACKSPACE
+    [0xFA] = 35, // END
+    [0x39] = 36, // ESC
+    [0xE9] = 37, // ESCAPE
+    [0xEA] = 38, // HOME
+    [0x05] = 39, // INSERT
+    [0x08] = 40, // NUMLOCK
+    [0x79] = 41, // PAGEUP
+    [0xB7] = 42, // PAGEDOWN
+    [0xCE] = 43, // PRINTSCREEN
+    [0xB1] = 44, // SCROLLOCK
+    [0xE1] = 45, // SPACE
+    [0xAE] = 46, // TAB
+    [0xD2] = 47, // MENU
+    [0x95] = 48, // APP
+    [0x50] = 49, // F1
+    [0x4F] = 50, // F2
+    [0x4E] = 51, // F3
+    [0x4D] = 52, // F4
+    [0x4C] = 53, // F5
+    [0x4B] = 54, // F6
+    [0x4A] = 55, // F7
+    [0x49] = 56, // F8
+    [0x48] = 57, // F9
+    [0x8D] = 58, // F10
+    [0x8E] = 59, // F11
+    [0x8B] = 60, // F12
+};
+
+static const char ducky_cmd_comment[] = {"REM"};
+
+typedef enum {
+    DuckyLineStart,
+    DuckyLineWord,
+    DuckyLineParam,
+    DuckyLineString,
+    DuckyLineComment,
+} DuckyLineState;
+
+struct DuckyCompiler {
+    uint8_t* code;
+    size_t code_size;
+    size_t code_capacity;
+
+    DuckyLineState state;
+    size_t line_len;
+    char word[DUCKY_WORD_LEN_MAX + 1];
+    uint8_t word_len;
+    char param[DUCKY_PARAM_LEN_MAX + 1];
+    uint8_t param_len;
+    const DuckyKeyword* keyword;
+    size_t string_len_pos;
+    uint16_t string_len;
+
+    uint16_t line_nb;
+    uint16_t error_line;
+    bool repeat_allowed;
+};
+
+static const DuckyKeyword* ducky_keyword_find(const char* word) {
+    uint32_t hash = DUCKY_KEYWORD_HASH_SEED;
+    for(const char* c = word; *c != '\0'; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619UL;
+    }
+    uint8_t index = ducky_keyword_table[hash >> 24];
+    if(index == 0) return NULL;
+    const DuckyKeyword* keyword = &ducky_keywords[index - 1];
+    return (strcmp(keyword->name, word) == 0) ? keyword : NULL;
+}
+
+static bool ducky_get_number(const char* param, uint32_t* val) {
+    char* end = NULL;
+    uint32_t value = strtoul(param, &end, 10);
+    if(end != param) {
+        *val = value;
+        return true;
+    }
+    return false;
+}
+
+static bool ducky_emit(DuckyCompiler* compiler, const void* data, size_t size) {
+    if(size == 0) return true;
+    if(compiler->code_size + size > compiler->code_capacity) {
+        if(compiler->code_size + size > DUCKY_CODE_SIZE_MAX) return false;
+        size_t capacity = compiler->code_capacity * 2;
+        while(capacity < compiler->code_size + size) capacity *= 2;
+        if(capacity > DUCKY_CODE_SIZE_MAX) capacity = DUCKY_CODE_SIZE_MAX;
+        compiler->code = realloc(compiler->code, capacity);
+        compiler->code_capacity = capacity;
+    }
+    memcpy(&compiler->code[compiler->code_size], data, size);
+    compiler->code_size += size;
+    return true;
+}
+
+static bool ducky_emit_op(DuckyCompiler* compiler, DuckyOp op) {
+    uint8_t op_byte = op;
+    return ducky_emit(compiler, &op_byte, 1);
+}
+
+// Bytecode is a byte stream, values are stored little-endian without alignment
+static bool ducky_emit_u16(DuckyCompiler* compiler, DuckyOp op, uint16_t value) {
+    uint8_t data[3] = {op, value, value >> 8};
+    return ducky_emit(compiler, data, sizeof(data));
+}
+
+static bool ducky_emit_u32(DuckyCompiler* compiler, DuckyOp op, uint32_t value) {
+    uint8_t data[5] = {op, value, value >> 8, value >> 16, value >> 24};
+    return ducky_emit(compiler, data, sizeof(data));
+}
+
+static bool ducky_emit_data(DuckyCompiler* compiler, DuckyOp op, const char* data, uint16_t len) {
+    uint8_t header[3] = {op, len, len >> 8};
+    return ducky_emit(compiler, header, sizeof(header)) && ducky_emit(compiler, data, len);
+}
+
+static uint16_t ducky_get_param_keycode(const char* param) {
+    char key_name[DUCKY_WORD_LEN_MAX + 1];
+    size_t len = 0;
+    while((param[len] != ' ') && (param[len] != '\0') && (len < DUCKY_WORD_LEN_MAX)) {
+        key_name[len] = param[len];
+        len++;
+    }
+    key_name[len] = '\0';
+
+    const DuckyKeyword* keyword = ducky_keyword_find(key_name);
+    if((keyword) && (keyword->op == DuckyOpKey)) return keyword->keycode;
+    if(len > 0) return (HID_ASCII_TO_KEY(param[0]) & 0xFF);
+    return KEY_NONE;
+}
+
+static void ducky_word_end(DuckyCompiler* compiler, bool has_param) {
+    compiler->word[compiler->word_len] = '\0';
+    if(strncmp(compiler->word, ducky_cmd_comment, strlen(ducky_cmd_comment)) == 0) {
+        compiler->state = DuckyLineComment;
+        return;
+    }
+
+    compiler->keyword = ducky_keyword_find(compiler->word);
+    if((has_param) && (compiler->keyword) &&
+       ((compiler->keyword->op == DuckyOpString) || (compiler->keyword->op == DuckyOpAltString))) {
+        // String is copied to bytecode as it comes, length is patched on line end
+        compiler->string_len_pos = compiler->code_size + 1;
+        compiler->string_len = 0;
+        compiler->state = DuckyLineString;
+        if(!ducky_emit_data(compiler, compiler->keyword->op, NULL, 0)) {
+            compiler->keyword = NULL;
+            compiler->state = DuckyLineParam;
+        }
+    } else {
+        compiler->state = DuckyLineParam;
+    }
+}
+
+static bool ducky_compile_param(DuckyCompiler* compiler) {
+    const DuckyKeyword* keyword = compiler->keyword;
+    const char* param = compiler->param;
+    uint32_t value = 0;
+    compiler->param[compiler->param_len] = '\0';
+
+    if(keyword == NULL) return false;
+
+    switch(keyword->op) {
+    case DuckyOpDelay:
+        if((compiler->param_len == 0) || (!ducky_get_number(param, &value)) || (value == 0))
+            return false;
+        return ducky_emit_u32(compiler, DuckyOpDelay, value);
+    case DuckyOpDefaultDelay:
+    case DuckyOpStringDelay:
+        if((compiler->param_len == 0) || (!ducky_get_number(param, &value))) return false;
+        return ducky_emit_u32(compiler, keyword->op, value);
+    case DuckyOpRepeat:
+        if((compiler->param_len == 0) || (!ducky_get_number(param, &value))) return false;
+        if(!compiler->repeat_allowed) return false;
+        return ducky_emit_u32(compiler, DuckyOpRepeat, value);
+    case DuckyOpAltChar: {
+        uint8_t len = 0;
+        while((param[len] >= '0') && (param[len] <= '9')) len++;
+        if((len == 0) || ((param[len] != ' ') && (param[len] != '\0'))) return false;
+        return ducky_emit_data(compiler, DuckyOpAltChar, param, len);
+    }
+    case DuckyOpKey: {
+        uint16_t key = keyword->keycode;
+        if((key & 0xFF00) != 0) {
+            // Modifier can be followed by a key name or a character
+            key |= ducky_get_param_keycode(param);
+        }
+        return ducky_emit_u16(compiler, DuckyOpKey, key);
+    }
+    default:
+        // String commands without parameter
+        return false;
+    }
+}
+
+static bool ducky_line_end(DuckyCompiler* compiler) {
+    bool state = true;
+    if(compiler->line_len == 0) return true; // Skip empty lines
+
+    if(compiler->state == DuckyLineWord) {
+        ducky_word_end(compiler, false);
+    }
+
+    if(compiler->state == DuckyLineString) {
+        compiler->code[compiler->string_len_pos] = compiler->string_len;
+        compiler->code[compiler->string_len_pos + 1] = compiler->string_len >> 8;
+    } else if((compiler->state == DuckyLineStart) || (compiler->state == DuckyLineComment)) {
+        state = ducky_emit_op(compiler, DuckyOpNop);
+    } else {
+        state = ducky_compile_param(compiler);
+    }
+
+    compiler->line_nb++;
+    if(!state) {
+        compiler->error_line = compiler->line_nb;
+        return false;
+    }
+    compiler->repeat_allowed = true;
+
+    compiler->state = DuckyLineStart;
+    compiler->line_len = 0;
+    compiler->word_len = 0;
+    compiler->param_len = 0;
+    compiler->keyword = NULL;
+    return true;
+}
+
+static bool ducky_put_char(DuckyCompiler* compiler, char c) {
+    if(c == '\n') return ducky_line_end(compiler);
+    if(c == '\r') return true;
+    compiler->line_len++;
+
+    switch(compiler->state) {
+    case DuckyLineStart:
+        if((c == ' ') || (c == '\t')) break; // Skip spaces and tabs
+        compiler->state = DuckyLineWord;
+        // fall through
+    case DuckyLineWord:
+        if(c == ' ') {
+            ducky_word_end(compiler, true);
+        } else if(compiler->word_len < DUCKY_WORD_LEN_MAX) {
+            // Longer words are cut, they can't match any keyword anyway
+            compiler->word[compiler->word_len++] = c;
+        }
+        break;
+    case DuckyLineParam:
+        if(compiler->param_len < DUCKY_PARAM_LEN_MAX) {
+            compiler->param[compiler->param_len++] = c;
+        }
+        break;
+    case DuckyLineString:
+        if((compiler->string_len == DUCKY_STRING_LEN_MAX) || (!ducky_emit(compiler, &c, 1))) {
+            compiler->error_line = compiler->line_nb + 1;
+            return false;
+        }
+        compiler->string_len++;
+        break;
+    case DuckyLineComment:
+        break;
+    }
+    return true;
+}
+
+DuckyCompiler* ducky_compiler_alloc() {
+    DuckyCompiler* compiler = malloc(sizeof(DuckyCompiler));
+    compiler->code = malloc(DUCKY_CODE_SIZE_INIT);
+    compiler->code_capacity = DUCKY_CODE_SIZE_INIT;
+    ducky_compiler_reset(compiler);
+    return compiler;
+}
+
+void ducky_compiler_free(DuckyCompiler* compiler) {
+    furi_assert(compiler);
+    free(compiler->code);
+    free(compiler);
+}
+
+void ducky_compiler_reset(DuckyCompiler* compiler) {
+    furi_assert(compiler);
+    compiler->code_size = 0;
+    compiler->state = DuckyLineStart;
+    compiler->line_len = 0;
+    compiler->word_len = 0;
+    compiler->param_len = 0;
+    compiler->keyword = NULL;
+    compiler->line_nb = 0;
+    compiler->error_line = 0;
+    compiler->repeat_allowed = false;
+}
+
+bool ducky_compiler_feed(DuckyCompiler* compiler, const uint8_t* data, size_t size) {
+    furi_assert(compiler);
+    if(compiler->error_line != 0) return false;
+    for(size_t i = 0; i < size; i++) {
+        if(!ducky_put_char(compiler, data[i])) return false;
+    }
+    return true;
+}
+
+bool ducky_compiler_finish(DuckyCompiler* compiler) {
+    furi_assert(compiler);
+    if(compiler->error_line != 0) return false;
+    return ducky_line_end(compiler);
+}
+
+uint16_t ducky_compiler_get_line_count(DuckyCompiler* compiler) {
+    furi_assert(compiler);
+    return compiler->line_nb;
+}
+
+uint16_t ducky_compiler_get_error_line(DuckyCompiler* compiler) {
+    furi_assert(compiler);
+    return compiler->error_line;
+}
+
+const uint8_t* ducky_compiler_get_code(DuckyCompiler* compiler, size_t* size) {
+    furi_assert(compiler);
+    furi_assert(size);
+    *size = compiler->code_size;
+    return compiler->code;
+}
+
+size_t ducky_bytecode_decode(const uint8_t* code, size_t pc, DuckyInstruction* instruction) {
+    instruction->op = code[pc++];
+    instruction->value = 0;
+    instruction->data = NULL;
+    instruction->data_len = 0;
+
+    switch(instruction->op) {
+    case DuckyOpKey:
+        instruction->value = code[pc] | (code[pc + 1] << 8);
+        pc += 2;
+        break;
+    case DuckyOpDelay:
+    case DuckyOpDefaultDelay:
+    case DuckyOpStringDelay:
+    case DuckyOpRepeat:
+        instruction->value = code[pc] | (code[pc + 1] << 8) | (code[pc + 2] << 16) |
+                             ((uint32_t)code[pc + 3] << 24);
+        pc += 4;
+        break;
+    case DuckyOpString:
+    case DuckyOpAltChar:
+    case DuckyOpAltString:
+        instruction->data_len = code[pc] | (code[pc + 1] << 8);
+        instruction->data = (const char*)&code[pc + 2];
+        pc += 2 + instruction->data_len;
+        break;
+    default:
+        break;
+    }
+    return pc;
+}
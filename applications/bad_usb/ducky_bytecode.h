@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** One script line is compiled to exactly one instruction */
+typedef enum {
+    DuckyOpNop, /**< Comment or blank line, only default delay is applied */
+    DuckyOpKey, /**< value: keycode with modifiers */
+    DuckyOpString, /**< data: ASCII run */
+    DuckyOpAltChar, /**< data: decimal digits for numpad */
+    DuckyOpAltString, /**< data: ASCII run, typed with ALT+numpad codes */
+    DuckyOpDelay, /**< value: delay in ms */
+    DuckyOpDefaultDelay, /**< value: delay in ms applied after every line */
+    DuckyOpStringDelay, /**< value: STRING typing interval in ms per character, 0 for max rate */
+    DuckyOpRepeat, /**< value: how many times previous instruction is repeated */
+} DuckyOp;
+
+typedef struct {
+    DuckyOp op;
+    uint32_t value;
+    const char* data;
+    uint16_t data_len;
+} DuckyInstruction;
+
+typedef struct DuckyCompiler DuckyCompiler;
+
+/** Allocate compiler
+ * @return DuckyCompiler instance
+ */
+DuckyCompiler* ducky_compiler_alloc();
+
+/** Free compiler and its bytecode
+ * @param compiler DuckyCompiler instance
+ */
+void ducky_compiler_free(DuckyCompiler* compiler);
+
+/** Drop bytecode and prepare for a new script
+ * @param compiler DuckyCompiler instance
+ */
+void ducky_compiler_reset(DuckyCompiler* compiler);
+
+/** Compile next chunk of script text
+ * Chunks may split lines anywhere, only line being compiled is kept in memory.
+ * @param compiler DuckyCompiler instance
+ * @param data script text
+ * @param size text size
+ * @return false on script error, see ducky_compiler_get_error_line
+ */
+bool ducky_compiler_feed(DuckyCompiler* compiler, const uint8_t* data, size_t size);
+
+/** Compile last line if it has no line end
+ * @param compiler DuckyCompiler instance
+ * @return false on script error
+ */
+bool ducky_compiler_finish(DuckyCompiler* compiler);
+
+/** Get count of compiled lines, blank lines are not counted
+ * @param compiler DuckyCompiler instance
+ * @return lines count
+ */
+uint16_t ducky_compiler_get_line_count(DuckyCompiler* compiler);
+
+/** Get line with error, numbering matches ducky_compiler_get_line_count
+ * @param compiler DuckyCompiler instance
+ * @return line number, 0 if there was no error
+ */
+uint16_t ducky_compiler_get_error_line(DuckyCompiler* compiler);
+
+/** Get compiled bytecode
+ * @param compiler DuckyCompiler instance
+ * @param size bytecode size
+ * @return bytecode, owned by compiler
+ */
+const uint8_t* ducky_compiler_get_code(DuckyCompiler* compiler, size_t* size);
+
+/** Decode instruction
+ * @param code bytecode
+ * @param pc instruction offset, must be less than bytecode size
+ * @param instruction decoded instruction, data points into bytecode
+ * @return next instruction offset
+ */
+size_t ducky_bytecode_decode(const uint8_t* code, size_t pc, DuckyInstruction* instruction);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,80 @@
+#include <furi.h>
+#include "ducky_typer.h"
+
+static bool ducky_typer_send(DuckyTyper* typer, bool keystroke) {
+    typer->reports_cnt++;
+    if(keystroke) typer->keystrokes_cnt++;
+    return typer->callback(&typer->report, keystroke, typer->context);
+}
+
+static bool ducky_typer_is_held(DuckyTyper* typer, uint8_t key) {
+    for(uint8_t i = 0; i < typer->keys_cnt; i++) {
+        if(typer->report.keys[i] == key) return true;
+    }
+    return false;
+}
+
+static void ducky_typer_clear(DuckyTyper* typer) {
+    memset(&typer->report, 0, sizeof(typer->report));
+    typer->keys_cnt = 0;
+}
+
+static bool ducky_typer_release(DuckyTyper* typer) {
+    if((typer->keys_cnt == 0) && (typer->report.mods == 0)) return true;
+    ducky_typer_clear(typer);
+    return ducky_typer_send(typer, false);
+}
+
+static bool ducky_typer_key(DuckyTyper* typer, uint16_t keycode) {
+    uint8_t key = keycode & 0xFF;
+    uint8_t mods = keycode >> 8;
+
+    if(typer->keys_cnt > 0) {
+        if(ducky_typer_is_held(typer, key)) {
+            // Same key needs a release to be seen as a new press
+            if(!ducky_typer_release(typer)) return false;
+        } else if(
+            (typer->rollover > 1) && (typer->report.mods == mods) &&
+            (typer->keys_cnt < typer->rollover)) {
+            // Add key to held ones
+            typer->report.keys[typer->keys_cnt++] = key;
+            return ducky_typer_send(typer, true);
+        } else if(typer->rollover == 1) {
+            if(!ducky_typer_release(typer)) return false;
+        }
+    }
+
+    // Held keys, if any, are released in the same report
+    ducky_typer_clear(typer);
+    typer->report.mods = mods;
+    typer->report.keys[typer->keys_cnt++] = key;
+    return ducky_typer_send(typer, true);
+}
+
+void ducky_typer_init(
+    DuckyTyper* typer,
+    uint8_t rollover,
+    DuckyTyperCallback callback,
+    void* context) {
+    furi_assert(typer);
+    furi_assert(callback);
+    furi_assert((rollover > 0) && (rollover <= HID_KB_MAX_KEYS));
+
+    ducky_typer_clear(typer);
+    typer->rollover = rollover;
+    typer->callback = callback;
+    typer->context = context;
+    typer->reports_cnt = 0;
+    typer->keystrokes_cnt = 0;
+}
+
+bool ducky_typer_string(DuckyTyper* typer, const char* text, size_t len) {
+    furi_assert(typer);
+
+    for(size_t i = 0; i < len; i++) {
+        uint16_t keycode = HID_ASCII_TO_KEY(text[i]);
+        if((keycode & 0xFF) == KEY_NONE) continue;
+        if(!ducky_typer_key(typer, keycode)) return false;
+    }
+    return ducky_typer_release(typer);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <furi_hal_usb_hid.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t mods;
+    uint8_t keys[HID_KB_MAX_KEYS];
+} DuckyTyperReport;
+
+/** Report sink
+ * @param report keyboard report to send
+ * @param keystroke true if report presses a new key, false if it only releases keys
+ * @param context callback context
+ * @return false to stop typing
+ */
+typedef bool (*DuckyTyperCallback)(const DuckyTyperReport* report, bool keystroke, void* context);
+
+/**
+ * Converts text to a sequence of keyboard reports
+ * With rollover every report presses exactly one new key while keeping previous
+ * ones down, so host sees key presses in text order with fewer reports. Release of
+ * held keys is merged with the next key press when possible. Keys are released
+ * before a repeated key or modifiers change.
+ */
+typedef struct {
+    DuckyTyperReport report;
+    uint8_t keys_cnt;
+    uint8_t rollover;
+    DuckyTyperCallback callback;
+    void* context;
+    uint32_t reports_cnt;
+    uint32_t keystrokes_cnt;
+} DuckyTyper;
+
+/** Init typer
+ * @param typer DuckyTyper instance
+ * @param rollover max number of keys held down, 1 for press and release of each key
+ * @param callback report sink
+ * @param context callback context
+ */
+void ducky_typer_init(
+    DuckyTyper* typer,
+    uint8_t rollover,
+    DuckyTyperCallback callback,
+    void* context);
+
+/** Type ASCII text, characters without key code are skipped
+ * All keys are released at the end
+ * @param typer DuckyTyper instance
+ * @param text text
+ * @param len text length
+ * @return false if callback stopped typing
+ */
+bool ducky_typer_string(DuckyTyper* typer, const char* text, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -14,6 +14,14 @@ typedef struct {
     uint8_t anim_frame;
 } BadUsbModel;
 
+static void bad_usb_draw_char_rate(Canvas* canvas, BadUsbModel* model, string_t disp_str) {
+    if(model->state.char_rate == 0) return;
+    canvas_set_font(canvas, FontSecondary);
+    string_printf(disp_str, "%u chr/s", model->state.char_rate);
+    canvas_draw_str_aligned(canvas, 127, 46, AlignRight, AlignBottom, string_get_cstr(disp_str));
+    string_reset(disp_str);
+}
+
 static void bad_usb_draw_callback(Canvas* canvas, void* _model) {
     BadUsbModel* model = _model;
 
@@ -68,12 +76,14 @@ static void bad_usb_draw_callback(Canvas* canvas, void* _model) {
             canvas, 114, 36, AlignRight, AlignBottom, string_get_cstr(disp_str));
         string_reset(disp_str);
         canvas_draw_icon(canvas, 117, 22, &I_Percent_10x14);
+        bad_usb_draw_char_rate(canvas, model, disp_str);
     } else if(model->state.state == BadUsbStateDone) {
         canvas_draw_icon(canvas, 4, 19, &I_EviSmile1_18x21);
         canvas_set_font(canvas, FontBigNumbers);
         canvas_draw_str_aligned(canvas, 114, 36, AlignRight, AlignBottom, "100");
         string_reset(disp_str);
         canvas_draw_icon(canvas, 117, 22, &I_Percent_10x14);
+        bad_usb_draw_char_rate(canvas, model, disp_str);
     } else if(model->state.state == BadUsbStateDelay) {
         if(model->anim_frame == 0) {
             canvas_draw_icon(canvas, 4, 19, &I_EviWaiting1_18x21);
@@ -4,6 +4,7 @@
 #include <lib/toolbox/args.h>
 
 #include "bt_settings.h"
+#include "bt_service/bt.h"
 
 static const char* bt_cli_address_types[] = {
     "Public Device Address",
@@ -20,6 +21,22 @@ static void bt_cli_command_hci_info(Cli* cli, string_t args, void* context) {
     string_clear(buffer);
 }
 
+static void bt_cli_command_rpc_stats(Cli* cli, string_t args, void* context) {
+    Bt* bt = furi_record_open("bt");
+    BtSerialTxStats stats;
+    bt_get_rpc_tx_stats(bt, &stats);
+    furi_record_close("bt");
+
+    uint32_t bytes_per_sec = 0;
+    if(stats.active_ticks) {
+        bytes_per_sec = (uint64_t)stats.bytes * osKernelGetTickFreq() / stats.active_ticks;
+    }
+    uint32_t stall_ms = (uint64_t)stats.stall_ticks * 1000 / osKernelGetTickFreq();
+    printf("Sent: %lu bytes, %lu packets, %lu B/s\r\n", stats.bytes, stats.packets, bytes_per_sec);
+    printf("Writes: %lu, busy: %lu, errors: %lu\r\n", stats.writes, stats.busy, stats.errors);
+    printf("Stalls: %lu, %lu ms\r\n", stats.stalls, stall_ms);
+}
+
 static void bt_cli_command_carrier_tx(Cli* cli, string_t args, void* context) {
     int channel = 0;
     int power = 0;
@@ -178,6 +195,7 @@ static void bt_cli_print_usage() {
     printf("bt <cmd> <args>\r\n");
     printf("Cmd list:\r\n");
     printf("\thci_info\t - HCI info\r\n");
+    printf("\trpc_stats\t - RPC transmit statistics\r\n");
     if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug) &&
        furi_hal_bt_get_radio_stack() == FuriHalBtStackHciLayer) {
         printf("\ttx_carrier <channel:0-39> <power:0-6>\t - start tx carrier test\r\n");
@@ -203,6 +221,10 @@ static void bt_cli(Cli* cli, string_t args, void* context) {
             bt_cli_command_hci_info(cli, args, NULL);
             break;
         }
+        if(string_cmp_str(cmd, "rpc_stats") == 0) {
+            bt_cli_command_rpc_stats(cli, args, NULL);
+            break;
+        }
         if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug) &&
            furi_hal_bt_get_radio_stack() == FuriHalBtStackHciLayer) {
             if(string_cmp_str(cmd, "carrier_tx") == 0) {
@@ -11,6 +11,8 @@
 #define BT_RPC_EVENT_DISCONNECTED (1UL << 1)
 #define BT_RPC_EVENT_ALL (BT_RPC_EVENT_BUFF_SENT | BT_RPC_EVENT_DISCONNECTED)
 
+#define BT_RPC_TX_BUFFER_SIZE (FURI_HAL_BT_SERIAL_PACKET_SIZE_MAX * 2)
+
 static void bt_draw_statusbar_callback(Canvas* canvas, void* context) {
     furi_assert(context);
 
@@ -96,7 +98,22 @@ static void bt_battery_level_changed_callback(const void* _event, void* context)
         BtMessage message = {
             .type = BtMessageTypeUpdateBatteryLevel,
             .data.battery_level = event->data.battery_level};
-        furi_check(osMessageQueuePut(bt->message_queue, &message, 0, osWaitForever) == osOK);
+        // Runs on shared pubsub dispatcher thread, must not block: next level change refreshes it
+        if(osMessageQueuePut(bt->message_queue, &message, 0, 0) != osOK) {
+            FURI_LOG_D(TAG, "Queue is full, battery level update dropped");
+        }
+    }
+}
+
+// Called from RPC or GAP thread with rpc_tx_mutex taken
+static BtSerialTxStatus bt_rpc_tx_callback(uint8_t* data, uint16_t size, void* context) {
+    SerialServiceTxStatus status = furi_hal_bt_serial_tx(data, size);
+    if(status == SerialServiceTxStatusOk) {
+        return BtSerialTxStatusOk;
+    } else if(status == SerialServiceTxStatusBusy) {
+        return BtSerialTxStatusBusy;
+    } else {
+        return BtSerialTxStatusError;
     }
 }
 
@@ -130,11 +147,21 @@ Bt* bt_alloc() {
     // Power
     bt->power = furi_record_open("power");
     FuriPubSub* power_pubsub = power_get_pubsub(bt->power);
-    furi_pubsub_subscribe(power_pubsub, bt_battery_level_changed_callback, bt);
+    // Deliver on dispatcher thread, so power service is not blocked by bt
+    furi_pubsub_subscribe_async(
+        power_pubsub,
+        bt_battery_level_changed_callback,
+        bt,
+        sizeof(PowerEvent),
+        4,
+        FuriPubSubAsyncPolicyDropOldest);
 
     // RPC
     bt->rpc = furi_record_open("rpc");
     bt->rpc_event = osEventFlagsNew(NULL);
+    bt->rpc_tx = bt_serial_tx_alloc(
+        BT_RPC_TX_BUFFER_SIZE, FURI_HAL_BT_SERIAL_PACKET_SIZE_MAX, bt_rpc_tx_callback, bt);
+    bt->rpc_tx_mutex = osMutexNew(NULL);
 
     // API evnent
     bt->api_event = osEventFlagsNew(NULL);
@@ -157,6 +184,11 @@ static uint16_t bt_serial_event_callback(SerialServiceEvent event, void* context
         }
         ret = rpc_session_get_available_size(bt->rpc_session);
     } else if(event.event == SerialServiceEventTypeDataSent) {
+        // Window moved: send what RPC has buffered meanwhile
+        furi_check(osMutexAcquire(bt->rpc_tx_mutex, osWaitForever) == osOK);
+        bt_serial_tx_sent(bt->rpc_tx);
+        bt_serial_tx_process(bt->rpc_tx, osKernelGetTickCount());
+        furi_check(osMutexRelease(bt->rpc_tx_mutex) == osOK);
         osEventFlagsSet(bt->rpc_event, BT_RPC_EVENT_BUFF_SENT);
     }
     return ret;
@@ -170,22 +202,34 @@ static void bt_rpc_send_bytes_callback(void* context, uint8_t* bytes, size_t byt
     osEventFlagsClear(bt->rpc_event, BT_RPC_EVENT_ALL);
     size_t bytes_sent = 0;
     while(bytes_sent < bytes_len) {
-        size_t bytes_remain = bytes_len - bytes_sent;
-        if(bytes_remain > bt->max_packet_size) {
-            furi_hal_bt_serial_tx(&bytes[bytes_sent], bt->max_packet_size);
-            bytes_sent += bt->max_packet_size;
-        } else {
-            furi_hal_bt_serial_tx(&bytes[bytes_sent], bytes_remain);
-            bytes_sent += bytes_remain;
-        }
-        uint32_t event_flag =
-            osEventFlagsWait(bt->rpc_event, BT_RPC_EVENT_ALL, osFlagsWaitAny, osWaitForever);
-        if(event_flag & BT_RPC_EVENT_DISCONNECTED) {
-            break;
+        furi_check(osMutexAcquire(bt->rpc_tx_mutex, osWaitForever) == osOK);
+        bt_serial_tx_set_packet_size(bt->rpc_tx, bt->max_packet_size);
+        bt_serial_tx_set_window(bt->rpc_tx, furi_hal_bt_serial_get_tx_window());
+        bytes_sent +=
+            bt_serial_tx_write(bt->rpc_tx, &bytes[bytes_sent], bytes_len - bytes_sent);
+        bt_serial_tx_process(bt->rpc_tx, osKernelGetTickCount());
+        furi_check(osMutexRelease(bt->rpc_tx_mutex) == osOK);
+        if(bytes_sent < bytes_len) {
+            // TX buffer is full, wait for window to move
+            uint32_t event_flag =
+                osEventFlagsWait(bt->rpc_event, BT_RPC_EVENT_ALL, osFlagsWaitAny, osWaitForever);
+            if(event_flag & BT_RPC_EVENT_DISCONNECTED) {
+                break;
+            }
         }
     }
 }
 
+static void bt_rpc_tx_reset(Bt* bt, bool connected) {
+    furi_check(osMutexAcquire(bt->rpc_tx_mutex, osWaitForever) == osOK);
+    if(connected) {
+        bt_serial_tx_reset(bt->rpc_tx);
+    } else {
+        bt_serial_tx_drop(bt->rpc_tx);
+    }
+    furi_check(osMutexRelease(bt->rpc_tx_mutex) == osOK);
+}
+
 // Called from GAP thread
 static bool bt_on_gap_event_callback(GapEvent event, void* context) {
     furi_assert(context);
@@ -202,6 +246,7 @@ static bool bt_on_gap_event_callback(GapEvent event, void* context) {
             bt->rpc_session = rpc_session_open(bt->rpc);
             if(bt->rpc_session) {
                 FURI_LOG_I(TAG, "Open RPC connection");
+                bt_rpc_tx_reset(bt, true);
                 rpc_session_set_send_bytes_callback(bt->rpc_session, bt_rpc_send_bytes_callback);
                 rpc_session_set_buffer_is_empty_callback(
                     bt->rpc_session, furi_hal_bt_serial_notify_buffer_is_empty);
@@ -222,6 +267,7 @@ static bool bt_on_gap_event_callback(GapEvent event, void* context) {
     } else if(event.type == GapEventTypeDisconnected) {
         if(bt->profile == BtProfileSerial && bt->rpc_session) {
             FURI_LOG_I(TAG, "Close RPC connection");
+            bt_rpc_tx_reset(bt, false);
             osEventFlagsSet(bt->rpc_event, BT_RPC_EVENT_DISCONNECTED);
             rpc_session_close(bt->rpc_session);
             furi_hal_bt_serial_set_event_callback(0, NULL, NULL);
@@ -284,6 +330,7 @@ static void bt_change_profile(Bt* bt, BtMessage* message) {
         bt_settings_load(&bt->bt_settings);
         if(bt->profile == BtProfileSerial && bt->rpc_session) {
             FURI_LOG_I(TAG, "Close RPC connection");
+            bt_rpc_tx_reset(bt, false);
             osEventFlagsSet(bt->rpc_event, BT_RPC_EVENT_DISCONNECTED);
             rpc_session_close(bt->rpc_session);
             furi_hal_bt_serial_set_event_callback(0, NULL, NULL);
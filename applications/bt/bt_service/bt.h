@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "bt_serial_tx.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,6 +50,13 @@ void bt_set_status_changed_callback(Bt* bt, BtStatusChangedCallback callback, vo
  */
 void bt_forget_bonded_devices(Bt* bt);
 
+/** Get RPC transmit statistics of current or last connection
+ *
+ * @param bt        Bt instance
+ * @param stats     BtSerialTxStats to fill
+ */
+void bt_get_rpc_tx_stats(Bt* bt, BtSerialTxStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
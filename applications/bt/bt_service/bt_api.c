@@ -26,3 +26,11 @@ void bt_forget_bonded_devices(Bt* bt) {
     BtMessage message = {.type = BtMessageTypeForgetBondedDevices};
     furi_check(osMessageQueuePut(bt->message_queue, &message, 0, osWaitForever) == osOK);
 }
+
+void bt_get_rpc_tx_stats(Bt* bt, BtSerialTxStats* stats) {
+    furi_assert(bt);
+    furi_assert(stats);
+    furi_check(osMutexAcquire(bt->rpc_tx_mutex, osWaitForever) == osOK);
+    bt_serial_tx_get_stats(bt->rpc_tx, stats);
+    furi_check(osMutexRelease(bt->rpc_tx_mutex) == osOK);
+}
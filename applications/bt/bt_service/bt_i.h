@@ -15,6 +15,7 @@
 #include <applications/notification/notification.h>
 
 #include "../bt_settings.h"
+#include "bt_serial_tx.h"
 
 #define BT_API_UNLOCK_EVENT (1UL << 0)
 
@@ -58,6 +59,8 @@ struct Bt {
     Rpc* rpc;
     RpcSession* rpc_session;
     osEventFlagsId_t rpc_event;
+    BtSerialTx* rpc_tx;
+    osMutexId_t rpc_tx_mutex;
     osEventFlagsId_t api_event;
     BtStatusChangedCallback status_changed_cb;
     void* status_changed_ctx;
@@ -0,0 +1,180 @@
+#include <furi.h>
+#include "bt_serial_tx.h"
+
+struct BtSerialTx {
+    uint8_t* buffer;
+    size_t buffer_size;
+    size_t head;
+    size_t count;
+    uint8_t* packet;
+    uint16_t packet_size_max;
+    uint16_t packet_size;
+    uint8_t window;
+    uint8_t in_flight;
+    bool busy;
+    bool stalled;
+    bool active;
+    uint32_t stall_start;
+    uint32_t last_process;
+    BtSerialTxStats stats;
+    BtSerialTxCallback callback;
+    void* context;
+};
+
+BtSerialTx* bt_serial_tx_alloc(
+    size_t buffer_size,
+    uint16_t packet_size_max,
+    BtSerialTxCallback callback,
+    void* context) {
+    furi_assert(buffer_size);
+    furi_assert(packet_size_max);
+    furi_assert(callback);
+    BtSerialTx* tx = malloc(sizeof(BtSerialTx));
+    tx->buffer = malloc(buffer_size);
+    tx->buffer_size = buffer_size;
+    tx->packet = malloc(packet_size_max);
+    tx->packet_size_max = packet_size_max;
+    tx->packet_size = packet_size_max;
+    tx->window = 1;
+    tx->callback = callback;
+    tx->context = context;
+    bt_serial_tx_reset(tx);
+    return tx;
+}
+
+void bt_serial_tx_free(BtSerialTx* tx) {
+    furi_assert(tx);
+    free(tx->packet);
+    free(tx->buffer);
+    free(tx);
+}
+
+void bt_serial_tx_drop(BtSerialTx* tx) {
+    furi_assert(tx);
+    tx->head = 0;
+    tx->count = 0;
+    tx->in_flight = 0;
+    tx->busy = false;
+    tx->stalled = false;
+    tx->active = false;
+}
+
+void bt_serial_tx_reset(BtSerialTx* tx) {
+    furi_assert(tx);
+    bt_serial_tx_drop(tx);
+    memset(&tx->stats, 0, sizeof(BtSerialTxStats));
+}
+
+void bt_serial_tx_set_packet_size(BtSerialTx* tx, uint16_t packet_size) {
+    furi_assert(tx);
+    furi_assert(packet_size);
+    tx->packet_size = MIN(packet_size, tx->packet_size_max);
+}
+
+void bt_serial_tx_set_window(BtSerialTx* tx, uint8_t window) {
+    furi_assert(tx);
+    tx->window = window;
+    if(window == BT_SERIAL_TX_WINDOW_UNLIMITED) {
+        tx->in_flight = 0;
+    }
+}
+
+size_t bt_serial_tx_write(BtSerialTx* tx, const uint8_t* data, size_t size) {
+    furi_assert(tx);
+    tx->stats.writes++;
+
+    size_t written = MIN(size, tx->buffer_size - tx->count);
+    size_t tail = (tx->head + tx->count) % tx->buffer_size;
+    size_t first = MIN(written, tx->buffer_size - tail);
+    memcpy(&tx->buffer[tail], data, first);
+    memcpy(tx->buffer, &data[first], written - first);
+    tx->count += written;
+
+    return written;
+}
+
+void bt_serial_tx_sent(BtSerialTx* tx) {
+    furi_assert(tx);
+    // Busy is only reported with nothing waiting for confirmation, so event is unambiguous
+    if(tx->busy) {
+        tx->busy = false;
+    } else if(tx->in_flight > 0) {
+        tx->in_flight--;
+    }
+}
+
+static void bt_serial_tx_consume(BtSerialTx* tx, size_t size) {
+    tx->head = (tx->head + size) % tx->buffer_size;
+    tx->count -= size;
+}
+
+static bool bt_serial_tx_send_packet(BtSerialTx* tx) {
+    size_t size = MIN(tx->count, tx->packet_size);
+    // Hold partial packet while previous one is in flight: more frames may join it
+    if(size < tx->packet_size && tx->in_flight > 0) return false;
+
+    size_t first = MIN(size, tx->buffer_size - tx->head);
+    memcpy(tx->packet, &tx->buffer[tx->head], first);
+    memcpy(&tx->packet[first], tx->buffer, size - first);
+
+    BtSerialTxStatus status = tx->callback(tx->packet, size, tx->context);
+    if(status == BtSerialTxStatusBusy) {
+        tx->busy = true;
+        tx->stats.busy++;
+        return false;
+    }
+
+    bt_serial_tx_consume(tx, size);
+    if(status == BtSerialTxStatusOk) {
+        tx->stats.bytes += size;
+        tx->stats.packets++;
+        if(tx->window != BT_SERIAL_TX_WINDOW_UNLIMITED) {
+            tx->in_flight++;
+        }
+    } else {
+        tx->stats.errors++;
+    }
+    return true;
+}
+
+void bt_serial_tx_process(BtSerialTx* tx, uint32_t now) {
+    furi_assert(tx);
+
+    if(tx->active) {
+        tx->stats.active_ticks += now - tx->last_process;
+    }
+    tx->last_process = now;
+
+    while(tx->count > 0 && !tx->busy) {
+        if(tx->window != BT_SERIAL_TX_WINDOW_UNLIMITED && tx->in_flight >= tx->window) break;
+        if(!bt_serial_tx_send_packet(tx)) break;
+    }
+
+    bool full = (tx->count == tx->buffer_size);
+    if(full && !tx->stalled) {
+        tx->stalled = true;
+        tx->stall_start = now;
+        tx->stats.stalls++;
+    } else if(!full && tx->stalled) {
+        tx->stalled = false;
+        tx->stats.stall_ticks += now - tx->stall_start;
+    }
+
+    tx->active = (tx->count > 0) || (tx->in_flight > 0) || tx->busy;
+}
+
+size_t bt_serial_tx_get_pending(BtSerialTx* tx) {
+    furi_assert(tx);
+    return tx->count;
+}
+
+uint8_t bt_serial_tx_get_in_flight(BtSerialTx* tx) {
+    furi_assert(tx);
+    return tx->in_flight;
+}
+
+void bt_serial_tx_get_stats(BtSerialTx* tx, BtSerialTxStats* stats) {
+    furi_assert(tx);
+    furi_assert(stats);
+    *stats = tx->stats;
+}
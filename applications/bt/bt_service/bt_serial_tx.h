@@ -0,0 +1,111 @@
+/**
+ * @file bt_serial_tx.h
+ * Bt: windowed transmit pipeline for Serial service
+ *
+ * Bytes written by RPC are buffered and sent in packets of negotiated size, several packets
+ * can be in flight at once. Small frames written while a packet is in flight are coalesced
+ * into full packets instead of waiting for a confirmation each.
+ *
+ * Not thread safe: owner serializes calls and runs process after each write and sent event.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Packets aren't confirmed, in flight count is limited by transport buffers only */
+#define BT_SERIAL_TX_WINDOW_UNLIMITED (0)
+
+typedef struct BtSerialTx BtSerialTx;
+
+typedef enum {
+    BtSerialTxStatusOk, /**< Packet is taken by transport */
+    BtSerialTxStatusBusy, /**< No transport buffers, retry after sent event */
+    BtSerialTxStatusError, /**< Packet can't be sent and is dropped */
+} BtSerialTxStatus;
+
+typedef struct {
+    uint32_t bytes; /**< Bytes taken by transport */
+    uint32_t packets; /**< Packets taken by transport */
+    uint32_t writes; /**< Write calls */
+    uint32_t busy; /**< Packets rejected by transport for lack of buffers */
+    uint32_t errors; /**< Packets dropped */
+    uint32_t stalls; /**< Times TX buffer got full and writer had to wait */
+    uint32_t stall_ticks; /**< Time TX buffer was full */
+    uint32_t active_ticks; /**< Time data was pending or in flight */
+} BtSerialTxStats;
+
+/** Send packet callback
+ *
+ * @param data      packet data
+ * @param size      packet size
+ * @param context   pointer to context
+ *
+ * @return          BtSerialTxStatus
+ */
+typedef BtSerialTxStatus (*BtSerialTxCallback)(uint8_t* data, uint16_t size, void* context);
+
+/** Allocate BtSerialTx
+ *
+ * @param buffer_size       TX buffer size, bytes
+ * @param packet_size_max   biggest packet transport can take
+ * @param callback          BtSerialTxCallback instance
+ * @param context           pointer to context
+ *
+ * @return                  BtSerialTx instance
+ */
+BtSerialTx* bt_serial_tx_alloc(
+    size_t buffer_size,
+    uint16_t packet_size_max,
+    BtSerialTxCallback callback,
+    void* context);
+
+void bt_serial_tx_free(BtSerialTx* tx);
+
+/** New connection: drop pending data, reset statistics */
+void bt_serial_tx_reset(BtSerialTx* tx);
+
+/** Connection lost: drop pending data, keep statistics */
+void bt_serial_tx_drop(BtSerialTx* tx);
+
+/** Set packet size, clamped to packet_size_max */
+void bt_serial_tx_set_packet_size(BtSerialTx* tx, uint16_t packet_size);
+
+/** Set packets that can wait for sent event
+ *
+ * @param window    packets count or BT_SERIAL_TX_WINDOW_UNLIMITED
+ */
+void bt_serial_tx_set_window(BtSerialTx* tx, uint8_t window);
+
+/** Buffer data
+ *
+ * @return  bytes taken, less than size if TX buffer is full
+ */
+size_t bt_serial_tx_write(BtSerialTx* tx, const uint8_t* data, size_t size);
+
+/** Transport sent event: packet confirmed or buffers are free again after busy */
+void bt_serial_tx_sent(BtSerialTx* tx);
+
+/** Send packets allowed by window and update statistics
+ *
+ * @param now   current tick
+ */
+void bt_serial_tx_process(BtSerialTx* tx, uint32_t now);
+
+/** Get bytes waiting in TX buffer */
+size_t bt_serial_tx_get_pending(BtSerialTx* tx);
+
+/** Get packets waiting for sent event */
+uint8_t bt_serial_tx_get_in_flight(BtSerialTx* tx);
+
+void bt_serial_tx_get_stats(BtSerialTx* tx, BtSerialTxStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,6 +5,8 @@
 #include <task_control_block.h>
 #include <time.h>
 #include <notification/notification_messages.h>
+#include <storage/storage.h>
+#include <lib/toolbox/args.h>
 
 // Close to ISO, `date +'%Y-%m-%d %H:%M:%S %u'`
 #define CLI_DATE_FORMAT "%.4d-%.2d-%.2d %.2d:%.2d:%.2d %d"
@@ -310,6 +312,169 @@ void cli_command_ps(Cli* cli, string_t args, void* context) {
     printf("\r\nTotal: %d", thread_num);
 }
 
+#define CLI_TOP_PERIOD_MS (1000)
+// Window of 10 periods
+#define CLI_TOP_HISTORY (11)
+
+static int cli_command_top_compare(const void* a, const void* b) {
+    const FuriThreadProfilerThread* thread_a = a;
+    const FuriThreadProfilerThread* thread_b = b;
+    if(thread_a->cpu_last != thread_b->cpu_last) {
+        return (int)thread_b->cpu_last - (int)thread_a->cpu_last;
+    }
+    return (int)thread_b->cpu_window - (int)thread_a->cpu_window;
+}
+
+void cli_command_top(Cli* cli, string_t args, void* context) {
+    FuriThreadProfiler* profiler = furi_thread_profiler_alloc(CLI_TOP_HISTORY);
+    FuriThreadProfilerThread* threads =
+        malloc(sizeof(FuriThreadProfilerThread) * FURI_THREAD_PROFILER_THREADS_MAX);
+    FuriThreadProfilerSummary summary;
+
+    furi_thread_profiler_sample(profiler);
+    uint32_t next = osKernelGetTickCount();
+    while(!cli_cmd_interrupt_received(cli)) {
+        next += CLI_TOP_PERIOD_MS * osKernelGetTickFreq() / 1000;
+        osDelayUntil(next);
+        furi_thread_profiler_sample(profiler);
+        size_t count = furi_thread_profiler_get(
+            profiler, &summary, threads, FURI_THREAD_PROFILER_THREADS_MAX);
+        qsort(threads, count, sizeof(FuriThreadProfilerThread), cli_command_top_compare);
+
+        printf("\e[2J\e[H");
+        printf(
+            "Threads: %lu, switches: %lu/s, sleep: %u.%u%% (%lus: %u.%u%%)\r\n",
+            summary.threads,
+            summary.switches,
+            summary.sleep_last / 10,
+            summary.sleep_last % 10,
+            summary.window_ms / 1000,
+            summary.sleep_window / 10,
+            summary.sleep_window % 10);
+        printf(
+            "Profiler: %u.%u%%, sample: %lu cycles, max %lu\r\n\r\n",
+            summary.overhead_window / 10,
+            summary.overhead_window % 10,
+            summary.sample_cycles,
+            summary.sample_cycles_max);
+        printf(
+            "%-16s %-4s %-6s %-6s %-6s %-6s %s\r\n",
+            "Name",
+            "Prio",
+            "CPU",
+            "Window",
+            "Sw/s",
+            "Stack",
+            "Min free");
+        for(size_t i = 0; i < count; i++) {
+            printf(
+                "%-16s %-4lu %3u.%u%% %3u.%u%% %-6lu %-6lu %lu\r\n",
+                threads[i].name,
+                threads[i].priority,
+                threads[i].cpu_last / 10,
+                threads[i].cpu_last % 10,
+                threads[i].cpu_window / 10,
+                threads[i].cpu_window % 10,
+                threads[i].switches,
+                threads[i].stack_size,
+                threads[i].stack_free);
+        }
+        printf("\r\nPress CTRL+C to stop\r\n");
+    }
+
+    free(threads);
+    furi_thread_profiler_free(profiler);
+}
+
+#ifdef FURI_TRACE
+#define CLI_TRACE_PATH "/int/.trace"
+
+static void cli_command_trace_print_usage() {
+    printf("Usage:\r\n");
+    printf("trace <cmd> <args>\r\n");
+    printf("Cmd list:\r\n");
+    printf("\tinfo\t - Show ring state\r\n");
+    printf("\tstart\t - Start recording\r\n");
+    printf("\tstop\t - Stop recording\r\n");
+    printf("\tclear\t - Drop all records\r\n");
+    printf("\tsave [path]\t - Save dump for scripts/trace.py, " CLI_TRACE_PATH " by default\r\n");
+}
+
+static bool cli_command_trace_write(const void* data, size_t size, void* context) {
+    File* file = context;
+    return storage_file_write(file, data, size) == size;
+}
+
+static void cli_command_trace_save(string_t path) {
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+
+    if(!storage_file_open(file, string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        printf("Can't open %s: %s", string_get_cstr(path), storage_file_get_error_desc(file));
+    } else if(!furi_trace_dump(cli_command_trace_write, file)) {
+        printf("Write failed: %s", storage_file_get_error_desc(file));
+    } else {
+        printf("Saved %lu bytes to %s", (uint32_t)storage_file_size(file), string_get_cstr(path));
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close("storage");
+}
+
+void cli_command_trace(Cli* cli, string_t args, void* context) {
+    string_t cmd;
+    string_init(cmd);
+
+    do {
+        if(!args_read_string_and_trim(args, cmd)) {
+            cli_command_trace_print_usage();
+            break;
+        }
+
+        if(string_cmp_str(cmd, "info") == 0) {
+            uint32_t records;
+            uint32_t lost;
+            size_t capacity = furi_trace_get_stats(&records, &lost);
+            printf(
+                "%s, %lu of %u records, %lu lost",
+                furi_trace_is_enabled() ? "Recording" : "Stopped",
+                records,
+                capacity,
+                lost);
+            break;
+        }
+
+        if(string_cmp_str(cmd, "start") == 0) {
+            furi_trace_set_enabled(true);
+            break;
+        }
+
+        if(string_cmp_str(cmd, "stop") == 0) {
+            furi_trace_set_enabled(false);
+            break;
+        }
+
+        if(string_cmp_str(cmd, "clear") == 0) {
+            furi_trace_clear();
+            break;
+        }
+
+        if(string_cmp_str(cmd, "save") == 0) {
+            if(!args_read_probably_quoted_string_and_trim(args, cmd)) {
+                string_set_str(cmd, CLI_TRACE_PATH);
+            }
+            cli_command_trace_save(cmd);
+            break;
+        }
+
+        cli_command_trace_print_usage();
+    } while(false);
+
+    string_clear(cmd);
+}
+#endif
+
 void cli_command_free(Cli* cli, string_t args, void* context) {
     printf("Free heap size: %d\r\n", memmgr_get_free_heap());
     printf("Minimum heap size: %d\r\n", memmgr_get_minimum_free_heap());
@@ -349,6 +514,10 @@ void cli_commands_init(Cli* cli) {
     cli_add_command(cli, "date", CliCommandFlagParallelSafe, cli_command_date, NULL);
     cli_add_command(cli, "log", CliCommandFlagParallelSafe, cli_command_log, NULL);
     cli_add_command(cli, "ps", CliCommandFlagParallelSafe, cli_command_ps, NULL);
+    cli_add_command(cli, "top", CliCommandFlagParallelSafe, cli_command_top, NULL);
+#ifdef FURI_TRACE
+    cli_add_command(cli, "trace", CliCommandFlagParallelSafe, cli_command_trace, NULL);
+#endif
     cli_add_command(cli, "free", CliCommandFlagParallelSafe, cli_command_free, NULL);
     cli_add_command(cli, "free_blocks", CliCommandFlagParallelSafe, cli_command_free_blocks, NULL);
 
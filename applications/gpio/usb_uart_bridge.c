@@ -1,11 +1,16 @@
 #include "usb_uart_bridge.h"
+#include "usb_uart_rx_ring.h"
 #include "furi_hal.h"
-#include <stream_buffer.h>
 #include <furi_hal_usb_cdc_i.h>
 #include "usb_cdc.h"
 
 #define USB_CDC_PKT_LEN CDC_DATA_SZ
-#define USB_UART_RX_BUF_SIZE (USB_CDC_PKT_LEN * 5)
+// CDC data endpoints are double-buffered, so two packets can be queued at once
+#define USB_CDC_TX_BUF_CNT 2
+// DMA reports every half of the buffer, 512 bytes take ~5.5ms at 921600 baud
+#define USB_UART_RX_BUF_SIZE (USB_CDC_PKT_LEN * 16)
+// Full packets are picked up at this interval while the line is not idle
+#define USB_UART_RX_POLL_TIMEOUT 10
 
 #define USB_CDC_BIT_DTR (1 << 0)
 #define USB_CDC_BIT_RTS (1 << 1)
@@ -28,11 +33,13 @@ typedef enum {
     WorkerEvtLineCfgSet = (1 << 6),
     WorkerEvtCtrlLineSet = (1 << 7),
 
+    WorkerEvtRxIdle = (1 << 8),
+
 } WorkerEvtFlags;
 
 #define WORKER_ALL_RX_EVENTS                                                      \
     (WorkerEvtStop | WorkerEvtRxDone | WorkerEvtCfgChange | WorkerEvtLineCfgSet | \
-     WorkerEvtCtrlLineSet)
+     WorkerEvtCtrlLineSet | WorkerEvtRxIdle)
 #define WORKER_ALL_TX_EVENTS (WorkerEvtTxStop | WorkerEvtCdcRx)
 
 struct UsbUartBridge {
@@ -42,7 +49,9 @@ struct UsbUartBridge {
     FuriThread* thread;
     FuriThread* tx_thread;
 
-    StreamBufferHandle_t rx_stream;
+    UsbUartRxRing rx_ring;
+    volatile uint32_t rx_ore_cnt;
+    uint32_t rx_overrun_base;
 
     osMutexId_t usb_mutex;
 
@@ -51,6 +60,7 @@ struct UsbUartBridge {
     UsbUartState st;
 
     uint8_t rx_buf[USB_CDC_PKT_LEN];
+    uint8_t rx_dma_buf[USB_UART_RX_BUF_SIZE];
 };
 
 static void vcp_on_cdc_tx_complete(void* context);
@@ -73,12 +83,18 @@ static int32_t usb_uart_tx_thread(void* context);
 
 static void usb_uart_on_irq_cb(UartIrqEvent ev, uint8_t data, void* context) {
     UsbUartBridge* usb_uart = (UsbUartBridge*)context;
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-    if(ev == UartIrqEventRXNE) {
-        xStreamBufferSendFromISR(usb_uart->rx_stream, &data, 1, &xHigherPriorityTaskWoken);
+    if(ev == UartIrqEventRXDMA) {
+        usb_uart_rx_ring_update(
+            &usb_uart->rx_ring, furi_hal_uart_dma_rx_get_pos(usb_uart->cfg.uart_ch));
+        osThreadFlagsSet(furi_thread_get_thread_id(usb_uart->thread), WorkerEvtRxDone);
+    } else if(ev == UartIrqEventIDLE) {
+        usb_uart_rx_ring_update(
+            &usb_uart->rx_ring, furi_hal_uart_dma_rx_get_pos(usb_uart->cfg.uart_ch));
+        osThreadFlagsSet(furi_thread_get_thread_id(usb_uart->thread), WorkerEvtRxIdle);
+    } else if(ev == UartIrqEventORE) {
+        usb_uart->rx_ore_cnt++;
         osThreadFlagsSet(furi_thread_get_thread_id(usb_uart->thread), WorkerEvtRxDone);
-        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
 }
 
@@ -97,17 +113,28 @@ static void usb_uart_vcp_deinit(UsbUartBridge* usb_uart, uint8_t vcp_ch) {
     if(vcp_ch == 0) furi_hal_vcp_enable();
 }
 
+static void usb_uart_update_rx_overrun(UsbUartBridge* usb_uart) {
+    usb_uart->st.rx_overrun_cnt = usb_uart->rx_overrun_base + usb_uart->rx_ore_cnt +
+                                  usb_uart_rx_ring_get_overrun(&usb_uart->rx_ring);
+}
+
 static void usb_uart_serial_init(UsbUartBridge* usb_uart, uint8_t uart_ch) {
     if(uart_ch == FuriHalUartIdUSART1) {
         furi_hal_console_disable();
     } else if(uart_ch == FuriHalUartIdLPUART1) {
         furi_hal_uart_init(uart_ch, 115200);
     }
+    usb_uart_rx_ring_init(&usb_uart->rx_ring, usb_uart->rx_dma_buf, USB_UART_RX_BUF_SIZE);
     furi_hal_uart_set_irq_cb(uart_ch, usb_uart_on_irq_cb, usb_uart);
+    furi_hal_uart_dma_rx_start(uart_ch, usb_uart->rx_dma_buf, USB_UART_RX_BUF_SIZE);
 }
 
 static void usb_uart_serial_deinit(UsbUartBridge* usb_uart, uint8_t uart_ch) {
+    furi_hal_uart_dma_rx_stop(uart_ch);
     furi_hal_uart_set_irq_cb(uart_ch, NULL, NULL);
+    usb_uart_update_rx_overrun(usb_uart);
+    usb_uart->rx_overrun_base = usb_uart->st.rx_overrun_cnt;
+    usb_uart->rx_ore_cnt = 0;
     if(uart_ch == FuriHalUartIdUSART1)
         furi_hal_console_enable();
     else if(uart_ch == FuriHalUartIdLPUART1)
@@ -138,14 +165,36 @@ static void usb_uart_update_ctrl_lines(UsbUartBridge* usb_uart) {
     }
 }
 
+static void usb_uart_rx_send(UsbUartBridge* usb_uart, bool flush) {
+    size_t len_min = flush ? 1 : USB_CDC_PKT_LEN;
+    while(usb_uart_rx_ring_get_pending(&usb_uart->rx_ring) >= len_min) {
+        if(osSemaphoreAcquire(usb_uart->tx_sem, 100) != osOK) {
+            // Host doesn't read, DMA would overwrite everything anyway
+            usb_uart_rx_ring_drop(&usb_uart->rx_ring);
+            break;
+        }
+        size_t len =
+            usb_uart_rx_ring_read(&usb_uart->rx_ring, usb_uart->rx_buf, USB_CDC_PKT_LEN, flush);
+        if(len > 0) {
+            usb_uart->st.rx_cnt += len;
+            furi_check(osMutexAcquire(usb_uart->usb_mutex, osWaitForever) == osOK);
+            furi_hal_cdc_send(usb_uart->cfg.vcp_ch, usb_uart->rx_buf, len);
+            furi_check(osMutexRelease(usb_uart->usb_mutex) == osOK);
+        } else {
+            osSemaphoreRelease(usb_uart->tx_sem);
+        }
+    }
+    usb_uart_update_rx_overrun(usb_uart);
+}
+
 static int32_t usb_uart_worker(void* context) {
     UsbUartBridge* usb_uart = (UsbUartBridge*)context;
 
     memcpy(&usb_uart->cfg, &usb_uart->cfg_new, sizeof(UsbUartConfig));
+    usb_uart->rx_ore_cnt = 0;
+    usb_uart->rx_overrun_base = 0;
 
-    usb_uart->rx_stream = xStreamBufferCreate(USB_UART_RX_BUF_SIZE, 1);
-
-    usb_uart->tx_sem = osSemaphoreNew(1, 1, NULL);
+    usb_uart->tx_sem = osSemaphoreNew(USB_CDC_TX_BUF_CNT, USB_CDC_TX_BUF_CNT, NULL);
     usb_uart->usb_mutex = osMutexNew(NULL);
 
     usb_uart->tx_thread = furi_thread_alloc();
@@ -169,23 +218,28 @@ static int32_t usb_uart_worker(void* context) {
 
     furi_thread_start(usb_uart->tx_thread);
 
+    bool rx_active = false;
     while(1) {
-        uint32_t events = osThreadFlagsWait(WORKER_ALL_RX_EVENTS, osFlagsWaitAny, osWaitForever);
+        uint32_t events = osThreadFlagsWait(
+            WORKER_ALL_RX_EVENTS,
+            osFlagsWaitAny,
+            rx_active ? USB_UART_RX_POLL_TIMEOUT : osWaitForever);
+        if(events == osFlagsErrorTimeout) {
+            // Slow continuous stream: DMA half transfer may take too long to come
+            FURI_CRITICAL_ENTER();
+            usb_uart_rx_ring_update(
+                &usb_uart->rx_ring, furi_hal_uart_dma_rx_get_pos(usb_uart->cfg.uart_ch));
+            FURI_CRITICAL_EXIT();
+            events = WorkerEvtRxDone;
+        }
         furi_check((events & osFlagsError) == 0);
         if(events & WorkerEvtStop) break;
-        if(events & WorkerEvtRxDone) {
-            size_t len =
-                xStreamBufferReceive(usb_uart->rx_stream, usb_uart->rx_buf, USB_CDC_PKT_LEN, 0);
-            if(len > 0) {
-                if(osSemaphoreAcquire(usb_uart->tx_sem, 100) == osOK) {
-                    usb_uart->st.rx_cnt += len;
-                    furi_check(osMutexAcquire(usb_uart->usb_mutex, osWaitForever) == osOK);
-                    furi_hal_cdc_send(usb_uart->cfg.vcp_ch, usb_uart->rx_buf, len);
-                    furi_check(osMutexRelease(usb_uart->usb_mutex) == osOK);
-                } else {
-                    xStreamBufferReset(usb_uart->rx_stream);
-                }
-            }
+        if(events & WorkerEvtRxIdle) {
+            usb_uart_rx_send(usb_uart, true);
+            rx_active = false;
+        } else if(events & WorkerEvtRxDone) {
+            usb_uart_rx_send(usb_uart, false);
+            rx_active = true;
         }
         if(events & WorkerEvtCfgChange) {
             if(usb_uart->cfg.vcp_ch != usb_uart->cfg_new.vcp_ch) {
@@ -205,9 +259,10 @@ static int32_t usb_uart_worker(void* context) {
                 furi_thread_join(usb_uart->tx_thread);
 
                 usb_uart_serial_deinit(usb_uart, usb_uart->cfg.uart_ch);
-                usb_uart_serial_init(usb_uart, usb_uart->cfg_new.uart_ch);
-
+                // RX interrupt callback reads channel from config
                 usb_uart->cfg.uart_ch = usb_uart->cfg_new.uart_ch;
+                usb_uart_serial_init(usb_uart, usb_uart->cfg.uart_ch);
+
                 usb_uart_set_baudrate(usb_uart, usb_uart->cfg.baudrate);
 
                 furi_thread_start(usb_uart->tx_thread);
@@ -257,7 +312,6 @@ static int32_t usb_uart_worker(void* context) {
     furi_thread_join(usb_uart->tx_thread);
     furi_thread_free(usb_uart->tx_thread);
 
-    vStreamBufferDelete(usb_uart->rx_stream);
     osMutexDelete(usb_uart->usb_mutex);
     osSemaphoreDelete(usb_uart->tx_sem);
 
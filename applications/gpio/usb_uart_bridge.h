@@ -15,6 +15,7 @@ typedef struct {
 typedef struct {
     uint32_t rx_cnt;
     uint32_t tx_cnt;
+    uint32_t rx_overrun_cnt;
     uint32_t baudrate_cur;
 } UsbUartState;
 
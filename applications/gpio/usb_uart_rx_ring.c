@@ -0,0 +1,65 @@
+#include "usb_uart_rx_ring.h"
+#include <furi.h>
+#include <string.h>
+
+void usb_uart_rx_ring_init(UsbUartRxRing* ring, uint8_t* buffer, size_t size) {
+    furi_assert(buffer);
+    // Free running counters wrap correctly only with power of two sizes
+    furi_assert(size > 0 && (size & (size - 1)) == 0);
+    ring->buffer = buffer;
+    ring->size = size;
+    ring->write_pos = 0;
+    ring->write_cnt = 0;
+    ring->read_cnt = 0;
+    ring->overrun_cnt = 0;
+}
+
+void usb_uart_rx_ring_update(UsbUartRxRing* ring, size_t dma_pos) {
+    size_t written = (dma_pos - ring->write_pos) & (ring->size - 1);
+    ring->write_pos = dma_pos;
+    ring->write_cnt += written;
+}
+
+size_t usb_uart_rx_ring_get_pending(UsbUartRxRing* ring) {
+    return ring->write_cnt - ring->read_cnt;
+}
+
+size_t usb_uart_rx_ring_read(UsbUartRxRing* ring, uint8_t* data, size_t packet_size, bool flush) {
+    uint32_t write_cnt = ring->write_cnt;
+    size_t pending = write_cnt - ring->read_cnt;
+
+    if(pending > ring->size) {
+        // DMA went over unread data, nothing in the buffer can be trusted
+        ring->overrun_cnt += pending;
+        ring->read_cnt = write_cnt;
+        return 0;
+    }
+    if(pending < packet_size) {
+        if(!flush) return 0;
+        packet_size = pending;
+    }
+
+    size_t read_pos = ring->read_cnt & (ring->size - 1);
+    size_t tail_len = ring->size - read_pos;
+    if(tail_len >= packet_size) {
+        memcpy(data, &ring->buffer[read_pos], packet_size);
+    } else {
+        memcpy(data, &ring->buffer[read_pos], tail_len);
+        memcpy(&data[tail_len], ring->buffer, packet_size - tail_len);
+    }
+    ring->read_cnt += packet_size;
+
+    return packet_size;
+}
+
+size_t usb_uart_rx_ring_drop(UsbUartRxRing* ring) {
+    uint32_t write_cnt = ring->write_cnt;
+    size_t pending = write_cnt - ring->read_cnt;
+    ring->overrun_cnt += pending;
+    ring->read_cnt = write_cnt;
+    return pending;
+}
+
+uint32_t usb_uart_rx_ring_get_overrun(UsbUartRxRing* ring) {
+    return ring->overrun_cnt;
+}
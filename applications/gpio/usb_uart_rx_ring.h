@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Consumer side of a circular DMA receive buffer
+ * DMA writes the buffer in circles, producer side only reports DMA position
+ * with usb_uart_rx_ring_update. Counters are free running, so buffer size must be
+ * a power of two. Has no hardware dependencies, so it can be driven by a loopback model.
+ */
+typedef struct {
+    uint8_t* buffer;
+    size_t size;
+    size_t write_pos;
+    volatile uint32_t write_cnt;
+    uint32_t read_cnt;
+    uint32_t overrun_cnt;
+} UsbUartRxRing;
+
+/**
+ * Init ring
+ * @param ring ring instance
+ * @param buffer DMA buffer
+ * @param size buffer size, power of two
+ */
+void usb_uart_rx_ring_init(UsbUartRxRing* ring, uint8_t* buffer, size_t size);
+
+/**
+ * Account bytes written by DMA since the previous update
+ * Must be called at least twice per buffer turn (DMA half and full transfer events)
+ * and never concurrently with itself
+ * @param ring ring instance
+ * @param dma_pos offset where DMA will store next byte
+ */
+void usb_uart_rx_ring_update(UsbUartRxRing* ring, size_t dma_pos);
+
+/**
+ * Get count of received bytes not read yet
+ * @param ring ring instance
+ * @return bytes count, may exceed buffer size if DMA lapped the reader
+ */
+size_t usb_uart_rx_ring_get_pending(UsbUartRxRing* ring);
+
+/**
+ * Read next packet
+ * Only full packets are returned unless flush is requested. If DMA lapped the reader
+ * pending bytes are dropped and added to overrun counter.
+ * @param ring ring instance
+ * @param data output buffer
+ * @param packet_size packet size, output buffer size
+ * @param flush return partial packet if there is not enough data for a full one
+ * @return packet size or 0
+ */
+size_t usb_uart_rx_ring_read(UsbUartRxRing* ring, uint8_t* data, size_t packet_size, bool flush);
+
+/**
+ * Drop all pending bytes, they are added to overrun counter
+ * @param ring ring instance
+ * @return dropped bytes count
+ */
+size_t usb_uart_rx_ring_drop(UsbUartRxRing* ring);
+
+/**
+ * Get count of bytes lost on overruns
+ * @param ring ring instance
+ * @return bytes count
+ */
+uint32_t usb_uart_rx_ring_get_overrun(UsbUartRxRing* ring);
+
+#ifdef __cplusplus
+}
+#endif
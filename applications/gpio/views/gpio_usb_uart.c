@@ -13,6 +13,7 @@ typedef struct {
     uint32_t baudrate;
     uint32_t tx_cnt;
     uint32_t rx_cnt;
+    uint32_t rx_overrun_cnt;
     uint8_t vcp_port;
     uint8_t tx_pin;
     uint8_t rx_pin;
@@ -74,6 +75,12 @@ static void gpio_usb_uart_draw_callback(Canvas* canvas, void* _model) {
         canvas_draw_str_aligned(canvas, 111, 41, AlignRight, AlignBottom, temp_str);
     }
 
+    if(model->rx_overrun_cnt > 0) {
+        canvas_set_font(canvas, FontSecondary);
+        snprintf(temp_str, 18, "Lost: %lu", model->rx_overrun_cnt);
+        canvas_draw_str_aligned(canvas, 127, 51, AlignRight, AlignBottom, temp_str);
+    }
+
     if(model->tx_active)
         canvas_draw_icon(canvas, 48, 14, &I_ArrowUpFilled_14x15);
     else
@@ -151,6 +158,7 @@ void gpio_usb_uart_update_state(GpioUsbUart* instance, UsbUartConfig* cfg, UsbUa
             model->rx_active = (model->rx_cnt != st->rx_cnt);
             model->tx_cnt = st->tx_cnt;
             model->rx_cnt = st->rx_cnt;
+            model->rx_overrun_cnt = st->rx_overrun_cnt;
             return true;
         });
 }
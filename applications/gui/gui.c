@@ -211,6 +211,7 @@ void gui_redraw(Gui* gui) {
     }
 
     canvas_commit(gui->canvas);
+    gui_event_notify(gui, GuiEventFrame);
     if(gui->canvas_callback) {
         gui->canvas_callback(
             canvas_get_buffer(gui->canvas),
@@ -315,6 +316,7 @@ void gui_add_view_port(Gui* gui, ViewPort* view_port, GuiLayer layer) {
     view_port_gui_set(view_port, gui);
     gui_unlock(gui);
 
+    gui_event_notify(gui, GuiEventViewPortAdded);
     gui_update(gui);
 }
 
@@ -408,6 +410,21 @@ void gui_set_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, vo
     }
 }
 
+void gui_set_event_callback(Gui* gui, GuiEventCallback callback, void* context) {
+    furi_assert(gui);
+    gui_lock(gui);
+    // Callback is read without lock: it never sees context of other callback
+    gui->event_callback = NULL;
+    gui->event_callback_context = context;
+    gui->event_callback = callback;
+    gui_unlock(gui);
+}
+
+void gui_event_notify(Gui* gui, GuiEvent event) {
+    GuiEventCallback callback = gui->event_callback;
+    if(callback) callback(event, gui->event_callback_context);
+}
+
 void gui_set_lockdown(Gui* gui, bool lockdown) {
     furi_assert(gui);
     gui_lock(gui);
@@ -29,6 +29,15 @@ typedef enum {
 /** Gui Canvas Commit Callback */
 typedef void (*GuiCanvasCommitCallback)(uint8_t* data, size_t size, void* context);
 
+/** Gui events for profiling */
+typedef enum {
+    GuiEventViewPortAdded, /**< View port added, called from thread that added it */
+    GuiEventViewDispatcherRun, /**< View dispatcher started, called from its thread */
+    GuiEventFrame, /**< Frame committed, called from GUI thread */
+} GuiEvent;
+
+typedef void (*GuiEventCallback)(GuiEvent event, void* context);
+
 typedef struct Gui Gui;
 
 /** Add view_port to view_port tree
@@ -79,6 +88,16 @@ void gui_view_port_send_to_back(Gui* gui, ViewPort* view_port);
  */
 void gui_set_framebuffer_callback(Gui* gui, GuiCanvasCommitCallback callback, void* context);
 
+/** Set gui event callback
+ *
+ * Callback is called from GUI and application threads, must be short and must not block
+ *
+ * @param      gui       Gui instance
+ * @param      callback  GuiEventCallback
+ * @param      context   GuiEventCallback context
+ */
+void gui_set_event_callback(Gui* gui, GuiEventCallback callback, void* context);
+
 /** Set lockdown mode
  *
  * When lockdown mode is enabled, only GuiLayerDesktop is shown.
@@ -54,6 +54,8 @@ struct Gui {
     Canvas* canvas;
     GuiCanvasCommitCallback canvas_callback;
     void* canvas_callback_context;
+    volatile GuiEventCallback event_callback;
+    void* event_callback_context;
 
     // Input
     osMessageQueueId_t input_queue;
@@ -72,6 +74,13 @@ void gui_update(Gui* gui);
 
 void gui_input_events_callback(const void* value, void* ctx);
 
+/** Call event callback, if any
+ *
+ * @param      gui    Gui instance
+ * @param      event  GuiEvent
+ */
+void gui_event_notify(Gui* gui, GuiEvent event);
+
 void gui_lock(Gui* gui);
 
 void gui_unlock(Gui* gui);
@@ -1,23 +1,25 @@
 #include "text_box.h"
+#include "text_box_layout.h"
 #include "gui/canvas.h"
-#include <m-string.h>
 #include <furi.h>
 #include <gui/elements.h>
 #include <stdint.h>
 
+#define TEXT_BOX_TEXT_WIDTH (140)
+#define TEXT_BOX_LINES_ON_SCREEN (5)
+#define TEXT_BOX_LINES_MAX (128)
+
 struct TextBox {
     View* view;
 };
 
 typedef struct {
-    const char* text;
-    char* text_pos;
-    string_t text_formatted;
+    TextBoxLayout* layout;
     int32_t scroll_pos;
     int32_t scroll_num;
+    bool scroll_tail;
     TextBoxFont font;
     TextBoxFocus focus;
-    bool formatted;
 } TextBoxModel;
 
 static void text_box_process_down(TextBox* text_box) {
@@ -25,10 +27,9 @@ static void text_box_process_down(TextBox* text_box) {
         text_box->view, (TextBoxModel * model) {
             if(model->scroll_pos < model->scroll_num - 1) {
                 model->scroll_pos++;
-                // Search next line start
-                while(*model->text_pos++ != '\n')
-                    ;
             }
+            // Follow appended text when scrolled to the end
+            model->scroll_tail = (model->scroll_pos >= model->scroll_num - 1);
             return true;
         });
 }
@@ -38,67 +39,20 @@ static void text_box_process_up(TextBox* text_box) {
         text_box->view, (TextBoxModel * model) {
             if(model->scroll_pos > 0) {
                 model->scroll_pos--;
-                // Reach last symbol of previous line
-                model->text_pos--;
-                // Search prevous line start
-                while((model->text_pos != model->text) && (*(--model->text_pos) != '\n'))
-                    ;
-                if(*model->text_pos == '\n') {
-                    model->text_pos++;
-                }
+                model->scroll_tail = false;
             }
             return true;
         });
 }
 
-static void text_box_insert_endline(Canvas* canvas, TextBoxModel* model) {
-    size_t i = 0;
-    size_t line_width = 0;
-    const char* str = model->text;
-    size_t line_num = 0;
-
-    const size_t text_width = 140;
-
-    while(str[i] != '\0') {
-        char symb = str[i++];
-        if(symb != '\n') {
-            line_width += canvas_glyph_width(canvas, symb) + 1;
-            if(line_width > text_width) {
-                line_num++;
-                line_width = 0;
-                string_push_back(model->text_formatted, '\n');
-            }
-        } else {
-            line_num++;
-            line_width = 0;
-        }
-        string_push_back(model->text_formatted, symb);
-    }
-    line_num++;
-    model->text = string_get_cstr(model->text_formatted);
-    model->text_pos = (char*)model->text;
-    if(model->focus == TextBoxFocusEnd && line_num > 5) {
-        // Set text position to 5th line from the end
-        for(uint8_t i = 0; i < line_num - 5; i++) {
-            while(*model->text_pos++ != '\n') {
-            };
-        }
-        model->scroll_num = line_num - 4;
-        model->scroll_pos = line_num - 5;
-    } else {
-        model->scroll_num = MAX(line_num - 4, 0);
-        model->scroll_pos = 0;
-    }
+static uint8_t text_box_glyph_width(char symbol, void* context) {
+    Canvas* canvas = context;
+    return canvas_glyph_width(canvas, symbol);
 }
 
 static void text_box_view_draw_callback(Canvas* canvas, void* _model) {
     TextBoxModel* model = _model;
 
-    if(!model->formatted) {
-        text_box_insert_endline(canvas, model);
-        model->formatted = true;
-    }
-
     canvas_clear(canvas);
     elements_slightly_rounded_frame(canvas, 0, 0, 124, 64);
     if(model->font == TextBoxFontText) {
@@ -106,7 +60,29 @@ static void text_box_view_draw_callback(Canvas* canvas, void* _model) {
     } else if(model->font == TextBoxFontHex) {
         canvas_set_font(canvas, FontKeyboard);
     }
-    elements_multiline_text(canvas, 3, 11, model->text_pos);
+
+    // Only text added since last draw is wrapped
+    text_box_layout_update(
+        model->layout, model->font, TEXT_BOX_TEXT_WIDTH, text_box_glyph_width, canvas);
+    int32_t lines_count = text_box_layout_get_lines_count(model->layout);
+    model->scroll_num = MAX(lines_count - (TEXT_BOX_LINES_ON_SCREEN - 1), 0);
+    if(model->scroll_tail) {
+        model->scroll_pos = MAX(model->scroll_num - 1, 0);
+    } else {
+        model->scroll_pos = MIN(model->scroll_pos, MAX(model->scroll_num - 1, 0));
+    }
+
+    // Draw visible lines only
+    char line[TEXT_BOX_LAYOUT_LINE_LEN_MAX + 1];
+    uint8_t font_height = canvas_current_font_height(canvas);
+    int32_t index = model->scroll_pos;
+    for(uint8_t y = 11; (y < 64) && (index < lines_count); y += font_height) {
+        size_t length = 0;
+        const char* str = text_box_layout_get_line(model->layout, index++, &length);
+        memcpy(line, str, length);
+        line[length] = '\0';
+        canvas_draw_str(canvas, 3, y, line);
+    }
     elements_scrollbar(canvas, model->scroll_pos, model->scroll_num);
 }
 
@@ -137,9 +113,7 @@ TextBox* text_box_alloc() {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            model->text = NULL;
-            string_init_set_str(model->text_formatted, "");
-            model->formatted = false;
+            model->layout = text_box_layout_alloc(TEXT_BOX_LINES_MAX);
             model->font = TextBoxFontText;
             return true;
         });
@@ -152,7 +126,7 @@ void text_box_free(TextBox* text_box) {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            string_clear(model->text_formatted);
+            text_box_layout_free(model->layout);
             return true;
         });
     view_free(text_box->view);
@@ -169,8 +143,10 @@ void text_box_reset(TextBox* text_box) {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            model->text = NULL;
-            string_set_str(model->text_formatted, "");
+            text_box_layout_reset(model->layout);
+            model->scroll_pos = 0;
+            model->scroll_num = 0;
+            model->scroll_tail = false;
             model->font = TextBoxFontText;
             model->focus = TextBoxFocusStart;
             return true;
@@ -183,10 +159,20 @@ void text_box_set_text(TextBox* text_box, const char* text) {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            model->text = text;
-            string_reset(model->text_formatted);
-            string_reserve(model->text_formatted, strlen(text));
-            model->formatted = false;
+            text_box_layout_set_text(model->layout, text);
+            model->scroll_pos = 0;
+            model->scroll_tail = (model->focus == TextBoxFocusEnd);
+            return true;
+        });
+}
+
+void text_box_append_text(TextBox* text_box, const char* text) {
+    furi_assert(text_box);
+    furi_assert(text);
+
+    with_view_model(
+        text_box->view, (TextBoxModel * model) {
+            text_box_layout_append(model->layout, text);
             return true;
         });
 }
@@ -207,6 +193,7 @@ void text_box_set_focus(TextBox* text_box, TextBoxFocus focus) {
     with_view_model(
         text_box->view, (TextBoxModel * model) {
             model->focus = focus;
+            model->scroll_tail = (focus == TextBoxFocusEnd);
             return true;
         });
 }
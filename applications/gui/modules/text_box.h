@@ -51,12 +51,23 @@ View* text_box_get_view(TextBox* text_box);
 void text_box_reset(TextBox* text_box);
 
 /** Set text for text_box
+ * @note Text is not copied and must stay valid until reset or next set.
+ * All lines are shown.
  *
  * @param      text_box  TextBox instance
  * @param      text      text to set
  */
 void text_box_set_text(TextBox* text_box, const char* text);
 
+/** Append text to text_box
+ * @note TextBox keeps copy of text, only the last 128 lines are kept.
+ * Text set by text_box_set_text is copied and continued.
+ *
+ * @param      text_box  TextBox instance
+ * @param      text      text to append
+ */
+void text_box_append_text(TextBox* text_box, const char* text);
+
 /** Set TextBox font
  *
  * @param      text_box  TextBox instance
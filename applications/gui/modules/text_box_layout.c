@@ -0,0 +1,255 @@
+#include "text_box_layout.h"
+#include <furi.h>
+
+#define TEXT_BOX_LAYOUT_BUFFER_SIZE_MIN (64)
+// Dropped lines are removed from owned text when they take half of the buffer
+#define TEXT_BOX_LAYOUT_COMPACT_SIZE_MIN (512)
+
+struct TextBoxLayout {
+    // Current text, points to caller text or to owned buffer
+    const char* text;
+    size_t text_size;
+    bool text_owned;
+    char* buffer;
+    size_t buffer_capacity;
+
+    // Ring of line start offsets in text, grows for caller text
+    size_t* lines;
+    size_t lines_capacity;
+    size_t lines_max;
+    size_t lines_head;
+    size_t lines_count;
+
+    // Wrapping state of last line
+    size_t laid_out;
+    uint16_t line_width;
+    uint8_t line_len;
+
+    // Glyph widths of font used for last update
+    bool widths_valid;
+    uint8_t font;
+    uint16_t width;
+    uint8_t widths[UINT8_MAX + 1];
+};
+
+static void text_box_layout_grow_lines(TextBoxLayout* layout) {
+    size_t capacity = layout->lines_capacity * 2;
+    size_t* lines = malloc(capacity * sizeof(size_t));
+    for(size_t i = 0; i < layout->lines_count; i++) {
+        lines[i] = layout->lines[(layout->lines_head + i) % layout->lines_capacity];
+    }
+    free(layout->lines);
+    layout->lines = lines;
+    layout->lines_capacity = capacity;
+    layout->lines_head = 0;
+}
+
+static void text_box_layout_push_line(TextBoxLayout* layout, size_t start) {
+    // Only appended text is limited, caller text keeps all lines
+    while(layout->text_owned && (layout->lines_count >= layout->lines_max)) {
+        layout->lines_head = (layout->lines_head + 1) % layout->lines_capacity;
+        layout->lines_count--;
+    }
+    if(layout->lines_count == layout->lines_capacity) {
+        text_box_layout_grow_lines(layout);
+    }
+    layout->lines[(layout->lines_head + layout->lines_count) % layout->lines_capacity] = start;
+    layout->lines_count++;
+    layout->line_width = 0;
+    layout->line_len = 0;
+}
+
+static void text_box_layout_restart(TextBoxLayout* layout, size_t start) {
+    layout->lines_head = 0;
+    layout->lines_count = 0;
+    layout->laid_out = start;
+    text_box_layout_push_line(layout, start);
+}
+
+static void text_box_layout_wrap(TextBoxLayout* layout) {
+    const char* text = layout->text;
+
+    while(layout->laid_out < layout->text_size) {
+        char symbol = text[layout->laid_out];
+        if(symbol == '\n') {
+            text_box_layout_push_line(layout, layout->laid_out + 1);
+        } else {
+            uint16_t symbol_width = layout->widths[(uint8_t)symbol] + 1;
+            if(layout->line_len &&
+               ((layout->line_len == TEXT_BOX_LAYOUT_LINE_LEN_MAX) ||
+                (layout->line_width + symbol_width > layout->width))) {
+                text_box_layout_push_line(layout, layout->laid_out);
+            }
+            layout->line_width += symbol_width;
+            layout->line_len++;
+        }
+        layout->laid_out++;
+    }
+}
+
+static void text_box_layout_cut(TextBoxLayout* layout, size_t size) {
+    memmove(layout->buffer, &layout->buffer[size], layout->text_size - size + 1);
+    layout->text_size -= size;
+}
+
+static void text_box_layout_compact(TextBoxLayout* layout) {
+    if(!layout->text_owned) return;
+
+    size_t start = layout->lines[layout->lines_head];
+    if((start >= TEXT_BOX_LAYOUT_COMPACT_SIZE_MIN) && (start * 2 >= layout->text_size)) {
+        text_box_layout_cut(layout, start);
+        layout->laid_out -= start;
+        for(size_t i = 0; i < layout->lines_count; i++) {
+            layout->lines[(layout->lines_head + i) % layout->lines_capacity] -= start;
+        }
+    }
+}
+
+// Text that is not wrapped yet is limited to what ring can hold.
+// Last lines_max lines take no more than size_max bytes, so text up to line break before them
+// is dropped on wrap anyway. Line break resets wrapping, so remaining lines are the same.
+static void text_box_layout_trim(TextBoxLayout* layout) {
+    size_t size_max = layout->lines_max * (TEXT_BOX_LAYOUT_LINE_LEN_MAX + 1);
+    if(layout->text_size <= size_max + size_max / 2) return;
+
+    size_t line_break = layout->text_size - size_max;
+    while(line_break > 0) {
+        line_break--;
+        if(layout->buffer[line_break] == '\n') {
+            text_box_layout_cut(layout, line_break + 1);
+            text_box_layout_restart(layout, 0);
+            break;
+        }
+    }
+}
+
+static void text_box_layout_reserve(TextBoxLayout* layout, size_t size) {
+    if(size + 1 <= layout->buffer_capacity) return;
+
+    while(layout->buffer_capacity < size + 1) {
+        layout->buffer_capacity *= 2;
+    }
+    layout->buffer = realloc(layout->buffer, layout->buffer_capacity);
+    layout->text = layout->buffer;
+}
+
+TextBoxLayout* text_box_layout_alloc(size_t lines_max) {
+    furi_assert(lines_max);
+
+    TextBoxLayout* layout = malloc(sizeof(TextBoxLayout));
+    memset(layout, 0, sizeof(TextBoxLayout));
+    layout->buffer_capacity = TEXT_BOX_LAYOUT_BUFFER_SIZE_MIN;
+    layout->buffer = malloc(layout->buffer_capacity);
+    layout->lines_max = lines_max;
+    layout->lines_capacity = lines_max;
+    layout->lines = malloc(lines_max * sizeof(size_t));
+    text_box_layout_reset(layout);
+
+    return layout;
+}
+
+void text_box_layout_free(TextBoxLayout* layout) {
+    furi_assert(layout);
+
+    free(layout->lines);
+    free(layout->buffer);
+    free(layout);
+}
+
+void text_box_layout_reset(TextBoxLayout* layout) {
+    furi_assert(layout);
+
+    // Free lines grown for caller text
+    if(layout->lines_capacity > layout->lines_max) {
+        free(layout->lines);
+        layout->lines_capacity = layout->lines_max;
+        layout->lines = malloc(layout->lines_capacity * sizeof(size_t));
+    }
+    layout->buffer[0] = '\0';
+    layout->text = layout->buffer;
+    layout->text_size = 0;
+    layout->text_owned = true;
+    text_box_layout_restart(layout, 0);
+}
+
+void text_box_layout_set_text(TextBoxLayout* layout, const char* text) {
+    furi_assert(layout);
+    furi_assert(text);
+
+    layout->text = text;
+    layout->text_size = strlen(text);
+    layout->text_owned = false;
+    text_box_layout_restart(layout, 0);
+}
+
+void text_box_layout_append(TextBoxLayout* layout, const char* text) {
+    furi_assert(layout);
+    furi_assert(text);
+
+    size_t size = strlen(text);
+    if(!layout->text_owned) {
+        // Continue caller text from own copy, offsets stay the same
+        const char* caller_text = layout->text;
+        text_box_layout_reserve(layout, layout->text_size + size);
+        memcpy(layout->buffer, caller_text, layout->text_size);
+        layout->text = layout->buffer;
+        layout->text_owned = true;
+    }
+
+    text_box_layout_reserve(layout, layout->text_size + size);
+    memcpy(&layout->buffer[layout->text_size], text, size + 1);
+    layout->text_size += size;
+
+    if(layout->widths_valid) {
+        text_box_layout_wrap(layout);
+        text_box_layout_compact(layout);
+    } else {
+        text_box_layout_trim(layout);
+    }
+}
+
+void text_box_layout_update(
+    TextBoxLayout* layout,
+    uint8_t font,
+    uint16_t width,
+    TextBoxLayoutGlyphWidth glyph_width,
+    void* context) {
+    furi_assert(layout);
+    furi_assert(glyph_width);
+
+    if(!layout->widths_valid || (layout->font != font) || (layout->width != width)) {
+        memset(layout->widths, 0, sizeof(layout->widths));
+        for(size_t i = ' '; i <= UINT8_MAX; i++) {
+            layout->widths[i] = glyph_width((char)i, context);
+        }
+        layout->widths_valid = true;
+        layout->font = font;
+        layout->width = width;
+        // Line breaks depend on glyph widths, wrap again from oldest line
+        text_box_layout_restart(layout, layout->lines[layout->lines_head]);
+    }
+
+    text_box_layout_wrap(layout);
+    text_box_layout_compact(layout);
+}
+
+size_t text_box_layout_get_lines_count(TextBoxLayout* layout) {
+    furi_assert(layout);
+    return layout->lines_count;
+}
+
+const char* text_box_layout_get_line(TextBoxLayout* layout, size_t index, size_t* length) {
+    furi_assert(layout);
+    furi_assert(index < layout->lines_count);
+    furi_assert(length);
+
+    size_t start = layout->lines[(layout->lines_head + index) % layout->lines_capacity];
+    size_t end = layout->laid_out;
+    if(index + 1 < layout->lines_count) {
+        end = layout->lines[(layout->lines_head + index + 1) % layout->lines_capacity];
+        if(layout->text[end - 1] == '\n') end--;
+    }
+    *length = end - start;
+
+    return &layout->text[start];
+}
@@ -0,0 +1,107 @@
+/**
+ * @file text_box_layout.h
+ * GUI: TextBox word-wrap layout engine
+ *
+ * Keeps line start offsets in a ring and wraps only text added since last update.
+ * Caller text keeps all its lines, the ring limit applies once text is appended.
+ * Glyph widths are cached per font, so appended text can be wrapped without canvas.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max chars in one line, longer lines are wrapped regardless of width */
+#define TEXT_BOX_LAYOUT_LINE_LEN_MAX (64)
+
+/** TextBoxLayout anonymous structure */
+typedef struct TextBoxLayout TextBoxLayout;
+
+/** Glyph width provider, usually canvas_glyph_width with font already set
+ *
+ * @param      symbol   symbol
+ * @param      context  callback context
+ *
+ * @return     glyph width in pixels
+ */
+typedef uint8_t (*TextBoxLayoutGlyphWidth)(char symbol, void* context);
+
+/** Allocate layout
+ *
+ * @param      lines_max  lines kept of appended text, oldest lines are dropped
+ *
+ * @return     TextBoxLayout instance
+ */
+TextBoxLayout* text_box_layout_alloc(size_t lines_max);
+
+/** Free layout
+ *
+ * @param      layout  TextBoxLayout instance
+ */
+void text_box_layout_free(TextBoxLayout* layout);
+
+/** Drop text and lines
+ *
+ * @param      layout  TextBoxLayout instance
+ */
+void text_box_layout_reset(TextBoxLayout* layout);
+
+/** Set text owned by caller, text must stay valid until reset or next set
+ * All lines of text are kept.
+ *
+ * @param      layout  TextBoxLayout instance
+ * @param      text    null terminated text
+ */
+void text_box_layout_set_text(TextBoxLayout* layout, const char* text);
+
+/** Append text, layout keeps its own copy and last lines_max lines
+ * Text is wrapped immediately if glyph widths are already cached.
+ *
+ * @param      layout  TextBoxLayout instance
+ * @param      text    null terminated text
+ */
+void text_box_layout_append(TextBoxLayout* layout, const char* text);
+
+/** Wrap text not laid out yet
+ * Whole text is wrapped again only if font or width differ from previous update.
+ *
+ * @param      layout       TextBoxLayout instance
+ * @param      font         font id, any value identifying glyph widths
+ * @param      width        line width in pixels
+ * @param      glyph_width  glyph width provider
+ * @param      context      glyph width provider context
+ */
+void text_box_layout_update(
+    TextBoxLayout* layout,
+    uint8_t font,
+    uint16_t width,
+    TextBoxLayoutGlyphWidth glyph_width,
+    void* context);
+
+/** Get count of lines in ring
+ *
+ * @param      layout  TextBoxLayout instance
+ *
+ * @return     lines count
+ */
+size_t text_box_layout_get_lines_count(TextBoxLayout* layout);
+
+/** Get line
+ *
+ * @param      layout  TextBoxLayout instance
+ * @param      index   line index, 0 is oldest line in ring
+ * @param      length  line length without line break, no more than TEXT_BOX_LAYOUT_LINE_LEN_MAX
+ *
+ * @return     pointer to line start, not null terminated
+ */
+const char* text_box_layout_get_line(TextBoxLayout* layout, size_t index, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
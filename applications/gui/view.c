@@ -85,6 +85,13 @@ void view_allocate_model(View* view, ViewModelType type, size_t size) {
         furi_check(model->mutex);
         model->data = malloc(size);
         view->model = model;
+    } else if(view->model_type == ViewModelTypeSnapshot) {
+        ViewModelSnapshot* model = malloc(sizeof(ViewModelSnapshot));
+        model->mutex = osMutexNew(NULL);
+        furi_check(model->mutex);
+        model->buffer = triple_buffer_alloc(size);
+        model->update_pending = false;
+        view->model = model;
     } else {
         furi_assert(false);
     }
@@ -102,6 +109,12 @@ void view_free_model(View* view) {
         free(model->data);
         free(model);
         view->model = NULL;
+    } else if(view->model_type == ViewModelTypeSnapshot) {
+        ViewModelSnapshot* model = view->model;
+        furi_check(osMutexDelete(model->mutex) == osOK);
+        triple_buffer_free(model->buffer);
+        free(model);
+        view->model = NULL;
     } else {
         furi_assert(false);
     }
@@ -113,12 +126,24 @@ void* view_get_model(View* view) {
         ViewModelLocking* model = (ViewModelLocking*)(view->model);
         furi_check(osMutexAcquire(model->mutex, osWaitForever) == osOK);
         return model->data;
+    } else if(view->model_type == ViewModelTypeSnapshot) {
+        ViewModelSnapshot* model = (ViewModelSnapshot*)(view->model);
+        furi_check(osMutexAcquire(model->mutex, osWaitForever) == osOK);
+        return triple_buffer_get_back(model->buffer);
     }
     return view->model;
 }
 
 void view_commit_model(View* view, bool update) {
     furi_assert(view);
+    if(view->model_type == ViewModelTypeSnapshot) {
+        ViewModelSnapshot* model = (ViewModelSnapshot*)(view->model);
+        triple_buffer_publish(model->buffer);
+        // Updates are coalesced: one redraw is requested until snapshot is drawn
+        if(update && __atomic_exchange_n(&model->update_pending, true, __ATOMIC_ACQ_REL)) {
+            update = false;
+        }
+    }
     view_unlock_model(view);
     if(update && view->update_callback) {
         view->update_callback(view, view->update_callback_context);
@@ -138,15 +163,24 @@ void view_unlock_model(View* view) {
     if(view->model_type == ViewModelTypeLocking) {
         ViewModelLocking* model = (ViewModelLocking*)(view->model);
         furi_check(osMutexRelease(model->mutex) == osOK);
+    } else if(view->model_type == ViewModelTypeSnapshot) {
+        ViewModelSnapshot* model = (ViewModelSnapshot*)(view->model);
+        furi_check(osMutexRelease(model->mutex) == osOK);
     }
 }
 
 void view_draw(View* view, Canvas* canvas) {
     furi_assert(view);
     if(view->draw_callback) {
-        void* data = view_get_model(view);
-        view->draw_callback(canvas, data);
-        view_unlock_model(view);
+        if(view->model_type == ViewModelTypeSnapshot) {
+            ViewModelSnapshot* model = (ViewModelSnapshot*)(view->model);
+            __atomic_store_n(&model->update_pending, false, __ATOMIC_RELEASE);
+            view->draw_callback(canvas, triple_buffer_get_front(model->buffer));
+        } else {
+            void* data = view_get_model(view);
+            view->draw_callback(canvas, data);
+            view_unlock_model(view);
+        }
     }
 }
 
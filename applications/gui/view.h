@@ -86,6 +86,13 @@ typedef enum {
      * Locking gui thread.
      */
     ViewModelTypeLocking,
+    /** Model is triple buffered, for models updated at high rate.
+     * Writers are serialized with mutex and never wait for gui thread,
+     * draw callback gets the latest committed copy without locking.
+     * Model must be plain data without pointers to mutable memory,
+     * changes made by draw callback are discarded.
+     */
+    ViewModelTypeSnapshot,
 } ViewModelType;
 
 /** Allocate and init View
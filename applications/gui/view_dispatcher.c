@@ -76,6 +76,7 @@ void view_dispatcher_set_tick_event_callback(
 void view_dispatcher_run(ViewDispatcher* view_dispatcher) {
     furi_assert(view_dispatcher);
     furi_assert(view_dispatcher->queue);
+    if(view_dispatcher->gui) gui_event_notify(view_dispatcher->gui, GuiEventViewDispatcherRun);
 
     uint32_t tick_period = view_dispatcher->tick_period == 0 ? osWaitForever :
                                                                view_dispatcher->tick_period;
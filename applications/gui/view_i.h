@@ -7,12 +7,21 @@
 
 #include "view.h"
 #include <furi.h>
+#include <toolbox/triple_buffer.h>
 
 typedef struct {
     void* data;
     osMutexId_t mutex;
 } ViewModelLocking;
 
+typedef struct {
+    TripleBuffer* buffer;
+    // Serializes writers, never taken by gui thread
+    osMutexId_t mutex;
+    // Redraw is requested and snapshot is not drawn yet
+    bool update_pending;
+} ViewModelSnapshot;
+
 struct View {
     ViewDrawCallback draw_callback;
     ViewInputCallback input_callback;
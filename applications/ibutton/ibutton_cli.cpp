@@ -6,6 +6,7 @@
 
 #include "helpers/key_info.h"
 #include "helpers/key_worker.h"
+#include <maxim_crc.h>
 
 #include <memory>
 
@@ -244,31 +245,48 @@ void onewire_cli_print_usage() {
 
 void onewire_cli_search(Cli* cli) {
     OneWireMaster onewire(&ibutton_gpio);
-    uint8_t address[8];
-    bool done = false;
+    // ROMs are verified and printed in batches, search goes on until the last device
+    static const size_t roms_max = 16;
+    uint8_t roms[roms_max][MAXIM_ROM_SIZE];
+    bool roms_valid[roms_max];
+    bool searching = true;
 
     printf("Search started\r\n");
 
     onewire.start();
     furi_hal_power_enable_otg();
 
-    while(!done) {
-        if(onewire.search(address, true) != 1) {
-            printf("Search finished\r\n");
-            onewire.reset_search();
-            done = true;
-        } else {
+    while(searching) {
+        size_t roms_count = 0;
+        while(roms_count < roms_max) {
+            if(onewire.search(roms[roms_count], true) != 1) {
+                onewire.reset_search();
+                searching = false;
+                break;
+            }
+            roms_count++;
+            delay(100);
+        }
+
+        maxim_crc8_verify_roms(&roms[0][0], roms_count, roms_valid);
+        for(size_t i = 0; i < roms_count; i++) {
             printf("Found: ");
-            for(uint8_t i = 0; i < 8; i++) {
-                printf("%02X", address[i]);
+            for(uint8_t j = 0; j < MAXIM_ROM_SIZE; j++) {
+                printf("%02X", roms[i][j]);
             }
-            printf("\r\n");
+            printf(roms_valid[i] ? "\r\n" : " CRC error\r\n");
+        }
+
+        if(cli_cmd_interrupt_received(cli)) {
+            printf("Search interrupted\r\n");
+            searching = false;
         }
-        delay(100);
     }
 
     furi_hal_power_disable_otg();
     onewire.stop();
+
+    printf("Search finished\r\n");
 }
 
 void onewire_cli(Cli* cli, string_t args, void* context) {
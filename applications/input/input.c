@@ -6,38 +6,50 @@
 
 static Input* input = NULL;
 
-inline static void input_timer_start(osTimerId_t timer_id, uint32_t ticks) {
-    TimerHandle_t hTimer = (TimerHandle_t)timer_id;
-    furi_check(xTimerChangePeriod(hTimer, ticks, portMAX_DELAY) == pdPASS);
+void input_isr(void* _ctx) {
+    InputPinState* pin_state = _ctx;
+    uint32_t now = osKernelGetTickCount();
+    if(!pin_state->edge_pending) {
+        pin_state->edge_first = now;
+        pin_state->edge_pending = true;
+    }
+    pin_state->edge_last = now;
+    osThreadFlagsSet(input->thread, INPUT_THREAD_FLAG_ISR);
 }
 
-inline static void input_timer_stop(osTimerId_t timer_id) {
-    TimerHandle_t hTimer = (TimerHandle_t)timer_id;
-    furi_check(xTimerStop(hTimer, portMAX_DELAY) == pdPASS);
-    // xTimerStop is not actually stopping timer,
-    // Instead it places stop event into timer queue
-    // This code ensures that timer is stopped
-    while(xTimerIsTimerActive(hTimer) == pdTRUE) osDelay(1);
+static bool input_debounce_read_callback(void* context, size_t pin) {
+    Input* input = context;
+    return GPIO_Read(input->pin_states[pin]);
 }
 
-void input_press_timer_callback(void* arg) {
-    InputPinState* input_pin = arg;
-    InputEvent event;
-    event.sequence = input_pin->counter;
-    event.key = input_pin->pin->key;
-    input_pin->press_counter++;
-    if(input_pin->press_counter == INPUT_LONG_PRESS_COUNTS) {
-        event.type = InputTypeLong;
-        furi_pubsub_publish(input->event_pubsub, &event);
-    } else if(input_pin->press_counter > INPUT_LONG_PRESS_COUNTS) {
-        input_pin->press_counter--;
-        event.type = InputTypeRepeat;
-        furi_pubsub_publish(input->event_pubsub, &event);
-    }
+static void input_debounce_event_callback(void* context, size_t pin, InputEvent* event) {
+    Input* input = context;
+    event->key = input->pin_states[pin].pin->key;
+    furi_pubsub_publish(input->event_pubsub, event);
 }
 
-void input_isr(void* _ctx) {
-    osThreadFlagsSet(input->thread, INPUT_THREAD_FLAG_ISR);
+static const InputDebounceCallbacks input_debounce_callbacks = {
+    .read = input_debounce_read_callback,
+    .event = input_debounce_event_callback,
+};
+
+// Pass edges captured in ISR to debounce, first and last edge is all it needs
+static void input_collect_edges(Input* input) {
+    for(size_t i = 0; i < input_pins_count; i++) {
+        InputPinState* pin_state = &input->pin_states[i];
+
+        FURI_CRITICAL_ENTER();
+        bool pending = pin_state->edge_pending;
+        uint32_t first = pin_state->edge_first;
+        uint32_t last = pin_state->edge_last;
+        pin_state->edge_pending = false;
+        FURI_CRITICAL_EXIT();
+
+        if(pending) {
+            input_debounce_edge(input->debounce, i, first);
+            input_debounce_edge(input->debounce, i, last);
+        }
+    }
 }
 
 const char* input_get_key_name(InputKey key) {
@@ -79,60 +91,23 @@ int32_t input_srv() {
 #endif
 
     input->pin_states = malloc(input_pins_count * sizeof(InputPinState));
+    input->debounce = input_debounce_alloc(input_pins_count, &input_debounce_callbacks, input);
 
     for(size_t i = 0; i < input_pins_count; i++) {
-        GpioPin gpio = {(GPIO_TypeDef*)input_pins[i].port, (uint16_t)input_pins[i].pin};
-        hal_gpio_add_int_callback(&gpio, input_isr, NULL);
         input->pin_states[i].pin = &input_pins[i];
-        input->pin_states[i].state = GPIO_Read(input->pin_states[i]);
-        input->pin_states[i].debounce = INPUT_DEBOUNCE_TICKS_HALF;
-        input->pin_states[i].press_timer =
-            osTimerNew(input_press_timer_callback, osTimerPeriodic, &input->pin_states[i], NULL);
-        input->pin_states[i].press_counter = 0;
+        input->pin_states[i].edge_pending = false;
+        input_debounce_reset(input->debounce, i, GPIO_Read(input->pin_states[i]));
+        GpioPin gpio = {(GPIO_TypeDef*)input_pins[i].port, (uint16_t)input_pins[i].pin};
+        hal_gpio_add_int_callback(&gpio, input_isr, &input->pin_states[i]);
     }
 
     while(1) {
-        bool is_changing = false;
-        for(size_t i = 0; i < input_pins_count; i++) {
-            bool state = GPIO_Read(input->pin_states[i]);
-            if(input->pin_states[i].debounce > 0 &&
-               input->pin_states[i].debounce < INPUT_DEBOUNCE_TICKS) {
-                is_changing = true;
-                input->pin_states[i].debounce += (state ? 1 : -1);
-            } else if(input->pin_states[i].state != state) {
-                input->pin_states[i].state = state;
-
-                // Common state info
-                InputEvent event;
-                event.key = input->pin_states[i].pin->key;
-
-                // Short / Long / Repeat timer routine
-                if(state) {
-                    input->counter++;
-                    input->pin_states[i].counter = input->counter;
-                    event.sequence = input->pin_states[i].counter;
-                    input_timer_start(input->pin_states[i].press_timer, INPUT_PRESS_TICKS);
-                } else {
-                    event.sequence = input->pin_states[i].counter;
-                    input_timer_stop(input->pin_states[i].press_timer);
-                    if(input->pin_states[i].press_counter < INPUT_LONG_PRESS_COUNTS) {
-                        event.type = InputTypeShort;
-                        furi_pubsub_publish(input->event_pubsub, &event);
-                    }
-                    input->pin_states[i].press_counter = 0;
-                }
-
-                // Send Press/Release event
-                event.type = input->pin_states[i].state ? InputTypePress : InputTypeRelease;
-                furi_pubsub_publish(input->event_pubsub, &event);
-            }
-        }
-
-        if(is_changing) {
-            osDelay(1);
-        } else {
-            osThreadFlagsWait(INPUT_THREAD_FLAG_ISR, osFlagsWaitAny, osWaitForever);
-        }
+        input_collect_edges(input);
+        uint32_t timeout = input_debounce_process(input->debounce, osKernelGetTickCount());
+        osThreadFlagsWait(
+            INPUT_THREAD_FLAG_ISR,
+            osFlagsWaitAny,
+            timeout == INPUT_DEBOUNCE_IDLE ? osWaitForever : timeout);
     }
 
     return 0;
@@ -23,6 +23,7 @@ typedef struct {
     uint32_t sequence;
     InputKey key;
     InputType type;
+    uint32_t timestamp; /**< Kernel tick of the key edge. Long, Repeat: end of period */
 } InputEvent;
 
 /** Get human readable input key name
@@ -4,11 +4,21 @@
 #include <cli/cli.h>
 #include <toolbox/args.h>
 
+#define INPUT_CLI_LATENCY_BUCKETS (8)
+#define INPUT_CLI_LATENCY_BUCKET_MS (4)
+#define INPUT_CLI_LATENCY_BAR_WIDTH (32)
+
+typedef struct {
+    InputEvent event;
+    uint32_t delivered;
+} InputCliLatencyEvent;
+
 static void input_cli_usage() {
     printf("Usage:\r\n");
     printf("input <cmd> <args>\r\n");
     printf("Cmd list:\r\n");
     printf("\tdump\t\t\t - dump input events\r\n");
+    printf("\tlatency\t\t\t - edge to event latency histogram\r\n");
     printf("\tsend <key> <type>\t - send input event\r\n");
 }
 
@@ -43,6 +53,84 @@ static void input_cli_dump(Cli* cli, string_t args, Input* input) {
     osMessageQueueDelete(input_queue);
 }
 
+static void input_cli_latency_events_callback(const void* value, void* ctx) {
+    furi_assert(value);
+    furi_assert(ctx);
+    InputCliLatencyEvent latency_event = {
+        .event = *(const InputEvent*)value,
+        .delivered = osKernelGetTickCount(),
+    };
+    // Runs in input thread: drop event rather than stall input
+    osMessageQueuePut(ctx, &latency_event, 0, 0);
+}
+
+static void input_cli_latency_print(const uint32_t* histogram, uint32_t count) {
+    uint32_t max_count = 1;
+    for(size_t i = 0; i < INPUT_CLI_LATENCY_BUCKETS; i++) {
+        max_count = MAX(max_count, histogram[i]);
+    }
+
+    printf("Latency, ms\tEvents\r\n");
+    for(size_t i = 0; i < INPUT_CLI_LATENCY_BUCKETS; i++) {
+        uint32_t from = i * INPUT_CLI_LATENCY_BUCKET_MS;
+        if(i < INPUT_CLI_LATENCY_BUCKETS - 1) {
+            uint32_t to = from + INPUT_CLI_LATENCY_BUCKET_MS - 1;
+            printf("%3lu-%-3lu\t\t%5lu ", from, to, histogram[i]);
+        } else {
+            printf("%3lu+   \t\t%5lu ", from, histogram[i]);
+        }
+        uint32_t bar = histogram[i] * INPUT_CLI_LATENCY_BAR_WIDTH / max_count;
+        for(size_t j = 0; j < bar; j++) {
+            printf("#");
+        }
+        printf("\r\n");
+    }
+    printf("Total: %lu\r\n", count);
+}
+
+static void input_cli_latency(Cli* cli, string_t args, Input* input) {
+    osMessageQueueId_t input_queue = osMessageQueueNew(8, sizeof(InputCliLatencyEvent), NULL);
+    FuriPubSubSubscription* input_subscription = furi_pubsub_subscribe(
+        input->event_pubsub, input_cli_latency_events_callback, input_queue);
+
+    uint32_t histogram[INPUT_CLI_LATENCY_BUCKETS] = {0};
+    uint32_t count = 0;
+    uint32_t total = 0;
+    uint32_t max = 0;
+    const uint32_t tick_freq = osKernelGetTickFreq();
+
+    printf("Press buttons, Ctrl+C to stop\r\n");
+    InputCliLatencyEvent latency_event;
+    while(!cli_cmd_interrupt_received(cli)) {
+        if(osMessageQueueGet(input_queue, &latency_event, NULL, 100) != osOK) continue;
+        // Only press and release are stamped with the key edge
+        if(latency_event.event.type != InputTypePress &&
+           latency_event.event.type != InputTypeRelease) {
+            continue;
+        }
+
+        uint32_t latency =
+            (latency_event.delivered - latency_event.event.timestamp) * 1000 / tick_freq;
+        histogram[MIN(latency / INPUT_CLI_LATENCY_BUCKET_MS, INPUT_CLI_LATENCY_BUCKETS - 1)]++;
+        count++;
+        total += latency;
+        max = MAX(max, latency);
+        printf(
+            "key: %s type: %s latency: %lums\r\n",
+            input_get_key_name(latency_event.event.key),
+            input_get_type_name(latency_event.event.type),
+            latency);
+    }
+
+    furi_pubsub_unsubscribe(input->event_pubsub, input_subscription);
+    osMessageQueueDelete(input_queue);
+
+    input_cli_latency_print(histogram, count);
+    if(count) {
+        printf("Average: %lums, max: %lums\r\n", total / count, max);
+    }
+}
+
 static void input_cli_send_print_usage() {
     printf("Invalid arguments. Usage:\r\n");
     printf("\tinput send <key> <type>\r\n");
@@ -92,6 +180,7 @@ void input_cli_send(Cli* cli, string_t args, Input* input) {
     } while(false);
 
     if(parsed) {
+        event.timestamp = osKernelGetTickCount();
         furi_pubsub_publish(input->event_pubsub, &event);
     } else {
         input_cli_send_print_usage();
@@ -115,6 +204,10 @@ void input_cli(Cli* cli, string_t args, void* context) {
             input_cli_dump(cli, args, input);
             break;
         }
+        if(string_cmp_str(cmd, "latency") == 0) {
+            input_cli_latency(cli, args, input);
+            break;
+        }
         if(string_cmp_str(cmd, "send") == 0) {
             input_cli_send(cli, args, input);
             break;
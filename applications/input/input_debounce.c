@@ -0,0 +1,172 @@
+#include <furi.h>
+#include "input_debounce.h"
+
+typedef struct {
+    bool state;
+    bool settling;
+    bool reported;
+    bool press_active;
+    uint8_t press_counter;
+    uint32_t first_edge;
+    uint32_t last_edge;
+    uint32_t settle_time;
+    uint32_t press_time;
+    uint32_t sequence;
+} InputDebouncePin;
+
+struct InputDebounce {
+    InputDebouncePin* pins;
+    size_t pins_count;
+    uint32_t counter;
+    const InputDebounceCallbacks* callbacks;
+    void* context;
+};
+
+InputDebounce* input_debounce_alloc(
+    size_t pins_count,
+    const InputDebounceCallbacks* callbacks,
+    void* context) {
+    furi_assert(callbacks);
+    InputDebounce* debounce = malloc(sizeof(InputDebounce));
+    debounce->pins = malloc(pins_count * sizeof(InputDebouncePin));
+    memset(debounce->pins, 0, pins_count * sizeof(InputDebouncePin));
+    debounce->pins_count = pins_count;
+    debounce->counter = 0;
+    debounce->callbacks = callbacks;
+    debounce->context = context;
+    return debounce;
+}
+
+void input_debounce_free(InputDebounce* debounce) {
+    furi_assert(debounce);
+    free(debounce->pins);
+    free(debounce);
+}
+
+void input_debounce_reset(InputDebounce* debounce, size_t pin, bool state) {
+    furi_assert(debounce);
+    furi_assert(pin < debounce->pins_count);
+    InputDebouncePin* input_pin = &debounce->pins[pin];
+    memset(input_pin, 0, sizeof(InputDebouncePin));
+    input_pin->state = state;
+}
+
+void input_debounce_edge(InputDebounce* debounce, size_t pin, uint32_t time) {
+    furi_assert(debounce);
+    furi_assert(pin < debounce->pins_count);
+    InputDebouncePin* input_pin = &debounce->pins[pin];
+    if(!input_pin->settling) {
+        input_pin->settling = true;
+        input_pin->reported = false;
+        input_pin->first_edge = time;
+    }
+    input_pin->last_edge = time;
+    input_pin->settle_time = time + INPUT_DEBOUNCE_SETTLE_TICKS;
+}
+
+static bool input_debounce_is_due(uint32_t deadline, uint32_t now) {
+    return (int32_t)(deadline - now) <= 0;
+}
+
+static void input_debounce_send(
+    InputDebounce* debounce,
+    size_t pin,
+    InputType type,
+    uint32_t timestamp) {
+    InputEvent event = {
+        .sequence = debounce->pins[pin].sequence,
+        .type = type,
+        .timestamp = timestamp,
+    };
+    debounce->callbacks->event(debounce->context, pin, &event);
+}
+
+static void input_debounce_set_state(
+    InputDebounce* debounce,
+    size_t pin,
+    bool state,
+    uint32_t timestamp) {
+    InputDebouncePin* input_pin = &debounce->pins[pin];
+    input_pin->state = state;
+
+    // Short / Long / Repeat timing
+    if(state) {
+        debounce->counter++;
+        input_pin->sequence = debounce->counter;
+        input_pin->press_active = true;
+        input_pin->press_counter = 0;
+        input_pin->press_time = timestamp + INPUT_PRESS_TICKS;
+    } else {
+        input_pin->press_active = false;
+        if(input_pin->press_counter < INPUT_LONG_PRESS_COUNTS) {
+            input_debounce_send(debounce, pin, InputTypeShort, timestamp);
+        }
+        input_pin->press_counter = 0;
+    }
+
+    input_debounce_send(debounce, pin, state ? InputTypePress : InputTypeRelease, timestamp);
+}
+
+static void input_debounce_settle(InputDebounce* debounce, size_t pin) {
+    InputDebouncePin* input_pin = &debounce->pins[pin];
+    input_pin->settling = false;
+
+    // Bounce ended on the other level: pin was released or pressed again meanwhile
+    bool state = debounce->callbacks->read(debounce->context, pin);
+    if(state != input_pin->state) {
+        input_debounce_set_state(debounce, pin, state, input_pin->last_edge);
+    }
+}
+
+static void input_debounce_press_tick(InputDebounce* debounce, size_t pin) {
+    InputDebouncePin* input_pin = &debounce->pins[pin];
+    uint32_t timestamp = input_pin->press_time;
+    input_pin->press_time += INPUT_PRESS_TICKS;
+    input_pin->press_counter++;
+    if(input_pin->press_counter == INPUT_LONG_PRESS_COUNTS) {
+        input_debounce_send(debounce, pin, InputTypeLong, timestamp);
+    } else if(input_pin->press_counter > INPUT_LONG_PRESS_COUNTS) {
+        input_pin->press_counter--;
+        input_debounce_send(debounce, pin, InputTypeRepeat, timestamp);
+    }
+}
+
+uint32_t input_debounce_process(InputDebounce* debounce, uint32_t now) {
+    furi_assert(debounce);
+    uint32_t timeout = INPUT_DEBOUNCE_IDLE;
+
+    for(size_t pin = 0; pin < debounce->pins_count; pin++) {
+        InputDebouncePin* input_pin = &debounce->pins[pin];
+
+        // Edge after stable level is a change, no need to wait for bounce to end
+        if(input_pin->settling && !input_pin->reported) {
+            input_pin->reported = true;
+            input_debounce_set_state(debounce, pin, !input_pin->state, input_pin->first_edge);
+        }
+
+        // Due deadlines of the pin in time order
+        while(true) {
+            bool settle_due =
+                input_pin->settling && input_debounce_is_due(input_pin->settle_time, now);
+            bool press_due =
+                input_pin->press_active && input_debounce_is_due(input_pin->press_time, now);
+            if(!settle_due && !press_due) break;
+
+            if(press_due &&
+               (!settle_due || (int32_t)(input_pin->press_time - input_pin->settle_time) < 0)) {
+                input_debounce_press_tick(debounce, pin);
+            } else {
+                input_debounce_settle(debounce, pin);
+            }
+        }
+
+        if(input_pin->settling) {
+            timeout = MIN(timeout, input_pin->settle_time - now);
+        }
+        if(input_pin->press_active) {
+            timeout = MIN(timeout, input_pin->press_time - now);
+        }
+    }
+
+    return timeout;
+}
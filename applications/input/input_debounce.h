@@ -0,0 +1,65 @@
+/**
+ * @file input_debounce.h
+ * Input: edge debouncing and press timing
+ *
+ * Works on edge timestamps only: no pin polling and no timers. Owner feeds edges captured in
+ * ISR, calls process and sleeps until returned deadline or next edge.
+ *
+ * First edge after a stable period is reported right away. Following edges are bounce: pin is
+ * read again only when there were no edges for INPUT_DEBOUNCE_SETTLE_TICKS.
+ */
+
+#pragma once
+
+#include "input.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** No edges for that long and pin level is stable, ticks */
+#define INPUT_DEBOUNCE_SETTLE_TICKS (INPUT_DEBOUNCE_TICKS / 2)
+/** Long and repeat period, ticks */
+#define INPUT_PRESS_TICKS 150
+#define INPUT_LONG_PRESS_COUNTS 2
+
+/** Nothing scheduled, process returns it when all pins are stable and released */
+#define INPUT_DEBOUNCE_IDLE UINT32_MAX
+
+typedef struct InputDebounce InputDebounce;
+
+typedef struct {
+    /** Read pin level, true if pressed */
+    bool (*read)(void* context, size_t pin);
+    /** Event ready. sequence, type and timestamp are filled, key is up to the owner */
+    void (*event)(void* context, size_t pin, InputEvent* event);
+} InputDebounceCallbacks;
+
+InputDebounce* input_debounce_alloc(
+    size_t pins_count,
+    const InputDebounceCallbacks* callbacks,
+    void* context);
+
+void input_debounce_free(InputDebounce* debounce);
+
+/** Set initial pin state, no events are sent */
+void input_debounce_reset(InputDebounce* debounce, size_t pin, bool state);
+
+/** Register pin edge
+ *
+ * @param time  tick when edge happened
+ */
+void input_debounce_edge(InputDebounce* debounce, size_t pin, uint32_t time);
+
+/** Send events that are due
+ *
+ * @return ticks until the next deadline or INPUT_DEBOUNCE_IDLE
+ */
+uint32_t input_debounce_process(InputDebounce* debounce, uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
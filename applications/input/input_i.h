@@ -6,6 +6,7 @@
 #pragma once
 
 #include "input.h"
+#include "input_debounce.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -14,20 +15,15 @@
 #include <m-string.h>
 #include <furi_hal_gpio.h>
 
-#define INPUT_DEBOUNCE_TICKS_HALF (INPUT_DEBOUNCE_TICKS / 2)
-#define INPUT_PRESS_TICKS 150
-#define INPUT_LONG_PRESS_COUNTS 2
 #define INPUT_THREAD_FLAG_ISR 0x00000001
 
 /** Input pin state */
 typedef struct {
     const InputPin* pin;
-    // State
-    volatile bool state;
-    volatile uint8_t debounce;
-    volatile osTimerId_t press_timer;
-    volatile uint8_t press_counter;
-    volatile uint32_t counter;
+    // Edges captured in ISR since the last collection
+    volatile bool edge_pending;
+    volatile uint32_t edge_first;
+    volatile uint32_t edge_last;
 } InputPinState;
 
 /** Input state */
@@ -35,14 +31,11 @@ typedef struct {
     osThreadId_t thread;
     FuriPubSub* event_pubsub;
     InputPinState* pin_states;
+    InputDebounce* debounce;
     Cli* cli;
-    volatile uint32_t counter;
 } Input;
 
-/** Input press timer callback */
-void input_press_timer_callback(void* arg);
-
-/** Input interrupt handler */
+/** Input interrupt handler, context is InputPinState */
 void input_isr(void* _ctx);
 
 /** Input CLI command handler */
@@ -11,6 +11,8 @@
 
 #define TAG "IrdaParser"
 
+#define IRDA_PARSER_STRING_ARENA_SIZE (128)
+
 bool irda_parser_save_signal(
     FlipperFormat* ff,
     const IrdaAppSignal& signal,
@@ -51,14 +53,22 @@ bool irda_parser_read_signal(FlipperFormat* ff, IrdaAppSignal& signal, std::stri
     furi_assert(ff);
 
     bool result = false;
-    string_t read_string;
-    string_init(read_string);
+    // Strings of one signal are read without heap allocations
+    char arena[IRDA_PARSER_STRING_ARENA_SIZE];
+    const char* read_string = nullptr;
+    flipper_format_set_string_arena(ff, arena, sizeof(arena));
 
     do {
-        if(!flipper_format_read_string(ff, "name", read_string)) break;
-        name = string_get_cstr(read_string);
-        if(!flipper_format_read_string(ff, "type", read_string)) break;
-        if(!string_cmp_str(read_string, "raw")) {
+        // Record with too long name is skipped, next one is read instead
+        bool name_read = flipper_format_read_string_view(ff, "name", &read_string);
+        while(!name_read && flipper_format_string_view_skipped(ff)) {
+            FURI_LOG_W(TAG, "Signal name is too long, record skipped");
+            name_read = flipper_format_read_string_view(ff, "name", &read_string);
+        }
+        if(!name_read) break;
+        name = read_string;
+        if(!flipper_format_read_string_view(ff, "type", &read_string)) break;
+        if(!strcmp(read_string, "raw")) {
             uint32_t* timings = nullptr;
             uint32_t timings_cnt = 0;
             uint32_t frequency = 0;
@@ -74,10 +84,10 @@ bool irda_parser_read_signal(FlipperFormat* ff, IrdaAppSignal& signal, std::stri
                 result = true;
             }
             free(timings);
-        } else if(!string_cmp_str(read_string, "parsed")) {
+        } else if(!strcmp(read_string, "parsed")) {
             IrdaMessage parsed_signal;
-            if(!flipper_format_read_string(ff, "protocol", read_string)) break;
-            parsed_signal.protocol = irda_get_protocol_by_name(string_get_cstr(read_string));
+            if(!flipper_format_read_string_view(ff, "protocol", &read_string)) break;
+            parsed_signal.protocol = irda_get_protocol_by_name(read_string);
             if(!flipper_format_read_hex(ff, "address", (uint8_t*)&parsed_signal.address, 4)) break;
             if(!flipper_format_read_hex(ff, "command", (uint8_t*)&parsed_signal.command, 4)) break;
             if(!irda_parser_is_parsed_signal_valid(&parsed_signal)) break;
@@ -88,7 +98,7 @@ bool irda_parser_read_signal(FlipperFormat* ff, IrdaAppSignal& signal, std::stri
         }
     } while(0);
 
-    string_clear(read_string);
+    flipper_format_set_string_arena(ff, NULL, 0);
     return result;
 }
 
@@ -22,15 +22,21 @@ bool IrdaAppBruteForce::calculate_messages() {
     if(result) {
         IrdaAppSignal signal;
 
-        string_t signal_name;
-        string_init(signal_name);
-        while(flipper_format_read_string(ff, "name", signal_name)) {
-            auto element = records.find(string_get_cstr(signal_name));
-            if(element != records.cend()) {
-                ++element->second.amount;
+        // Whole database is scanned, names are read without heap allocations
+        char arena[128];
+        const char* signal_name = nullptr;
+        flipper_format_set_string_arena(ff, arena, sizeof(arena));
+        while(true) {
+            if(flipper_format_read_string_view(ff, "name", &signal_name)) {
+                auto element = records.find(signal_name);
+                if(element != records.cend()) {
+                    ++element->second.amount;
+                }
+                flipper_format_reset_string_arena(ff);
+            } else if(!flipper_format_string_view_skipped(ff)) {
+                break;
             }
         }
-        string_clear(signal_name);
     }
 
     flipper_format_free(ff);
@@ -22,3 +22,8 @@ void EncoderEM::get_next(bool* polarity, uint16_t* period, uint16_t* pulse) {
         card_data_index = 0;
     }
 }
+
+uint16_t EncoderEM::get_frame_pulses() {
+    // one pulse per bit
+    return 64;
+}
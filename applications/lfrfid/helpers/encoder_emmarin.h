@@ -12,6 +12,7 @@ public:
     void init(const uint8_t* data, const uint8_t data_size) final;
 
     void get_next(bool* polarity, uint16_t* period, uint16_t* pulse) final;
+    uint16_t get_frame_pulses() final;
 
 private:
     // clock pulses per bit
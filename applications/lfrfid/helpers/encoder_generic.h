@@ -21,6 +21,13 @@ public:
      */
     virtual void get_next(bool* polarity, uint16_t* period, uint16_t* pulse) = 0;
 
+    /**
+     * @brief Get count of get_next calls after which waveform repeats
+     * 
+     * @return uint16_t pulses in one frame
+     */
+    virtual uint16_t get_frame_pulses() = 0;
+
     virtual ~EncoderGeneric(){};
 
 private:
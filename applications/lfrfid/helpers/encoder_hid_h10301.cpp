@@ -37,6 +37,12 @@ void EncoderHID_H10301::get_next(bool* polarity, uint16_t* period, uint16_t* pul
     *pulse = *period / 2;
 }
 
+uint16_t EncoderHID_H10301::get_frame_pulses() {
+    // Preamble and manchester coded data are balanced, so frame always has 48 zeros and 48 ones:
+    // 48 * 50 / 8 + 48 * 50 / 10 = 540 FSK periods, exactly 4800 clocks
+    return 540;
+}
+
 EncoderHID_H10301::EncoderHID_H10301() {
     fsk = new OscFSK(8, 10, 50);
 }
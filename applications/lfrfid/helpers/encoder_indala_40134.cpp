@@ -8,6 +8,7 @@ void EncoderIndala_40134::init(const uint8_t* data, const uint8_t data_size) {
 
     last_bit = card_data & 1;
     card_data_index = 0;
+    bit_clock_index = 0;
     current_polarity = true;
 }
 
@@ -34,3 +35,8 @@ void EncoderIndala_40134::get_next(bool* polarity, uint16_t* period, uint16_t* p
         }
     }
 }
+
+uint16_t EncoderIndala_40134::get_frame_pulses() {
+    // polarity flips an even number of times per frame, so frame is 64 bits
+    return 64 * clock_per_bit;
+}
@@ -0,0 +1,132 @@
+#include "pulse_train.h"
+#include <furi.h>
+
+uint8_t PulseTrain::get_segments(EncoderGeneric* encoder, Segment* segments) {
+    bool polarity;
+    uint16_t period;
+    uint16_t pulse;
+    uint8_t segments_count = 0;
+
+    encoder->get_next(&polarity, &period, &pulse);
+
+    // polarity true = high2low, false = low2high
+    if(pulse > 0) {
+        segments[segments_count++] = {polarity, pulse};
+    }
+    if(period > pulse) {
+        segments[segments_count++] = {!polarity, static_cast<uint16_t>(period - pulse)};
+    }
+
+    return segments_count;
+}
+
+bool PulseTrain::render(EncoderGeneric* encoder) {
+    const uint16_t frame_pulses = encoder->get_frame_pulses();
+    Segment segments[2];
+    uint8_t segments_count;
+
+    reset();
+
+    // Skip first frame: some oscillators need it to settle into periodic state
+    for(uint16_t i = 0; i < frame_pulses; i++) {
+        get_segments(encoder, segments);
+    }
+
+    // First pass: count rising edges and find the first one, edge between frames included
+    bool first_level = false;
+    bool last_level = false;
+    bool has_level = false;
+    uint32_t frame_segments = 0;
+    uint32_t first_rise_segment = 0;
+    bool first_rise_found = false;
+    uint16_t rises = 0;
+
+    for(uint16_t i = 0; i < frame_pulses; i++) {
+        segments_count = get_segments(encoder, segments);
+        for(uint8_t s = 0; s < segments_count; s++) {
+            if(!has_level) {
+                first_level = segments[s].level;
+                has_level = true;
+            } else if(segments[s].level && !last_level) {
+                rises++;
+                if(!first_rise_found) {
+                    first_rise_found = true;
+                    first_rise_segment = frame_segments;
+                }
+            }
+            last_level = segments[s].level;
+            frame_segments++;
+        }
+    }
+
+    if(first_level && !last_level) {
+        rises++;
+        first_rise_found = true;
+        first_rise_segment = 0;
+    }
+
+    // Constant level can't be emulated with timer pulses
+    if(!first_rise_found) {
+        return false;
+    }
+
+    pulses = static_cast<Pulse*>(malloc(sizeof(Pulse) * rises));
+    count = 0;
+
+    // Second pass: start from the first rising edge and wrap into the next frame
+    uint32_t segment_index = 0;
+    uint32_t segments_rendered = 0;
+    uint32_t high_time = 0;
+    uint32_t low_time = 0;
+
+    while(segments_rendered < frame_segments) {
+        segments_count = get_segments(encoder, segments);
+        for(uint8_t s = 0; s < segments_count && segments_rendered < frame_segments; s++) {
+            if(segment_index < first_rise_segment) {
+                segment_index++;
+                continue;
+            }
+
+            if(segments[s].level) {
+                if(low_time) {
+                    pulses[count++] = {
+                        static_cast<uint16_t>(high_time + low_time),
+                        static_cast<uint16_t>(high_time)};
+                    high_time = 0;
+                    low_time = 0;
+                }
+                high_time += segments[s].time;
+            } else {
+                low_time += segments[s].time;
+            }
+
+            segments_rendered++;
+        }
+    }
+
+    pulses[count++] = {
+        static_cast<uint16_t>(high_time + low_time), static_cast<uint16_t>(high_time)};
+    furi_check(count == rises);
+
+    return true;
+}
+
+void PulseTrain::reset() {
+    if(pulses) {
+        free(pulses);
+        pulses = nullptr;
+    }
+    count = 0;
+}
+
+const PulseTrain::Pulse* PulseTrain::get_pulses() {
+    return pulses;
+}
+
+uint16_t PulseTrain::get_count() {
+    return count;
+}
+
+PulseTrain::~PulseTrain() {
+    reset();
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+#include "encoder_generic.h"
+
+/**
+ * @brief Renders encoder waveform to timer period/pulse pairs once,
+ * so emulation ISR only steps through prepared buffer.
+ */
+class PulseTrain {
+public:
+    struct Pulse {
+        uint16_t period;
+        uint16_t pulse;
+    };
+
+    /**
+     * @brief Render one frame of initialized encoder. Frame is rendered cyclically,
+     * so looped playback has no seam. Every pulse starts with high level.
+     * 
+     * @param encoder initialized encoder
+     * @return true if rendered successfully
+     */
+    bool render(EncoderGeneric* encoder);
+
+    /**
+     * @brief Free rendered buffer
+     */
+    void reset();
+
+    const Pulse* get_pulses();
+    uint16_t get_count();
+
+    ~PulseTrain();
+
+private:
+    Pulse* pulses = nullptr;
+    uint16_t count = 0;
+
+    struct Segment {
+        bool level;
+        uint16_t time;
+    };
+
+    // Encoder pulse split to non-empty level segments
+    uint8_t get_segments(EncoderGeneric* encoder, Segment* segments);
+};
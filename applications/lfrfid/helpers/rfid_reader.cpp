@@ -10,12 +10,12 @@ extern COMP_HandleTypeDef hcomp1;
  * @brief private violation assistant for RfidReader
  */
 struct RfidReaderAccessor {
-    static void decode(RfidReader& rfid_reader, bool polarity) {
-        rfid_reader.decode(polarity);
+    static void timestamp_edge(RfidReader& rfid_reader, bool polarity) {
+        rfid_reader.timestamp_edge(polarity);
     }
 };
 
-void RfidReader::decode(bool polarity) {
+void RfidReader::timestamp_edge(bool polarity) {
     uint32_t current_dwt_value = DWT->CYCCNT;
     uint32_t period = current_dwt_value - last_dwt_value;
     last_dwt_value = current_dwt_value;
@@ -24,19 +24,102 @@ void RfidReader::decode(bool polarity) {
     decoder_gpio_out.process_front(polarity, period);
 #endif
 
-    switch(type) {
-    case Type::Normal:
-        decoder_em.process_front(polarity, period);
-        decoder_hid26.process_front(polarity, period);
-        break;
-    case Type::Indala:
+    push_edge(polarity, period);
+    detect_ticks++;
+}
+
+void RfidReader::push_edge(bool polarity, uint32_t period) {
+    // Only timestamp in ISR, decoding is done in batches by decoder thread
+    uint32_t edge = (period & ~edge_polarity_mask) | (polarity ? edge_polarity_mask : 0);
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    // Never write partial record, it will break alignment of the whole stream
+    if(xStreamBufferSpacesAvailable(edge_stream) >= sizeof(uint32_t)) {
+        xStreamBufferSendFromISR(edge_stream, &edge, sizeof(uint32_t), &xHigherPriorityTaskWoken);
+    } else {
+        dropped_edges++;
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void RfidReader::decode(const uint32_t* edges, size_t count) {
+    // Mode is sampled once per batch, hardware config can't change faster anyway
+    Type current_type = type;
+
+    for(size_t i = 0; i < count; i++) {
+        bool polarity = edges[i] & edge_polarity_mask;
+        uint32_t period = edges[i] & ~edge_polarity_mask;
+
         decoder_em.process_front(polarity, period);
         decoder_hid26.process_front(polarity, period);
-        decoder_indala.process_front(polarity, period);
-        break;
+        // Indala needs 62.5kHz carrier, so it can't share the pass with EM and HID
+        if(current_type == Type::Indala) {
+            decoder_indala.process_front(polarity, period);
+        }
     }
+}
 
-    detect_ticks++;
+void RfidReader::publish_keys() {
+    Key key;
+    // Decoder holds its key until read, reader drops keys if it doesn't keep up
+    if(decoder_em.read(key.data, LFRFID_KEY_SIZE)) {
+        key.type = LfrfidKeyType::KeyEM4100;
+        osMessageQueuePut(key_queue, &key, 0, 0);
+    }
+
+    if(decoder_hid26.read(key.data, LFRFID_KEY_SIZE)) {
+        key.type = LfrfidKeyType::KeyH10301;
+        osMessageQueuePut(key_queue, &key, 0, 0);
+    }
+
+    if(decoder_indala.read(key.data, LFRFID_KEY_SIZE)) {
+        key.type = LfrfidKeyType::KeyI40134;
+        osMessageQueuePut(key_queue, &key, 0, 0);
+    }
+}
+
+int32_t RfidReader::decoder_thread(void* context) {
+    RfidReader* _this = static_cast<RfidReader*>(context);
+    uint32_t edges[edge_batch_count];
+
+    while(_this->running) {
+        size_t size = xStreamBufferReceive(_this->edge_stream, edges, sizeof(edges), 10);
+        _this->decode(edges, size / sizeof(uint32_t));
+        _this->publish_keys();
+    }
+
+    return 0;
+}
+
+void RfidReader::start_decoder_thread() {
+    furi_assert(thread == nullptr);
+
+    // Wake up decoder thread by half of batch, it keeps ISR to thread latency low
+    edge_stream = xStreamBufferCreate(
+        sizeof(uint32_t) * edge_buffer_count, sizeof(uint32_t) * edge_batch_count / 2);
+    key_queue = osMessageQueueNew(key_queue_count, sizeof(Key), NULL);
+    dropped_edges = 0;
+    running = true;
+
+    thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "RfidDecoder");
+    furi_thread_set_stack_size(thread, 1024);
+    furi_thread_set_context(thread, this);
+    furi_thread_set_callback(thread, decoder_thread);
+    furi_thread_start(thread);
+}
+
+void RfidReader::stop_decoder_thread() {
+    if(thread == nullptr) return;
+
+    running = false;
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    thread = nullptr;
+
+    vStreamBufferDelete(edge_stream);
+    edge_stream = nullptr;
+    osMessageQueueDelete(key_queue);
+    key_queue = nullptr;
 }
 
 bool RfidReader::switch_timer_elapsed() {
@@ -68,17 +151,23 @@ static void comparator_trigger_callback(void* hcomp, void* comp_ctx) {
     RfidReader* _this = static_cast<RfidReader*>(comp_ctx);
 
     if(hcomp == &hcomp1) {
-        RfidReaderAccessor::decode(
+        RfidReaderAccessor::timestamp_edge(
             *_this, (HAL_COMP_GetOutputLevel(_hcomp) == COMP_OUTPUT_LEVEL_HIGH));
     }
 }
 
 RfidReader::RfidReader() {
+    running = false;
+    dropped_edges = 0;
+    type = Type::Normal;
+    last_readed_count = 0;
 }
 
 void RfidReader::start() {
     type = Type::Normal;
 
+    start_decoder_thread();
+
     furi_hal_rfid_pins_read();
     furi_hal_rfid_tim_read(125000, 0.5);
     furi_hal_rfid_tim_read_start();
@@ -100,25 +189,20 @@ void RfidReader::stop() {
     furi_hal_rfid_tim_read_stop();
     furi_hal_rfid_tim_reset();
     stop_comparator();
+
+    stop_decoder_thread();
 }
 
 bool RfidReader::read(LfrfidKeyType* _type, uint8_t* data, uint8_t data_size, bool switch_enable) {
+    furi_assert(data_size <= LFRFID_KEY_SIZE);
     bool result = false;
     bool something_readed = false;
 
-    // reading
-    if(decoder_em.read(data, data_size)) {
-        *_type = LfrfidKeyType::KeyEM4100;
-        something_readed = true;
-    }
-
-    if(decoder_hid26.read(data, data_size)) {
-        *_type = LfrfidKeyType::KeyH10301;
-        something_readed = true;
-    }
-
-    if(decoder_indala.read(data, data_size)) {
-        *_type = LfrfidKeyType::KeyI40134;
+    // reading, decoders run in decoder thread
+    Key key;
+    if(osMessageQueueGet(key_queue, &key, NULL, 0) == osOK) {
+        *_type = key.type;
+        memcpy(data, key.data, data_size);
         something_readed = true;
     }
 
@@ -162,6 +246,10 @@ bool RfidReader::any_read() {
     return last_readed_count > 0;
 }
 
+uint32_t RfidReader::get_dropped_edges() {
+    return dropped_edges;
+}
+
 void RfidReader::start_comparator(void) {
     api_interrupt_add(comparator_trigger_callback, InterruptTypeComparatorTrigger, this);
     last_dwt_value = DWT->CYCCNT;
@@ -1,4 +1,7 @@
 #pragma once
+#include <furi.h>
+#include <stream_buffer.h>
+#include <atomic>
 //#include "decoder_analyzer.h"
 #include "decoder_gpio_out.h"
 #include "decoder_emmarin.h"
@@ -24,8 +27,14 @@ public:
     bool detect();
     bool any_read();
 
+    /**
+     * @brief Edges dropped because decoder thread was not able to keep up
+     */
+    uint32_t get_dropped_edges();
+
 private:
     friend struct RfidReaderAccessor;
+    friend struct RfidReaderTest;
 
     //DecoderAnalyzer decoder_analyzer;
 #ifdef RFID_GPIO_DEBUG
@@ -40,7 +49,32 @@ private:
     void start_comparator(void);
     void stop_comparator(void);
 
-    void decode(bool polarity);
+    // Edge record: comparator level in MSB, previous level duration in DWT ticks in the rest
+    static constexpr uint32_t edge_polarity_mask = 0x80000000UL;
+    static constexpr size_t edge_buffer_count = 1024;
+    static constexpr size_t edge_batch_count = 64;
+    static constexpr size_t key_queue_count = 4;
+
+    // Decoded key, decoders are owned by decoder thread and publish keys through queue
+    struct Key {
+        LfrfidKeyType type;
+        uint8_t data[LFRFID_KEY_SIZE];
+    };
+
+    FuriThread* thread = nullptr;
+    StreamBufferHandle_t edge_stream = nullptr;
+    osMessageQueueId_t key_queue = nullptr;
+    std::atomic<bool> running;
+    std::atomic<uint32_t> dropped_edges;
+
+    void start_decoder_thread();
+    void stop_decoder_thread();
+    static int32_t decoder_thread(void* context);
+
+    void timestamp_edge(bool polarity);
+    void push_edge(bool polarity, uint32_t period);
+    void decode(const uint32_t* edges, size_t count);
+    void publish_keys();
 
     uint32_t detect_ticks;
 
@@ -53,5 +87,5 @@ private:
     uint8_t last_readed_data[LFRFID_KEY_SIZE];
     uint8_t last_readed_count;
 
-    Type type = Type::Normal;
+    std::atomic<Type> type;
 };
@@ -1,5 +1,7 @@
 #include "rfid_timer_emulator.h"
 
+#define TAG "RfidTimerEmulator"
+
 extern TIM_HandleTypeDef htim1;
 
 RfidTimerEmulator::RfidTimerEmulator() {
@@ -15,23 +17,36 @@ RfidTimerEmulator::~RfidTimerEmulator() {
     encoders.clear();
 }
 
-void RfidTimerEmulator::start(LfrfidKeyType type, const uint8_t* data, uint8_t data_size) {
-    if(encoders.count(type)) {
-        current_encoder = encoders.find(type)->second;
-
-        if(data_size >= lfrfid_key_get_type_data_count(type)) {
-            current_encoder->init(data, data_size);
+bool RfidTimerEmulator::start(LfrfidKeyType type, const uint8_t* data, uint8_t data_size) {
+    if(!encoders.count(type)) {
+        FURI_LOG_E(TAG, "No encoder for key type %d", static_cast<int>(type));
+        return false;
+    }
 
-            furi_hal_rfid_tim_emulate(125000);
-            furi_hal_rfid_pins_emulate();
+    if(data_size < lfrfid_key_get_type_data_count(type)) {
+        FURI_LOG_E(TAG, "Key data too short: %d", data_size);
+        return false;
+    }
 
-            api_interrupt_add(timer_update_callback, InterruptTypeTimerUpdate, this);
+    current_encoder = encoders.find(type)->second;
+    current_encoder->init(data, data_size);
 
-            furi_hal_rfid_tim_emulate_start();
-        }
-    } else {
-        // not found
+    // Render whole waveform now, ISR will only step through it
+    if(!pulse_train.render(current_encoder)) {
+        FURI_LOG_E(TAG, "Failed to render %s waveform", lfrfid_key_get_type_string(type));
+        return false;
     }
+    pulses = pulse_train.get_pulses();
+    pulses_count = pulse_train.get_count();
+    pulse_index = 0;
+
+    furi_hal_rfid_tim_emulate(125000);
+    furi_hal_rfid_pins_emulate();
+
+    api_interrupt_add(timer_update_callback, InterruptTypeTimerUpdate, this);
+
+    furi_hal_rfid_tim_emulate_start();
+    return true;
 }
 
 void RfidTimerEmulator::stop() {
@@ -40,6 +55,10 @@ void RfidTimerEmulator::stop() {
 
     furi_hal_rfid_tim_reset();
     furi_hal_rfid_pins_reset();
+
+    pulses = nullptr;
+    pulses_count = 0;
+    pulse_train.reset();
 }
 
 void RfidTimerEmulator::timer_update_callback(void* _hw, void* ctx) {
@@ -47,19 +66,14 @@ void RfidTimerEmulator::timer_update_callback(void* _hw, void* ctx) {
     TIM_HandleTypeDef* hw = static_cast<TIM_HandleTypeDef*>(_hw);
 
     if(furi_hal_rfid_is_tim_emulate(hw)) {
-        bool result;
-        bool polarity;
-        uint16_t period;
-        uint16_t pulse;
+        const PulseTrain::Pulse* pulse = &_this->pulses[_this->pulse_index];
 
-        do {
-            _this->current_encoder->get_next(&polarity, &period, &pulse);
-            result = _this->pulse_joiner.push_pulse(polarity, period, pulse);
-        } while(result == false);
+        furi_hal_rfid_set_emulate_period(pulse->period - 1);
+        furi_hal_rfid_set_emulate_pulse(pulse->pulse);
 
-        _this->pulse_joiner.pop_pulse(&period, &pulse);
-
-        furi_hal_rfid_set_emulate_period(period - 1);
-        furi_hal_rfid_set_emulate_pulse(pulse);
+        _this->pulse_index++;
+        if(_this->pulse_index >= _this->pulses_count) {
+            _this->pulse_index = 0;
+        }
     }
 }
@@ -5,14 +5,18 @@
 #include "encoder_emmarin.h"
 #include "encoder_hid_h10301.h"
 #include "encoder_indala_40134.h"
-#include "pulse_joiner.h"
+#include "pulse_train.h"
 #include <map>
 
 class RfidTimerEmulator {
 public:
     RfidTimerEmulator();
     ~RfidTimerEmulator();
-    void start(LfrfidKeyType type, const uint8_t* data, uint8_t data_size);
+    /**
+     * @brief Start emulation
+     * @return false if key can't be emulated, coil stays off
+     */
+    bool start(LfrfidKeyType type, const uint8_t* data, uint8_t data_size);
     void stop();
 
 private:
@@ -24,6 +28,10 @@ private:
         {LfrfidKeyType::KeyI40134, new EncoderIndala_40134()},
     };
 
-    PulseJoiner pulse_joiner;
+    PulseTrain pulse_train;
+    const PulseTrain::Pulse* pulses = nullptr;
+    uint16_t pulses_count = 0;
+    uint16_t pulse_index = 0;
+
     static void timer_update_callback(void* _hw, void* ctx);
 };
\ No newline at end of file
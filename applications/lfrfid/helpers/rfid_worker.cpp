@@ -58,8 +58,8 @@ void RfidWorker::stop_write() {
     reader.stop();
 }
 
-void RfidWorker::start_emulate() {
-    emulator.start(key.get_type(), key.get_data(), key.get_type_data_count());
+bool RfidWorker::start_emulate() {
+    return emulator.start(key.get_type(), key.get_data(), key.get_type_data_count());
 }
 
 void RfidWorker::stop_emulate() {
@@ -27,7 +27,7 @@ public:
     WriteResult write();
     void stop_write();
 
-    void start_emulate();
+    bool start_emulate();
     void stop_emulate();
 
     RfidKey key;
@@ -92,6 +92,9 @@ void lfrfid_cli_read(Cli* cli, string_t args) {
     }
 
     printf("Reading stopped\r\n");
+    if(reader.get_dropped_edges()) {
+        printf("Dropped edges: %lu\r\n", reader.get_dropped_edges());
+    }
     reader.stop();
 
     string_clear(type_string);
@@ -132,7 +135,11 @@ void lfrfid_cli_emulate(Cli* cli, string_t args) {
         return;
     }
 
-    emulator.start(type, key_data, key_data_size);
+    if(!emulator.start(type, key_data, key_data_size)) {
+        printf("Can't emulate this key\r\n");
+        string_clear(data);
+        return;
+    }
 
     printf("Emulating RFID...\r\nPress Ctrl+C to abort\r\n");
     while(!cli_cmd_interrupt_received(cli)) {
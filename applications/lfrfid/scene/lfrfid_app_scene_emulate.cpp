@@ -13,7 +13,8 @@ void LfRfidAppSceneEmulate::on_enter(LfRfidApp* app, bool need_restore) {
 
     auto popup = app->view_controller.get<PopupVM>();
 
-    popup->set_header("Emulating", 89, 30, AlignCenter, AlignTop);
+    emulating = app->worker.start_emulate();
+    popup->set_header(emulating ? "Emulating" : "Can't emulate", 89, 30, AlignCenter, AlignTop);
     if(strlen(app->worker.key.get_name())) {
         popup->set_text(app->worker.key.get_name(), 89, 43, AlignCenter, AlignTop);
     } else {
@@ -22,13 +23,12 @@ void LfRfidAppSceneEmulate::on_enter(LfRfidApp* app, bool need_restore) {
     popup->set_icon(0, 3, &I_RFIDDolphinSend_97x61);
 
     app->view_controller.switch_to<PopupVM>();
-    app->worker.start_emulate();
 }
 
 bool LfRfidAppSceneEmulate::on_event(LfRfidApp* app, LfRfidApp::Event* event) {
     bool consumed = false;
 
-    if(event->type == LfRfidApp::EventType::Tick) {
+    if(emulating && event->type == LfRfidApp::EventType::Tick) {
         notification_message(app->notification, &sequence_blink_cyan_10);
     }
 
@@ -9,4 +9,5 @@ public:
 
 private:
     string_t data_string;
+    bool emulating;
 };
\ No newline at end of file
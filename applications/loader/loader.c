@@ -20,6 +20,8 @@ static bool
     }
 
     FURI_LOG_I(TAG, "Starting: %s", loader_instance->application->name);
+    loader_profile_begin(
+        loader_instance->application->name, loader_instance->application->stack_size);
 
     furi_thread_set_name(loader_instance->application_thread, loader_instance->application->name);
     furi_thread_set_stack_size(
@@ -63,6 +65,10 @@ static void loader_cli_print_usage() {
     printf("Cmd list:\r\n");
     printf("\tlist\t - List available applications\r\n");
     printf("\topen <Application Name:string>\t - Open application by name\r\n");
+    printf("\tprofile\t - Show recent application launches\r\n");
+    printf(
+        "\tprofile save [path:string]\t - Save recent launches, %s is updated on exit\r\n",
+        LOADER_PROFILE_PATH);
 }
 
 const FlipperApplication* loader_find_application_by_name(const char* name) {
@@ -149,6 +155,85 @@ void loader_cli_list(Cli* cli, string_t args, Loader* instance) {
     }
 }
 
+static void loader_cli_profile_print_mark(uint32_t mark) {
+    if(mark == LOADER_PROFILE_NO_MARK) {
+        printf("%8s", "-");
+    } else {
+        printf("%8lu", mark);
+    }
+}
+
+static void loader_cli_profile_save(string_t args, Loader* instance) {
+    string_t path;
+    string_init_set_str(path, LOADER_PROFILE_PATH);
+    args_read_probably_quoted_string_and_trim(args, path);
+
+    LoaderProfileRing* ring = malloc(sizeof(LoaderProfileRing));
+    FURI_CRITICAL_ENTER();
+    *ring = *instance->profile_ring;
+    FURI_CRITICAL_EXIT();
+
+    if(loader_profile_ring_save(ring, instance->storage, string_get_cstr(path))) {
+        printf("Saved to %s\r\n", string_get_cstr(path));
+    } else {
+        printf("Failed to save %s\r\n", string_get_cstr(path));
+    }
+
+    free(ring);
+    string_clear(path);
+}
+
+void loader_cli_profile(Cli* cli, string_t args, Loader* instance) {
+    string_t cmd;
+    string_init(cmd);
+    bool save = args_read_string_and_trim(args, cmd) && string_cmp_str(cmd, "save") == 0;
+    string_clear(cmd);
+    if(save) {
+        loader_cli_profile_save(args, instance);
+        return;
+    }
+
+    LoaderProfileRecord* records = malloc(sizeof(LoaderProfileRecord) * LOADER_PROFILE_RING_SIZE);
+    FURI_CRITICAL_ENTER();
+    size_t count =
+        loader_profile_ring_get(instance->profile_ring, records, LOADER_PROFILE_RING_SIZE);
+    FURI_CRITICAL_EXIT();
+
+    // Times are ms since start request, storage is counted until the first frame
+    printf(
+        "%-24s %8s %8s %8s %6s %8s %8s %11s %8s\r\n",
+        "Application",
+        "Thread",
+        "ViewDisp",
+        "Frame",
+        "Calls",
+        "Read",
+        "Heap",
+        "Stack",
+        "Run");
+    for(size_t i = 0; i < count; i++) {
+        LoaderProfileRecord* record = &records[i];
+        printf("%-24.24s ", record->name);
+        for(size_t mark = 0; mark < LoaderProfileMarkCount; mark++) {
+            loader_cli_profile_print_mark(record->marks[mark]);
+            printf(" ");
+        }
+        printf(
+            "%6lu %8lu %8lu %5lu/%5lu %8lu\r\n",
+            record->storage_calls,
+            record->storage_read,
+            record->heap_peak,
+            record->stack_peak,
+            record->stack_size,
+            record->run_time);
+    }
+    if(count == 0) {
+        printf("No launches recorded\r\n");
+    }
+
+    free(records);
+}
+
 void loader_cli(Cli* cli, string_t args, void* _ctx) {
     furi_assert(_ctx);
     Loader* instance = _ctx;
@@ -172,6 +257,11 @@ void loader_cli(Cli* cli, string_t args, void* _ctx) {
             break;
         }
 
+        if(string_cmp_str(cmd, "profile") == 0) {
+            loader_cli_profile(cli, args, instance);
+            break;
+        }
+
         loader_cli_print_usage();
     } while(false);
 
@@ -231,6 +321,7 @@ static void loader_thread_state_callback(FuriThreadState thread_state, void* con
         event.type = LoaderEventTypeApplicationStarted;
         furi_pubsub_publish(loader_instance->pubsub, &event);
         furi_hal_power_insomnia_enter();
+        loader_profile_thread_started();
 
         // Snapshot current memory usage
         instance->free_heap_size = memmgr_get_free_heap();
@@ -253,6 +344,26 @@ static void loader_thread_state_callback(FuriThreadState thread_state, void* con
             heap_diff,
             furi_thread_get_heap_size(instance->application_thread));
 
+        LoaderProfileRecord record;
+        loader_profile_end(
+            &record,
+            furi_thread_get_heap_peak(instance->application_thread),
+            furi_thread_get_stack_space(instance->application_thread));
+        FURI_LOG_I(
+            TAG,
+            "Heap peak: %lu. Stack peak: %lu of %lu.",
+            record.heap_peak,
+            record.stack_peak,
+            record.stack_size);
+        FURI_CRITICAL_ENTER();
+        loader_profile_ring_push(instance->profile_ring, &record);
+        FURI_CRITICAL_EXIT();
+        // Keep file current for RPC. Ring is changed only here, so it is saved without copy
+        if(!loader_profile_ring_save(
+               instance->profile_ring, instance->storage, LOADER_PROFILE_PATH)) {
+            FURI_LOG_D(TAG, "Can't save launch profile to %s", LOADER_PROFILE_PATH);
+        }
+
         if(loader_instance->application_arguments) {
             free(loader_instance->application_arguments);
             loader_instance->application_arguments = NULL;
@@ -266,6 +377,20 @@ static void loader_thread_state_callback(FuriThreadState thread_state, void* con
     }
 }
 
+static void loader_gui_event_callback(GuiEvent event, void* context) {
+    if(event == GuiEventViewPortAdded) {
+        loader_profile_gui_attached();
+    } else if(event == GuiEventViewDispatcherRun) {
+        loader_profile_mark(LoaderProfileMarkViewDispatcherRun);
+    } else if(event == GuiEventFrame) {
+        loader_profile_mark(LoaderProfileMarkFirstFrame);
+    }
+}
+
+static void loader_storage_call_callback(uint16_t bytes_read, void* context) {
+    loader_profile_storage_call(bytes_read);
+}
+
 static uint32_t loader_hide_menu(void* context) {
     return VIEW_NONE;
 }
@@ -287,6 +412,11 @@ static Loader* loader_alloc() {
 
     instance->pubsub = furi_pubsub_alloc();
 
+    // Launch profile
+    instance->profile_ring = malloc(sizeof(LoaderProfileRing));
+    instance->storage = furi_record_open("storage");
+    storage_set_call_callback(instance->storage, loader_storage_call_callback, instance);
+
 #ifdef SRV_CLI
     instance->cli = furi_record_open("cli");
     cli_add_command(instance->cli, "loader", CliCommandFlagDefault, loader_cli, instance);
@@ -296,6 +426,7 @@ static Loader* loader_alloc() {
 
     // Gui
     instance->gui = furi_record_open("gui");
+    gui_set_event_callback(instance->gui, loader_gui_event_callback, instance);
     instance->view_dispatcher = view_dispatcher_alloc();
     view_dispatcher_attach_to_gui(
         instance->view_dispatcher, instance->gui, ViewDispatcherTypeFullscreen);
@@ -356,8 +487,13 @@ static void loader_free(Loader* instance) {
     view_dispatcher_remove_view(loader_instance->view_dispatcher, LoaderMenuViewSettings);
     view_dispatcher_free(loader_instance->view_dispatcher);
 
+    gui_set_event_callback(loader_instance->gui, NULL, NULL);
     furi_record_close("gui");
 
+    storage_set_call_callback(instance->storage, NULL, NULL);
+    furi_record_close("storage");
+    free(instance->profile_ring);
+
     free(instance);
     instance = NULL;
 }
@@ -1,4 +1,5 @@
 #include "loader.h"
+#include "loader_profile.h"
 
 #include <furi.h>
 #include <furi_hal.h>
@@ -23,6 +24,7 @@ struct Loader {
 
     Cli* cli;
     Gui* gui;
+    Storage* storage;
 
     ViewDispatcher* view_dispatcher;
     Menu* primary_menu;
@@ -34,6 +36,8 @@ struct Loader {
     volatile uint8_t lock_count;
 
     FuriPubSub* pubsub;
+
+    LoaderProfileRing* profile_ring;
 };
 
 typedef enum {
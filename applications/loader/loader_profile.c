@@ -0,0 +1,182 @@
+#include "loader_profile.h"
+#include <furi.h>
+
+#define TAG "LoaderProfile"
+
+#define LOADER_PROFILE_MAGIC (0x464F5250)
+#define LOADER_PROFILE_VERSION (1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t ring_size;
+    uint16_t record_size;
+    uint32_t sequence;
+} LoaderProfileHeader;
+
+typedef struct {
+    volatile osThreadId_t thread;
+    volatile bool gui_attached;
+    uint32_t start;
+    LoaderProfileRecord record;
+} LoaderProfile;
+
+static LoaderProfile loader_profile = {0};
+
+static uint32_t loader_profile_get_time() {
+    return (osKernelGetTickCount() - loader_profile.start) * 1000 / osKernelGetTickFreq();
+}
+
+void loader_profile_begin(const char* name, uint32_t stack_size) {
+    furi_assert(name);
+    FURI_CRITICAL_ENTER();
+    loader_profile.thread = NULL;
+    loader_profile.gui_attached = false;
+    loader_profile.start = osKernelGetTickCount();
+    memset(&loader_profile.record, 0, sizeof(LoaderProfileRecord));
+    strlcpy(loader_profile.record.name, name, LOADER_PROFILE_NAME_SIZE);
+    for(size_t i = 0; i < LoaderProfileMarkCount; i++) {
+        loader_profile.record.marks[i] = LOADER_PROFILE_NO_MARK;
+    }
+    loader_profile.record.stack_size = stack_size;
+    FURI_CRITICAL_EXIT();
+}
+
+void loader_profile_thread_started() {
+    loader_profile.record.marks[LoaderProfileMarkThreadStart] = loader_profile_get_time();
+    loader_profile.thread = osThreadGetId();
+}
+
+void loader_profile_end(LoaderProfileRecord* record, size_t heap_peak, size_t stack_space) {
+    furi_assert(record);
+    FURI_CRITICAL_ENTER();
+    loader_profile.thread = NULL;
+    loader_profile.record.run_time = loader_profile_get_time();
+    loader_profile.record.heap_peak = heap_peak;
+    loader_profile.record.stack_peak = loader_profile.record.stack_size - stack_space;
+    *record = loader_profile.record;
+    FURI_CRITICAL_EXIT();
+}
+
+static bool loader_profile_is_application_thread() {
+    return loader_profile.thread && loader_profile.thread == osThreadGetId();
+}
+
+void loader_profile_mark(LoaderProfileMark mark) {
+    furi_assert(mark < LoaderProfileMarkCount);
+    if(loader_profile.record.marks[mark] != LOADER_PROFILE_NO_MARK) return;
+
+    if(mark == LoaderProfileMarkFirstFrame) {
+        // Frames before application view port shows are previous application
+        if(!loader_profile.thread || !loader_profile.gui_attached) return;
+    } else if(!loader_profile_is_application_thread()) {
+        return;
+    }
+
+    loader_profile.record.marks[mark] = loader_profile_get_time();
+}
+
+void loader_profile_gui_attached() {
+    if(loader_profile_is_application_thread()) {
+        loader_profile.gui_attached = true;
+    }
+}
+
+void loader_profile_storage_call(uint32_t bytes_read) {
+    if(!loader_profile_is_application_thread()) return;
+    if(loader_profile.record.marks[LoaderProfileMarkFirstFrame] != LOADER_PROFILE_NO_MARK) return;
+    loader_profile.record.storage_calls++;
+    loader_profile.record.storage_read += bytes_read;
+}
+
+void loader_profile_ring_push(LoaderProfileRing* ring, LoaderProfileRecord* record) {
+    furi_assert(ring);
+    furi_assert(record);
+    record->sequence = ring->sequence;
+    ring->records[ring->sequence % LOADER_PROFILE_RING_SIZE] = *record;
+    ring->sequence++;
+}
+
+size_t loader_profile_ring_get(
+    const LoaderProfileRing* ring,
+    LoaderProfileRecord* records,
+    size_t count) {
+    furi_assert(ring);
+    furi_assert(records);
+    size_t stored = MIN(ring->sequence, LOADER_PROFILE_RING_SIZE);
+    size_t read = MIN(stored, count);
+    for(size_t i = 0; i < read; i++) {
+        records[i] = ring->records[(ring->sequence - 1 - i) % LOADER_PROFILE_RING_SIZE];
+    }
+    return read;
+}
+
+static bool loader_profile_ring_read_header(File* file, LoaderProfileHeader* header) {
+    bool valid = storage_file_read(file, header, sizeof(LoaderProfileHeader)) ==
+                 sizeof(LoaderProfileHeader);
+    valid = valid && header->magic == LOADER_PROFILE_MAGIC &&
+            header->version == LOADER_PROFILE_VERSION &&
+            header->ring_size == LOADER_PROFILE_RING_SIZE &&
+            header->record_size == sizeof(LoaderProfileRecord);
+    return valid;
+}
+
+static uint32_t loader_profile_ring_offset(uint32_t sequence) {
+    return sizeof(LoaderProfileHeader) +
+           (sequence % LOADER_PROFILE_RING_SIZE) * sizeof(LoaderProfileRecord);
+}
+
+bool loader_profile_ring_save(const LoaderProfileRing* ring, Storage* storage, const char* path) {
+    furi_assert(ring);
+    furi_assert(storage);
+    furi_assert(path);
+    File* file = storage_file_alloc(storage);
+
+    LoaderProfileHeader header = {
+        .magic = LOADER_PROFILE_MAGIC,
+        .version = LOADER_PROFILE_VERSION,
+        .ring_size = LOADER_PROFILE_RING_SIZE,
+        .record_size = sizeof(LoaderProfileRecord),
+        .sequence = ring->sequence,
+    };
+    bool result = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                  storage_file_write(file, &header, sizeof(header)) == sizeof(header) &&
+                  storage_file_write(file, ring->records, sizeof(ring->records)) ==
+                      sizeof(ring->records);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return result;
+}
+
+size_t loader_profile_ring_read(
+    Storage* storage,
+    const char* path,
+    LoaderProfileRecord* records,
+    size_t count) {
+    furi_assert(storage);
+    furi_assert(path);
+    furi_assert(records);
+    File* file = storage_file_alloc(storage);
+    size_t read = 0;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+
+        LoaderProfileHeader header;
+        if(!loader_profile_ring_read_header(file, &header)) break;
+
+        size_t stored = MIN(header.sequence, LOADER_PROFILE_RING_SIZE);
+        for(; read < MIN(stored, count); read++) {
+            uint32_t sequence = header.sequence - 1 - read;
+            if(!storage_file_seek(file, loader_profile_ring_offset(sequence), true)) break;
+            if(storage_file_read(file, &records[read], sizeof(LoaderProfileRecord)) !=
+               sizeof(LoaderProfileRecord))
+                break;
+        }
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return read;
+}
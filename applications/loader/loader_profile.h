@@ -0,0 +1,136 @@
+/**
+ * @file loader_profile.h
+ * Loader: application launch profiler
+ *
+ * Loader opens a launch record when application is started. GUI and storage event callbacks
+ * report launch milestones and storage use of application thread until its first frame.
+ * Finished launches are kept in RAM ring, shown by `loader profile`. Loader writes ring to
+ * LOADER_PROFILE_PATH each time application exits, so the file read over RPC as a regular file
+ * is current. `loader profile save` writes ring to another path on request.
+ */
+
+#pragma once
+
+#include <storage/storage.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOADER_PROFILE_PATH "/ext/.loader.profile"
+#define LOADER_PROFILE_RING_SIZE (16)
+#define LOADER_PROFILE_NAME_SIZE (24)
+/** Milestone wasn't reached */
+#define LOADER_PROFILE_NO_MARK UINT32_MAX
+
+typedef enum {
+    LoaderProfileMarkThreadStart, /**< Application thread is running */
+    LoaderProfileMarkViewDispatcherRun, /**< First view_dispatcher_run */
+    LoaderProfileMarkFirstFrame, /**< First frame after application added its view port */
+    LoaderProfileMarkCount,
+} LoaderProfileMark;
+
+/** Launch record, saved to ring file as is */
+typedef struct {
+    char name[LOADER_PROFILE_NAME_SIZE];
+    uint32_t sequence; /**< Launch number since boot */
+    uint32_t marks[LoaderProfileMarkCount]; /**< ms since start request or NO_MARK */
+    uint32_t storage_calls; /**< Storage API calls before first frame */
+    uint32_t storage_read; /**< Bytes read before first frame */
+    uint32_t heap_peak; /**< Most heap application thread had at once, bytes */
+    uint32_t stack_size; /**< Application stack size, bytes */
+    uint32_t stack_peak; /**< Most stack used, bytes */
+    uint32_t run_time; /**< ms from start request to exit */
+} LoaderProfileRecord;
+
+/** Finished launches */
+typedef struct {
+    uint32_t sequence; /**< Launches pushed */
+    LoaderProfileRecord records[LOADER_PROFILE_RING_SIZE];
+} LoaderProfileRing;
+
+/** Open launch record, called by loader on start request
+ *
+ * @param name          application name
+ * @param stack_size    application stack size
+ */
+void loader_profile_begin(const char* name, uint32_t stack_size);
+
+/** Application thread is running, called from application thread */
+void loader_profile_thread_started();
+
+/** Close launch record, called from application thread when it exits
+ *
+ * @param record        record to fill, sequence is set by ring push
+ * @param heap_peak     most heap application thread had at once
+ * @param stack_space   stack space that was never used
+ */
+void loader_profile_end(LoaderProfileRecord* record, size_t heap_peak, size_t stack_space);
+
+/** Probe: milestone reached
+ *
+ * ViewDispatcherRun counts from application thread only, FirstFrame only after application
+ * thread added its view port.
+ */
+void loader_profile_mark(LoaderProfileMark mark);
+
+/** Probe: view port added to GUI */
+void loader_profile_gui_attached();
+
+/** Probe: storage API call completed
+ *
+ * @param bytes_read    bytes read by the call
+ */
+void loader_profile_storage_call(uint32_t bytes_read);
+
+/** Push record to ring, oldest record is overwritten when ring is full
+ *
+ * @param ring      ring
+ * @param record    record to store, sequence is updated
+ */
+void loader_profile_ring_push(LoaderProfileRing* ring, LoaderProfileRecord* record);
+
+/** Get records from ring, newest first
+ *
+ * @param ring      ring
+ * @param records   buffer for records
+ * @param count     buffer size, records
+ *
+ * @return          records copied
+ */
+size_t loader_profile_ring_get(
+    const LoaderProfileRing* ring,
+    LoaderProfileRecord* records,
+    size_t count);
+
+/** Save ring to file: header followed by LOADER_PROFILE_RING_SIZE record slots
+ *
+ * @param ring      ring
+ * @param storage   Storage instance
+ * @param path      file path
+ *
+ * @return          true on success
+ */
+bool loader_profile_ring_save(const LoaderProfileRing* ring, Storage* storage, const char* path);
+
+/** Read records from saved ring file, newest first
+ *
+ * @param storage   Storage instance
+ * @param path      ring file path
+ * @param records   buffer for records
+ * @param count     buffer size, records
+ *
+ * @return          records read
+ */
+size_t loader_profile_ring_read(
+    Storage* storage,
+    const char* path,
+    LoaderProfileRecord* records,
+    size_t count);
+
+#ifdef __cplusplus
+}
+#endif
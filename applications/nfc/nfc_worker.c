@@ -649,11 +649,10 @@ void nfc_worker_emulate_mifare_ul(NfcWorker* nfc_worker) {
             5000);
         // Check if data was modified
         if(mf_ul_emulate.data_changed) {
-            nfc_worker->dev_data->mf_ul_data = mf_ul_emulate.data;
+            mf_ul_sync_emulation_data(&mf_ul_emulate, &nfc_worker->dev_data->mf_ul_data);
             if(nfc_worker->callback) {
                 nfc_worker->callback(nfc_worker->context);
             }
-            mf_ul_emulate.data_changed = false;
         }
     }
 }
@@ -94,14 +94,14 @@ bool nfc_scene_emulate_uid_on_event(void* context, SceneManagerEvent event) {
             if(!string_size(nfc->text_box_store)) {
                 nfc_scene_emulate_uid_widget_config(nfc, true);
             }
-            // Update TextBox data
-            string_cat_printf(nfc->text_box_store, "R:");
+            // Append new line to TextBox, store keeps only the last one
+            string_set_str(nfc->text_box_store, "R:");
             for(uint16_t i = 0; i < reader_data->size; i++) {
                 string_cat_printf(nfc->text_box_store, " %02X", reader_data->data[i]);
             }
             string_push_back(nfc->text_box_store, '\n');
             memset(reader_data, 0, sizeof(NfcReaderRequestData));
-            text_box_set_text(nfc->text_box, string_get_cstr(nfc->text_box_store));
+            text_box_append_text(nfc->text_box, string_get_cstr(nfc->text_box_store));
             consumed = true;
         } else if(event.event == GuiButtonTypeCenter && state == NfcSceneEmulateUidStateWidget) {
             view_dispatcher_switch_to_view(nfc->view_dispatcher, NfcViewTextBox);
@@ -30,12 +30,17 @@ typedef struct {
     float display_brightness;
 } NotificationMessageDataForcedSettings;
 
+typedef struct {
+    uint8_t level;
+} NotificationMessageDataPriority;
+
 typedef union {
     NotificationMessageDataSound sound;
     NotificationMessageDataLed led;
     NotificationMessageDataVibro vibro;
     NotificationMessageDataDelay delay;
     NotificationMessageDataForcedSettings forced_settings;
+    NotificationMessageDataPriority priority;
 } NotificationMessageData;
 
 typedef enum {
@@ -51,6 +56,7 @@ typedef enum {
     NotificationMessageTypeForceSpeakerVolumeSetting,
     NotificationMessageTypeForceVibroSetting,
     NotificationMessageTypeForceDisplayBrightnessSetting,
+    NotificationMessageTypePriority,
 } NotificationMessageType;
 
 typedef struct {
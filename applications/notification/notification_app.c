@@ -7,9 +7,6 @@
 
 #define TAG "NotificationSrv"
 
-static const uint8_t minimal_delay = 100;
-static const uint8_t led_off_values[NOTIFICATION_LED_COUNT] = {0x00, 0x00, 0x00};
-
 static const uint8_t reset_red_mask = 1 << 0;
 static const uint8_t reset_green_mask = 1 << 1;
 static const uint8_t reset_blue_mask = 1 << 2;
@@ -110,13 +107,6 @@ void notification_reset_notification_layer(NotificationApp* app, uint8_t reset_m
     }
 }
 
-static void notification_apply_notification_leds(NotificationApp* app, const uint8_t* values) {
-    for(uint8_t i = 0; i < NOTIFICATION_LED_COUNT; i++) {
-        notification_apply_notification_led_layer(
-            &app->led[i], notification_settings_get_rgb_led_brightness(app, values[i]));
-    }
-}
-
 // settings
 uint8_t notification_settings_get_display_brightness(NotificationApp* app, uint8_t value) {
     return (value * app->settings.display_brightness);
@@ -154,135 +144,111 @@ static void notification_display_timer(void* ctx) {
     notification_message(app, &sequence_display_off);
 }
 
-// message processing
-void notification_process_notification_message(
-    NotificationApp* app,
-    NotificationAppMessage* message) {
-    uint32_t notification_message_index = 0;
-    const NotificationMessage* notification_message;
-    notification_message = (*message->sequence)[notification_message_index];
-
-    bool led_active = false;
-    uint8_t led_values[NOTIFICATION_LED_COUNT] = {0x00, 0x00, 0x00};
-    bool reset_notifications = true;
-    float speaker_volume_setting = app->settings.speaker_volume;
-    bool vibro_setting = app->settings.vibro_on;
-    float display_brightness_setting = app->settings.display_brightness;
-
-    uint8_t reset_mask = 0;
+// timeline output
+static void notification_timeline_output_callback(
+    void* context,
+    NotificationChannel channel,
+    const NotificationTimelineValue* value) {
+    NotificationApp* app = context;
 
-    while(notification_message != NULL) {
-        switch(notification_message->type) {
-        case NotificationMessageTypeLedDisplay:
-            // if on - switch on and start timer
-            // if off - switch off and stop timer
-            // on timer - switch off
-            if(notification_message->data.led.value > 0x00) {
-                notification_apply_notification_led_layer(
-                    &app->display,
-                    notification_message->data.led.value * display_brightness_setting);
-            } else {
-                notification_reset_notification_led_layer(&app->display);
-                if(osTimerIsRunning(app->display_timer)) {
-                    osTimerStop(app->display_timer);
-                }
-            }
-            reset_mask |= reset_display_mask;
-            break;
-        case NotificationMessageTypeLedRed:
-            // store and send on delay or after seq
-            led_active = true;
-            led_values[0] = notification_message->data.led.value;
-            reset_mask |= reset_red_mask;
-            break;
-        case NotificationMessageTypeLedGreen:
-            // store and send on delay or after seq
-            led_active = true;
-            led_values[1] = notification_message->data.led.value;
-            reset_mask |= reset_green_mask;
-            break;
-        case NotificationMessageTypeLedBlue:
-            // store and send on delay or after seq
-            led_active = true;
-            led_values[2] = notification_message->data.led.value;
-            reset_mask |= reset_blue_mask;
-            break;
-        case NotificationMessageTypeVibro:
-            if(notification_message->data.vibro.on) {
-                if(vibro_setting) notification_vibro_on();
-            } else {
-                notification_vibro_off();
+    switch(channel) {
+    case NotificationChannelRed:
+    case NotificationChannelGreen:
+    case NotificationChannelBlue:
+        notification_apply_notification_led_layer(
+            &app->led[channel - NotificationChannelRed],
+            notification_settings_get_rgb_led_brightness(app, value->value));
+        break;
+    case NotificationChannelDisplay:
+        // if on - switch on and start timer
+        // if off - switch off and stop timer
+        // on timer - switch off
+        if(value->value > 0x00) {
+            notification_apply_notification_led_layer(&app->display, value->value);
+        } else {
+            notification_reset_notification_led_layer(&app->display);
+            if(osTimerIsRunning(app->display_timer)) {
+                osTimerStop(app->display_timer);
             }
-            reset_mask |= reset_vibro_mask;
-            break;
-        case NotificationMessageTypeSoundOn:
-            notification_sound_on(
-                notification_message->data.sound.pwm * speaker_volume_setting,
-                notification_message->data.sound.frequency);
-            reset_mask |= reset_sound_mask;
-            break;
-        case NotificationMessageTypeSoundOff:
+        }
+        break;
+    case NotificationChannelVibro:
+        if(value->value) {
+            notification_vibro_on();
+        } else {
+            notification_vibro_off();
+        }
+        break;
+    case NotificationChannelSpeaker:
+        if(value->value) {
+            notification_sound_on(value->pwm, value->frequency);
+        } else {
             notification_sound_off();
-            reset_mask |= reset_sound_mask;
-            break;
-        case NotificationMessageTypeDelay:
-            if(led_active) {
-                if(notification_is_any_led_layer_internal_and_not_empty(app)) {
-                    notification_apply_notification_leds(app, led_off_values);
-                    delay(minimal_delay);
-                }
-
-                led_active = false;
-
-                notification_apply_notification_leds(app, led_values);
-                reset_mask |= reset_red_mask;
-                reset_mask |= reset_green_mask;
-                reset_mask |= reset_blue_mask;
-            }
-
-            delay(notification_message->data.delay.length);
-            break;
-        case NotificationMessageTypeDoNotReset:
-            reset_notifications = false;
-            break;
-        case NotificationMessageTypeForceSpeakerVolumeSetting:
-            speaker_volume_setting = notification_message->data.forced_settings.speaker_volume;
-            break;
-        case NotificationMessageTypeForceVibroSetting:
-            vibro_setting = notification_message->data.forced_settings.vibro;
-            break;
-        case NotificationMessageTypeForceDisplayBrightnessSetting:
-            display_brightness_setting =
-                notification_message->data.forced_settings.display_brightness;
         }
-        notification_message_index++;
-        notification_message = (*message->sequence)[notification_message_index];
-    };
+        break;
+    default:
+        break;
+    }
+}
 
-    // send and do minimal delay
-    if(led_active) {
-        bool need_minimal_delay = false;
-        if(notification_is_any_led_layer_internal_and_not_empty(app)) {
-            need_minimal_delay = true;
-        }
+static void notification_timeline_reset_callback(void* context, NotificationChannel channel) {
+    NotificationApp* app = context;
+    const uint8_t reset_masks[NotificationChannelMax] = {
+        reset_red_mask,
+        reset_green_mask,
+        reset_blue_mask,
+        reset_display_mask,
+        reset_vibro_mask,
+        reset_sound_mask,
+    };
+    notification_reset_notification_layer(app, reset_masks[channel]);
+}
 
-        led_active = false;
-        notification_apply_notification_leds(app, led_values);
-        reset_mask |= reset_red_mask;
-        reset_mask |= reset_green_mask;
-        reset_mask |= reset_blue_mask;
+static bool notification_timeline_is_led_internal_on_callback(void* context) {
+    NotificationApp* app = context;
+    return notification_is_any_led_layer_internal_and_not_empty(app);
+}
 
-        if(need_minimal_delay) {
-            notification_apply_notification_leds(app, led_off_values);
-            delay(minimal_delay);
-        }
+static void notification_timeline_complete_callback(void* context, void* tag) {
+    osEventFlagsId_t back_event = tag;
+    if(back_event != NULL) {
+        osEventFlagsSet(back_event, NOTIFICATION_EVENT_COMPLETE);
     }
+}
+
+static const NotificationTimelineCallbacks notification_timeline_callbacks = {
+    .output = notification_timeline_output_callback,
+    .reset = notification_timeline_reset_callback,
+    .is_led_internal_on = notification_timeline_is_led_internal_on_callback,
+    .complete = notification_timeline_complete_callback,
+};
+
+static uint32_t notification_get_time() {
+    return osKernelGetTickCount() / (osKernelGetTickFreq() / 1000);
+}
 
-    if(reset_notifications) {
-        notification_reset_notification_layer(app, reset_mask);
+static uint32_t notification_time_to_ticks(uint32_t time) {
+    if(time == NOTIFICATION_TIMELINE_IDLE) {
+        return osWaitForever;
+    } else {
+        return time * (osKernelGetTickFreq() / 1000);
     }
 }
 
+// message processing
+void notification_process_notification_message(
+    NotificationApp* app,
+    NotificationAppMessage* message) {
+    NotificationTimelineSettings settings = {
+        .speaker_volume = app->settings.speaker_volume,
+        .vibro_on = app->settings.vibro_on,
+        .display_brightness = app->settings.display_brightness,
+    };
+    // Sequence runs along with others, back event is set on completion
+    notification_timeline_add(
+        app->timeline, message->sequence, &settings, message->back_event, notification_get_time());
+}
+
 void notification_process_internal_message(NotificationApp* app, NotificationAppMessage* message) {
     uint32_t notification_message_index = 0;
     const NotificationMessage* notification_message;
@@ -435,6 +401,8 @@ static NotificationApp* notification_app_alloc() {
 
     app->settings.version = NOTIFICATION_SETTINGS_VERSION;
 
+    app->timeline = notification_timeline_alloc(&notification_timeline_callbacks, app);
+
     // display backlight control
     app->event_record = furi_record_open("input_events");
     furi_pubsub_subscribe(app->event_record, input_event_callback, app);
@@ -461,24 +429,33 @@ int32_t notification_srv(void* p) {
     furi_record_create("notification", app);
 
     NotificationAppMessage message;
+    uint32_t timeout = NOTIFICATION_TIMELINE_IDLE;
     while(1) {
-        furi_check(osMessageQueueGet(app->queue, &message, NULL, osWaitForever) == osOK);
+        // Wait for message or for the next timeline event
+        osStatus_t status = osMessageQueueGet(
+            app->queue, &message, NULL, notification_time_to_ticks(timeout));
+        furi_check(status == osOK || status == osErrorTimeout);
+
+        if(status == osOK) {
+            switch(message.type) {
+            case NotificationLayerMessage:
+                notification_process_notification_message(app, &message);
+                message.back_event = NULL;
+                break;
+            case InternalLayerMessage:
+                notification_process_internal_message(app, &message);
+                break;
+            case SaveSettingsMessage:
+                notification_save_settings(app);
+                break;
+            }
 
-        switch(message.type) {
-        case NotificationLayerMessage:
-            notification_process_notification_message(app, &message);
-            break;
-        case InternalLayerMessage:
-            notification_process_internal_message(app, &message);
-            break;
-        case SaveSettingsMessage:
-            notification_save_settings(app);
-            break;
+            if(message.back_event != NULL) {
+                osEventFlagsSet(message.back_event, NOTIFICATION_EVENT_COMPLETE);
+            }
         }
 
-        if(message.back_event != NULL) {
-            osEventFlagsSet(message.back_event, NOTIFICATION_EVENT_COMPLETE);
-        }
+        timeout = notification_timeline_process(app->timeline, notification_get_time());
     }
 
     return 0;
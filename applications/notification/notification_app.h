@@ -2,6 +2,7 @@
 #include <furi_hal.h>
 #include "notification.h"
 #include "notification_messages.h"
+#include "notification_timeline.h"
 
 #define NOTIFICATION_LED_COUNT 3
 #define NOTIFICATION_EVENT_COMPLETE 0x00000001U
@@ -46,6 +47,7 @@ struct NotificationApp {
     osMessageQueueId_t queue;
     FuriPubSub* event_record;
     osTimerId_t display_timer;
+    NotificationTimeline* timeline;
 
     NotificationLedLayer display;
     NotificationLedLayer led[NOTIFICATION_LED_COUNT];
@@ -109,6 +109,12 @@ const NotificationMessage message_do_not_reset = {
     .type = NotificationMessageTypeDoNotReset,
 };
 
+// Priority
+const NotificationMessage message_priority_high = {
+    .type = NotificationMessageTypePriority,
+    .data.priority.level = 1,
+};
+
 // Override user settings
 const NotificationMessage message_force_speaker_volume_setting_1f = {
     .type = NotificationMessageTypeForceSpeakerVolumeSetting,
@@ -42,6 +42,9 @@ extern const NotificationMessage message_vibro_off;
 // Reset
 extern const NotificationMessage message_do_not_reset;
 
+// Priority, channels of sequence can't be taken over by sequences with lower priority
+extern const NotificationMessage message_priority_high;
+
 // Override user settings
 extern const NotificationMessage message_force_speaker_volume_setting_1f;
 extern const NotificationMessage message_force_vibro_setting_on;
@@ -0,0 +1,311 @@
+#include <furi.h>
+#include "notification_timeline.h"
+
+#define NOTIFICATION_TIMELINE_LED_COUNT (3)
+// Leds are off for that long before notification shown over internal layer
+#define NOTIFICATION_TIMELINE_LED_OFF_TIME (100)
+
+static const uint8_t led_off_values[NOTIFICATION_TIMELINE_LED_COUNT] = {0x00, 0x00, 0x00};
+
+typedef enum {
+    NotificationTimelineTrackStateIdle,
+    NotificationTimelineTrackStateRun,
+    NotificationTimelineTrackStateLedOff,
+} NotificationTimelineTrackState;
+
+typedef struct {
+    NotificationTimelineTrackState state;
+    const NotificationSequence* sequence;
+    size_t index;
+    uint32_t time;
+    uint32_t order;
+    void* tag;
+
+    uint8_t priority;
+    uint8_t channels;
+    uint8_t reset_mask;
+    bool reset;
+
+    bool led_active;
+    uint8_t led_values[NOTIFICATION_TIMELINE_LED_COUNT];
+    NotificationTimelineSettings settings;
+} NotificationTimelineTrack;
+
+struct NotificationTimeline {
+    NotificationTimelineTrack tracks[NOTIFICATION_TIMELINE_TRACKS];
+    uint32_t order;
+    const NotificationTimelineCallbacks* callbacks;
+    void* context;
+};
+
+NotificationTimeline*
+    notification_timeline_alloc(const NotificationTimelineCallbacks* callbacks, void* context) {
+    furi_assert(callbacks);
+    NotificationTimeline* timeline = malloc(sizeof(NotificationTimeline));
+    memset(timeline, 0, sizeof(NotificationTimeline));
+    timeline->callbacks = callbacks;
+    timeline->context = context;
+    return timeline;
+}
+
+void notification_timeline_free(NotificationTimeline* timeline) {
+    furi_assert(timeline);
+    free(timeline);
+}
+
+static bool notification_timeline_is_newer(
+    const NotificationTimelineTrack* track,
+    const NotificationTimelineTrack* other) {
+    return (int32_t)(track->order - other->order) > 0;
+}
+
+static bool notification_timeline_claim(
+    NotificationTimeline* timeline,
+    NotificationTimelineTrack* track,
+    NotificationChannel channel) {
+    const uint8_t mask = 1 << channel;
+    if(track->channels & mask) return true;
+
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_TRACKS; i++) {
+        NotificationTimelineTrack* owner = &timeline->tracks[i];
+        if(owner == track || !(owner->channels & mask)) continue;
+
+        if(track->priority > owner->priority ||
+           (track->priority == owner->priority && notification_timeline_is_newer(track, owner))) {
+            owner->channels &= ~mask;
+        } else {
+            return false;
+        }
+    }
+
+    track->channels |= mask;
+    return true;
+}
+
+static void notification_timeline_output(
+    NotificationTimeline* timeline,
+    NotificationTimelineTrack* track,
+    NotificationChannel channel,
+    const NotificationTimelineValue* value) {
+    if(notification_timeline_claim(timeline, track, channel)) {
+        track->reset_mask |= 1 << channel;
+        timeline->callbacks->output(timeline->context, channel, value);
+    }
+}
+
+static void notification_timeline_output_value(
+    NotificationTimeline* timeline,
+    NotificationTimelineTrack* track,
+    NotificationChannel channel,
+    uint8_t value) {
+    NotificationTimelineValue output = {.value = value};
+    notification_timeline_output(timeline, track, channel, &output);
+}
+
+static void notification_timeline_output_leds(
+    NotificationTimeline* timeline,
+    NotificationTimelineTrack* track,
+    const uint8_t* values) {
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_LED_COUNT; i++) {
+        notification_timeline_output_value(
+            timeline, track, NotificationChannelRed + i, values[i]);
+    }
+}
+
+// Show stored led values, returns true if leds are off for a while before that
+static bool notification_timeline_show_leds(
+    NotificationTimeline* timeline,
+    NotificationTimelineTrack* track) {
+    if(timeline->callbacks->is_led_internal_on(timeline->context)) {
+        notification_timeline_output_leds(timeline, track, led_off_values);
+        track->state = NotificationTimelineTrackStateLedOff;
+        track->time += NOTIFICATION_TIMELINE_LED_OFF_TIME;
+        return true;
+    }
+
+    notification_timeline_output_leds(timeline, track, track->led_values);
+    track->led_active = false;
+    return false;
+}
+
+static void notification_timeline_finish(
+    NotificationTimeline* timeline,
+    NotificationTimelineTrack* track) {
+    if(track->reset) {
+        for(size_t channel = 0; channel < NotificationChannelMax; channel++) {
+            if(track->channels & track->reset_mask & (1 << channel)) {
+                timeline->callbacks->reset(timeline->context, channel);
+            }
+        }
+    }
+
+    track->channels = 0;
+    track->state = NotificationTimelineTrackStateIdle;
+    if(timeline->callbacks->complete) {
+        timeline->callbacks->complete(timeline->context, track->tag);
+    }
+}
+
+// Output events of track up to the next delay
+static void
+    notification_timeline_step(NotificationTimeline* timeline, NotificationTimelineTrack* track) {
+    const NotificationMessage* message = (*track->sequence)[track->index];
+
+    if(track->state == NotificationTimelineTrackStateLedOff) {
+        // Leds were off long enough, finish delay or sequence that started it
+        notification_timeline_output_leds(timeline, track, track->led_values);
+        track->led_active = false;
+        track->state = NotificationTimelineTrackStateRun;
+        if(message == NULL) {
+            notification_timeline_finish(timeline, track);
+        } else {
+            track->time += message->data.delay.length;
+            track->index++;
+        }
+        return;
+    }
+
+    NotificationTimelineValue value = {0};
+    while(message != NULL) {
+        switch(message->type) {
+        case NotificationMessageTypeLedDisplay:
+            notification_timeline_output_value(
+                timeline,
+                track,
+                NotificationChannelDisplay,
+                message->data.led.value * track->settings.display_brightness);
+            break;
+        case NotificationMessageTypeLedRed:
+            // store and send on delay or after seq
+            track->led_active = true;
+            track->led_values[0] = message->data.led.value;
+            break;
+        case NotificationMessageTypeLedGreen:
+            track->led_active = true;
+            track->led_values[1] = message->data.led.value;
+            break;
+        case NotificationMessageTypeLedBlue:
+            track->led_active = true;
+            track->led_values[2] = message->data.led.value;
+            break;
+        case NotificationMessageTypeVibro:
+            if(!message->data.vibro.on || track->settings.vibro_on) {
+                notification_timeline_output_value(
+                    timeline, track, NotificationChannelVibro, message->data.vibro.on);
+            }
+            break;
+        case NotificationMessageTypeSoundOn:
+            value.value = 1;
+            value.pwm = message->data.sound.pwm * track->settings.speaker_volume;
+            value.frequency = message->data.sound.frequency;
+            notification_timeline_output(timeline, track, NotificationChannelSpeaker, &value);
+            break;
+        case NotificationMessageTypeSoundOff:
+            notification_timeline_output_value(timeline, track, NotificationChannelSpeaker, 0);
+            break;
+        case NotificationMessageTypeDelay:
+            if(track->led_active && notification_timeline_show_leds(timeline, track)) return;
+            track->time += message->data.delay.length;
+            track->index++;
+            return;
+        case NotificationMessageTypeDoNotReset:
+            track->reset = false;
+            break;
+        case NotificationMessageTypeForceSpeakerVolumeSetting:
+            track->settings.speaker_volume = message->data.forced_settings.speaker_volume;
+            break;
+        case NotificationMessageTypeForceVibroSetting:
+            track->settings.vibro_on = message->data.forced_settings.vibro;
+            break;
+        case NotificationMessageTypeForceDisplayBrightnessSetting:
+            track->settings.display_brightness =
+                message->data.forced_settings.display_brightness;
+            break;
+        case NotificationMessageTypePriority:
+            track->priority = message->data.priority.level;
+            break;
+        }
+        track->index++;
+        message = (*track->sequence)[track->index];
+    }
+
+    if(track->led_active && notification_timeline_show_leds(timeline, track)) return;
+    notification_timeline_finish(timeline, track);
+}
+
+// Track with the earliest event, older one goes first
+static NotificationTimelineTrack* notification_timeline_get_next(NotificationTimeline* timeline) {
+    NotificationTimelineTrack* next = NULL;
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_TRACKS; i++) {
+        NotificationTimelineTrack* track = &timeline->tracks[i];
+        if(track->state == NotificationTimelineTrackStateIdle) continue;
+        if(next == NULL) {
+            next = track;
+        } else {
+            int32_t diff = track->time - next->time;
+            if(diff < 0 || (diff == 0 && notification_timeline_is_newer(next, track))) {
+                next = track;
+            }
+        }
+    }
+    return next;
+}
+
+void notification_timeline_add(
+    NotificationTimeline* timeline,
+    const NotificationSequence* sequence,
+    const NotificationTimelineSettings* settings,
+    void* tag,
+    uint32_t now) {
+    furi_assert(timeline);
+    furi_assert(sequence);
+    furi_assert(settings);
+
+    NotificationTimelineTrack* track = NULL;
+    NotificationTimelineTrack* oldest = NULL;
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_TRACKS; i++) {
+        if(timeline->tracks[i].state == NotificationTimelineTrackStateIdle) {
+            track = &timeline->tracks[i];
+            break;
+        }
+        if(oldest == NULL || notification_timeline_is_newer(oldest, &timeline->tracks[i])) {
+            oldest = &timeline->tracks[i];
+        }
+    }
+
+    if(track == NULL) {
+        notification_timeline_finish(timeline, oldest);
+        track = oldest;
+    }
+
+    memset(track, 0, sizeof(NotificationTimelineTrack));
+    track->state = NotificationTimelineTrackStateRun;
+    track->sequence = sequence;
+    track->time = now;
+    track->order = timeline->order++;
+    track->tag = tag;
+    track->reset = true;
+    track->settings = *settings;
+}
+
+uint32_t notification_timeline_process(NotificationTimeline* timeline, uint32_t now) {
+    furi_assert(timeline);
+
+    NotificationTimelineTrack* track = notification_timeline_get_next(timeline);
+    while(track != NULL && (int32_t)(track->time - now) <= 0) {
+        notification_timeline_step(timeline, track);
+        track = notification_timeline_get_next(timeline);
+    }
+
+    return track ? (track->time - now) : NOTIFICATION_TIMELINE_IDLE;
+}
+
+size_t notification_timeline_get_track_count(NotificationTimeline* timeline) {
+    furi_assert(timeline);
+
+    size_t count = 0;
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_TRACKS; i++) {
+        if(timeline->tracks[i].state != NotificationTimelineTrackStateIdle) count++;
+    }
+    return count;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file notification_timeline.h
+ * Notification sequences scheduler.
+ *
+ * Every sequence becomes a track on one shared timeline. Tracks run concurrently, each output
+ * channel is owned by one track at a time: newer track or track with higher priority takes
+ * the channel over, events of other tracks on that channel are dropped. Nothing blocks,
+ * caller waits for the time returned by notification_timeline_process.
+ */
+
+#pragma once
+
+#include "notification.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NOTIFICATION_TIMELINE_TRACKS (8)
+#define NOTIFICATION_TIMELINE_IDLE (0xFFFFFFFFU)
+
+typedef enum {
+    NotificationChannelRed,
+    NotificationChannelGreen,
+    NotificationChannelBlue,
+    NotificationChannelDisplay,
+    NotificationChannelVibro,
+    NotificationChannelSpeaker,
+    NotificationChannelMax,
+} NotificationChannel;
+
+typedef struct {
+    uint8_t value; /**< Light value, 1/0 for vibro and speaker on/off */
+    float pwm; /**< Speaker pwm, volume applied */
+    float frequency; /**< Speaker frequency */
+} NotificationTimelineValue;
+
+typedef struct {
+    float speaker_volume;
+    bool vibro_on;
+    float display_brightness;
+} NotificationTimelineSettings;
+
+typedef struct {
+    /** Set channel value */
+    void (*output)(
+        void* context,
+        NotificationChannel channel,
+        const NotificationTimelineValue* value);
+    /** Return channel to its state before notification */
+    void (*reset)(void* context, NotificationChannel channel);
+    /** Leds show internal layer, notification must blink them off first to be noticed */
+    bool (*is_led_internal_on)(void* context);
+    /** Track is finished, tag is the one given to notification_timeline_add */
+    void (*complete)(void* context, void* tag);
+} NotificationTimelineCallbacks;
+
+typedef struct NotificationTimeline NotificationTimeline;
+
+/** Allocate NotificationTimeline
+ *
+ * @param callbacks output callbacks, must stay valid
+ * @param context callbacks context
+ * @return NotificationTimeline instance
+ */
+NotificationTimeline*
+    notification_timeline_alloc(const NotificationTimelineCallbacks* callbacks, void* context);
+
+/** Free NotificationTimeline, running tracks are dropped without output
+ *
+ * @param timeline NotificationTimeline instance
+ */
+void notification_timeline_free(NotificationTimeline* timeline);
+
+/** Add sequence to the timeline. If all tracks are busy, the oldest one is finished.
+ * First events are output on the next notification_timeline_process call.
+ *
+ * @param timeline NotificationTimeline instance
+ * @param sequence notification sequence, must stay valid until completion
+ * @param settings user settings, sequence may override them
+ * @param tag passed to complete callback
+ * @param now current time, ms
+ */
+void notification_timeline_add(
+    NotificationTimeline* timeline,
+    const NotificationSequence* sequence,
+    const NotificationTimelineSettings* settings,
+    void* tag,
+    uint32_t now);
+
+/** Output all events due by now
+ *
+ * @param timeline NotificationTimeline instance
+ * @param now current time, ms
+ * @return time to the next event, ms, NOTIFICATION_TIMELINE_IDLE if there are no tracks
+ */
+uint32_t notification_timeline_process(NotificationTimeline* timeline, uint32_t now);
+
+/** Get count of running tracks
+ *
+ * @param timeline NotificationTimeline instance
+ * @return tracks count
+ */
+size_t notification_timeline_get_track_count(NotificationTimeline* timeline);
+
+#ifdef __cplusplus
+}
+#endif
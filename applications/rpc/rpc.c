@@ -34,7 +34,7 @@ typedef struct {
 static RpcSystemCallbacks rpc_systems[] = {
     {
         .alloc = rpc_system_system_alloc,
-        .free = NULL,
+        .free = rpc_system_system_free,
     },
     {
         .alloc = rpc_system_storage_alloc,
@@ -121,6 +121,8 @@ static void
         return;
     }
 
+    event.timestamp = osKernelGetTickCount();
+
     FuriPubSub* input_events = furi_record_open("input_events");
     furi_check(input_events);
     furi_pubsub_publish(input_events, &event);
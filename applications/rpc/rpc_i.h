@@ -22,6 +22,7 @@ void rpc_send_and_release_empty(Rpc* rpc, uint32_t command_id, PB_CommandStatus
 void rpc_add_handler(Rpc* rpc, pb_size_t message_tag, RpcHandler* handler);
 
 void* rpc_system_system_alloc(Rpc* rpc);
+void rpc_system_system_free(void* ctx);
 void* rpc_system_storage_alloc(Rpc* rpc);
 void rpc_system_storage_free(void* ctx);
 void* rpc_system_app_alloc(Rpc* rpc);
@@ -9,7 +9,7 @@
 #include "storage/filesystem_api_defines.h"
 #include "storage/storage.h"
 #include <stdint.h>
-#include <lib/toolbox/md5.h>
+#include <lib/toolbox/hash.h>
 
 #define RPC_TAG "RPC_STORAGE"
 #define MAX_NAME_LENGTH 255
@@ -440,21 +440,12 @@ static void rpc_system_storage_md5sum_process(const PB_Main* request, void* cont
     Storage* fs_api = furi_record_open("storage");
     File* file = storage_file_alloc(fs_api);
 
-    if(storage_file_open(file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        const uint16_t read_size = 512;
-        const uint8_t hash_size = 16;
-        uint8_t* data = malloc(read_size);
-        uint8_t* hash = malloc(sizeof(uint8_t) * hash_size);
-        md5_context* md5_ctx = malloc(sizeof(md5_context));
-
-        md5_starts(md5_ctx);
-        while(true) {
-            uint16_t readed_size = storage_file_read(file, data, read_size);
-            if(readed_size == 0) break;
-            md5_update(md5_ctx, data, readed_size);
-        }
-        md5_finish(md5_ctx, hash);
-        free(md5_ctx);
+    Hash* md5 = hash_alloc(HashTypeMd5);
+
+    if(storage_file_open(file, filename, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       hash_update_file(md5, file)) {
+        uint8_t hash[HASH_SIZE_MAX];
+        size_t hash_size = hash_finish(md5, hash);
 
         PB_Main response = {
             .command_id = request->command_id,
@@ -467,12 +458,8 @@ static void rpc_system_storage_md5sum_process(const PB_Main* request, void* cont
         size_t md5sum_size = sizeof(response.content.storage_md5sum_response.md5sum);
         (void)md5sum_size;
         furi_assert(hash_size <= ((md5sum_size - 1) / 2));
-        for(uint8_t i = 0; i < hash_size; i++) {
-            md5sum += sprintf(md5sum, "%02x", hash[i]);
-        }
+        hash_digest_to_string(hash, hash_size, md5sum);
 
-        free(hash);
-        free(data);
         storage_file_close(file);
         rpc_send_and_release(rpc_storage->rpc, &response);
     } else {
@@ -480,6 +467,7 @@ static void rpc_system_storage_md5sum_process(const PB_Main* request, void* cont
             rpc_storage->rpc, request->command_id, rpc_system_storage_get_file_error(file));
     }
 
+    hash_free(md5);
     storage_file_free(file);
 
     furi_record_close("storage");
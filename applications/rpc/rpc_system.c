@@ -6,6 +6,11 @@
 
 #include "rpc_i.h"
 
+typedef struct {
+    Rpc* rpc;
+    FuriThreadProfiler* thread_profiler;
+} RpcSystem;
+
 static void rpc_system_system_ping_process(const PB_Main* msg_request, void* context) {
     furi_assert(msg_request);
     furi_assert(msg_request->which_content == PB_Main_system_ping_request_tag);
@@ -56,6 +61,7 @@ static void rpc_system_system_reboot_process(const PB_Main* request, void* conte
 typedef struct {
     Rpc* rpc;
     PB_Main* response;
+    bool more; /**< Keys follow after last one from furi_hal_info */
 } RpcSystemSystemDeviceInfoContext;
 
 static void rpc_system_system_device_info_callback(
@@ -71,18 +77,75 @@ static void rpc_system_system_device_info_callback(
     char* str_key = strdup(key);
     char* str_value = strdup(value);
 
-    ctx->response->has_next = !last;
+    ctx->response->has_next = !last || ctx->more;
     ctx->response->content.system_device_info_response.key = str_key;
     ctx->response->content.system_device_info_response.value = str_value;
 
     rpc_send_and_release(ctx->rpc, ctx->response);
 }
 
+static void rpc_system_system_device_info_threads(
+    FuriThreadProfiler* profiler,
+    RpcSystemSystemDeviceInfoContext* ctx) {
+    FuriThreadProfilerThread* threads =
+        malloc(sizeof(FuriThreadProfilerThread) * FURI_THREAD_PROFILER_THREADS_MAX);
+    FuriThreadProfilerSummary summary;
+    furi_thread_profiler_sample(profiler);
+    size_t count =
+        furi_thread_profiler_get(profiler, &summary, threads, FURI_THREAD_PROFILER_THREADS_MAX);
+
+    string_t key;
+    string_t value;
+    string_init(key);
+    string_init(value);
+
+    // Shares and rates are since previous request of this session
+    string_printf(value, "%lu", summary.window_ms);
+    rpc_system_system_device_info_callback("thread_window_ms", string_get_cstr(value), false, ctx);
+    string_printf(value, "%u.%u", summary.sleep_window / 10, summary.sleep_window % 10);
+    rpc_system_system_device_info_callback("thread_sleep", string_get_cstr(value), false, ctx);
+    string_printf(value, "%lu", summary.switches);
+    rpc_system_system_device_info_callback("thread_switches", string_get_cstr(value), false, ctx);
+    string_printf(value, "%lu", summary.sample_cycles_max);
+    rpc_system_system_device_info_callback(
+        "thread_sample_cycles_max", string_get_cstr(value), false, ctx);
+    string_printf(value, "%u", count);
+    ctx->more = count > 0;
+    rpc_system_system_device_info_callback("thread_count", string_get_cstr(value), true, ctx);
+
+    for(size_t i = 0; i < count; i++) {
+        ctx->more = i + 1 < count;
+        string_printf(key, "thread_%u_name", i);
+        rpc_system_system_device_info_callback(string_get_cstr(key), threads[i].name, false, ctx);
+        string_printf(key, "thread_%u_cpu", i);
+        string_printf(value, "%u.%u", threads[i].cpu_window / 10, threads[i].cpu_window % 10);
+        rpc_system_system_device_info_callback(
+            string_get_cstr(key), string_get_cstr(value), false, ctx);
+        string_printf(key, "thread_%u_switches", i);
+        string_printf(value, "%lu", threads[i].switches);
+        rpc_system_system_device_info_callback(
+            string_get_cstr(key), string_get_cstr(value), false, ctx);
+        string_printf(key, "thread_%u_stack_size", i);
+        string_printf(value, "%lu", threads[i].stack_size);
+        rpc_system_system_device_info_callback(
+            string_get_cstr(key), string_get_cstr(value), false, ctx);
+        string_printf(key, "thread_%u_stack_free", i);
+        string_printf(value, "%lu", threads[i].stack_free);
+        rpc_system_system_device_info_callback(
+            string_get_cstr(key), string_get_cstr(value), true, ctx);
+    }
+
+    string_clear(key);
+    string_clear(value);
+    free(threads);
+}
+
 static void rpc_system_system_device_info_process(const PB_Main* request, void* context) {
     furi_assert(request);
     furi_assert(request->which_content == PB_Main_system_device_info_request_tag);
     furi_assert(context);
-    Rpc* rpc = context;
+    RpcSystem* rpc_system = context;
+    Rpc* rpc = rpc_system->rpc;
 
     PB_Main* response = malloc(sizeof(PB_Main));
     response->command_id = request->command_id;
@@ -92,9 +155,13 @@ static void rpc_system_system_device_info_process(const PB_Main* request, void*
     RpcSystemSystemDeviceInfoContext device_info_context = {
         .rpc = rpc,
         .response = response,
+        .more = rpc_system->thread_profiler != NULL,
     };
 
     furi_hal_info_get(rpc_system_system_device_info_callback, &device_info_context);
+    if(rpc_system->thread_profiler) {
+        rpc_system_system_device_info_threads(rpc_system->thread_profiler, &device_info_context);
+    }
 
     free(response);
 }
@@ -195,6 +262,15 @@ static void rpc_system_system_protobuf_version_process(const PB_Main* request, v
 }
 
 void* rpc_system_system_alloc(Rpc* rpc) {
+    RpcSystem* rpc_system = malloc(sizeof(RpcSystem));
+    rpc_system->rpc = rpc;
+    // Thread stats in device info are for debug sessions only: they add ~5 keys per thread
+    // and a scheduler sample to every request. Session start is the first window edge.
+    if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
+        rpc_system->thread_profiler = furi_thread_profiler_alloc(2);
+        furi_thread_profiler_sample(rpc_system->thread_profiler);
+    }
+
     RpcHandler rpc_handler = {
         .message_handler = NULL,
         .decode_submessage = NULL,
@@ -208,7 +284,9 @@ void* rpc_system_system_alloc(Rpc* rpc) {
     rpc_add_handler(rpc, PB_Main_system_reboot_request_tag, &rpc_handler);
 
     rpc_handler.message_handler = rpc_system_system_device_info_process;
+    rpc_handler.context = rpc_system;
     rpc_add_handler(rpc, PB_Main_system_device_info_request_tag, &rpc_handler);
+    rpc_handler.context = rpc;
 
     rpc_handler.message_handler = rpc_system_system_factory_reset_process;
     rpc_add_handler(rpc, PB_Main_system_factory_reset_request_tag, &rpc_handler);
@@ -225,5 +303,13 @@ void* rpc_system_system_alloc(Rpc* rpc) {
     rpc_handler.message_handler = rpc_system_system_protobuf_version_process;
     rpc_add_handler(rpc, PB_Main_system_protobuf_version_request_tag, &rpc_handler);
 
-    return NULL;
+    return rpc_system;
+}
+
+void rpc_system_system_free(void* ctx) {
+    RpcSystem* rpc_system = ctx;
+    if(rpc_system->thread_profiler) {
+        furi_thread_profiler_free(rpc_system->thread_profiler);
+    }
+    free(rpc_system);
 }
@@ -20,6 +20,20 @@ void storage_file_free(File* file);
 
 FuriPubSub* storage_get_pubsub(Storage* storage);
 
+/** Storage API call callback, for profiling
+ * Called from thread that made the call, must be short and must not block
+ * @param bytes_read bytes read by the call
+ * @param context callback context
+ */
+typedef void (*StorageCallCallback)(uint16_t bytes_read, void* context);
+
+/** Sets storage API call callback
+ * @param storage pointer to the api
+ * @param callback callback, NULL to remove
+ * @param context callback context
+ */
+void storage_set_call_callback(Storage* storage, StorageCallCallback callback, void* context);
+
 /******************* File Functions *******************/
 
 /** Opens an existing file or create a new one.
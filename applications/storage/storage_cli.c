@@ -3,7 +3,7 @@
 
 #include <cli/cli.h>
 #include <lib/toolbox/args.h>
-#include <lib/toolbox/md5.h>
+#include <lib/toolbox/hash.h>
 #include <storage/storage.h>
 #include <storage/storage_sd_api.h>
 #include <power/power_service/power.h>
@@ -29,6 +29,9 @@ static void storage_cli_print_usage() {
     printf("\trename\t - move file to new file, <args> must contain new path\r\n");
     printf("\tmkdir\t - creates a new directory\r\n");
     printf("\tmd5\t - md5 hash of the file\r\n");
+    printf("\tsha1\t - sha1 hash of the file\r\n");
+    printf("\tsha256\t - sha256 hash of the file\r\n");
+    printf("\tcrc32\t - crc32 of the file\r\n");
     printf("\tstat\t - info about file or dir\r\n");
 };
 
@@ -395,33 +398,22 @@ static void storage_cli_mkdir(Cli* cli, string_t path) {
     furi_record_close("storage");
 }
 
-static void storage_cli_md5(Cli* cli, string_t path) {
+static void storage_cli_hash(Cli* cli, string_t path, HashType type) {
     Storage* api = furi_record_open("storage");
     File* file = storage_file_alloc(api);
 
     if(storage_file_open(file, string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
-        const uint16_t read_size = 512;
-        const uint8_t hash_size = 16;
-        uint8_t* data = malloc(read_size);
-        uint8_t* hash = malloc(sizeof(uint8_t) * hash_size);
-        md5_context* md5_ctx = malloc(sizeof(md5_context));
-
-        md5_starts(md5_ctx);
-        while(true) {
-            uint16_t readed_size = storage_file_read(file, data, read_size);
-            if(readed_size == 0) break;
-            md5_update(md5_ctx, data, readed_size);
-        }
-        md5_finish(md5_ctx, hash);
-        free(md5_ctx);
-
-        for(uint8_t i = 0; i < hash_size; i++) {
-            printf("%02x", hash[i]);
+        Hash* hash = hash_alloc(type);
+        if(hash_update_file(hash, file)) {
+            uint8_t digest[HASH_SIZE_MAX];
+            char digest_string[HASH_SIZE_MAX * 2 + 1];
+            size_t digest_size = hash_finish(hash, digest);
+            hash_digest_to_string(digest, digest_size, digest_string);
+            printf("%s\r\n", digest_string);
+        } else {
+            storage_cli_print_error(storage_file_get_error(file));
         }
-        printf("\r\n");
-
-        free(hash);
-        free(data);
+        hash_free(hash);
     } else {
         storage_cli_print_error(storage_file_get_error(file));
     }
@@ -504,8 +496,9 @@ void storage_cli(Cli* cli, string_t args, void* context) {
             break;
         }
 
-        if(string_cmp_str(cmd, "md5") == 0) {
-            storage_cli_md5(cli, path);
+        HashType hash_type;
+        if(hash_get_type(string_get_cstr(cmd), &hash_type)) {
+            storage_cli_hash(cli, path, hash_type);
             break;
         }
 
@@ -6,6 +6,11 @@
 
 #define MAX_NAME_LENGTH 256
 
+static void storage_call_notify(Storage* storage, uint16_t bytes_read) {
+    StorageCallCallback callback = storage->call_callback;
+    if(callback) callback(bytes_read, storage->call_callback_context);
+}
+
 #define S_API_PROLOGUE                                      \
     osSemaphoreId_t semaphore = osSemaphoreNew(1, 0, NULL); \
     furi_check(semaphore != NULL);
@@ -17,7 +22,9 @@
 #define S_API_EPILOGUE                                                                         \
     furi_check(osMessageQueuePut(storage->message_queue, &message, 0, osWaitForever) == osOK); \
     osSemaphoreAcquire(semaphore, osWaitForever);                                              \
-    osSemaphoreDelete(semaphore);
+    osSemaphoreDelete(semaphore);                                                              \
+    storage_call_notify(                                                                       \
+        storage, message.command == StorageCommandFileRead ? return_data.uint16_value : 0);
 
 #define S_API_MESSAGE(_command)      \
     SAReturn return_data;            \
@@ -395,6 +402,14 @@ FuriPubSub* storage_get_pubsub(Storage* storage) {
     return storage->pubsub;
 }
 
+void storage_set_call_callback(Storage* storage, StorageCallCallback callback, void* context) {
+    furi_assert(storage);
+    // Callback is read without lock: it never sees context of other callback
+    storage->call_callback = NULL;
+    storage->call_callback_context = context;
+    storage->call_callback = callback;
+}
+
 bool storage_simply_remove_recursive(Storage* storage, const char* path) {
     furi_assert(storage);
     furi_assert(path);
@@ -1,6 +1,7 @@
 #pragma once
 #include <furi.h>
 #include <gui/gui.h>
+#include "storage.h"
 #include "storage_glue.h"
 #include "storage_sd_api.h"
 #include "filesystem_api_internal.h"
@@ -22,6 +23,8 @@ struct Storage {
     StorageStatus prev_ext_storage_status;
     StorageSDGui sd_gui;
     FuriPubSub* pubsub;
+    volatile StorageCallCallback call_callback;
+    void* call_callback_context;
 };
 
 #ifdef __cplusplus
@@ -139,3 +139,8 @@ bool subghz_chat_worker_write(SubGhzChatWorker* instance, uint8_t* data, size_t
     furi_assert(instance);
     return subghz_tx_rx_worker_write(instance->subghz_txrx, data, size);
 }
+
+void subghz_chat_worker_get_stats(SubGhzChatWorker* instance, SubGhzTxRxWorkerStats* stats) {
+    furi_assert(instance);
+    subghz_tx_rx_worker_get_stats(instance->subghz_txrx, stats);
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "../subghz_i.h"
+#include <lib/subghz/subghz_tx_rx_worker.h>
 
 typedef struct SubGhzChatWorker SubGhzChatWorker;
 
@@ -27,3 +28,4 @@ void subghz_chat_worker_put_event_chat(SubGhzChatWorker* instance, SubghzChatEve
 size_t subghz_chat_worker_available(SubGhzChatWorker* instance);
 size_t subghz_chat_worker_read(SubGhzChatWorker* instance, uint8_t* data, size_t size);
 bool subghz_chat_worker_write(SubGhzChatWorker* instance, uint8_t* data, size_t size);
+void subghz_chat_worker_get_stats(SubGhzChatWorker* instance, SubGhzTxRxWorkerStats* stats);
@@ -23,6 +23,38 @@ static const uint8_t subghz_preset_ook_650khz[][2] = {
     {0, 0},
 };
 
+#define TAG "SubGhzFrequencyAnalyzerWorker"
+
+#define SUBGHZ_FREQUENCY_ANALYZER_THRESHOLD -90.0f
+#define SUBGHZ_FREQUENCY_ANALYZER_RSSI_MIN -127.0f
+
+// Fine sweep: 10kHz step from -250kHz to +240kHz around coarse channel
+#define SUBGHZ_FREQUENCY_ANALYZER_FINE_STEP 10000
+#define SUBGHZ_FREQUENCY_ANALYZER_FINE_OFFSET 250000
+// While signal is tracked only bins around last peak are swept,
+// coarse channels and whole fine window are swept every Nth pass
+#define SUBGHZ_FREQUENCY_ANALYZER_TRACK_BINS 6
+#define SUBGHZ_FREQUENCY_ANALYZER_FULL_SWEEP_EVERY 4
+
+// RSSI is valid after IDLE to RX transition without calibration (~90us) and a few
+// RSSI filter samples, sample period is inversely proportional to RX bandwidth
+#define SUBGHZ_FREQUENCY_ANALYZER_SETTLE_650KHZ_US 120
+#define SUBGHZ_FREQUENCY_ANALYZER_SETTLE_58KHZ_US 500
+
+// Result is reported once per period with the strongest peak seen during it
+#define SUBGHZ_FREQUENCY_ANALYZER_REPORT_PERIOD 50
+#define SUBGHZ_FREQUENCY_ANALYZER_HOLD_PERIODS 20
+#define SUBGHZ_FREQUENCY_ANALYZER_DECAY 3.0f
+
+/** Precomputed registers of coarse channel and its fine window */
+typedef struct {
+    uint32_t frequency;
+    FuriHalSubGhzChannel channel;
+    FuriHalSubGhzChannel fine[SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE];
+    uint32_t fine_frequency[SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE];
+    uint64_t fine_valid;
+} SubGhzFrequencyAnalyzerChannel;
+
 struct SubGhzFrequencyAnalyzerWorker {
     FuriThread* thread;
 
@@ -32,8 +64,14 @@ struct SubGhzFrequencyAnalyzerWorker {
 
     float filVal;
 
+    SubGhzFrequencyAnalyzerChannel* plan;
+    size_t plan_count;
+    SubGhzFrequencyAnalyzerSpectrum spectrum;
+
     SubGhzFrequencyAnalyzerWorkerPairCallback pair_callback;
     void* context;
+    SubGhzFrequencyAnalyzerWorkerSpectrumCallback spectrum_callback;
+    void* spectrum_context;
 };
 
 // running average with adaptive coefficient
@@ -52,6 +90,154 @@ static uint32_t subghz_frequency_analyzer_worker_expRunningAverageAdaptive(
     return (uint32_t)instance->filVal;
 }
 
+/** Calibrate coarse channels once and derive registers of fine windows
+ * 
+ * @param instance SubGhzFrequencyAnalyzerWorker instance
+ */
+static void subghz_frequency_analyzer_worker_build_plan(SubGhzFrequencyAnalyzerWorker* instance) {
+    instance->plan = malloc(subghz_frequencies_count * sizeof(SubGhzFrequencyAnalyzerChannel));
+    instance->plan_count = 0;
+
+    for(size_t i = 0; i < subghz_frequencies_count; i++) {
+        if(!furi_hal_subghz_is_frequency_valid(subghz_frequencies[i])) continue;
+        SubGhzFrequencyAnalyzerChannel* channel = &instance->plan[instance->plan_count++];
+        furi_hal_subghz_idle();
+        channel->frequency =
+            furi_hal_subghz_calibrate_channel(subghz_frequencies[i], &channel->channel);
+
+        channel->fine_valid = 0;
+        uint32_t frequency = subghz_frequencies[i] - SUBGHZ_FREQUENCY_ANALYZER_FINE_OFFSET;
+        for(size_t j = 0; j < SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE; j++) {
+            if(furi_hal_subghz_is_frequency_valid(frequency)) {
+                channel->fine_frequency[j] = furi_hal_subghz_derive_channel(
+                    frequency, &channel->channel, &channel->fine[j]);
+                channel->fine_valid |= (1ULL << j);
+            }
+            frequency += SUBGHZ_FREQUENCY_ANALYZER_FINE_STEP;
+        }
+    }
+}
+
+static float subghz_frequency_analyzer_worker_get_rssi(
+    const FuriHalSubGhzChannel* channel,
+    uint32_t settle_us) {
+    furi_hal_subghz_rx_channel(channel);
+    delay_us(settle_us);
+    return furi_hal_subghz_get_rssi();
+}
+
+/** Sweep coarse channels
+ * 
+ * @param instance SubGhzFrequencyAnalyzerWorker instance
+ * @return index of the strongest channel above threshold, -1 if none
+ */
+static int32_t
+    subghz_frequency_analyzer_worker_sweep_coarse(SubGhzFrequencyAnalyzerWorker* instance) {
+    int32_t peak = -1;
+    float peak_rssi = SUBGHZ_FREQUENCY_ANALYZER_THRESHOLD;
+
+    furi_hal_subghz_idle();
+    furi_hal_subghz_load_registers(subghz_preset_ook_650khz);
+    for(size_t i = 0; i < instance->plan_count; i++) {
+        float rssi = subghz_frequency_analyzer_worker_get_rssi(
+            &instance->plan[i].channel, SUBGHZ_FREQUENCY_ANALYZER_SETTLE_650KHZ_US);
+        if(rssi > peak_rssi) {
+            peak_rssi = rssi;
+            peak = i;
+        }
+    }
+    return peak;
+}
+
+/** Sweep fine window bins and update spectrum
+ * 
+ * @param instance SubGhzFrequencyAnalyzerWorker instance
+ * @param channel coarse channel
+ * @param first first bin
+ * @param last last bin
+ * @param peak strongest bin
+ * @return strongest frequency and its RSSI
+ */
+static FrequencyRSSI subghz_frequency_analyzer_worker_sweep_fine(
+    SubGhzFrequencyAnalyzerWorker* instance,
+    const SubGhzFrequencyAnalyzerChannel* channel,
+    int32_t first,
+    int32_t last,
+    int32_t* peak) {
+    FrequencyRSSI frequency_rssi = {.frequency = 0, .rssi = SUBGHZ_FREQUENCY_ANALYZER_RSSI_MIN};
+
+    furi_hal_subghz_idle();
+    furi_hal_subghz_load_registers(subghz_preset_ook_58khz);
+    for(int32_t i = first; i <= last; i++) {
+        if(!(channel->fine_valid & (1ULL << i))) continue;
+        float rssi = subghz_frequency_analyzer_worker_get_rssi(
+            &channel->fine[i], SUBGHZ_FREQUENCY_ANALYZER_SETTLE_58KHZ_US);
+        if(rssi > instance->spectrum.rssi[i]) instance->spectrum.rssi[i] = rssi;
+        if(rssi > frequency_rssi.rssi) {
+            frequency_rssi.rssi = rssi;
+            frequency_rssi.frequency = channel->fine_frequency[i];
+            *peak = i;
+        }
+    }
+    return frequency_rssi;
+}
+
+static void subghz_frequency_analyzer_worker_spectrum_reset(
+    SubGhzFrequencyAnalyzerWorker* instance,
+    const SubGhzFrequencyAnalyzerChannel* channel) {
+    instance->spectrum.frequency_start =
+        channel ? channel->frequency - SUBGHZ_FREQUENCY_ANALYZER_FINE_OFFSET : 0;
+    instance->spectrum.frequency_step = SUBGHZ_FREQUENCY_ANALYZER_FINE_STEP;
+    for(size_t i = 0; i < SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE; i++) {
+        instance->spectrum.rssi[i] = SUBGHZ_FREQUENCY_ANALYZER_RSSI_MIN;
+    }
+}
+
+static void
+    subghz_frequency_analyzer_worker_spectrum_decay(SubGhzFrequencyAnalyzerWorker* instance) {
+    for(size_t i = 0; i < SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE; i++) {
+        instance->spectrum.rssi[i] = MAX(
+            instance->spectrum.rssi[i] - SUBGHZ_FREQUENCY_ANALYZER_DECAY,
+            SUBGHZ_FREQUENCY_ANALYZER_RSSI_MIN);
+    }
+}
+
+/** Report strongest signal of the period
+ * 
+ * @param instance SubGhzFrequencyAnalyzerWorker instance
+ * @param frequency_rssi strongest signal
+ * @return false if signal is lost
+ */
+static bool subghz_frequency_analyzer_worker_report(
+    SubGhzFrequencyAnalyzerWorker* instance,
+    FrequencyRSSI frequency_rssi) {
+    bool ret = true;
+    if(frequency_rssi.rssi > SUBGHZ_FREQUENCY_ANALYZER_THRESHOLD) {
+        instance->count_repet = SUBGHZ_FREQUENCY_ANALYZER_HOLD_PERIODS;
+        if(instance->filVal) {
+            frequency_rssi.frequency = subghz_frequency_analyzer_worker_expRunningAverageAdaptive(
+                instance, frequency_rssi.frequency);
+        }
+        if(instance->pair_callback)
+            instance->pair_callback(
+                instance->context, frequency_rssi.frequency, frequency_rssi.rssi);
+
+    } else {
+        if(instance->count_repet > 0) {
+            instance->count_repet--;
+        } else {
+            instance->filVal = 0;
+            if(instance->pair_callback) instance->pair_callback(instance->context, 0, 0);
+            ret = false;
+        }
+    }
+
+    if(instance->spectrum_callback) {
+        instance->spectrum_callback(instance->spectrum_context, &instance->spectrum);
+    }
+    return ret;
+}
+
 /** Worker thread
  * 
  * @param context 
@@ -60,83 +246,88 @@ static uint32_t subghz_frequency_analyzer_worker_expRunningAverageAdaptive(
 static int32_t subghz_frequency_analyzer_worker_thread(void* context) {
     SubGhzFrequencyAnalyzerWorker* instance = context;
 
-    FrequencyRSSI frequency_rssi = {.frequency = 0, .rssi = 0};
-    float rssi;
-    uint32_t frequency;
-    uint32_t frequency_start;
+    // Sweep is busy waiting, let UI go first
+    osThreadSetPriority(osThreadGetId(), osPriorityBelowNormal);
 
     //Start CC1101
     furi_hal_subghz_reset();
     furi_hal_subghz_load_preset(FuriHalSubGhzPresetOok650Async);
-    furi_hal_subghz_set_frequency(433920000);
-    furi_hal_subghz_flush_rx();
-    furi_hal_subghz_rx();
+    // Register sets are applied on top of reset values, autocalibration is off there
+    furi_hal_subghz_load_registers(subghz_preset_ook_650khz);
+    subghz_frequency_analyzer_worker_build_plan(instance);
+    subghz_frequency_analyzer_worker_spectrum_reset(instance, NULL);
+
+    FrequencyRSSI period_peak = {.frequency = 0, .rssi = SUBGHZ_FREQUENCY_ANALYZER_RSSI_MIN};
+    int32_t channel = -1;
+    int32_t fine_peak = -1;
+    uint32_t sweeps = 0;
+    uint32_t rate_sweeps = 0;
+    uint32_t report_time = osKernelGetTickCount();
+    uint32_t rate_time = report_time;
 
     while(instance->worker_running) {
-        osDelay(10);
-        frequency_rssi.rssi = -127.0f;
-        furi_hal_subghz_idle();
-        furi_hal_subghz_load_registers(subghz_preset_ook_650khz);
-        for(size_t i = 0; i < subghz_frequencies_count; i++) {
-            if(furi_hal_subghz_is_frequency_valid(subghz_frequencies[i])) {
-                furi_hal_subghz_idle();
-                frequency = furi_hal_subghz_set_frequency(subghz_frequencies[i]);
-                furi_hal_subghz_rx();
-                osDelay(3);
-                rssi = furi_hal_subghz_get_rssi();
-                if(frequency_rssi.rssi < rssi) {
-                    frequency_rssi.rssi = rssi;
-                    frequency_rssi.frequency = frequency;
-                }
-            }
-        }
-
-        if(frequency_rssi.rssi > -90.0) {
-            //  -0.5 ... 433.92 ... +0.5
-            frequency_start = frequency_rssi.frequency - 250000;
-            //step 10KHz
-            frequency_rssi.rssi = -127.0;
-            furi_hal_subghz_idle();
-            furi_hal_subghz_load_registers(subghz_preset_ook_58khz);
-            for(uint32_t i = frequency_start; i < frequency_start + 500000; i += 10000) {
-                if(furi_hal_subghz_is_frequency_valid(i)) {
-                    furi_hal_subghz_idle();
-                    frequency = furi_hal_subghz_set_frequency(i);
-                    furi_hal_subghz_rx();
-                    osDelay(3);
-                    rssi = furi_hal_subghz_get_rssi();
-                    if(frequency_rssi.rssi < rssi) {
-                        frequency_rssi.rssi = rssi;
-                        frequency_rssi.frequency = frequency;
-                    }
-                }
+        bool full_sweep = (sweeps % SUBGHZ_FREQUENCY_ANALYZER_FULL_SWEEP_EVERY) == 0;
+
+        // Coarse channels: look for signal, or for a stronger one while tracking
+        if(channel < 0 || full_sweep) {
+            int32_t coarse_peak = subghz_frequency_analyzer_worker_sweep_coarse(instance);
+            if(coarse_peak >= 0 && coarse_peak != channel) {
+                channel = coarse_peak;
+                fine_peak = -1;
+                subghz_frequency_analyzer_worker_spectrum_reset(
+                    instance, &instance->plan[channel]);
             }
         }
 
-        if(frequency_rssi.rssi > -90.0) {
-            instance->count_repet = 20;
-            if(instance->filVal) {
-                frequency_rssi.frequency =
-                    subghz_frequency_analyzer_worker_expRunningAverageAdaptive(
-                        instance, frequency_rssi.frequency);
+        // Fine window: whole or only around last peak
+        if(channel >= 0) {
+            int32_t first = 0;
+            int32_t last = SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE - 1;
+            if(fine_peak >= 0 && !full_sweep) {
+                first = MAX(fine_peak - SUBGHZ_FREQUENCY_ANALYZER_TRACK_BINS, first);
+                last = MIN(fine_peak + SUBGHZ_FREQUENCY_ANALYZER_TRACK_BINS, last);
             }
-            if(instance->pair_callback)
-                instance->pair_callback(
-                    instance->context, frequency_rssi.frequency, frequency_rssi.rssi);
-
-        } else {
-            if(instance->count_repet > 0) {
-                instance->count_repet--;
+            int32_t peak = -1;
+            FrequencyRSSI frequency_rssi = subghz_frequency_analyzer_worker_sweep_fine(
+                instance, &instance->plan[channel], first, last, &peak);
+            if(frequency_rssi.rssi > SUBGHZ_FREQUENCY_ANALYZER_THRESHOLD) {
+                fine_peak = peak;
+                if(frequency_rssi.rssi > period_peak.rssi) period_peak = frequency_rssi;
             } else {
-                instance->filVal = 0;
-                if(instance->pair_callback) instance->pair_callback(instance->context, 0, 0);
+                fine_peak = -1;
+            }
+        }
+        sweeps++;
+
+        uint32_t now = osKernelGetTickCount();
+        if(now - report_time >= SUBGHZ_FREQUENCY_ANALYZER_REPORT_PERIOD) {
+            report_time = now;
+            if(!subghz_frequency_analyzer_worker_report(instance, period_peak)) {
+                channel = -1;
+                fine_peak = -1;
+                subghz_frequency_analyzer_worker_spectrum_reset(instance, NULL);
             }
+            subghz_frequency_analyzer_worker_spectrum_decay(instance);
+            period_peak.frequency = 0;
+            period_peak.rssi = SUBGHZ_FREQUENCY_ANALYZER_RSSI_MIN;
         }
+        if(now - rate_time >= 1000) {
+            instance->spectrum.sweeps_per_second =
+                (sweeps - rate_sweeps) * 1000 / (now - rate_time);
+            FURI_LOG_D(TAG, "%u sweeps/s", instance->spectrum.sweeps_per_second);
+            rate_sweeps = sweeps;
+            rate_time = now;
+        }
+
+        // Lower priority threads get their time between sweeps
+        osDelay(1);
     }
 
     //Stop CC1101
     furi_hal_subghz_idle();
     furi_hal_subghz_sleep();
+    free(instance->plan);
+    instance->plan = NULL;
 
     return 0;
 }
@@ -171,6 +362,16 @@ void subghz_frequency_analyzer_worker_set_pair_callback(
     instance->context = context;
 }
 
+void subghz_frequency_analyzer_worker_set_spectrum_callback(
+    SubGhzFrequencyAnalyzerWorker* instance,
+    SubGhzFrequencyAnalyzerWorkerSpectrumCallback callback,
+    void* context) {
+    furi_assert(instance);
+    furi_assert(context);
+    instance->spectrum_callback = callback;
+    instance->spectrum_context = context;
+}
+
 void subghz_frequency_analyzer_worker_start(SubGhzFrequencyAnalyzerWorker* instance) {
     furi_assert(instance);
     furi_assert(!instance->worker_running);
@@ -12,6 +12,20 @@ typedef struct {
     float rssi;
 } FrequencyRSSI;
 
+#define SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE 50
+
+/** Fine sweep window around detected signal */
+typedef struct {
+    uint32_t frequency_start; /**< First bin frequency, 0 if there is no signal */
+    uint32_t frequency_step; /**< Bin width */
+    float rssi[SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE]; /**< Peak hold with decay, dBm */
+    uint16_t sweeps_per_second; /**< Full plan passes per second */
+} SubGhzFrequencyAnalyzerSpectrum;
+
+typedef void (*SubGhzFrequencyAnalyzerWorkerSpectrumCallback)(
+    void* context,
+    const SubGhzFrequencyAnalyzerSpectrum* spectrum);
+
 /** Allocate SubGhzFrequencyAnalyzerWorker
  * 
  * @return SubGhzFrequencyAnalyzerWorker* 
@@ -35,6 +49,17 @@ void subghz_frequency_analyzer_worker_set_pair_callback(
     SubGhzFrequencyAnalyzerWorkerPairCallback callback,
     void* context);
 
+/** Spectrum callback SubGhzFrequencyAnalyzerWorker, called with pair callback
+ * 
+ * @param instance SubGhzFrequencyAnalyzerWorker instance
+ * @param callback SubGhzFrequencyAnalyzerWorkerSpectrumCallback callback
+ * @param context 
+ */
+void subghz_frequency_analyzer_worker_set_spectrum_callback(
+    SubGhzFrequencyAnalyzerWorker* instance,
+    SubGhzFrequencyAnalyzerWorkerSpectrumCallback callback,
+    void* context);
+
 /** Start SubGhzFrequencyAnalyzerWorker
  * 
  * @param instance SubGhzFrequencyAnalyzerWorker instance
@@ -273,14 +273,19 @@ bool subghz_scene_read_raw_on_event(void* context, SceneManagerEvent event) {
         }
     } else if(event.type == SceneManagerEventTypeTick) {
         switch(subghz->state_notifications) {
-        case SubGhzNotificationStateRX:
+        case SubGhzNotificationStateRX: {
             notification_message(subghz->notifications, &sequence_blink_blue_10);
             subghz_read_raw_update_sample_write(
                 subghz->subghz_read_raw,
                 subghz_protocol_raw_get_sample_write(
                     (SubGhzProtocolRAW*)subghz->txrx->protocol_result));
+            SubGhzProtocolRAWWriterStats writer_stats;
+            subghz_protocol_raw_get_writer_stats(
+                (SubGhzProtocolRAW*)subghz->txrx->protocol_result, &writer_stats);
+            subghz_read_raw_update_writer_stats(subghz->subghz_read_raw, &writer_stats);
             subghz_read_raw_add_data_rssi(subghz->subghz_read_raw, furi_hal_subghz_get_rssi());
             break;
+        }
         case SubGhzNotificationStateTX:
             notification_message(subghz->notifications, &sequence_blink_green_10);
             subghz_read_raw_update_sin(subghz->subghz_read_raw);
@@ -536,7 +536,22 @@ static void subghz_cli_command_chat(Cli* cli, string_t args) {
 
     if(subghz_chat_worker_is_running(subghz_chat)) {
         subghz_chat_worker_stop(subghz_chat);
+        SubGhzTxRxWorkerStats stats;
+        subghz_chat_worker_get_stats(subghz_chat, &stats);
         subghz_chat_worker_free(subghz_chat);
+        printf(
+            "\r\nTX: %lu messages, %lu packets\r\n"
+            "RX: %lu messages, %lu packets, %lu lost, %lu CRC errors, %lu FIFO overflows\r\n"
+            "Last RSSI: %.1fdBm LQI: %u\r\n",
+            stats.link.tx_messages,
+            stats.link.tx_frames,
+            stats.link.rx_messages,
+            stats.link.rx_frames,
+            stats.link.rx_lost,
+            stats.rx_crc_errors,
+            stats.rx_fifo_overflows,
+            stats.link.rssi,
+            stats.link.lqi);
     }
     printf("\r\nExit chat\r\n");
 }
@@ -22,9 +22,14 @@ struct SubghzFrequencyAnalyzer {
     void* context;
 };
 
+#define SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_X 14
+#define SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_Y 20
+#define SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_HEIGHT 10
+
 typedef struct {
     uint32_t frequency;
     float rssi;
+    uint8_t spectrum[SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE];
 } SubghzFrequencyAnalyzerModel;
 
 void subghz_frequency_analyzer_set_callback(
@@ -53,6 +58,20 @@ void subghz_frequency_analyzer_draw_rssi(Canvas* canvas, float rssi) {
     }
 }
 
+// Peak hold of fine sweep window, 2px per bin
+void subghz_frequency_analyzer_draw_spectrum(Canvas* canvas, const uint8_t* spectrum) {
+    for(size_t i = 0; i < SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE; i++) {
+        if(spectrum[i]) {
+            canvas_draw_line(
+                canvas,
+                SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_X + 2 * i,
+                SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_Y,
+                SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_X + 2 * i,
+                SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_Y - spectrum[i] + 1);
+        }
+    }
+}
+
 void subghz_frequency_analyzer_draw(Canvas* canvas, SubghzFrequencyAnalyzerModel* model) {
     char buffer[64];
 
@@ -62,6 +81,7 @@ void subghz_frequency_analyzer_draw(Canvas* canvas, SubghzFrequencyAnalyzerModel
 
     canvas_draw_str(canvas, 28, 60, "RSSI");
     subghz_frequency_analyzer_draw_rssi(canvas, model->rssi);
+    subghz_frequency_analyzer_draw_spectrum(canvas, model->spectrum);
 
     //Frequency
     canvas_set_font(canvas, FontBigNumbers);
@@ -96,6 +116,24 @@ void subghz_frequency_analyzer_pair_callback(void* context, uint32_t frequency,
         });
 }
 
+void subghz_frequency_analyzer_spectrum_callback(
+    void* context,
+    const SubGhzFrequencyAnalyzerSpectrum* spectrum) {
+    SubghzFrequencyAnalyzer* instance = context;
+    with_view_model(
+        instance->view, (SubghzFrequencyAnalyzerModel * model) {
+            for(size_t i = 0; i < SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_SIZE; i++) {
+                // -110dBm and below is empty, 4dB per pixel
+                float level = (spectrum->rssi[i] + 110.0f) / 4.0f;
+                model->spectrum[i] =
+                    spectrum->frequency_start ?
+                        CLAMP(level, SUBGHZ_FREQUENCY_ANALYZER_SPECTRUM_HEIGHT, 0.0f) :
+                        0;
+            }
+            return true;
+        });
+}
+
 void subghz_frequency_analyzer_enter(void* context) {
     furi_assert(context);
     SubghzFrequencyAnalyzer* instance = context;
@@ -108,12 +146,16 @@ void subghz_frequency_analyzer_enter(void* context) {
         (SubGhzFrequencyAnalyzerWorkerPairCallback)subghz_frequency_analyzer_pair_callback,
         instance);
 
+    subghz_frequency_analyzer_worker_set_spectrum_callback(
+        instance->worker, subghz_frequency_analyzer_spectrum_callback, instance);
+
     subghz_frequency_analyzer_worker_start(instance->worker);
 
     with_view_model(
         instance->view, (SubghzFrequencyAnalyzerModel * model) {
             model->rssi = 0;
             model->frequency = 0;
+            memset(model->spectrum, 0, sizeof(model->spectrum));
             return true;
         });
 }
@@ -141,7 +183,7 @@ SubghzFrequencyAnalyzer* subghz_frequency_analyzer_alloc() {
     // View allocation and configuration
     instance->view = view_alloc();
     view_allocate_model(
-        instance->view, ViewModelTypeLocking, sizeof(SubghzFrequencyAnalyzerModel));
+        instance->view, ViewModelTypeSnapshot, sizeof(SubghzFrequencyAnalyzerModel));
     view_set_context(instance->view, instance);
     view_set_draw_callback(instance->view, (ViewDrawCallback)subghz_frequency_analyzer_draw);
     view_set_input_callback(instance->view, subghz_frequency_analyzer_input);
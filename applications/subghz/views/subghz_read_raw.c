@@ -18,16 +18,20 @@ struct SubghzReadRAW {
     void* context;
 };
 
+#define SUBGHZ_READ_RAW_STATUSBAR_STR_SIZE 16
+
+// Snapshot model: plain data only, copied on each commit
 typedef struct {
-    string_t frequency_str;
-    string_t preset_str;
-    string_t sample_write;
-    string_t file_name;
-    uint8_t* rssi_history;
+    char frequency_str[SUBGHZ_READ_RAW_STATUSBAR_STR_SIZE];
+    char preset_str[SUBGHZ_READ_RAW_STATUSBAR_STR_SIZE];
+    char sample_write[SUBGHZ_READ_RAW_STATUSBAR_STR_SIZE];
+    char file_name[SUBGHZ_TEXT_STORE_SIZE + 1];
+    uint8_t rssi_history[SUBGHZ_READ_RAW_RSSI_HISTORY_SIZE + 1];
     bool rssi_history_end;
     uint8_t ind_write;
     uint8_t ind_sin;
     SubghzReadRAWStatus satus;
+    SubGhzProtocolRAWWriterStats writer_stats;
 } SubghzReadRAWModel;
 
 void subghz_read_raw_set_callback(
@@ -47,8 +51,8 @@ void subghz_read_raw_add_data_statusbar(
     furi_assert(instance);
     with_view_model(
         instance->view, (SubghzReadRAWModel * model) {
-            string_set(model->frequency_str, frequency_str);
-            string_set(model->preset_str, preset_str);
+            strlcpy(model->frequency_str, frequency_str, sizeof(model->frequency_str));
+            strlcpy(model->preset_str, preset_str, sizeof(model->preset_str));
             return true;
         });
 }
@@ -80,7 +84,20 @@ void subghz_read_raw_update_sample_write(SubghzReadRAW* instance, size_t sample)
 
     with_view_model(
         instance->view, (SubghzReadRAWModel * model) {
-            string_printf(model->sample_write, "%d spl.", sample);
+            snprintf(model->sample_write, sizeof(model->sample_write), "%d spl.", sample);
+            return false;
+        });
+}
+
+void subghz_read_raw_update_writer_stats(
+    SubghzReadRAW* instance,
+    const SubGhzProtocolRAWWriterStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+
+    with_view_model(
+        instance->view, (SubghzReadRAWModel * model) {
+            model->writer_stats = *stats;
             return false;
         });
 }
@@ -214,14 +231,32 @@ void subghz_read_raw_draw_rssi(Canvas* canvas, SubghzReadRAWModel* model) {
     }
 }
 
+static void subghz_read_raw_draw_writer_stats(Canvas* canvas, SubghzReadRAWModel* model) {
+    char buffer[16];
+    SubGhzProtocolRAWWriterStats* stats = &model->writer_stats;
+
+    // Buffers waiting for SD card and the longest wait
+    snprintf(
+        buffer,
+        sizeof(buffer),
+        "%u/%u %lums",
+        stats->buffers_in_flight,
+        stats->buffers_count,
+        stats->write_latency_max);
+    canvas_draw_str_aligned(canvas, 1, 63, AlignLeft, AlignBottom, buffer);
+    snprintf(
+        buffer, sizeof(buffer), "Ovr %lu", stats->overrun_cnt + stats->stream_overrun_cnt);
+    canvas_draw_str_aligned(canvas, 126, 63, AlignRight, AlignBottom, buffer);
+}
+
 void subghz_read_raw_draw(Canvas* canvas, SubghzReadRAWModel* model) {
     uint8_t graphics_mode = 1;
     canvas_set_color(canvas, ColorBlack);
     canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str(canvas, 5, 8, string_get_cstr(model->frequency_str));
-    canvas_draw_str(canvas, 40, 8, string_get_cstr(model->preset_str));
+    canvas_draw_str(canvas, 5, 8, model->frequency_str);
+    canvas_draw_str(canvas, 40, 8, model->preset_str);
     canvas_draw_str_aligned(
-        canvas, 126, 0, AlignRight, AlignTop, string_get_cstr(model->sample_write));
+        canvas, 126, 0, AlignRight, AlignTop, model->sample_write);
 
     canvas_draw_line(canvas, 0, 14, 115, 14);
     canvas_draw_line(canvas, 0, 48, 115, 48);
@@ -238,7 +273,7 @@ void subghz_read_raw_draw(Canvas* canvas, SubghzReadRAWModel* model) {
         elements_button_center(canvas, "Send");
         elements_button_right(canvas, "More");
         elements_text_box(
-            canvas, 4, 12, 110, 44, AlignCenter, AlignCenter, string_get_cstr(model->file_name));
+            canvas, 4, 12, 110, 44, AlignCenter, AlignCenter, model->file_name);
         break;
 
     case SubghzReadRAWStatusTX:
@@ -256,6 +291,7 @@ void subghz_read_raw_draw(Canvas* canvas, SubghzReadRAWModel* model) {
 
     default:
         elements_button_center(canvas, "Stop");
+        subghz_read_raw_draw_writer_stats(canvas, model);
         break;
     }
 
@@ -368,8 +404,8 @@ bool subghz_read_raw_input(InputEvent* event, void* context) {
                     model->satus = SubghzReadRAWStatusStart;
                     model->rssi_history_end = false;
                     model->ind_write = 0;
-                    string_set(model->sample_write, "0 spl.");
-                    string_reset(model->file_name);
+                    strlcpy(model->sample_write, "0 spl.", sizeof(model->sample_write));
+                    model->file_name[0] = '\0';
                     instance->callback(SubghzCustomEventViewReadRAWErase, instance->context);
                 }
                 return true;
@@ -395,6 +431,7 @@ bool subghz_read_raw_input(InputEvent* event, void* context) {
                     model->satus = SubghzReadRAWStatusREC;
                     model->ind_write = 0;
                     model->rssi_history_end = false;
+                    memset(&model->writer_stats, 0, sizeof(SubGhzProtocolRAWWriterStats));
                 } else if(model->satus == SubghzReadRAWStatusREC) {
                     //Stop
                     instance->callback(SubghzCustomEventViewReadRAWIDLE, instance->context);
@@ -419,8 +456,8 @@ void subghz_read_raw_set_status(
                 model->satus = SubghzReadRAWStatusStart;
                 model->rssi_history_end = false;
                 model->ind_write = 0;
-                string_reset(model->file_name);
-                string_set(model->sample_write, "0 spl.");
+                model->file_name[0] = '\0';
+                strlcpy(model->sample_write, "0 spl.", sizeof(model->sample_write));
                 return true;
             });
         break;
@@ -437,8 +474,8 @@ void subghz_read_raw_set_status(
                 model->satus = SubghzReadRAWStatusLoadKeyIDLE;
                 model->rssi_history_end = false;
                 model->ind_write = 0;
-                string_set(model->file_name, file_name);
-                string_set(model->sample_write, "RAW");
+                strlcpy(model->file_name, file_name, sizeof(model->file_name));
+                strlcpy(model->sample_write, "RAW", sizeof(model->sample_write));
                 return true;
             });
         break;
@@ -447,10 +484,10 @@ void subghz_read_raw_set_status(
             instance->view, (SubghzReadRAWModel * model) {
                 model->satus = SubghzReadRAWStatusLoadKeyIDLE;
                 if(!model->ind_write) {
-                    string_set(model->file_name, file_name);
-                    string_set(model->sample_write, "RAW");
+                    strlcpy(model->file_name, file_name, sizeof(model->file_name));
+                    strlcpy(model->sample_write, "RAW", sizeof(model->sample_write));
                 } else {
-                    string_reset(model->file_name);
+                    model->file_name[0] = '\0';
                 }
                 return true;
             });
@@ -488,7 +525,7 @@ SubghzReadRAW* subghz_read_raw_alloc() {
 
     // View allocation and configuration
     instance->view = view_alloc();
-    view_allocate_model(instance->view, ViewModelTypeLocking, sizeof(SubghzReadRAWModel));
+    view_allocate_model(instance->view, ViewModelTypeSnapshot, sizeof(SubghzReadRAWModel));
     view_set_context(instance->view, instance);
     view_set_draw_callback(instance->view, (ViewDrawCallback)subghz_read_raw_draw);
     view_set_input_callback(instance->view, subghz_read_raw_input);
@@ -497,11 +534,7 @@ SubghzReadRAW* subghz_read_raw_alloc() {
 
     with_view_model(
         instance->view, (SubghzReadRAWModel * model) {
-            string_init(model->frequency_str);
-            string_init(model->preset_str);
-            string_init(model->sample_write);
-            string_init(model->file_name);
-            model->rssi_history = malloc(SUBGHZ_READ_RAW_RSSI_HISTORY_SIZE * sizeof(uint8_t));
+            memset(model, 0, sizeof(SubghzReadRAWModel));
             return true;
         });
 
@@ -511,15 +544,6 @@ SubghzReadRAW* subghz_read_raw_alloc() {
 void subghz_read_raw_free(SubghzReadRAW* instance) {
     furi_assert(instance);
 
-    with_view_model(
-        instance->view, (SubghzReadRAWModel * model) {
-            string_clear(model->frequency_str);
-            string_clear(model->preset_str);
-            string_clear(model->sample_write);
-            string_clear(model->file_name);
-            free(model->rssi_history);
-            return true;
-        });
     view_free(instance->view);
     free(instance);
 }
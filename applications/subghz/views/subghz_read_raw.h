@@ -2,6 +2,7 @@
 
 #include <gui/view.h>
 #include "../helpers/subghz_custom_event.h"
+#include <lib/subghz/protocols/subghz_protocol_raw.h>
 
 typedef struct SubghzReadRAW SubghzReadRAW;
 
@@ -36,6 +37,10 @@ void subghz_read_raw_add_data_statusbar(
 
 void subghz_read_raw_update_sample_write(SubghzReadRAW* instance, size_t sample);
 
+void subghz_read_raw_update_writer_stats(
+    SubghzReadRAW* instance,
+    const SubGhzProtocolRAWWriterStats* stats);
+
 void subghz_read_raw_stop_send(SubghzReadRAW* instance);
 
 void subghz_read_raw_update_sin(SubghzReadRAW* instance);
@@ -0,0 +1,223 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_hal_usb_hid.h>
+#include <bad_usb/ducky_bytecode.h>
+#include "../minunit.h"
+
+#define TAG "DuckyBytecodeTest"
+
+typedef struct {
+    DuckyOp op;
+    uint32_t value;
+    const char* data;
+} DuckyTestInstruction;
+
+static const char ducky_test_payload[] = "REM Open terminal\n"
+                                         "DEFAULT_DELAY 20\n"
+                                         "  GUI r\n"
+                                         "DELAY 500\n"
+                                         "STRING cmd /k echo  Hello, World!\n"
+                                         "ENTER\n"
+                                         "\n"
+                                         "CTRL-ALT DELETE\n"
+                                         "REPEAT 3\n"
+                                         "\t\n"
+                                         "ALTCHAR 0169\n"
+                                         "ALTSTRING Hi\n"
+                                         "STRING \n"
+                                         "CTRL\n"
+                                         "F12";
+
+static const DuckyTestInstruction ducky_test_payload_code[] = {
+    {DuckyOpNop, 0, NULL},
+    {DuckyOpDefaultDelay, 20, NULL},
+    {DuckyOpKey, KEY_MOD_LEFT_GUI | KEY_R, NULL},
+    {DuckyOpDelay, 500, NULL},
+    {DuckyOpString, 0, "cmd /k echo  Hello, World!"},
+    {DuckyOpKey, KEY_ENTER, NULL},
+    {DuckyOpKey, KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_ALT | KEY_DELETE, NULL},
+    {DuckyOpRepeat, 3, NULL},
+    {DuckyOpNop, 0, NULL},
+    {DuckyOpAltChar, 0, "0169"},
+    {DuckyOpAltString, 0, "Hi"},
+    {DuckyOpString, 0, ""},
+    {DuckyOpKey, KEY_MOD_LEFT_CTRL, NULL},
+    {DuckyOpKey, KEY_F12, NULL},
+};
+
+static DuckyCompiler* ducky_test_compile(const char* script, size_t chunk_size) {
+    DuckyCompiler* compiler = ducky_compiler_alloc();
+    size_t len = strlen(script);
+    bool state = true;
+    for(size_t pos = 0; (pos < len) && (state); pos += chunk_size) {
+        size_t chunk_len = MIN(chunk_size, len - pos);
+        state = ducky_compiler_feed(compiler, (const uint8_t*)&script[pos], chunk_len);
+    }
+    if(state) ducky_compiler_finish(compiler);
+    return compiler;
+}
+
+static void ducky_test_check_code(
+    DuckyCompiler* compiler,
+    const DuckyTestInstruction* expected,
+    size_t expected_count) {
+    size_t code_size = 0;
+    const uint8_t* code = ducky_compiler_get_code(compiler, &code_size);
+    size_t pc = 0;
+
+    mu_assert_int_eq(0, ducky_compiler_get_error_line(compiler));
+    mu_assert_int_eq(expected_count, ducky_compiler_get_line_count(compiler));
+
+    for(size_t i = 0; i < expected_count; i++) {
+        DuckyInstruction instruction;
+        mu_check(pc < code_size);
+        pc = ducky_bytecode_decode(code, pc, &instruction);
+        mu_assert_int_eq(expected[i].op, instruction.op);
+        mu_assert_int_eq(expected[i].value, instruction.value);
+        if(expected[i].data) {
+            mu_assert_int_eq(strlen(expected[i].data), instruction.data_len);
+            mu_check(memcmp(expected[i].data, instruction.data, instruction.data_len) == 0);
+        } else {
+            mu_assert_int_eq(0, instruction.data_len);
+        }
+    }
+    mu_assert_int_eq(code_size, pc);
+}
+
+MU_TEST(ducky_bytecode_payload_test) {
+    // Line splits at any chunk boundary must not change the result
+    static const size_t chunk_sizes[] = {1, 2, 3, 7, 16, 128};
+    for(size_t i = 0; i < COUNT_OF(chunk_sizes); i++) {
+        DuckyCompiler* compiler = ducky_test_compile(ducky_test_payload, chunk_sizes[i]);
+        ducky_test_check_code(
+            compiler, ducky_test_payload_code, COUNT_OF(ducky_test_payload_code));
+        ducky_compiler_free(compiler);
+    }
+}
+
+MU_TEST(ducky_bytecode_keyword_test) {
+    // Every keyword must be reachable through the perfect hash table
+    static const struct {
+        const char* name;
+        uint16_t keycode;
+    } keys[] = {
+        {"CTRL-ALT", KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_ALT},
+        {"CTRL-SHIFT", KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_SHIFT},
+        {"ALT-SHIFT", KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_SHIFT},
+        {"ALT-GUI", KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_GUI},
+        {"CTRL", KEY_MOD_LEFT_CTRL},
+        {"CONTROL", KEY_MOD_LEFT_CTRL},
+        {"SHIFT", KEY_MOD_LEFT_SHIFT},
+        {"ALT", KEY_MOD_LEFT_ALT},
+        {"GUI", KEY_MOD_LEFT_GUI},
+        {"WINDOWS", KEY_MOD_LEFT_GUI},
+        {"DOWNARROW", KEY_DOWN_ARROW},
+        {"DOWN", KEY_DOWN_ARROW},
+        {"LEFTARROW", KEY_LEFT_ARROW},
+        {"LEFT", KEY_LEFT_ARROW},
+        {"RIGHTARROW", KEY_RIGHT_ARROW},
+        {"RIGHT", KEY_RIGHT_ARROW},
+        {"UPARROW", KEY_UP_ARROW},
+        {"UP", KEY_UP_ARROW},
+        {"ENTER", KEY_ENTER},
+        {"BREAK", KEY_PAUSE},
+        {"PAUSE", KEY_PAUSE},
+        {"CAPSLOCK", KEY_CAPS_LOCK},
+        {"DELETE", KEY_DELETE},
+        {"BACKSPACE", KEY_BACKSPACE},
+        {"END", KEY_END},
+        {"ESC", KEY_ESC},
+        {"ESCAPE", KEY_ESC},
+        {"HOME", KEY_HOME},
+        {"INSERT", KEY_INSERT},
+        {"NUMLOCK", KEY_NUM_LOCK},
+        {"PAGEUP", KEY_PAGE_UP},
+        {"PAGEDOWN", KEY_PAGE_DOWN},
+        {"PRINTSCREEN", KEY_PRINT},
+        {"SCROLLOCK", KEY_SCROLL_LOCK},
+        {"SPACE", KEY_SPACE},
+        {"TAB", KEY_TAB},
+        {"MENU", KEY_APPLICATION},
+        {"APP", KEY_APPLICATION},
+        {"F1", KEY_F1},
+        {"F2", KEY_F2},
+        {"F3", KEY_F3},
+        {"F4", KEY_F4},
+        {"F5", KEY_F5},
+        {"F6", KEY_F6},
+        {"F7", KEY_F7},
+        {"F8", KEY_F8},
+        {"F9", KEY_F9},
+        {"F10", KEY_F10},
+        {"F11", KEY_F11},
+        {"F12", KEY_F12},
+    };
+    for(size_t i = 0; i < COUNT_OF(keys); i++) {
+        DuckyCompiler* compiler = ducky_test_compile(keys[i].name, 128);
+        DuckyTestInstruction expected = {DuckyOpKey, keys[i].keycode, NULL};
+        ducky_test_check_code(compiler, &expected, 1);
+        ducky_compiler_free(compiler);
+    }
+
+    DuckyCompiler* compiler = ducky_test_compile(
+        "DELAY 1\nSTRING a\nDEFAULT_DELAY 2\nDEFAULTDELAY 3\nREPEAT 4\n"
+        "ALTCHAR 5\nALTSTRING b\nALTCODE c\nSTRING_DELAY 0\nSTRINGDELAY 10\n",
+        128);
+    static const DuckyTestInstruction commands[] = {
+        {DuckyOpDelay, 1, NULL},
+        {DuckyOpString, 0, "a"},
+        {DuckyOpDefaultDelay, 2, NULL},
+        {DuckyOpDefaultDelay, 3, NULL},
+        {DuckyOpRepeat, 4, NULL},
+        {DuckyOpAltChar, 0, "5"},
+        {DuckyOpAltString, 0, "b"},
+        {DuckyOpAltString, 0, "c"},
+        {DuckyOpStringDelay, 0, NULL},
+        {DuckyOpStringDelay, 10, NULL},
+    };
+    ducky_test_check_code(compiler, commands, COUNT_OF(commands));
+    ducky_compiler_free(compiler);
+}
+
+MU_TEST(ducky_bytecode_error_test) {
+    static const struct {
+        const char* script;
+        uint16_t error_line;
+    } scripts[] = {
+        {"STRING ok\nENTER\nUNKNOWN\nSTRING never\n", 3},
+        {"REPEAT 2\n", 1},
+        {"\nREM\nDELAY 0\n", 2},
+        {"DELAY\n", 1},
+        {"DELAY abc\n", 1},
+        {"STRING\n", 1},
+        {"ALTCHAR 12a\n", 1},
+        {"REMARK is a comment too\r\nTAB\r\nENTERPRISE\r\n", 3},
+    };
+    for(size_t i = 0; i < COUNT_OF(scripts); i++) {
+        DuckyCompiler* compiler = ducky_test_compile(scripts[i].script, 5);
+        mu_assert_int_eq(scripts[i].error_line, ducky_compiler_get_error_line(compiler));
+        ducky_compiler_free(compiler);
+    }
+}
+
+MU_TEST(ducky_bytecode_size_test) {
+    // Per-line parsing is gone, check bytecode stays about as compact as the text
+    DuckyCompiler* compiler = ducky_test_compile(ducky_test_payload, 16);
+    size_t code_size = 0;
+    ducky_compiler_get_code(compiler, &code_size);
+    FURI_LOG_I(TAG, "Script %u bytes, bytecode %u bytes", strlen(ducky_test_payload), code_size);
+    mu_check(code_size < strlen(ducky_test_payload));
+    ducky_compiler_free(compiler);
+}
+
+MU_TEST_SUITE(ducky_bytecode_suite) {
+    MU_RUN_TEST(ducky_bytecode_payload_test);
+    MU_RUN_TEST(ducky_bytecode_keyword_test);
+    MU_RUN_TEST(ducky_bytecode_error_test);
+    MU_RUN_TEST(ducky_bytecode_size_test);
+}
+
+int run_minunit_test_ducky_bytecode() {
+    MU_RUN_SUITE(ducky_bytecode_suite);
+    return MU_EXIT_CODE;
+}
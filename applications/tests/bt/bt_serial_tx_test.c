@@ -0,0 +1,285 @@
+#include <furi.h>
+#include <bt/bt_service/bt_serial_tx.h>
+#include "../minunit.h"
+
+#define TAG "BtSerialTxTest"
+
+#define BT_SERIAL_TX_TEST_PACKET_SIZE_MAX (486)
+#define BT_SERIAL_TX_TEST_BUFFER_SIZE (BT_SERIAL_TX_TEST_PACKET_SIZE_MAX * 2)
+#define BT_SERIAL_TX_TEST_PACKET_SIZE (244)
+// 7.5ms connection interval, packets link layer sends in one connection event
+#define BT_SERIAL_TX_TEST_INTERVAL (8)
+#define BT_SERIAL_TX_TEST_EVENT_PACKETS (4)
+#define BT_SERIAL_TX_TEST_STREAM_SIZE (8 * 1024)
+#define BT_SERIAL_TX_TEST_FRAMES_MAX (BT_SERIAL_TX_TEST_STREAM_SIZE / 16)
+#define BT_SERIAL_TX_TEST_QUEUE_MAX (16)
+
+// Simulated Serial service: stack TX buffers are credits
+typedef struct {
+    uint32_t now;
+    bool indicate;
+    uint8_t credits;
+    // Packets in stack buffers, waiting for connection event
+    uint16_t queue[BT_SERIAL_TX_TEST_QUEUE_MAX];
+    size_t queue_count;
+    bool confirm_pending;
+    bool busy_reported;
+    // Client side
+    uint8_t* received;
+    size_t received_size;
+    size_t packets;
+    BtSerialTx* tx;
+} BtSerialTxTestLink;
+
+static BtSerialTxStatus bt_serial_tx_test_callback(uint8_t* data, uint16_t size, void* context) {
+    BtSerialTxTestLink* link = context;
+    furi_check(size <= BT_SERIAL_TX_TEST_PACKET_SIZE);
+    // Next indication before confirmation is a protocol error
+    furi_check(!link->indicate || (link->queue_count == 0 && !link->confirm_pending));
+    if(link->queue_count >= link->credits) {
+        link->busy_reported = true;
+        return BtSerialTxStatusBusy;
+    }
+    // Payload is stored right away, order is checked on client side
+    memcpy(&link->received[link->received_size], data, size);
+    link->received_size += size;
+    link->queue[link->queue_count++] = size;
+    return BtSerialTxStatusOk;
+}
+
+static void bt_serial_tx_test_sent(BtSerialTxTestLink* link) {
+    bt_serial_tx_sent(link->tx);
+    bt_serial_tx_process(link->tx, link->now);
+}
+
+static void bt_serial_tx_test_connection_event(BtSerialTxTestLink* link) {
+    if(link->indicate) {
+        // Confirmation comes in the event after indication
+        if(link->confirm_pending) {
+            link->confirm_pending = false;
+            bt_serial_tx_test_sent(link);
+        } else if(link->queue_count) {
+            link->queue_count = 0;
+            link->packets++;
+            link->confirm_pending = true;
+        }
+    } else {
+        size_t sent = MIN(link->queue_count, BT_SERIAL_TX_TEST_EVENT_PACKETS);
+        memmove(link->queue, &link->queue[sent], (link->queue_count - sent) * sizeof(uint16_t));
+        link->queue_count -= sent;
+        link->packets += sent;
+        if(sent && link->busy_reported) {
+            link->busy_reported = false;
+            bt_serial_tx_test_sent(link);
+        }
+    }
+}
+
+static void bt_serial_tx_test_link_init(
+    BtSerialTxTestLink* link,
+    BtSerialTx* tx,
+    bool indicate,
+    uint8_t credits,
+    uint8_t* received) {
+    memset(link, 0, sizeof(BtSerialTxTestLink));
+    link->indicate = indicate;
+    link->credits = indicate ? 1 : credits;
+    link->received = received;
+    link->tx = tx;
+    bt_serial_tx_reset(tx);
+    bt_serial_tx_set_window(tx, indicate ? 1 : BT_SERIAL_TX_WINDOW_UNLIMITED);
+}
+
+// RPC thread writes frames and blocks while TX buffer is full, link runs on tick timer
+static void bt_serial_tx_test_run(
+    BtSerialTxTestLink* link,
+    const uint8_t* stream,
+    const size_t* frames,
+    size_t frames_count) {
+    size_t frame = 0;
+    size_t frame_written = 0;
+    size_t offset = 0;
+
+    while(true) {
+        if(link->now % BT_SERIAL_TX_TEST_INTERVAL == 0) {
+            bt_serial_tx_test_connection_event(link);
+        }
+
+        while(frame < frames_count) {
+            size_t written = bt_serial_tx_write(
+                link->tx, &stream[offset + frame_written], frames[frame] - frame_written);
+            bt_serial_tx_process(link->tx, link->now);
+            frame_written += written;
+            if(frame_written < frames[frame]) break;
+            offset += frames[frame];
+            frame++;
+            frame_written = 0;
+        }
+
+        bool idle = (frame == frames_count) && (bt_serial_tx_get_pending(link->tx) == 0) &&
+                    (bt_serial_tx_get_in_flight(link->tx) == 0) && (link->queue_count == 0) &&
+                    !link->confirm_pending;
+        if(idle) break;
+        link->now++;
+        furi_check(link->now < 1000000);
+    }
+}
+
+static uint8_t* bt_serial_tx_test_stream_alloc() {
+    uint8_t* stream = malloc(BT_SERIAL_TX_TEST_STREAM_SIZE);
+    for(size_t i = 0; i < BT_SERIAL_TX_TEST_STREAM_SIZE; i++) {
+        stream[i] = (i * 7 + (i >> 8)) & 0xFF;
+    }
+    return stream;
+}
+
+// Split stream in RPC like frames: small responses and chunks of file data
+static size_t bt_serial_tx_test_frames(size_t* frames, size_t frames_max, size_t small_size) {
+    size_t count = 0;
+    size_t total = 0;
+    while(total < BT_SERIAL_TX_TEST_STREAM_SIZE) {
+        furi_check(count < frames_max);
+        size_t size = (count % 4 == 3) ? 512 : small_size;
+        size = MIN(size, BT_SERIAL_TX_TEST_STREAM_SIZE - total);
+        frames[count++] = size;
+        total += size;
+    }
+    return count;
+}
+
+static uint32_t bt_serial_tx_test_bytes_per_sec(BtSerialTxStats* stats) {
+    furi_check(stats->active_ticks);
+    return (uint64_t)stats->bytes * osKernelGetTickFreq() / stats->active_ticks;
+}
+
+MU_TEST(bt_serial_tx_stream_test) {
+    uint8_t* stream = bt_serial_tx_test_stream_alloc();
+    uint8_t* received = malloc(BT_SERIAL_TX_TEST_STREAM_SIZE);
+    size_t* frames = malloc(BT_SERIAL_TX_TEST_FRAMES_MAX * sizeof(size_t));
+    size_t frames_count = bt_serial_tx_test_frames(frames, BT_SERIAL_TX_TEST_FRAMES_MAX, 13);
+    BtSerialTxTestLink link;
+
+    // Same bytes in the same order whatever the window
+    const uint8_t credits[] = {0, 1, 2, 6};
+    for(size_t i = 0; i < COUNT_OF(credits); i++) {
+        bool indicate = (credits[i] == 0);
+        BtSerialTx* tx = bt_serial_tx_alloc(
+            BT_SERIAL_TX_TEST_BUFFER_SIZE,
+            BT_SERIAL_TX_TEST_PACKET_SIZE_MAX,
+            bt_serial_tx_test_callback,
+            &link);
+        bt_serial_tx_set_packet_size(tx, BT_SERIAL_TX_TEST_PACKET_SIZE);
+        bt_serial_tx_test_link_init(&link, tx, indicate, credits[i], received);
+        bt_serial_tx_test_run(&link, stream, frames, frames_count);
+
+        BtSerialTxStats stats;
+        bt_serial_tx_get_stats(tx, &stats);
+        mu_assert_int_eq(BT_SERIAL_TX_TEST_STREAM_SIZE, link.received_size);
+        mu_assert_int_eq(0, memcmp(stream, received, BT_SERIAL_TX_TEST_STREAM_SIZE));
+        mu_assert_int_eq(BT_SERIAL_TX_TEST_STREAM_SIZE, stats.bytes);
+        mu_assert_int_eq(link.packets, stats.packets);
+        mu_assert_int_eq(0, stats.errors);
+        bt_serial_tx_free(tx);
+    }
+
+    free(frames);
+    free(received);
+    free(stream);
+}
+
+MU_TEST(bt_serial_tx_coalesce_test) {
+    uint8_t* stream = bt_serial_tx_test_stream_alloc();
+    uint8_t* received = malloc(BT_SERIAL_TX_TEST_STREAM_SIZE);
+    const size_t frames_count = BT_SERIAL_TX_TEST_FRAMES_MAX;
+    size_t* frames = malloc(frames_count * sizeof(size_t));
+    for(size_t i = 0; i < frames_count; i++) {
+        frames[i] = 16;
+    }
+    BtSerialTxTestLink link;
+    BtSerialTx* tx = bt_serial_tx_alloc(
+        BT_SERIAL_TX_TEST_BUFFER_SIZE,
+        BT_SERIAL_TX_TEST_PACKET_SIZE_MAX,
+        bt_serial_tx_test_callback,
+        &link);
+    bt_serial_tx_set_packet_size(tx, BT_SERIAL_TX_TEST_PACKET_SIZE);
+
+    // Small frames written while indication is in flight go out in full packets
+    bt_serial_tx_test_link_init(&link, tx, true, 1, received);
+    bt_serial_tx_test_run(&link, stream, frames, frames_count);
+
+    BtSerialTxStats stats;
+    bt_serial_tx_get_stats(tx, &stats);
+    FURI_LOG_I(
+        TAG,
+        "Coalesce: %u frames in %lu packets, %lu B/s",
+        frames_count,
+        stats.packets,
+        bt_serial_tx_test_bytes_per_sec(&stats));
+    mu_assert_int_eq(0, memcmp(stream, received, BT_SERIAL_TX_TEST_STREAM_SIZE));
+    mu_check(stats.packets * 10 < frames_count);
+
+    bt_serial_tx_free(tx);
+    free(frames);
+    free(received);
+    free(stream);
+}
+
+MU_TEST(bt_serial_tx_window_test) {
+    uint8_t* stream = bt_serial_tx_test_stream_alloc();
+    uint8_t* received = malloc(BT_SERIAL_TX_TEST_STREAM_SIZE);
+    const size_t frames_count = BT_SERIAL_TX_TEST_STREAM_SIZE / 512;
+    size_t* frames = malloc(frames_count * sizeof(size_t));
+    for(size_t i = 0; i < frames_count; i++) {
+        frames[i] = 512;
+    }
+    BtSerialTxTestLink link;
+    BtSerialTx* tx = bt_serial_tx_alloc(
+        BT_SERIAL_TX_TEST_BUFFER_SIZE,
+        BT_SERIAL_TX_TEST_PACKET_SIZE_MAX,
+        bt_serial_tx_test_callback,
+        &link);
+    bt_serial_tx_set_packet_size(tx, BT_SERIAL_TX_TEST_PACKET_SIZE);
+    BtSerialTxStats stats;
+
+    // Bulk transfer: one indication per two connection events, as before
+    bt_serial_tx_test_link_init(&link, tx, true, 1, received);
+    bt_serial_tx_test_run(&link, stream, frames, frames_count);
+    bt_serial_tx_get_stats(tx, &stats);
+    uint32_t single_rate = bt_serial_tx_test_bytes_per_sec(&stats);
+    uint32_t single_stalls = stats.stalls;
+
+    // Notifications up to stack TX buffers
+    bt_serial_tx_test_link_init(&link, tx, false, 6, received);
+    bt_serial_tx_test_run(&link, stream, frames, frames_count);
+    bt_serial_tx_get_stats(tx, &stats);
+    uint32_t window_rate = bt_serial_tx_test_bytes_per_sec(&stats);
+    mu_assert_int_eq(0, memcmp(stream, received, BT_SERIAL_TX_TEST_STREAM_SIZE));
+
+    FURI_LOG_I(
+        TAG,
+        "Single: %lu B/s, %lu stalls. Window: %lu B/s, %lu stalls, %lu busy, %lu ms stalled",
+        single_rate,
+        single_stalls,
+        window_rate,
+        stats.stalls,
+        stats.busy,
+        stats.stall_ticks * 1000 / osKernelGetTickFreq());
+    mu_check(window_rate > single_rate * 4);
+    mu_check(stats.busy > 0);
+
+    bt_serial_tx_free(tx);
+    free(frames);
+    free(received);
+    free(stream);
+}
+
+MU_TEST_SUITE(bt_serial_tx_suite) {
+    MU_RUN_TEST(bt_serial_tx_stream_test);
+    MU_RUN_TEST(bt_serial_tx_coalesce_test);
+    MU_RUN_TEST(bt_serial_tx_window_test);
+}
+
+int run_minunit_test_bt_serial_tx() {
+    MU_RUN_SUITE(bt_serial_tx_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,251 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <flipper_format/flipper_format.h>
+#include <toolbox/stream/stream.h>
+#include "../minunit.h"
+
+#define TAG "FlipperFormatArenaTest"
+
+#define FLIPPER_FORMAT_ARENA_TEST_SIGNALS (64)
+
+static const char* test_data = "Filetype: Arena test\n"
+                               "Version: 1\n"
+                               "Name: Some name\n"
+                               "Protocol: NEC\n"
+                               "Count: 3 14 15\n"
+                               "Ratio: 0.33\n"
+                               "Key: DE AD BE EF\n"
+                               "Long: 0123456789ABCDEF0123456789ABCDEF\n";
+
+MU_TEST(flipper_format_arena_view_test) {
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    stream_write_cstring(stream, test_data);
+
+    char arena[32];
+    const char* name = NULL;
+    const char* protocol = NULL;
+    const char* missing = NULL;
+    uint32_t count[3];
+    uint32_t value_count = 0;
+    float ratio = 0;
+    uint8_t key[4];
+    const uint8_t expected_key[] = {0xDE, 0xAD, 0xBE, 0xEF};
+
+    flipper_format_set_string_arena(flipper_format, arena, sizeof(arena));
+    mu_check(flipper_format_rewind(flipper_format));
+
+    // Views stay valid until arena reset
+    mu_check(flipper_format_read_string_view(flipper_format, "Name", &name));
+    mu_check(flipper_format_read_string_view(flipper_format, "Protocol", &protocol));
+    mu_assert_string_eq("Some name", name);
+    mu_assert_string_eq("NEC", protocol);
+    mu_check(!flipper_format_read_string_view(flipper_format, "Missing", &missing));
+    mu_check(missing == NULL);
+    mu_check(!flipper_format_string_view_skipped(flipper_format));
+
+    mu_check(flipper_format_rewind(flipper_format));
+    mu_check(flipper_format_get_value_count(flipper_format, "Count", &value_count));
+    mu_assert_int_eq(3, value_count);
+    mu_check(flipper_format_read_uint32(flipper_format, "Count", count, COUNT_OF(count)));
+    mu_assert_int_eq(3, count[0]);
+    mu_assert_int_eq(14, count[1]);
+    mu_assert_int_eq(15, count[2]);
+    mu_check(flipper_format_read_float(flipper_format, "Ratio", &ratio, 1));
+    mu_check(ratio > 0.32f && ratio < 0.34f);
+    mu_check(flipper_format_read_hex(flipper_format, "Key", key, sizeof(key)));
+    mu_check(memcmp(expected_key, key, sizeof(key)) == 0);
+
+    // Arena is full: read fails, older views are intact
+    mu_check(!flipper_format_read_string_view(flipper_format, "Long", &missing));
+    mu_check(flipper_format_string_view_skipped(flipper_format));
+    mu_assert_string_eq("Some name", name);
+
+    flipper_format_reset_string_arena(flipper_format);
+    mu_check(flipper_format_rewind(flipper_format));
+    mu_check(flipper_format_read_string_view(flipper_format, "Protocol", &protocol));
+    mu_assert_string_eq("NEC", protocol);
+    mu_check(arena == protocol);
+
+    flipper_format_set_string_arena(flipper_format, NULL, 0);
+    flipper_format_free(flipper_format);
+}
+
+MU_TEST(flipper_format_arena_skip_test) {
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    stream_write_cstring(
+        stream,
+        "name: First
+type: parsed
+"
+        "name: This name is much longer than the whole arena
+type: raw
+"
+        "name: Last
+type: parsed
+");
+
+    char arena[16];
+    const char* name = NULL;
+    const char* type = NULL;
+    flipper_format_set_string_arena(flipper_format, arena, sizeof(arena));
+    mu_check(flipper_format_rewind(flipper_format));
+
+    mu_check(flipper_format_read_string_view(flipper_format, "name", &name));
+    mu_assert_string_eq("First", name);
+    flipper_format_reset_string_arena(flipper_format);
+
+    // Too long value is skipped as a whole, scan goes on with the next record
+    mu_check(!flipper_format_read_string_view(flipper_format, "name", &name));
+    mu_check(flipper_format_string_view_skipped(flipper_format));
+    mu_check(flipper_format_read_string_view(flipper_format, "type", &type));
+    mu_assert_string_eq("raw", type);
+    mu_check(flipper_format_read_string_view(flipper_format, "name", &name));
+    mu_assert_string_eq("Last", name);
+    mu_check(!flipper_format_string_view_skipped(flipper_format));
+
+    flipper_format_set_string_arena(flipper_format, NULL, 0);
+    flipper_format_free(flipper_format);
+}
+
+typedef struct {
+    FlipperFormat* flipper_format;
+    uint32_t string_allocs;
+    uint32_t string_cycles;
+    uint32_t string_signals;
+    uint32_t arena_allocs;
+    uint32_t arena_cycles;
+    uint32_t arena_signals;
+} FlipperFormatArenaBench;
+
+// Signal parsing as done by irda parser before and after arena
+static bool flipper_format_arena_test_read_string(FlipperFormat* flipper_format) {
+    bool result = false;
+    string_t name;
+    string_t type;
+    string_t protocol;
+    string_init(name);
+    string_init(type);
+    string_init(protocol);
+    uint32_t address = 0;
+
+    do {
+        if(!flipper_format_read_string(flipper_format, "name", name)) break;
+        if(!flipper_format_read_string(flipper_format, "type", type)) break;
+        if(string_cmp_str(type, "parsed")) break;
+        if(!flipper_format_read_string(flipper_format, "protocol", protocol)) break;
+        if(!flipper_format_read_hex(flipper_format, "address", (uint8_t*)&address, 4)) break;
+        result = true;
+    } while(0);
+
+    string_clear(protocol);
+    string_clear(type);
+    string_clear(name);
+    return result;
+}
+
+static bool flipper_format_arena_test_read_arena(FlipperFormat* flipper_format) {
+    bool result = false;
+    const char* name = NULL;
+    const char* type = NULL;
+    const char* protocol = NULL;
+    uint32_t address = 0;
+
+    do {
+        if(!flipper_format_read_string_view(flipper_format, "name", &name)) break;
+        if(!flipper_format_read_string_view(flipper_format, "type", &type)) break;
+        if(strcmp(type, "parsed")) break;
+        if(!flipper_format_read_string_view(flipper_format, "protocol", &protocol)) break;
+        if(!flipper_format_read_hex(flipper_format, "address", (uint8_t*)&address, 4)) break;
+        result = true;
+    } while(0);
+
+    flipper_format_reset_string_arena(flipper_format);
+    return result;
+}
+
+// Runs in heap traced thread, so every allocation is counted
+static int32_t flipper_format_arena_test_bench(void* context) {
+    FlipperFormatArenaBench* bench = context;
+    FlipperFormat* flipper_format = bench->flipper_format;
+    osThreadId_t thread_id = osThreadGetId();
+    char arena[64];
+
+    size_t allocs = memmgr_heap_get_thread_alloc_count(thread_id);
+    uint32_t cycles = DWT->CYCCNT;
+    flipper_format_rewind(flipper_format);
+    while(flipper_format_arena_test_read_string(flipper_format)) {
+        bench->string_signals++;
+    }
+    bench->string_cycles = DWT->CYCCNT - cycles;
+    bench->string_allocs = memmgr_heap_get_thread_alloc_count(thread_id) - allocs;
+
+    flipper_format_set_string_arena(flipper_format, arena, sizeof(arena));
+    allocs = memmgr_heap_get_thread_alloc_count(thread_id);
+    cycles = DWT->CYCCNT;
+    flipper_format_rewind(flipper_format);
+    while(flipper_format_arena_test_read_arena(flipper_format)) {
+        bench->arena_signals++;
+    }
+    bench->arena_cycles = DWT->CYCCNT - cycles;
+    bench->arena_allocs = memmgr_heap_get_thread_alloc_count(thread_id) - allocs;
+    flipper_format_set_string_arena(flipper_format, NULL, 0);
+
+    return 0;
+}
+
+MU_TEST(flipper_format_arena_bench_test) {
+    FlipperFormatArenaBench bench = {0};
+    bench.flipper_format = flipper_format_string_alloc();
+    Stream* stream = flipper_format_get_raw_stream(bench.flipper_format);
+
+    string_t line;
+    string_init(line);
+    for(size_t i = 0; i < FLIPPER_FORMAT_ARENA_TEST_SIGNALS; i++) {
+        string_printf(
+            line,
+            "#\nname: Button_%u\ntype: parsed\nprotocol: NECext\naddress: %02X 00 00 00\n"
+            "command: 08 00 00 00\n",
+            i,
+            i);
+        stream_write_string(stream, line);
+    }
+    string_clear(line);
+
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "FlipperFormatArenaBench");
+    furi_thread_set_stack_size(thread, 2048);
+    furi_thread_set_context(thread, &bench);
+    furi_thread_set_callback(thread, flipper_format_arena_test_bench);
+    furi_thread_enable_heap_trace(thread);
+    furi_thread_start(thread);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    flipper_format_free(bench.flipper_format);
+
+    FURI_LOG_I(
+        TAG,
+        "%lu signals. String: %lu allocs, %lu cycles. Arena: %lu allocs, %lu cycles",
+        bench.string_signals,
+        bench.string_allocs,
+        bench.string_cycles,
+        bench.arena_allocs,
+        bench.arena_cycles);
+
+    mu_assert_int_eq(FLIPPER_FORMAT_ARENA_TEST_SIGNALS, bench.string_signals);
+    mu_assert_int_eq(FLIPPER_FORMAT_ARENA_TEST_SIGNALS, bench.arena_signals);
+    mu_check(bench.string_allocs >= FLIPPER_FORMAT_ARENA_TEST_SIGNALS);
+    mu_assert_int_eq(0, bench.arena_allocs);
+}
+
+MU_TEST_SUITE(flipper_format_arena_suite) {
+    MU_RUN_TEST(flipper_format_arena_view_test);
+    MU_RUN_TEST(flipper_format_arena_skip_test);
+    MU_RUN_TEST(flipper_format_arena_bench_test);
+}
+
+int run_minunit_test_flipper_format_arena() {
+    MU_RUN_SUITE(flipper_format_arena_suite);
+    return MU_EXIT_CODE;
+}
@@ -42,4 +42,194 @@ void test_furi_pubsub() {
 
     // delete pubsub case
     furi_pubsub_free(test_pubsub);
-}
\ No newline at end of file
+}
+typedef struct {
+    FuriPubSub* pubsub;
+    FuriPubSubSubscription* self;
+    FuriPubSubSubscription* added;
+    uint32_t self_calls;
+    uint32_t added_calls;
+} PubSubReentrantTest;
+
+static void test_pubsub_added_handler(const void* arg, void* ctx) {
+    PubSubReentrantTest* test = ctx;
+    test->added_calls++;
+}
+
+// Unsubscribes itself and subscribes other handler from callback
+static void test_pubsub_reentrant_handler(const void* arg, void* ctx) {
+    PubSubReentrantTest* test = ctx;
+    test->self_calls++;
+    furi_pubsub_unsubscribe(test->pubsub, test->self);
+    test->added = furi_pubsub_subscribe(test->pubsub, test_pubsub_added_handler, test);
+}
+
+void test_furi_pubsub_reentrant() {
+    PubSubReentrantTest test = {0};
+    test.pubsub = furi_pubsub_alloc();
+    test.self = furi_pubsub_subscribe(test.pubsub, test_pubsub_reentrant_handler, &test);
+
+    // New subscriber gets messages starting from next publish
+    furi_pubsub_publish(test.pubsub, (void*)&notify_value_0);
+    mu_assert_int_eq(1, test.self_calls);
+    mu_assert_int_eq(0, test.added_calls);
+    furi_pubsub_publish(test.pubsub, (void*)&notify_value_1);
+    mu_assert_int_eq(1, test.self_calls);
+    mu_assert_int_eq(1, test.added_calls);
+
+    FuriPubSubStats stats;
+    furi_pubsub_get_stats(test.pubsub, &stats);
+    mu_assert_int_eq(1, stats.subscribers);
+    mu_assert_int_eq(2, stats.published);
+
+    furi_pubsub_unsubscribe(test.pubsub, test.added);
+    furi_pubsub_free(test.pubsub);
+}
+
+typedef struct {
+    FuriPubSub* pubsub;
+    FuriPubSubSubscription* subscription;
+    uint32_t calls;
+    volatile bool blocked;
+    volatile bool release;
+    volatile bool unsubscribed;
+} PubSubConcurrentTest;
+
+// First caller blocks, second caller unsubscribes while first is still inside
+static void test_pubsub_concurrent_handler(const void* arg, void* ctx) {
+    PubSubConcurrentTest* test = ctx;
+    if(test->calls++ == 0) {
+        test->blocked = true;
+        while(!test->release) osDelay(1);
+    } else {
+        furi_pubsub_unsubscribe(test->pubsub, test->subscription);
+        test->unsubscribed = true;
+    }
+}
+
+static int32_t test_pubsub_concurrent_thread(void* ctx) {
+    PubSubConcurrentTest* test = ctx;
+    furi_pubsub_publish(test->pubsub, (void*)&notify_value_0);
+    return 0;
+}
+
+static FuriThread* test_pubsub_concurrent_start(PubSubConcurrentTest* test) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "PubSubTest");
+    furi_thread_set_stack_size(thread, 1024);
+    furi_thread_set_context(thread, test);
+    furi_thread_set_callback(thread, test_pubsub_concurrent_thread);
+    furi_thread_start(thread);
+    return thread;
+}
+
+void test_furi_pubsub_concurrent() {
+    PubSubConcurrentTest test = {0};
+    test.pubsub = furi_pubsub_alloc();
+    test.subscription = furi_pubsub_subscribe(test.pubsub, test_pubsub_concurrent_handler, &test);
+
+    FuriThread* blocker = test_pubsub_concurrent_start(&test);
+    while(!test.blocked) osDelay(1);
+    FuriThread* unsubscriber = test_pubsub_concurrent_start(&test);
+
+    // Unsubscribe waits for callback running in other thread, but not for its own
+    osDelay(20);
+    mu_check(!test.unsubscribed);
+    test.release = true;
+    for(size_t i = 0; i < 100 && !test.unsubscribed; i++) osDelay(1);
+    mu_check(test.unsubscribed);
+    mu_assert_int_eq(2, test.calls);
+
+    if(test.unsubscribed) {
+        mu_assert_int_eq(osOK, furi_thread_join(unsubscriber));
+        mu_assert_int_eq(osOK, furi_thread_join(blocker));
+        furi_thread_free(unsubscriber);
+        furi_thread_free(blocker);
+        furi_pubsub_free(test.pubsub);
+    }
+}
+
+#define PUBSUB_ASYNC_TEST_MESSAGES (10)
+
+typedef struct {
+    uint32_t received[PUBSUB_ASYNC_TEST_MESSAGES];
+    uint32_t count;
+} PubSubAsyncTest;
+
+// Slow subscriber that would block publisher if called synchronously
+static void test_pubsub_async_handler(const void* arg, void* ctx) {
+    PubSubAsyncTest* test = ctx;
+    if(test->count < PUBSUB_ASYNC_TEST_MESSAGES) {
+        test->received[test->count++] = *(const uint32_t*)arg;
+    }
+    osDelay(5);
+}
+
+void test_furi_pubsub_async() {
+    FuriPubSub* pubsub = furi_pubsub_alloc();
+    PubSubAsyncTest drop_oldest = {0};
+    PubSubAsyncTest drop_newest = {0};
+    PubSubAsyncTest merge = {0};
+
+    FuriPubSubSubscription* drop_oldest_subscription = furi_pubsub_subscribe_async(
+        pubsub,
+        test_pubsub_async_handler,
+        &drop_oldest,
+        sizeof(uint32_t),
+        4,
+        FuriPubSubAsyncPolicyDropOldest);
+    FuriPubSubSubscription* drop_newest_subscription = furi_pubsub_subscribe_async(
+        pubsub,
+        test_pubsub_async_handler,
+        &drop_newest,
+        sizeof(uint32_t),
+        4,
+        FuriPubSubAsyncPolicyDropNewest);
+    FuriPubSubSubscription* merge_subscription = furi_pubsub_subscribe_async(
+        pubsub,
+        test_pubsub_async_handler,
+        &merge,
+        sizeof(uint32_t),
+        1,
+        FuriPubSubAsyncPolicyMerge);
+
+    // Message is copied, publisher may reuse it
+    uint32_t message = 0;
+    for(size_t i = 0; i < PUBSUB_ASYNC_TEST_MESSAGES; i++) {
+        message = i;
+        furi_pubsub_publish(pubsub, &message);
+    }
+    osDelay(200);
+
+    FuriPubSubStats stats;
+    furi_pubsub_get_stats(pubsub, &stats);
+    FURI_LOG_I(
+        "PubSubTest",
+        "Async: publish max %luus, latency max %luus, depth max %lu, dropped %lu, merged %lu",
+        stats.publish_time_max,
+        stats.async_latency_max,
+        stats.async_queue_depth_max,
+        stats.async_dropped,
+        stats.async_merged);
+    mu_assert_int_eq(
+        3 * PUBSUB_ASYNC_TEST_MESSAGES,
+        stats.async_delivered + stats.async_dropped + stats.async_merged);
+    mu_check(stats.async_queue_depth_max <= 4);
+    mu_check(stats.publish_time_max < 5000);
+
+    // Every subscription gets messages in order and the last state is not lost
+    mu_check(drop_oldest.count > 0);
+    mu_assert_int_eq(PUBSUB_ASYNC_TEST_MESSAGES - 1, drop_oldest.received[drop_oldest.count - 1]);
+    mu_check(drop_newest.count > 0);
+    mu_assert_int_eq(0, drop_newest.received[0]);
+    mu_check(merge.count > 0);
+    mu_assert_int_eq(PUBSUB_ASYNC_TEST_MESSAGES - 1, merge.received[merge.count - 1]);
+    for(size_t i = 1; i < drop_newest.count; i++) {
+        mu_check(drop_newest.received[i] > drop_newest.received[i - 1]);
+    }
+
+    furi_pubsub_unsubscribe(pubsub, drop_oldest_subscription);
+    furi_pubsub_unsubscribe(pubsub, drop_newest_subscription);
+    furi_pubsub_unsubscribe(pubsub, merge_subscription);
+    furi_pubsub_free(pubsub);
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include <furi_hal_delay.h>
+#include "minunit.h"
+
+#define TAG "ThreadProfilerTest"
+
+#define TEST_PROFILER_BUSY_MS (300)
+#define TEST_PROFILER_STACK_SIZE (1024)
+#define TEST_PROFILER_STACK_USED (256)
+
+typedef struct {
+    volatile bool busy_done;
+    volatile bool release;
+} TestProfilerContext;
+
+static int32_t test_profiler_busy_thread(void* context) {
+    TestProfilerContext* ctx = context;
+
+    // Dirty some stack
+    volatile uint8_t buffer[TEST_PROFILER_STACK_USED];
+    memset((uint8_t*)buffer, 0xA5, TEST_PROFILER_STACK_USED);
+
+    // Spin, letting equal priority threads in once per ms
+    uint32_t start = osKernelGetTickCount();
+    while(osKernelGetTickCount() - start < TEST_PROFILER_BUSY_MS) {
+        delay_us(1000);
+        osThreadYield();
+    }
+
+    ctx->busy_done = true;
+    while(!ctx->release) {
+        osDelay(1);
+    }
+    return buffer[0];
+}
+
+void test_furi_thread_profiler() {
+    TestProfilerContext ctx = {0};
+    FuriThreadProfilerSummary summary;
+    FuriThreadProfilerThread* threads =
+        malloc(sizeof(FuriThreadProfilerThread) * FURI_THREAD_PROFILER_THREADS_MAX);
+
+    FuriThreadProfiler* profiler = furi_thread_profiler_alloc(3);
+
+    // Single sample: no shares and rates yet
+    furi_thread_profiler_sample(profiler);
+    size_t count = furi_thread_profiler_get(
+        profiler, &summary, threads, FURI_THREAD_PROFILER_THREADS_MAX);
+    mu_check(count > 0);
+    mu_assert_int_eq(0, summary.last_ms);
+    mu_assert_int_eq(0, summary.window_ms);
+    mu_assert_int_eq(0, summary.switches);
+    for(size_t i = 0; i < count; i++) {
+        mu_assert_int_eq(0, threads[i].cpu_last);
+        mu_check(threads[i].stack_free <= threads[i].stack_size);
+    }
+
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "ProfilerBusy");
+    furi_thread_set_stack_size(thread, TEST_PROFILER_STACK_SIZE);
+    furi_thread_set_context(thread, &ctx);
+    furi_thread_set_callback(thread, test_profiler_busy_thread);
+    mu_check(furi_thread_start(thread));
+    while(!ctx.busy_done) {
+        osDelay(10);
+    }
+
+    furi_thread_profiler_sample(profiler);
+    count = furi_thread_profiler_get(
+        profiler, &summary, threads, FURI_THREAD_PROFILER_THREADS_MAX);
+    mu_check(summary.last_ms >= TEST_PROFILER_BUSY_MS);
+    mu_assert_int_eq(summary.last_ms, summary.window_ms);
+    mu_check(summary.switches > 0);
+    mu_check(summary.sample_cycles > 0);
+    mu_check(summary.sample_cycles <= summary.sample_cycles_max);
+    // Sampling must stay well under 10ms
+    mu_check(summary.sample_cycles_max < SystemCoreClock / 100);
+    FURI_LOG_I(
+        TAG,
+        "Sample: %lu cycles, %lu threads, overhead %u.%u%%",
+        summary.sample_cycles,
+        summary.threads,
+        summary.overhead_window / 10,
+        summary.overhead_window % 10);
+
+    FuriThreadProfilerThread* busy = NULL;
+    uint32_t cpu_total = summary.sleep_last;
+    for(size_t i = 0; i < count; i++) {
+        cpu_total += threads[i].cpu_last;
+        if(threads[i].id == furi_thread_get_thread_id(thread)) {
+            busy = &threads[i];
+        }
+    }
+    // Shares add up to whole wall time, give or take rounding and a tick of wall time
+    mu_check(cpu_total <= 1000 + 10);
+    mu_check(cpu_total + count + 10 >= 1000);
+
+    mu_assert_pointers_not_eq(busy, NULL);
+    mu_assert_string_eq("ProfilerBusy", busy->name);
+    mu_check(busy->cpu_last > 500);
+    mu_assert_int_eq(busy->cpu_last, busy->cpu_window);
+    mu_check(busy->switches > 0);
+    mu_assert_int_eq(TEST_PROFILER_STACK_SIZE, busy->stack_size);
+    mu_check(busy->stack_free < TEST_PROFILER_STACK_SIZE - TEST_PROFILER_STACK_USED);
+    mu_check(busy->stack_free > 0);
+
+    // Exited thread is gone from next sample
+    osThreadId_t busy_id = busy->id;
+    ctx.release = true;
+    mu_assert_int_eq(osOK, furi_thread_join(thread));
+    furi_thread_free(thread);
+    // Idle thread cleans up exited thread
+    osDelay(10);
+    furi_thread_profiler_sample(profiler);
+    count = furi_thread_profiler_get(
+        profiler, &summary, threads, FURI_THREAD_PROFILER_THREADS_MAX);
+    for(size_t i = 0; i < count; i++) {
+        mu_assert_pointers_not_eq(busy_id, threads[i].id);
+    }
+    mu_check(summary.window_ms > summary.last_ms);
+
+    furi_thread_profiler_free(profiler);
+    free(threads);
+}
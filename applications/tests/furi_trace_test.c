@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include <furi_hal.h>
+#include "minunit.h"
+
+#ifdef FURI_TRACE
+
+#define TAG "TraceTest"
+
+#define TEST_TRACE_RECORDS (16)
+#define TEST_TRACE_DUMP_SIZE (32 * 1024)
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+} TestTraceDump;
+
+static bool test_trace_dump_callback(const void* data, size_t size, void* context) {
+    TestTraceDump* dump = context;
+    if(dump->size + size > TEST_TRACE_DUMP_SIZE) return false;
+    memcpy(dump->data + dump->size, data, size);
+    dump->size += size;
+    return true;
+}
+
+void test_furi_trace() {
+    bool enabled = furi_trace_is_enabled();
+    uint32_t records;
+    uint32_t lost;
+
+    // Stopped ring takes nothing
+    furi_trace_set_enabled(false);
+    furi_trace_clear();
+    FURI_TRACE_INSTANT("test stopped", 0);
+    furi_trace_get_stats(&records, &lost);
+    mu_assert_int_eq(0, records);
+
+    // Interrupts and task switches may add records in between
+    furi_trace_set_enabled(true);
+    uint32_t start = DWT->CYCCNT;
+    for(size_t i = 0; i < TEST_TRACE_RECORDS; i++) {
+        FURI_TRACE_INSTANT("test instant", i);
+    }
+    uint32_t cycles = (DWT->CYCCNT - start) / TEST_TRACE_RECORDS;
+    furi_trace_set_enabled(false);
+    FURI_LOG_I(TAG, "Record: %lu cycles", cycles);
+    mu_check(cycles < 100);
+
+    size_t capacity = furi_trace_get_stats(&records, &lost);
+    mu_check(records >= TEST_TRACE_RECORDS);
+    mu_check(records <= capacity);
+    mu_assert_int_eq(0, lost);
+
+    TestTraceDump dump = {.data = malloc(TEST_TRACE_DUMP_SIZE), .size = 0};
+    mu_check(furi_trace_dump(test_trace_dump_callback, &dump));
+    mu_check(!furi_trace_is_enabled());
+
+    FuriTraceDumpHeader* header = (FuriTraceDumpHeader*)dump.data;
+    mu_assert_int_eq(FURI_TRACE_MAGIC, header->magic);
+    mu_assert_int_eq(FURI_TRACE_VERSION, header->version);
+    mu_assert_int_eq(sizeof(FuriTraceRecord), header->record_size);
+    mu_assert_int_eq(records, header->records);
+    mu_check(header->threads > 0);
+    mu_assert_int_eq(1, header->names);
+    size_t size = sizeof(FuriTraceDumpHeader) + header->records * sizeof(FuriTraceRecord) +
+                  header->threads * sizeof(FuriTraceDumpThread) +
+                  header->names * sizeof(FuriTraceDumpName);
+    mu_assert_int_eq(size, dump.size);
+
+    // Our records come oldest first with increasing values
+    FuriTraceRecord* record = (FuriTraceRecord*)(header + 1);
+    uint32_t value = 0;
+    for(size_t i = 0; i < header->records; i++) {
+        if(record[i].id != FuriTraceIdInstant) continue;
+        mu_assert_int_eq(value, record[i].arg1);
+        value++;
+    }
+    mu_assert_int_eq(TEST_TRACE_RECORDS, value);
+
+    FuriTraceDumpName* name = (FuriTraceDumpName*)(dump.data + dump.size) - 1;
+    mu_assert_string_eq("test instant", name->name);
+
+    free(dump.data);
+    furi_trace_clear();
+    furi_trace_set_enabled(enabled);
+}
+
+typedef struct {
+    osMutexId_t mutex;
+    osStatus_t timeout_status;
+    osStatus_t take_status;
+} TestTraceMutex;
+
+static int32_t test_trace_mutex_waiter(void* context) {
+    TestTraceMutex* test = context;
+    test->timeout_status = osMutexAcquire(test->mutex, 5);
+    test->take_status = osMutexAcquire(test->mutex, osWaitForever);
+    osMutexRelease(test->mutex);
+    return 0;
+}
+
+void test_furi_trace_mutex() {
+    bool enabled = furi_trace_is_enabled();
+    TestTraceMutex test = {.mutex = osMutexNew(NULL)};
+    mu_check(test.mutex);
+    mu_assert_int_eq(osOK, osMutexAcquire(test.mutex, osWaitForever));
+
+    furi_trace_set_enabled(false);
+    furi_trace_clear();
+    furi_trace_set_enabled(true);
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "TraceMutexWaiter");
+    furi_thread_set_stack_size(thread, 1024);
+    furi_thread_set_context(thread, &test);
+    furi_thread_set_callback(thread, test_trace_mutex_waiter);
+    furi_thread_start(thread);
+
+    // Waiter times out and blocks again, owner's own failed try is not a wait
+    delay(20);
+    mu_assert_int_eq(osErrorResource, osMutexAcquire(test.mutex, 0));
+    mu_assert_int_eq(osOK, osMutexRelease(test.mutex));
+    mu_assert_int_eq(osOK, furi_thread_join(thread));
+    furi_trace_set_enabled(false);
+    furi_thread_free(thread);
+    mu_assert_int_eq(osErrorTimeout, test.timeout_status);
+    mu_assert_int_eq(osOK, test.take_status);
+
+    TestTraceDump dump = {.data = malloc(TEST_TRACE_DUMP_SIZE), .size = 0};
+    mu_check(furi_trace_dump(test_trace_dump_callback, &dump));
+    FuriTraceDumpHeader* header = (FuriTraceDumpHeader*)dump.data;
+    mu_assert_int_eq(0, header->lost);
+    FuriTraceRecord* record = (FuriTraceRecord*)(header + 1);
+    size_t waits = 0;
+    size_t takes = 0;
+    size_t timeouts = 0;
+    for(size_t i = 0; i < header->records; i++) {
+        if(record[i].arg0 != (uint32_t)test.mutex) continue;
+        if(record[i].id == FuriTraceIdMutexWait) waits++;
+        if(record[i].id == FuriTraceIdMutexTake) takes++;
+        if(record[i].id == FuriTraceIdMutexTimeout) timeouts++;
+    }
+    mu_assert_int_eq(2, waits);
+    mu_assert_int_eq(1, timeouts);
+    mu_assert_int_eq(1, takes);
+
+    free(dump.data);
+    osMutexDelete(test.mutex);
+    furi_trace_clear();
+    furi_trace_set_enabled(enabled);
+}
+
+#endif
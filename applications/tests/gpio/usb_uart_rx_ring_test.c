@@ -0,0 +1,159 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <gpio/usb_uart_rx_ring.h>
+#include "../minunit.h"
+
+#define USB_UART_TEST_RING_SIZE (256)
+#define USB_UART_TEST_PKT_LEN (64)
+#define USB_UART_TEST_STREAM_SIZE (4096)
+
+// Loopback model: UART line feeds circular DMA, bridge worker drains packets to USB
+typedef struct {
+    uint8_t dma_buf[USB_UART_TEST_RING_SIZE];
+    size_t dma_pos;
+    UsbUartRxRing ring;
+
+    uint8_t usb_out[USB_UART_TEST_STREAM_SIZE];
+    size_t usb_out_len;
+    size_t usb_packets;
+    size_t usb_short_packets;
+} UsbUartTestLoopback;
+
+static UsbUartTestLoopback* usb_uart_test_loopback_alloc() {
+    UsbUartTestLoopback* loopback = malloc(sizeof(UsbUartTestLoopback));
+    memset(loopback, 0, sizeof(UsbUartTestLoopback));
+    usb_uart_rx_ring_init(&loopback->ring, loopback->dma_buf, USB_UART_TEST_RING_SIZE);
+    return loopback;
+}
+
+// DMA stores a byte, half and full transfer events report position like HAL does
+static void usb_uart_test_line_rx(UsbUartTestLoopback* loopback, uint8_t data) {
+    loopback->dma_buf[loopback->dma_pos] = data;
+    loopback->dma_pos = (loopback->dma_pos + 1) % USB_UART_TEST_RING_SIZE;
+    if(loopback->dma_pos == 0 || loopback->dma_pos == USB_UART_TEST_RING_SIZE / 2) {
+        usb_uart_rx_ring_update(&loopback->ring, loopback->dma_pos);
+    }
+}
+
+static void usb_uart_test_line_idle(UsbUartTestLoopback* loopback) {
+    usb_uart_rx_ring_update(&loopback->ring, loopback->dma_pos);
+}
+
+static void usb_uart_test_worker_run(UsbUartTestLoopback* loopback, bool flush) {
+    uint8_t packet[USB_UART_TEST_PKT_LEN];
+    size_t len;
+    while((len = usb_uart_rx_ring_read(&loopback->ring, packet, sizeof(packet), flush)) > 0) {
+        furi_check(loopback->usb_out_len + len <= USB_UART_TEST_STREAM_SIZE);
+        memcpy(&loopback->usb_out[loopback->usb_out_len], packet, len);
+        loopback->usb_out_len += len;
+        loopback->usb_packets++;
+        if(len < USB_UART_TEST_PKT_LEN) loopback->usb_short_packets++;
+    }
+}
+
+static uint8_t usb_uart_test_pattern(size_t i) {
+    return (uint8_t)(i * 7 + (i >> 8));
+}
+
+MU_TEST(usb_uart_rx_ring_stream_test) {
+    UsbUartTestLoopback* loopback = usb_uart_test_loopback_alloc();
+
+    // Bursts of odd lengths separated by idle line, worker keeps up
+    size_t sent = 0;
+    size_t burst = 1;
+    while(sent + burst <= USB_UART_TEST_STREAM_SIZE) {
+        for(size_t i = 0; i < burst; i++) {
+            usb_uart_test_line_rx(loopback, usb_uart_test_pattern(sent++));
+            // Worker wakes up on each DMA event and takes full packets only
+            usb_uart_test_worker_run(loopback, false);
+        }
+        usb_uart_test_line_idle(loopback);
+        usb_uart_test_worker_run(loopback, true);
+        burst = (burst * 3 + 5) % (USB_UART_TEST_RING_SIZE / 2);
+    }
+
+    mu_assert_int_eq(sent, loopback->usb_out_len);
+    for(size_t i = 0; i < sent; i++) {
+        if(loopback->usb_out[i] != usb_uart_test_pattern(i)) {
+            mu_fail("stream mismatch");
+            break;
+        }
+    }
+    mu_assert_int_eq(0, usb_uart_rx_ring_get_overrun(&loopback->ring));
+    mu_assert_int_eq(0, usb_uart_rx_ring_get_pending(&loopback->ring));
+    // Partial packets are sent only on idle line, at most one per burst
+    mu_check(loopback->usb_packets >= sent / USB_UART_TEST_PKT_LEN);
+    mu_check(loopback->usb_packets - loopback->usb_short_packets <= sent / USB_UART_TEST_PKT_LEN);
+
+    free(loopback);
+}
+
+MU_TEST(usb_uart_rx_ring_wrap_test) {
+    UsbUartTestLoopback* loopback = usb_uart_test_loopback_alloc();
+
+    // Packet boundary doesn't match ring boundary
+    for(size_t i = 0; i < 100; i++) {
+        usb_uart_test_line_rx(loopback, usb_uart_test_pattern(i));
+    }
+    usb_uart_test_line_idle(loopback);
+    usb_uart_test_worker_run(loopback, true);
+    for(size_t i = 100; i < 100 + USB_UART_TEST_RING_SIZE; i++) {
+        usb_uart_test_line_rx(loopback, usb_uart_test_pattern(i));
+    }
+    usb_uart_test_line_idle(loopback);
+    mu_assert_int_eq(USB_UART_TEST_RING_SIZE, usb_uart_rx_ring_get_pending(&loopback->ring));
+    usb_uart_test_worker_run(loopback, false);
+
+    mu_assert_int_eq(100 + USB_UART_TEST_RING_SIZE, loopback->usb_out_len);
+    for(size_t i = 0; i < loopback->usb_out_len; i++) {
+        if(loopback->usb_out[i] != usb_uart_test_pattern(i)) {
+            mu_fail("wrapped packet mismatch");
+            break;
+        }
+    }
+
+    free(loopback);
+}
+
+MU_TEST(usb_uart_rx_ring_overrun_test) {
+    UsbUartTestLoopback* loopback = usb_uart_test_loopback_alloc();
+
+    // USB is stalled while DMA goes more than a full turn
+    size_t lost = USB_UART_TEST_RING_SIZE + USB_UART_TEST_RING_SIZE / 2 + 10;
+    for(size_t i = 0; i < lost; i++) {
+        usb_uart_test_line_rx(loopback, usb_uart_test_pattern(i));
+    }
+    usb_uart_test_line_idle(loopback);
+    usb_uart_test_worker_run(loopback, true);
+    mu_assert_int_eq(0, loopback->usb_out_len);
+    mu_assert_int_eq(lost, usb_uart_rx_ring_get_overrun(&loopback->ring));
+
+    // Reception recovers on the next byte
+    usb_uart_test_line_rx(loopback, 0xA5);
+    usb_uart_test_line_idle(loopback);
+    usb_uart_test_worker_run(loopback, true);
+    mu_assert_int_eq(1, loopback->usb_out_len);
+    mu_assert_int_eq(0xA5, loopback->usb_out[0]);
+
+    // Host timeout drops pending data and counts it
+    for(size_t i = 0; i < 20; i++) {
+        usb_uart_test_line_rx(loopback, usb_uart_test_pattern(i));
+    }
+    usb_uart_test_line_idle(loopback);
+    mu_assert_int_eq(20, usb_uart_rx_ring_drop(&loopback->ring));
+    mu_assert_int_eq(lost + 20, usb_uart_rx_ring_get_overrun(&loopback->ring));
+    mu_assert_int_eq(0, usb_uart_rx_ring_get_pending(&loopback->ring));
+
+    free(loopback);
+}
+
+MU_TEST_SUITE(usb_uart_rx_ring_suite) {
+    MU_RUN_TEST(usb_uart_rx_ring_stream_test);
+    MU_RUN_TEST(usb_uart_rx_ring_wrap_test);
+    MU_RUN_TEST(usb_uart_rx_ring_overrun_test);
+}
+
+int run_minunit_test_usb_uart_rx_ring() {
+    MU_RUN_SUITE(usb_uart_rx_ring_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,205 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <gui/modules/text_box_layout.h>
+#include "../minunit.h"
+
+#define TAG "TextBoxLayoutTest"
+
+#define TEXT_BOX_TEST_WIDTH (140)
+#define TEXT_BOX_TEST_LINES_MAX (128)
+#define TEXT_BOX_TEST_LOG_SIZE (64 * 1024)
+
+// Proportional font model: narrow space and 'i', everything else is 5px
+static uint8_t text_box_test_glyph_width(char symbol, void* context) {
+    return (symbol == ' ' || symbol == 'i') ? 2 : 5;
+}
+
+static bool text_box_test_line_eq(TextBoxLayout* layout, size_t index, const char* expected) {
+    size_t length = 0;
+    const char* line = text_box_layout_get_line(layout, index, &length);
+    return (length == strlen(expected)) && (memcmp(line, expected, length) == 0);
+}
+
+// CLI style log: short and long lines, some wider than screen
+static char* text_box_test_log_alloc(size_t* lines_count) {
+    char* log = malloc(TEXT_BOX_TEST_LOG_SIZE + 1);
+    size_t size = 0;
+    *lines_count = 0;
+    while(true) {
+        char line[160];
+        int length = snprintf(line, sizeof(line), "Rx %05u: ", *lines_count);
+        for(size_t i = 0; i < (*lines_count * 7) % 40; i++) {
+            length += snprintf(&line[length], sizeof(line) - length, "%02X ", (i * 13) & 0xFF);
+        }
+        line[length++] = '\n';
+        if(size + length > TEXT_BOX_TEST_LOG_SIZE) break;
+        memcpy(&log[size], line, length);
+        size += length;
+        (*lines_count)++;
+    }
+    log[size] = '\0';
+    return log;
+}
+
+static bool text_box_test_tail_eq(TextBoxLayout* tail, TextBoxLayout* full) {
+    size_t tail_count = text_box_layout_get_lines_count(tail);
+    size_t full_count = text_box_layout_get_lines_count(full);
+    if(tail_count > full_count) return false;
+
+    for(size_t i = 0; i < tail_count; i++) {
+        size_t tail_length = 0;
+        size_t full_length = 0;
+        const char* tail_line = text_box_layout_get_line(tail, i, &tail_length);
+        const char* full_line =
+            text_box_layout_get_line(full, full_count - tail_count + i, &full_length);
+        if((tail_length != full_length) || memcmp(tail_line, full_line, tail_length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MU_TEST(text_box_layout_wrap_test) {
+    TextBoxLayout* layout = text_box_layout_alloc(8);
+
+    text_box_layout_set_text(layout, "hello world\nab\n\nmiii");
+    text_box_layout_update(layout, 0, 30, text_box_test_glyph_width, NULL);
+    mu_assert_int_eq(6, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 0, "hello"));
+    mu_check(text_box_test_line_eq(layout, 1, " worl"));
+    mu_check(text_box_test_line_eq(layout, 2, "d"));
+    mu_check(text_box_test_line_eq(layout, 3, "ab"));
+    mu_check(text_box_test_line_eq(layout, 4, ""));
+    mu_check(text_box_test_line_eq(layout, 5, "miii"));
+
+    // Append continues the last line
+    text_box_layout_append(layout, "i\nnext");
+    mu_assert_int_eq(7, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 5, "miiii"));
+    mu_check(text_box_test_line_eq(layout, 6, "next"));
+
+    // Width change wraps everything again
+    text_box_layout_update(layout, 0, 60, text_box_test_glyph_width, NULL);
+    mu_check(text_box_test_line_eq(layout, 0, "hello worl"));
+    mu_check(text_box_test_line_eq(layout, 1, "d"));
+
+    // Ring keeps the last lines only
+    text_box_layout_append(layout, "\n1\n2\n3\n4\n5");
+    mu_assert_int_eq(8, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 0, ""));
+    mu_check(text_box_test_line_eq(layout, 1, "miiii"));
+    mu_check(text_box_test_line_eq(layout, 7, "5"));
+
+    text_box_layout_reset(layout);
+    mu_assert_int_eq(1, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 0, ""));
+
+    text_box_layout_free(layout);
+}
+
+MU_TEST(text_box_layout_set_text_test) {
+    TextBoxLayout* layout = text_box_layout_alloc(4);
+
+    // Caller text keeps all lines
+    text_box_layout_set_text(layout, "1\n2\n3\n4\n5\n6");
+    text_box_layout_update(layout, 0, 30, text_box_test_glyph_width, NULL);
+    mu_assert_int_eq(6, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 0, "1"));
+    mu_check(text_box_test_line_eq(layout, 5, "6"));
+
+    text_box_layout_update(layout, 0, 60, text_box_test_glyph_width, NULL);
+    mu_assert_int_eq(6, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 0, "1"));
+
+    // Appended text is limited
+    text_box_layout_append(layout, "\n7");
+    mu_assert_int_eq(4, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 0, "4"));
+    mu_check(text_box_test_line_eq(layout, 3, "7"));
+
+    text_box_layout_reset(layout);
+    mu_assert_int_eq(1, text_box_layout_get_lines_count(layout));
+    text_box_layout_set_text(layout, "a\nb\nc\nd\ne");
+    text_box_layout_update(layout, 0, 60, text_box_test_glyph_width, NULL);
+    mu_assert_int_eq(5, text_box_layout_get_lines_count(layout));
+    mu_check(text_box_test_line_eq(layout, 0, "a"));
+    mu_check(text_box_test_line_eq(layout, 4, "e"));
+
+    text_box_layout_free(layout);
+}
+
+MU_TEST(text_box_layout_append_test) {
+    size_t log_lines = 0;
+    char* log = text_box_test_log_alloc(&log_lines);
+    size_t log_size = strlen(log);
+
+    // Reference: whole log wrapped at once
+    TextBoxLayout* full = text_box_layout_alloc(log_lines * 2);
+    text_box_layout_set_text(full, log);
+    uint32_t full_cycles = DWT->CYCCNT;
+    text_box_layout_update(full, 0, TEXT_BOX_TEST_WIDTH, text_box_test_glyph_width, NULL);
+    full_cycles = DWT->CYCCNT - full_cycles;
+
+    // Streaming: line by line, wrapped on each append
+    TextBoxLayout* stream = text_box_layout_alloc(TEXT_BOX_TEST_LINES_MAX);
+    text_box_layout_update(stream, 0, TEXT_BOX_TEST_WIDTH, text_box_test_glyph_width, NULL);
+    size_t appends = 0;
+    uint32_t stream_cycles = 0;
+    char* line = log;
+    while(*line) {
+        char* line_end = strchr(line, '\n') + 1;
+        char saved = *line_end;
+        *line_end = '\0';
+        uint32_t cycles = DWT->CYCCNT;
+        text_box_layout_append(stream, line);
+        text_box_layout_update(stream, 0, TEXT_BOX_TEST_WIDTH, text_box_test_glyph_width, NULL);
+        stream_cycles += DWT->CYCCNT - cycles;
+        *line_end = saved;
+        line = line_end;
+        appends++;
+    }
+    mu_assert_int_eq(TEXT_BOX_TEST_LINES_MAX, text_box_layout_get_lines_count(stream));
+    mu_check(text_box_test_tail_eq(stream, full));
+
+    // Unwrapped text is trimmed to ring size without changing the result
+    TextBoxLayout* late = text_box_layout_alloc(TEXT_BOX_TEST_LINES_MAX);
+    for(size_t i = 0; i < log_size; i += 1000) {
+        char chunk[1001];
+        size_t chunk_size = MIN(log_size - i, sizeof(chunk) - 1);
+        memcpy(chunk, &log[i], chunk_size);
+        chunk[chunk_size] = '\0';
+        text_box_layout_append(late, chunk);
+    }
+    text_box_layout_update(late, 0, TEXT_BOX_TEST_WIDTH, text_box_test_glyph_width, NULL);
+    mu_assert_int_eq(TEXT_BOX_TEST_LINES_MAX, text_box_layout_get_lines_count(late));
+    mu_check(text_box_test_tail_eq(late, full));
+
+    // Wrapping whole text on each append costs half of full wrap per append on average
+    uint64_t rewrap_cycles = (uint64_t)full_cycles * appends / 2;
+    FURI_LOG_I(
+        TAG,
+        "%u bytes, %u appends: incremental %lu cycles, full wrap %lu cycles, "
+        "%lu times faster",
+        log_size,
+        appends,
+        stream_cycles,
+        full_cycles,
+        (uint32_t)(rewrap_cycles / MAX(stream_cycles, 1UL)));
+    mu_check(stream_cycles * 10ULL < rewrap_cycles);
+
+    text_box_layout_free(late);
+    text_box_layout_free(stream);
+    text_box_layout_free(full);
+    free(log);
+}
+
+MU_TEST_SUITE(text_box_layout_suite) {
+    MU_RUN_TEST(text_box_layout_wrap_test);
+    MU_RUN_TEST(text_box_layout_set_text_test);
+    MU_RUN_TEST(text_box_layout_append_test);
+}
+
+int run_minunit_test_text_box_layout() {
+    MU_RUN_SUITE(text_box_layout_suite);
+    return MU_EXIT_CODE;
+}
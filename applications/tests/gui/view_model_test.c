@@ -0,0 +1,155 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <gui/view_i.h>
+#include "../minunit.h"
+
+#define TAG "ViewModelTest"
+
+#define VIEW_MODEL_TEST_WORDS (63)
+#define VIEW_MODEL_TEST_DRAW_US (200)
+#define VIEW_MODEL_TEST_BURST (8)
+#define VIEW_MODEL_TEST_BURSTS (200)
+
+typedef struct {
+    uint32_t seq;
+    uint32_t data[VIEW_MODEL_TEST_WORDS];
+} ViewModelTestModel;
+
+typedef struct {
+    View* view;
+
+    // Producer side
+    uint32_t commits;
+    uint32_t commit_cycles_max;
+    uint32_t commits_blocked;
+    volatile uint32_t updates;
+
+    // Draw side
+    uint32_t draws;
+    uint32_t drawn_seq;
+    uint32_t torn;
+    uint32_t reordered;
+} ViewModelTest;
+
+// Draw callback gets only model
+static ViewModelTest* view_model_test;
+
+static void view_model_test_update(View* view, void* context) {
+    ViewModelTest* test = context;
+    test->updates++;
+}
+
+// Draw takes time like real rendering, holding model lock for locking views
+static void view_model_test_draw(Canvas* canvas, void* _model) {
+    ViewModelTestModel* model = _model;
+    ViewModelTest* test = view_model_test;
+    uint32_t seq = model->seq;
+
+    delay_us(VIEW_MODEL_TEST_DRAW_US);
+    for(size_t i = 0; i < VIEW_MODEL_TEST_WORDS; i++) {
+        if(model->data[i] != seq) {
+            test->torn++;
+            break;
+        }
+    }
+    if(seq < test->drawn_seq) test->reordered++;
+    test->drawn_seq = seq;
+    test->draws++;
+}
+
+// Worker pushing data in bursts from higher priority thread
+static int32_t view_model_test_producer(void* context) {
+    ViewModelTest* test = context;
+    osThreadSetPriority(osThreadGetId(), osPriorityAboveNormal);
+    // Commit that waits for draw takes longer than one draw
+    const uint32_t blocked_cycles = VIEW_MODEL_TEST_DRAW_US * (SystemCoreClock / 1000000) / 2;
+
+    for(size_t burst = 0; burst < VIEW_MODEL_TEST_BURSTS; burst++) {
+        for(size_t i = 0; i < VIEW_MODEL_TEST_BURST; i++) {
+            uint32_t cycles = DWT->CYCCNT;
+            with_view_model(
+                test->view, (ViewModelTestModel * model) {
+                    model->seq++;
+                    for(size_t word = 0; word < VIEW_MODEL_TEST_WORDS; word++) {
+                        model->data[word] = model->seq;
+                    }
+                    return true;
+                });
+            cycles = DWT->CYCCNT - cycles;
+            test->commits++;
+            test->commit_cycles_max = MAX(test->commit_cycles_max, cycles);
+            if(cycles > blocked_cycles) test->commits_blocked++;
+        }
+        osDelay(1);
+    }
+
+    return 0;
+}
+
+static void view_model_test_run(ViewModelTest* test, ViewModelType type, const char* name) {
+    memset(test, 0, sizeof(ViewModelTest));
+    test->view = view_alloc();
+    view_allocate_model(test->view, type, sizeof(ViewModelTestModel));
+    view_set_draw_callback(test->view, view_model_test_draw);
+    view_set_update_callback(test->view, view_model_test_update);
+    view_set_update_callback_context(test->view, test);
+    view_model_test = test;
+
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "ViewModelTestProducer");
+    furi_thread_set_stack_size(thread, 1024);
+    furi_thread_set_context(thread, test);
+    furi_thread_set_callback(thread, view_model_test_producer);
+    furi_thread_start(thread);
+
+    // Gui thread draws whenever it gets time
+    while(furi_thread_get_state(thread) != FuriThreadStateStopped) {
+        view_draw(test->view, NULL);
+    }
+    view_draw(test->view, NULL);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+
+    FURI_LOG_I(
+        TAG,
+        "%s: %lu commits, %lu blocked by draw, max commit %lu cycles, %lu updates, %lu draws",
+        name,
+        test->commits,
+        test->commits_blocked,
+        test->commit_cycles_max,
+        test->updates,
+        test->draws);
+
+    view_free(test->view);
+}
+
+MU_TEST(view_model_snapshot_test) {
+    ViewModelTest* locking = malloc(sizeof(ViewModelTest));
+    ViewModelTest* snapshot = malloc(sizeof(ViewModelTest));
+
+    view_model_test_run(locking, ViewModelTypeLocking, "Locking");
+    view_model_test_run(snapshot, ViewModelTypeSnapshot, "Snapshot");
+
+    // Snapshot is consistent and ends with the last commit
+    mu_assert_int_eq(0, snapshot->torn);
+    mu_assert_int_eq(0, snapshot->reordered);
+    mu_assert_int_eq(snapshot->commits, snapshot->drawn_seq);
+
+    // Producer never waits for draw, redraw requests are coalesced
+    mu_assert_int_eq(0, snapshot->commits_blocked);
+    mu_check(snapshot->commit_cycles_max < locking->commit_cycles_max);
+    mu_check(snapshot->updates <= snapshot->draws);
+    mu_assert_int_eq(locking->commits, locking->updates);
+
+    free(snapshot);
+    free(locking);
+}
+
+MU_TEST_SUITE(view_model_suite) {
+    MU_RUN_TEST(view_model_snapshot_test);
+}
+
+int run_minunit_test_view_model() {
+    MU_RUN_SUITE(view_model_suite);
+    return MU_EXIT_CODE;
+}
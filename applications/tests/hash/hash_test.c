@@ -0,0 +1,214 @@
+#include <furi.h>
+#include <furi_hal_crc.h>
+#include <storage/storage.h>
+#include <lib/toolbox/hash.h>
+#include <lib/toolbox/crc32_calc.h>
+#include "../minunit.h"
+
+#define TAG "HashTest"
+
+#define HASH_TEST_FILE_PATH "/int/.unit_test.hash"
+#define HASH_TEST_DATA_SIZE (10000)
+#define HASH_TEST_BENCHMARK_SIZE (256 * 1024)
+
+typedef struct {
+    const char* message;
+    const char* digest[HashTypeCount];
+} HashTestVector;
+
+static const HashTestVector hash_test_vectors[] = {
+    {
+        .message = "",
+        .digest =
+            {
+                [HashTypeMd5] = "d41d8cd98f00b204e9800998ecf8427e",
+                [HashTypeSha1] = "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+                [HashTypeSha256] =
+                    "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+                [HashTypeCrc32] = "00000000",
+            },
+    },
+    {
+        .message = "abc",
+        .digest =
+            {
+                [HashTypeMd5] = "900150983cd24fb0d6963f7d28e17f72",
+                [HashTypeSha1] = "a9993e364706816aba3e25717850c26c9cd0d89d",
+                [HashTypeSha256] =
+                    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+                [HashTypeCrc32] = "352441c2",
+            },
+    },
+    {
+        .message = "The quick brown fox jumps over the lazy dog",
+        .digest =
+            {
+                [HashTypeMd5] = "9e107d9d372bb6826bd81d3542a419d6",
+                [HashTypeSha1] = "2fd4e1c67a2d28fced849ee1bb76e7391b93eb12",
+                [HashTypeSha256] =
+                    "d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592",
+                [HashTypeCrc32] = "414fa339",
+            },
+    },
+    {
+        // Padding takes second block
+        .message = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        .digest =
+            {
+                [HashTypeMd5] = "8215ef0796a20bcaaae116d3876c664a",
+                [HashTypeSha1] = "84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+                [HashTypeSha256] =
+                    "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+                [HashTypeCrc32] = "171a3f5f",
+            },
+    },
+};
+
+static void hash_test_finish_string(Hash* hash, char* string) {
+    uint8_t digest[HASH_SIZE_MAX];
+    size_t size = hash_finish(hash, digest);
+    hash_digest_to_string(digest, size, string);
+}
+
+static uint8_t* hash_test_data_alloc(size_t size) {
+    uint8_t* data = malloc(size);
+    uint32_t state = 0x12345678;
+    for(size_t i = 0; i < size; i++) {
+        state = state * 1103515245 + 12345;
+        data[i] = state >> 16;
+    }
+    return data;
+}
+
+MU_TEST(hash_vectors_test) {
+    char string[HASH_SIZE_MAX * 2 + 1];
+
+    for(size_t type = 0; type < HashTypeCount; type++) {
+        Hash* hash = hash_alloc(type);
+        for(size_t i = 0; i < COUNT_OF(hash_test_vectors); i++) {
+            const HashTestVector* vector = &hash_test_vectors[i];
+            size_t size = strlen(vector->message);
+
+            hash_reset(hash);
+            hash_update(hash, vector->message, size);
+            hash_test_finish_string(hash, string);
+            mu_assert_string_eq(vector->digest[type], string);
+
+            // Byte by byte
+            hash_reset(hash);
+            for(size_t j = 0; j < size; j++) {
+                hash_update(hash, &vector->message[j], 1);
+            }
+            hash_test_finish_string(hash, string);
+            mu_assert_string_eq(vector->digest[type], string);
+        }
+        hash_free(hash);
+    }
+}
+
+MU_TEST(hash_chunks_test) {
+    uint8_t* data = hash_test_data_alloc(HASH_TEST_DATA_SIZE);
+    char whole[HASH_SIZE_MAX * 2 + 1];
+    char chunked[HASH_SIZE_MAX * 2 + 1];
+    const size_t chunks[] = {1, 3, 63, 64, 65, 200, 511, 4096};
+
+    for(size_t type = 0; type < HashTypeCount; type++) {
+        Hash* hash = hash_alloc(type);
+        hash_update(hash, data, HASH_TEST_DATA_SIZE);
+        hash_test_finish_string(hash, whole);
+
+        // Unaligned chunks, CRC32 goes to CRC unit and software in turns
+        hash_reset(hash);
+        size_t offset = 0;
+        for(size_t i = 0; offset < HASH_TEST_DATA_SIZE; i++) {
+            size_t size = MIN(chunks[i % COUNT_OF(chunks)], HASH_TEST_DATA_SIZE - offset);
+            hash_update(hash, &data[offset], size);
+            offset += size;
+        }
+        hash_test_finish_string(hash, chunked);
+        mu_assert_string_eq(whole, chunked);
+        hash_free(hash);
+    }
+
+    for(size_t offset = 0; offset < 4; offset++) {
+        for(size_t size = 0; size < 16; size++) {
+            mu_assert_int_eq(
+                crc32_calc_buffer(0x5A5A5A5A, &data[offset], size),
+                furi_hal_crc32(0x5A5A5A5A, &data[offset], size));
+        }
+    }
+
+    free(data);
+}
+
+MU_TEST(hash_file_test) {
+    uint8_t* data = hash_test_data_alloc(HASH_TEST_DATA_SIZE);
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    char expected[HASH_SIZE_MAX * 2 + 1];
+    char string[HASH_SIZE_MAX * 2 + 1];
+
+    mu_check(storage_file_open(file, HASH_TEST_FILE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_assert_int_eq(HASH_TEST_DATA_SIZE, storage_file_write(file, data, HASH_TEST_DATA_SIZE));
+    storage_file_close(file);
+
+    for(size_t type = 0; type < HashTypeCount; type++) {
+        Hash* hash = hash_alloc(type);
+        hash_update(hash, data, HASH_TEST_DATA_SIZE);
+        hash_test_finish_string(hash, expected);
+
+        hash_reset(hash);
+        mu_check(storage_file_open(file, HASH_TEST_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING));
+        mu_check(hash_update_file(hash, file));
+        storage_file_close(file);
+        hash_test_finish_string(hash, string);
+        mu_assert_string_eq(expected, string);
+        hash_free(hash);
+    }
+
+    storage_file_free(file);
+    storage_common_remove(storage, HASH_TEST_FILE_PATH);
+    furi_record_close("storage");
+    free(data);
+}
+
+static uint32_t hash_test_kbytes_per_sec(uint32_t ticks) {
+    return (uint64_t)HASH_TEST_BENCHMARK_SIZE * osKernelGetTickFreq() / MAX(ticks, 1UL) / 1000;
+}
+
+MU_TEST(hash_benchmark_test) {
+    uint8_t* block = hash_test_data_alloc(HASH_FILE_BLOCK_SIZE);
+
+    for(size_t type = 0; type < HashTypeCount; type++) {
+        Hash* hash = hash_alloc(type);
+        uint32_t start = osKernelGetTickCount();
+        for(size_t i = 0; i < HASH_TEST_BENCHMARK_SIZE / HASH_FILE_BLOCK_SIZE; i++) {
+            hash_update(hash, block, HASH_FILE_BLOCK_SIZE);
+        }
+        uint32_t rate = hash_test_kbytes_per_sec(osKernelGetTickCount() - start);
+        FURI_LOG_I(TAG, "%s: %lu.%02lu MB/s", hash_get_name(type), rate / 1000, rate % 1000 / 10);
+        hash_free(hash);
+    }
+
+    uint32_t crc = 0;
+    uint32_t start = osKernelGetTickCount();
+    for(size_t i = 0; i < HASH_TEST_BENCHMARK_SIZE / HASH_FILE_BLOCK_SIZE; i++) {
+        crc = crc32_calc_buffer(crc, block, HASH_FILE_BLOCK_SIZE);
+    }
+    uint32_t rate = hash_test_kbytes_per_sec(osKernelGetTickCount() - start);
+    FURI_LOG_I(TAG, "crc32 software: %lu.%02lu MB/s", rate / 1000, rate % 1000 / 10);
+
+    free(block);
+}
+
+MU_TEST_SUITE(hash_suite) {
+    MU_RUN_TEST(hash_vectors_test);
+    MU_RUN_TEST(hash_chunks_test);
+    MU_RUN_TEST(hash_file_test);
+    MU_RUN_TEST(hash_benchmark_test);
+}
+
+int run_minunit_test_hash() {
+    MU_RUN_SUITE(hash_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,237 @@
+#include <furi.h>
+#include <input/input_debounce.h>
+#include "../minunit.h"
+
+#define TAG "InputDebounceTest"
+
+#define INPUT_DEBOUNCE_TEST_PINS (2)
+#define INPUT_DEBOUNCE_TEST_EVENTS (16)
+
+// Waveform: pin level from given tick on
+typedef struct {
+    uint32_t time;
+    bool level;
+} InputDebounceTestEdge;
+
+typedef struct {
+    const InputDebounceTestEdge* edges;
+    size_t count;
+} InputDebounceTestTrace;
+
+typedef struct {
+    uint32_t time;
+    size_t pin;
+    InputType type;
+    uint32_t timestamp;
+    uint32_t sequence;
+} InputDebounceTestEvent;
+
+// Fake pins: replay traces with fake clock, record events
+typedef struct {
+    uint32_t now;
+    InputDebounceTestTrace traces[INPUT_DEBOUNCE_TEST_PINS];
+    size_t position[INPUT_DEBOUNCE_TEST_PINS];
+    bool level[INPUT_DEBOUNCE_TEST_PINS];
+    InputDebounceTestEvent events[INPUT_DEBOUNCE_TEST_EVENTS];
+    size_t events_count;
+    size_t wakeups;
+} InputDebounceTest;
+
+static bool input_debounce_test_read(void* context, size_t pin) {
+    InputDebounceTest* test = context;
+    return test->level[pin];
+}
+
+static void input_debounce_test_event(void* context, size_t pin, InputEvent* event) {
+    InputDebounceTest* test = context;
+    furi_check(test->events_count < INPUT_DEBOUNCE_TEST_EVENTS);
+    InputDebounceTestEvent* test_event = &test->events[test->events_count++];
+    test_event->time = test->now;
+    test_event->pin = pin;
+    test_event->type = event->type;
+    test_event->timestamp = event->timestamp;
+    test_event->sequence = event->sequence;
+}
+
+static const InputDebounceCallbacks input_debounce_test_callbacks = {
+    .read = input_debounce_test_read,
+    .event = input_debounce_test_event,
+};
+
+static InputDebounce* input_debounce_test_alloc(InputDebounceTest* test) {
+    memset(test, 0, sizeof(InputDebounceTest));
+    InputDebounce* debounce = input_debounce_alloc(
+        INPUT_DEBOUNCE_TEST_PINS, &input_debounce_test_callbacks, test);
+    for(size_t i = 0; i < INPUT_DEBOUNCE_TEST_PINS; i++) {
+        input_debounce_reset(debounce, i, false);
+    }
+    return debounce;
+}
+
+// Wake up on edges and returned deadlines only, like input thread does
+static void
+    input_debounce_test_run(InputDebounceTest* test, InputDebounce* debounce, uint32_t end) {
+    uint32_t timeout = INPUT_DEBOUNCE_IDLE;
+    while(true) {
+        uint32_t wake = (timeout == INPUT_DEBOUNCE_IDLE) ? UINT32_MAX : test->now + timeout;
+        for(size_t pin = 0; pin < INPUT_DEBOUNCE_TEST_PINS; pin++) {
+            const InputDebounceTestTrace* trace = &test->traces[pin];
+            if(test->position[pin] < trace->count) {
+                wake = MIN(wake, trace->edges[test->position[pin]].time);
+            }
+        }
+        if(wake > end) break;
+        test->now = wake;
+
+        for(size_t pin = 0; pin < INPUT_DEBOUNCE_TEST_PINS; pin++) {
+            const InputDebounceTestTrace* trace = &test->traces[pin];
+            while(test->position[pin] < trace->count &&
+                  trace->edges[test->position[pin]].time <= test->now) {
+                const InputDebounceTestEdge* edge = &trace->edges[test->position[pin]++];
+                test->level[pin] = edge->level;
+                input_debounce_edge(debounce, pin, edge->time);
+            }
+        }
+
+        timeout = input_debounce_process(debounce, test->now);
+        test->wakeups++;
+    }
+    test->now = end;
+}
+
+static void input_debounce_test_check(
+    InputDebounceTest* test,
+    const InputDebounceTestEvent* expected,
+    size_t count) {
+    mu_assert_int_eq(count, test->events_count);
+    for(size_t i = 0; i < count; i++) {
+        mu_assert_int_eq(expected[i].time, test->events[i].time);
+        mu_assert_int_eq(expected[i].pin, test->events[i].pin);
+        mu_assert_int_eq(expected[i].type, test->events[i].type);
+        mu_assert_int_eq(expected[i].timestamp, test->events[i].timestamp);
+        mu_assert_int_eq(expected[i].sequence, test->events[i].sequence);
+    }
+}
+
+MU_TEST(input_debounce_bounce_test) {
+    InputDebounceTest test;
+    InputDebounce* debounce = input_debounce_test_alloc(&test);
+
+    // Contact bounces on press and on release
+    const InputDebounceTestEdge edges[] = {
+        {0, true},
+        {1, false},
+        {2, true},
+        {4, false},
+        {5, true},
+        {290, false},
+        {291, true},
+        {293, false},
+    };
+    test.traces[0] = (InputDebounceTestTrace){edges, COUNT_OF(edges)};
+    input_debounce_test_run(&test, debounce, 1000);
+
+    const InputDebounceTestEvent expected[] = {
+        {0, 0, InputTypePress, 0, 1},
+        {290, 0, InputTypeShort, 290, 1},
+        {290, 0, InputTypeRelease, 290, 1},
+    };
+    input_debounce_test_check(&test, expected, COUNT_OF(expected));
+
+    // One wake up per edge, settle deadlines and press period. Polling every tick while
+    // changing takes about settle time of wake ups per bounce burst instead.
+    FURI_LOG_I(TAG, "Bounce: %u edges, %u wake ups", COUNT_OF(edges), test.wakeups);
+    mu_assert_int_eq(COUNT_OF(edges) + 3, test.wakeups);
+
+    input_debounce_free(debounce);
+}
+
+MU_TEST(input_debounce_long_test) {
+    InputDebounceTest test;
+    InputDebounce* debounce = input_debounce_test_alloc(&test);
+
+    const InputDebounceTestEdge edges[] = {
+        {0, true},
+        {500, false},
+    };
+    test.traces[0] = (InputDebounceTestTrace){edges, COUNT_OF(edges)};
+    input_debounce_test_run(&test, debounce, 1000);
+
+    const InputDebounceTestEvent expected[] = {
+        {0, 0, InputTypePress, 0, 1},
+        {INPUT_PRESS_TICKS * 2, 0, InputTypeLong, INPUT_PRESS_TICKS * 2, 1},
+        {INPUT_PRESS_TICKS * 3, 0, InputTypeRepeat, INPUT_PRESS_TICKS * 3, 1},
+        {500, 0, InputTypeRelease, 500, 1},
+    };
+    input_debounce_test_check(&test, expected, COUNT_OF(expected));
+
+    input_debounce_free(debounce);
+}
+
+MU_TEST(input_debounce_settle_test) {
+    InputDebounceTest test;
+    InputDebounce* debounce = input_debounce_test_alloc(&test);
+
+    // Released while bouncing: release is found when level settles, stamped with last edge
+    const InputDebounceTestEdge edges[] = {
+        {100, true},
+        {101, false},
+        {102, true},
+        {103, false},
+    };
+    test.traces[0] = (InputDebounceTestTrace){edges, COUNT_OF(edges)};
+    input_debounce_test_run(&test, debounce, 1000);
+
+    const InputDebounceTestEvent expected[] = {
+        {100, 0, InputTypePress, 100, 1},
+        {103 + INPUT_DEBOUNCE_SETTLE_TICKS, 0, InputTypeShort, 103, 1},
+        {103 + INPUT_DEBOUNCE_SETTLE_TICKS, 0, InputTypeRelease, 103, 1},
+    };
+    input_debounce_test_check(&test, expected, COUNT_OF(expected));
+
+    input_debounce_free(debounce);
+}
+
+MU_TEST(input_debounce_pins_test) {
+    InputDebounceTest test;
+    InputDebounce* debounce = input_debounce_test_alloc(&test);
+
+    // Keys are independent, sequence is shared
+    const InputDebounceTestEdge edges_0[] = {
+        {0, true},
+        {50, false},
+    };
+    const InputDebounceTestEdge edges_1[] = {
+        {20, true},
+        {30, false},
+        {31, true},
+        {60, false},
+    };
+    test.traces[0] = (InputDebounceTestTrace){edges_0, COUNT_OF(edges_0)};
+    test.traces[1] = (InputDebounceTestTrace){edges_1, COUNT_OF(edges_1)};
+    input_debounce_test_run(&test, debounce, 1000);
+
+    const InputDebounceTestEvent expected[] = {
+        {0, 0, InputTypePress, 0, 1},
+        {20, 1, InputTypePress, 20, 2},
+        {50, 0, InputTypeShort, 50, 1},
+        {50, 0, InputTypeRelease, 50, 1},
+        {60, 1, InputTypeShort, 60, 2},
+        {60, 1, InputTypeRelease, 60, 2},
+    };
+    input_debounce_test_check(&test, expected, COUNT_OF(expected));
+
+    input_debounce_free(debounce);
+}
+
+MU_TEST_SUITE(input_debounce_suite) {
+    MU_RUN_TEST(input_debounce_bounce_test);
+    MU_RUN_TEST(input_debounce_long_test);
+    MU_RUN_TEST(input_debounce_settle_test);
+    MU_RUN_TEST(input_debounce_pins_test);
+}
+
+int run_minunit_test_input_debounce() {
+    MU_RUN_SUITE(input_debounce_suite);
+    return MU_EXIT_CODE;
+}
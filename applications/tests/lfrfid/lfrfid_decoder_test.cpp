@@ -0,0 +1,220 @@
+#include <furi.h>
+#include <lfrfid/helpers/decoder_emmarin.h>
+#include <lfrfid/helpers/decoder_hid26.h>
+#include <lfrfid/helpers/decoder_indala.h>
+#include <lfrfid/helpers/encoder_emmarin.h>
+#include <lfrfid/helpers/encoder_hid_h10301.h>
+#include <lfrfid/helpers/encoder_indala_40134.h>
+#include <lfrfid/helpers/key_info.h>
+#include <lfrfid/helpers/rfid_reader.h>
+#include "../minunit.h"
+
+#define TAG "LfRfidDecoderTest"
+
+// Comparator edges are timestamped with 64MHz DWT, encoder clock is 125kHz carrier
+static const uint32_t lfrfid_test_ticks_per_clock = 64000000 / 125000;
+static const size_t lfrfid_test_edges_max = 4096;
+
+struct LfRfidTestEdge {
+    bool polarity;
+    uint32_t time;
+};
+
+/**
+ * @brief Replays tag waveform as comparator edges: level after edge and previous level duration
+ */
+class LfRfidTestTrace {
+public:
+    LfRfidTestTrace() {
+        edges = new LfRfidTestEdge[lfrfid_test_edges_max];
+    }
+
+    ~LfRfidTestTrace() {
+        delete[] edges;
+    }
+
+    void render(EncoderGeneric* encoder, size_t pulses, bool envelope_only) {
+        bool polarity;
+        uint16_t period;
+        uint16_t pulse;
+
+        count = 0;
+        level = false;
+        level_time = 0;
+
+        for(size_t i = 0; i < pulses; i++) {
+            encoder->get_next(&polarity, &period, &pulse);
+            if(envelope_only) {
+                push(polarity, period);
+            } else {
+                push(polarity, pulse);
+                push(!polarity, period - pulse);
+            }
+        }
+    }
+
+    template <class Decoder> bool replay(Decoder* decoder, uint8_t* data, uint8_t data_size) {
+        bool result = false;
+        for(size_t i = 0; i < count && !result; i++) {
+            decoder->process_front(edges[i].polarity, edges[i].time);
+            result = decoder->read(data, data_size);
+        }
+        return result;
+    }
+
+    const LfRfidTestEdge& get(size_t index) {
+        return edges[index];
+    }
+
+    size_t count;
+
+private:
+    void push(bool new_level, uint32_t clocks) {
+        if(new_level != level && level_time) {
+            furi_check(count < lfrfid_test_edges_max);
+            edges[count].polarity = new_level;
+            edges[count].time = level_time * lfrfid_test_ticks_per_clock;
+            count++;
+            level_time = 0;
+        }
+        level = new_level;
+        level_time += clocks;
+    }
+
+    LfRfidTestEdge* edges;
+    bool level;
+    uint32_t level_time;
+};
+
+MU_TEST(lfrfid_decoder_em4100_test) {
+    const uint8_t key[] = {0x01, 0x23, 0x45, 0x67, 0x89};
+    uint8_t data[LFRFID_KEY_SIZE] = {0};
+    EncoderEM encoder;
+    DecoderEMMarin decoder;
+    LfRfidTestTrace trace;
+
+    encoder.init(key, sizeof(key));
+    // Two full frames, so decoder can lock on the header
+    trace.render(&encoder, 64 * 2, false);
+    mu_check(trace.replay(&decoder, data, sizeof(data)));
+    mu_check(memcmp(key, data, sizeof(key)) == 0);
+}
+
+MU_TEST(lfrfid_decoder_h10301_test) {
+    const uint8_t key[] = {0xAB, 0x12, 0x34};
+    uint8_t data[LFRFID_KEY_SIZE] = {0};
+    EncoderHID_H10301 encoder;
+    DecoderHID26 decoder;
+    LfRfidTestTrace trace;
+
+    encoder.init(key, sizeof(key));
+    // 96 bits, up to 7 FSK periods per bit, two frames
+    trace.render(&encoder, 96 * 7 * 2, false);
+    mu_check(trace.replay(&decoder, data, sizeof(data)));
+    mu_check(memcmp(key, data, sizeof(key)) == 0);
+}
+
+MU_TEST(lfrfid_decoder_indala_test) {
+    const uint8_t key[] = {0x1A, 0x2B, 0x3C};
+    uint8_t data[LFRFID_KEY_SIZE] = {0};
+    EncoderIndala_40134 encoder;
+    DecoderIndala decoder;
+    LfRfidTestTrace trace;
+
+    encoder.init(key, sizeof(key));
+    // PSK is seen as phase changes only, 16 encoder pulses per bit, two frames
+    trace.render(&encoder, 64 * 16 * 2, true);
+    mu_check(trace.replay(&decoder, data, sizeof(data)));
+    mu_check(memcmp(key, data, sizeof(key)) == 0);
+}
+
+/**
+ * @brief Drives RfidReader decoder thread without comparator
+ */
+struct RfidReaderTest {
+    static void start(RfidReader& reader) {
+        reader.start_decoder_thread();
+    }
+
+    static void stop(RfidReader& reader) {
+        reader.stop_decoder_thread();
+    }
+
+    static void push_edge(RfidReader& reader, bool polarity, uint32_t period) {
+        reader.push_edge(polarity, period);
+    }
+};
+
+struct LfRfidTestFeeder {
+    RfidReader* reader;
+    LfRfidTestTrace* trace;
+    std::atomic<bool> running;
+};
+
+// Stands in for comparator ISR: preempts reader thread and feeds edges while it reads
+static int32_t lfrfid_test_feeder_thread(void* context) {
+    LfRfidTestFeeder* feeder = static_cast<LfRfidTestFeeder*>(context);
+    while(feeder->running) {
+        for(size_t i = 0; i < feeder->trace->count && feeder->running; i++) {
+            const LfRfidTestEdge& edge = feeder->trace->get(i);
+            RfidReaderTest::push_edge(*feeder->reader, edge.polarity, edge.time);
+            // Slower than decoder, so no edges are dropped
+            if(i % 32 == 31) osDelay(1);
+        }
+    }
+    return 0;
+}
+
+MU_TEST(lfrfid_reader_thread_test) {
+    const uint8_t key[] = {0x01, 0x23, 0x45, 0x67, 0x89};
+    uint8_t data[LFRFID_KEY_SIZE] = {0};
+    LfrfidKeyType type;
+    EncoderEM encoder;
+    LfRfidTestTrace trace;
+    RfidReader reader;
+
+    encoder.init(key, sizeof(key));
+    trace.render(&encoder, 64 * 2, false);
+
+    RfidReaderTest::start(reader);
+    LfRfidTestFeeder feeder;
+    feeder.reader = &reader;
+    feeder.trace = &trace;
+    feeder.running = true;
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "RfidTestFeeder");
+    furi_thread_set_stack_size(thread, 1024);
+    furi_thread_set_context(thread, &feeder);
+    furi_thread_set_callback(thread, lfrfid_test_feeder_thread);
+    furi_thread_start(thread);
+    osThreadSetPriority(furi_thread_get_thread_id(thread), osPriorityHigh);
+
+    // Key must be confirmed by several reads, reader polls while edges keep coming
+    bool result = false;
+    for(size_t i = 0; i < 200 && !result; i++) {
+        result = reader.read(&type, data, sizeof(data), false);
+        osDelay(10);
+    }
+
+    feeder.running = false;
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    RfidReaderTest::stop(reader);
+
+    mu_check(result);
+    mu_check(type == LfrfidKeyType::KeyEM4100);
+    mu_check(memcmp(key, data, sizeof(key)) == 0);
+    mu_assert_int_eq(0, reader.get_dropped_edges());
+}
+
+MU_TEST_SUITE(lfrfid_decoder_suite) {
+    MU_RUN_TEST(lfrfid_decoder_em4100_test);
+    MU_RUN_TEST(lfrfid_decoder_h10301_test);
+    MU_RUN_TEST(lfrfid_decoder_indala_test);
+    MU_RUN_TEST(lfrfid_reader_thread_test);
+}
+
+extern "C" int run_minunit_test_lfrfid_decoder() {
+    MU_RUN_SUITE(lfrfid_decoder_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,204 @@
+#include <furi.h>
+#include <lfrfid/helpers/encoder_emmarin.h>
+#include <lfrfid/helpers/encoder_hid_h10301.h>
+#include <lfrfid/helpers/encoder_indala_40134.h>
+#include <lfrfid/helpers/pulse_joiner.h>
+#include <lfrfid/helpers/pulse_train.h>
+#include "../minunit.h"
+
+// EM4100 01 23 45 67 89, train starts at the second header bit:
+// 8 header ones, then rows 0000-0 and 0001-1
+static const PulseTrain::Pulse lfrfid_test_em4100_golden[] = {
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {96, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {64, 32},
+    {96, 64},
+};
+
+struct LfRfidTestRun {
+    uint16_t count;
+    PulseTrain::Pulse pulse;
+};
+
+// H10301 AB 12 34, train starts at the preamble 0001 1101:
+// FSK zero is ~6 periods of 8 clocks, one is 5 periods of 10 clocks
+static const LfRfidTestRun lfrfid_test_h10301_golden[] = {
+    {19, {8, 4}},
+    {15, {10, 5}},
+    {7, {8, 4}},
+    {5, {10, 5}},
+    {6, {8, 4}},
+    {5, {10, 5}},
+    {6, {8, 4}},
+    {5, {10, 5}},
+    {6, {8, 4}},
+    {5, {10, 5}},
+    {7, {8, 4}},
+    {5, {10, 5}},
+    {6, {8, 4}},
+    {5, {10, 5}},
+    {6, {8, 4}},
+    {10, {10, 5}},
+};
+
+// Indala 40134 1A 2B 3C: carrier is half of 125kHz and a phase change
+// stretches one period to 3 clocks, the first 4 phase changes
+static const LfRfidTestRun lfrfid_test_indala_golden[] = {
+    {14, {2, 1}},
+    {1, {3, 1}},
+    {15, {2, 1}},
+    {1, {3, 2}},
+    {14, {2, 1}},
+    {1, {3, 1}},
+    {15, {2, 1}},
+    {1, {3, 2}},
+};
+
+static bool lfrfid_test_train_matches_golden(
+    PulseTrain* train,
+    const LfRfidTestRun* golden,
+    size_t golden_count) {
+    const PulseTrain::Pulse* pulses = train->get_pulses();
+    uint16_t index = 0;
+
+    for(size_t i = 0; i < golden_count; i++) {
+        for(uint16_t j = 0; j < golden[i].count; j++) {
+            if(index >= train->get_count()) return false;
+            if(pulses[index].period != golden[i].pulse.period ||
+               pulses[index].pulse != golden[i].pulse.pulse) {
+                return false;
+            }
+            index++;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compare looped train with pulses produced the way emulation ISR used to do it.
+ * Oscillator phase survives encoder init, so reference encoder must be a fresh instance.
+ */
+static bool lfrfid_test_train_matches_joiner(
+    EncoderGeneric* encoder,
+    const uint8_t* key,
+    uint8_t key_size,
+    PulseTrain* train) {
+    PulseJoiner joiner;
+    const PulseTrain::Pulse* pulses = train->get_pulses();
+    const uint16_t count = train->get_count();
+    // Skip oscillator settling, then capture two loops of the train
+    const uint32_t skip = count * 2;
+    const uint32_t reference_count = count * 2;
+    PulseTrain::Pulse* reference = new PulseTrain::Pulse[reference_count];
+    bool polarity;
+    uint16_t period;
+    uint16_t pulse;
+    bool result = false;
+
+    encoder->init(key, key_size);
+
+    for(uint32_t i = 0; i < skip + reference_count; i++) {
+        do {
+            encoder->get_next(&polarity, &period, &pulse);
+        } while(!joiner.push_pulse(polarity, period, pulse));
+        joiner.pop_pulse(&period, &pulse);
+
+        if(i >= skip) {
+            reference[i - skip] = {period, pulse};
+        }
+    }
+
+    // Find train phase
+    for(uint16_t offset = 0; offset < count && !result; offset++) {
+        result = true;
+        for(uint32_t i = 0; i < reference_count; i++) {
+            const PulseTrain::Pulse* expected = &pulses[(offset + i) % count];
+            if(expected->period != reference[i].period || expected->pulse != reference[i].pulse) {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    delete[] reference;
+    return result;
+}
+
+static uint32_t lfrfid_test_train_clocks(PulseTrain* train) {
+    uint32_t clocks = 0;
+    for(uint16_t i = 0; i < train->get_count(); i++) {
+        clocks += train->get_pulses()[i].period;
+    }
+    return clocks;
+}
+
+MU_TEST(lfrfid_pulse_train_em4100_test) {
+    const uint8_t key[] = {0x01, 0x23, 0x45, 0x67, 0x89};
+    EncoderEM encoder;
+    EncoderEM reference_encoder;
+    PulseTrain train;
+
+    encoder.init(key, sizeof(key));
+    mu_check(train.render(&encoder));
+    mu_assert_int_eq(64 * 64, lfrfid_test_train_clocks(&train));
+    mu_check(train.get_count() >= COUNT_OF(lfrfid_test_em4100_golden));
+    for(size_t i = 0; i < COUNT_OF(lfrfid_test_em4100_golden); i++) {
+        mu_assert_int_eq(lfrfid_test_em4100_golden[i].period, train.get_pulses()[i].period);
+        mu_assert_int_eq(lfrfid_test_em4100_golden[i].pulse, train.get_pulses()[i].pulse);
+    }
+    mu_check(lfrfid_test_train_matches_joiner(&reference_encoder, key, sizeof(key), &train));
+}
+
+MU_TEST(lfrfid_pulse_train_h10301_test) {
+    const uint8_t key[] = {0xAB, 0x12, 0x34};
+    EncoderHID_H10301 encoder;
+    EncoderHID_H10301 reference_encoder;
+    PulseTrain train;
+
+    encoder.init(key, sizeof(key));
+    mu_check(train.render(&encoder));
+    mu_assert_int_eq(540, train.get_count());
+    mu_assert_int_eq(96 * 50, lfrfid_test_train_clocks(&train));
+    mu_check(lfrfid_test_train_matches_golden(
+        &train, lfrfid_test_h10301_golden, COUNT_OF(lfrfid_test_h10301_golden)));
+    mu_check(lfrfid_test_train_matches_joiner(&reference_encoder, key, sizeof(key), &train));
+}
+
+MU_TEST(lfrfid_pulse_train_indala_test) {
+    const uint8_t key[] = {0x1A, 0x2B, 0x3C};
+    EncoderIndala_40134 encoder;
+    EncoderIndala_40134 reference_encoder;
+    PulseTrain train;
+
+    encoder.init(key, sizeof(key));
+    mu_check(train.render(&encoder));
+    mu_assert_int_eq(1011, train.get_count());
+    mu_assert_int_eq(64 * 32, lfrfid_test_train_clocks(&train));
+    mu_check(lfrfid_test_train_matches_golden(
+        &train, lfrfid_test_indala_golden, COUNT_OF(lfrfid_test_indala_golden)));
+    mu_check(lfrfid_test_train_matches_joiner(&reference_encoder, key, sizeof(key), &train));
+}
+
+MU_TEST_SUITE(lfrfid_pulse_train_suite) {
+    MU_RUN_TEST(lfrfid_pulse_train_em4100_test);
+    MU_RUN_TEST(lfrfid_pulse_train_h10301_test);
+    MU_RUN_TEST(lfrfid_pulse_train_indala_test);
+}
+
+extern "C" int run_minunit_test_lfrfid_pulse_train() {
+    MU_RUN_SUITE(lfrfid_pulse_train_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,141 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <loader/loader_profile.h>
+#include "../minunit.h"
+
+#define TAG "LoaderProfileTest"
+
+#define LOADER_PROFILE_TEST_PATH "/int/.unit_test.profile"
+#define LOADER_PROFILE_TEST_LAUNCHES (LOADER_PROFILE_RING_SIZE + 5)
+
+static void loader_profile_test_cleanup() {
+    Storage* storage = furi_record_open("storage");
+    storage_common_remove(storage, LOADER_PROFILE_TEST_PATH);
+    furi_record_close("storage");
+}
+
+MU_TEST(loader_profile_timeline_test) {
+    LoaderProfileRecord record;
+
+    loader_profile_begin("Test App", 2048);
+    // Nothing counts before application thread runs
+    loader_profile_storage_call(100);
+    loader_profile_mark(LoaderProfileMarkViewDispatcherRun);
+    loader_profile_thread_started();
+
+    loader_profile_storage_call(0);
+    loader_profile_storage_call(512);
+    loader_profile_storage_call(64);
+    // Frame of previous application
+    loader_profile_mark(LoaderProfileMarkFirstFrame);
+    loader_profile_gui_attached();
+    loader_profile_mark(LoaderProfileMarkViewDispatcherRun);
+    loader_profile_mark(LoaderProfileMarkFirstFrame);
+    // Startup is over
+    loader_profile_storage_call(1024);
+    loader_profile_end(&record, 3000, 1500);
+
+    mu_assert_string_eq("Test App", record.name);
+    mu_check(record.marks[LoaderProfileMarkThreadStart] != LOADER_PROFILE_NO_MARK);
+    mu_check(record.marks[LoaderProfileMarkViewDispatcherRun] != LOADER_PROFILE_NO_MARK);
+    mu_check(record.marks[LoaderProfileMarkFirstFrame] != LOADER_PROFILE_NO_MARK);
+    mu_check(
+        record.marks[LoaderProfileMarkThreadStart] <=
+        record.marks[LoaderProfileMarkViewDispatcherRun]);
+    mu_check(
+        record.marks[LoaderProfileMarkViewDispatcherRun] <=
+        record.marks[LoaderProfileMarkFirstFrame]);
+    mu_check(record.run_time >= record.marks[LoaderProfileMarkFirstFrame]);
+    mu_assert_int_eq(3, record.storage_calls);
+    mu_assert_int_eq(576, record.storage_read);
+    mu_assert_int_eq(3000, record.heap_peak);
+    mu_assert_int_eq(2048, record.stack_size);
+    mu_assert_int_eq(548, record.stack_peak);
+
+    // Closed launch ignores probes
+    loader_profile_storage_call(1);
+    loader_profile_end(&record, 3000, 1500);
+    mu_assert_int_eq(3, record.storage_calls);
+}
+
+MU_TEST(loader_profile_ring_test) {
+    loader_profile_test_cleanup();
+    Storage* storage = furi_record_open("storage");
+    LoaderProfileRing* ring = malloc(sizeof(LoaderProfileRing));
+    LoaderProfileRecord* records = malloc(sizeof(LoaderProfileRecord) * LOADER_PROFILE_RING_SIZE);
+
+    mu_assert_int_eq(0, loader_profile_ring_get(ring, records, LOADER_PROFILE_RING_SIZE));
+    mu_assert_int_eq(
+        0,
+        loader_profile_ring_read(
+            storage, LOADER_PROFILE_TEST_PATH, records, LOADER_PROFILE_RING_SIZE));
+
+    for(size_t i = 0; i < LOADER_PROFILE_TEST_LAUNCHES; i++) {
+        LoaderProfileRecord record = {0};
+        snprintf(record.name, LOADER_PROFILE_NAME_SIZE, "App %u", i);
+        record.run_time = i;
+        loader_profile_ring_push(ring, &record);
+        mu_assert_int_eq(i, record.sequence);
+    }
+
+    // Newest first, oldest launches are overwritten
+    size_t count = loader_profile_ring_get(ring, records, LOADER_PROFILE_RING_SIZE);
+    mu_assert_int_eq(LOADER_PROFILE_RING_SIZE, count);
+    for(size_t i = 0; i < count; i++) {
+        uint32_t sequence = LOADER_PROFILE_TEST_LAUNCHES - 1 - i;
+        char name[LOADER_PROFILE_NAME_SIZE];
+        snprintf(name, LOADER_PROFILE_NAME_SIZE, "App %lu", sequence);
+        mu_assert_int_eq(sequence, records[i].sequence);
+        mu_assert_int_eq(sequence, records[i].run_time);
+        mu_assert_string_eq(name, records[i].name);
+    }
+
+    // Fewer than stored
+    mu_assert_int_eq(2, loader_profile_ring_get(ring, records, 2));
+    mu_assert_int_eq(LOADER_PROFILE_TEST_LAUNCHES - 1, records[0].sequence);
+
+    // Saved file reads back the same
+    mu_check(loader_profile_ring_save(ring, storage, LOADER_PROFILE_TEST_PATH));
+    count = loader_profile_ring_read(
+        storage, LOADER_PROFILE_TEST_PATH, records, LOADER_PROFILE_RING_SIZE);
+    mu_assert_int_eq(LOADER_PROFILE_RING_SIZE, count);
+    for(size_t i = 0; i < count; i++) {
+        LoaderProfileRecord* record =
+            &ring->records[(ring->sequence - 1 - i) % LOADER_PROFILE_RING_SIZE];
+        mu_check(memcmp(record, &records[i], sizeof(LoaderProfileRecord)) == 0);
+    }
+
+    // Unknown file reads nothing and is overwritten by save
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, LOADER_PROFILE_TEST_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_assert_int_eq(4, storage_file_write(file, "junk", 4));
+    storage_file_close(file);
+    storage_file_free(file);
+    mu_assert_int_eq(
+        0,
+        loader_profile_ring_read(
+            storage, LOADER_PROFILE_TEST_PATH, records, LOADER_PROFILE_RING_SIZE));
+    memset(ring, 0, sizeof(LoaderProfileRing));
+    LoaderProfileRecord record = {0};
+    loader_profile_ring_push(ring, &record);
+    mu_check(loader_profile_ring_save(ring, storage, LOADER_PROFILE_TEST_PATH));
+    mu_assert_int_eq(
+        1,
+        loader_profile_ring_read(
+            storage, LOADER_PROFILE_TEST_PATH, records, LOADER_PROFILE_RING_SIZE));
+
+    free(records);
+    free(ring);
+    furi_record_close("storage");
+    loader_profile_test_cleanup();
+}
+
+MU_TEST_SUITE(loader_profile_suite) {
+    MU_RUN_TEST(loader_profile_timeline_test);
+    MU_RUN_TEST(loader_profile_ring_test);
+}
+
+int run_minunit_test_loader_profile() {
+    MU_RUN_SUITE(loader_profile_suite);
+    return MU_EXIT_CODE;
+}
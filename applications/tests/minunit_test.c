@@ -7,6 +7,14 @@ void test_furi_create_open();
 void test_furi_valuemutex();
 void test_furi_concurrent_access();
 void test_furi_pubsub();
+void test_furi_pubsub_reentrant();
+void test_furi_pubsub_concurrent();
+void test_furi_pubsub_async();
+void test_furi_thread_profiler();
+#ifdef FURI_TRACE
+void test_furi_trace();
+void test_furi_trace_mutex();
+#endif
 
 void test_furi_memmgr();
 
@@ -41,6 +49,32 @@ MU_TEST(mu_test_furi_pubsub) {
     test_furi_pubsub();
 }
 
+MU_TEST(mu_test_furi_pubsub_reentrant) {
+    test_furi_pubsub_reentrant();
+}
+
+MU_TEST(mu_test_furi_pubsub_concurrent) {
+    test_furi_pubsub_concurrent();
+}
+
+MU_TEST(mu_test_furi_pubsub_async) {
+    test_furi_pubsub_async();
+}
+
+MU_TEST(mu_test_furi_thread_profiler) {
+    test_furi_thread_profiler();
+}
+
+#ifdef FURI_TRACE
+MU_TEST(mu_test_furi_trace) {
+    test_furi_trace();
+}
+
+MU_TEST(mu_test_furi_trace_mutex) {
+    test_furi_trace_mutex();
+}
+#endif
+
 MU_TEST(mu_test_furi_memmgr) {
     // this test is not accurate, but gives a basic understanding
     // that memory management is working fine
@@ -57,6 +91,14 @@ MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(mu_test_furi_valuemutex);
     MU_RUN_TEST(mu_test_furi_concurrent_access);
     MU_RUN_TEST(mu_test_furi_pubsub);
+    MU_RUN_TEST(mu_test_furi_pubsub_reentrant);
+    MU_RUN_TEST(mu_test_furi_pubsub_concurrent);
+    MU_RUN_TEST(mu_test_furi_pubsub_async);
+    MU_RUN_TEST(mu_test_furi_thread_profiler);
+#ifdef FURI_TRACE
+    MU_RUN_TEST(mu_test_furi_trace);
+    MU_RUN_TEST(mu_test_furi_trace_mutex);
+#endif
     MU_RUN_TEST(mu_test_furi_memmgr);
 }
 
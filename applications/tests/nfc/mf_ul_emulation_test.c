@@ -0,0 +1,161 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <lib/nfc_protocols/mifare_ultralight.h>
+#include "../minunit.h"
+
+#define TAG "MfUlEmulationTest"
+
+#define MF_UL_TEST_NTAG213_PAGES (45)
+#define MF_UL_TEST_PWD_PAGE (MF_UL_TEST_NTAG213_PAGES - 2)
+#define MF_UL_TEST_PACK_PAGE (MF_UL_TEST_NTAG213_PAGES - 1)
+#define MF_UL_TEST_NACK_BITS (4)
+
+typedef struct {
+    uint8_t rx[8];
+    uint8_t rx_len;
+    uint8_t tx[20];
+    uint16_t tx_bits;
+} MfUlTestFrame;
+
+// Reader transcript recorded against NTAG213 with password 11223344 and PACK AABB
+static const MfUlTestFrame mf_ul_test_transcript[] = {
+    // GET_VERSION
+    {.rx = {0x60},
+     .rx_len = 1,
+     .tx = {0x00, 0x04, 0x04, 0x02, 0x01, 0x00, 0x0F, 0x03},
+     .tx_bits = 8 * 8},
+    // READ 0
+    {.rx = {0x30, 0x00},
+     .rx_len = 2,
+     .tx = {0x04,
+            0x11,
+            0x22,
+            0xBF,
+            0x33,
+            0x44,
+            0x55,
+            0x66,
+            0x00,
+            0x48,
+            0x00,
+            0x00,
+            0xE1,
+            0x10,
+            0x12,
+            0x00},
+     .tx_bits = 16 * 8},
+    // READ 42 with roll-over, PWD and PACK must be masked
+    {.rx = {0x30, 42},
+     .rx_len = 2,
+     .tx = {42, 42, 42, 42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 44, 44, 0x04, 0x11, 0x22, 0xBF},
+     .tx_bits = 16 * 8},
+    // FAST_READ 43..44
+    {.rx = {0x3A, 43, 44},
+     .rx_len = 3,
+     .tx = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 44, 44},
+     .tx_bits = 8 * 8},
+    // WRITE 4
+    {.rx = {0xA2, 0x04, 0x01, 0x02, 0x03, 0x04}, .rx_len = 6, .tx = {0x0A}, .tx_bits = 4},
+    // READ 4 returns written page
+    {.rx = {0x30, 0x04},
+     .rx_len = 2,
+     .tx = {0x01, 0x02, 0x03, 0x04, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7},
+     .tx_bits = 16 * 8},
+    // WRITE to PWD page is rejected
+    {.rx = {0xA2, 43, 0xDE, 0xAD, 0xBE, 0xEF},
+     .rx_len = 6,
+     .tx = {0x00},
+     .tx_bits = MF_UL_TEST_NACK_BITS},
+    // PWD_AUTH with valid password
+    {.rx = {0x1B, 0x11, 0x22, 0x33, 0x44}, .rx_len = 5, .tx = {0xAA, 0xBB}, .tx_bits = 2 * 8},
+    // PWD_AUTH with invalid password
+    {.rx = {0x1B, 0x00, 0x00, 0x00, 0x00},
+     .rx_len = 5,
+     .tx = {0x00},
+     .tx_bits = MF_UL_TEST_NACK_BITS},
+    // Truncated READ
+    {.rx = {0x30}, .rx_len = 1, .tx = {0x00}, .tx_bits = MF_UL_TEST_NACK_BITS},
+    // Unknown command
+    {.rx = {0xFF}, .rx_len = 1, .tx = {0x00}, .tx_bits = MF_UL_TEST_NACK_BITS},
+};
+
+static void mf_ul_test_fill_ntag213(MifareUlData* data) {
+    static const uint8_t version[] = {0x00, 0x04, 0x04, 0x02, 0x01, 0x00, 0x0F, 0x03};
+    static const uint8_t header[] = {
+        0x04, 0x11, 0x22, 0xBF, 0x33, 0x44, 0x55, 0x66, // UID
+        0x00, 0x48, 0x00, 0x00, 0xE1, 0x10, 0x12, 0x00, // Lock bytes and capability container
+    };
+
+    memset(data, 0, sizeof(MifareUlData));
+    memcpy(&data->version, version, sizeof(version));
+    data->type = MfUltralightTypeNTAG213;
+    data->data_size = MF_UL_TEST_NTAG213_PAGES * 4;
+    for(uint16_t page = 0; page < MF_UL_TEST_NTAG213_PAGES; page++) {
+        memset(&data->data[page * 4], page, 4);
+    }
+    memcpy(data->data, header, sizeof(header));
+    memcpy(&data->data[MF_UL_TEST_PWD_PAGE * 4], (uint8_t[]){0x11, 0x22, 0x33, 0x44}, 4);
+    memcpy(&data->data[MF_UL_TEST_PACK_PAGE * 4], (uint8_t[]){0xAA, 0xBB}, 2);
+}
+
+MU_TEST(mf_ul_emulation_transcript_test) {
+    MifareUlData* data = furi_alloc(sizeof(MifareUlData));
+    MifareUlDevice* mf_ul_emulate = furi_alloc(sizeof(MifareUlDevice));
+    uint8_t tx[64];
+    uint8_t rx[8];
+    uint16_t tx_bits;
+    uint32_t data_type;
+    uint32_t cycles_max = 0;
+    uint32_t cycles_total = 0;
+
+    mf_ul_test_fill_ntag213(data);
+    mf_ul_prepare_emulation(mf_ul_emulate, data);
+
+    for(size_t i = 0; i < COUNT_OF(mf_ul_test_transcript); i++) {
+        const MfUlTestFrame* frame = &mf_ul_test_transcript[i];
+        memcpy(rx, frame->rx, sizeof(rx));
+        memset(tx, 0xFF, sizeof(tx));
+
+        uint32_t cycles = DWT->CYCCNT;
+        mf_ul_prepare_emulation_response(
+            rx, frame->rx_len * 8, tx, &tx_bits, &data_type, mf_ul_emulate);
+        cycles = DWT->CYCCNT - cycles;
+        cycles_total += cycles;
+        if(cycles > cycles_max) cycles_max = cycles;
+
+        mu_assert_int_eq(frame->tx_bits, tx_bits);
+        if(frame->tx_bits == MF_UL_TEST_NACK_BITS) {
+            mu_assert_int_eq(FURI_HAL_NFC_TXRX_RAW, data_type);
+            mu_assert_int_eq(frame->tx[0], tx[0]);
+        } else {
+            mu_check(memcmp(frame->tx, tx, frame->tx_bits / 8) == 0);
+        }
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Response cycles: avg %d, max %d",
+        cycles_total / COUNT_OF(mf_ul_test_transcript),
+        cycles_max);
+
+    // Only written page goes back, auth pages stay intact
+    mu_check(mf_ul_emulate->data_changed);
+    mf_ul_sync_emulation_data(mf_ul_emulate, data);
+    mu_check(!mf_ul_emulate->data_changed);
+    mu_check(memcmp(&data->data[4 * 4], (uint8_t[]){0x01, 0x02, 0x03, 0x04}, 4) == 0);
+    mu_check(
+        memcmp(&data->data[MF_UL_TEST_PWD_PAGE * 4], (uint8_t[]){0x11, 0x22, 0x33, 0x44}, 4) == 0);
+    mu_check(memcmp(&data->data[MF_UL_TEST_PACK_PAGE * 4], (uint8_t[]){0xAA, 0xBB}, 2) == 0);
+
+    free(mf_ul_emulate);
+    free(data);
+}
+
+MU_TEST_SUITE(mf_ul_emulation_suite) {
+    MU_RUN_TEST(mf_ul_emulation_transcript_test);
+}
+
+int run_minunit_test_mf_ul_emulation() {
+    MU_RUN_SUITE(mf_ul_emulation_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,303 @@
+#include <furi.h>
+#include <notification/notification_messages.h>
+#include <notification/notification_timeline.h>
+#include "../minunit.h"
+
+#define TAG "NotificationTimelineTest"
+
+#define NOTIFICATION_TIMELINE_TEST_EVENTS (32)
+
+typedef struct {
+    uint32_t time;
+    NotificationChannel channel;
+    uint8_t value;
+    bool reset;
+} NotificationTimelineTestEvent;
+
+// Fake hardware: records outputs with fake clock time
+typedef struct {
+    uint32_t now;
+    bool led_internal_on;
+    NotificationTimelineTestEvent events[NOTIFICATION_TIMELINE_TEST_EVENTS];
+    size_t events_count;
+    uint32_t complete_time[NOTIFICATION_TIMELINE_TRACKS + 1];
+    size_t complete_count;
+} NotificationTimelineTest;
+
+static void notification_timeline_test_record(
+    NotificationTimelineTest* test,
+    NotificationChannel channel,
+    uint8_t value,
+    bool reset) {
+    furi_check(test->events_count < NOTIFICATION_TIMELINE_TEST_EVENTS);
+    NotificationTimelineTestEvent* event = &test->events[test->events_count++];
+    event->time = test->now;
+    event->channel = channel;
+    event->value = value;
+    event->reset = reset;
+}
+
+static void notification_timeline_test_output(
+    void* context,
+    NotificationChannel channel,
+    const NotificationTimelineValue* value) {
+    notification_timeline_test_record(context, channel, value->value, false);
+}
+
+static void notification_timeline_test_reset(void* context, NotificationChannel channel) {
+    notification_timeline_test_record(context, channel, 0, true);
+}
+
+static bool notification_timeline_test_is_led_internal_on(void* context) {
+    NotificationTimelineTest* test = context;
+    return test->led_internal_on;
+}
+
+static void notification_timeline_test_complete(void* context, void* tag) {
+    NotificationTimelineTest* test = context;
+    size_t index = (size_t)tag;
+    furi_check(index < COUNT_OF(test->complete_time));
+    test->complete_time[index] = test->now;
+    test->complete_count++;
+}
+
+static const NotificationTimelineCallbacks notification_timeline_test_callbacks = {
+    .output = notification_timeline_test_output,
+    .reset = notification_timeline_test_reset,
+    .is_led_internal_on = notification_timeline_test_is_led_internal_on,
+    .complete = notification_timeline_test_complete,
+};
+
+static const NotificationTimelineSettings notification_timeline_test_settings = {
+    .speaker_volume = 1.0f,
+    .vibro_on = true,
+    .display_brightness = 1.0f,
+};
+
+static const NotificationMessage test_sound_on = {
+    .type = NotificationMessageTypeSoundOn,
+    .data.sound.frequency = 440.0f,
+    .data.sound.pwm = 0.5f,
+};
+
+static const NotificationSequence test_melody = {
+    &test_sound_on,
+    &message_delay_50,
+    &test_sound_on,
+    &message_delay_50,
+    &test_sound_on,
+    &message_delay_50,
+    &message_sound_off,
+    NULL,
+};
+
+static const NotificationSequence test_melody_high = {
+    &message_priority_high,
+    &test_sound_on,
+    &message_delay_100,
+    &message_sound_off,
+    NULL,
+};
+
+static const NotificationSequence test_beep = {
+    &test_sound_on,
+    &message_delay_10,
+    &message_sound_off,
+    NULL,
+};
+
+static const NotificationSequence test_blink = {
+    &message_red_255,
+    &message_delay_100,
+    NULL,
+};
+
+static const NotificationSequence test_vibro = {
+    &message_vibro_on,
+    &message_delay_100,
+    &message_vibro_off,
+    NULL,
+};
+
+static NotificationTimeline* notification_timeline_test_alloc(NotificationTimelineTest* test) {
+    memset(test, 0, sizeof(NotificationTimelineTest));
+    return notification_timeline_alloc(&notification_timeline_test_callbacks, test);
+}
+
+static void notification_timeline_test_add(
+    NotificationTimelineTest* test,
+    NotificationTimeline* timeline,
+    const NotificationSequence* sequence,
+    size_t tag) {
+    notification_timeline_add(
+        timeline, sequence, &notification_timeline_test_settings, (void*)tag, test->now);
+}
+
+// Sleep for returned time like notification thread does, wake up at end
+static void notification_timeline_test_run(
+    NotificationTimelineTest* test,
+    NotificationTimeline* timeline,
+    uint32_t end) {
+    uint32_t timeout = notification_timeline_process(timeline, test->now);
+    while(timeout != NOTIFICATION_TIMELINE_IDLE && test->now + timeout <= end) {
+        test->now += timeout;
+        timeout = notification_timeline_process(timeline, test->now);
+    }
+    test->now = end;
+}
+
+static void notification_timeline_test_check(
+    NotificationTimelineTest* test,
+    const NotificationTimelineTestEvent* expected,
+    size_t count) {
+    mu_assert_int_eq(count, test->events_count);
+    for(size_t i = 0; i < count; i++) {
+        mu_assert_int_eq(expected[i].time, test->events[i].time);
+        mu_assert_int_eq(expected[i].channel, test->events[i].channel);
+        mu_assert_int_eq(expected[i].value, test->events[i].value);
+        mu_assert_int_eq(expected[i].reset, test->events[i].reset);
+    }
+}
+
+MU_TEST(notification_timeline_merge_test) {
+    NotificationTimelineTest test;
+    NotificationTimeline* timeline = notification_timeline_test_alloc(&test);
+
+    // Blink comes while melody plays
+    notification_timeline_test_add(&test, timeline, &test_melody, 1);
+    notification_timeline_test_run(&test, timeline, 20);
+    notification_timeline_test_add(&test, timeline, &test_blink, 2);
+    mu_assert_int_eq(2, notification_timeline_get_track_count(timeline));
+    notification_timeline_test_run(&test, timeline, 1000);
+
+    const NotificationTimelineTestEvent expected[] = {
+        {0, NotificationChannelSpeaker, 1, false},
+        {20, NotificationChannelRed, 0xFF, false},
+        {20, NotificationChannelGreen, 0x00, false},
+        {20, NotificationChannelBlue, 0x00, false},
+        {50, NotificationChannelSpeaker, 1, false},
+        {100, NotificationChannelSpeaker, 1, false},
+        {120, NotificationChannelRed, 0, true},
+        {120, NotificationChannelGreen, 0, true},
+        {120, NotificationChannelBlue, 0, true},
+        {150, NotificationChannelSpeaker, 0, false},
+        {150, NotificationChannelSpeaker, 0, true},
+    };
+    notification_timeline_test_check(&test, expected, COUNT_OF(expected));
+
+    // Blink is shown as soon as it comes, not after the melody
+    uint32_t latency = test.events[1].time - 20;
+    FURI_LOG_I(
+        TAG,
+        "Blink latency %lums, completed at %lums. Melody completed at %lums",
+        latency,
+        test.complete_time[2],
+        test.complete_time[1]);
+    mu_assert_int_eq(0, latency);
+    mu_assert_int_eq(120, test.complete_time[2]);
+    mu_assert_int_eq(150, test.complete_time[1]);
+    mu_assert_int_eq(0, notification_timeline_get_track_count(timeline));
+
+    notification_timeline_free(timeline);
+}
+
+MU_TEST(notification_timeline_preempt_test) {
+    NotificationTimelineTest test;
+    NotificationTimeline* timeline = notification_timeline_test_alloc(&test);
+
+    // Newer sequence takes vibro over, older one doesn't switch it off
+    notification_timeline_test_add(&test, timeline, &test_vibro, 1);
+    notification_timeline_test_run(&test, timeline, 30);
+    notification_timeline_test_add(&test, timeline, &test_vibro, 2);
+    notification_timeline_test_run(&test, timeline, 1000);
+
+    const NotificationTimelineTestEvent expected[] = {
+        {0, NotificationChannelVibro, 1, false},
+        {30, NotificationChannelVibro, 1, false},
+        {130, NotificationChannelVibro, 0, false},
+        {130, NotificationChannelVibro, 0, true},
+    };
+    notification_timeline_test_check(&test, expected, COUNT_OF(expected));
+    mu_assert_int_eq(100, test.complete_time[1]);
+    mu_assert_int_eq(130, test.complete_time[2]);
+
+    notification_timeline_free(timeline);
+}
+
+MU_TEST(notification_timeline_priority_test) {
+    NotificationTimelineTest test;
+    NotificationTimeline* timeline = notification_timeline_test_alloc(&test);
+
+    // Beep can't take speaker from high priority melody
+    notification_timeline_test_add(&test, timeline, &test_melody_high, 1);
+    notification_timeline_test_run(&test, timeline, 20);
+    notification_timeline_test_add(&test, timeline, &test_beep, 2);
+    notification_timeline_test_run(&test, timeline, 1000);
+
+    const NotificationTimelineTestEvent expected[] = {
+        {0, NotificationChannelSpeaker, 1, false},
+        {100, NotificationChannelSpeaker, 0, false},
+        {100, NotificationChannelSpeaker, 0, true},
+    };
+    notification_timeline_test_check(&test, expected, COUNT_OF(expected));
+    mu_assert_int_eq(30, test.complete_time[2]);
+    mu_assert_int_eq(100, test.complete_time[1]);
+
+    notification_timeline_free(timeline);
+}
+
+MU_TEST(notification_timeline_led_internal_test) {
+    NotificationTimelineTest test;
+    NotificationTimeline* timeline = notification_timeline_test_alloc(&test);
+    test.led_internal_on = true;
+
+    // Leds are off for a moment, then delay starts
+    notification_timeline_test_add(&test, timeline, &test_blink, 1);
+    notification_timeline_test_run(&test, timeline, 1000);
+
+    const NotificationTimelineTestEvent expected[] = {
+        {0, NotificationChannelRed, 0x00, false},
+        {0, NotificationChannelGreen, 0x00, false},
+        {0, NotificationChannelBlue, 0x00, false},
+        {100, NotificationChannelRed, 0xFF, false},
+        {100, NotificationChannelGreen, 0x00, false},
+        {100, NotificationChannelBlue, 0x00, false},
+        {200, NotificationChannelRed, 0, true},
+        {200, NotificationChannelGreen, 0, true},
+        {200, NotificationChannelBlue, 0, true},
+    };
+    notification_timeline_test_check(&test, expected, COUNT_OF(expected));
+    mu_assert_int_eq(200, test.complete_time[1]);
+
+    notification_timeline_free(timeline);
+}
+
+MU_TEST(notification_timeline_overflow_test) {
+    NotificationTimelineTest test;
+    NotificationTimeline* timeline = notification_timeline_test_alloc(&test);
+
+    // Oldest track is finished to make room
+    for(size_t i = 0; i <= NOTIFICATION_TIMELINE_TRACKS; i++) {
+        notification_timeline_test_add(&test, timeline, &test_melody, i);
+        notification_timeline_test_run(&test, timeline, test.now + 1);
+    }
+    mu_assert_int_eq(
+        NOTIFICATION_TIMELINE_TRACKS, notification_timeline_get_track_count(timeline));
+    mu_assert_int_eq(1, test.complete_count);
+    mu_assert_int_eq(NOTIFICATION_TIMELINE_TRACKS, test.complete_time[0]);
+
+    notification_timeline_free(timeline);
+}
+
+MU_TEST_SUITE(notification_timeline_suite) {
+    MU_RUN_TEST(notification_timeline_merge_test);
+    MU_RUN_TEST(notification_timeline_preempt_test);
+    MU_RUN_TEST(notification_timeline_priority_test);
+    MU_RUN_TEST(notification_timeline_led_internal_test);
+    MU_RUN_TEST(notification_timeline_overflow_test);
+}
+
+int run_minunit_test_notification_timeline() {
+    MU_RUN_SUITE(notification_timeline_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,130 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <maxim_crc.h>
+#include "../minunit.h"
+
+#define TAG "MaximCrcTest"
+
+static const size_t maxim_crc_test_buffer_size = 4096;
+
+// Bit at a time reference implementation
+static uint8_t maxim_crc_test_crc8_reference(const uint8_t* data, size_t data_size, uint8_t crc) {
+    for(size_t index = 0; index < data_size; ++index) {
+        uint8_t input_byte = data[index];
+        for(uint8_t bit_position = 0; bit_position < 8; ++bit_position) {
+            const uint8_t mix = (crc ^ input_byte) & 0x01;
+            crc >>= 1;
+            if(mix != 0) crc ^= 0x8C;
+            input_byte >>= 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t
+    maxim_crc_test_crc16_reference(const uint8_t* data, size_t data_size, uint16_t crc) {
+    for(size_t index = 0; index < data_size; ++index) {
+        crc ^= data[index];
+        for(uint8_t bit_position = 0; bit_position < 8; ++bit_position) {
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ 0xA001) : (crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static float maxim_crc_test_mbps(uint32_t cycles, size_t size) {
+    return (float)size * SystemCoreClock / cycles / (1024 * 1024);
+}
+
+MU_TEST(maxim_crc_cross_check_test) {
+    uint8_t* buffer = static_cast<uint8_t*>(malloc(maxim_crc_test_buffer_size));
+    furi_hal_random_fill_buf(buffer, maxim_crc_test_buffer_size);
+
+    // Every length up to 64, then a few long ones
+    for(size_t size = 0; size < 64; size++) {
+        uint8_t crc8_init = buffer[size];
+        uint16_t crc16_init = buffer[size] << 8 | buffer[size + 1];
+        mu_assert_int_eq(
+            maxim_crc_test_crc8_reference(buffer, size, crc8_init),
+            maxim_crc8(buffer, size, crc8_init));
+        mu_assert_int_eq(
+            maxim_crc_test_crc16_reference(buffer, size, crc16_init),
+            maxim_crc16(buffer, size, crc16_init));
+        mu_assert_int_eq(
+            maxim_crc_test_crc16_reference(&buffer[size], 1, crc16_init),
+            maxim_crc16(buffer[size], crc16_init));
+    }
+    mu_assert_int_eq(
+        maxim_crc_test_crc8_reference(buffer, maxim_crc_test_buffer_size, 0),
+        maxim_crc8(buffer, maxim_crc_test_buffer_size));
+    mu_assert_int_eq(
+        maxim_crc_test_crc16_reference(buffer, maxim_crc_test_buffer_size, 0),
+        maxim_crc16(buffer, maxim_crc_test_buffer_size));
+
+    free(buffer);
+}
+
+MU_TEST(maxim_crc_verify_roms_test) {
+    uint8_t roms[3][MAXIM_ROM_SIZE] = {
+        {0x01, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0x00},
+        {0x28, 0xFF, 0x4B, 0x1A, 0x61, 0x16, 0x04, 0x00},
+        {0x01, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0x00},
+    };
+    bool valid[3];
+
+    roms[0][7] = maxim_crc8(roms[0], 7);
+    roms[1][7] = maxim_crc8(roms[1], 7);
+    roms[2][7] = roms[0][7] ^ 0x01;
+
+    mu_assert_int_eq(2, maxim_crc8_verify_roms(&roms[0][0], 3, valid));
+    mu_check(valid[0]);
+    mu_check(valid[1]);
+    mu_check(!valid[2]);
+}
+
+MU_TEST(maxim_crc_benchmark_test) {
+    uint8_t* buffer = static_cast<uint8_t*>(malloc(maxim_crc_test_buffer_size));
+    furi_hal_random_fill_buf(buffer, maxim_crc_test_buffer_size);
+    volatile uint16_t crc;
+
+    uint32_t cycles = DWT->CYCCNT;
+    crc = maxim_crc_test_crc8_reference(buffer, maxim_crc_test_buffer_size, 0);
+    uint32_t crc8_reference_cycles = DWT->CYCCNT - cycles;
+
+    cycles = DWT->CYCCNT;
+    crc = maxim_crc8(buffer, maxim_crc_test_buffer_size);
+    uint32_t crc8_cycles = DWT->CYCCNT - cycles;
+
+    cycles = DWT->CYCCNT;
+    crc = maxim_crc_test_crc16_reference(buffer, maxim_crc_test_buffer_size, 0);
+    uint32_t crc16_reference_cycles = DWT->CYCCNT - cycles;
+
+    cycles = DWT->CYCCNT;
+    crc = maxim_crc16(buffer, maxim_crc_test_buffer_size);
+    uint32_t crc16_cycles = DWT->CYCCNT - cycles;
+    (void)crc;
+
+    FURI_LOG_I(
+        TAG,
+        "CRC8 %0.2f MB/s (bitwise %0.2f MB/s), CRC16 %0.2f MB/s (bitwise %0.2f MB/s)",
+        maxim_crc_test_mbps(crc8_cycles, maxim_crc_test_buffer_size),
+        maxim_crc_test_mbps(crc8_reference_cycles, maxim_crc_test_buffer_size),
+        maxim_crc_test_mbps(crc16_cycles, maxim_crc_test_buffer_size),
+        maxim_crc_test_mbps(crc16_reference_cycles, maxim_crc_test_buffer_size));
+
+    mu_check(crc8_cycles < crc8_reference_cycles);
+    mu_check(crc16_cycles < crc16_reference_cycles);
+
+    free(buffer);
+}
+
+MU_TEST_SUITE(maxim_crc_suite) {
+    MU_RUN_TEST(maxim_crc_cross_check_test);
+    MU_RUN_TEST(maxim_crc_verify_roms_test);
+    MU_RUN_TEST(maxim_crc_benchmark_test);
+}
+
+extern "C" int run_minunit_test_maxim_crc() {
+    MU_RUN_SUITE(maxim_crc_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,705 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_hal_sd.h>
+#include <storage/storage.h>
+#include <stm32_adafruit_sd.h>
+#include "../minunit.h"
+
+#define TAG "SdSpiTest"
+
+#define SD_SPI_TEST_BLOCKS (16)
+#define SD_SPI_TEST_OUT_SIZE (SD_BLOCK_SIZE + 16)
+#define SD_SPI_TEST_BUSY_BYTES (4)
+#define SD_SPI_TEST_PERSISTENT UINT32_MAX
+// Bus model for estimates: 16MHz clock, CS guard times of SD_IO_CSState
+#define SD_SPI_TEST_BYTE_NS (500)
+#define SD_SPI_TEST_SELECT_NS (20000)
+#define SD_SPI_TEST_CARD_BLOCKS (64)
+#define SD_SPI_TEST_CARD_RUN (16)
+#define SD_SPI_TEST_DMA_BLOCKS (4)
+
+typedef enum {
+    SdSpiTestFaultNone,
+    SdSpiTestFaultReadCrc, // Block goes out with bad CRC
+    SdSpiTestFaultReadToken, // Error token instead of block
+    SdSpiTestFaultWriteCrc, // Block is damaged on its way to card
+    SdSpiTestFaultWriteError, // Card fails to program block
+} SdSpiTestFault;
+
+typedef enum {
+    SdSpiTestStateIdle,
+    SdSpiTestStateCommand,
+    SdSpiTestStateWriteToken,
+    SdSpiTestStateWriteData,
+} SdSpiTestState;
+
+// SD card in SPI mode, byte by byte: output byte is chosen before input byte is seen
+typedef struct {
+    uint8_t* disk;
+    bool sdhc;
+    bool crc;
+    bool selected;
+    bool app_cmd;
+    SdSpiTestState state;
+    uint8_t frame[6];
+    size_t frame_size;
+    // Write
+    bool write_multiple;
+    uint32_t write_block;
+    uint8_t write_data[SD_BLOCK_SIZE + 2];
+    size_t write_size;
+    // Read
+    bool read_multiple;
+    uint32_t read_block;
+    // Data line, 0xFF when empty
+    uint8_t out[SD_SPI_TEST_OUT_SIZE];
+    size_t out_size;
+    size_t out_pos;
+    // Fault injection
+    SdSpiTestFault fault;
+    uint32_t fault_block;
+    uint32_t fault_count;
+    // Stats
+    uint32_t commands[64];
+    uint32_t app_commands[64];
+    uint32_t erase_count;
+    uint32_t crc_errors;
+    uint32_t bytes;
+    uint32_t selects;
+} SdSpiTestCard;
+
+typedef struct {
+    SdSpiTestCard* card;
+    uint16_t sdhc;
+    uint8_t crc;
+    bool card_mounted;
+} SdSpiTest;
+
+static SdSpiTest sd_spi_test = {0};
+
+static uint8_t sd_spi_test_crc7(const uint8_t* data, size_t size) {
+    uint8_t crc = 0;
+    for(size_t i = 0; i < size * 8; i++) {
+        uint8_t bit = ((data[i / 8] >> (7 - i % 8)) & 1) ^ (crc >> 6);
+        crc = (crc << 1) & 0x7F;
+        if(bit) crc ^= 0x09;
+    }
+    return crc;
+}
+
+static uint16_t sd_spi_test_crc16(const uint8_t* data, size_t size) {
+    uint16_t crc = 0;
+    for(size_t i = 0; i < size; i++) {
+        crc ^= data[i] << 8;
+        for(size_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static bool sd_spi_test_card_fault(SdSpiTestCard* card, SdSpiTestFault fault, uint32_t block) {
+    if(card->fault != fault || card->fault_block != block || card->fault_count == 0) return false;
+    if(card->fault_count != SD_SPI_TEST_PERSISTENT) card->fault_count--;
+    return true;
+}
+
+static void sd_spi_test_card_put(SdSpiTestCard* card, uint8_t data) {
+    furi_check(card->out_size < SD_SPI_TEST_OUT_SIZE);
+    card->out[card->out_size++] = data;
+}
+
+static void sd_spi_test_card_r1(SdSpiTestCard* card, uint8_t r1) {
+    // One byte of NCR
+    sd_spi_test_card_put(card, 0xFF);
+    sd_spi_test_card_put(card, r1);
+}
+
+static void sd_spi_test_card_busy(SdSpiTestCard* card) {
+    for(size_t i = 0; i < SD_SPI_TEST_BUSY_BYTES; i++) {
+        sd_spi_test_card_put(card, 0x00);
+    }
+}
+
+static void sd_spi_test_card_send_block(SdSpiTestCard* card) {
+    uint32_t block = card->read_block++;
+    // Access time
+    sd_spi_test_card_put(card, 0xFF);
+
+    if(block >= SD_SPI_TEST_BLOCKS) {
+        // Out of range error token
+        sd_spi_test_card_put(card, 0x08);
+        card->read_multiple = false;
+    } else if(sd_spi_test_card_fault(card, SdSpiTestFaultReadToken, block)) {
+        // Card ECC failed error token
+        sd_spi_test_card_put(card, 0x04);
+        card->read_multiple = false;
+    } else {
+        const uint8_t* data = &card->disk[block * SD_BLOCK_SIZE];
+        uint16_t crc = sd_spi_test_crc16(data, SD_BLOCK_SIZE);
+        if(sd_spi_test_card_fault(card, SdSpiTestFaultReadCrc, block)) crc ^= 0x0100;
+        sd_spi_test_card_put(card, 0xFE);
+        memcpy(&card->out[card->out_size], data, SD_BLOCK_SIZE);
+        card->out_size += SD_BLOCK_SIZE;
+        sd_spi_test_card_put(card, crc >> 8);
+        sd_spi_test_card_put(card, crc);
+    }
+}
+
+static void sd_spi_test_card_write_block(SdSpiTestCard* card) {
+    uint32_t block = card->write_block;
+    uint16_t crc = (card->write_data[SD_BLOCK_SIZE] << 8) | card->write_data[SD_BLOCK_SIZE + 1];
+    if(sd_spi_test_card_fault(card, SdSpiTestFaultWriteCrc, block)) card->write_data[0] ^= 0x01;
+
+    // Data response xxx0sss1
+    if(card->crc && crc != sd_spi_test_crc16(card->write_data, SD_BLOCK_SIZE)) {
+        sd_spi_test_card_put(card, 0xEB);
+    } else if(
+        block >= SD_SPI_TEST_BLOCKS ||
+        sd_spi_test_card_fault(card, SdSpiTestFaultWriteError, block)) {
+        sd_spi_test_card_put(card, 0xED);
+    } else {
+        memcpy(&card->disk[block * SD_BLOCK_SIZE], card->write_data, SD_BLOCK_SIZE);
+        card->write_block++;
+        sd_spi_test_card_put(card, 0xE5);
+        sd_spi_test_card_busy(card);
+    }
+
+    card->state = card->write_multiple ? SdSpiTestStateWriteToken : SdSpiTestStateIdle;
+}
+
+static bool sd_spi_test_card_address(SdSpiTestCard* card, uint32_t arg, uint32_t* block) {
+    if(!card->sdhc && (arg % SD_BLOCK_SIZE)) return false;
+    *block = card->sdhc ? arg : arg / SD_BLOCK_SIZE;
+    return *block < SD_SPI_TEST_BLOCKS;
+}
+
+static void sd_spi_test_card_command(SdSpiTestCard* card) {
+    uint8_t cmd = card->frame[0] & 0x3F;
+    uint32_t arg = ((uint32_t)card->frame[1] << 24) | (card->frame[2] << 16) |
+                   (card->frame[3] << 8) | card->frame[4];
+    bool app_cmd = card->app_cmd;
+    card->app_cmd = false;
+    // New command takes over data line
+    card->out_size = 0;
+    card->out_pos = 0;
+
+    // CMD0 and CMD8 are checked even with CRC off
+    bool crc_checked = card->crc || cmd == 0 || cmd == 8;
+    uint8_t crc = (sd_spi_test_crc7(card->frame, 5) << 1) | 1;
+    if(crc_checked && card->frame[5] != crc) {
+        card->crc_errors++;
+        sd_spi_test_card_r1(card, 0x08);
+        return;
+    }
+
+    if(app_cmd) {
+        card->app_commands[cmd]++;
+    } else {
+        card->commands[cmd]++;
+    }
+
+    uint32_t block;
+    if(app_cmd && cmd == 23) {
+        card->erase_count = arg;
+        sd_spi_test_card_r1(card, 0x00);
+    } else if(cmd == 0) {
+        card->crc = false;
+        sd_spi_test_card_r1(card, 0x01);
+    } else if(cmd == 12) {
+        card->read_multiple = false;
+        // Stuff byte is whatever card was sending
+        sd_spi_test_card_put(card, 0x5A);
+        sd_spi_test_card_r1(card, 0x00);
+        sd_spi_test_card_busy(card);
+    } else if(cmd == 13) {
+        sd_spi_test_card_r1(card, 0x00);
+        sd_spi_test_card_put(card, 0x00);
+    } else if(cmd == 16) {
+        sd_spi_test_card_r1(card, (arg == SD_BLOCK_SIZE) ? 0x00 : 0x40);
+    } else if(cmd == 17 || cmd == 18) {
+        if(sd_spi_test_card_address(card, arg, &block)) {
+            sd_spi_test_card_r1(card, 0x00);
+            card->read_block = block;
+            card->read_multiple = (cmd == 18);
+            sd_spi_test_card_send_block(card);
+        } else {
+            sd_spi_test_card_r1(card, 0x20);
+        }
+    } else if(cmd == 24 || cmd == 25) {
+        if(sd_spi_test_card_address(card, arg, &block)) {
+            sd_spi_test_card_r1(card, 0x00);
+            card->write_block = block;
+            card->write_multiple = (cmd == 25);
+            card->state = SdSpiTestStateWriteToken;
+        } else {
+            sd_spi_test_card_r1(card, 0x20);
+        }
+    } else if(cmd == 55) {
+        card->app_cmd = true;
+        sd_spi_test_card_r1(card, 0x00);
+    } else if(cmd == 59) {
+        card->crc = arg & 1;
+        sd_spi_test_card_r1(card, 0x00);
+    } else {
+        sd_spi_test_card_r1(card, 0x04);
+    }
+}
+
+static void sd_spi_test_card_input(SdSpiTestCard* card, uint8_t data) {
+    switch(card->state) {
+    case SdSpiTestStateIdle:
+        // Start bit 0, transmission bit 1
+        if((data & 0xC0) == 0x40) {
+            card->frame[0] = data;
+            card->frame_size = 1;
+            card->state = SdSpiTestStateCommand;
+        }
+        break;
+    case SdSpiTestStateCommand:
+        card->frame[card->frame_size++] = data;
+        if(card->frame_size == sizeof(card->frame)) {
+            card->state = SdSpiTestStateIdle;
+            sd_spi_test_card_command(card);
+        }
+        break;
+    case SdSpiTestStateWriteToken:
+        if(data == (card->write_multiple ? 0xFC : 0xFE)) {
+            card->write_size = 0;
+            card->state = SdSpiTestStateWriteData;
+        } else if(card->write_multiple && data == 0xFD) {
+            // Stuff byte, then busy
+            sd_spi_test_card_put(card, 0xFF);
+            sd_spi_test_card_busy(card);
+            card->state = SdSpiTestStateIdle;
+        }
+        break;
+    case SdSpiTestStateWriteData:
+        card->write_data[card->write_size++] = data;
+        if(card->write_size == sizeof(card->write_data)) {
+            card->out_size = 0;
+            card->out_pos = 0;
+            sd_spi_test_card_write_block(card);
+        }
+        break;
+    }
+}
+
+static uint8_t sd_spi_test_card_byte(SdSpiTestCard* card, uint8_t data) {
+    uint8_t out = 0xFF;
+    card->bytes++;
+    if(!card->selected) return out;
+
+    if(card->out_pos == card->out_size) {
+        card->out_size = 0;
+        card->out_pos = 0;
+        if(card->read_multiple) sd_spi_test_card_send_block(card);
+    }
+    if(card->out_pos < card->out_size) {
+        out = card->out[card->out_pos++];
+    }
+
+    sd_spi_test_card_input(card, data);
+    return out;
+}
+
+static void sd_spi_test_card_cs(bool selected, void* context) {
+    SdSpiTestCard* card = context;
+    if(selected && !card->selected) card->selects++;
+    card->selected = selected;
+    if(!selected) {
+        card->out_size = 0;
+        card->out_pos = 0;
+        card->read_multiple = false;
+        card->state = SdSpiTestStateIdle;
+    }
+}
+
+static void sd_spi_test_card_trx(
+    const uint8_t* data_in,
+    uint8_t* data_out,
+    uint16_t size,
+    void* context) {
+    SdSpiTestCard* card = context;
+    for(size_t i = 0; i < size; i++) {
+        uint8_t out = sd_spi_test_card_byte(card, data_in ? data_in[i] : 0xFF);
+        if(data_out) data_out[i] = out;
+    }
+}
+
+static void sd_spi_test_card_reset(SdSpiTestCard* card, bool sdhc, bool crc) {
+    uint8_t* disk = card->disk;
+    memset(card, 0, sizeof(SdSpiTestCard));
+    card->disk = disk;
+    card->sdhc = sdhc;
+    card->crc = crc;
+    memset(card->disk, 0, SD_SPI_TEST_BLOCKS * SD_BLOCK_SIZE);
+    // Driver mode as BSP_SD_Init would leave it
+    flag_SDHC = sdhc;
+    flag_CRC = crc;
+}
+
+static void sd_spi_test_card_fault_set(
+    SdSpiTestCard* card,
+    SdSpiTestFault fault,
+    uint32_t block,
+    uint32_t count) {
+    card->fault = fault;
+    card->fault_block = block;
+    card->fault_count = count;
+}
+
+static void sd_spi_test_card_stats_reset(SdSpiTestCard* card) {
+    memset(card->commands, 0, sizeof(card->commands));
+    memset(card->app_commands, 0, sizeof(card->app_commands));
+    card->erase_count = 0;
+    card->crc_errors = 0;
+    card->bytes = 0;
+    card->selects = 0;
+}
+
+static void sd_spi_test_fill(uint8_t* data, size_t blocks, uint8_t seed) {
+    for(size_t i = 0; i < blocks * SD_BLOCK_SIZE; i++) {
+        data[i] = (i * 7 + seed) ^ (i >> 9);
+    }
+}
+
+static SD_IO_Link sd_spi_test_link = {
+    .cs = sd_spi_test_card_cs,
+    .trx = sd_spi_test_card_trx,
+    .context = NULL,
+};
+
+static void sd_spi_test_setup() {
+    sd_spi_test.card = malloc(sizeof(SdSpiTestCard));
+    sd_spi_test.card->disk = malloc(SD_SPI_TEST_BLOCKS * SD_BLOCK_SIZE);
+
+    // Bus is held for the whole test: nobody else may talk to the card while link is set
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
+    furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
+    sd_spi_test.sdhc = flag_SDHC;
+    sd_spi_test.crc = flag_CRC;
+
+    sd_spi_test_link.context = sd_spi_test.card;
+    SD_IO_SetLink(&sd_spi_test_link);
+}
+
+static void sd_spi_test_teardown() {
+    SD_IO_SetLink(NULL);
+    flag_SDHC = sd_spi_test.sdhc;
+    flag_CRC = sd_spi_test.crc;
+    furi_hal_sd_spi_handle = NULL;
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_sd_fast);
+
+    free(sd_spi_test.card->disk);
+    free(sd_spi_test.card);
+}
+
+MU_TEST(sd_spi_test_transfer) {
+    SdSpiTestCard* card = sd_spi_test.card;
+    uint8_t* data = malloc(8 * SD_BLOCK_SIZE);
+    uint8_t* read = malloc(8 * SD_BLOCK_SIZE);
+    sd_spi_test_card_reset(card, true, true);
+    sd_spi_test_fill(data, 8, 0x11);
+
+    // Run of blocks is one command, card gets erase hint
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_WriteBlocks((uint32_t*)data, 3, 8, SD_DATATIMEOUT));
+    mu_check(memcmp(data, &card->disk[3 * SD_BLOCK_SIZE], 8 * SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(1, card->commands[16]);
+    mu_assert_int_eq(1, card->app_commands[23]);
+    mu_assert_int_eq(8, card->erase_count);
+    mu_assert_int_eq(1, card->commands[25]);
+    mu_assert_int_eq(0, card->commands[24]);
+    mu_assert_int_eq(0, card->crc_errors);
+
+    sd_spi_test_card_stats_reset(card);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)read, 3, 8, SD_DATATIMEOUT));
+    mu_check(memcmp(data, read, 8 * SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(1, card->commands[16]);
+    mu_assert_int_eq(1, card->commands[18]);
+    mu_assert_int_eq(1, card->commands[12]);
+    mu_assert_int_eq(0, card->commands[17]);
+    mu_assert_int_eq(0, card->commands[13]);
+
+    // Single block keeps single block commands
+    sd_spi_test_card_stats_reset(card);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_WriteBlocks((uint32_t*)data, 15, 1, SD_DATATIMEOUT));
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)read, 15, 1, SD_DATATIMEOUT));
+    mu_check(memcmp(data, read, SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(1, card->commands[24]);
+    mu_assert_int_eq(1, card->commands[17]);
+    mu_assert_int_eq(0, card->commands[12]);
+    mu_assert_int_eq(0, card->app_commands[23]);
+
+    // Out of range
+    mu_assert_int_eq(
+        BSP_SD_ERROR,
+        BSP_SD_ReadBlocks((uint32_t*)read, SD_SPI_TEST_BLOCKS, 1, SD_DATATIMEOUT));
+    mu_assert_int_eq(0, card->crc_errors);
+
+    free(read);
+    free(data);
+}
+
+MU_TEST(sd_spi_test_standard_capacity) {
+    SdSpiTestCard* card = sd_spi_test.card;
+    uint8_t* data = malloc(4 * SD_BLOCK_SIZE);
+    uint8_t* read = malloc(4 * SD_BLOCK_SIZE);
+    sd_spi_test_card_reset(card, false, false);
+    sd_spi_test_fill(data, 4, 0x22);
+
+    // Byte addressing, no data CRC check
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_WriteBlocks((uint32_t*)data, 5, 4, SD_DATATIMEOUT));
+    mu_check(memcmp(data, &card->disk[5 * SD_BLOCK_SIZE], 4 * SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)read, 5, 4, SD_DATATIMEOUT));
+    mu_check(memcmp(data, read, 4 * SD_BLOCK_SIZE) == 0);
+
+    // Bad CRC passes unnoticed
+    sd_spi_test_card_fault_set(card, SdSpiTestFaultReadCrc, 6, 1);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)read, 5, 4, SD_DATATIMEOUT));
+    mu_assert_int_eq(0, card->fault_count);
+
+    free(read);
+    free(data);
+}
+
+MU_TEST(sd_spi_test_recovery) {
+    SdSpiTestCard* card = sd_spi_test.card;
+    uint8_t* data = malloc(8 * SD_BLOCK_SIZE);
+    uint8_t* read = malloc(8 * SD_BLOCK_SIZE);
+    sd_spi_test_card_reset(card, true, true);
+    sd_spi_test_fill(data, 8, 0x33);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_WriteBlocks((uint32_t*)data, 2, 8, SD_DATATIMEOUT));
+
+    // Bad CRC: read goes on from failed block
+    sd_spi_test_card_stats_reset(card);
+    sd_spi_test_card_fault_set(card, SdSpiTestFaultReadCrc, 5, 1);
+    memset(read, 0, 8 * SD_BLOCK_SIZE);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)read, 2, 8, SD_DATATIMEOUT));
+    mu_check(memcmp(data, read, 8 * SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(2, card->commands[18]);
+    mu_assert_int_eq(2, card->commands[12]);
+    mu_assert_int_eq(1, card->commands[13]);
+
+    // Error token, twice
+    sd_spi_test_card_stats_reset(card);
+    sd_spi_test_card_fault_set(card, SdSpiTestFaultReadToken, 4, 2);
+    memset(read, 0, 8 * SD_BLOCK_SIZE);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)read, 2, 8, SD_DATATIMEOUT));
+    mu_check(memcmp(data, read, 8 * SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(3, card->commands[18]);
+
+    // Block that never reads gives up after a bounded number of tries
+    sd_spi_test_card_stats_reset(card);
+    sd_spi_test_card_fault_set(card, SdSpiTestFaultReadCrc, 6, SD_SPI_TEST_PERSISTENT);
+    mu_assert_int_eq(BSP_SD_ERROR, BSP_SD_ReadBlocks((uint32_t*)read, 2, 8, SD_DATATIMEOUT));
+    mu_assert_int_eq(3, card->commands[18]);
+    mu_check(memcmp(data, read, 4 * SD_BLOCK_SIZE) == 0);
+
+    // Damaged on the wire: card refuses block, rest is written again
+    sd_spi_test_card_reset(card, true, true);
+    sd_spi_test_card_fault_set(card, SdSpiTestFaultWriteCrc, 7, 1);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_WriteBlocks((uint32_t*)data, 4, 8, SD_DATATIMEOUT));
+    mu_check(memcmp(data, &card->disk[4 * SD_BLOCK_SIZE], 8 * SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(2, card->commands[25]);
+    mu_assert_int_eq(2, card->app_commands[23]);
+    mu_assert_int_eq(5, card->erase_count);
+    mu_assert_int_eq(1, card->commands[13]);
+
+    // Write error that stays
+    sd_spi_test_card_stats_reset(card);
+    sd_spi_test_card_fault_set(card, SdSpiTestFaultWriteError, 0, SD_SPI_TEST_PERSISTENT);
+    mu_assert_int_eq(BSP_SD_ERROR, BSP_SD_WriteBlocks((uint32_t*)data, 0, 1, SD_DATATIMEOUT));
+    mu_assert_int_eq(3, card->commands[24]);
+
+    // Card is usable afterwards
+    sd_spi_test_card_fault_set(card, SdSpiTestFaultNone, 0, 0);
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_WriteBlocks((uint32_t*)data, 0, 2, SD_DATATIMEOUT));
+    mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)read, 0, 2, SD_DATATIMEOUT));
+    mu_check(memcmp(data, read, 2 * SD_BLOCK_SIZE) == 0);
+    mu_assert_int_eq(0, card->crc_errors);
+
+    free(read);
+    free(data);
+}
+
+static uint32_t sd_spi_test_estimate_kbps(SdSpiTestCard* card, size_t size) {
+    uint64_t time_ns = (uint64_t)card->bytes * SD_SPI_TEST_BYTE_NS +
+                       (uint64_t)card->selects * SD_SPI_TEST_SELECT_NS;
+    return (uint64_t)size * 1000000000 / 1024 / time_ns;
+}
+
+MU_TEST(sd_spi_test_benchmark) {
+    SdSpiTestCard* card = sd_spi_test.card;
+    const size_t size = SD_SPI_TEST_BLOCKS * SD_BLOCK_SIZE;
+    uint8_t* data = malloc(size);
+    sd_spi_test_card_reset(card, true, true);
+
+    // Bus traffic, one call per block vs one call
+    sd_spi_test_card_stats_reset(card);
+    for(size_t i = 0; i < SD_SPI_TEST_BLOCKS; i++) {
+        BSP_SD_ReadBlocks((uint32_t*)&data[i * SD_BLOCK_SIZE], i, 1, SD_DATATIMEOUT);
+    }
+    uint32_t single_bytes = card->bytes;
+    uint32_t single_selects = card->selects;
+    uint32_t single_kbps = sd_spi_test_estimate_kbps(card, size);
+
+    sd_spi_test_card_stats_reset(card);
+    BSP_SD_ReadBlocks((uint32_t*)data, 0, SD_SPI_TEST_BLOCKS, SD_DATATIMEOUT);
+    uint32_t multiple_bytes = card->bytes;
+    uint32_t multiple_selects = card->selects;
+    uint32_t multiple_kbps = sd_spi_test_estimate_kbps(card, size);
+
+    FURI_LOG_I(
+        TAG,
+        "Read %u blocks, single: %lu B %lu CS ~%lu KB/s, multiple: %lu B %lu CS ~%lu KB/s",
+        SD_SPI_TEST_BLOCKS,
+        single_bytes,
+        single_selects,
+        single_kbps,
+        multiple_bytes,
+        multiple_selects,
+        multiple_kbps);
+    mu_check(multiple_bytes < single_bytes);
+    mu_check(multiple_selects < single_selects);
+
+    sd_spi_test_card_stats_reset(card);
+    for(size_t i = 0; i < SD_SPI_TEST_BLOCKS; i++) {
+        BSP_SD_WriteBlocks((uint32_t*)&data[i * SD_BLOCK_SIZE], i, 1, SD_DATATIMEOUT);
+    }
+    single_bytes = card->bytes;
+    single_kbps = sd_spi_test_estimate_kbps(card, size);
+
+    sd_spi_test_card_stats_reset(card);
+    BSP_SD_WriteBlocks((uint32_t*)data, 0, SD_SPI_TEST_BLOCKS, SD_DATATIMEOUT);
+    multiple_bytes = card->bytes;
+    multiple_kbps = sd_spi_test_estimate_kbps(card, size);
+
+    FURI_LOG_I(
+        TAG,
+        "Write %u blocks, single: %lu B ~%lu KB/s, multiple: %lu B ~%lu KB/s",
+        SD_SPI_TEST_BLOCKS,
+        single_bytes,
+        single_kbps,
+        multiple_bytes,
+        multiple_kbps);
+    mu_check(multiple_bytes < single_bytes);
+
+    free(data);
+}
+
+MU_TEST(sd_spi_test_dma) {
+    // Real bus, card is deselected and ignores clock
+    FuriHalSpiBusHandle* handle = furi_hal_sd_spi_handle;
+    const size_t size = SD_SPI_TEST_DMA_BLOCKS * SD_BLOCK_SIZE;
+    const size_t sizes[] = {1, 2, SD_BLOCK_SIZE, size};
+    uint8_t* tx = malloc(size);
+    uint8_t* rx = malloc(size);
+    sd_spi_test_fill(tx, SD_SPI_TEST_DMA_BLOCKS, 0x5A);
+
+    for(size_t i = 0; i < COUNT_OF(sizes); i++) {
+        mu_check(furi_hal_spi_bus_trx_dma(handle, tx, rx, sizes[i], SD_DATATIMEOUT));
+        mu_check(furi_hal_spi_bus_trx_dma(handle, NULL, rx, sizes[i], SD_DATATIMEOUT));
+        mu_check(furi_hal_spi_bus_trx_dma(handle, tx, NULL, sizes[i], SD_DATATIMEOUT));
+    }
+
+    uint32_t start = DWT->CYCCNT;
+    mu_check(furi_hal_spi_bus_trx_dma(handle, tx, rx, size, SD_DATATIMEOUT));
+    uint32_t dma_cycles = DWT->CYCCNT - start;
+    start = DWT->CYCCNT;
+    mu_check(furi_hal_spi_bus_trx(handle, tx, rx, size, SD_DATATIMEOUT));
+    uint32_t polled_cycles = DWT->CYCCNT - start;
+    FURI_LOG_I(
+        TAG,
+        "Bus %u bytes, DMA: %lu us, polled: %lu us",
+        size,
+        dma_cycles / (SystemCoreClock / 1000000),
+        polled_cycles / (SystemCoreClock / 1000000));
+
+    // Polled transfers work after DMA: bus is left clean
+    mu_check(furi_hal_spi_bus_trx(handle, tx, rx, 1, SD_DATATIMEOUT));
+    free(rx);
+    free(tx);
+
+    if(!sd_spi_test.card_mounted) {
+        FURI_LOG_I(TAG, "No SD card, card DMA test skipped");
+        return;
+    }
+
+    // Real card: block CRC16 checks data that came through DMA
+    SD_IO_SetLink(NULL);
+    flag_SDHC = sd_spi_test.sdhc;
+    flag_CRC = sd_spi_test.crc;
+    mu_check(flag_CRC);
+    uint8_t* data = malloc(size);
+    uint8_t* read = malloc(size);
+    mu_assert_int_eq(
+        BSP_SD_OK, BSP_SD_ReadBlocks((uint32_t*)data, 0, SD_SPI_TEST_DMA_BLOCKS, SD_DATATIMEOUT));
+    for(size_t i = 0; i < SD_SPI_TEST_DMA_BLOCKS; i++) {
+        uint32_t* block = (uint32_t*)&read[i * SD_BLOCK_SIZE];
+        mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks(block, i, 1, SD_DATATIMEOUT));
+    }
+    mu_check(memcmp(data, read, size) == 0);
+
+    free(read);
+    free(data);
+}
+
+MU_TEST(sd_spi_test_card_benchmark) {
+    if(!sd_spi_test.card_mounted) {
+        FURI_LOG_I(TAG, "No SD card, card benchmark skipped");
+        return;
+    }
+
+    // Real card on real bus, reading only
+    SD_IO_SetLink(NULL);
+    flag_SDHC = sd_spi_test.sdhc;
+    flag_CRC = sd_spi_test.crc;
+    uint8_t* data = malloc(SD_SPI_TEST_CARD_RUN * SD_BLOCK_SIZE);
+    const uint32_t size = SD_SPI_TEST_CARD_BLOCKS * SD_BLOCK_SIZE;
+
+    uint32_t start = osKernelGetTickCount();
+    for(size_t i = 0; i < SD_SPI_TEST_CARD_BLOCKS; i++) {
+        uint32_t* block = (uint32_t*)&data[(i % SD_SPI_TEST_CARD_RUN) * SD_BLOCK_SIZE];
+        mu_assert_int_eq(BSP_SD_OK, BSP_SD_ReadBlocks(block, i, 1, SD_DATATIMEOUT));
+    }
+    uint32_t single_time = MAX(osKernelGetTickCount() - start, 1UL);
+
+    start = osKernelGetTickCount();
+    for(size_t i = 0; i < SD_SPI_TEST_CARD_BLOCKS; i += SD_SPI_TEST_CARD_RUN) {
+        mu_assert_int_eq(
+            BSP_SD_OK,
+            BSP_SD_ReadBlocks((uint32_t*)data, i, SD_SPI_TEST_CARD_RUN, SD_DATATIMEOUT));
+    }
+    uint32_t multiple_time = MAX(osKernelGetTickCount() - start, 1UL);
+
+    FURI_LOG_I(
+        TAG,
+        "Card read %lu KB, single: %lu KB/s, multiple: %lu KB/s",
+        size / 1024,
+        size * osKernelGetTickFreq() / 1024 / single_time,
+        size * osKernelGetTickFreq() / 1024 / multiple_time);
+
+    free(data);
+}
+
+MU_TEST_SUITE(sd_spi_suite) {
+    MU_SUITE_CONFIGURE(&sd_spi_test_setup, &sd_spi_test_teardown);
+
+    MU_RUN_TEST(sd_spi_test_transfer);
+    MU_RUN_TEST(sd_spi_test_standard_capacity);
+    MU_RUN_TEST(sd_spi_test_recovery);
+    MU_RUN_TEST(sd_spi_test_benchmark);
+    MU_RUN_TEST(sd_spi_test_dma);
+    MU_RUN_TEST(sd_spi_test_card_benchmark);
+}
+
+int run_minunit_test_sd_spi() {
+    // Asked before bus is taken: storage may be waiting for it
+    Storage* storage = furi_record_open("storage");
+    sd_spi_test.card_mounted = (storage_sd_status(storage) == FSE_OK);
+    furi_record_close("storage");
+
+    MU_RUN_SUITE(sd_spi_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,336 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+#include <toolbox/settings_journal.h>
+#include "../minunit.h"
+
+#define TAG "SettingsJournalTest"
+
+#define SETTINGS_JOURNAL_TEST_PATH "/int/.unit_test.journal"
+#define SETTINGS_JOURNAL_TEST_PATH_TMP SETTINGS_JOURNAL_TEST_PATH ".tmp"
+#define SETTINGS_JOURNAL_TEST_PATH_BAD SETTINGS_JOURNAL_TEST_PATH ".bad"
+#define SETTINGS_JOURNAL_TEST_STRUCT_PATH "/int/.unit_test.struct"
+#define SETTINGS_JOURNAL_TEST_SAVES (50)
+#define SETTINGS_JOURNAL_TEST_COMMITS (400)
+
+// Similar to dolphin state: counters updated one by one
+typedef struct {
+    uint32_t counters[24];
+    uint32_t timestamp;
+} SettingsJournalTestStruct;
+
+static void settings_journal_test_cleanup() {
+    Storage* storage = furi_record_open("storage");
+    storage_common_remove(storage, SETTINGS_JOURNAL_TEST_PATH);
+    storage_common_remove(storage, SETTINGS_JOURNAL_TEST_PATH_TMP);
+    storage_common_remove(storage, SETTINGS_JOURNAL_TEST_PATH_BAD);
+    storage_common_remove(storage, SETTINGS_JOURNAL_TEST_STRUCT_PATH);
+    furi_record_close("storage");
+}
+
+// Cut file as power loss in the middle of write would do
+static bool settings_journal_test_truncate(const char* path, uint32_t size) {
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(file, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING) &&
+                  storage_file_seek(file, size, true) && storage_file_truncate(file);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close("storage");
+    return result;
+}
+
+static bool settings_journal_test_append(const char* path, const void* data, size_t size) {
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(file, path, FSAM_WRITE, FSOM_OPEN_APPEND) &&
+                  (storage_file_write(file, data, size) == size);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close("storage");
+    return result;
+}
+
+MU_TEST(settings_journal_store_test) {
+    SettingsJournalTestStruct value = {0};
+    SettingsJournalTestStruct loaded;
+    uint32_t number = 0;
+
+    SettingsJournal* journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_assert_int_eq(0, settings_journal_get_size(journal, "value"));
+    mu_check(!settings_journal_get(journal, "value", &loaded, sizeof(loaded)));
+
+    value.counters[3] = 3;
+    settings_journal_set(journal, "value", &value, sizeof(value));
+    number = 42;
+    settings_journal_set(journal, "number", &number, sizeof(number));
+    mu_check(settings_journal_commit(journal));
+
+    // Only changed bytes are written
+    SettingsJournalStats before;
+    SettingsJournalStats after;
+    settings_journal_get_stats(journal, &before);
+    value.counters[10] = 10;
+    settings_journal_set(journal, "value", &value, sizeof(value));
+    settings_journal_set(journal, "number", &number, sizeof(number));
+    mu_check(settings_journal_commit(journal));
+    settings_journal_get_stats(journal, &after);
+    mu_assert_int_eq(1, after.records - before.records);
+    mu_assert_int_eq(1, after.bytes_changed - before.bytes_changed);
+    mu_check(after.bytes_written - before.bytes_written < 32);
+
+    // Nothing changed, nothing written
+    mu_check(settings_journal_commit(journal));
+    settings_journal_get_stats(journal, &before);
+    mu_assert_int_eq(after.bytes_written, before.bytes_written);
+    settings_journal_free(journal);
+
+    journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_check(settings_journal_get(journal, "value", &loaded, sizeof(loaded)));
+    mu_check(memcmp(&value, &loaded, sizeof(value)) == 0);
+    number = 0;
+    mu_check(settings_journal_get(journal, "number", &number, sizeof(number)));
+    mu_assert_int_eq(42, number);
+    // Size mismatch
+    mu_check(!settings_journal_get(journal, "number", &loaded, sizeof(loaded)));
+    settings_journal_free(journal);
+
+    settings_journal_test_cleanup();
+}
+
+MU_TEST(settings_journal_power_loss_test) {
+    uint32_t first = 1;
+    uint32_t second = 1;
+    SettingsJournalStats stats;
+
+    SettingsJournal* journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    settings_journal_set(journal, "first", &first, sizeof(first));
+    settings_journal_set(journal, "second", &second, sizeof(second));
+    mu_check(settings_journal_commit(journal));
+    settings_journal_get_stats(journal, &stats);
+    uint32_t committed_size = stats.file_size;
+
+    first = 2;
+    second = 2;
+    settings_journal_set(journal, "first", &first, sizeof(first));
+    settings_journal_set(journal, "second", &second, sizeof(second));
+    mu_check(settings_journal_commit(journal));
+    settings_journal_get_stats(journal, &stats);
+    settings_journal_free(journal);
+
+    // Second record of commit is lost: whole commit is dropped
+    mu_check(settings_journal_test_truncate(SETTINGS_JOURNAL_TEST_PATH, stats.file_size - 2));
+    journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_check(settings_journal_get(journal, "first", &first, sizeof(first)));
+    mu_check(settings_journal_get(journal, "second", &second, sizeof(second)));
+    mu_assert_int_eq(1, first);
+    mu_assert_int_eq(1, second);
+    settings_journal_get_stats(journal, &stats);
+    mu_assert_int_eq(committed_size, stats.file_size);
+
+    // Incomplete tail is replaced by next commit
+    first = 3;
+    settings_journal_set(journal, "first", &first, sizeof(first));
+    mu_check(settings_journal_commit(journal));
+    settings_journal_free(journal);
+
+    // Garbage after the last commit is ignored
+    const uint8_t garbage[] = {0x5A, 0xA5, 0x01, 0x05, 0xFF, 0x00};
+    mu_check(settings_journal_test_append(SETTINGS_JOURNAL_TEST_PATH, garbage, sizeof(garbage)));
+    journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_check(settings_journal_get(journal, "first", &first, sizeof(first)));
+    mu_check(settings_journal_get(journal, "second", &second, sizeof(second)));
+    mu_assert_int_eq(3, first);
+    mu_assert_int_eq(1, second);
+    settings_journal_free(journal);
+
+    // Compaction interrupted before old journal removal
+    mu_check(settings_journal_test_append(SETTINGS_JOURNAL_TEST_PATH_TMP, garbage, 3));
+    journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_check(settings_journal_get(journal, "first", &first, sizeof(first)));
+    mu_assert_int_eq(3, first);
+    settings_journal_free(journal);
+    Storage* storage = furi_record_open("storage");
+    mu_assert_int_eq(
+        FSE_NOT_EXIST, storage_common_stat(storage, SETTINGS_JOURNAL_TEST_PATH_TMP, NULL));
+    furi_record_close("storage");
+
+    settings_journal_test_cleanup();
+}
+
+MU_TEST(settings_journal_bad_file_test) {
+    uint32_t number = 7;
+    FileInfo info;
+
+    // Not a journal: kept aside, not overwritten
+    const uint8_t foreign[] = "not a settings journal";
+    mu_check(settings_journal_test_append(SETTINGS_JOURNAL_TEST_PATH, foreign, sizeof(foreign)));
+    SettingsJournal* journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_assert_int_eq(0, settings_journal_get_size(journal, "number"));
+    settings_journal_set(journal, "number", &number, sizeof(number));
+    mu_check(settings_journal_commit(journal));
+    settings_journal_free(journal);
+
+    Storage* storage = furi_record_open("storage");
+    mu_assert_int_eq(FSE_OK, storage_common_stat(storage, SETTINGS_JOURNAL_TEST_PATH_BAD, &info));
+    mu_assert_int_eq(sizeof(foreign), info.size);
+    furi_record_close("storage");
+
+    journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    number = 0;
+    mu_check(settings_journal_get(journal, "number", &number, sizeof(number)));
+    mu_assert_int_eq(7, number);
+    settings_journal_free(journal);
+
+    settings_journal_test_cleanup();
+}
+
+MU_TEST(settings_journal_unreadable_test) {
+    uint32_t number = 7;
+
+    // Directory in place of journal: file can't be opened, save fails instead of staging
+    Storage* storage = furi_record_open("storage");
+    mu_assert_int_eq(FSE_OK, storage_common_mkdir(storage, SETTINGS_JOURNAL_TEST_PATH));
+    SettingsJournal* journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_check(!settings_journal_set(journal, "number", &number, sizeof(number)));
+    mu_check(!settings_journal_commit(journal));
+    mu_assert_int_eq(0, settings_journal_get_size(journal, "number"));
+
+    // Journal becomes readable: stored value is not replaced by the failed save
+    mu_assert_int_eq(FSE_OK, storage_common_remove(storage, SETTINGS_JOURNAL_TEST_PATH));
+    furi_record_close("storage");
+    SettingsJournal* other = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    number = 1;
+    mu_check(settings_journal_set(other, "number", &number, sizeof(number)));
+    mu_check(settings_journal_commit(other));
+    settings_journal_free(other);
+
+    number = 0;
+    mu_check(settings_journal_get(journal, "number", &number, sizeof(number)));
+    mu_assert_int_eq(1, number);
+    number = 7;
+    mu_check(settings_journal_set(journal, "number", &number, sizeof(number)));
+    mu_check(settings_journal_commit(journal));
+    settings_journal_free(journal);
+
+    journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    number = 0;
+    mu_check(settings_journal_get(journal, "number", &number, sizeof(number)));
+    mu_assert_int_eq(7, number);
+    settings_journal_free(journal);
+
+    settings_journal_test_cleanup();
+}
+
+MU_TEST(settings_journal_compaction_test) {
+    SettingsJournalTestStruct value = {0};
+    SettingsJournalStats stats;
+
+    SettingsJournal* journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    for(size_t i = 0; i < SETTINGS_JOURNAL_TEST_COMMITS; i++) {
+        value.counters[i % COUNT_OF(value.counters)]++;
+        settings_journal_set(journal, "value", &value, sizeof(value));
+        mu_check(settings_journal_commit(journal));
+        settings_journal_get_stats(journal, &stats);
+        mu_check(stats.file_size < 4096 + 64);
+    }
+    mu_check(stats.compactions > 0);
+    settings_journal_free(journal);
+
+    SettingsJournalTestStruct loaded;
+    journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    mu_check(settings_journal_get(journal, "value", &loaded, sizeof(loaded)));
+    mu_check(memcmp(&value, &loaded, sizeof(value)) == 0);
+    settings_journal_free(journal);
+
+    settings_journal_test_cleanup();
+}
+
+// File rewrite on each save as saved_struct did before journal
+static bool settings_journal_test_rewrite(Storage* storage, const void* data, size_t size) {
+    uint8_t header[8] = {0};
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(
+                      file, SETTINGS_JOURNAL_TEST_STRUCT_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                  (storage_file_write(file, header, sizeof(header)) == sizeof(header)) &&
+                  (storage_file_write(file, data, size) == size);
+    storage_file_close(file);
+    storage_file_free(file);
+    return result;
+}
+
+MU_TEST(settings_journal_rewrite_compare_test) {
+    SettingsJournalTestStruct value = {0};
+    Storage* storage = furi_record_open("storage");
+    const uint32_t cycles_per_us = SystemCoreClock / 1000000;
+
+    uint32_t rewrite_time_max = 0;
+    uint32_t rewrite_time = 0;
+    uint32_t rewrite_bytes = 0;
+    for(size_t i = 0; i < SETTINGS_JOURNAL_TEST_SAVES; i++) {
+        value.counters[0]++;
+        uint32_t cycles = DWT->CYCCNT;
+        mu_check(settings_journal_test_rewrite(storage, &value, sizeof(value)));
+        cycles = (DWT->CYCCNT - cycles) / cycles_per_us;
+        rewrite_time += cycles;
+        rewrite_time_max = MAX(rewrite_time_max, cycles);
+        rewrite_bytes += 8 + sizeof(value);
+    }
+
+    SettingsJournal* journal = settings_journal_alloc(SETTINGS_JOURNAL_TEST_PATH);
+    settings_journal_set(journal, "value", &value, sizeof(value));
+    mu_check(settings_journal_commit(journal));
+    SettingsJournalStats before;
+    settings_journal_get_stats(journal, &before);
+    uint32_t journal_time = 0;
+    for(size_t i = 0; i < SETTINGS_JOURNAL_TEST_SAVES; i++) {
+        value.counters[0]++;
+        uint32_t cycles = DWT->CYCCNT;
+        settings_journal_set(journal, "value", &value, sizeof(value));
+        mu_check(settings_journal_commit(journal));
+        journal_time += (DWT->CYCCNT - cycles) / cycles_per_us;
+    }
+    SettingsJournalStats after;
+    settings_journal_get_stats(journal, &after);
+    settings_journal_free(journal);
+    furi_record_close("storage");
+
+    uint32_t journal_bytes = after.bytes_written - before.bytes_written;
+    uint32_t changed_bytes = after.bytes_changed - before.bytes_changed;
+    FURI_LOG_I(
+        TAG,
+        "%u saves, %lu bytes changed. Rewrite: %lu bytes, avg %luus, max %luus. "
+        "Journal: %lu bytes, avg %luus, max %luus, %lu compactions",
+        SETTINGS_JOURNAL_TEST_SAVES,
+        changed_bytes,
+        rewrite_bytes,
+        rewrite_time / SETTINGS_JOURNAL_TEST_SAVES,
+        rewrite_time_max,
+        journal_bytes,
+        journal_time / SETTINGS_JOURNAL_TEST_SAVES,
+        after.commit_time_max,
+        after.compactions - before.compactions);
+    FURI_LOG_I(
+        TAG,
+        "Write amplification: rewrite %lu, journal %lu",
+        rewrite_bytes / MAX(changed_bytes, 1UL),
+        journal_bytes / MAX(changed_bytes, 1UL));
+    mu_check(journal_bytes * 2 < rewrite_bytes);
+
+    settings_journal_test_cleanup();
+}
+
+MU_TEST_SUITE(settings_journal_suite) {
+    settings_journal_test_cleanup();
+    MU_RUN_TEST(settings_journal_store_test);
+    MU_RUN_TEST(settings_journal_power_loss_test);
+    MU_RUN_TEST(settings_journal_bad_file_test);
+    MU_RUN_TEST(settings_journal_unreadable_test);
+    MU_RUN_TEST(settings_journal_compaction_test);
+    MU_RUN_TEST(settings_journal_rewrite_compare_test);
+}
+
+int run_minunit_test_settings_journal() {
+    MU_RUN_SUITE(settings_journal_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,122 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+#include <lib/subghz/protocols/subghz_protocol_raw.h>
+#include "../minunit.h"
+
+#define TAG "SubGhzRawWriterTest"
+
+#define RAW_TEST_NAME "unit_test_raw"
+#define RAW_TEST_FILE SUBGHZ_RAW_FOLDER "/" RAW_TEST_NAME SUBGHZ_APP_EXTENSION
+#define RAW_TEST_SAMPLES (4096 + 100)
+#define RAW_TEST_FLOOD_SAMPLES (20000)
+
+// Alternating levels, durations above RAW filter threshold
+static uint32_t raw_test_duration(size_t i) {
+    return 100 + (i * 37) % 5000;
+}
+
+static int32_t raw_test_sample(size_t i) {
+    return (i % 2 == 0) ? (int32_t)raw_test_duration(i) : -(int32_t)raw_test_duration(i);
+}
+
+// Read back all RAW_Data lines, values are checked if no samples were lost
+static size_t raw_test_read_back(bool check_values, bool* values_ok) {
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    int32_t* data = malloc(1024 * sizeof(int32_t));
+    size_t total = 0;
+    *values_ok = true;
+
+    if(flipper_format_file_open_existing(flipper_format, RAW_TEST_FILE)) {
+        uint32_t count = 0;
+        while(flipper_format_get_value_count(flipper_format, "RAW_Data", &count)) {
+            if((count == 0) || (count > 1024)) break;
+            if(!flipper_format_read_int32(flipper_format, "RAW_Data", data, count)) break;
+            for(size_t i = 0; (i < count) && check_values; i++) {
+                if(data[i] != raw_test_sample(total + i)) *values_ok = false;
+            }
+            total += count;
+        }
+    }
+
+    free(data);
+    flipper_format_free(flipper_format);
+    storage_simply_remove(storage, RAW_TEST_FILE);
+    furi_record_close("storage");
+
+    return total;
+}
+
+MU_TEST(subghz_raw_writer_paced_test) {
+    SubGhzProtocolRAW* raw = subghz_protocol_raw_alloc();
+    mu_check(subghz_protocol_raw_save_to_file_init(raw, RAW_TEST_NAME, 433920000, "Test"));
+
+    // Edge rate storage keeps up with, writer gets time between bursts
+    for(size_t i = 0; i < RAW_TEST_SAMPLES; i++) {
+        subghz_protocol_raw_parse(raw, (i % 2 == 0), raw_test_duration(i));
+        if(i % 256 == 255) osDelay(20);
+    }
+    mu_assert_int_eq(RAW_TEST_SAMPLES, subghz_protocol_raw_get_sample_write(raw));
+    subghz_protocol_raw_save_to_file_stop(raw);
+
+    SubGhzProtocolRAWWriterStats stats;
+    subghz_protocol_raw_get_writer_stats(raw, &stats);
+    FURI_LOG_I(
+        TAG,
+        "Paced: max latency %lums, max in flight %u/%u",
+        stats.write_latency_max,
+        stats.buffers_in_flight_max,
+        stats.buffers_count);
+    mu_assert_int_eq(0, stats.overrun_cnt);
+    mu_assert_int_eq(0, stats.samples_lost);
+    mu_assert_int_eq(0, stats.buffers_in_flight);
+
+    subghz_protocol_raw_free(raw);
+    bool values_ok = false;
+    mu_assert_int_eq(RAW_TEST_SAMPLES, raw_test_read_back(true, &values_ok));
+    mu_check(values_ok);
+}
+
+MU_TEST(subghz_raw_writer_flood_test) {
+    SubGhzProtocolRAW* raw = subghz_protocol_raw_alloc();
+    mu_check(subghz_protocol_raw_save_to_file_init(raw, RAW_TEST_NAME, 433920000, "Test"));
+
+    // Capture never blocks: samples beyond writer throughput are dropped and counted
+    uint32_t start = osKernelGetTickCount();
+    for(size_t i = 0; i < RAW_TEST_FLOOD_SAMPLES; i++) {
+        subghz_protocol_raw_parse(raw, (i % 2 == 0), raw_test_duration(i));
+    }
+    uint32_t capture_ticks = osKernelGetTickCount() - start;
+    size_t captured = subghz_protocol_raw_get_sample_write(raw);
+    subghz_protocol_raw_save_to_file_stop(raw);
+
+    SubGhzProtocolRAWWriterStats stats;
+    subghz_protocol_raw_get_writer_stats(raw, &stats);
+    FURI_LOG_I(
+        TAG,
+        "Flood: %u samples in %lu ticks, captured %u, lost %lu, overruns %lu, max latency %lums",
+        RAW_TEST_FLOOD_SAMPLES,
+        capture_ticks,
+        captured,
+        stats.samples_lost,
+        stats.overrun_cnt,
+        stats.write_latency_max);
+    mu_assert_int_eq(RAW_TEST_FLOOD_SAMPLES, captured + stats.samples_lost);
+    mu_check(stats.buffers_in_flight_max <= stats.buffers_count);
+
+    subghz_protocol_raw_free(raw);
+    bool values_ok = false;
+    mu_assert_int_eq(captured, raw_test_read_back(false, &values_ok));
+}
+
+MU_TEST_SUITE(subghz_raw_writer_suite) {
+    MU_RUN_TEST(subghz_raw_writer_paced_test);
+    MU_RUN_TEST(subghz_raw_writer_flood_test);
+}
+
+int run_minunit_test_subghz_raw_writer() {
+    MU_RUN_SUITE(subghz_raw_writer_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,380 @@
+#include <furi.h>
+#include <lib/subghz/subghz_tx_rx_link.h>
+#include "../minunit.h"
+
+#define TAG "SubGhzTxRxLinkTest"
+
+#define LINK_TEST_ID_A 0x11
+#define LINK_TEST_ID_B 0x22
+#define LINK_TEST_RX_SIZE (8 * 1024)
+#define LINK_TEST_MESSAGES 20
+// Air time of one byte at 9.99Kbps, ms
+#define LINK_TEST_BYTE_TIME 1
+
+// Simulated radio: half duplex channel that drops frames with given probability
+typedef struct {
+    uint32_t seed;
+    uint8_t loss_percent;
+    bool drop_acks_only;
+    size_t dropped;
+    uint32_t now;
+} LinkTestChannel;
+
+typedef struct {
+    uint8_t data[LINK_TEST_RX_SIZE];
+    size_t size;
+    size_t messages;
+} LinkTestReceiver;
+
+static bool link_test_channel_pass(LinkTestChannel* channel, const uint8_t* frame) {
+    channel->seed = channel->seed * 1103515245 + 12345;
+    bool is_ack = (frame[0] & 0x0F) == 0x02;
+    if(channel->drop_acks_only && !is_ack) return true;
+    if(((channel->seed >> 16) % 100) < channel->loss_percent) {
+        channel->dropped++;
+        return false;
+    }
+    return true;
+}
+
+static void link_test_receiver_callback(const uint8_t* data, size_t size, void* context) {
+    LinkTestReceiver* receiver = context;
+    if(receiver->size + size <= LINK_TEST_RX_SIZE) {
+        memcpy(&receiver->data[receiver->size], data, size);
+        receiver->size += size;
+    }
+    receiver->messages++;
+}
+
+// Radio turns: each node gets a chance to transmit, frame takes its air time
+static void link_test_channel_run(
+    LinkTestChannel* channel,
+    SubGhzTxRxLink* a,
+    SubGhzTxRxLink* b,
+    uint32_t duration) {
+    uint8_t frame[SUBGHZ_TXRX_LINK_FRAME_MAX];
+    size_t size = 0;
+    uint32_t end = channel->now + duration;
+    while(channel->now < end) {
+        if(subghz_tx_rx_link_get_frame(a, frame, &size, channel->now)) {
+            channel->now += size * LINK_TEST_BYTE_TIME;
+            if(link_test_channel_pass(channel, frame)) {
+                subghz_tx_rx_link_put_frame(b, frame, size, -60.5f, 42, channel->now);
+            }
+        }
+        if(subghz_tx_rx_link_get_frame(b, frame, &size, channel->now)) {
+            channel->now += size * LINK_TEST_BYTE_TIME;
+            if(link_test_channel_pass(channel, frame)) {
+                subghz_tx_rx_link_put_frame(a, frame, size, -60.5f, 42, channel->now);
+            }
+        }
+        channel->now++;
+    }
+}
+
+static uint8_t link_test_pattern(size_t i) {
+    return (i * 7 + (i >> 8)) & 0xFF;
+}
+
+// Send messages of different sizes from a to b, message is sent when previous one is done
+static size_t link_test_send_messages(
+    LinkTestChannel* channel,
+    SubGhzTxRxLink* a,
+    SubGhzTxRxLink* b,
+    uint8_t* tx_data) {
+    size_t total = 0;
+    for(size_t i = 0; i < LINK_TEST_MESSAGES; i++) {
+        size_t size = 1 + (i * 97) % (LINK_TEST_RX_SIZE / LINK_TEST_MESSAGES);
+        if(size > SUBGHZ_TXRX_LINK_MESSAGE_MAX) size = SUBGHZ_TXRX_LINK_MESSAGE_MAX;
+        while(!subghz_tx_rx_link_is_tx_idle(a)) {
+            link_test_channel_run(channel, a, b, 10);
+        }
+        subghz_tx_rx_link_send(a, &tx_data[total], size);
+        total += size;
+    }
+    while(!subghz_tx_rx_link_is_tx_idle(a)) {
+        link_test_channel_run(channel, a, b, 10);
+    }
+    // Let last ACK go through
+    link_test_channel_run(channel, a, b, 100);
+    return total;
+}
+
+MU_TEST(subghz_tx_rx_link_fragment_test) {
+    SubGhzTxRxLink* a = subghz_tx_rx_link_alloc(LINK_TEST_ID_A);
+    SubGhzTxRxLink* b = subghz_tx_rx_link_alloc(LINK_TEST_ID_B);
+    LinkTestReceiver* receiver = malloc(sizeof(LinkTestReceiver));
+    memset(receiver, 0, sizeof(LinkTestReceiver));
+    subghz_tx_rx_link_set_callback(b, link_test_receiver_callback, receiver);
+    LinkTestChannel channel = {.seed = 1};
+
+    uint8_t* message = malloc(SUBGHZ_TXRX_LINK_MESSAGE_MAX);
+    for(size_t i = 0; i < SUBGHZ_TXRX_LINK_MESSAGE_MAX; i++) message[i] = link_test_pattern(i);
+
+    // Too long and empty messages are rejected
+    mu_check(!subghz_tx_rx_link_send(a, message, SUBGHZ_TXRX_LINK_MESSAGE_MAX + 1));
+    mu_check(!subghz_tx_rx_link_send(a, message, 0));
+
+    mu_check(subghz_tx_rx_link_send(a, message, SUBGHZ_TXRX_LINK_MESSAGE_MAX));
+    mu_check(!subghz_tx_rx_link_send(a, message, 1));
+    link_test_channel_run(&channel, a, b, 2000);
+
+    SubGhzTxRxLinkStats stats;
+    subghz_tx_rx_link_get_stats(a, &stats);
+    size_t fragments = (SUBGHZ_TXRX_LINK_MESSAGE_MAX + SUBGHZ_TXRX_LINK_PAYLOAD_MAX - 1) /
+                       SUBGHZ_TXRX_LINK_PAYLOAD_MAX;
+    mu_assert_int_eq(fragments, stats.tx_frames);
+    mu_assert_int_eq(1, stats.tx_messages);
+
+    mu_assert_int_eq(1, receiver->messages);
+    mu_assert_int_eq(SUBGHZ_TXRX_LINK_MESSAGE_MAX, receiver->size);
+    mu_check(memcmp(message, receiver->data, SUBGHZ_TXRX_LINK_MESSAGE_MAX) == 0);
+
+    subghz_tx_rx_link_get_stats(b, &stats);
+    mu_assert_int_eq(fragments, stats.rx_frames);
+    mu_assert_int_eq(0, stats.rx_lost);
+    mu_assert_int_eq(42, stats.lqi);
+    mu_check(stats.rssi < -60.0f && stats.rssi > -61.0f);
+
+    // Short message takes one frame
+    mu_check(subghz_tx_rx_link_send(a, message, 5));
+    link_test_channel_run(&channel, a, b, 100);
+    mu_assert_int_eq(2, receiver->messages);
+    mu_assert_int_eq(SUBGHZ_TXRX_LINK_MESSAGE_MAX + 5, receiver->size);
+
+    free(message);
+    free(receiver);
+    subghz_tx_rx_link_free(a);
+    subghz_tx_rx_link_free(b);
+}
+
+MU_TEST(subghz_tx_rx_link_loss_test) {
+    SubGhzTxRxLink* a = subghz_tx_rx_link_alloc(LINK_TEST_ID_A);
+    SubGhzTxRxLink* b = subghz_tx_rx_link_alloc(LINK_TEST_ID_B);
+    LinkTestReceiver* receiver = malloc(sizeof(LinkTestReceiver));
+    memset(receiver, 0, sizeof(LinkTestReceiver));
+    subghz_tx_rx_link_set_callback(b, link_test_receiver_callback, receiver);
+    LinkTestChannel channel = {.seed = 42, .loss_percent = 20};
+
+    uint8_t* tx_data = malloc(LINK_TEST_RX_SIZE);
+    for(size_t i = 0; i < LINK_TEST_RX_SIZE; i++) tx_data[i] = link_test_pattern(i);
+    link_test_send_messages(&channel, a, b, tx_data);
+
+    // Without ACK lost frames are counted, messages with missing fragments are dropped
+    SubGhzTxRxLinkStats stats_a;
+    SubGhzTxRxLinkStats stats_b;
+    subghz_tx_rx_link_get_stats(a, &stats_a);
+    subghz_tx_rx_link_get_stats(b, &stats_b);
+    mu_check(channel.dropped > 0);
+    mu_assert_int_eq(0, stats_a.tx_retries);
+    mu_assert_int_eq(LINK_TEST_MESSAGES, stats_a.tx_messages);
+    mu_assert_int_eq(stats_a.tx_frames, stats_b.rx_frames + channel.dropped);
+    // Frames lost after the last received one are not seen by receiver
+    mu_check(stats_b.rx_lost <= channel.dropped);
+    mu_check(stats_b.rx_lost + 3 >= channel.dropped);
+    mu_check(receiver->messages < LINK_TEST_MESSAGES);
+    mu_check(stats_b.rx_messages_dropped > 0);
+
+    free(tx_data);
+    free(receiver);
+    subghz_tx_rx_link_free(a);
+    subghz_tx_rx_link_free(b);
+}
+
+MU_TEST(subghz_tx_rx_link_ack_test) {
+    SubGhzTxRxLink* a = subghz_tx_rx_link_alloc(LINK_TEST_ID_A);
+    SubGhzTxRxLink* b = subghz_tx_rx_link_alloc(LINK_TEST_ID_B);
+    LinkTestReceiver* receiver = malloc(sizeof(LinkTestReceiver));
+    memset(receiver, 0, sizeof(LinkTestReceiver));
+    subghz_tx_rx_link_set_callback(b, link_test_receiver_callback, receiver);
+    subghz_tx_rx_link_set_ack(a, 10, SUBGHZ_TXRX_LINK_FRAME_MAX * LINK_TEST_BYTE_TIME + 50);
+    subghz_tx_rx_link_set_ack(b, 10, SUBGHZ_TXRX_LINK_FRAME_MAX * LINK_TEST_BYTE_TIME + 50);
+    LinkTestChannel channel = {.seed = 7, .loss_percent = 20};
+
+    uint8_t* tx_data = malloc(LINK_TEST_RX_SIZE);
+    for(size_t i = 0; i < LINK_TEST_RX_SIZE; i++) tx_data[i] = link_test_pattern(i);
+    uint32_t start = channel.now;
+    size_t total = link_test_send_messages(&channel, a, b, tx_data);
+
+    // Every message is delivered once and in order
+    SubGhzTxRxLinkStats stats_a;
+    SubGhzTxRxLinkStats stats_b;
+    subghz_tx_rx_link_get_stats(a, &stats_a);
+    subghz_tx_rx_link_get_stats(b, &stats_b);
+    FURI_LOG_I(
+        TAG,
+        "%u bytes in %lums with %u%% loss: %lu frames, %lu retries, %lu duplicates",
+        total,
+        channel.now - start,
+        channel.loss_percent,
+        stats_a.tx_frames,
+        stats_a.tx_retries,
+        stats_b.rx_duplicates);
+    mu_check(channel.dropped > 0);
+    mu_check(stats_a.tx_retries > 0);
+    mu_assert_int_eq(0, stats_a.tx_failed);
+    mu_assert_int_eq(LINK_TEST_MESSAGES, stats_a.tx_messages);
+    mu_assert_int_eq(LINK_TEST_MESSAGES, receiver->messages);
+    mu_assert_int_eq(total, receiver->size);
+    mu_check(memcmp(tx_data, receiver->data, total) == 0);
+    mu_assert_int_eq(0, stats_b.rx_lost);
+    mu_assert_int_eq(0, stats_b.rx_messages_dropped);
+
+    free(tx_data);
+    free(receiver);
+    subghz_tx_rx_link_free(a);
+    subghz_tx_rx_link_free(b);
+}
+
+MU_TEST(subghz_tx_rx_link_duplicate_test) {
+    SubGhzTxRxLink* a = subghz_tx_rx_link_alloc(LINK_TEST_ID_A);
+    SubGhzTxRxLink* b = subghz_tx_rx_link_alloc(LINK_TEST_ID_B);
+    LinkTestReceiver* receiver = malloc(sizeof(LinkTestReceiver));
+    memset(receiver, 0, sizeof(LinkTestReceiver));
+    subghz_tx_rx_link_set_callback(b, link_test_receiver_callback, receiver);
+    subghz_tx_rx_link_set_ack(a, 10, 100);
+    // Lost ACKs make sender repeat frames that were already received
+    LinkTestChannel channel = {.seed = 3, .loss_percent = 50, .drop_acks_only = true};
+
+    uint8_t message[64];
+    for(size_t i = 0; i < sizeof(message); i++) message[i] = link_test_pattern(i);
+    for(size_t i = 0; i < 10; i++) {
+        mu_check(subghz_tx_rx_link_send(a, message, sizeof(message)));
+        while(!subghz_tx_rx_link_is_tx_idle(a)) {
+            link_test_channel_run(&channel, a, b, 10);
+        }
+    }
+
+    SubGhzTxRxLinkStats stats_a;
+    SubGhzTxRxLinkStats stats_b;
+    subghz_tx_rx_link_get_stats(a, &stats_a);
+    subghz_tx_rx_link_get_stats(b, &stats_b);
+    mu_check(stats_b.rx_duplicates > 0);
+    mu_assert_int_eq(stats_a.tx_retries, stats_b.rx_duplicates);
+    mu_assert_int_eq(10, receiver->messages);
+    mu_assert_int_eq(0, stats_b.rx_lost);
+
+    free(receiver);
+    subghz_tx_rx_link_free(a);
+    subghz_tx_rx_link_free(b);
+}
+
+MU_TEST(subghz_tx_rx_link_invalid_test) {
+    SubGhzTxRxLink* b = subghz_tx_rx_link_alloc(LINK_TEST_ID_B);
+    LinkTestReceiver* receiver = malloc(sizeof(LinkTestReceiver));
+    memset(receiver, 0, sizeof(LinkTestReceiver));
+    subghz_tx_rx_link_set_callback(b, link_test_receiver_callback, receiver);
+
+    // Too short, unknown type, short middle fragment, fragment index out of range
+    const uint8_t short_frame[] = {0x01, LINK_TEST_ID_A, 0};
+    const uint8_t bad_type[] = {0x07, LINK_TEST_ID_A, 0, 0x00, 1};
+    const uint8_t short_fragment[] = {0x01, LINK_TEST_ID_A, 1, 0x01, 1};
+    const uint8_t bad_fragment[] = {0x01, LINK_TEST_ID_A, 2, 0x21, 1};
+    subghz_tx_rx_link_put_frame(b, short_frame, sizeof(short_frame), 0, 0, 0);
+    subghz_tx_rx_link_put_frame(b, bad_type, sizeof(bad_type), 0, 0, 0);
+    subghz_tx_rx_link_put_frame(b, short_fragment, sizeof(short_fragment), 0, 0, 0);
+    subghz_tx_rx_link_put_frame(b, bad_fragment, sizeof(bad_fragment), 0, 0, 0);
+
+    SubGhzTxRxLinkStats stats;
+    subghz_tx_rx_link_get_stats(b, &stats);
+    mu_assert_int_eq(4, stats.rx_invalid);
+    mu_assert_int_eq(0, receiver->messages);
+
+    // Single fragment message is delivered
+    const uint8_t good[] = {0x01, LINK_TEST_ID_A, 3, 0x00, 'h', 'i'};
+    subghz_tx_rx_link_put_frame(b, good, sizeof(good), 0, 0, 0);
+    mu_assert_int_eq(1, receiver->messages);
+    mu_assert_int_eq(2, receiver->size);
+
+    free(receiver);
+    subghz_tx_rx_link_free(b);
+}
+
+MU_TEST(subghz_tx_rx_link_id_conflict_test) {
+    SubGhzTxRxLink* b = subghz_tx_rx_link_alloc(LINK_TEST_ID_B);
+    LinkTestReceiver* receiver = malloc(sizeof(LinkTestReceiver));
+    memset(receiver, 0, sizeof(LinkTestReceiver));
+    subghz_tx_rx_link_set_callback(b, link_test_receiver_callback, receiver);
+    subghz_tx_rx_link_set_ack(b, 10, 100);
+
+    // Message of b is in flight when other node with the same id shows up
+    const uint8_t message[] = {'o', 'k'};
+    uint8_t frame[SUBGHZ_TXRX_LINK_FRAME_MAX];
+    size_t size = 0;
+    mu_check(subghz_tx_rx_link_send(b, message, sizeof(message)));
+    mu_check(subghz_tx_rx_link_get_frame(b, frame, &size, 0));
+    mu_assert_int_eq(LINK_TEST_ID_B, frame[1]);
+
+    // Frame is delivered, b takes another id and sends its message again without waiting ACK
+    const uint8_t same_id[] = {0x11, LINK_TEST_ID_B, 0, 0x00, 'h', 'i'};
+    subghz_tx_rx_link_put_frame(b, same_id, sizeof(same_id), 0, 0, 10);
+    SubGhzTxRxLinkStats stats;
+    subghz_tx_rx_link_get_stats(b, &stats);
+    mu_assert_int_eq(1, stats.id_conflicts);
+    mu_assert_int_eq(0, stats.rx_invalid);
+    mu_assert_int_eq(1, receiver->messages);
+
+    // ACK for frame of other node goes first
+    mu_check(subghz_tx_rx_link_get_frame(b, frame, &size, 20));
+    mu_assert_int_eq(0x02, frame[0] & 0x0F);
+    mu_check(subghz_tx_rx_link_get_frame(b, frame, &size, 20));
+    mu_assert_int_eq(0x01, frame[0] & 0x0F);
+    mu_check(frame[1] != LINK_TEST_ID_B);
+    mu_assert_int_eq(0x00, frame[3]);
+    mu_check(memcmp(&frame[SUBGHZ_TXRX_LINK_HEADER_SIZE], message, sizeof(message)) == 0);
+
+    // Frames with the old id are not a conflict anymore
+    const uint8_t next[] = {0x01, LINK_TEST_ID_B, 1, 0x00, 'h', 'i'};
+    subghz_tx_rx_link_put_frame(b, next, sizeof(next), 0, 0, 30);
+    subghz_tx_rx_link_get_stats(b, &stats);
+    mu_assert_int_eq(1, stats.id_conflicts);
+    mu_assert_int_eq(2, receiver->messages);
+
+    free(receiver);
+    subghz_tx_rx_link_free(b);
+}
+
+MU_TEST(subghz_tx_rx_link_sources_test) {
+    SubGhzTxRxLink* b = subghz_tx_rx_link_alloc(LINK_TEST_ID_B);
+    LinkTestReceiver* receiver = malloc(sizeof(LinkTestReceiver));
+    memset(receiver, 0, sizeof(LinkTestReceiver));
+    subghz_tx_rx_link_set_callback(b, link_test_receiver_callback, receiver);
+
+    // Single frame messages of two senders interleave, each has own sequence
+    uint8_t frame_a[] = {0x01, LINK_TEST_ID_A, 0, 0x00, 'a'};
+    uint8_t frame_c[] = {0x01, 0x33, 200, 0x00, 'c'};
+    for(size_t i = 0; i < 10; i++) {
+        frame_a[2] = i;
+        frame_c[2] = 200 + i;
+        subghz_tx_rx_link_put_frame(b, frame_a, sizeof(frame_a), 0, 0, 0);
+        subghz_tx_rx_link_put_frame(b, frame_c, sizeof(frame_c), 0, 0, 0);
+    }
+    // Repeated frame of first sender is a duplicate, skipped one is lost
+    subghz_tx_rx_link_put_frame(b, frame_a, sizeof(frame_a), 0, 0, 0);
+    frame_c[2] += 2;
+    subghz_tx_rx_link_put_frame(b, frame_c, sizeof(frame_c), 0, 0, 0);
+
+    SubGhzTxRxLinkStats stats;
+    subghz_tx_rx_link_get_stats(b, &stats);
+    mu_assert_int_eq(1, stats.rx_duplicates);
+    mu_assert_int_eq(1, stats.rx_lost);
+    mu_assert_int_eq(21, receiver->messages);
+
+    free(receiver);
+    subghz_tx_rx_link_free(b);
+}
+
+MU_TEST_SUITE(subghz_tx_rx_link_suite) {
+    MU_RUN_TEST(subghz_tx_rx_link_fragment_test);
+    MU_RUN_TEST(subghz_tx_rx_link_loss_test);
+    MU_RUN_TEST(subghz_tx_rx_link_ack_test);
+    MU_RUN_TEST(subghz_tx_rx_link_duplicate_test);
+    MU_RUN_TEST(subghz_tx_rx_link_invalid_test);
+    MU_RUN_TEST(subghz_tx_rx_link_id_conflict_test);
+    MU_RUN_TEST(subghz_tx_rx_link_sources_test);
+}
+
+int run_minunit_test_subghz_tx_rx_link() {
+    MU_RUN_SUITE(subghz_tx_rx_link_suite);
+    return MU_EXIT_CODE;
+}
@@ -15,7 +15,28 @@ int run_minunit_test_irda_decoder_encoder();
 int run_minunit_test_rpc();
 int run_minunit_test_flipper_format();
 int run_minunit_test_flipper_format_string();
+int run_minunit_test_flipper_format_arena();
 int run_minunit_test_stream();
+int run_minunit_test_mf_ul_emulation();
+int run_minunit_test_lfrfid_decoder();
+int run_minunit_test_lfrfid_pulse_train();
+int run_minunit_test_maxim_crc();
+int run_minunit_test_usb_uart_rx_ring();
+int run_minunit_test_ducky_bytecode();
+int run_minunit_test_ducky_typer();
+int run_minunit_test_subghz_raw_writer();
+int run_minunit_test_subghz_tx_rx_link();
+int run_minunit_test_text_box_layout();
+int run_minunit_test_view_model();
+int run_minunit_test_settings_journal();
+int run_minunit_test_notification_timeline();
+int run_minunit_test_u2f_counter();
+int run_minunit_test_u2f_ecc();
+int run_minunit_test_input_debounce();
+int run_minunit_test_bt_serial_tx();
+int run_minunit_test_loader_profile();
+int run_minunit_test_hash();
+int run_minunit_test_sd_spi();
 
 void minunit_print_progress(void) {
     static char progress[] = {'\\', '|', '/', '-'};
@@ -58,6 +79,27 @@ void unit_tests_cli(Cli* cli, string_t args, void* context) {
         test_result |= run_minunit_test_stream();
         test_result |= run_minunit_test_flipper_format();
         test_result |= run_minunit_test_flipper_format_string();
+        test_result |= run_minunit_test_flipper_format_arena();
+        test_result |= run_minunit_test_mf_ul_emulation();
+        test_result |= run_minunit_test_lfrfid_decoder();
+        test_result |= run_minunit_test_lfrfid_pulse_train();
+        test_result |= run_minunit_test_maxim_crc();
+        test_result |= run_minunit_test_usb_uart_rx_ring();
+        test_result |= run_minunit_test_ducky_bytecode();
+        test_result |= run_minunit_test_ducky_typer();
+        test_result |= run_minunit_test_subghz_raw_writer();
+        test_result |= run_minunit_test_subghz_tx_rx_link();
+        test_result |= run_minunit_test_text_box_layout();
+        test_result |= run_minunit_test_view_model();
+        test_result |= run_minunit_test_settings_journal();
+        test_result |= run_minunit_test_notification_timeline();
+        test_result |= run_minunit_test_u2f_counter();
+        test_result |= run_minunit_test_u2f_ecc();
+        test_result |= run_minunit_test_input_debounce();
+        test_result |= run_minunit_test_bt_serial_tx();
+        test_result |= run_minunit_test_loader_profile();
+        test_result |= run_minunit_test_hash();
+        test_result |= run_minunit_test_sd_spi();
         cycle_counter = (DWT->CYCCNT - cycle_counter);
 
         FURI_LOG_I(TAG, "Consumed: %0.2fs", (float)cycle_counter / (SystemCoreClock));
@@ -0,0 +1,159 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <u2f/u2f_counter.h>
+#include "../minunit.h"
+
+#define TAG "U2fCounterTest"
+
+#define U2F_COUNTER_TEST_AUTHS (200)
+// Key load, encryption and counter file rewrite, as measured on device
+#define U2F_COUNTER_TEST_WRITE_US (25000)
+#define U2F_COUNTER_TEST_KEY (0x5A5AA5A5)
+
+// Fake counter file: mark is stored "encrypted" like u2f_data does
+typedef struct {
+    bool exists;
+    bool fail;
+    uint32_t data;
+    uint32_t writes;
+} U2fCounterTestStorage;
+
+static bool u2f_counter_test_read(void* context, uint32_t* mark) {
+    U2fCounterTestStorage* storage = context;
+    if(!storage->exists) return false;
+    *mark = storage->data ^ U2F_COUNTER_TEST_KEY;
+    return true;
+}
+
+static bool u2f_counter_test_write(void* context, uint32_t mark) {
+    U2fCounterTestStorage* storage = context;
+    if(storage->fail) return false;
+    storage->exists = true;
+    storage->data = mark ^ U2F_COUNTER_TEST_KEY;
+    storage->writes++;
+    return true;
+}
+
+static const U2fCounterStorage u2f_counter_test_storage = {
+    .read = u2f_counter_test_read,
+    .write = u2f_counter_test_write,
+};
+
+// One authentication: take counter value and move to the next one
+static bool u2f_counter_test_auth(U2fCounter* counter, uint32_t* value) {
+    if(!u2f_counter_get(counter, value)) return false;
+    u2f_counter_increment(counter);
+    return true;
+}
+
+MU_TEST(u2f_counter_power_loss_test) {
+    U2fCounterTestStorage storage = {0};
+    U2fCounter counter;
+    uint32_t value = 0;
+    uint32_t last = 0;
+
+    // No counter file yet
+    u2f_counter_init(&counter, &u2f_counter_test_storage, &storage, U2F_COUNTER_BLOCK_SIZE);
+    mu_check(!u2f_counter_load(&counter));
+    mu_check(u2f_counter_save(&counter));
+    mu_assert_int_eq(1, storage.writes);
+
+    for(size_t i = 0; i < 10; i++) {
+        mu_check(u2f_counter_test_auth(&counter, &value));
+        mu_assert_int_eq(i, value);
+    }
+    mu_assert_int_eq(2, storage.writes);
+    last = value;
+
+    // Power loss: RAM state is lost, counter resumes after reserved block
+    u2f_counter_init(&counter, &u2f_counter_test_storage, &storage, U2F_COUNTER_BLOCK_SIZE);
+    mu_check(u2f_counter_load(&counter));
+    mu_check(u2f_counter_test_auth(&counter, &value));
+    mu_check(value > last);
+    mu_assert_int_eq(U2F_COUNTER_BLOCK_SIZE, value);
+    last = value;
+
+    // Clean exit gives unused values back
+    mu_check(u2f_counter_save(&counter));
+    u2f_counter_init(&counter, &u2f_counter_test_storage, &storage, U2F_COUNTER_BLOCK_SIZE);
+    mu_check(u2f_counter_load(&counter));
+    mu_check(u2f_counter_test_auth(&counter, &value));
+    mu_assert_int_eq(last + 1, value);
+
+    // Value that isn't covered by stored mark is never given out
+    for(size_t i = 0; i < U2F_COUNTER_BLOCK_SIZE - 1; i++) {
+        mu_check(u2f_counter_test_auth(&counter, &value));
+    }
+    storage.fail = true;
+    mu_check(!u2f_counter_get(&counter, &value));
+    storage.fail = false;
+    last = value;
+    mu_check(u2f_counter_test_auth(&counter, &value));
+    mu_assert_int_eq(last + 1, value);
+}
+
+static void u2f_counter_test_measure(
+    uint32_t block_size,
+    uint32_t* writes,
+    uint32_t* latency_avg,
+    uint32_t* latency_max) {
+    U2fCounterTestStorage storage = {.exists = true, .data = U2F_COUNTER_TEST_KEY};
+    U2fCounter counter;
+    const uint32_t cycles_per_us = SystemCoreClock / 1000000;
+    uint32_t value = 0;
+    uint32_t total = 0;
+
+    u2f_counter_init(&counter, &u2f_counter_test_storage, &storage, block_size);
+    u2f_counter_load(&counter);
+    *latency_max = 0;
+    for(size_t i = 0; i < U2F_COUNTER_TEST_AUTHS; i++) {
+        uint32_t writes_before = storage.writes;
+        uint32_t cycles = DWT->CYCCNT;
+        furi_check(u2f_counter_test_auth(&counter, &value));
+        uint32_t latency = (DWT->CYCCNT - cycles) / cycles_per_us +
+                           (storage.writes - writes_before) * U2F_COUNTER_TEST_WRITE_US;
+        total += latency;
+        *latency_max = MAX(*latency_max, latency);
+    }
+
+    *writes = storage.writes;
+    *latency_avg = total / U2F_COUNTER_TEST_AUTHS;
+}
+
+MU_TEST(u2f_counter_latency_test) {
+    uint32_t legacy_writes, legacy_avg, legacy_max;
+    uint32_t block_writes, block_avg, block_max;
+
+    // Block of one value is the old write on every authentication
+    u2f_counter_test_measure(1, &legacy_writes, &legacy_avg, &legacy_max);
+    u2f_counter_test_measure(U2F_COUNTER_BLOCK_SIZE, &block_writes, &block_avg, &block_max);
+
+    FURI_LOG_I(
+        TAG,
+        "%u auths. Write each: %lu writes, avg %luus, max %luus. "
+        "Block of %u: %lu writes, avg %luus, max %luus",
+        U2F_COUNTER_TEST_AUTHS,
+        legacy_writes,
+        legacy_avg,
+        legacy_max,
+        U2F_COUNTER_BLOCK_SIZE,
+        block_writes,
+        block_avg,
+        block_max);
+
+    mu_assert_int_eq(U2F_COUNTER_TEST_AUTHS, legacy_writes);
+    mu_assert_int_eq(
+        (U2F_COUNTER_TEST_AUTHS + U2F_COUNTER_BLOCK_SIZE - 1) / U2F_COUNTER_BLOCK_SIZE,
+        block_writes);
+    mu_check(block_avg * 10 < legacy_avg);
+}
+
+MU_TEST_SUITE(u2f_counter_suite) {
+    MU_RUN_TEST(u2f_counter_power_loss_test);
+    MU_RUN_TEST(u2f_counter_latency_test);
+}
+
+int run_minunit_test_u2f_counter() {
+    MU_RUN_SUITE(u2f_counter_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,230 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <micro-ecc/uECC.h>
+#include "../minunit.h"
+
+#define TAG "U2fEccTest"
+
+#define U2F_ECC_TEST_KEY_SIZE (32)
+#define U2F_ECC_TEST_RANDOM_KEYS (16)
+#define U2F_ECC_TEST_BENCH_SIGNS (8)
+
+typedef struct {
+    const char* message;
+    uint8_t hash[U2F_ECC_TEST_KEY_SIZE];
+    uint8_t k[U2F_ECC_TEST_KEY_SIZE];
+    uint8_t signature[U2F_ECC_TEST_KEY_SIZE * 2];
+} U2fEccTestVector;
+
+// RFC 6979 A.2.5, ECDSA P-256 with SHA-256
+static const uint8_t u2f_ecc_test_private[U2F_ECC_TEST_KEY_SIZE] = {
+    0xC9, 0xAF, 0xA9, 0xD8, 0x45, 0xBA, 0x75, 0x16, 0x6B, 0x5C, 0x21, 0x57, 0x67, 0xB1, 0xD6, 0x93,
+    0x4E, 0x50, 0xC3, 0xDB, 0x36, 0xE8, 0x9B, 0x12, 0x7B, 0x8A, 0x62, 0x2B, 0x12, 0x0F, 0x67, 0x21,
+};
+
+static const uint8_t u2f_ecc_test_public[U2F_ECC_TEST_KEY_SIZE * 2] = {
+    0x60, 0xFE, 0xD4, 0xBA, 0x25, 0x5A, 0x9D, 0x31, 0xC9, 0x61, 0xEB, 0x74, 0xC6, 0x35, 0x6D, 0x68,
+    0xC0, 0x49, 0xB8, 0x92, 0x3B, 0x61, 0xFA, 0x6C, 0xE6, 0x69, 0x62, 0x2E, 0x60, 0xF2, 0x9F, 0xB6,
+    0x79, 0x03, 0xFE, 0x10, 0x08, 0xB8, 0xBC, 0x99, 0xA4, 0x1A, 0xE9, 0xE9, 0x56, 0x28, 0xBC, 0x64,
+    0xF2, 0xF1, 0xB2, 0x0C, 0x2D, 0x7E, 0x9F, 0x51, 0x77, 0xA3, 0xC2, 0x94, 0xD4, 0x46, 0x22, 0x99,
+};
+
+static const U2fEccTestVector u2f_ecc_test_vectors[] = {
+    {
+        .message = "sample",
+        .hash = {0xAF, 0x2B, 0xDB, 0xE1, 0xAA, 0x9B, 0x6E, 0xC1, 0xE2, 0xAD, 0xE1,
+                 0xD6, 0x94, 0xF4, 0x1F, 0xC7, 0x1A, 0x83, 0x1D, 0x02, 0x68, 0xE9,
+                 0x89, 0x15, 0x62, 0x11, 0x3D, 0x8A, 0x62, 0xAD, 0xD1, 0xBF},
+        .k = {0xA6, 0xE3, 0xC5, 0x7D, 0xD0, 0x1A, 0xBE, 0x90, 0x08, 0x65, 0x38,
+              0x39, 0x83, 0x55, 0xDD, 0x4C, 0x3B, 0x17, 0xAA, 0x87, 0x33, 0x82,
+              0xB0, 0xF2, 0x4D, 0x61, 0x29, 0x49, 0x3D, 0x8A, 0xAD, 0x60},
+        .signature = {0xEF, 0xD4, 0x8B, 0x2A, 0xAC, 0xB6, 0xA8, 0xFD, 0x11, 0x40, 0xDD,
+                      0x9C, 0xD4, 0x5E, 0x81, 0xD6, 0x9D, 0x2C, 0x87, 0x7B, 0x56, 0xAA,
+                      0xF9, 0x91, 0xC3, 0x4D, 0x0E, 0xA8, 0x4E, 0xAF, 0x37, 0x16, 0xF7,
+                      0xCB, 0x1C, 0x94, 0x2D, 0x65, 0x7C, 0x41, 0xD4, 0x36, 0xC7, 0xA1,
+                      0xB6, 0xE2, 0x9F, 0x65, 0xF3, 0xE9, 0x00, 0xDB, 0xB9, 0xAF, 0xF4,
+                      0x06, 0x4D, 0xC4, 0xAB, 0x2F, 0x84, 0x3A, 0xCD, 0xA8},
+    },
+    {
+        .message = "test",
+        .hash = {0x9F, 0x86, 0xD0, 0x81, 0x88, 0x4C, 0x7D, 0x65, 0x9A, 0x2F, 0xEA,
+                 0xA0, 0xC5, 0x5A, 0xD0, 0x15, 0xA3, 0xBF, 0x4F, 0x1B, 0x2B, 0x0B,
+                 0x82, 0x2C, 0xD1, 0x5D, 0x6C, 0x15, 0xB0, 0xF0, 0x0A, 0x08},
+        .k = {0xD1, 0x6B, 0x6A, 0xE8, 0x27, 0xF1, 0x71, 0x75, 0xE0, 0x40, 0x87,
+              0x1A, 0x1C, 0x7E, 0xC3, 0x50, 0x01, 0x92, 0xC4, 0xC9, 0x26, 0x77,
+              0x33, 0x6E, 0xC2, 0x53, 0x7A, 0xCA, 0xEE, 0x00, 0x08, 0xE0},
+        .signature = {0xF1, 0xAB, 0xB0, 0x23, 0x51, 0x83, 0x51, 0xCD, 0x71, 0xD8, 0x81,
+                      0x56, 0x7B, 0x1E, 0xA6, 0x63, 0xED, 0x3E, 0xFC, 0xF6, 0xC5, 0x13,
+                      0x2B, 0x35, 0x4F, 0x28, 0xD3, 0xB0, 0xB7, 0xD3, 0x83, 0x67, 0x01,
+                      0x9F, 0x41, 0x13, 0x74, 0x2A, 0x2B, 0x14, 0xBD, 0x25, 0x92, 0x6B,
+                      0x49, 0xC6, 0x49, 0x15, 0x5F, 0x26, 0x7E, 0x60, 0xD3, 0x81, 0x4B,
+                      0x4C, 0x0C, 0xC8, 0x42, 0x50, 0xE4, 0x6F, 0x00, 0x83},
+    },
+};
+
+// Curve order n, edge scalars are derived from it
+static const uint8_t u2f_ecc_test_order[U2F_ECC_TEST_KEY_SIZE] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51,
+};
+
+static const uint8_t u2f_ecc_test_generator[U2F_ECC_TEST_KEY_SIZE * 2] = {
+    0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+    0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+    0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+    0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
+};
+
+// y of -G = (n - 1) * G
+static const uint8_t u2f_ecc_test_generator_neg_y[U2F_ECC_TEST_KEY_SIZE] = {
+    0xB0, 0x1C, 0xBD, 0x1C, 0x01, 0xE5, 0x80, 0x65, 0x71, 0x18, 0x14, 0xB5, 0x83, 0xF0, 0x61, 0xE9,
+    0xD4, 0x31, 0xCC, 0xA9, 0x94, 0xCE, 0xA1, 0x31, 0x34, 0x49, 0xBF, 0x97, 0xC8, 0x40, 0xAE, 0x0A,
+};
+
+static int u2f_ecc_test_random(uint8_t* dest, unsigned size) {
+    furi_hal_random_fill_buf(dest, size);
+    return 1;
+}
+
+// Public key and signature with both comb and ladder, results must be the same
+static bool u2f_ecc_test_compare(const uint8_t* private, const uint8_t* k, uECC_Curve curve) {
+    uint8_t public[2][U2F_ECC_TEST_KEY_SIZE * 2];
+    uint8_t signature[2][U2F_ECC_TEST_KEY_SIZE * 2];
+    const uint8_t* hash = u2f_ecc_test_vectors[0].hash;
+
+    for(size_t i = 0; i < 2; i++) {
+        uECC_set_fixed_base_comb(i == 0);
+        if(!uECC_compute_public_key(private, public[i], curve)) return false;
+        if(!uECC_sign_with_k(private, hash, U2F_ECC_TEST_KEY_SIZE, k, signature[i], curve))
+            return false;
+    }
+    uECC_set_fixed_base_comb(true);
+
+    return memcmp(public[0], public[1], sizeof(public[0])) == 0 &&
+           memcmp(signature[0], signature[1], sizeof(signature[0])) == 0;
+}
+
+MU_TEST(u2f_ecc_vectors_test) {
+    uECC_Curve curve = uECC_secp256r1();
+    uint8_t public[U2F_ECC_TEST_KEY_SIZE * 2];
+    uint8_t signature[U2F_ECC_TEST_KEY_SIZE * 2];
+
+    for(size_t comb = 0; comb < 2; comb++) {
+        uECC_set_fixed_base_comb(comb);
+        mu_check(uECC_compute_public_key(u2f_ecc_test_private, public, curve));
+        mu_check(memcmp(public, u2f_ecc_test_public, sizeof(public)) == 0);
+
+        for(size_t i = 0; i < COUNT_OF(u2f_ecc_test_vectors); i++) {
+            const U2fEccTestVector* vector = &u2f_ecc_test_vectors[i];
+            mu_check(uECC_sign_with_k(
+                u2f_ecc_test_private,
+                vector->hash,
+                sizeof(vector->hash),
+                vector->k,
+                signature,
+                curve));
+            mu_assert(
+                memcmp(signature, vector->signature, sizeof(signature)) == 0, vector->message);
+            mu_check(uECC_verify(public, vector->hash, sizeof(vector->hash), signature, curve));
+        }
+    }
+    uECC_set_fixed_base_comb(true);
+}
+
+MU_TEST(u2f_ecc_edge_test) {
+    uECC_Curve curve = uECC_secp256r1();
+    uint8_t scalar[U2F_ECC_TEST_KEY_SIZE];
+    uint8_t public[U2F_ECC_TEST_KEY_SIZE * 2];
+
+    // Ladder can't handle 1, n - 2 and n - 1 and returns error, comb results are checked directly
+    memset(scalar, 0, sizeof(scalar));
+    scalar[U2F_ECC_TEST_KEY_SIZE - 1] = 1;
+    mu_check(uECC_compute_public_key(scalar, public, curve));
+    mu_check(memcmp(public, u2f_ecc_test_generator, sizeof(public)) == 0);
+
+    memcpy(scalar, u2f_ecc_test_order, sizeof(scalar));
+    scalar[U2F_ECC_TEST_KEY_SIZE - 1] -= 1;
+    mu_check(uECC_compute_public_key(scalar, public, curve));
+    mu_check(memcmp(public, u2f_ecc_test_generator, U2F_ECC_TEST_KEY_SIZE) == 0);
+    mu_check(
+        memcmp(
+            public + U2F_ECC_TEST_KEY_SIZE,
+            u2f_ecc_test_generator_neg_y,
+            U2F_ECC_TEST_KEY_SIZE) == 0);
+
+    // 2 and n - 3, even scalars are negated inside comb
+    memset(scalar, 0, sizeof(scalar));
+    scalar[U2F_ECC_TEST_KEY_SIZE - 1] = 2;
+    mu_check(u2f_ecc_test_compare(scalar, scalar, curve));
+
+    memcpy(scalar, u2f_ecc_test_order, sizeof(scalar));
+    scalar[U2F_ECC_TEST_KEY_SIZE - 1] -= 3;
+    mu_check(u2f_ecc_test_compare(scalar, scalar, curve));
+
+    // n is out of range
+    mu_check(!uECC_compute_public_key(u2f_ecc_test_order, public, curve));
+}
+
+MU_TEST(u2f_ecc_random_test) {
+    uECC_Curve curve = uECC_secp256r1();
+    uint8_t private[U2F_ECC_TEST_KEY_SIZE];
+    uint8_t k[U2F_ECC_TEST_KEY_SIZE];
+
+    for(size_t i = 0; i < U2F_ECC_TEST_RANDOM_KEYS; i++) {
+        furi_hal_random_fill_buf(private, sizeof(private));
+        furi_hal_random_fill_buf(k, sizeof(k));
+        // Keep both below n
+        private[0] &= 0x7F;
+        k[0] &= 0x7F;
+        mu_check(u2f_ecc_test_compare(private, k, curve));
+    }
+}
+
+static uint32_t u2f_ecc_test_sign_cycles(bool comb) {
+    uECC_Curve curve = uECC_secp256r1();
+    const U2fEccTestVector* vector = &u2f_ecc_test_vectors[0];
+    uint8_t signature[U2F_ECC_TEST_KEY_SIZE * 2];
+
+    uECC_set_fixed_base_comb(comb);
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < U2F_ECC_TEST_BENCH_SIGNS; i++) {
+        furi_check(uECC_sign(
+            u2f_ecc_test_private, vector->hash, sizeof(vector->hash), signature, curve));
+    }
+    cycles = DWT->CYCCNT - cycles;
+    uECC_set_fixed_base_comb(true);
+
+    return cycles / U2F_ECC_TEST_BENCH_SIGNS;
+}
+
+MU_TEST(u2f_ecc_benchmark_test) {
+    uint32_t ladder_cycles = u2f_ecc_test_sign_cycles(false);
+    uint32_t comb_cycles = u2f_ecc_test_sign_cycles(true);
+    const uint32_t cycles_per_us = SystemCoreClock / 1000000;
+
+    FURI_LOG_I(
+        TAG,
+        "Sign: ladder %lu cycles (%luus), comb %lu cycles (%luus)",
+        ladder_cycles,
+        ladder_cycles / cycles_per_us,
+        comb_cycles,
+        comb_cycles / cycles_per_us);
+    mu_check(comb_cycles * 2 < ladder_cycles);
+}
+
+MU_TEST_SUITE(u2f_ecc_suite) {
+    uECC_RNG_Function rng = uECC_get_rng();
+    uECC_set_rng(u2f_ecc_test_random);
+
+    MU_RUN_TEST(u2f_ecc_vectors_test);
+    MU_RUN_TEST(u2f_ecc_edge_test);
+    MU_RUN_TEST(u2f_ecc_random_test);
+    MU_RUN_TEST(u2f_ecc_benchmark_test);
+
+    uECC_set_rng(rng);
+}
+
+int run_minunit_test_u2f_ecc() {
+    MU_RUN_SUITE(u2f_ecc_suite);
+    return MU_EXIT_CODE;
+}
@@ -2,6 +2,7 @@
 #include "u2f.h"
 #include "u2f_hid.h"
 #include "u2f_data.h"
+#include "u2f_counter.h"
 #include <furi_hal.h>
 #include <furi_hal_random.h>
 
@@ -79,7 +80,7 @@ static const uint8_t state_wrong_data[] = {0x6A, 0x80};
 struct U2fData {
     uint8_t device_key[32];
     uint8_t cert_key[32];
-    uint32_t counter;
+    U2fCounter counter;
     const struct uECC_Curve_t* p_curve;
     bool ready;
     bool user_present;
@@ -92,17 +93,38 @@ static int u2f_uecc_random(uint8_t* dest, unsigned size) {
     return 1;
 }
 
+static bool u2f_counter_read_callback(void* context, uint32_t* mark) {
+    return u2f_data_cnt_read(mark);
+}
+
+static bool u2f_counter_write_callback(void* context, uint32_t mark) {
+    return u2f_data_cnt_write(mark);
+}
+
+static const U2fCounterStorage u2f_counter_storage = {
+    .read = u2f_counter_read_callback,
+    .write = u2f_counter_write_callback,
+};
+
 U2fData* u2f_alloc() {
     return malloc(sizeof(U2fData));
 }
 
 void u2f_free(U2fData* U2F) {
     furi_assert(U2F);
+    if(U2F->ready && (U2F->counter.reserved != U2F->counter.value)) {
+        // Don't skip unused reserved values on next start
+        if(u2f_counter_save(&U2F->counter) == false) {
+            FURI_LOG_W(TAG, "Counter write failed");
+        }
+    }
     free(U2F);
 }
 
 bool u2f_init(U2fData* U2F) {
     furi_assert(U2F);
+    // u2f_free saves counter of ready instance only
+    U2F->ready = false;
 
     if(u2f_data_cert_check() == false) {
         FURI_LOG_E(TAG, "Certificate load error");
@@ -119,10 +141,10 @@ bool u2f_init(U2fData* U2F) {
             return false;
         }
     }
-    if(u2f_data_cnt_read(&U2F->counter) == false) {
+    u2f_counter_init(&U2F->counter, &u2f_counter_storage, U2F, U2F_COUNTER_BLOCK_SIZE);
+    if(u2f_counter_load(&U2F->counter) == false) {
         FURI_LOG_W(TAG, "Counter loading error, resetting counter");
-        U2F->counter = 0;
-        if(u2f_data_cnt_write(0) == false) {
+        if(u2f_counter_save(&U2F->counter) == false) {
             FURI_LOG_E(TAG, "Counter write failed");
             return false;
         }
@@ -256,6 +278,7 @@ static uint16_t u2f_authenticate(U2fData* U2F, uint8_t* buf) {
     uint8_t flags = 0;
     uint8_t hash[32];
     uint8_t signature[64];
+    uint32_t counter = 0;
 
     if(u2f_data_check(false) == false) {
         U2F->ready = false;
@@ -275,11 +298,19 @@ static uint16_t u2f_authenticate(U2fData* U2F, uint8_t* buf) {
     }
     U2F->user_present = false;
 
+    // Storage is written only when reserved counter values are used up
+    if(u2f_counter_get(&U2F->counter, &counter) == false) {
+        FURI_LOG_E(TAG, "Counter write failed");
+        if(U2F->callback != NULL) U2F->callback(U2fNotifyError, U2F->context);
+        memcpy(&buf[0], state_not_supported, 2);
+        return 2;
+    }
+
     // Generate hash
     sha256_start(&sha_ctx);
     sha256_update(&sha_ctx, req->app_id, 32);
     sha256_update(&sha_ctx, &flags, 1);
-    sha256_update(&sha_ctx, (uint8_t*)&(U2F->counter), 4);
+    sha256_update(&sha_ctx, (uint8_t*)&counter, 4);
     sha256_update(&sha_ctx, req->challenge, 32);
     sha256_finish(&sha_ctx, hash);
 
@@ -309,13 +340,12 @@ static uint16_t u2f_authenticate(U2fData* U2F, uint8_t* buf) {
     uECC_sign(priv_key, hash, 32, signature, U2F->p_curve);
 
     resp->user_present = flags;
-    resp->counter = U2F->counter;
+    resp->counter = counter;
     uint8_t signature_len = u2f_der_encode_signature(resp->signature, signature);
     memcpy(resp->signature + signature_len, state_no_error, 2);
 
-    FURI_LOG_D(TAG, "Counter: %lu", U2F->counter);
-    U2F->counter++;
-    u2f_data_cnt_write(U2F->counter);
+    FURI_LOG_D(TAG, "Counter: %lu", counter);
+    u2f_counter_increment(&U2F->counter);
 
     if(U2F->callback != NULL) U2F->callback(U2fNotifyAuthSuccess, U2F->context);
 
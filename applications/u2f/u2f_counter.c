@@ -0,0 +1,54 @@
+#include "u2f_counter.h"
+
+void u2f_counter_init(
+    U2fCounter* counter,
+    const U2fCounterStorage* storage,
+    void* context,
+    uint32_t block_size) {
+    furi_assert(counter);
+    furi_assert(storage);
+    furi_assert(block_size > 0);
+    counter->storage = storage;
+    counter->context = context;
+    counter->block_size = block_size;
+    counter->value = 0;
+    counter->reserved = 0;
+}
+
+bool u2f_counter_load(U2fCounter* counter) {
+    furi_assert(counter);
+    uint32_t mark = 0;
+    bool state = counter->storage->read(counter->context, &mark);
+    // Values below mark may be used already, nothing is reserved yet
+    counter->value = state ? mark : 0;
+    counter->reserved = counter->value;
+    return state;
+}
+
+bool u2f_counter_get(U2fCounter* counter, uint32_t* value) {
+    furi_assert(counter);
+    furi_assert(value);
+
+    if(counter->value >= counter->reserved) {
+        // Mark must be stored before any value of the block is used
+        uint32_t mark = counter->value + counter->block_size;
+        if(!counter->storage->write(counter->context, mark)) return false;
+        counter->reserved = mark;
+    }
+
+    *value = counter->value;
+    return true;
+}
+
+void u2f_counter_increment(U2fCounter* counter) {
+    furi_assert(counter);
+    furi_assert(counter->value < counter->reserved);
+    counter->value++;
+}
+
+bool u2f_counter_save(U2fCounter* counter) {
+    furi_assert(counter);
+    if(!counter->storage->write(counter->context, counter->value)) return false;
+    counter->reserved = counter->value;
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <furi.h>
+
+/** Counter values reserved with one storage write */
+#define U2F_COUNTER_BLOCK_SIZE 32
+
+typedef struct {
+    bool (*read)(void* context, uint32_t* mark);
+    bool (*write)(void* context, uint32_t mark);
+} U2fCounterStorage;
+
+/** Authentication counter, kept in RAM.
+ * Storage holds the high-water mark: every value handed out is below it, so counter stays
+ * monotonic after power loss. Mark is moved one block ahead when reserved values run out.
+ */
+typedef struct {
+    const U2fCounterStorage* storage;
+    void* context;
+    uint32_t block_size;
+    uint32_t value;
+    uint32_t reserved;
+} U2fCounter;
+
+void u2f_counter_init(
+    U2fCounter* counter,
+    const U2fCounterStorage* storage,
+    void* context,
+    uint32_t block_size);
+
+/** Resume from stored mark
+ *
+ * @return false if there is no valid mark, counter starts from 0
+ */
+bool u2f_counter_load(U2fCounter* counter);
+
+/** Get current value, reserving next block first if needed
+ *
+ * @return false if block can't be stored, value must not be used
+ */
+bool u2f_counter_get(U2fCounter* counter, uint32_t* value);
+
+void u2f_counter_increment(U2fCounter* counter);
+
+/** Store exact value, giving unused reserved values back */
+bool u2f_counter_save(U2fCounter* counter);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,3 +6,9 @@ C_SOURCES		+= $(wildcard $(CORE_DIR)/*.c)
 C_SOURCES		+= $(wildcard $(CORE_DIR)/furi/*.c)
 C_SOURCES		+= $(wildcard $(CORE_DIR)/furi_hal/*.c)
 CPP_SOURCES		+= $(wildcard $(CORE_DIR)/*.cpp)
+
+# Binary event tracing, see core/furi/trace.h
+FURI_TRACE ?= 0
+ifeq ($(FURI_TRACE), 1)
+CFLAGS			+= -DFURI_TRACE
+endif
@@ -1,8 +1,12 @@
 #include "furi.h"
 
 void furi_init() {
+#ifdef FURI_TRACE
+    furi_trace_init();
+#endif
     api_interrupt_init();
     furi_log_init();
     furi_record_init();
+    furi_pubsub_init();
     furi_stdglue_init();
 }
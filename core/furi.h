@@ -14,6 +14,8 @@
 #include <furi/record.h>
 #include <furi/stdglue.h>
 #include <furi/thread.h>
+#include <furi/thread_profiler.h>
+#include <furi/trace.h>
 #include <furi/valuemutex.h>
 #include <furi/log.h>
 
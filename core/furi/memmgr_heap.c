@@ -126,11 +126,17 @@ DICT_DEF2(
 
 /* Thread allocation tracing storage */
 static MemmgrHeapThreadDict_t memmgr_heap_thread_dict = {0};
+static MemmgrHeapAllocDict_t memmgr_heap_thread_count_dict = {0};
+static MemmgrHeapAllocDict_t memmgr_heap_thread_usage_dict = {0};
+static MemmgrHeapAllocDict_t memmgr_heap_thread_peak_dict = {0};
 static volatile uint32_t memmgr_heap_thread_trace_depth = 0;
 
 /* Initialize tracing storage on start */
 void memmgr_heap_init() {
     MemmgrHeapThreadDict_init(memmgr_heap_thread_dict);
+    MemmgrHeapAllocDict_init(memmgr_heap_thread_count_dict);
+    MemmgrHeapAllocDict_init(memmgr_heap_thread_usage_dict);
+    MemmgrHeapAllocDict_init(memmgr_heap_thread_peak_dict);
 }
 
 void memmgr_heap_enable_thread_trace(osThreadId_t thread_id) {
@@ -142,6 +148,9 @@ void memmgr_heap_enable_thread_trace(osThreadId_t thread_id) {
         MemmgrHeapAllocDict_init(alloc_dict);
         MemmgrHeapThreadDict_set_at(memmgr_heap_thread_dict, (uint32_t)thread_id, alloc_dict);
         MemmgrHeapAllocDict_clear(alloc_dict);
+        MemmgrHeapAllocDict_set_at(memmgr_heap_thread_count_dict, (uint32_t)thread_id, 0);
+        MemmgrHeapAllocDict_set_at(memmgr_heap_thread_usage_dict, (uint32_t)thread_id, 0);
+        MemmgrHeapAllocDict_set_at(memmgr_heap_thread_peak_dict, (uint32_t)thread_id, 0);
         memmgr_heap_thread_trace_depth--;
     }
     (void)xTaskResumeAll();
@@ -153,6 +162,9 @@ void memmgr_heap_disable_thread_trace(osThreadId_t thread_id) {
         memmgr_heap_thread_trace_depth++;
         furi_check(MemmgrHeapThreadDict_get(memmgr_heap_thread_dict, (uint32_t)thread_id) != NULL);
         MemmgrHeapThreadDict_erase(memmgr_heap_thread_dict, (uint32_t)thread_id);
+        MemmgrHeapAllocDict_erase(memmgr_heap_thread_count_dict, (uint32_t)thread_id);
+        MemmgrHeapAllocDict_erase(memmgr_heap_thread_usage_dict, (uint32_t)thread_id);
+        MemmgrHeapAllocDict_erase(memmgr_heap_thread_peak_dict, (uint32_t)thread_id);
         memmgr_heap_thread_trace_depth--;
     }
     (void)xTaskResumeAll();
@@ -181,6 +193,38 @@ size_t memmgr_heap_get_thread_memory(osThreadId_t thread_id) {
     return leftovers;
 }
 
+size_t memmgr_heap_get_thread_alloc_count(osThreadId_t thread_id) {
+    size_t count = MEMMGR_HEAP_UNKNOWN;
+    vTaskSuspendAll();
+    {
+        memmgr_heap_thread_trace_depth++;
+        uint32_t* data =
+            MemmgrHeapAllocDict_get(memmgr_heap_thread_count_dict, (uint32_t)thread_id);
+        if(data) {
+            count = *data;
+        }
+        memmgr_heap_thread_trace_depth--;
+    }
+    (void)xTaskResumeAll();
+    return count;
+}
+
+size_t memmgr_heap_get_thread_peak_memory(osThreadId_t thread_id) {
+    size_t peak = MEMMGR_HEAP_UNKNOWN;
+    vTaskSuspendAll();
+    {
+        memmgr_heap_thread_trace_depth++;
+        uint32_t* data =
+            MemmgrHeapAllocDict_get(memmgr_heap_thread_peak_dict, (uint32_t)thread_id);
+        if(data) {
+            peak = *data;
+        }
+        memmgr_heap_thread_trace_depth--;
+    }
+    (void)xTaskResumeAll();
+    return peak;
+}
+
 #undef traceMALLOC
 static inline void traceMALLOC(void* pointer, size_t size) {
     osThreadId_t thread_id = osThreadGetId();
@@ -191,6 +235,20 @@ static inline void traceMALLOC(void* pointer, size_t size) {
         if(alloc_dict) {
             MemmgrHeapAllocDict_set_at(*alloc_dict, (uint32_t)pointer, (uint32_t)size);
         }
+        uint32_t* count =
+            MemmgrHeapAllocDict_get(memmgr_heap_thread_count_dict, (uint32_t)thread_id);
+        if(count) {
+            (*count)++;
+        }
+        // Running total: summing alloc dict on every allocation is too slow
+        uint32_t* usage =
+            MemmgrHeapAllocDict_get(memmgr_heap_thread_usage_dict, (uint32_t)thread_id);
+        uint32_t* peak =
+            MemmgrHeapAllocDict_get(memmgr_heap_thread_peak_dict, (uint32_t)thread_id);
+        if(usage && peak) {
+            *usage += size;
+            *peak = MAX(*peak, *usage);
+        }
         memmgr_heap_thread_trace_depth--;
     }
 }
@@ -203,6 +261,13 @@ static inline void traceFREE(void* pointer, size_t size) {
         MemmgrHeapAllocDict_t* alloc_dict =
             MemmgrHeapThreadDict_get(memmgr_heap_thread_dict, (uint32_t)thread_id);
         if(alloc_dict) {
+            // Only memory that thread allocated itself is taken off its usage
+            uint32_t* alloc_size = MemmgrHeapAllocDict_get(*alloc_dict, (uint32_t)pointer);
+            uint32_t* usage =
+                MemmgrHeapAllocDict_get(memmgr_heap_thread_usage_dict, (uint32_t)thread_id);
+            if(alloc_size && usage) {
+                *usage -= MIN(*usage, *alloc_size);
+            }
             MemmgrHeapAllocDict_erase(*alloc_dict, (uint32_t)pointer);
         }
         memmgr_heap_thread_trace_depth--;
@@ -34,6 +34,22 @@ void memmgr_heap_disable_thread_trace(osThreadId_t thread_id);
  */
 size_t memmgr_heap_get_thread_memory(osThreadId_t thread_id);
 
+/** Memmgr heap get count of allocations made by thread since trace start
+ *
+ * @param      thread_id  - thread id to track
+ *
+ * @return     allocations count, MEMMGR_HEAP_UNKNOWN if thread is not traced
+ */
+size_t memmgr_heap_get_thread_alloc_count(osThreadId_t thread_id);
+
+/** Memmgr heap get the most memory thread had allocated at once since trace start
+ *
+ * @param      thread_id  - thread id to track
+ *
+ * @return     bytes, MEMMGR_HEAP_UNKNOWN if thread is not traced
+ */
+size_t memmgr_heap_get_thread_peak_memory(osThreadId_t thread_id);
+
 /** Memmgr heap get the max contiguous block size on the heap
  *
  * @return     size_t max contiguous block size
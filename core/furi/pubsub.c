@@ -1,29 +1,285 @@
 #include "pubsub.h"
 #include "memmgr.h"
 #include "check.h"
+#include "common_defines.h"
+#include "thread.h"
 
-#include <m-list.h>
 #include <cmsis_os2.h>
+#include <stdbool.h>
+#include <string.h>
+#include <furi_hal_delay.h>
+
+#define FURI_PUBSUB_DISPATCHER_FLAG_READY (1UL << 0)
+#define FURI_PUBSUB_DISPATCHER_STACK_SIZE (1024)
+
+typedef struct {
+    uint8_t* slots;
+    uint32_t* timestamps;
+    size_t message_size;
+    size_t queue_size;
+    size_t head;
+    size_t count;
+    FuriPubSubAsyncPolicy policy;
+    // Message being delivered, owned by dispatcher
+    uint8_t* current;
+    // Dispatcher ready list
+    bool ready;
+    FuriPubSubSubscription* ready_next;
+} FuriPubSubAsyncQueue;
+
+// Running callback, lives on stack of the calling thread
+typedef struct FuriPubSubCall {
+    osThreadId_t thread;
+    struct FuriPubSubCall* next;
+} FuriPubSubCall;
 
 struct FuriPubSubSubscription {
+    FuriPubSub* pubsub;
     FuriPubSubCallback callback;
     void* callback_context;
+    FuriPubSubAsyncQueue* async;
+
+    // Guarded by critical section
+    bool removed;
+    FuriPubSubCall* calls;
+    FuriPubSubSubscription* garbage_next;
 };
 
-LIST_DEF(FuriPubSubSubscriptionList, FuriPubSubSubscription, M_POD_OPLIST);
+// Immutable snapshot of subscribers, replaced on each subscribe and unsubscribe
+typedef struct FuriPubSubSubscribers {
+    struct FuriPubSubSubscribers* garbage_next;
+    size_t count;
+    FuriPubSubSubscription* items[];
+} FuriPubSubSubscribers;
 
 struct FuriPubSub {
-    FuriPubSubSubscriptionList_t items;
+    // Serializes writers, never taken by publish
     osMutexId_t mutex;
+
+    // Guarded by critical section
+    FuriPubSubSubscribers* subscribers;
+    uint32_t readers;
+    FuriPubSubSubscribers* garbage_subscribers;
+    FuriPubSubSubscription* garbage_items;
+    FuriPubSubStats stats;
 };
 
+typedef struct {
+    osMutexId_t mutex;
+    FuriThread* thread;
+    osThreadId_t thread_id;
+    // Guarded by critical section
+    FuriPubSubSubscription* ready_head;
+    FuriPubSubSubscription* ready_tail;
+} FuriPubSubDispatcher;
+
+static FuriPubSubDispatcher furi_pubsub_dispatcher;
+
+static uint32_t furi_pubsub_cycles_to_us(uint32_t cycles) {
+    return cycles / (SystemCoreClock / 1000000);
+}
+
+// Must be called in critical section
+static void furi_pubsub_call_enter(
+    FuriPubSubSubscription* item,
+    FuriPubSubCall* call,
+    osThreadId_t thread) {
+    call->thread = thread;
+    call->next = item->calls;
+    item->calls = call;
+}
+
+// Must be called in critical section, calls of other threads may end in any order
+static void furi_pubsub_call_exit(FuriPubSubSubscription* item, FuriPubSubCall* call) {
+    FuriPubSubCall** it = &item->calls;
+    while(*it != call) it = &(*it)->next;
+    *it = call->next;
+}
+
+// Must be called in critical section
+static bool furi_pubsub_call_other(FuriPubSubSubscription* item, osThreadId_t thread) {
+    for(FuriPubSubCall* call = item->calls; call; call = call->next) {
+        if(call->thread != thread) return true;
+    }
+    return false;
+}
+
+static FuriPubSubSubscribers* furi_pubsub_subscribers_alloc(size_t count) {
+    FuriPubSubSubscribers* subscribers =
+        malloc(sizeof(FuriPubSubSubscribers) + count * sizeof(FuriPubSubSubscription*));
+    subscribers->garbage_next = NULL;
+    subscribers->count = count;
+    return subscribers;
+}
+
+static void furi_pubsub_subscription_free(FuriPubSubSubscription* item) {
+    if(item->async) {
+        free(item->async->slots);
+        free(item->async->timestamps);
+        free(item->async->current);
+        free(item->async);
+    }
+    free(item);
+}
+
+// Old snapshots may be in use by publish, they are freed when no publish is running.
+// Removed subscriptions are freed also when their callbacks returned.
+static void furi_pubsub_collect(FuriPubSub* pubsub) {
+    FuriPubSubSubscribers* subscribers = NULL;
+    FuriPubSubSubscription* items = NULL;
+
+    FURI_CRITICAL_ENTER();
+    if(pubsub->readers == 0) {
+        subscribers = pubsub->garbage_subscribers;
+        pubsub->garbage_subscribers = NULL;
+        items = pubsub->garbage_items;
+        pubsub->garbage_items = NULL;
+    }
+    FURI_CRITICAL_EXIT();
+
+    while(subscribers) {
+        FuriPubSubSubscribers* next = subscribers->garbage_next;
+        free(subscribers);
+        subscribers = next;
+    }
+
+    while(items) {
+        FuriPubSubSubscription* next = items->garbage_next;
+        bool busy = false;
+        {
+            FURI_CRITICAL_ENTER();
+            busy = items->calls != NULL;
+            if(busy) {
+                items->garbage_next = pubsub->garbage_items;
+                pubsub->garbage_items = items;
+            }
+            FURI_CRITICAL_EXIT();
+        }
+        if(!busy) furi_pubsub_subscription_free(items);
+        items = next;
+    }
+}
+
+static bool furi_pubsub_collect_pending(FuriPubSub* pubsub) {
+    return pubsub->garbage_subscribers || pubsub->garbage_items;
+}
+
+// Replace snapshot, must be called with writer mutex
+static void furi_pubsub_replace(
+    FuriPubSub* pubsub,
+    FuriPubSubSubscribers* subscribers,
+    FuriPubSubSubscription* removed) {
+    FURI_CRITICAL_ENTER();
+    FuriPubSubSubscribers* old = pubsub->subscribers;
+    pubsub->subscribers = subscribers;
+    old->garbage_next = pubsub->garbage_subscribers;
+    pubsub->garbage_subscribers = old;
+
+    if(removed) {
+        removed->removed = true;
+        // Drop queued messages
+        if(removed->async && removed->async->ready) {
+            FuriPubSubSubscription** it = &furi_pubsub_dispatcher.ready_head;
+            FuriPubSubSubscription* prev = NULL;
+            while(*it != removed) {
+                prev = *it;
+                it = &(*it)->async->ready_next;
+            }
+            *it = removed->async->ready_next;
+            if(furi_pubsub_dispatcher.ready_tail == removed) {
+                furi_pubsub_dispatcher.ready_tail = prev;
+            }
+            removed->async->ready = false;
+        }
+    }
+    FURI_CRITICAL_EXIT();
+}
+
+static int32_t furi_pubsub_dispatcher_thread(void* context) {
+    FuriPubSubDispatcher* dispatcher = context;
+
+    while(1) {
+        osThreadFlagsWait(FURI_PUBSUB_DISPATCHER_FLAG_READY, osFlagsWaitAny, osWaitForever);
+
+        while(1) {
+            FuriPubSubSubscription* item = NULL;
+            FuriPubSubCall call;
+            uint32_t now = DWT->CYCCNT;
+            {
+                FURI_CRITICAL_ENTER();
+                item = dispatcher->ready_head;
+                if(item) {
+                    // Take one message, subscription goes to the end of list if it has more
+                    FuriPubSubAsyncQueue* queue = item->async;
+                    dispatcher->ready_head = queue->ready_next;
+                    if(!dispatcher->ready_head) dispatcher->ready_tail = NULL;
+                    memcpy(
+                        queue->current,
+                        &queue->slots[queue->head * queue->message_size],
+                        queue->message_size);
+                    FuriPubSubStats* stats = &item->pubsub->stats;
+                    uint32_t latency =
+                        furi_pubsub_cycles_to_us(now - queue->timestamps[queue->head]);
+                    stats->async_delivered++;
+                    stats->async_latency_max = MAX(stats->async_latency_max, latency);
+                    queue->head = (queue->head + 1) % queue->queue_size;
+                    queue->count--;
+                    if(queue->count) {
+                        queue->ready_next = NULL;
+                        if(dispatcher->ready_tail) {
+                            dispatcher->ready_tail->async->ready_next = item;
+                        } else {
+                            dispatcher->ready_head = item;
+                        }
+                        dispatcher->ready_tail = item;
+                    } else {
+                        queue->ready = false;
+                    }
+                    furi_pubsub_call_enter(item, &call, dispatcher->thread_id);
+                }
+                FURI_CRITICAL_EXIT();
+            }
+            if(!item) break;
+
+            item->callback(item->async->current, item->callback_context);
+
+            FURI_CRITICAL_ENTER();
+            furi_pubsub_call_exit(item, &call);
+            FURI_CRITICAL_EXIT();
+        }
+    }
+
+    return 0;
+}
+
+static void furi_pubsub_dispatcher_start() {
+    FuriPubSubDispatcher* dispatcher = &furi_pubsub_dispatcher;
+    furi_check(osMutexAcquire(dispatcher->mutex, osWaitForever) == osOK);
+    if(!dispatcher->thread) {
+        dispatcher->thread = furi_thread_alloc();
+        furi_thread_set_name(dispatcher->thread, "PubSubDispatcher");
+        furi_thread_set_stack_size(dispatcher->thread, FURI_PUBSUB_DISPATCHER_STACK_SIZE);
+        furi_thread_set_context(dispatcher->thread, dispatcher);
+        furi_thread_set_callback(dispatcher->thread, furi_pubsub_dispatcher_thread);
+        furi_thread_start(dispatcher->thread);
+        dispatcher->thread_id = furi_thread_get_thread_id(dispatcher->thread);
+    }
+    furi_check(osMutexRelease(dispatcher->mutex) == osOK);
+}
+
+void furi_pubsub_init() {
+    furi_pubsub_dispatcher.mutex = osMutexNew(NULL);
+    furi_check(furi_pubsub_dispatcher.mutex);
+}
+
 FuriPubSub* furi_pubsub_alloc() {
     FuriPubSub* pubsub = malloc(sizeof(FuriPubSub));
+    memset(pubsub, 0, sizeof(FuriPubSub));
 
     pubsub->mutex = osMutexNew(NULL);
     furi_assert(pubsub->mutex);
 
-    FuriPubSubSubscriptionList_init(pubsub->items);
+    pubsub->subscribers = furi_pubsub_subscribers_alloc(0);
 
     return pubsub;
 }
@@ -31,28 +287,83 @@ FuriPubSub* furi_pubsub_alloc() {
 void furi_pubsub_free(FuriPubSub* pubsub) {
     furi_assert(pubsub);
 
-    furi_check(FuriPubSubSubscriptionList_size(pubsub->items) == 0);
+    furi_check(pubsub->subscribers->count == 0);
 
-    FuriPubSubSubscriptionList_clear(pubsub->items);
+    // Wait for callbacks that unsubscribed themselves
+    furi_pubsub_collect(pubsub);
+    while(furi_pubsub_collect_pending(pubsub)) {
+        osDelay(1);
+        furi_pubsub_collect(pubsub);
+    }
+
+    free(pubsub->subscribers);
 
     furi_check(osMutexDelete(pubsub->mutex) == osOK);
 
     free(pubsub);
 }
 
+static FuriPubSubSubscription* furi_pubsub_add(FuriPubSub* pubsub, FuriPubSubSubscription* item) {
+    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+
+    FuriPubSubSubscribers* old = pubsub->subscribers;
+    FuriPubSubSubscribers* subscribers = furi_pubsub_subscribers_alloc(old->count + 1);
+    memcpy(subscribers->items, old->items, old->count * sizeof(FuriPubSubSubscription*));
+    subscribers->items[old->count] = item;
+    furi_pubsub_replace(pubsub, subscribers, NULL);
+
+    furi_check(osMutexRelease(pubsub->mutex) == osOK);
+
+    furi_pubsub_collect(pubsub);
+
+    return item;
+}
+
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context) {
-    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
-    // put uninitialized item to the list
-    FuriPubSubSubscription* item = FuriPubSubSubscriptionList_push_raw(pubsub->items);
+    furi_assert(pubsub);
+    furi_assert(callback);
 
-    // initialize item
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
+    memset(item, 0, sizeof(FuriPubSubSubscription));
+    item->pubsub = pubsub;
     item->callback = callback;
     item->callback_context = callback_context;
 
-    furi_check(osMutexRelease(pubsub->mutex) == osOK);
+    return furi_pubsub_add(pubsub, item);
+}
 
-    return item;
+FuriPubSubSubscription* furi_pubsub_subscribe_async(
+    FuriPubSub* pubsub,
+    FuriPubSubCallback callback,
+    void* callback_context,
+    size_t message_size,
+    size_t queue_size,
+    FuriPubSubAsyncPolicy policy) {
+    furi_assert(pubsub);
+    furi_assert(callback);
+    furi_assert(message_size);
+    furi_assert(queue_size);
+
+    furi_pubsub_dispatcher_start();
+
+    FuriPubSubAsyncQueue* queue = malloc(sizeof(FuriPubSubAsyncQueue));
+    memset(queue, 0, sizeof(FuriPubSubAsyncQueue));
+    queue->slots = malloc(message_size * queue_size);
+    queue->timestamps = malloc(sizeof(uint32_t) * queue_size);
+    queue->current = malloc(message_size);
+    queue->message_size = message_size;
+    queue->queue_size = queue_size;
+    queue->policy = policy;
+
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
+    memset(item, 0, sizeof(FuriPubSubSubscription));
+    item->pubsub = pubsub;
+    item->callback = callback;
+    item->callback_context = callback_context;
+    item->async = queue;
+
+    return furi_pubsub_add(pubsub, item);
 }
 
 void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_subscription) {
@@ -60,36 +371,164 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
     furi_assert(pubsub_subscription);
 
     furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
-    bool result = false;
-
-    // iterate over items
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
 
-        // if the iterator is equal to our element
-        if(item == pubsub_subscription) {
-            FuriPubSubSubscriptionList_remove(pubsub->items, it);
+    FuriPubSubSubscribers* old = pubsub->subscribers;
+    furi_check(old->count > 0);
+    FuriPubSubSubscribers* subscribers = furi_pubsub_subscribers_alloc(old->count - 1);
+    bool result = false;
+    size_t count = 0;
+    for(size_t i = 0; i < old->count; i++) {
+        if(old->items[i] == pubsub_subscription) {
             result = true;
-            break;
+        } else if(count < subscribers->count) {
+            subscribers->items[count++] = old->items[i];
         }
     }
+    furi_check(result);
+    furi_pubsub_replace(pubsub, subscribers, pubsub_subscription);
 
     furi_check(osMutexRelease(pubsub->mutex) == osOK);
-    furi_check(result);
+
+    // Callback may still run in other threads, but not after return.
+    // Unsubscribing from own callback doesn't wait for calls of this thread.
+    osThreadId_t self = osThreadGetId();
+    while(1) {
+        bool busy = false;
+        {
+            FURI_CRITICAL_ENTER();
+            busy = furi_pubsub_call_other(pubsub_subscription, self);
+            FURI_CRITICAL_EXIT();
+        }
+        if(!busy) break;
+        osDelay(1);
+    }
+
+    FURI_CRITICAL_ENTER();
+    pubsub_subscription->garbage_next = pubsub->garbage_items;
+    pubsub->garbage_items = pubsub_subscription;
+    FURI_CRITICAL_EXIT();
+
+    furi_pubsub_collect(pubsub);
+}
+
+// Copy message to subscription queue, returns true if dispatcher should be notified
+static bool furi_pubsub_async_put(
+    FuriPubSub* pubsub,
+    FuriPubSubSubscription* item,
+    const void* message,
+    uint32_t timestamp) {
+    FuriPubSubAsyncQueue* queue = item->async;
+    bool notify = false;
+
+    FURI_CRITICAL_ENTER();
+    if(!item->removed) {
+        size_t slot = (queue->head + queue->count) % queue->queue_size;
+        bool put = true;
+
+        if(queue->count == queue->queue_size) {
+            if(queue->policy == FuriPubSubAsyncPolicyDropNewest) {
+                pubsub->stats.async_dropped++;
+                put = false;
+            } else if(queue->policy == FuriPubSubAsyncPolicyDropOldest) {
+                pubsub->stats.async_dropped++;
+                queue->head = (queue->head + 1) % queue->queue_size;
+                queue->count--;
+            } else {
+                // Newest queued message is replaced, keeps its place in queue
+                pubsub->stats.async_merged++;
+                slot = (queue->head + queue->count - 1) % queue->queue_size;
+                memcpy(&queue->slots[slot * queue->message_size], message, queue->message_size);
+                put = false;
+            }
+        }
+
+        if(put) {
+            memcpy(&queue->slots[slot * queue->message_size], message, queue->message_size);
+            queue->timestamps[slot] = timestamp;
+            queue->count++;
+            pubsub->stats.async_queue_depth_max =
+                MAX(pubsub->stats.async_queue_depth_max, queue->count);
+        }
+
+        if(!queue->ready && queue->count) {
+            queue->ready = true;
+            queue->ready_next = NULL;
+            if(furi_pubsub_dispatcher.ready_tail) {
+                furi_pubsub_dispatcher.ready_tail->async->ready_next = item;
+            } else {
+                furi_pubsub_dispatcher.ready_head = item;
+            }
+            furi_pubsub_dispatcher.ready_tail = item;
+            notify = true;
+        }
+    }
+    FURI_CRITICAL_EXIT();
+
+    return notify;
 }
 
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message) {
-    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    furi_assert(pubsub);
 
-    // iterate over subscribers
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-        item->callback(message, item->callback_context);
+    uint32_t start = DWT->CYCCNT;
+    FuriPubSubSubscribers* subscribers = NULL;
+    {
+        FURI_CRITICAL_ENTER();
+        pubsub->readers++;
+        subscribers = pubsub->subscribers;
+        FURI_CRITICAL_EXIT();
     }
 
-    furi_check(osMutexRelease(pubsub->mutex) == osOK);
+    // iterate over subscribers snapshot without lock
+    bool notify = false;
+    for(size_t i = 0; i < subscribers->count; i++) {
+        FuriPubSubSubscription* item = subscribers->items[i];
+        if(item->async) {
+            notify |= furi_pubsub_async_put(pubsub, item, message, start);
+            continue;
+        }
+
+        FuriPubSubCall call;
+        bool active = false;
+        {
+            FURI_CRITICAL_ENTER();
+            if(!item->removed) {
+                furi_pubsub_call_enter(item, &call, osThreadGetId());
+                active = true;
+            }
+            FURI_CRITICAL_EXIT();
+        }
+        if(active) {
+            item->callback(message, item->callback_context);
+            FURI_CRITICAL_ENTER();
+            furi_pubsub_call_exit(item, &call);
+            FURI_CRITICAL_EXIT();
+        }
+    }
+
+    if(notify) {
+        osThreadFlagsSet(furi_pubsub_dispatcher.thread_id, FURI_PUBSUB_DISPATCHER_FLAG_READY);
+    }
+
+    bool collect = false;
+    {
+        uint32_t time = furi_pubsub_cycles_to_us(DWT->CYCCNT - start);
+        FURI_CRITICAL_ENTER();
+        pubsub->stats.published++;
+        pubsub->stats.publish_time_max = MAX(pubsub->stats.publish_time_max, time);
+        pubsub->readers--;
+        collect = (pubsub->readers == 0) && furi_pubsub_collect_pending(pubsub);
+        FURI_CRITICAL_EXIT();
+    }
+    if(collect) furi_pubsub_collect(pubsub);
+}
+
+void furi_pubsub_get_stats(FuriPubSub* pubsub, FuriPubSubStats* stats) {
+    furi_assert(pubsub);
+    furi_assert(stats);
+
+    FURI_CRITICAL_ENTER();
+    *stats = pubsub->stats;
+    stats->subscribers = pubsub->subscribers->count;
+    FURI_CRITICAL_EXIT();
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -13,6 +16,28 @@ typedef struct FuriPubSub FuriPubSub;
 /** FuriPubSubSubscription type */
 typedef struct FuriPubSubSubscription FuriPubSubSubscription;
 
+/** Async subscription behavior when its queue is full */
+typedef enum {
+    FuriPubSubAsyncPolicyDropNewest, /**< New message is dropped */
+    FuriPubSubAsyncPolicyDropOldest, /**< The oldest queued message is dropped */
+    FuriPubSubAsyncPolicyMerge, /**< The newest queued message is replaced, for state updates */
+} FuriPubSubAsyncPolicy;
+
+/** FuriPubSub statistics */
+typedef struct {
+    uint32_t subscribers; /**< Current subscribers count */
+    uint32_t published; /**< Messages published */
+    uint32_t publish_time_max; /**< Longest publish including sync callbacks, us */
+    uint32_t async_delivered; /**< Messages delivered to async subscribers */
+    uint32_t async_latency_max; /**< Longest time from publish to async callback, us */
+    uint32_t async_queue_depth_max; /**< Most messages waiting in one async queue */
+    uint32_t async_dropped; /**< Messages dropped on full async queue */
+    uint32_t async_merged; /**< Messages merged on full async queue */
+} FuriPubSubStats;
+
+/** Init FuriPubSub async dispatcher, called once from furi_init */
+void furi_pubsub_init();
+
 /** Allocate FuriPubSub
  *
  * Reentrable, Not threadsafe, one owner
@@ -28,8 +53,9 @@ FuriPubSub* furi_pubsub_alloc();
 void furi_pubsub_free(FuriPubSub* pubsub);
 
 /** Subscribe to FuriPubSub
- * 
- * Threadsafe, Reentrable
+ *
+ * Callback is called in publisher thread.
+ * Threadsafe, Reentrable, can be called from callback.
  * 
  * @param      pubsub            pointer to FuriPubSub instance
  * @param[in]  callback          The callback
@@ -40,10 +66,34 @@ void furi_pubsub_free(FuriPubSub* pubsub);
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context);
 
+/** Subscribe to FuriPubSub with async delivery
+ *
+ * Message is copied to subscription queue on publish, callback is called later in
+ * dispatcher thread shared by all async subscriptions. Publisher never waits for callback.
+ * Threadsafe, Reentrable, can be called from callback.
+ *
+ * @param      pubsub            pointer to FuriPubSub instance
+ * @param[in]  callback          The callback
+ * @param      callback_context  The callback context
+ * @param      message_size      size of message to copy
+ * @param      queue_size        messages queue size
+ * @param      policy            what to do when queue is full
+ *
+ * @return     pointer to FuriPubSubSubscription instance
+ */
+FuriPubSubSubscription* furi_pubsub_subscribe_async(
+    FuriPubSub* pubsub,
+    FuriPubSubCallback callback,
+    void* callback_context,
+    size_t message_size,
+    size_t queue_size,
+    FuriPubSubAsyncPolicy policy);
+
 /** Unsubscribe from FuriPubSub
  * 
  * No use of `pubsub_subscription` allowed after call of this method
- * Threadsafe, Reentrable.
+ * Callback is not called after return, queued async messages are dropped.
+ * Threadsafe, Reentrable, can be called from callback.
  *
  * @param      pubsub               pointer to FuriPubSub instance
  * @param      pubsub_subscription  pointer to FuriPubSubSubscription instance
@@ -52,6 +102,8 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
 
 /** Publish message to FuriPubSub
  *
+ * Subscribers list is not locked, callbacks of sync subscribers are called one by one,
+ * they may run concurrently when publishing from several threads.
  * Threadsafe, Reentrable.
  * 
  * @param      pubsub   pointer to FuriPubSub instance
@@ -59,6 +111,13 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
  */
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message);
 
+/** Get FuriPubSub statistics
+ *
+ * @param      pubsub  pointer to FuriPubSub instance
+ * @param      stats   FuriPubSubStats to fill
+ */
+void furi_pubsub_get_stats(FuriPubSub* pubsub, FuriPubSubStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -150,6 +150,22 @@ void furi_thread_disable_heap_trace(FuriThread* thread);
  */
 size_t furi_thread_get_heap_size(FuriThread* thread);
 
+/** Get the most heap thread had allocated at once during last run
+ *
+ * @param      thread  FuriThread instance
+ *
+ * @return     size in bytes
+ */
+size_t furi_thread_get_heap_peak(FuriThread* thread);
+
+/** Get stack space that was never used during last run
+ *
+ * @param      thread  FuriThread instance
+ *
+ * @return     size in bytes, valid after thread callback returns
+ */
+size_t furi_thread_get_stack_space(FuriThread* thread);
+
 #ifdef __cplusplus
 }
 #endif
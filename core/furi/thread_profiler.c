@@ -0,0 +1,230 @@
+#include "thread_profiler.h"
+#include "check.h"
+#include "common_defines.h"
+#include "memmgr.h"
+
+#include <stm32wbxx.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include <task_control_block.h>
+
+typedef struct {
+    UBaseType_t switches;
+    uint32_t stack_size;
+} FuriThreadProfilerExtra;
+
+typedef struct {
+    TaskHandle_t handle; /**< NULL: slot is free */
+    UBaseType_t number; /**< TCB number, handle memory may be reused by new thread */
+    char name[FURI_THREAD_PROFILER_NAME_SIZE];
+    uint32_t priority;
+    uint32_t stack_size;
+    uint32_t stack_free;
+    uint32_t* run; /**< Cycles run since thread start, per sample */
+    uint32_t* switches; /**< Times scheduled in since thread start, per sample */
+} FuriThreadProfilerSlot;
+
+struct FuriThreadProfiler {
+    size_t history;
+    size_t samples;
+    size_t latest;
+    uint32_t* ticks;
+    uint32_t* overhead;
+    uint32_t overhead_total;
+    uint32_t sample_cycles;
+    uint32_t sample_cycles_max;
+    uint32_t threads;
+    FuriThreadProfilerSlot slots[FURI_THREAD_PROFILER_THREADS_MAX];
+};
+
+FuriThreadProfiler* furi_thread_profiler_alloc(size_t history) {
+    furi_assert(history >= 2);
+    FuriThreadProfiler* profiler = malloc(sizeof(FuriThreadProfiler));
+    profiler->history = history;
+    profiler->ticks = malloc(sizeof(uint32_t) * history);
+    profiler->overhead = malloc(sizeof(uint32_t) * history);
+    for(size_t i = 0; i < FURI_THREAD_PROFILER_THREADS_MAX; i++) {
+        profiler->slots[i].run = malloc(sizeof(uint32_t) * history);
+        profiler->slots[i].switches = malloc(sizeof(uint32_t) * history);
+    }
+    return profiler;
+}
+
+void furi_thread_profiler_free(FuriThreadProfiler* profiler) {
+    furi_assert(profiler);
+    for(size_t i = 0; i < FURI_THREAD_PROFILER_THREADS_MAX; i++) {
+        free(profiler->slots[i].run);
+        free(profiler->slots[i].switches);
+    }
+    free(profiler->ticks);
+    free(profiler->overhead);
+    free(profiler);
+}
+
+static size_t furi_thread_profiler_index(FuriThreadProfiler* profiler, size_t age) {
+    return (profiler->latest + profiler->history - age) % profiler->history;
+}
+
+static FuriThreadProfilerSlot*
+    furi_thread_profiler_get_slot(FuriThreadProfiler* profiler, TaskStatus_t* status) {
+    FuriThreadProfilerSlot* free_slot = NULL;
+    for(size_t i = 0; i < FURI_THREAD_PROFILER_THREADS_MAX; i++) {
+        FuriThreadProfilerSlot* slot = &profiler->slots[i];
+        if(slot->handle == status->xHandle && slot->number == status->xTaskNumber) {
+            return slot;
+        } else if(!slot->handle && !free_slot) {
+            free_slot = slot;
+        }
+    }
+
+    if(free_slot) {
+        // New thread: counters were zero before it started
+        free_slot->handle = status->xHandle;
+        free_slot->number = status->xTaskNumber;
+        strlcpy(free_slot->name, status->pcTaskName, FURI_THREAD_PROFILER_NAME_SIZE);
+        memset(free_slot->run, 0, sizeof(uint32_t) * profiler->history);
+        memset(free_slot->switches, 0, sizeof(uint32_t) * profiler->history);
+    }
+    return free_slot;
+}
+
+void furi_thread_profiler_sample(FuriThreadProfiler* profiler) {
+    furi_assert(profiler);
+    uint32_t start = DWT->CYCCNT;
+
+    // Threads may be created before scheduler is suspended: retry with bigger buffer
+    TaskStatus_t* status = NULL;
+    FuriThreadProfilerExtra* extra = NULL;
+    UBaseType_t count = 0;
+    while(!count) {
+        UBaseType_t size = uxTaskGetNumberOfTasks() + 4;
+        status = malloc(sizeof(TaskStatus_t) * size);
+        extra = malloc(sizeof(FuriThreadProfilerExtra) * size);
+
+        vTaskSuspendAll();
+        count = uxTaskGetSystemState(status, size, NULL);
+        for(UBaseType_t i = 0; i < count; i++) {
+            TaskControlBlock* tcb = (TaskControlBlock*)status[i].xHandle;
+            extra[i].switches = tcb->uxTaskNumber;
+            extra[i].stack_size = (tcb->pxEndOfStack - tcb->pxStack + 1) * sizeof(StackType_t);
+        }
+        xTaskResumeAll();
+
+        if(!count) {
+            free(status);
+            free(extra);
+        }
+    }
+    uint32_t ticks = osKernelGetTickCount();
+
+    profiler->latest = (profiler->latest + 1) % profiler->history;
+    profiler->samples = MIN(profiler->samples + 1, profiler->history);
+    profiler->ticks[profiler->latest] = ticks;
+    profiler->threads = count;
+
+    bool alive[FURI_THREAD_PROFILER_THREADS_MAX] = {0};
+    for(UBaseType_t i = 0; i < count; i++) {
+        FuriThreadProfilerSlot* slot = furi_thread_profiler_get_slot(profiler, &status[i]);
+        if(!slot) continue;
+        alive[slot - profiler->slots] = true;
+        slot->priority = status[i].uxCurrentPriority;
+        slot->stack_size = extra[i].stack_size;
+        slot->stack_free = status[i].usStackHighWaterMark * sizeof(StackType_t);
+        slot->run[profiler->latest] = status[i].ulRunTimeCounter;
+        slot->switches[profiler->latest] = extra[i].switches;
+    }
+    for(size_t i = 0; i < FURI_THREAD_PROFILER_THREADS_MAX; i++) {
+        if(!alive[i]) profiler->slots[i].handle = NULL;
+    }
+    free(status);
+    free(extra);
+
+    // Keep window short enough for cycle counters to wrap at most once
+    uint32_t window_ticks_max = FURI_THREAD_PROFILER_WINDOW_MAX_MS * osKernelGetTickFreq() / 1000;
+    while(profiler->samples > 1 &&
+          ticks - profiler->ticks[furi_thread_profiler_index(profiler, profiler->samples - 1)] >
+              window_ticks_max) {
+        profiler->samples--;
+    }
+
+    profiler->sample_cycles = DWT->CYCCNT - start;
+    profiler->sample_cycles_max = MAX(profiler->sample_cycles_max, profiler->sample_cycles);
+    profiler->overhead_total += profiler->sample_cycles;
+    profiler->overhead[profiler->latest] = profiler->overhead_total;
+}
+
+static uint16_t furi_thread_profiler_share(uint64_t cycles, uint64_t wall) {
+    if(!wall) return 0;
+    return MIN(cycles * 1000 / wall, 1000);
+}
+
+static uint32_t furi_thread_profiler_rate(uint32_t count, uint32_t ms) {
+    if(!ms) return 0;
+    return (uint64_t)count * 1000 / ms;
+}
+
+size_t furi_thread_profiler_get(
+    FuriThreadProfiler* profiler,
+    FuriThreadProfilerSummary* summary,
+    FuriThreadProfilerThread* threads,
+    size_t count) {
+    furi_assert(profiler);
+    furi_assert(summary);
+    memset(summary, 0, sizeof(FuriThreadProfilerSummary));
+
+    size_t latest = profiler->latest;
+    size_t last = furi_thread_profiler_index(profiler, profiler->samples > 1 ? 1 : 0);
+    size_t oldest =
+        furi_thread_profiler_index(profiler, profiler->samples ? profiler->samples - 1 : 0);
+    uint32_t tick_freq = osKernelGetTickFreq();
+    uint32_t last_ticks = profiler->ticks[latest] - profiler->ticks[last];
+    uint32_t window_ticks = profiler->ticks[latest] - profiler->ticks[oldest];
+    // Cycle counter stops in sleep, wall time comes from ticks
+    uint64_t last_wall = (uint64_t)last_ticks * SystemCoreClock / tick_freq;
+    uint64_t window_wall = (uint64_t)window_ticks * SystemCoreClock / tick_freq;
+
+    summary->last_ms = last_ticks * 1000 / tick_freq;
+    summary->window_ms = window_ticks * 1000 / tick_freq;
+    summary->threads = profiler->threads;
+    summary->sample_cycles = profiler->sample_cycles;
+    summary->sample_cycles_max = profiler->sample_cycles_max;
+    summary->overhead_window = furi_thread_profiler_share(
+        profiler->overhead[latest] - profiler->overhead[oldest], window_wall);
+
+    uint64_t run_last = 0;
+    uint64_t run_window = 0;
+    uint32_t switches = 0;
+    size_t written = 0;
+    for(size_t i = 0; i < FURI_THREAD_PROFILER_THREADS_MAX; i++) {
+        FuriThreadProfilerSlot* slot = &profiler->slots[i];
+        if(!slot->handle) continue;
+
+        uint32_t slot_run_last = slot->run[latest] - slot->run[last];
+        uint32_t slot_run_window = slot->run[latest] - slot->run[oldest];
+        uint32_t slot_switches = slot->switches[latest] - slot->switches[oldest];
+        run_last += slot_run_last;
+        run_window += slot_run_window;
+        switches += slot_switches;
+
+        if(threads && written < count) {
+            FuriThreadProfilerThread* thread = &threads[written++];
+            thread->id = slot->handle;
+            strlcpy(thread->name, slot->name, FURI_THREAD_PROFILER_NAME_SIZE);
+            thread->priority = slot->priority;
+            thread->cpu_last = furi_thread_profiler_share(slot_run_last, last_wall);
+            thread->cpu_window = furi_thread_profiler_share(slot_run_window, window_wall);
+            thread->switches = furi_thread_profiler_rate(slot_switches, summary->window_ms);
+            thread->stack_size = slot->stack_size;
+            thread->stack_free = slot->stack_free;
+        }
+    }
+
+    // Threads that exited within window are counted as sleep
+    summary->sleep_last = last_wall ? 1000 - furi_thread_profiler_share(run_last, last_wall) : 0;
+    summary->sleep_window =
+        window_wall ? 1000 - furi_thread_profiler_share(run_window, window_wall) : 0;
+    summary->switches = furi_thread_profiler_rate(switches, summary->window_ms);
+
+    return written;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file thread_profiler.h
+ * Furi: per-thread CPU usage and stack profiler
+ *
+ * FreeRTOS run time stats count DWT cycle counter, context switch hook counts how many times
+ * each thread was scheduled in. Profiler has no thread of its own: every reader allocates
+ * profiler, samples it at its own pace and gets rates over recent samples. Cycle counter
+ * stops while core sleeps, so what threads didn't use out of wall time is sleep.
+ * Interrupts are accounted to the thread they preempted.
+ */
+
+#pragma once
+
+#include <cmsis_os2.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Threads tracked by one profiler */
+#define FURI_THREAD_PROFILER_THREADS_MAX (32)
+/** Longest window: per-thread cycle counters wrap in 2^32 cycles, ~67s at 64MHz */
+#define FURI_THREAD_PROFILER_WINDOW_MAX_MS (50000)
+/** Thread name size, same as configMAX_TASK_NAME_LEN */
+#define FURI_THREAD_PROFILER_NAME_SIZE (16)
+
+/** FuriThreadProfiler type */
+typedef struct FuriThreadProfiler FuriThreadProfiler;
+
+/** Thread stats, CPU shares are in 0.1% of wall time */
+typedef struct {
+    osThreadId_t id;
+    char name[FURI_THREAD_PROFILER_NAME_SIZE];
+    uint32_t priority;
+    uint16_t cpu_last; /**< CPU share between two last samples */
+    uint16_t cpu_window; /**< CPU share over whole window */
+    uint32_t switches; /**< Times scheduled in over whole window, per second */
+    uint32_t stack_size; /**< bytes */
+    uint32_t stack_free; /**< Stack that was never used since thread start, bytes */
+} FuriThreadProfilerThread;
+
+/** Profiler summary, shares are in 0.1% of wall time */
+typedef struct {
+    uint32_t last_ms; /**< Time between two last samples, 0 if there is one sample */
+    uint32_t window_ms; /**< Time from oldest to latest sample */
+    uint32_t threads; /**< Threads alive at latest sample */
+    uint16_t sleep_last; /**< Core clock stopped between two last samples */
+    uint16_t sleep_window; /**< Core clock stopped over whole window */
+    uint16_t overhead_window; /**< Time spent in sampling over whole window */
+    uint32_t switches; /**< Context switches over whole window, per second */
+    uint32_t sample_cycles; /**< Cycles spent in latest sample */
+    uint32_t sample_cycles_max; /**< Most cycles spent in one sample */
+} FuriThreadProfilerSummary;
+
+/** Allocate FuriThreadProfiler
+ *
+ * Not threadsafe, one owner.
+ *
+ * @param      history  samples to keep, 2 or more: window spans history - 1 periods
+ *
+ * @return     pointer to FuriThreadProfiler instance
+ */
+FuriThreadProfiler* furi_thread_profiler_alloc(size_t history);
+
+/** Free FuriThreadProfiler
+ *
+ * @param      profiler  FuriThreadProfiler instance
+ */
+void furi_thread_profiler_free(FuriThreadProfiler* profiler);
+
+/** Take sample of all threads
+ *
+ * Scheduler is suspended while threads are read, stack high-water marks take most of it.
+ * Samples older than FURI_THREAD_PROFILER_WINDOW_MAX_MS are dropped from window.
+ *
+ * @param      profiler  FuriThreadProfiler instance
+ */
+void furi_thread_profiler_sample(FuriThreadProfiler* profiler);
+
+/** Get stats from samples taken so far
+ *
+ * Threads come in order profiler first saw them. Shares and rates are 0 until there are two
+ * samples.
+ *
+ * @param      profiler  FuriThreadProfiler instance
+ * @param      summary   FuriThreadProfilerSummary to fill
+ * @param      threads   buffer for thread stats, can be NULL
+ * @param      count     buffer size, threads
+ *
+ * @return     threads written
+ */
+size_t furi_thread_profiler_get(
+    FuriThreadProfiler* profiler,
+    FuriThreadProfilerSummary* summary,
+    FuriThreadProfilerThread* threads,
+    size_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,241 @@
+#include "trace.h"
+
+#ifdef FURI_TRACE
+
+#include "check.h"
+#include "common_defines.h"
+#include "memmgr.h"
+
+#include <stm32wbxx.h>
+#include <string.h>
+#include <cmsis_os2.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef FURI_TRACE_RECORDS
+#define FURI_TRACE_RECORDS (1024)
+#endif
+
+_Static_assert(
+    (FURI_TRACE_RECORDS & (FURI_TRACE_RECORDS - 1)) == 0,
+    "FURI_TRACE_RECORDS must be power of 2");
+
+/** Cortex-M4 exceptions and STM32WB55 CPU1 interrupts */
+#define FURI_TRACE_VECTORS (16 + 63)
+#define FURI_TRACE_VECTOR_FIRST_IRQ (16)
+/** Event names are string literals, they live in flash */
+#define FURI_TRACE_NAME_AREA_SIZE (1024 * 1024)
+#define FURI_TRACE_NAMES_MAX (64)
+/** Tasks blocked on mutex at once, waits beyond that are not traced */
+#define FURI_TRACE_MUTEX_WAITERS (16)
+
+typedef void (*FuriTraceVector)();
+
+typedef struct {
+    volatile bool enabled;
+    volatile uint32_t head; /**< Records written since boot */
+    uint32_t tail; /**< First record after clear */
+    FuriTraceRecord ring[FURI_TRACE_RECORDS];
+    FuriTraceVector handlers[FURI_TRACE_VECTORS];
+    void* mutex_waiters[FURI_TRACE_MUTEX_WAITERS]; /**< Task handles, slot is freed by owner */
+} FuriTrace;
+
+static FuriTrace furi_trace = {0};
+// VTOR wants table aligned to its size rounded up to power of 2
+static FuriTraceVector furi_trace_vectors[FURI_TRACE_VECTORS] __attribute__((aligned(512)));
+
+void furi_trace_record(uint32_t id, uint32_t arg0, uint32_t arg1) {
+    if(!furi_trace.enabled) return;
+    // Preempting writer takes next slot, its timestamp may come earlier than ours
+    uint32_t index = __atomic_fetch_add(&furi_trace.head, 1, __ATOMIC_RELAXED);
+    FuriTraceRecord* record = &furi_trace.ring[index & (FURI_TRACE_RECORDS - 1)];
+    record->timestamp = DWT->CYCCNT;
+    record->id = id;
+    record->arg0 = arg0;
+    record->arg1 = arg1;
+}
+
+void furi_trace_task_switched_in(uint32_t number, const char* name) {
+    uint32_t name_head;
+    memcpy(&name_head, name, sizeof(uint32_t));
+    furi_trace_record(FuriTraceIdTaskSwitchedIn, number, name_head);
+}
+
+void furi_trace_mutex_wait(void* mutex) {
+    void* task = xTaskGetCurrentTaskHandle();
+    // Woken task that didn't get the mutex blocks again: its first wait is kept
+    for(size_t i = 0; i < FURI_TRACE_MUTEX_WAITERS; i++) {
+        if(furi_trace.mutex_waiters[i] == task) return;
+    }
+    for(size_t i = 0; i < FURI_TRACE_MUTEX_WAITERS; i++) {
+        void* empty = NULL;
+        if(__atomic_compare_exchange_n(
+               &furi_trace.mutex_waiters[i],
+               &empty,
+               task,
+               false,
+               __ATOMIC_RELAXED,
+               __ATOMIC_RELAXED)) {
+            furi_trace_record(FuriTraceIdMutexWait, (uint32_t)mutex, 0);
+            return;
+        }
+    }
+}
+
+// Only task itself frees its slot, so no atomics are needed
+static bool furi_trace_mutex_wait_end(void* task) {
+    for(size_t i = 0; i < FURI_TRACE_MUTEX_WAITERS; i++) {
+        if(furi_trace.mutex_waiters[i] == task) {
+            furi_trace.mutex_waiters[i] = NULL;
+            return true;
+        }
+    }
+    return false;
+}
+
+void furi_trace_mutex_take(void* mutex) {
+    if(furi_trace_mutex_wait_end(xTaskGetCurrentTaskHandle())) {
+        furi_trace_record(FuriTraceIdMutexTake, (uint32_t)mutex, 0);
+    }
+}
+
+void furi_trace_mutex_timeout(void* mutex) {
+    if(furi_trace_mutex_wait_end(xTaskGetCurrentTaskHandle())) {
+        furi_trace_record(FuriTraceIdMutexTimeout, (uint32_t)mutex, 0);
+    }
+}
+
+void furi_trace_task_deleted(void* task) {
+    furi_trace_mutex_wait_end(task);
+}
+
+static void furi_trace_isr() {
+    uint32_t vector = __get_IPSR();
+    furi_trace_record(FuriTraceIdIsrEnter, vector, 0);
+    furi_trace.handlers[vector]();
+    furi_trace_record(FuriTraceIdIsrExit, vector, 0);
+}
+
+void furi_trace_init() {
+    const FuriTraceVector* vectors = (const FuriTraceVector*)SCB->VTOR;
+    for(size_t i = 0; i < FURI_TRACE_VECTORS; i++) {
+        furi_trace.handlers[i] = vectors[i];
+        // System exceptions stay as is: SVC and PendSV switch context in assembly
+        furi_trace_vectors[i] = i < FURI_TRACE_VECTOR_FIRST_IRQ ? vectors[i] : furi_trace_isr;
+    }
+    __disable_irq();
+    SCB->VTOR = (uint32_t)furi_trace_vectors;
+    __DSB();
+    __ISB();
+    __enable_irq();
+
+    furi_trace.enabled = true;
+}
+
+void furi_trace_set_enabled(bool enabled) {
+    furi_trace.enabled = enabled;
+}
+
+bool furi_trace_is_enabled() {
+    return furi_trace.enabled;
+}
+
+void furi_trace_clear() {
+    furi_trace.tail = furi_trace.head;
+}
+
+size_t furi_trace_get_stats(uint32_t* records, uint32_t* lost) {
+    uint32_t written = furi_trace.head - furi_trace.tail;
+    uint32_t stored = MIN(written, (uint32_t)FURI_TRACE_RECORDS);
+    if(records) *records = stored;
+    if(lost) *lost = written - stored;
+    return FURI_TRACE_RECORDS;
+}
+
+static bool furi_trace_is_event(const FuriTraceRecord* record) {
+    return record->id == FuriTraceIdInstant || record->id == FuriTraceIdBegin ||
+           record->id == FuriTraceIdEnd;
+}
+
+static size_t furi_trace_collect_names(uint32_t first, uint32_t last, FuriTraceDumpName* names) {
+    size_t count = 0;
+    for(uint32_t i = first; i != last && count < FURI_TRACE_NAMES_MAX; i++) {
+        const FuriTraceRecord* record = &furi_trace.ring[i & (FURI_TRACE_RECORDS - 1)];
+        if(!furi_trace_is_event(record)) continue;
+        if(record->arg0 < FLASH_BASE || record->arg0 >= FLASH_BASE + FURI_TRACE_NAME_AREA_SIZE)
+            continue;
+
+        bool known = false;
+        for(size_t j = 0; j < count && !known; j++) {
+            known = names[j].pointer == record->arg0;
+        }
+        if(known) continue;
+
+        names[count].pointer = record->arg0;
+        strlcpy(names[count].name, (const char*)record->arg0, FURI_TRACE_EVENT_NAME_SIZE);
+        count++;
+    }
+    return count;
+}
+
+static size_t furi_trace_collect_threads(FuriTraceDumpThread** threads) {
+    // Threads may be created in between: retry with bigger buffer
+    TaskStatus_t* status = NULL;
+    UBaseType_t count = 0;
+    while(!count) {
+        UBaseType_t size = uxTaskGetNumberOfTasks() + 4;
+        status = malloc(sizeof(TaskStatus_t) * size);
+        count = uxTaskGetSystemState(status, size, NULL);
+        if(!count) free(status);
+    }
+
+    *threads = malloc(sizeof(FuriTraceDumpThread) * count);
+    for(UBaseType_t i = 0; i < count; i++) {
+        (*threads)[i].number = status[i].xTaskNumber;
+        strlcpy((*threads)[i].name, status[i].pcTaskName, FURI_TRACE_THREAD_NAME_SIZE);
+    }
+    free(status);
+    return count;
+}
+
+bool furi_trace_dump(FuriTraceDumpCallback callback, void* context) {
+    furi_assert(callback);
+    bool enabled = furi_trace.enabled;
+    furi_trace.enabled = false;
+
+    uint32_t records;
+    FuriTraceDumpHeader header = {
+        .magic = FURI_TRACE_MAGIC,
+        .version = FURI_TRACE_VERSION,
+        .record_size = sizeof(FuriTraceRecord),
+        .core_clock = SystemCoreClock,
+        .tick_freq = osKernelGetTickFreq(),
+    };
+    furi_trace_get_stats(&records, &header.lost);
+    header.records = records;
+    uint32_t last = furi_trace.head;
+    uint32_t first = last - records;
+
+    FuriTraceDumpThread* threads = NULL;
+    header.threads = furi_trace_collect_threads(&threads);
+    FuriTraceDumpName* names = malloc(sizeof(FuriTraceDumpName) * FURI_TRACE_NAMES_MAX);
+    header.names = furi_trace_collect_names(first, last, names);
+
+    // Ring wraps at most once
+    size_t first_index = first & (FURI_TRACE_RECORDS - 1);
+    size_t first_part = MIN(records, FURI_TRACE_RECORDS - first_index);
+    size_t first_size = first_part * sizeof(FuriTraceRecord);
+    size_t second_size = (records - first_part) * sizeof(FuriTraceRecord);
+    bool result = callback(&header, sizeof(FuriTraceDumpHeader), context);
+    result = result && callback(&furi_trace.ring[first_index], first_size, context);
+    result = result && callback(&furi_trace.ring[0], second_size, context);
+    result = result && callback(threads, header.threads * sizeof(FuriTraceDumpThread), context);
+    result = result && callback(names, header.names * sizeof(FuriTraceDumpName), context);
+
+    free(threads);
+    free(names);
+    furi_trace.enabled = enabled;
+    return result;
+}
+
+#endif
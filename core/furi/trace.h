@@ -0,0 +1,190 @@
+/**
+ * @file trace.h
+ * Furi: low-overhead binary event tracing
+ *
+ * Built with FURI_TRACE only. Trace points write fixed-size records stamped with DWT cycle
+ * counter into RAM ring, oldest records are overwritten. Ring is lock-free: slot is reserved
+ * with atomic increment, so trace points are safe in threads and interrupts of any priority.
+ * Task switches, interrupts, blocking mutex takes and tickless sleep are traced automatically.
+ * Dump is converted to Chrome trace JSON by scripts/trace.py.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FURI_TRACE_MAGIC (0x43525446)
+#define FURI_TRACE_VERSION (1)
+/** Size of thread and event names in dump */
+#define FURI_TRACE_THREAD_NAME_SIZE (16)
+#define FURI_TRACE_EVENT_NAME_SIZE (32)
+
+typedef enum {
+    FuriTraceIdNone,
+    FuriTraceIdTaskSwitchedIn, /**< arg0: TCB number, arg1: first 4 chars of name */
+    FuriTraceIdIsrEnter, /**< arg0: exception number */
+    FuriTraceIdIsrExit, /**< arg0: exception number */
+    FuriTraceIdMutexWait, /**< Thread blocks on mutex, arg0: mutex */
+    FuriTraceIdMutexTake, /**< Blocked thread took mutex, arg0: mutex */
+    FuriTraceIdMutexTimeout, /**< Blocked thread gave up, arg0: mutex */
+    FuriTraceIdSleep, /**< Tickless sleep begins, arg0: expected ticks */
+    FuriTraceIdSleepTicks, /**< Ticks slept, cycle counter doesn't count them, arg0: ticks */
+    FuriTraceIdInstant, /**< arg0: name, arg1: value */
+    FuriTraceIdBegin, /**< arg0: name, arg1: value */
+    FuriTraceIdEnd, /**< arg0: name, arg1: value */
+} FuriTraceId;
+
+/** Trace record, stored in ring and dump as is */
+typedef struct {
+    uint32_t timestamp; /**< DWT cycle counter */
+    uint32_t id; /**< FuriTraceId */
+    uint32_t arg0;
+    uint32_t arg1;
+} FuriTraceRecord;
+
+/** Dump header, followed by records oldest first, threads and event names */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t core_clock; /**< Cycle counter frequency, Hz */
+    uint32_t tick_freq; /**< OS tick frequency, Hz */
+    uint32_t records;
+    uint32_t lost; /**< Records overwritten before dump */
+    uint32_t threads;
+    uint32_t names;
+} FuriTraceDumpHeader;
+
+/** Dump thread entry: names for TCB numbers of threads alive at dump time */
+typedef struct {
+    uint32_t number;
+    char name[FURI_TRACE_THREAD_NAME_SIZE];
+} FuriTraceDumpThread;
+
+/** Dump event name entry: strings that event records point to */
+typedef struct {
+    uint32_t pointer;
+    char name[FURI_TRACE_EVENT_NAME_SIZE];
+} FuriTraceDumpName;
+
+/** Dump write callback
+ *
+ * @param      data     data to write
+ * @param      size     data size
+ * @param      context  callback context
+ *
+ * @return     true on success
+ */
+typedef bool (*FuriTraceDumpCallback)(const void* data, size_t size, void* context);
+
+#ifdef FURI_TRACE
+
+/** Trace point macros, name must be string literal */
+#define FURI_TRACE_INSTANT(name, value) \
+    furi_trace_record(FuriTraceIdInstant, (uint32_t)(name), (uint32_t)(value))
+#define FURI_TRACE_BEGIN(name, value) \
+    furi_trace_record(FuriTraceIdBegin, (uint32_t)(name), (uint32_t)(value))
+#define FURI_TRACE_END(name, value) \
+    furi_trace_record(FuriTraceIdEnd, (uint32_t)(name), (uint32_t)(value))
+
+/** Init tracing and start recording, called once from furi_init
+ *
+ * Moves vector table to RAM to hook interrupts.
+ */
+void furi_trace_init();
+
+/** Write record
+ *
+ * Threadsafe, ISR safe, a few dozen cycles.
+ *
+ * @param      id    FuriTraceId
+ * @param      arg0  first argument
+ * @param      arg1  second argument
+ */
+void furi_trace_record(uint32_t id, uint32_t arg0, uint32_t arg1);
+
+/** Record task switch, called from FreeRTOS hook
+ *
+ * @param      number  TCB number
+ * @param      name    task name
+ */
+void furi_trace_task_switched_in(uint32_t number, const char* name);
+
+/** Current task blocks on mutex, called from FreeRTOS hook
+ *
+ * Blocked task is remembered, so only its own take or timeout ends the wait.
+ *
+ * @param      mutex  mutex queue
+ */
+void furi_trace_mutex_wait(void* mutex);
+
+/** Current task took mutex, called from FreeRTOS hook
+ *
+ * @param      mutex  mutex queue
+ */
+void furi_trace_mutex_take(void* mutex);
+
+/** Current task failed to take mutex, called from FreeRTOS hook
+ *
+ * @param      mutex  mutex queue
+ */
+void furi_trace_mutex_timeout(void* mutex);
+
+/** Task is deleted, called from FreeRTOS hook
+ *
+ * @param      task  task handle
+ */
+void furi_trace_task_deleted(void* task);
+
+/** Start or stop recording
+ *
+ * @param      enabled  true to record
+ */
+void furi_trace_set_enabled(bool enabled);
+
+/** Get recording state
+ *
+ * @return     true if recording
+ */
+bool furi_trace_is_enabled();
+
+/** Drop all records */
+void furi_trace_clear();
+
+/** Get ring stats
+ *
+ * @param      records   records in ring, can be NULL
+ * @param      lost      records overwritten, can be NULL
+ *
+ * @return     ring capacity, records
+ */
+size_t furi_trace_get_stats(uint32_t* records, uint32_t* lost);
+
+/** Write dump: header, records, threads and event names
+ *
+ * Recording is paused while dump is written.
+ *
+ * @param      callback  write callback
+ * @param      context   callback context
+ *
+ * @return     true if all writes succeeded
+ */
+bool furi_trace_dump(FuriTraceDumpCallback callback, void* context);
+
+#else
+
+#define FURI_TRACE_INSTANT(name, value)
+#define FURI_TRACE_BEGIN(name, value)
+#define FURI_TRACE_END(name, value)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
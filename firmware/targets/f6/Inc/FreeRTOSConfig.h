@@ -25,7 +25,7 @@ extern uint32_t SystemCoreClock;
 /* Heap size determined automatically by linker */
 // #define configTOTAL_HEAP_SIZE                    ((size_t)0)
 #define configMAX_TASK_NAME_LEN (16)
-#define configGENERATE_RUN_TIME_STATS 0
+#define configGENERATE_RUN_TIME_STATS 1
 #define configUSE_TRACE_FACILITY 1
 #define configUSE_16_BIT_TICKS 0
 #define configUSE_MUTEXES 1
@@ -57,6 +57,43 @@ extern uint32_t SystemCoreClock;
 
 #define configIDLE_TASK_NAME "(-_-)"
 
+/* Run time stats count core cycles: DWT cycle counter is enabled by furi_hal_delay_init
+   before scheduler starts, it doesn't count while core sleeps. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() (*(volatile uint32_t*)0xE0001004UL) /* DWT->CYCCNT */
+/* TCB trace number counts how many times task was scheduled in */
+#ifdef FURI_TRACE
+#include <furi/trace.h>
+#define traceTASK_SWITCHED_IN()                                                           \
+    do {                                                                                  \
+        pxCurrentTCB->uxTaskNumber++;                                                     \
+        furi_trace_task_switched_in(pxCurrentTCB->uxTCBNumber, pxCurrentTCB->pcTaskName); \
+    } while(0)
+/* Blocking mutex takes: trace remembers blocked task, take or timeout is recorded for it only */
+#define FURI_TRACE_IS_MUTEX(pxQueue)                            \
+    ((pxQueue)->ucQueueType == queueQUEUE_TYPE_MUTEX ||         \
+     (pxQueue)->ucQueueType == queueQUEUE_TYPE_RECURSIVE_MUTEX)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)                          \
+    do {                                                                 \
+        if(FURI_TRACE_IS_MUTEX(pxQueue)) furi_trace_mutex_wait(pxQueue); \
+    } while(0)
+#define traceQUEUE_RECEIVE(pxQueue)                                      \
+    do {                                                                 \
+        if(FURI_TRACE_IS_MUTEX(pxQueue)) furi_trace_mutex_take(pxQueue); \
+    } while(0)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)                                  \
+    do {                                                                    \
+        if(FURI_TRACE_IS_MUTEX(pxQueue)) furi_trace_mutex_timeout(pxQueue); \
+    } while(0)
+#define traceTASK_DELETE(pxTCB) furi_trace_task_deleted(pxTCB)
+/* Cycle counter stops in tickless sleep, trace gets ticks to fill the gap */
+#define traceLOW_POWER_IDLE_BEGIN() furi_trace_record(FuriTraceIdSleep, xExpectedIdleTime, 0)
+#define traceINCREASE_TICK_COUNT(xTicksToJump)                  \
+    furi_trace_record(FuriTraceIdSleepTicks, (xTicksToJump), 0)
+#else
+#define traceTASK_SWITCHED_IN() (pxCurrentTCB->uxTaskNumber++)
+#endif
+
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 #define INCLUDE_eTaskGetState 1
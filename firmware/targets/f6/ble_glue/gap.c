@@ -10,6 +10,10 @@
 #define FAST_ADV_TIMEOUT 30000
 #define INITIAL_ADV_TIMEOUT 60000
 
+// Longest link layer payload and its air time on 1M PHY, us
+#define DATA_LENGTH_TX_OCTETS 251
+#define DATA_LENGTH_TX_TIME 2120
+
 typedef struct {
     uint16_t gap_svc_handle;
     uint16_t dev_name_char_handle;
@@ -146,6 +150,11 @@ SVCCTL_UserEvtFlowStatus_t SVCCTL_App_Notification(void* pckt) {
                    params->supervisor_timeout)) {
                 FURI_LOG_W(TAG, "Failed to request connection parameters update");
             }
+            // Full MTU packet in one link layer PDU instead of fragments of 27 bytes
+            if(hci_le_set_data_length(
+                   gap->service.connection_handle, DATA_LENGTH_TX_OCTETS, DATA_LENGTH_TX_TIME)) {
+                FURI_LOG_W(TAG, "Failed to request data length update");
+            }
 
             // Start pairing by sending security request
             aci_gap_slave_security_req(connection_complete_event->Connection_Handle);
@@ -14,6 +14,8 @@ typedef struct {
     osMutexId_t buff_size_mtx;
     uint32_t buff_size;
     uint16_t bytes_ready_to_receive;
+    bool tx_notify;
+    bool tx_busy;
     SerialServiceEventCallback callback;
     void* context;
 } SerialSvc;
@@ -65,6 +67,22 @@ static SVCCTL_EvtAckStatus_t serial_svc_event_handler(void* event) {
                     furi_check(osMutexRelease(serial_svc->buff_size_mtx) == osOK);
                 }
                 ret = SVCCTL_EvtAckFlowEnable;
+            } else if(attribute_modified->Attr_Handle == serial_svc->tx_char_handle + 2) {
+                // Client prefers notifications if both are enabled
+                serial_svc->tx_notify = attribute_modified->Attr_Data[0] & 0x01;
+                FURI_LOG_D(TAG, "TX notifications: %d", serial_svc->tx_notify);
+                ret = SVCCTL_EvtAckFlowEnable;
+            }
+        } else if(blecore_evt->ecode == ACI_GATT_TX_POOL_AVAILABLE_VSEVT_CODE) {
+            // Only notify client that got busy, other services share the pool
+            if(serial_svc->tx_busy) {
+                serial_svc->tx_busy = false;
+                if(serial_svc->callback) {
+                    SerialServiceEvent event = {
+                        .event = SerialServiceEventTypeDataSent,
+                    };
+                    serial_svc->callback(event, serial_svc->context);
+                }
             }
         } else if(blecore_evt->ecode == ACI_GATT_SERVER_CONFIRMATION_VSEVT_CODE) {
             FURI_LOG_T(TAG, "Ack received", blecore_evt->ecode);
@@ -115,7 +133,7 @@ void serial_svc_start() {
         UUID_TYPE_128,
         (const Char_UUID_t*)char_tx_uuid,
         SERIAL_SVC_DATA_LEN_MAX,
-        CHAR_PROP_READ | CHAR_PROP_INDICATE,
+        CHAR_PROP_READ | CHAR_PROP_INDICATE | CHAR_PROP_NOTIFY,
         ATTR_PERMISSION_AUTHEN_READ,
         GATT_DONT_NOTIFY_EVENTS,
         10,
@@ -212,9 +230,15 @@ bool serial_svc_is_started() {
     return serial_svc != NULL;
 }
 
-bool serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
+uint8_t serial_svc_get_tx_window() {
+    furi_assert(serial_svc);
+    // One indication at a time, notifications are limited by stack TX pool only
+    return serial_svc->tx_notify ? 0 : 1;
+}
+
+SerialServiceTxStatus serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
     if(data_len > SERIAL_SVC_DATA_LEN_MAX) {
-        return false;
+        return SerialServiceTxStatusError;
     }
 
     for(uint16_t remained = data_len; remained > 0;) {
@@ -226,17 +250,21 @@ bool serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
             0,
             serial_svc->svc_handle,
             serial_svc->tx_char_handle,
-            remained ? 0x00 : 0x02,
+            remained ? 0x00 : (serial_svc->tx_notify ? 0x01 : 0x02),
             data_len,
             value_offset,
             value_len,
             data + value_offset);
 
-        if(result) {
+        if(result == BLE_STATUS_INSUFFICIENT_RESOURCES) {
+            // Whole value is sent again when pool is available
+            serial_svc->tx_busy = true;
+            return SerialServiceTxStatusBusy;
+        } else if(result) {
             FURI_LOG_E(TAG, "Failed updating TX characteristic: %d", result);
-            return false;
+            return SerialServiceTxStatusError;
         }
     }
 
-    return true;
+    return SerialServiceTxStatusOk;
 }
@@ -1,4 +1,5 @@
 #include "main.h"
+#include "stm32_adafruit_sd.h"
 #include <furi_hal.h>
 #include <furi.h>
 
@@ -7,6 +8,8 @@
 const uint32_t SpiTimeout = 1000;
 uint8_t SD_IO_WriteByte(uint8_t Data);
 
+static const SD_IO_Link* SdLink = NULL;
+
 /******************************************************************************
                             BUS OPERATIONS
  *******************************************************************************/
@@ -19,6 +22,10 @@ uint8_t SD_IO_WriteByte(uint8_t Data);
  * @retval None
  */
 static void SPIx_WriteReadData(const uint8_t* DataIn, uint8_t* DataOut, uint16_t DataLength) {
+    if(SdLink) {
+        SdLink->trx(DataIn, DataOut, DataLength, SdLink->context);
+        return;
+    }
     furi_check(furi_hal_spi_bus_trx(
         furi_hal_sd_spi_handle, (uint8_t*)DataIn, DataOut, DataLength, SpiTimeout));
 }
@@ -63,6 +70,10 @@ void SD_IO_Init(void) {
  * @retval None
  */
 void SD_IO_CSState(uint8_t val) {
+    if(SdLink) {
+        SdLink->cs(val == 0, SdLink->context);
+        return;
+    }
     /* Some SD Cards are prone to fail if CLK-ed too soon after CS transition. Worst case found: 8us */
     if(val == 1) {
         delay_us(10); // Exit guard time for some SD cards
@@ -97,3 +108,42 @@ uint8_t SD_IO_WriteByte(uint8_t Data) {
     SPIx_WriteReadData(&Data, &tmp, 1);
     return tmp;
 }
+
+/**
+ * @brief  Read data block from the SD, 0xFF is sent meanwhile
+ * @param  DataOut: Pointer to data buffer for read data
+ * @param  DataLength: number of bytes to read
+ * @retval None
+ */
+void SD_IO_ReceiveData(uint8_t* DataOut, uint16_t DataLength) {
+    if(SdLink) {
+        SdLink->trx(NULL, DataOut, DataLength, SdLink->context);
+        return;
+    }
+    furi_check(
+        furi_hal_spi_bus_trx_dma(furi_hal_sd_spi_handle, NULL, DataOut, DataLength, SpiTimeout));
+}
+
+/**
+ * @brief  Write data block to the SD, received data is dropped
+ * @param  DataIn: Pointer to data buffer to write
+ * @param  DataLength: number of bytes to write
+ * @retval None
+ */
+void SD_IO_TransmitData(const uint8_t* DataIn, uint16_t DataLength) {
+    if(SdLink) {
+        SdLink->trx(DataIn, NULL, DataLength, SdLink->context);
+        return;
+    }
+    furi_check(furi_hal_spi_bus_trx_dma(
+        furi_hal_sd_spi_handle, (uint8_t*)DataIn, NULL, DataLength, SpiTimeout));
+}
+
+/**
+ * @brief  Replace SPI bus with other link, must be called with SD bus acquired
+ * @param  Link: link to use, NULL to return to SPI bus
+ * @retval None
+ */
+void SD_IO_SetLink(const SD_IO_Link* Link) {
+    SdLink = Link;
+}
@@ -133,6 +133,8 @@ typedef struct {
 #define SD_CMD_LENGTH 6
 
 #define SD_MAX_TRY 100 /* Number of try */
+#define SD_MAX_TRANSFER_TRY 3 /* Number of try for block that failed to transfer */
+#define SD_MAX_BUSY_TRY 0x40000 /* Bytes to wait for card to finish programming, >250ms */
 
 #define SD_CSD_STRUCT_V1 0x2 /* CSD struct version V1 */
 #define SD_CSD_STRUCT_V2 0x1 /* CSD struct version V2 */
@@ -161,7 +163,7 @@ typedef enum {
 #define SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE \
     0xFE /* Data token start byte, Start Single Block Write */
 #define SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE \
-    0xFD /* Data token start byte, Start Multiple Block Write */
+    0xFC /* Data token start byte, Start Multiple Block Write */
 #define SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE \
     0xFD /* Data toke stop byte, Stop Multiple Block Write */
 
@@ -195,6 +197,8 @@ typedef enum {
 #define SD_CMD_SD_APP_OP_COND 41 /* CMD41 = 0x69 */
 #define SD_CMD_APP_CMD 55 /* CMD55 = 0x77 */
 #define SD_CMD_READ_OCR 58 /* CMD55 = 0x79 */
+#define SD_CMD_CRC_ON_OFF 59 /* CMD59 = 0x7B */
+#define SD_ACMD_SET_WR_BLK_ERASE_COUNT 23 /* ACMD23 = 0x57 */
 
 /**
   * @brief  SD reponses and error flags
@@ -257,6 +261,48 @@ __IO uint8_t SdStatus = SD_NOT_PRESENT;
 */
 uint16_t flag_SDHC = 0;
 
+/* flag_CRC :
+      0 : Data CRC is not checked
+      1 : Data CRC is checked by card and by us, enabled with CMD59
+*/
+uint8_t flag_CRC = 0;
+
+/* CRC16-CCITT (x^16 + x^12 + x^5 + 1) of data blocks */
+static const uint16_t SD_CRC16_Table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
 /**
   * @}
   */
@@ -266,9 +312,14 @@ static uint8_t SD_GetCIDRegister(SD_CID* Cid);
 static uint8_t SD_GetCSDRegister(SD_CSD* Csd);
 static uint8_t SD_GetDataResponse(void);
 static uint8_t SD_GoIdleState(void);
-static SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Crc, uint8_t Answer);
+static uint16_t SD_CRC16(const uint8_t* Data, uint16_t Length);
+static SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Answer);
+static uint8_t SD_StopTransmission(void);
 static uint8_t SD_WaitData(uint8_t data);
+static uint8_t SD_WaitNotBusy(void);
 static uint8_t SD_ReadData(void);
+static uint32_t SD_ReadBlocksRun(uint8_t* pData, uint32_t ReadAddr, uint32_t NumOfBlocks);
+static uint32_t SD_WriteBlocksRun(const uint8_t* pData, uint32_t WriteAddr, uint32_t NumOfBlocks);
 /** @defgroup STM32_ADAFRUIT_SD_Private_Function_Prototypes
   * @{
   */
@@ -409,85 +460,193 @@ uint8_t BSP_SD_GetCardInfo(SD_CardInfo* pCardInfo) {
 }
 
 /**
-  * @brief  Reads block(s) from a specified address in the SD card, in polling mode. 
-  * @param  pData: Pointer to the buffer that will contain the data to transmit
-  * @param  ReadAddr: Address from where data is to be read. The address is counted 
-  *                   in blocks of 512bytes
-  * @param  NumOfBlocks: Number of SD blocks to read
-  * @param  Timeout: This parameter is used for compatibility with BSP implementation
+  * @brief  Sends CMD16 (SD_CMD_SET_BLOCKLEN) to set the size of the block
+  * @param  None
   * @retval SD status
   */
-uint8_t
-    BSP_SD_ReadBlocks(uint32_t* pData, uint32_t ReadAddr, uint32_t NumOfBlocks, uint32_t Timeout) {
-    uint32_t offset = 0;
-    uint32_t addr;
-    uint8_t retr = BSP_SD_ERROR;
-    uint8_t* ptr = NULL;
+static uint8_t SD_SetBlockLength(void) {
     SD_CmdAnswer_typedef response;
-    uint16_t BlockSize = 512;
 
-    /* Send CMD16 (SD_CMD_SET_BLOCKLEN) to set the size of the block and 
-     Check if the SD acknowledged the set block length command: R1 response (0x00: no errors) */
-    response = SD_SendCmd(SD_CMD_SET_BLOCKLEN, BlockSize, 0xFF, SD_ANSWER_R1_EXPECTED);
+    /* Check if the SD acknowledged the set block length command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(SD_CMD_SET_BLOCKLEN, SD_BLOCK_SIZE, SD_ANSWER_R1_EXPECTED);
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
-    if(response.r1 != SD_R1_NO_ERROR) {
-        goto error;
-    }
 
-    ptr = malloc(sizeof(uint8_t) * BlockSize);
-    if(ptr == NULL) {
-        goto error;
-    }
-    memset(ptr, SD_DUMMY_BYTE, sizeof(uint8_t) * BlockSize);
+    return (response.r1 == SD_R1_NO_ERROR) ? BSP_SD_OK : BSP_SD_ERROR;
+}
 
-    /* Initialize the address */
-    addr = (ReadAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
+/**
+  * @brief  Converts block number to command address
+  * @param  Block: block number
+  * @retval Address in blocks for SDHC, in bytes otherwise
+  */
+static uint32_t SD_BlockAddress(uint32_t Block) {
+    return Block * ((flag_SDHC == 1) ? 1 : SD_BLOCK_SIZE);
+}
 
-    /* Data transfer */
-    while(NumOfBlocks--) {
-        /* Send CMD17 (SD_CMD_READ_SINGLE_BLOCK) to read one block */
-        /* Check if the SD acknowledged the read block command: R1 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_READ_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
-        if(response.r1 != SD_R1_NO_ERROR) {
-            goto error;
-        }
+/**
+  * @brief  Reads blocks with one command: CMD18 for many blocks, CMD17 for one.
+  *         Stops at first block that failed.
+  * @param  pData: Pointer to the buffer that will contain the data
+  * @param  ReadAddr: Address from where data is to be read, in blocks
+  * @param  NumOfBlocks: Number of SD blocks to read
+  * @retval Number of blocks read
+  */
+uint32_t SD_ReadBlocksRun(uint8_t* pData, uint32_t ReadAddr, uint32_t NumOfBlocks) {
+    uint32_t done = 0;
+    bool multiple = (NumOfBlocks > 1);
+    SD_CmdAnswer_typedef response;
 
-        /* Now look for the data token to signify the start of the data */
-        if(SD_WaitData(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ) == BSP_SD_OK) {
-            /* Read the SD block data : read NumByteToRead data */
-            SD_IO_WriteReadData(ptr, (uint8_t*)pData + offset, BlockSize);
+    /* Check if the SD acknowledged the read block command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(
+        multiple ? SD_CMD_READ_MULT_BLOCK : SD_CMD_READ_SINGLE_BLOCK,
+        SD_BlockAddress(ReadAddr),
+        SD_ANSWER_R1_EXPECTED);
 
-            /* Set next read address*/
-            offset += BlockSize;
-            addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
+    if(response.r1 == SD_R1_NO_ERROR) {
+        while(done < NumOfBlocks) {
+            uint8_t* block = pData + done * SD_BLOCK_SIZE;
 
-            /* get CRC bytes (not really needed by us, but required by SD) */
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-        } else {
-            goto error;
+            /* Now look for the data token to signify the start of the data */
+            if(SD_WaitData(SD_TOKEN_START_DATA_MULTIPLE_BLOCK_READ) != BSP_SD_OK) {
+                break;
+            }
+
+            /* Read the SD block data, then CRC bytes */
+            SD_IO_ReceiveData(block, SD_BLOCK_SIZE);
+            uint16_t crc = SD_IO_WriteByte(SD_DUMMY_BYTE) << 8;
+            crc |= SD_IO_WriteByte(SD_DUMMY_BYTE);
+            if(flag_CRC && (crc != SD_CRC16(block, SD_BLOCK_SIZE))) {
+                break;
+            }
+
+            done++;
+        }
+
+        if(multiple) {
+            SD_StopTransmission();
         }
+    }
 
-        /* End the command data read cycle */
+    /* End the command data read cycle */
+    SD_IO_CSState(1);
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+
+    return done;
+}
+
+/**
+  * @brief  Writes blocks with one command: CMD25 for many blocks, CMD24 for one.
+  *         Stops at first block that failed.
+  * @param  pData: Pointer to the buffer that contains the data to transmit
+  * @param  WriteAddr: Address where data is to be written, in blocks
+  * @param  NumOfBlocks: Number of SD blocks to write
+  * @retval Number of blocks written
+  */
+uint32_t SD_WriteBlocksRun(const uint8_t* pData, uint32_t WriteAddr, uint32_t NumOfBlocks) {
+    uint32_t done = 0;
+    bool multiple = (NumOfBlocks > 1);
+    uint8_t token = SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE;
+    SD_CmdAnswer_typedef response;
+
+    if(multiple) {
+        token = SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE;
+
+        /* Send ACMD23 (SD_ACMD_SET_WR_BLK_ERASE_COUNT) so card can pre-erase blocks to write.
+         It is only a hint: answer is not checked */
+        SD_SendCmd(SD_CMD_APP_CMD, 0, SD_ANSWER_R1_EXPECTED);
+        SD_IO_CSState(1);
+        SD_IO_WriteByte(SD_DUMMY_BYTE);
+        SD_SendCmd(SD_ACMD_SET_WR_BLK_ERASE_COUNT, NumOfBlocks, SD_ANSWER_R1_EXPECTED);
         SD_IO_CSState(1);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
     }
 
-    retr = BSP_SD_OK;
+    /* Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(
+        multiple ? SD_CMD_WRITE_MULT_BLOCK : SD_CMD_WRITE_SINGLE_BLOCK,
+        SD_BlockAddress(WriteAddr),
+        SD_ANSWER_R1_EXPECTED);
+
+    if(response.r1 == SD_R1_NO_ERROR) {
+        while(done < NumOfBlocks) {
+            const uint8_t* block = pData + done * SD_BLOCK_SIZE;
+            uint16_t crc = SD_CRC16(block, SD_BLOCK_SIZE);
+
+            /* Send dummy byte for NWR timing : one byte between CMDWRITE and TOKEN */
+            SD_IO_WriteByte(SD_DUMMY_BYTE);
+
+            /* Send the data token to signify the start of the data */
+            SD_IO_WriteByte(token);
+
+            /* Write the block data to SD, then CRC bytes */
+            SD_IO_TransmitData(block, SD_BLOCK_SIZE);
+            SD_IO_WriteByte(crc >> 8);
+            SD_IO_WriteByte(crc);
+
+            /* Read data response, card is busy until block is programmed */
+            if(SD_GetDataResponse() != SD_DATA_OK) {
+                break;
+            }
+
+            done++;
+        }
+
+        if(multiple) {
+            /* Stop token, then stuff byte and busy until card is done */
+            SD_IO_WriteByte(SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE);
+            SD_IO_WriteByte(SD_DUMMY_BYTE);
+            SD_WaitNotBusy();
+        }
+    }
 
-error:
-    /* Send dummy byte: 8 Clock pulses of delay */
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
-    if(ptr != NULL) free(ptr);
 
-    /* Return the reponse */
-    return retr;
+    return done;
+}
+
+/**
+  * @brief  Reads block(s) from a specified address in the SD card, in polling mode. 
+  *         Blocks go in one multiple block read, block that failed is retried.
+  * @param  pData: Pointer to the buffer that will contain the data to transmit
+  * @param  ReadAddr: Address from where data is to be read. The address is counted 
+  *                   in blocks of 512bytes
+  * @param  NumOfBlocks: Number of SD blocks to read
+  * @param  Timeout: This parameter is used for compatibility with BSP implementation
+  * @retval SD status
+  */
+uint8_t
+    BSP_SD_ReadBlocks(uint32_t* pData, uint32_t ReadAddr, uint32_t NumOfBlocks, uint32_t Timeout) {
+    uint8_t* data = (uint8_t*)pData;
+    uint8_t tries = 0;
+
+    if(SD_SetBlockLength() != BSP_SD_OK) {
+        return BSP_SD_ERROR;
+    }
+
+    while(NumOfBlocks > 0) {
+        uint32_t done = SD_ReadBlocksRun(data, ReadAddr, NumOfBlocks);
+        data += done * SD_BLOCK_SIZE;
+        ReadAddr += done;
+        NumOfBlocks -= done;
+        if(NumOfBlocks == 0) break;
+
+        /* Blocks before failed one are kept, failed one starts next run */
+        tries = (done > 0) ? 1 : tries + 1;
+        if(tries >= SD_MAX_TRANSFER_TRY) {
+            return BSP_SD_ERROR;
+        }
+        /* Read status to clear card errors */
+        BSP_SD_GetCardState();
+    }
+
+    return BSP_SD_OK;
 }
 
 /**
   * @brief  Writes block(s) to a specified address in the SD card, in polling mode. 
+  *         Blocks go in one multiple block write, block that failed is retried.
   * @param  pData: Pointer to the buffer that will contain the data to transmit
   * @param  WriteAddr: Address from where data is to be written. The address is counted 
   *                   in blocks of 512bytes
@@ -500,76 +659,30 @@ uint8_t BSP_SD_WriteBlocks(
     uint32_t WriteAddr,
     uint32_t NumOfBlocks,
     uint32_t Timeout) {
-    uint32_t offset = 0;
-    uint32_t addr;
-    uint8_t retr = BSP_SD_ERROR;
-    uint8_t* ptr = NULL;
-    SD_CmdAnswer_typedef response;
-    uint16_t BlockSize = 512;
-
-    /* Send CMD16 (SD_CMD_SET_BLOCKLEN) to set the size of the block and 
-     Check if the SD acknowledged the set block length command: R1 response (0x00: no errors) */
-    response = SD_SendCmd(SD_CMD_SET_BLOCKLEN, BlockSize, 0xFF, SD_ANSWER_R1_EXPECTED);
-    SD_IO_CSState(1);
-    SD_IO_WriteByte(SD_DUMMY_BYTE);
-    if(response.r1 != SD_R1_NO_ERROR) {
-        goto error;
-    }
+    const uint8_t* data = (const uint8_t*)pData;
+    uint8_t tries = 0;
 
-    ptr = malloc(sizeof(uint8_t) * BlockSize);
-    if(ptr == NULL) {
-        goto error;
+    if(SD_SetBlockLength() != BSP_SD_OK) {
+        return BSP_SD_ERROR;
     }
 
-    /* Initialize the address */
-    addr = (WriteAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
+    while(NumOfBlocks > 0) {
+        uint32_t done = SD_WriteBlocksRun(data, WriteAddr, NumOfBlocks);
+        data += done * SD_BLOCK_SIZE;
+        WriteAddr += done;
+        NumOfBlocks -= done;
+        if(NumOfBlocks == 0) break;
 
-    /* Data transfer */
-    while(NumOfBlocks--) {
-        /* Send CMD24 (SD_CMD_WRITE_SINGLE_BLOCK) to write blocks  and
-       Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_WRITE_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
-        if(response.r1 != SD_R1_NO_ERROR) {
-            goto error;
-        }
-
-        /* Send dummy byte for NWR timing : one byte between CMDWRITE and TOKEN */
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
-
-        /* Send the data token to signify the start of the data */
-        SD_IO_WriteByte(SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
-
-        /* Write the block data to SD */
-        SD_IO_WriteReadData((uint8_t*)pData + offset, ptr, BlockSize);
-
-        /* Set next write address */
-        offset += BlockSize;
-        addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
-
-        /* Put CRC bytes (not really needed by us, but required by SD) */
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
-
-        /* Read data response */
-        if(SD_GetDataResponse() != SD_DATA_OK) {
-            /* Set response value to failure */
-            goto error;
+        /* Blocks before failed one are written, failed one starts next run */
+        tries = (done > 0) ? 1 : tries + 1;
+        if(tries >= SD_MAX_TRANSFER_TRY) {
+            return BSP_SD_ERROR;
         }
-
-        SD_IO_CSState(1);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
+        /* Read status to clear card errors */
+        BSP_SD_GetCardState();
     }
-    retr = BSP_SD_OK;
-
-error:
-    if(ptr != NULL) free(ptr);
-    /* Send dummy byte: 8 Clock pulses of delay */
-    SD_IO_CSState(1);
-    SD_IO_WriteByte(SD_DUMMY_BYTE);
 
-    /* Return the reponse */
-    return retr;
+    return BSP_SD_OK;
 }
 
 /**
@@ -587,7 +700,6 @@ uint8_t BSP_SD_Erase(uint32_t StartAddr, uint32_t EndAddr) {
     response = SD_SendCmd(
         SD_CMD_SD_ERASE_GRP_START,
         (StartAddr) * (flag_SDHC == 1 ? 1 : BlockSize),
-        0xFF,
         SD_ANSWER_R1_EXPECTED);
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
@@ -596,13 +708,12 @@ uint8_t BSP_SD_Erase(uint32_t StartAddr, uint32_t EndAddr) {
         response = SD_SendCmd(
             SD_CMD_SD_ERASE_GRP_END,
             (EndAddr * 512) * (flag_SDHC == 1 ? 1 : BlockSize),
-            0xFF,
             SD_ANSWER_R1_EXPECTED);
         SD_IO_CSState(1);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
         if(response.r1 == SD_R1_NO_ERROR) {
             /* Send CMD38 (Erase) and Check if the SD acknowledged the erase command: R1 response (0x00: no errors) */
-            response = SD_SendCmd(SD_CMD_ERASE, 0, 0xFF, SD_ANSWER_R1B_EXPECTED);
+            response = SD_SendCmd(SD_CMD_ERASE, 0, SD_ANSWER_R1B_EXPECTED);
             if(response.r1 == SD_R1_NO_ERROR) {
                 retr = BSP_SD_OK;
             }
@@ -624,7 +735,7 @@ uint8_t BSP_SD_GetCardState(void) {
     SD_CmdAnswer_typedef retr;
 
     /* Send CMD13 (SD_SEND_STATUS) to get SD status */
-    retr = SD_SendCmd(SD_CMD_SEND_STATUS, 0, 0xFF, SD_ANSWER_R2_EXPECTED);
+    retr = SD_SendCmd(SD_CMD_SEND_STATUS, 0, SD_ANSWER_R2_EXPECTED);
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
 
@@ -650,7 +761,7 @@ uint8_t SD_GetCSDRegister(SD_CSD* Csd) {
     SD_CmdAnswer_typedef response;
 
     /* Send CMD9 (CSD register) or CMD10(CSD register) and Wait for response in the R1 format (0x00 is no errors) */
-    response = SD_SendCmd(SD_CMD_SEND_CSD, 0, 0xFF, SD_ANSWER_R1_EXPECTED);
+    response = SD_SendCmd(SD_CMD_SEND_CSD, 0, SD_ANSWER_R1_EXPECTED);
     if(response.r1 == SD_R1_NO_ERROR) {
         if(SD_WaitData(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ) == BSP_SD_OK) {
             for(counter = 0; counter < 16; counter++) {
@@ -756,7 +867,7 @@ uint8_t SD_GetCIDRegister(SD_CID* Cid) {
     SD_CmdAnswer_typedef response;
 
     /* Send CMD10 (CID register) and Wait for response in the R1 format (0x00 is no errors) */
-    response = SD_SendCmd(SD_CMD_SEND_CID, 0, 0xFF, SD_ANSWER_R1_EXPECTED);
+    response = SD_SendCmd(SD_CMD_SEND_CID, 0, SD_ANSWER_R1_EXPECTED);
     if(response.r1 == SD_R1_NO_ERROR) {
         if(SD_WaitData(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ) == BSP_SD_OK) {
             /* Store CID register value on CID_Tab */
@@ -831,20 +942,49 @@ uint8_t SD_GetCIDRegister(SD_CID* Cid) {
 }
 
 /**
-  * @brief  Sends 5 bytes command to the SD card and get response
+  * @brief  Computes CRC7 of command frame
+  * @param  Data: frame bytes
+  * @param  Length: number of bytes
+  * @retval CRC7 value
+  */
+static uint8_t SD_CRC7(const uint8_t* Data, uint8_t Length) {
+    uint8_t crc = 0;
+
+    /* CRC is kept in upper 7 bits: x^7 + x^3 + 1 */
+    for(uint8_t i = 0; i < Length; i++) {
+        crc ^= Data[i];
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? ((crc << 1) ^ 0x12) : (crc << 1);
+        }
+    }
+
+    return crc >> 1;
+}
+
+/**
+  * @brief  Computes CRC16 of data block
+  * @param  Data: block bytes
+  * @param  Length: number of bytes
+  * @retval CRC16 value
+  */
+static uint16_t SD_CRC16(const uint8_t* Data, uint16_t Length) {
+    uint16_t crc = 0;
+
+    for(uint16_t i = 0; i < Length; i++) {
+        crc = (crc << 8) ^ SD_CRC16_Table[(crc >> 8) ^ Data[i]];
+    }
+
+    return crc;
+}
+
+/**
+  * @brief  Sends 6 bytes command frame, CS is not changed
   * @param  Cmd: The user expected command to send to SD card.
   * @param  Arg: The command argument.
-  * @param  Crc: The CRC.
-  * @param  Answer: SD_ANSWER_NOT_EXPECTED or SD_ANSWER_EXPECTED
-  * @retval SD status
+  * @retval None
   */
-SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Crc, uint8_t Answer) {
+static void SD_SendFrame(uint8_t Cmd, uint32_t Arg) {
     uint8_t frame[SD_CMD_LENGTH], frameout[SD_CMD_LENGTH];
-    SD_CmdAnswer_typedef retr = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-
-    /* R1 Lenght = NCS(0)+ 6 Bytes command + NCR(min1 max8) + 1 Bytes answer + NEC(0) = 15bytes */
-    /* R1b identical to R1 + Busy information                                                   */
-    /* R2 Lenght = NCS(0)+ 6 Bytes command + NCR(min1 max8) + 2 Bytes answer + NEC(0) = 16bytes */
 
     /* Prepare Frame to send */
     frame[0] = (Cmd | 0x40); /* Construct byte 1 */
@@ -852,11 +992,28 @@ SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Crc, uint8_t
     frame[2] = (uint8_t)(Arg >> 16); /* Construct byte 3 */
     frame[3] = (uint8_t)(Arg >> 8); /* Construct byte 4 */
     frame[4] = (uint8_t)(Arg); /* Construct byte 5 */
-    frame[5] = (Crc | 0x01); /* Construct byte 6 */
+    frame[5] = (SD_CRC7(frame, 5) << 1) | 0x01; /* Construct byte 6 */
+
+    SD_IO_WriteReadData(frame, frameout, SD_CMD_LENGTH); /* Send the Cmd bytes */
+}
+
+/**
+  * @brief  Sends 5 bytes command to the SD card and get response
+  * @param  Cmd: The user expected command to send to SD card.
+  * @param  Arg: The command argument.
+  * @param  Answer: SD_ANSWER_NOT_EXPECTED or SD_ANSWER_EXPECTED
+  * @retval SD status
+  */
+SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Answer) {
+    SD_CmdAnswer_typedef retr = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+    /* R1 Lenght = NCS(0)+ 6 Bytes command + NCR(min1 max8) + 1 Bytes answer + NEC(0) = 15bytes */
+    /* R1b identical to R1 + Busy information                                                   */
+    /* R2 Lenght = NCS(0)+ 6 Bytes command + NCR(min1 max8) + 2 Bytes answer + NEC(0) = 16bytes */
 
     /* Send the command */
     SD_IO_CSState(0);
-    SD_IO_WriteReadData(frame, frameout, SD_CMD_LENGTH); /* Send the Cmd bytes */
+    SD_SendFrame(Cmd, Arg);
 
     switch(Answer) {
     case SD_ANSWER_R1_EXPECTED:
@@ -893,6 +1050,24 @@ SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Crc, uint8_t
     return retr;
 }
 
+/**
+  * @brief  Sends CMD12 (SD_CMD_STOP_TRANSMISSION) in the middle of multiple block read
+  *         and waits until card is ready. CS stays low.
+  * @param  None
+  * @retval R1 answer
+  */
+uint8_t SD_StopTransmission(void) {
+    uint8_t r1;
+
+    SD_SendFrame(SD_CMD_STOP_TRANSMISSION, 0);
+    /* Stuff byte: card may still be sending data */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    r1 = SD_ReadData();
+    SD_WaitNotBusy();
+
+    return r1;
+}
+
 /**
   * @brief  Gets the SD card data response and check the busy flag.
   * @param  None
@@ -912,16 +1087,10 @@ uint8_t SD_GetDataResponse(void) {
     /* Mask unused bits */
     switch(dataresponse & 0x1F) {
     case SD_DATA_OK:
-        rvalue = SD_DATA_OK;
-
-        /* Set CS High */
-        SD_IO_CSState(1);
-        /* Set CS Low */
-        SD_IO_CSState(0);
-
-        /* Wait IO line return 0xFF */
-        while(SD_IO_WriteByte(SD_DUMMY_BYTE) != 0xFF)
-            ;
+        /* Wait IO line return 0xFF, CS stays low: multiple block write goes on */
+        if(SD_WaitNotBusy() == BSP_SD_OK) {
+            rvalue = SD_DATA_OK;
+        }
         break;
     case SD_DATA_CRC_ERROR:
         rvalue = SD_DATA_CRC_ERROR;
@@ -945,12 +1114,14 @@ uint8_t SD_GetDataResponse(void) {
 uint8_t SD_GoIdleState(void) {
     SD_CmdAnswer_typedef response;
     __IO uint8_t counter;
+    /* CMD0 turns CRC checking off */
+    flag_CRC = 0;
     /* Send CMD0 (SD_CMD_GO_IDLE_STATE) to put SD in SPI mode and 
      wait for In Idle State Response (R1 Format) equal to 0x01 */
     counter = 0;
     do {
         counter++;
-        response = SD_SendCmd(SD_CMD_GO_IDLE_STATE, 0, 0x95, SD_ANSWER_R1_EXPECTED);
+        response = SD_SendCmd(SD_CMD_GO_IDLE_STATE, 0, SD_ANSWER_R1_EXPECTED);
         SD_IO_CSState(1);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
         if(counter >= SD_MAX_TRY) {
@@ -960,7 +1131,7 @@ uint8_t SD_GoIdleState(void) {
 
     /* Send CMD8 (SD_CMD_SEND_IF_COND) to check the power supply status 
      and wait until response (R7 Format) equal to 0xAA and */
-    response = SD_SendCmd(SD_CMD_SEND_IF_COND, 0x1AA, 0x87, SD_ANSWER_R7_EXPECTED);
+    response = SD_SendCmd(SD_CMD_SEND_IF_COND, 0x1AA, SD_ANSWER_R7_EXPECTED);
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
     if((response.r1 & SD_R1_ILLEGAL_COMMAND) == SD_R1_ILLEGAL_COMMAND) {
@@ -970,12 +1141,12 @@ uint8_t SD_GoIdleState(void) {
             counter++;
             /* initialise card V1 */
             /* Send CMD55 (SD_CMD_APP_CMD) before any ACMD command: R1 response (0x00: no errors) */
-            response = SD_SendCmd(SD_CMD_APP_CMD, 0x00000000, 0xFF, SD_ANSWER_R1_EXPECTED);
+            response = SD_SendCmd(SD_CMD_APP_CMD, 0x00000000, SD_ANSWER_R1_EXPECTED);
             SD_IO_CSState(1);
             SD_IO_WriteByte(SD_DUMMY_BYTE);
 
             /* Send ACMD41 (SD_CMD_SD_APP_OP_COND) to initialize SDHC or SDXC cards: R1 response (0x00: no errors) */
-            response = SD_SendCmd(SD_CMD_SD_APP_OP_COND, 0x00000000, 0xFF, SD_ANSWER_R1_EXPECTED);
+            response = SD_SendCmd(SD_CMD_SD_APP_OP_COND, 0x00000000, SD_ANSWER_R1_EXPECTED);
             SD_IO_CSState(1);
             SD_IO_WriteByte(SD_DUMMY_BYTE);
             if(counter >= SD_MAX_TRY) {
@@ -989,12 +1160,12 @@ uint8_t SD_GoIdleState(void) {
         do {
             counter++;
             /* Send CMD55 (SD_CMD_APP_CMD) before any ACMD command: R1 response (0x00: no errors) */
-            response = SD_SendCmd(SD_CMD_APP_CMD, 0, 0xFF, SD_ANSWER_R1_EXPECTED);
+            response = SD_SendCmd(SD_CMD_APP_CMD, 0, SD_ANSWER_R1_EXPECTED);
             SD_IO_CSState(1);
             SD_IO_WriteByte(SD_DUMMY_BYTE);
 
             /* Send ACMD41 (SD_CMD_SD_APP_OP_COND) to initialize SDHC or SDXC cards: R1 response (0x00: no errors) */
-            response = SD_SendCmd(SD_CMD_SD_APP_OP_COND, 0x40000000, 0xFF, SD_ANSWER_R1_EXPECTED);
+            response = SD_SendCmd(SD_CMD_SD_APP_OP_COND, 0x40000000, SD_ANSWER_R1_EXPECTED);
             SD_IO_CSState(1);
             SD_IO_WriteByte(SD_DUMMY_BYTE);
             if(counter >= SD_MAX_TRY) {
@@ -1007,15 +1178,14 @@ uint8_t SD_GoIdleState(void) {
             do {
                 counter++;
                 /* Send CMD55 (SD_CMD_APP_CMD) before any ACMD command: R1 response (0x00: no errors) */
-                response = SD_SendCmd(SD_CMD_APP_CMD, 0, 0xFF, SD_ANSWER_R1_EXPECTED);
+                response = SD_SendCmd(SD_CMD_APP_CMD, 0, SD_ANSWER_R1_EXPECTED);
                 SD_IO_CSState(1);
                 SD_IO_WriteByte(SD_DUMMY_BYTE);
                 if(response.r1 != SD_R1_IN_IDLE_STATE) {
                     return BSP_SD_ERROR;
                 }
                 /* Send ACMD41 (SD_CMD_SD_APP_OP_COND) to initialize SDHC or SDXC cards: R1 response (0x00: no errors) */
-                response =
-                    SD_SendCmd(SD_CMD_SD_APP_OP_COND, 0x00000000, 0xFF, SD_ANSWER_R1_EXPECTED);
+                response = SD_SendCmd(SD_CMD_SD_APP_OP_COND, 0x00000000, SD_ANSWER_R1_EXPECTED);
                 SD_IO_CSState(1);
                 SD_IO_WriteByte(SD_DUMMY_BYTE);
                 if(counter >= SD_MAX_TRY) {
@@ -1025,7 +1195,7 @@ uint8_t SD_GoIdleState(void) {
         }
 
         /* Send CMD58 (SD_CMD_READ_OCR) to initialize SDHC or SDXC cards: R3 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_READ_OCR, 0x00000000, 0xFF, SD_ANSWER_R3_EXPECTED);
+        response = SD_SendCmd(SD_CMD_READ_OCR, 0x00000000, SD_ANSWER_R3_EXPECTED);
         SD_IO_CSState(1);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
         if(response.r1 != SD_R1_NO_ERROR) {
@@ -1036,6 +1206,13 @@ uint8_t SD_GoIdleState(void) {
         return BSP_SD_ERROR;
     }
 
+    /* Send CMD59 (SD_CMD_CRC_ON_OFF) to check data CRC both ways: R1 response (0x00: no errors)
+     Card that refuses it is used without CRC check */
+    response = SD_SendCmd(SD_CMD_CRC_ON_OFF, 1, SD_ANSWER_R1_EXPECTED);
+    SD_IO_CSState(1);
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    flag_CRC = (response.r1 == SD_R1_NO_ERROR);
+
     return BSP_SD_OK;
 }
 
@@ -1062,7 +1239,7 @@ uint8_t SD_ReadData(void) {
 /**
   * @brief  Waits a data from the SD card
   * @param  data : Expected data from the SD card
-  * @retval BSP_SD_OK or BSP_SD_TIMEOUT
+  * @retval BSP_SD_OK, BSP_SD_ERROR if card sent error token or BSP_SD_TIMEOUT
   */
 uint8_t SD_WaitData(uint8_t data) {
     uint16_t timeout = 0xFFFF;
@@ -1073,17 +1250,39 @@ uint8_t SD_WaitData(uint8_t data) {
     do {
         readvalue = SD_IO_WriteByte(SD_DUMMY_BYTE);
         timeout--;
-    } while((readvalue != data) && timeout);
+    } while((readvalue == SD_DUMMY_BYTE) && timeout);
 
-    if(timeout == 0) {
+    if(readvalue == SD_DUMMY_BYTE) {
         /* After time out */
         return BSP_SD_TIMEOUT;
     }
 
+    if(readvalue != data) {
+        /* Error token */
+        return BSP_SD_ERROR;
+    }
+
     /* Right response got */
     return BSP_SD_OK;
 }
 
+/**
+  * @brief  Waits until card releases data line after programming
+  * @param  None
+  * @retval BSP_SD_OK or BSP_SD_TIMEOUT
+  */
+uint8_t SD_WaitNotBusy(void) {
+    uint32_t timeout = SD_MAX_BUSY_TRY;
+
+    while(SD_IO_WriteByte(SD_DUMMY_BYTE) != SD_DUMMY_BYTE) {
+        if(--timeout == 0) {
+            return BSP_SD_TIMEOUT;
+        }
+    }
+
+    return BSP_SD_OK;
+}
+
 /**
   * @}
   */
@@ -178,6 +178,20 @@ typedef struct {
 
 #define SD_DATATIMEOUT ((uint32_t)100000000)
 
+/**
+  * @brief  SD SPI link replacement, puts card emulator on the bus
+  */
+typedef struct {
+    void (*cs)(bool selected, void* context);
+    /* DataIn NULL sends 0xFF, DataOut NULL drops received bytes */
+    void (*trx)(const uint8_t* DataIn, uint8_t* DataOut, uint16_t DataLength, void* context);
+    void* context;
+} SD_IO_Link;
+
+/* Card mode, set by BSP_SD_Init: block addressing and data CRC check */
+extern uint16_t flag_SDHC;
+extern uint8_t flag_CRC;
+
 /** 
   * @brief SD Card information structure 
   */
@@ -214,6 +228,9 @@ void SD_IO_Init(void);
 void SD_IO_CSState(uint8_t state);
 void SD_IO_WriteReadData(const uint8_t* DataIn, uint8_t* DataOut, uint16_t DataLength);
 uint8_t SD_IO_WriteByte(uint8_t Data);
+void SD_IO_ReceiveData(uint8_t* DataOut, uint16_t DataLength);
+void SD_IO_TransmitData(const uint8_t* DataIn, uint16_t DataLength);
+void SD_IO_SetLink(const SD_IO_Link* Link);
 
 /* Link function for HAL delay */
 void HAL_Delay(__IO uint32_t Delay);
@@ -0,0 +1,50 @@
+#include <furi_hal_crc.h>
+#include <furi.h>
+
+#include <stm32wbxx_ll_bus.h>
+#include <stm32wbxx_ll_crc.h>
+
+#define TAG "FuriHalCrc"
+
+static osMutexId_t furi_hal_crc_mutex = NULL;
+
+void furi_hal_crc_init() {
+    furi_hal_crc_mutex = osMutexNew(NULL);
+    FURI_LOG_I(TAG, "Init OK");
+}
+
+uint32_t furi_hal_crc32(uint32_t crc, const void* buffer, size_t size) {
+    furi_assert(furi_hal_crc_mutex);
+    furi_check(osMutexAcquire(furi_hal_crc_mutex, osWaitForever) == osOK);
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_CRC);
+
+    // Reflected CRC32: bytes go in bit reversed, register holds non reflected state
+    LL_CRC_SetPolynomialSize(CRC, LL_CRC_POLYLENGTH_32B);
+    LL_CRC_SetPolynomialCoef(CRC, LL_CRC_DEFAULT_CRC32_POLY);
+    LL_CRC_SetInputDataReverseMode(CRC, LL_CRC_INDATA_REVERSE_BYTE);
+    LL_CRC_SetOutputDataReverseMode(CRC, LL_CRC_OUTDATA_REVERSE_BIT);
+    LL_CRC_SetInitialData(CRC, __RBIT(~crc));
+    LL_CRC_ResetCRCCalculationUnit(CRC);
+
+    const uint8_t* data = buffer;
+    while(size > 0 && ((uint32_t)data & 3)) {
+        LL_CRC_FeedData8(CRC, *data++);
+        size--;
+    }
+    // Unit takes most significant byte of word first
+    const uint32_t* words = (const uint32_t*)data;
+    for(; size >= 4; size -= 4) {
+        LL_CRC_FeedData32(CRC, __REV(*words++));
+    }
+    data = (const uint8_t*)words;
+    while(size > 0) {
+        LL_CRC_FeedData8(CRC, *data++);
+        size--;
+    }
+
+    crc = ~LL_CRC_ReadData32(CRC);
+
+    LL_AHB1_GRP1_DisableClock(LL_AHB1_GRP1_PERIPH_CRC);
+    furi_check(osMutexRelease(furi_hal_crc_mutex) == osOK);
+    return crc;
+}
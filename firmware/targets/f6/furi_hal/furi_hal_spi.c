@@ -8,9 +8,30 @@
 #include <stm32wbxx_ll_spi.h>
 #include <stm32wbxx_ll_utils.h>
 #include <stm32wbxx_ll_cortex.h>
+#include <stm32wbxx_ll_dma.h>
+#include <stm32wbxx_ll_bus.h>
+#include <furi_hal_interrupt.h>
 
 #define TAG "FuriHalSpi"
 
+// DMA channels are shared by all buses, DMA1 channels 1 and 2 belong to IRDA
+#define SPI_DMA DMA1
+#define SPI_DMA_RX_CHANNEL LL_DMA_CHANNEL_3
+#define SPI_DMA_TX_CHANNEL LL_DMA_CHANNEL_4
+#define SPI_DMA_RX_IRQ DMA1_Channel3_IRQn
+
+static osMutexId_t furi_hal_spi_dma_mutex = NULL;
+static osSemaphoreId_t furi_hal_spi_dma_completed = NULL;
+static const uint8_t furi_hal_spi_dma_tx_fill = 0xFF;
+static uint8_t furi_hal_spi_dma_rx_sink;
+
+static void furi_hal_spi_dma_isr() {
+    if(LL_DMA_IsActiveFlag_TC3(SPI_DMA)) {
+        LL_DMA_ClearFlag_TC3(SPI_DMA);
+        osSemaphoreRelease(furi_hal_spi_dma_completed);
+    }
+}
+
 void furi_hal_spi_init() {
     furi_hal_spi_bus_init(&furi_hal_spi_bus_r);
     furi_hal_spi_bus_init(&furi_hal_spi_bus_d);
@@ -21,6 +42,15 @@ void furi_hal_spi_init() {
     furi_hal_spi_bus_handle_init(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_spi_bus_handle_init(&furi_hal_spi_bus_handle_sd_slow);
 
+    furi_hal_spi_dma_mutex = osMutexNew(NULL);
+    furi_hal_spi_dma_completed = osSemaphoreNew(1, 0, NULL);
+
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMAMUX1);
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+    furi_hal_interrupt_set_dma_channel_isr(SPI_DMA, SPI_DMA_RX_CHANNEL, furi_hal_spi_dma_isr);
+    NVIC_SetPriority(SPI_DMA_RX_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+    NVIC_EnableIRQ(SPI_DMA_RX_IRQ);
+
     FURI_LOG_I(TAG, "Init OK");
 }
 
@@ -153,3 +183,72 @@ bool furi_hal_spi_bus_trx(
 
     return ret;
 }
+
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout) {
+    furi_assert(handle);
+    furi_assert(handle->bus->current_handle == handle);
+    furi_assert(size > 0 && size <= UINT16_MAX);
+    SPI_TypeDef* spi = handle->bus->spi;
+
+    furi_check(osMutexAcquire(furi_hal_spi_dma_mutex, osWaitForever) == osOK);
+
+    LL_DMA_InitTypeDef dma_config = {0};
+    dma_config.PeriphOrM2MSrcAddress = LL_SPI_DMA_GetRegAddr(spi);
+    dma_config.Mode = LL_DMA_MODE_NORMAL;
+    dma_config.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma_config.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+    dma_config.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+    dma_config.NbData = size;
+    dma_config.Priority = LL_DMA_PRIORITY_HIGH;
+
+    dma_config.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma_config.PeriphRequest = (spi == SPI1) ? LL_DMAMUX_REQ_SPI1_RX : LL_DMAMUX_REQ_SPI2_RX;
+    if(rx_buffer) {
+        dma_config.MemoryOrM2MDstAddress = (uint32_t)rx_buffer;
+        dma_config.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    } else {
+        dma_config.MemoryOrM2MDstAddress = (uint32_t)&furi_hal_spi_dma_rx_sink;
+        dma_config.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_NOINCREMENT;
+    }
+    LL_DMA_Init(SPI_DMA, SPI_DMA_RX_CHANNEL, &dma_config);
+
+    dma_config.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+    dma_config.PeriphRequest = (spi == SPI1) ? LL_DMAMUX_REQ_SPI1_TX : LL_DMAMUX_REQ_SPI2_TX;
+    if(tx_buffer) {
+        dma_config.MemoryOrM2MDstAddress = (uint32_t)tx_buffer;
+        dma_config.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    } else {
+        dma_config.MemoryOrM2MDstAddress = (uint32_t)&furi_hal_spi_dma_tx_fill;
+        dma_config.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_NOINCREMENT;
+    }
+    LL_DMA_Init(SPI_DMA, SPI_DMA_TX_CHANNEL, &dma_config);
+
+    // Completion is signaled by RX channel: last byte is clocked in when it fires
+    LL_DMA_ClearFlag_TC3(SPI_DMA);
+    LL_DMA_EnableIT_TC(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_SPI_EnableDMAReq_RX(spi);
+    LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_EnableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_SPI_EnableDMAReq_TX(spi);
+
+    bool ret = (osSemaphoreAcquire(furi_hal_spi_dma_completed, timeout) == osOK);
+
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_TX_CHANNEL);
+    LL_DMA_DisableChannel(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_DMA_DisableIT_TC(SPI_DMA, SPI_DMA_RX_CHANNEL);
+    LL_SPI_DisableDMAReq_TX(spi);
+    LL_SPI_DisableDMAReq_RX(spi);
+    // Completion that came after timeout must not end next transfer
+    osSemaphoreAcquire(furi_hal_spi_dma_completed, 0);
+
+    furi_hal_spi_bus_end_txrx(handle, timeout);
+    LL_SPI_ClearFlag_OVR(spi);
+
+    furi_check(osMutexRelease(furi_hal_spi_dma_mutex) == osOK);
+    return ret;
+}
@@ -28,6 +28,8 @@ typedef enum {
 typedef enum {
     UartIrqEventRXNE,
     UartIrqEventIDLE,
+    UartIrqEventORE,
+    UartIrqEventRXDMA,
     //TODO: more events
 } UartIrqEvent;
 
@@ -72,6 +74,30 @@ void furi_hal_uart_set_irq_cb(
     void (*callback)(UartIrqEvent event, uint8_t data, void* context),
     void* context);
 
+/**
+ * Starts circular DMA reception
+ * RXNE interrupt is disabled and received bytes are stored to the buffer by DMA.
+ * Callback gets UartIrqEventRXDMA on half and full buffer, UartIrqEventIDLE on idle line
+ * and UartIrqEventORE on hardware overrun. Callback must be set before the call.
+ * @param channel UART channel
+ * @param buffer receive buffer, must stay valid until furi_hal_uart_dma_rx_stop
+ * @param buffer_size buffer size (in bytes)
+ */
+void furi_hal_uart_dma_rx_start(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size);
+
+/**
+ * Stops DMA reception and returns UART to RXNE interrupt mode
+ * @param channel UART channel
+ */
+void furi_hal_uart_dma_rx_stop(FuriHalUartId channel);
+
+/**
+ * Gets DMA write position
+ * @param channel UART channel
+ * @return offset in the receive buffer where DMA will store next byte
+ */
+size_t furi_hal_uart_dma_rx_get_pos(FuriHalUartId channel);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
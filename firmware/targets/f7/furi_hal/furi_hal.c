@@ -33,6 +33,7 @@ void furi_hal_init() {
     FURI_LOG_I(TAG, "COMP1 OK");
 
     furi_hal_crypto_init();
+    furi_hal_crc_init();
 
     // VCP + USB
     furi_hal_usb_init();
@@ -440,6 +440,51 @@ void furi_hal_subghz_write_packet(const uint8_t* data, uint8_t size) {
     furi_hal_spi_release(&furi_hal_spi_bus_handle_subghz);
 }
 
+void furi_hal_subghz_write_fifo(const uint8_t* data, uint8_t size) {
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
+    cc1101_write_fifo(&furi_hal_spi_bus_handle_subghz, data, size);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_subghz);
+}
+
+void furi_hal_subghz_read_fifo(uint8_t* data, uint8_t size) {
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
+    cc1101_read_fifo_raw(&furi_hal_spi_bus_handle_subghz, data, size);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_subghz);
+}
+
+// Bytes count may be wrong if read while it changes, so read until two values match
+static uint8_t furi_hal_subghz_read_fifo_status(uint8_t reg) {
+    uint8_t status[2] = {0};
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
+    cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, reg | CC1101_BURST, &status[0]);
+    do {
+        status[1] = status[0];
+        cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, reg | CC1101_BURST, &status[0]);
+    } while(status[0] != status[1]);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_subghz);
+    return status[0];
+}
+
+uint8_t furi_hal_subghz_get_tx_bytes(bool* underflow) {
+    uint8_t status = furi_hal_subghz_read_fifo_status(CC1101_STATUS_TXBYTES);
+    CC1101TxBytes* tx_bytes = (CC1101TxBytes*)&status;
+    if(underflow) *underflow = tx_bytes->TXFIFO_UNDERFLOW;
+    return tx_bytes->NUM_TXBYTES;
+}
+
+uint8_t furi_hal_subghz_get_rx_bytes(bool* overflow) {
+    uint8_t status = furi_hal_subghz_read_fifo_status(CC1101_STATUS_RXBYTES);
+    CC1101RxBytes* rx_bytes = (CC1101RxBytes*)&status;
+    if(overflow) *overflow = rx_bytes->RXFIFO_OVERFLOW;
+    return rx_bytes->NUM_RXBYTES;
+}
+
+void furi_hal_subghz_set_gdo0(uint8_t iocfg) {
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
+    cc1101_write_reg(&furi_hal_spi_bus_handle_subghz, CC1101_IOCFG0, iocfg);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_subghz);
+}
+
 void furi_hal_subghz_flush_rx() {
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
     cc1101_flush_rx(&furi_hal_spi_bus_handle_subghz);
@@ -631,6 +676,53 @@ uint32_t furi_hal_subghz_set_frequency(uint32_t value) {
     return real_frequency;
 }
 
+uint32_t furi_hal_subghz_calibrate_channel(uint32_t value, FuriHalSubGhzChannel* channel) {
+    furi_assert(channel);
+    uint32_t real_frequency = furi_hal_subghz_set_frequency(value);
+
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
+    cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FREQ2, &channel->freq[0]);
+    cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FREQ1, &channel->freq[1]);
+    cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FREQ0, &channel->freq[2]);
+    cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FSCAL3, &channel->fscal[0]);
+    cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FSCAL2, &channel->fscal[1]);
+    cc1101_read_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FSCAL1, &channel->fscal[2]);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_subghz);
+
+    return real_frequency;
+}
+
+uint32_t furi_hal_subghz_derive_channel(
+    uint32_t value,
+    const FuriHalSubGhzChannel* reference,
+    FuriHalSubGhzChannel* channel) {
+    furi_assert(reference);
+    furi_assert(channel);
+    uint64_t real_value = (uint64_t)value * CC1101_FDIV / CC1101_QUARTZ;
+    furi_check((real_value & CC1101_FMASK) == real_value);
+
+    channel->freq[0] = (real_value >> 16) & 0xFF;
+    channel->freq[1] = (real_value >> 8) & 0xFF;
+    channel->freq[2] = (real_value >> 0) & 0xFF;
+    memcpy(channel->fscal, reference->fscal, sizeof(channel->fscal));
+
+    return (uint32_t)(real_value * CC1101_QUARTZ / CC1101_FDIV);
+}
+
+void furi_hal_subghz_rx_channel(const FuriHalSubGhzChannel* channel) {
+    furi_assert(channel);
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
+    cc1101_switch_to_idle(&furi_hal_spi_bus_handle_subghz);
+    cc1101_write_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FREQ2, channel->freq[0]);
+    cc1101_write_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FREQ1, channel->freq[1]);
+    cc1101_write_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FREQ0, channel->freq[2]);
+    cc1101_write_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FSCAL3, channel->fscal[0]);
+    cc1101_write_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FSCAL2, channel->fscal[1]);
+    cc1101_write_reg(&furi_hal_spi_bus_handle_subghz, CC1101_FSCAL1, channel->fscal[2]);
+    cc1101_switch_to_rx(&furi_hal_spi_bus_handle_subghz);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_subghz);
+}
+
 void furi_hal_subghz_set_path(FuriHalSubGhzPath path) {
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_subghz);
     if(path == FuriHalSubGhzPath433) {
@@ -2,7 +2,9 @@
 #include <stdbool.h>
 #include <stm32wbxx_ll_lpuart.h>
 #include <stm32wbxx_ll_usart.h>
+#include <stm32wbxx_ll_dma.h>
 #include <furi_hal_resources.h>
+#include <furi_hal_interrupt.h>
 
 #include <furi.h>
 #include <furi_hal_delay.h>
@@ -10,6 +12,13 @@
 static void (*irq_cb[2])(uint8_t ev, uint8_t data, void* context);
 static void* irq_ctx[2];
 
+// USART1 RX is served by DMA2 channel 1, LPUART1 RX by DMA2 channel 2
+static const uint32_t dma_rx_channel[2] = {LL_DMA_CHANNEL_1, LL_DMA_CHANNEL_2};
+static size_t dma_rx_size[2];
+
+static void furi_hal_usart_dma_rx_isr();
+static void furi_hal_lpuart_dma_rx_isr();
+
 static void furi_hal_usart_init(uint32_t baud) {
     hal_gpio_init_ex(
         &gpio_usart_tx,
@@ -184,27 +193,138 @@ void furi_hal_uart_set_irq_cb(
     }
 }
 
+void furi_hal_uart_dma_rx_start(FuriHalUartId ch, uint8_t* buffer, size_t buffer_size) {
+    furi_assert(buffer);
+    furi_assert(buffer_size > 0);
+    furi_assert(irq_cb[ch]);
+
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2);
+
+    LL_DMA_InitTypeDef dma_config = {0};
+    if(ch == FuriHalUartIdUSART1) {
+        dma_config.PeriphOrM2MSrcAddress =
+            LL_USART_DMA_GetRegAddr(USART1, LL_USART_DMA_REG_DATA_RECEIVE);
+        dma_config.PeriphRequest = LL_DMAMUX_REQ_USART1_RX;
+    } else if(ch == FuriHalUartIdLPUART1) {
+        dma_config.PeriphOrM2MSrcAddress =
+            LL_LPUART_DMA_GetRegAddr(LPUART1, LL_LPUART_DMA_REG_DATA_RECEIVE);
+        dma_config.PeriphRequest = LL_DMAMUX_REQ_LPUART1_RX;
+    }
+    dma_config.MemoryOrM2MDstAddress = (uint32_t)buffer;
+    dma_config.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma_config.Mode = LL_DMA_MODE_CIRCULAR;
+    dma_config.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma_config.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    dma_config.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+    dma_config.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+    dma_config.NbData = buffer_size;
+    dma_config.Priority = LL_DMA_PRIORITY_HIGH;
+    LL_DMA_Init(DMA2, dma_rx_channel[ch], &dma_config);
+    dma_rx_size[ch] = buffer_size;
+
+    if(ch == FuriHalUartIdUSART1) {
+        furi_hal_interrupt_set_dma_channel_isr(
+            DMA2, dma_rx_channel[ch], furi_hal_usart_dma_rx_isr);
+        LL_DMA_ClearFlag_HT1(DMA2);
+        LL_DMA_ClearFlag_TC1(DMA2);
+        NVIC_SetPriority(
+            DMA2_Channel1_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+        NVIC_EnableIRQ(DMA2_Channel1_IRQn);
+    } else if(ch == FuriHalUartIdLPUART1) {
+        furi_hal_interrupt_set_dma_channel_isr(
+            DMA2, dma_rx_channel[ch], furi_hal_lpuart_dma_rx_isr);
+        LL_DMA_ClearFlag_HT2(DMA2);
+        LL_DMA_ClearFlag_TC2(DMA2);
+        NVIC_SetPriority(
+            DMA2_Channel2_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+        NVIC_EnableIRQ(DMA2_Channel2_IRQn);
+    }
+    LL_DMA_EnableIT_HT(DMA2, dma_rx_channel[ch]);
+    LL_DMA_EnableIT_TC(DMA2, dma_rx_channel[ch]);
+    LL_DMA_EnableChannel(DMA2, dma_rx_channel[ch]);
+
+    // Bytes go to memory now, only line events are left to the UART interrupt
+    if(ch == FuriHalUartIdUSART1) {
+        LL_USART_DisableIT_RXNE_RXFNE(USART1);
+        LL_USART_EnableDMAReq_RX(USART1);
+    } else if(ch == FuriHalUartIdLPUART1) {
+        LL_LPUART_DisableIT_RXNE_RXFNE(LPUART1);
+        LL_LPUART_EnableDMAReq_RX(LPUART1);
+    }
+}
+
+void furi_hal_uart_dma_rx_stop(FuriHalUartId ch) {
+    if(ch == FuriHalUartIdUSART1) {
+        LL_USART_DisableDMAReq_RX(USART1);
+        LL_USART_EnableIT_RXNE_RXFNE(USART1);
+        NVIC_DisableIRQ(DMA2_Channel1_IRQn);
+    } else if(ch == FuriHalUartIdLPUART1) {
+        LL_LPUART_DisableDMAReq_RX(LPUART1);
+        LL_LPUART_EnableIT_RXNE_RXFNE(LPUART1);
+        NVIC_DisableIRQ(DMA2_Channel2_IRQn);
+    }
+    LL_DMA_DisableIT_HT(DMA2, dma_rx_channel[ch]);
+    LL_DMA_DisableIT_TC(DMA2, dma_rx_channel[ch]);
+    LL_DMA_DisableChannel(DMA2, dma_rx_channel[ch]);
+    furi_hal_interrupt_set_dma_channel_isr(DMA2, dma_rx_channel[ch], NULL);
+    dma_rx_size[ch] = 0;
+}
+
+size_t furi_hal_uart_dma_rx_get_pos(FuriHalUartId ch) {
+    if(dma_rx_size[ch] == 0) return 0;
+    size_t remaining = LL_DMA_GetDataLength(DMA2, dma_rx_channel[ch]);
+    // Counter reloads in circular mode, so it is never 0 while channel is running
+    return (dma_rx_size[ch] - remaining) % dma_rx_size[ch];
+}
+
+static void furi_hal_usart_dma_rx_isr() {
+    if(LL_DMA_IsActiveFlag_HT1(DMA2)) {
+        LL_DMA_ClearFlag_HT1(DMA2);
+        irq_cb[FuriHalUartIdUSART1](UartIrqEventRXDMA, 0, irq_ctx[FuriHalUartIdUSART1]);
+    }
+    if(LL_DMA_IsActiveFlag_TC1(DMA2)) {
+        LL_DMA_ClearFlag_TC1(DMA2);
+        irq_cb[FuriHalUartIdUSART1](UartIrqEventRXDMA, 0, irq_ctx[FuriHalUartIdUSART1]);
+    }
+}
+
+static void furi_hal_lpuart_dma_rx_isr() {
+    if(LL_DMA_IsActiveFlag_HT2(DMA2)) {
+        LL_DMA_ClearFlag_HT2(DMA2);
+        irq_cb[FuriHalUartIdLPUART1](UartIrqEventRXDMA, 0, irq_ctx[FuriHalUartIdLPUART1]);
+    }
+    if(LL_DMA_IsActiveFlag_TC2(DMA2)) {
+        LL_DMA_ClearFlag_TC2(DMA2);
+        irq_cb[FuriHalUartIdLPUART1](UartIrqEventRXDMA, 0, irq_ctx[FuriHalUartIdLPUART1]);
+    }
+}
+
 void LPUART1_IRQHandler(void) {
-    if(LL_LPUART_IsActiveFlag_RXNE_RXFNE(LPUART1)) {
+    if(LL_LPUART_IsActiveFlag_ORE(LPUART1)) {
+        LL_LPUART_ClearFlag_ORE(LPUART1);
+        irq_cb[FuriHalUartIdLPUART1](UartIrqEventORE, 0, irq_ctx[FuriHalUartIdLPUART1]);
+    }
+    if(LL_LPUART_IsActiveFlag_RXNE_RXFNE(LPUART1) &&
+       LL_LPUART_IsEnabledIT_RXNE_RXFNE(LPUART1)) {
         uint8_t data = LL_LPUART_ReceiveData8(LPUART1);
         irq_cb[FuriHalUartIdLPUART1](UartIrqEventRXNE, data, irq_ctx[FuriHalUartIdLPUART1]);
     } else if(LL_LPUART_IsActiveFlag_IDLE(LPUART1)) {
         irq_cb[FuriHalUartIdLPUART1](UartIrqEventIDLE, 0, irq_ctx[FuriHalUartIdLPUART1]);
         LL_LPUART_ClearFlag_IDLE(LPUART1);
-    } else if(LL_LPUART_IsActiveFlag_ORE(LPUART1)) {
-        LL_LPUART_ClearFlag_ORE(LPUART1);
     }
     //TODO: more events
 }
 
 void USART1_IRQHandler(void) {
-    if(LL_USART_IsActiveFlag_RXNE_RXFNE(USART1)) {
+    if(LL_USART_IsActiveFlag_ORE(USART1)) {
+        LL_USART_ClearFlag_ORE(USART1);
+        irq_cb[FuriHalUartIdUSART1](UartIrqEventORE, 0, irq_ctx[FuriHalUartIdUSART1]);
+    }
+    if(LL_USART_IsActiveFlag_RXNE_RXFNE(USART1) && LL_USART_IsEnabledIT_RXNE_RXFNE(USART1)) {
         uint8_t data = LL_USART_ReceiveData8(USART1);
         irq_cb[FuriHalUartIdUSART1](UartIrqEventRXNE, data, irq_ctx[FuriHalUartIdUSART1]);
     } else if(LL_USART_IsActiveFlag_IDLE(USART1)) {
         irq_cb[FuriHalUartIdUSART1](UartIrqEventIDLE, 0, irq_ctx[FuriHalUartIdUSART1]);
         LL_USART_ClearFlag_IDLE(USART1);
-    } else if(LL_USART_IsActiveFlag_ORE(USART1)) {
-        LL_USART_ClearFlag_ORE(USART1);
     }
 }
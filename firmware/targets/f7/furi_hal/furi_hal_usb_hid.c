@@ -15,8 +15,8 @@
 #define HID_EP_OUT 0x01
 #define HID_EP_SZ 0x10
 
-#define HID_KB_MAX_KEYS 6
 #define HID_CONSUMER_MAX_KEYS 2
+#define HID_KB_QUEUE_LEN 16
 
 #define HID_PAGE_CONSUMER 0x0C
 #define HID_CONSUMER_CONTROL 0x01
@@ -205,6 +205,75 @@ static const struct HidConfigDescriptor hid_cfg_desc = {
         },
 };
 
+/* Device configuration descriptor with 1 ms IN polling, for back-to-back keystroke reports */
+static const struct HidConfigDescriptor hid_cfg_desc_fast = {
+    .config =
+        {
+            .bLength = sizeof(struct usb_config_descriptor),
+            .bDescriptorType = USB_DTYPE_CONFIGURATION,
+            .wTotalLength = sizeof(struct HidConfigDescriptor),
+            .bNumInterfaces = 1,
+            .bConfigurationValue = 1,
+            .iConfiguration = NO_DESCRIPTOR,
+            .bmAttributes = USB_CFG_ATTR_RESERVED | USB_CFG_ATTR_SELFPOWERED,
+            .bMaxPower = USB_CFG_POWER_MA(100),
+        },
+    .iad_0 =
+        {
+            .hid_iad =
+                {
+                    .bLength = sizeof(struct usb_iad_descriptor),
+                    .bDescriptorType = USB_DTYPE_INTERFASEASSOC,
+                    .bFirstInterface = 0,
+                    .bInterfaceCount = 1,
+                    .bFunctionClass = USB_CLASS_PER_INTERFACE,
+                    .bFunctionSubClass = USB_SUBCLASS_NONE,
+                    .bFunctionProtocol = USB_PROTO_NONE,
+                    .iFunction = NO_DESCRIPTOR,
+                },
+            .hid =
+                {
+                    .bLength = sizeof(struct usb_interface_descriptor),
+                    .bDescriptorType = USB_DTYPE_INTERFACE,
+                    .bInterfaceNumber = 0,
+                    .bAlternateSetting = 0,
+                    .bNumEndpoints = 2,
+                    .bInterfaceClass = USB_CLASS_HID,
+                    .bInterfaceSubClass = USB_HID_SUBCLASS_NONBOOT,
+                    .bInterfaceProtocol = USB_HID_PROTO_NONBOOT,
+                    .iInterface = NO_DESCRIPTOR,
+                },
+            .hid_desc =
+                {
+                    .bLength = sizeof(struct usb_hid_descriptor),
+                    .bDescriptorType = USB_DTYPE_HID,
+                    .bcdHID = VERSION_BCD(1, 0, 0),
+                    .bCountryCode = USB_HID_COUNTRY_NONE,
+                    .bNumDescriptors = 1,
+                    .bDescriptorType0 = USB_DTYPE_HID_REPORT,
+                    .wDescriptorLength0 = sizeof(hid_report_desc),
+                },
+            .hid_ep_in =
+                {
+                    .bLength = sizeof(struct usb_endpoint_descriptor),
+                    .bDescriptorType = USB_DTYPE_ENDPOINT,
+                    .bEndpointAddress = HID_EP_IN,
+                    .bmAttributes = USB_EPTYPE_INTERRUPT,
+                    .wMaxPacketSize = HID_EP_SZ,
+                    .bInterval = 1,
+                },
+            .hid_ep_out =
+                {
+                    .bLength = sizeof(struct usb_endpoint_descriptor),
+                    .bDescriptorType = USB_DTYPE_ENDPOINT,
+                    .bEndpointAddress = HID_EP_OUT,
+                    .bmAttributes = USB_EPTYPE_INTERRUPT,
+                    .wMaxPacketSize = HID_EP_SZ,
+                    .bInterval = 10,
+                },
+        },
+};
+
 struct HidReportMouse {
     uint8_t report_id;
     uint8_t btn;
@@ -242,10 +311,13 @@ static void hid_on_wakeup(usbd_device* dev);
 static void hid_on_suspend(usbd_device* dev);
 
 static bool hid_send_report(uint8_t report_id);
+static void hid_kb_queue_send_next();
 static usbd_respond hid_ep_config(usbd_device* dev, uint8_t cfg);
 static usbd_respond hid_control(usbd_device* dev, usbd_ctlreq* req, usbd_rqc_callback* callback);
 static usbd_device* usb_dev;
 static osSemaphoreId_t hid_semaphore = NULL;
+static osMessageQueueId_t hid_kb_queue = NULL;
+static struct HidReportKB hid_kb_queue_tx;
 static bool hid_connected = false;
 static HidStateCallback callback;
 static void* cb_ctx;
@@ -302,6 +374,33 @@ bool furi_hal_hid_kb_release_all() {
     return hid_send_report(ReportIdKeyboard);
 }
 
+bool furi_hal_hid_kb_queue_report(
+    uint8_t mods,
+    const uint8_t keys[HID_KB_MAX_KEYS],
+    uint32_t timeout) {
+    if((hid_kb_queue == NULL) || (hid_connected == false)) {
+        // Reports queued before disconnect are stale
+        if(hid_kb_queue != NULL) osMessageQueueReset(hid_kb_queue);
+        return false;
+    }
+
+    struct HidReportKB report = {.report_id = ReportIdKeyboard, .mods = mods};
+    memcpy(report.btn, keys, HID_KB_MAX_KEYS);
+    if(osMessageQueuePut(hid_kb_queue, &report, 0, timeout) != osOK) return false;
+
+    // Kick transfer if endpoint is idle, otherwise next report is taken on transfer completion
+    if(osSemaphoreAcquire(hid_semaphore, 0) == osOK) hid_kb_queue_send_next();
+    return true;
+}
+
+bool furi_hal_hid_kb_queue_wait(uint32_t timeout) {
+    if(hid_semaphore == NULL) return true;
+    // Semaphore is held until the last queued report is sent
+    if(osSemaphoreAcquire(hid_semaphore, timeout) != osOK) return false;
+    osSemaphoreRelease(hid_semaphore);
+    return true;
+}
+
 bool furi_hal_hid_mouse_move(int8_t dx, int8_t dy) {
     hid_report.mouse.x = dx;
     hid_report.mouse.y = dy;
@@ -363,8 +462,25 @@ FuriHalUsbInterface usb_hid = {
     .cfg_descr = (void*)&hid_cfg_desc,
 };
 
+FuriHalUsbInterface usb_hid_fast = {
+    .init = hid_init,
+    .deinit = hid_deinit,
+    .wakeup = hid_on_wakeup,
+    .suspend = hid_on_suspend,
+
+    .dev_descr = (struct usb_device_descriptor*)&hid_device_desc,
+
+    .str_manuf_descr = (void*)&dev_manuf_desc,
+    .str_prod_descr = (void*)&dev_prod_desc,
+    .str_serial_descr = (void*)&dev_serial_desc,
+
+    .cfg_descr = (void*)&hid_cfg_desc_fast,
+};
+
 static void hid_init(usbd_device* dev, FuriHalUsbInterface* intf) {
     if(hid_semaphore == NULL) hid_semaphore = osSemaphoreNew(1, 1, NULL);
+    if(hid_kb_queue == NULL)
+        hid_kb_queue = osMessageQueueNew(HID_KB_QUEUE_LEN, sizeof(struct HidReportKB), NULL);
     usb_dev = dev;
     hid_report.keyboard.report_id = ReportIdKeyboard;
     hid_report.mouse.report_id = ReportIdMouse;
@@ -391,6 +507,9 @@ static void hid_on_wakeup(usbd_device* dev) {
 static void hid_on_suspend(usbd_device* dev) {
     if(hid_connected == true) {
         hid_connected = false;
+        // Drop reports queued for disconnected host
+        while(osMessageQueueGet(hid_kb_queue, &hid_kb_queue_tx, NULL, 0) == osOK)
+            ;
         osSemaphoreRelease(hid_semaphore);
         if(callback != NULL) callback(false, cb_ctx);
     }
@@ -412,9 +531,19 @@ static bool hid_send_report(uint8_t report_id) {
     return false;
 }
 
+/* Must be called with hid_semaphore acquired, releases it when queue is empty */
+static void hid_kb_queue_send_next() {
+    if((hid_connected == true) && (hid_kb_queue != NULL) &&
+       (osMessageQueueGet(hid_kb_queue, &hid_kb_queue_tx, NULL, 0) == osOK)) {
+        usbd_ep_write(usb_dev, HID_EP_IN, &hid_kb_queue_tx, sizeof(hid_kb_queue_tx));
+    } else {
+        osSemaphoreRelease(hid_semaphore);
+    }
+}
+
 static void hid_txrx_ep_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
     if(event == usbd_evt_eptx) {
-        osSemaphoreRelease(hid_semaphore);
+        hid_kb_queue_send_next();
     } else {
         struct HidReportLED leds;
         usbd_ep_read(usb_dev, ep, &leds, 2);
@@ -30,11 +30,18 @@ void furi_hal_bt_serial_set_event_callback(
  */
 void furi_hal_bt_serial_notify_buffer_is_empty();
 
+/** Get packets that can be sent before DataSent event
+ *
+ * @return      1 if client uses indications, 0 for notifications: limited by stack TX pool
+ */
+uint8_t furi_hal_bt_serial_get_tx_window();
+
 /** Send data through BLE
  *
  * @param data  data buffer
  * @param size  data buffer size
  *
- * @return      true on success
+ * @return      SerialServiceTxStatusBusy if there are no stack buffers, DataSent event is sent
+ *              when they are available again
  */
-bool furi_hal_bt_serial_tx(uint8_t* data, uint16_t size);
+SerialServiceTxStatus furi_hal_bt_serial_tx(uint8_t* data, uint16_t size);
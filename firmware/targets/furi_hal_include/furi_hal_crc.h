@@ -0,0 +1,32 @@
+/**
+ * @file furi_hal_crc.h
+ * CRC calculation unit HAL API
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Initialize CRC unit */
+void furi_hal_crc_init();
+
+/** Calculate CRC32 (IEEE 802.3, as in zlib and PNG) with CRC unit
+ *
+ * Result is the same as crc32_calc_buffer, chunks can be mixed between them. Unit is shared:
+ * call blocks while other thread uses it. Not for ISR.
+ *
+ * @param      crc     initial value, 0 for first chunk
+ * @param      buffer  data
+ * @param      size    data size
+ *
+ * @return     CRC32 value
+ */
+uint32_t furi_hal_crc32(uint32_t crc, const void* buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -97,6 +97,25 @@ bool furi_hal_spi_bus_trx(
     size_t size,
     uint32_t timeout);
 
+/** SPI Transmit and Receive with DMA
+ *
+ * Bytes go back to back, calling thread sleeps until transfer is complete.
+ *
+ * @param      handle     pointer to FuriHalSpiBusHandle instance
+ * @param      tx_buffer  pointer to tx buffer, NULL to send 0xFF
+ * @param      rx_buffer  pointer to rx buffer, NULL to drop received data
+ * @param      size       transaction size, up to 65535
+ * @param      timeout    operation timeout in ms
+ *
+ * @return     true on success
+ */
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
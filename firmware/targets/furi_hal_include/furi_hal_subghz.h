@@ -33,6 +33,12 @@ typedef enum {
     FuriHalSubGhzPath868, /**< Center Frquency: 868MHz. Path 3: SW1RF3-SW2RF3, LCLC */
 } FuriHalSubGhzPath;
 
+/** Synthesizer registers of calibrated frequency, used for fast switching */
+typedef struct {
+    uint8_t freq[3]; /**< FREQ2, FREQ1, FREQ0 */
+    uint8_t fscal[3]; /**< FSCAL3, FSCAL2, FSCAL1 */
+} FuriHalSubGhzChannel;
+
 /** SubGhz state */
 typedef enum {
     SubGhzStateInit, /**< Init pending */
@@ -112,6 +118,44 @@ bool furi_hal_subghz_is_rx_data_crc_valid();
  */
 void furi_hal_subghz_read_packet(uint8_t* data, uint8_t* size);
 
+/** Write bytes to TX FIFO as is, without flush and packet length
+ * Used to refill FIFO while long packet is transmitted
+ *
+ * @param      data  bytes array
+ * @param      size  size, no more than free space in FIFO
+ */
+void furi_hal_subghz_write_fifo(const uint8_t* data, uint8_t size);
+
+/** Read bytes from RX FIFO as is
+ * Used to drain FIFO while long packet is received
+ *
+ * @param      data  pointer
+ * @param      size  bytes to read, no more than bytes in FIFO
+ */
+void furi_hal_subghz_read_fifo(uint8_t* data, uint8_t size);
+
+/** Get TX FIFO bytes count
+ *
+ * @param      underflow  pointer to underflow flag, can be NULL
+ *
+ * @return     bytes in TX FIFO
+ */
+uint8_t furi_hal_subghz_get_tx_bytes(bool* underflow);
+
+/** Get RX FIFO bytes count
+ *
+ * @param      overflow  pointer to overflow flag, can be NULL
+ *
+ * @return     bytes in RX FIFO
+ */
+uint8_t furi_hal_subghz_get_rx_bytes(bool* overflow);
+
+/** Set GDO0 pin function
+ *
+ * @param      iocfg  CC1101Iocfg value
+ */
+void furi_hal_subghz_set_gdo0(uint8_t iocfg);
+
 /** Flush rx FIFO buffer
  */
 void furi_hal_subghz_flush_rx();
@@ -189,6 +233,37 @@ bool furi_hal_subghz_is_tx_allowed(uint32_t value);
  */
 uint32_t furi_hal_subghz_set_frequency(uint32_t value);
 
+/** Set frequency, calibrate synthesizer and save registers for fast switching
+ * Radio is left in IDLE state
+ *
+ * @param      value    frequency in Hz
+ * @param      channel  FuriHalSubGhzChannel to fill
+ *
+ * @return     real frequency in herz
+ */
+uint32_t furi_hal_subghz_calibrate_channel(uint32_t value, FuriHalSubGhzChannel* channel);
+
+/** Prepare channel registers without calibration
+ * Calibration of nearby frequency is used, so frequency must be within few hundreds kHz
+ *
+ * @param      value      frequency in Hz
+ * @param      reference  calibrated channel
+ * @param      channel    FuriHalSubGhzChannel to fill
+ *
+ * @return     real frequency in herz
+ */
+uint32_t furi_hal_subghz_derive_channel(
+    uint32_t value,
+    const FuriHalSubGhzChannel* reference,
+    FuriHalSubGhzChannel* channel);
+
+/** Switch to channel and start receive, no calibration is done
+ * Preset must have autocalibration disabled in MCSM0
+ *
+ * @param      channel  prepared channel
+ */
+void furi_hal_subghz_rx_channel(const FuriHalSubGhzChannel* channel);
+
 /** Set path
  *
  * @param      path  path to use
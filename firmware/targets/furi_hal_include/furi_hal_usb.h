@@ -23,6 +23,7 @@ struct FuriHalUsbInterface {
 extern FuriHalUsbInterface usb_cdc_single;
 extern FuriHalUsbInterface usb_cdc_dual;
 extern FuriHalUsbInterface usb_hid;
+extern FuriHalUsbInterface usb_hid_fast;
 extern FuriHalUsbInterface usb_hid_u2f;
 
 typedef enum {
@@ -1,5 +1,8 @@
 #pragma once
 
+/** Max number of simultaneously pressed keys in keyboard report */
+#define HID_KB_MAX_KEYS 6
+
 /** HID keyboard key codes */
 enum HidKeyboardKeys {
     KEY_NONE = 0x00,
@@ -305,6 +308,31 @@ bool furi_hal_hid_kb_release(uint16_t button);
  */
 bool furi_hal_hid_kb_release_all();
 
+/** Queue keyboard report for asynchronous sending
+ *
+ * Queued reports are sent in order, one per endpoint poll, without waiting for
+ * each transfer to complete. Pressed keys state set by furi_hal_hid_kb_press is
+ * not changed.
+ *
+ * @param      mods      modifier keys bitmask (high byte of key code)
+ * @param      keys      key codes, unused slots must be KEY_NONE
+ * @param      timeout   time to wait for free queue slot, ms
+ *
+ * @return     true if report was queued, false on timeout or disconnect
+ */
+bool furi_hal_hid_kb_queue_report(
+    uint8_t mods,
+    const uint8_t keys[HID_KB_MAX_KEYS],
+    uint32_t timeout);
+
+/** Wait until all queued keyboard reports are sent
+ *
+ * @param      timeout  timeout, ms
+ *
+ * @return     true if queue is empty, false on timeout
+ */
+bool furi_hal_hid_kb_queue_wait(uint32_t timeout);
+
 /** Set mouse movement and send HID report
  *
  * @param      dx  x coordinate delta
@@ -174,3 +174,21 @@ uint8_t cc1101_read_fifo(FuriHalSpiBusHandle* handle, uint8_t* data, uint8_t* si
 
     return *size;
 }
+
+uint8_t cc1101_read_fifo_raw(FuriHalSpiBusHandle* handle, uint8_t* data, uint8_t size) {
+    uint8_t buff_tx[65] = {0};
+    buff_tx[0] = CC1101_FIFO | CC1101_READ | CC1101_BURST;
+    uint8_t buff_rx[1];
+    if(size > 64) size = 64;
+
+    // Start transaction
+    // Wait IC to become ready
+    while(hal_gpio_read(handle->miso))
+        ;
+
+    // Address byte, then data
+    furi_hal_spi_bus_trx(handle, buff_tx, buff_rx, 1, CC1101_TIMEOUT);
+    furi_hal_spi_bus_trx(handle, &buff_tx[1], data, size, CC1101_TIMEOUT);
+
+    return size;
+}
@@ -175,6 +175,16 @@ uint8_t cc1101_write_fifo(FuriHalSpiBusHandle* handle, const uint8_t* data, uint
  */
 uint8_t cc1101_read_fifo(FuriHalSpiBusHandle* handle, uint8_t* data, uint8_t* size);
 
+/** Read FIFO bytes as is, without packet length
+ *
+ * @param      handle  - pointer to FuriHalSpiHandle
+ * @param      data    pointer to byte array
+ * @param      size    bytes to read from fifo, no more than 64
+ *
+ * @return     size, read bytes count
+ */
+uint8_t cc1101_read_fifo_raw(FuriHalSpiBusHandle* handle, uint8_t* data, uint8_t size);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -11,6 +11,12 @@
 struct FlipperFormat {
     Stream* stream;
     bool strict_mode;
+    // String views are stored here
+    char* arena;
+    size_t arena_size;
+    size_t arena_used;
+    // Last string view didn't fit arena
+    bool arena_skipped;
 };
 
 static const char* const flipper_format_filetype_key = "Filetype";
@@ -26,6 +32,7 @@ FlipperFormat* flipper_format_string_alloc() {
     FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
     flipper_format->stream = string_stream_alloc();
     flipper_format->strict_mode = false;
+    flipper_format_set_string_arena(flipper_format, NULL, 0);
     return flipper_format;
 }
 
@@ -33,6 +40,7 @@ FlipperFormat* flipper_format_file_alloc(Storage* storage) {
     FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
     flipper_format->stream = file_stream_alloc(storage);
     flipper_format->strict_mode = false;
+    flipper_format_set_string_arena(flipper_format, NULL, 0);
     return flipper_format;
 }
 
@@ -97,6 +105,20 @@ void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_m
     flipper_format->strict_mode = strict_mode;
 }
 
+void flipper_format_set_string_arena(FlipperFormat* flipper_format, char* buffer, size_t size) {
+    furi_assert(flipper_format);
+    furi_assert(buffer || !size);
+    flipper_format->arena = buffer;
+    flipper_format->arena_size = size;
+    flipper_format->arena_used = 0;
+    flipper_format->arena_skipped = false;
+}
+
+void flipper_format_reset_string_arena(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    flipper_format->arena_used = 0;
+}
+
 bool flipper_format_rewind(FlipperFormat* flipper_format) {
     furi_assert(flipper_format);
     return stream_rewind(flipper_format->stream);
@@ -144,6 +166,30 @@ bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key,
         flipper_format->stream, key, FlipperStreamValueStr, data, 1, flipper_format->strict_mode);
 }
 
+bool flipper_format_read_string_view(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char** data) {
+    furi_assert(flipper_format);
+    furi_assert(flipper_format->arena);
+    char* view = &flipper_format->arena[flipper_format->arena_used];
+    size_t free_size = flipper_format->arena_size - flipper_format->arena_used;
+    size_t length = 0;
+    bool result = flipper_format_stream_read_string_buffer(
+        flipper_format->stream, key, view, free_size, &length, flipper_format->strict_mode);
+    flipper_format->arena_skipped = !result && length && (length >= free_size);
+    if(result) {
+        flipper_format->arena_used += length + 1;
+        *data = view;
+    }
+    return result;
+}
+
+bool flipper_format_string_view_skipped(FlipperFormat* flipper_format) {
+    furi_assert(flipper_format);
+    return flipper_format->arena_skipped;
+}
+
 bool flipper_format_write_string(FlipperFormat* flipper_format, const char* key, string_t data) {
     furi_assert(flipper_format);
     FlipperStreamWriteData write_data = {
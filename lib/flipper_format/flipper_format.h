@@ -90,6 +90,21 @@
  * flipper_format_free(file);
  * ~~~~~~~~~~~~~~~~~~~~~
  * 
+ * Reading without heap allocations: strings are stored in caller's arena and returned as views,
+ * numbers and hex arrays are parsed directly from the stream.
+ * 
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * char arena[128];
+ * const char* string_value = NULL;
+ * flipper_format_set_string_arena(file, arena, sizeof(arena));
+ * 
+ * do {
+ *     if(!flipper_format_file_open_existing(file, "/ext/flipper_format_test")) break;
+ *     if(!flipper_format_read_string_view(file, "String", &string_value)) break;
+ *     if(!flipper_format_read_hex(file, "Hex Array", array, array_size)) break;
+ * } while(0);
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * 
  */
 
 #pragma once
@@ -172,6 +187,21 @@ void flipper_format_free(FlipperFormat* flipper_format);
  */
 void flipper_format_set_strict_mode(FlipperFormat* flipper_format, bool strict_mode);
 
+/**
+ * Set arena for strings read with flipper_format_read_string_view.
+ * Arena is owned by caller and must outlive FlipperFormat or be replaced.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param buffer Arena buffer, NULL to disable
+ * @param size Arena size
+ */
+void flipper_format_set_string_arena(FlipperFormat* flipper_format, char* buffer, size_t size);
+
+/**
+ * Drop all string views, arena is filled from the start again.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ */
+void flipper_format_reset_string_arena(FlipperFormat* flipper_format);
+
 /**
  * Rewind the RW pointer.
  * @param flipper_format Pointer to a FlipperFormat instance
@@ -236,6 +266,27 @@ bool flipper_format_get_value_count(
  */
 bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, string_t data);
 
+/**
+ * Read a string by key into string arena, no heap allocations.
+ * View stays valid until arena is reset or replaced.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param key Key
+ * @param data View of the value
+ * @return True on success, false if key is not found or arena is full
+ */
+bool flipper_format_read_string_view(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char** data);
+
+/**
+ * Check if last flipper_format_read_string_view failed because value didn't fit arena.
+ * Such value is skipped, reading can go on with the next key.
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @return True if value was skipped
+ */
+bool flipper_format_string_view_skipped(FlipperFormat* flipper_format);
+
 /**
  * Write key and string
  * @param flipper_format Pointer to a FlipperFormat instance
@@ -4,6 +4,9 @@
 #include "flipper_format_stream.h"
 #include "flipper_format_stream_i.h"
 
+// Longest number value: float max printed with "%f", separator and terminator
+#define FLIPPER_FORMAT_STREAM_VALUE_SIZE (48)
+
 static bool flipper_format_stream_write(Stream* stream, const void* data, size_t data_size) {
     size_t bytes_written = stream_write(stream, data, data_size);
     return bytes_written == data_size;
@@ -26,10 +29,12 @@ bool flipper_format_stream_write_eol(Stream* stream) {
     return flipper_format_stream_write(stream, &flipper_format_eoln, 1);
 }
 
-static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
-    string_reset(key);
+// Find the next key and compare it with the expected one while reading
+static bool flipper_format_stream_read_valid_key(Stream* stream, const char* key, bool* match) {
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
+    size_t length = 0;
+    *match = true;
 
     bool found = false;
     bool error = false;
@@ -44,7 +49,8 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
             uint8_t data = buffer[i];
             if(data == flipper_format_eoln) {
                 // EOL found, clean data, start accumulating data and set the new_line flag
-                string_reset(key);
+                length = 0;
+                *match = true;
                 accumulate = true;
                 new_line = true;
             } else if(data == flipper_format_eolr) {
@@ -60,7 +66,8 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
                     // this can only be if we have previously found some kind of key, so
                     // clear the data, set the flag that we no longer want to accumulate data
                     // and reset the new_line flag
-                    string_reset(key);
+                    length = 0;
+                    *match = true;
                     accumulate = false;
                     new_line = false;
                 } else {
@@ -73,6 +80,7 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
                             break;
                         }
 
+                        *match = *match && (key[length] == '\0');
                         found = true;
                         break;
                     }
@@ -80,9 +88,13 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
             } else {
                 // just new symbol, reset the new_line flag
                 new_line = false;
-                if(accumulate) {
-                    // and accumulate data if we want
-                    string_push_back(key, data);
+                if(accumulate && *match) {
+                    // and compare data if key still matches
+                    if(key[length] == data) {
+                        length++;
+                    } else {
+                        *match = false;
+                    }
                 }
             }
         }
@@ -95,13 +107,11 @@ static bool flipper_format_stream_read_valid_key(Stream* stream, string_t key) {
 
 static bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, bool strict_mode) {
     bool found = false;
-    string_t read_key;
-
-    string_init(read_key);
 
     while(!stream_eof(stream)) {
-        if(flipper_format_stream_read_valid_key(stream, read_key)) {
-            if(string_cmp_str(read_key, key) == 0) {
+        bool match = false;
+        if(flipper_format_stream_read_valid_key(stream, key, &match)) {
+            if(match) {
                 if(!stream_seek(stream, 2, StreamOffsetFromCurrent)) break;
 
                 found = true;
@@ -112,15 +122,19 @@ static bool flipper_format_stream_seek_to_key(Stream* stream, const char* key, b
             }
         }
     }
-    string_clear(read_key);
 
     return found;
 }
 
-static bool flipper_format_stream_read_value(Stream* stream, string_t value, bool* last) {
-    string_reset(value);
+// Read one value into buffer, value is only skipped if buffer is NULL
+static bool flipper_format_stream_read_value(
+    Stream* stream,
+    char* value,
+    size_t value_size,
+    bool* last) {
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
+    size_t length = 0;
     bool result = false;
     bool error = false;
 
@@ -129,17 +143,17 @@ static bool flipper_format_stream_read_value(Stream* stream, string_t value, boo
 
         if(was_read == 0) {
             // check EOF
-            if(stream_eof(stream) && string_size(value) > 0) {
+            if(stream_eof(stream) && length > 0) {
                 result = true;
                 *last = true;
-                break;
             }
+            break;
         }
 
         for(uint16_t i = 0; i < was_read; i++) {
             uint8_t data = buffer[i];
             if(data == flipper_format_eoln) {
-                if(string_size(value) > 0) {
+                if(length > 0) {
                     if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
                         error = true;
                         break;
@@ -150,9 +164,10 @@ static bool flipper_format_stream_read_value(Stream* stream, string_t value, boo
                     break;
                 } else {
                     error = true;
+                    break;
                 }
             } else if(data == ' ') {
-                if(string_size(value) > 0) {
+                if(length > 0) {
                     if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
                         error = true;
                         break;
@@ -165,14 +180,23 @@ static bool flipper_format_stream_read_value(Stream* stream, string_t value, boo
 
             } else if(data == flipper_format_eolr) {
                 // Ignore
+            } else if(value) {
+                // Value doesn't fit
+                if(length + 1 >= value_size) {
+                    error = true;
+                    break;
+                }
+                value[length++] = data;
             } else {
-                string_push_back(value, data);
+                length++;
             }
         }
 
         if(error || result) break;
     }
 
+    if(result && value) value[length] = '\0';
+
     return result;
 }
 
@@ -213,6 +237,53 @@ static bool flipper_format_stream_read_line(Stream* stream, string_t str_result)
     return string_size(str_result) != 0;
 }
 
+// Read the rest of line into fixed buffer, fails if it doesn't fit
+static bool flipper_format_stream_read_line_buffer(
+    Stream* stream,
+    char* str_result,
+    size_t str_result_size,
+    size_t* length) {
+    const size_t buffer_size = 32;
+    uint8_t buffer[buffer_size];
+    bool result = false;
+    bool error = false;
+    *length = 0;
+
+    while(true) {
+        size_t was_read = stream_read(stream, buffer, buffer_size);
+        if(was_read == 0) {
+            result = stream_eof(stream);
+            break;
+        }
+
+        for(size_t i = 0; i < was_read; i++) {
+            uint8_t data = buffer[i];
+            if(data == flipper_format_eoln) {
+                if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
+                    error = true;
+                    break;
+                }
+
+                result = true;
+                break;
+            } else if(data == flipper_format_eolr) {
+                // Ignore
+            } else {
+                // Too long line is read to the end, so next key can be found
+                if(*length + 1 < str_result_size) str_result[*length] = data;
+                (*length)++;
+            }
+        }
+
+        if(result || error) break;
+    }
+
+    if(error || (*length >= str_result_size)) result = false;
+    if(result && *length) str_result[*length] = '\0';
+
+    return result && (*length != 0);
+}
+
 static bool flipper_format_stream_seek_to_next_line(Stream* stream) {
     const size_t buffer_size = 32;
     uint8_t buffer[buffer_size];
@@ -254,47 +325,47 @@ bool flipper_format_stream_write_value_line(Stream* stream, FlipperStreamWriteDa
     if(write_data->type == FlipperStreamValueIgnore) {
         result = true;
     } else {
-        string_t value;
-        string_init(value);
+        char value[FLIPPER_FORMAT_STREAM_VALUE_SIZE];
 
         do {
             if(!flipper_format_stream_write_key(stream, write_data->key)) break;
 
-            if(write_data->type == FlipperStreamValueStr) write_data->data_size = 1;
+            uint16_t data_size = write_data->data_size;
+            if(write_data->type == FlipperStreamValueStr) {
+                const char* data = write_data->data;
+                if(!flipper_format_stream_write(stream, data, strlen(data))) break;
+                data_size = 0;
+            }
 
             bool cycle_error = false;
-            for(uint16_t i = 0; i < write_data->data_size; i++) {
+            for(uint16_t i = 0; i < data_size; i++) {
+                int length = 0;
                 switch(write_data->type) {
-                case FlipperStreamValueStr: {
-                    const char* data = write_data->data;
-                    string_printf(value, "%s", data);
-                }; break;
                 case FlipperStreamValueHex: {
                     const uint8_t* data = write_data->data;
-                    string_printf(value, "%02X", data[i]);
+                    length = snprintf(value, sizeof(value), "%02X", data[i]);
                 }; break;
                 case FlipperStreamValueFloat: {
                     const float* data = write_data->data;
-                    string_printf(value, "%f", data[i]);
+                    length = snprintf(value, sizeof(value), "%f", (double)data[i]);
                 }; break;
                 case FlipperStreamValueInt32: {
                     const int32_t* data = write_data->data;
-                    string_printf(value, "%" PRIi32, data[i]);
+                    length = snprintf(value, sizeof(value), "%" PRIi32, data[i]);
                 }; break;
                 case FlipperStreamValueUint32: {
                     const uint32_t* data = write_data->data;
-                    string_printf(value, "%" PRId32, data[i]);
+                    length = snprintf(value, sizeof(value), "%" PRId32, data[i]);
                 }; break;
                 default:
                     furi_crash("Unknown FF type");
                 }
 
-                if((i + 1) < write_data->data_size) {
-                    string_cat(value, " ");
+                if((i + 1) < data_size) {
+                    value[length++] = ' ';
                 }
 
-                if(!flipper_format_stream_write(
-                       stream, string_get_cstr(value), string_size(value))) {
+                if(!flipper_format_stream_write(stream, value, length)) {
                     cycle_error = true;
                     break;
                 }
@@ -304,8 +375,6 @@ bool flipper_format_stream_write_value_line(Stream* stream, FlipperStreamWriteDa
             if(!flipper_format_stream_write_eol(stream)) break;
             result = true;
         } while(false);
-
-        string_clear(value);
     }
 
     return result;
@@ -331,24 +400,20 @@ bool flipper_format_stream_read_value_line(
             }
         } else {
             result = true;
-            string_t value;
-            string_init(value);
+            char value[FLIPPER_FORMAT_STREAM_VALUE_SIZE];
 
             for(uint16_t i = 0; i < data_size; i++) {
                 bool last = false;
-                result = flipper_format_stream_read_value(stream, value, &last);
+                result = flipper_format_stream_read_value(stream, value, sizeof(value), &last);
                 if(result) {
                     int scan_values = 0;
 
                     switch(type) {
                     case FlipperStreamValueHex: {
                         uint8_t* data = _data;
-                        if(string_size(value) >= 2) {
+                        if(strlen(value) >= 2) {
                             // sscanf "%02X" does not work here
-                            if(hex_chars_to_uint8(
-                                   string_get_char(value, 0),
-                                   string_get_char(value, 1),
-                                   &data[i])) {
+                            if(hex_chars_to_uint8(value[0], value[1], &data[i])) {
                                 scan_values = 1;
                             }
                         }
@@ -356,9 +421,9 @@ bool flipper_format_stream_read_value_line(
                     case FlipperStreamValueFloat: {
                         float* data = _data;
                         // newlib-nano does not have sscanf for floats
-                        // scan_values = sscanf(string_get_cstr(value), "%f", &data[i]);
+                        // scan_values = sscanf(value, "%f", &data[i]);
                         char* end_char;
-                        data[i] = strtof(string_get_cstr(value), &end_char);
+                        data[i] = strtof(value, &end_char);
                         if(*end_char == 0) {
                             // most likely ok
                             scan_values = 1;
@@ -366,11 +431,11 @@ bool flipper_format_stream_read_value_line(
                     }; break;
                     case FlipperStreamValueInt32: {
                         int32_t* data = _data;
-                        scan_values = sscanf(string_get_cstr(value), "%" PRIi32, &data[i]);
+                        scan_values = sscanf(value, "%" PRIi32, &data[i]);
                     }; break;
                     case FlipperStreamValueUint32: {
                         uint32_t* data = _data;
-                        scan_values = sscanf(string_get_cstr(value), "%" PRId32, &data[i]);
+                        scan_values = sscanf(value, "%" PRId32, &data[i]);
                     }; break;
                     default:
                         furi_crash("Unknown FF type");
@@ -389,14 +454,23 @@ bool flipper_format_stream_read_value_line(
                     break;
                 }
             }
-
-            string_clear(value);
         }
     } while(false);
 
     return result;
 }
 
+bool flipper_format_stream_read_string_buffer(
+    Stream* stream,
+    const char* key,
+    char* data,
+    size_t data_size,
+    size_t* length,
+    bool strict_mode) {
+    return flipper_format_stream_seek_to_key(stream, key, strict_mode) &&
+           flipper_format_stream_read_line_buffer(stream, data, data_size, length);
+}
+
 bool flipper_format_stream_get_value_count(
     Stream* stream,
     const char* key,
@@ -405,9 +479,6 @@ bool flipper_format_stream_get_value_count(
     bool result = false;
     bool last = false;
 
-    string_t value;
-    string_init(value);
-
     uint32_t position = stream_tell(stream);
     do {
         if(!flipper_format_stream_seek_to_key(stream, key, strict_mode)) break;
@@ -415,7 +486,7 @@ bool flipper_format_stream_get_value_count(
 
         result = true;
         while(true) {
-            if(!flipper_format_stream_read_value(stream, value, &last)) {
+            if(!flipper_format_stream_read_value(stream, NULL, 0, &last)) {
                 result = false;
                 break;
             }
@@ -430,7 +501,6 @@ bool flipper_format_stream_get_value_count(
         result = false;
     }
 
-    string_clear(value);
     return result;
 }
 
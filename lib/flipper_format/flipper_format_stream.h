@@ -52,6 +52,25 @@ bool flipper_format_stream_read_value_line(
     size_t data_size,
     bool strict_mode);
 
+/**
+ * Reads a string value by key from a stream into a fixed buffer, without heap allocations.
+ * @param stream 
+ * @param key 
+ * @param data buffer for the value, NUL-terminated on success
+ * @param data_size buffer size
+ * @param length value length, not less than data_size if value doesn't fit the buffer
+ * @param strict_mode 
+ * @return true 
+ * @return false if key is not found or value doesn't fit the buffer, too long value is skipped
+ */
+bool flipper_format_stream_read_string_buffer(
+    Stream* stream,
+    const char* key,
+    char* data,
+    size_t data_size,
+    size_t* length,
+    bool strict_mode);
+
 /**
  * Get the count of values by key from a stream.
  * @param stream 
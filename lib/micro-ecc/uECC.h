@@ -69,6 +69,14 @@ the same endianness. */
     #define uECC_SUPPORTS_secp256k1 1
 #endif
 
+/* uECC_FIXED_BASE_COMB - If enabled (defined as nonzero), multiplication by the secp256r1
+generator (key generation, public key computation and signing) uses a precomputed comb table
+instead of Montgomery's ladder. Results are the same, it is several times faster and takes
+1 KB more of read-only data. */
+#ifndef uECC_FIXED_BASE_COMB
+    #define uECC_FIXED_BASE_COMB uECC_SUPPORTS_secp256r1
+#endif
+
 /* Specifies whether compressed point format is supported.
    Set to 0 to disable point compression/decompression functions. */
 #ifndef uECC_SUPPORT_COMPRESSED_POINT
@@ -135,6 +143,14 @@ Returns the function that will be used to generate random bytes.
 */
 uECC_RNG_Function uECC_get_rng(void);
 
+#if uECC_FIXED_BASE_COMB
+/* uECC_set_fixed_base_comb() function.
+Enable or disable the secp256r1 comb table at runtime (enabled by default). Disabled, all
+generator multiplications use Montgomery's ladder, which is useful for testing.
+*/
+void uECC_set_fixed_base_comb(int enabled);
+#endif
+
 /* uECC_curve_private_key_size() function.
 
 Returns the size of a private key for the curve in bytes.
@@ -263,6 +279,28 @@ int uECC_sign(const uint8_t *private_key,
               uint8_t *signature,
               uECC_Curve curve);
 
+/* uECC_sign_with_k() function.
+Generate an ECDSA signature with an explicitly specified k value. For testing only (for example
+against RFC 6979 test vectors): k must never be reused or predictable.
+
+Inputs:
+    private_key  - Your private key.
+    message_hash - The hash of the message to sign.
+    hash_size    - The size of message_hash in bytes.
+    k            - The k value, curve size long.
+
+Outputs:
+    signature - Will be filled in with the signature value. Must be at least 2 * curve size long.
+
+Returns 1 if the signature generated successfully, 0 if an error occurred.
+*/
+int uECC_sign_with_k(const uint8_t *private_key,
+                     const uint8_t *message_hash,
+                     unsigned hash_size,
+                     const uint8_t *k,
+                     uint8_t *signature,
+                     uECC_Curve curve);
+
 /* uECC_HashContext structure.
 This is used to pass in an arbitrary hash function to uECC_sign_deterministic().
 The structure will be used for multiple hash computations; each time a new hash
@@ -152,11 +152,20 @@ uint16_t mf_ul_prepare_write(uint8_t* dest, uint16_t page_addr, uint32_t data) {
     return 6;
 }
 
+#define MF_UL_ACK (0x0A)
+#define MF_UL_NACK (0x00)
+
+static inline void mf_ul_emulation_set_dirty(MifareUlDevice* mf_ul_emulate, uint8_t page) {
+    mf_ul_emulate->dirty_pages[page / 32] |= 1UL << (page % 32);
+    mf_ul_emulate->data_changed = true;
+}
+
 void mf_ul_prepare_emulation(MifareUlDevice* mf_ul_emulate, MifareUlData* data) {
     mf_ul_emulate->data = *data;
-    mf_ul_emulate->auth_data = NULL;
     mf_ul_emulate->data_changed = false;
     mf_ul_emulate->comp_write_cmd_started = false;
+    mf_ul_emulate->page_num = data->data_size / 4;
+    memset(mf_ul_emulate->dirty_pages, 0, sizeof(mf_ul_emulate->dirty_pages));
     if(data->version.storage_size == 0) {
         mf_ul_emulate->data.type = MfUltralightTypeUnknown;
         mf_ul_emulate->support_fast_read = false;
@@ -177,29 +186,249 @@ void mf_ul_prepare_emulation(MifareUlDevice* mf_ul_emulate, MifareUlData* data)
         mf_ul_emulate->support_fast_read = true;
     }
 
-    if(mf_ul_emulate->data.type >= MfUltralightTypeNTAG213) {
-        uint16_t pwd_page = (data->data_size / 4) - 2;
-        mf_ul_emulate->auth_data = (MifareUlAuthData*)&data->data[pwd_page * 4];
+    // Move PWD and PACK out of the image, so READ and FAST_READ can be served with plain copy
+    mf_ul_emulate->auth_supported = false;
+    memset(&mf_ul_emulate->auth_data, 0, sizeof(MifareUlAuthData));
+    if((mf_ul_emulate->data.type >= MfUltralightTypeNTAG213) && (mf_ul_emulate->page_num > 2)) {
+        uint8_t* pwd = &mf_ul_emulate->data.data[(mf_ul_emulate->page_num - 2) * 4];
+        uint8_t* pack = pwd + 4;
+        memcpy(mf_ul_emulate->auth_data.pwd, pwd, sizeof(mf_ul_emulate->auth_data.pwd));
+        memcpy(mf_ul_emulate->auth_data.pack.raw, pack, sizeof(mf_ul_emulate->auth_data.pack));
+        memset(pwd, 0, sizeof(mf_ul_emulate->auth_data.pwd));
+        memset(pack, 0, sizeof(mf_ul_emulate->auth_data.pack));
+        mf_ul_emulate->auth_supported = true;
     }
 }
 
-void mf_ul_protect_auth_data_on_read_command(
-    uint8_t* tx_buff,
-    uint8_t start_page,
-    uint8_t end_page,
-    MifareUlDevice* mf_ul_emulate) {
-    if(mf_ul_emulate->data.type >= MfUltralightTypeNTAG213) {
-        uint8_t pwd_page = (mf_ul_emulate->data.data_size / 4) - 2;
-        uint8_t pack_page = pwd_page + 1;
-        if((start_page <= pwd_page) && (end_page >= pwd_page)) {
-            memset(&tx_buff[(pwd_page - start_page) * 4], 0, 4);
-        }
-        if((start_page <= pack_page) && (end_page >= pack_page)) {
-            memset(&tx_buff[(pack_page - start_page) * 4], 0, 2);
+void mf_ul_sync_emulation_data(MifareUlDevice* mf_ul_emulate, MifareUlData* data) {
+    furi_assert(mf_ul_emulate);
+    furi_assert(data);
+
+    for(uint16_t page = 0; page < mf_ul_emulate->page_num; page++) {
+        if(mf_ul_emulate->dirty_pages[page / 32] & (1UL << (page % 32))) {
+            memcpy(&data->data[page * 4], &mf_ul_emulate->data.data[page * 4], 4);
         }
     }
+    memcpy(data->counter, mf_ul_emulate->data.counter, sizeof(data->counter));
+    memset(mf_ul_emulate->dirty_pages, 0, sizeof(mf_ul_emulate->dirty_pages));
+    mf_ul_emulate->data_changed = false;
+}
+
+typedef bool (*MfUlEmulationCommandHandler)(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type);
+
+typedef struct {
+    MfUlEmulationCommandHandler handler;
+    uint8_t rx_len;
+} MfUlEmulationCommand;
+
+static bool mf_ul_emulation_ack(uint8_t* buff_tx, uint16_t* tx_bits, uint32_t* data_type) {
+    buff_tx[0] = MF_UL_ACK;
+    *tx_bits = 4;
+    *data_type = FURI_HAL_NFC_TXRX_RAW;
+    return true;
+}
+
+static bool mf_ul_emulation_send(uint16_t tx_bytes, uint16_t* tx_bits, uint32_t* data_type) {
+    *tx_bits = tx_bytes * 8;
+    *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
+    return true;
+}
+
+static bool mf_ul_emulation_get_version(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    if(mf_ul_emulate->data.type == MfUltralightTypeUnknown) {
+        return false;
+    }
+    memcpy(buff_tx, &mf_ul_emulate->data.version, sizeof(mf_ul_emulate->data.version));
+    return mf_ul_emulation_send(sizeof(mf_ul_emulate->data.version), tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_read(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    uint16_t page_num = mf_ul_emulate->page_num;
+    uint8_t start_page = buff_rx[1];
+    if(start_page >= page_num) {
+        return false;
+    }
+    uint8_t* image = mf_ul_emulate->data.data;
+    if(start_page + 4 > page_num) {
+        // Handle roll-over mechanism
+        uint8_t end_pages_num = page_num - start_page;
+        memcpy(buff_tx, &image[start_page * 4], end_pages_num * 4);
+        memcpy(&buff_tx[end_pages_num * 4], image, (4 - end_pages_num) * 4);
+    } else {
+        memcpy(buff_tx, &image[start_page * 4], 16);
+    }
+    return mf_ul_emulation_send(16, tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_fast_read(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    uint16_t page_num = mf_ul_emulate->page_num;
+    uint8_t start_page = buff_rx[1];
+    uint8_t end_page = buff_rx[2];
+    if(!mf_ul_emulate->support_fast_read || (end_page >= page_num) || (start_page > end_page)) {
+        return false;
+    }
+    uint16_t tx_bytes = ((end_page + 1) - start_page) * 4;
+    memcpy(buff_tx, &mf_ul_emulate->data.data[start_page * 4], tx_bytes);
+    return mf_ul_emulation_send(tx_bytes, tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_write(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    uint8_t write_page = buff_rx[1];
+    // Auth pages are never writable, so readable image stays valid without rebuild
+    if((write_page < 2) || (write_page >= mf_ul_emulate->page_num - 2)) {
+        return false;
+    }
+    memcpy(&mf_ul_emulate->data.data[write_page * 4], &buff_rx[2], 4);
+    mf_ul_emulation_set_dirty(mf_ul_emulate, write_page);
+    return mf_ul_emulation_ack(buff_tx, tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_comp_write(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    uint8_t write_page = buff_rx[1];
+    if((write_page < 2) || (write_page >= mf_ul_emulate->page_num - 2)) {
+        return false;
+    }
+    mf_ul_emulate->comp_write_cmd_started = true;
+    mf_ul_emulate->comp_write_page_addr = write_page;
+    return mf_ul_emulation_ack(buff_tx, tx_bits, data_type);
 }
 
+static bool mf_ul_emulation_read_cnt(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    uint8_t cnt_num = buff_rx[1];
+    if(cnt_num >= 3) {
+        return false;
+    }
+    buff_tx[0] = mf_ul_emulate->data.counter[cnt_num] >> 16;
+    buff_tx[1] = mf_ul_emulate->data.counter[cnt_num] >> 8;
+    buff_tx[2] = mf_ul_emulate->data.counter[cnt_num];
+    return mf_ul_emulation_send(3, tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_inc_cnt(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    uint8_t cnt_num = buff_rx[1];
+    uint32_t inc = (buff_rx[2] | (buff_rx[3] << 8) | (buff_rx[4] << 16));
+    if((cnt_num >= 3) || (mf_ul_emulate->data.counter[cnt_num] + inc >= 0x00FFFFFF)) {
+        return false;
+    }
+    mf_ul_emulate->data.counter[cnt_num] += inc;
+    mf_ul_emulate->data_changed = true;
+    return mf_ul_emulation_ack(buff_tx, tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_auth(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    if(!mf_ul_emulate->auth_supported) {
+        return false;
+    }
+    if(memcmp(&buff_rx[1], mf_ul_emulate->auth_data.pwd, 4) == 0) {
+        buff_tx[0] = mf_ul_emulate->auth_data.pack.raw[0];
+        buff_tx[1] = mf_ul_emulate->auth_data.pack.raw[1];
+    } else if(!mf_ul_emulate->auth_data.pack.value) {
+        buff_tx[0] = 0x80;
+        buff_tx[1] = 0x80;
+    } else {
+        return false;
+    }
+    return mf_ul_emulation_send(2, tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_read_sig(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    // Check 2nd byte = 0x00 - RFU
+    if(buff_rx[1] != 0x00) {
+        return false;
+    }
+    memcpy(buff_tx, mf_ul_emulate->data.signature, sizeof(mf_ul_emulate->data.signature));
+    return mf_ul_emulation_send(sizeof(mf_ul_emulate->data.signature), tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_check_tearing(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    uint8_t cnt_num = buff_rx[1];
+    if(cnt_num >= 3) {
+        return false;
+    }
+    buff_tx[0] = mf_ul_emulate->data.tearing[cnt_num];
+    return mf_ul_emulation_send(1, tx_bits, data_type);
+}
+
+static bool mf_ul_emulation_halt(
+    MifareUlDevice* mf_ul_emulate,
+    uint8_t* buff_rx,
+    uint8_t* buff_tx,
+    uint16_t* tx_bits,
+    uint32_t* data_type) {
+    *tx_bits = 0;
+    return true;
+}
+
+// Command byte -> handler, minimal frame length in bytes includes command byte
+static const MfUlEmulationCommand mf_ul_emulation_commands[256] = {
+    [MF_UL_GET_VERSION_CMD] = {.handler = mf_ul_emulation_get_version, .rx_len = 1},
+    [MF_UL_READ_CMD] = {.handler = mf_ul_emulation_read, .rx_len = 2},
+    [MF_UL_FAST_READ_CMD] = {.handler = mf_ul_emulation_fast_read, .rx_len = 3},
+    [MF_UL_WRITE] = {.handler = mf_ul_emulation_write, .rx_len = 6},
+    [MF_UL_COMP_WRITE] = {.handler = mf_ul_emulation_comp_write, .rx_len = 2},
+    [MF_UL_READ_CNT] = {.handler = mf_ul_emulation_read_cnt, .rx_len = 2},
+    [MF_UL_INC_CNT] = {.handler = mf_ul_emulation_inc_cnt, .rx_len = 5},
+    [MF_UL_AUTH] = {.handler = mf_ul_emulation_auth, .rx_len = 5},
+    [MF_UL_READ_SIG] = {.handler = mf_ul_emulation_read_sig, .rx_len = 2},
+    [MF_UL_CHECK_TEARING] = {.handler = mf_ul_emulation_check_tearing, .rx_len = 2},
+    [MF_UL_HALT_START] = {.handler = mf_ul_emulation_halt, .rx_len = 1},
+};
+
 bool mf_ul_prepare_emulation_response(
     uint8_t* buff_rx,
     uint16_t buff_rx_len,
@@ -209,9 +438,6 @@ bool mf_ul_prepare_emulation_response(
     void* context) {
     furi_assert(context);
     MifareUlDevice* mf_ul_emulate = context;
-    uint8_t cmd = buff_rx[0];
-    uint16_t page_num = mf_ul_emulate->data.data_size / 4;
-    uint16_t tx_bytes = 0;
     uint16_t tx_bits = 0;
     bool command_parsed = false;
 
@@ -219,146 +445,27 @@ bool mf_ul_prepare_emulation_response(
     if(mf_ul_emulate->comp_write_cmd_started) {
         // Compatibility write is the only one composit command
         if(buff_rx_len == 16) {
-            memcpy(&mf_ul_emulate->data.data[mf_ul_emulate->comp_write_page_addr * 4], buff_rx, 4);
-            mf_ul_emulate->data_changed = true;
-            // Send ACK message
-            buff_tx[0] = 0x0A;
-            tx_bits = 4;
-            *data_type = FURI_HAL_NFC_TXRX_RAW;
-            command_parsed = true;
+            uint8_t write_page = mf_ul_emulate->comp_write_page_addr;
+            memcpy(&mf_ul_emulate->data.data[write_page * 4], buff_rx, 4);
+            mf_ul_emulation_set_dirty(mf_ul_emulate, write_page);
+            command_parsed = mf_ul_emulation_ack(buff_tx, &tx_bits, data_type);
         }
         mf_ul_emulate->comp_write_cmd_started = false;
-    } else if(cmd == MF_UL_GET_VERSION_CMD) {
-        if(mf_ul_emulate->data.type != MfUltralightTypeUnknown) {
-            tx_bytes = sizeof(mf_ul_emulate->data.version);
-            memcpy(buff_tx, &mf_ul_emulate->data.version, tx_bytes);
-            *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-            command_parsed = true;
+    } else if(buff_rx_len) {
+        const MfUlEmulationCommand* command = &mf_ul_emulation_commands[buff_rx[0]];
+        if(command->handler && ((buff_rx_len / 8) >= command->rx_len)) {
+            command_parsed =
+                command->handler(mf_ul_emulate, buff_rx, buff_tx, &tx_bits, data_type);
         }
-    } else if(cmd == MF_UL_READ_CMD) {
-        uint8_t start_page = buff_rx[1];
-        if(start_page < page_num) {
-            tx_bytes = 16;
-            if(start_page + 4 > page_num) {
-                // Handle roll-over mechanism
-                uint8_t end_pages_num = page_num - start_page;
-                memcpy(buff_tx, &mf_ul_emulate->data.data[start_page * 4], end_pages_num * 4);
-                memcpy(
-                    &buff_tx[end_pages_num * 4],
-                    mf_ul_emulate->data.data,
-                    (4 - end_pages_num) * 4);
-            } else {
-                memcpy(buff_tx, &mf_ul_emulate->data.data[start_page * 4], tx_bytes);
-            }
-            mf_ul_protect_auth_data_on_read_command(
-                buff_tx, start_page, (start_page + 4), mf_ul_emulate);
-            *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-            command_parsed = true;
-        }
-    } else if(cmd == MF_UL_FAST_READ_CMD) {
-        if(mf_ul_emulate->support_fast_read) {
-            uint8_t start_page = buff_rx[1];
-            uint8_t end_page = buff_rx[2];
-            if((start_page < page_num) && (end_page < page_num) && (start_page < (end_page + 1))) {
-                tx_bytes = ((end_page + 1) - start_page) * 4;
-                memcpy(buff_tx, &mf_ul_emulate->data.data[start_page * 4], tx_bytes);
-                mf_ul_protect_auth_data_on_read_command(
-                    buff_tx, start_page, end_page, mf_ul_emulate);
-                *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-                command_parsed = true;
-            }
-        }
-    } else if(cmd == MF_UL_WRITE) {
-        uint8_t write_page = buff_rx[1];
-        if((write_page > 1) && (write_page < page_num - 2)) {
-            memcpy(&mf_ul_emulate->data.data[write_page * 4], &buff_rx[2], 4);
-            mf_ul_emulate->data_changed = true;
-            // ACK
-            buff_tx[0] = 0x0A;
-            tx_bits = 4;
-            *data_type = FURI_HAL_NFC_TXRX_RAW;
-            command_parsed = true;
-        }
-    } else if(cmd == MF_UL_COMP_WRITE) {
-        uint8_t write_page = buff_rx[1];
-        if((write_page > 1) && (write_page < page_num - 2)) {
-            mf_ul_emulate->comp_write_cmd_started = true;
-            mf_ul_emulate->comp_write_page_addr = write_page;
-            // ACK
-            buff_tx[0] = 0x0A;
-            tx_bits = 4;
-            *data_type = FURI_HAL_NFC_TXRX_RAW;
-            command_parsed = true;
-        }
-    } else if(cmd == MF_UL_READ_CNT) {
-        uint8_t cnt_num = buff_rx[1];
-        if(cnt_num < 3) {
-            buff_tx[0] = mf_ul_emulate->data.counter[cnt_num] >> 16;
-            buff_tx[1] = mf_ul_emulate->data.counter[cnt_num] >> 8;
-            buff_tx[2] = mf_ul_emulate->data.counter[cnt_num];
-            tx_bytes = 3;
-            *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-            command_parsed = true;
-        }
-    } else if(cmd == MF_UL_INC_CNT) {
-        uint8_t cnt_num = buff_rx[1];
-        uint32_t inc = (buff_rx[2] | (buff_rx[3] << 8) | (buff_rx[4] << 16));
-        if((cnt_num < 3) && (mf_ul_emulate->data.counter[cnt_num] + inc < 0x00FFFFFF)) {
-            mf_ul_emulate->data.counter[cnt_num] += inc;
-            mf_ul_emulate->data_changed = true;
-            // ACK
-            buff_tx[0] = 0x0A;
-            tx_bits = 4;
-            *data_type = FURI_HAL_NFC_TXRX_RAW;
-            command_parsed = true;
-        }
-    } else if(cmd == MF_UL_AUTH) {
-        if(mf_ul_emulate->data.type >= MfUltralightTypeNTAG213) {
-            if(memcmp(&buff_rx[1], mf_ul_emulate->auth_data->pwd, 4) == 0) {
-                buff_tx[0] = mf_ul_emulate->auth_data->pack.raw[0];
-                buff_tx[1] = mf_ul_emulate->auth_data->pack.raw[1];
-                tx_bytes = 2;
-                *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-                command_parsed = true;
-            } else if(!mf_ul_emulate->auth_data->pack.value) {
-                buff_tx[0] = 0x80;
-                buff_tx[1] = 0x80;
-                tx_bytes = 2;
-                *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-                command_parsed = true;
-            }
-        }
-    } else if(cmd == MF_UL_READ_SIG) {
-        // Check 2nd byte = 0x00 - RFU
-        if(buff_rx[1] == 0x00) {
-            tx_bytes = sizeof(mf_ul_emulate->data.signature);
-            memcpy(buff_tx, mf_ul_emulate->data.signature, tx_bytes);
-            *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-            command_parsed = true;
-        }
-    } else if(cmd == MF_UL_CHECK_TEARING) {
-        uint8_t cnt_num = buff_rx[1];
-        if(cnt_num < 3) {
-            buff_tx[0] = mf_ul_emulate->data.tearing[cnt_num];
-            tx_bytes = 1;
-            *data_type = FURI_HAL_NFC_TXRX_DEFAULT;
-            command_parsed = true;
-        }
-    } else if(cmd == MF_UL_HALT_START) {
-        tx_bits = 0;
-        command_parsed = true;
     }
 
     if(!command_parsed) {
         // Send NACK
-        buff_tx[0] = 0x00;
+        buff_tx[0] = MF_UL_NACK;
         tx_bits = 4;
         *data_type = FURI_HAL_NFC_TXRX_RAW;
     }
     // Return tx buffer size in bits
-    if(tx_bytes) {
-        tx_bits = tx_bytes * 8;
-    }
     *buff_tx_len = tx_bits;
     return tx_bits > 0;
 }
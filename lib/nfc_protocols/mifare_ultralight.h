@@ -5,6 +5,7 @@
 #include <string.h>
 
 #define MF_UL_MAX_DUMP_SIZE 1024
+#define MF_UL_MAX_PAGES (MF_UL_MAX_DUMP_SIZE / 4)
 
 #define MF_UL_TEARING_FLAG_DEFAULT (0xBD)
 
@@ -77,8 +78,12 @@ typedef struct {
     uint8_t pages_readed;
     bool support_fast_read;
     bool data_changed;
+    // In emulation mode data.data is the readable image: PWD and PACK are masked
     MifareUlData data;
-    MifareUlAuthData* auth_data;
+    MifareUlAuthData auth_data;
+    bool auth_supported;
+    uint16_t page_num;
+    uint32_t dirty_pages[MF_UL_MAX_PAGES / 32];
     bool comp_write_cmd_started;
     uint8_t comp_write_page_addr;
 } MifareUlDevice;
@@ -115,7 +120,22 @@ void mf_ul_parse_fast_read_response(
 
 uint16_t mf_ul_prepare_write(uint8_t* dest, uint16_t page_addr, uint32_t data);
 
+/** Prepare emulation
+ * Builds readable image with masked PWD and PACK pages and resets dirty pages tracking
+ *
+ * @param mf_ul_emulate     MifareUlDevice instance
+ * @param data              MifareUlData to emulate
+ */
 void mf_ul_prepare_emulation(MifareUlDevice* mf_ul_emulate, MifareUlData* data);
+
+/** Copy changes made by reader during emulation
+ * Only dirty pages and counters are copied, auth pages of destination are kept intact
+ *
+ * @param mf_ul_emulate     MifareUlDevice instance
+ * @param data              MifareUlData to update
+ */
+void mf_ul_sync_emulation_data(MifareUlDevice* mf_ul_emulate, MifareUlData* data);
+
 bool mf_ul_prepare_emulation_response(
     uint8_t* buff_rx,
     uint16_t buff_rx_len,
@@ -1,48 +1,75 @@
 #include "maxim_crc.h"
 
-uint8_t maxim_crc8(const uint8_t* data, const uint8_t data_size, const uint8_t crc_init) {
-    uint8_t crc = crc_init;
+template <typename T> struct MaximCrcTable {
+    T value[256];
+};
+
+// Dallas/Maxim CRC8: x^8 + x^5 + x^4 + 1, reflected
+static constexpr MaximCrcTable<uint8_t> maxim_crc8_table_generate() {
+    MaximCrcTable<uint8_t> table = {};
 
-    for(uint8_t index = 0; index < data_size; ++index) {
-        uint8_t input_byte = data[index];
-        for(uint8_t bit_position = 0; bit_position < 8; ++bit_position) {
-            const uint8_t mix = (crc ^ input_byte) & static_cast<uint8_t>(0x01);
-            crc >>= 1;
-            if(mix != 0) crc ^= 0x8C;
-            input_byte >>= 1;
+    for(uint16_t i = 0; i < 256; i++) {
+        uint8_t crc = i;
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x01) ? ((crc >> 1) ^ 0x8C) : (crc >> 1);
         }
+        table.value[i] = crc;
     }
-    return crc;
+
+    return table;
 }
 
-uint16_t maxim_crc16(const uint8_t* address, const uint8_t length, const uint16_t init) {
-    uint16_t crc = init;
+// Dallas/Maxim CRC16: x^16 + x^15 + x^2 + 1, reflected
+static constexpr MaximCrcTable<uint16_t> maxim_crc16_table_generate() {
+    MaximCrcTable<uint16_t> table = {};
+
+    for(uint16_t i = 0; i < 256; i++) {
+        uint16_t crc = i;
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ 0xA001) : (crc >> 1);
+        }
+        table.value[i] = crc;
+    }
 
-    static const uint8_t odd_parity[16] = {0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0};
+    return table;
+}
 
-    for(uint8_t i = 0; i < length; ++i) {
-        uint16_t cdata = address[i];
-        cdata = (cdata ^ crc) & static_cast<uint16_t>(0xff);
-        crc >>= 8;
+static constexpr MaximCrcTable<uint8_t> maxim_crc8_table = maxim_crc8_table_generate();
+static constexpr MaximCrcTable<uint16_t> maxim_crc16_table = maxim_crc16_table_generate();
 
-        if((odd_parity[cdata & 0x0F] ^ odd_parity[cdata >> 4]) != 0) crc ^= 0xC001;
+uint8_t maxim_crc8(const uint8_t* data, const size_t data_size, const uint8_t crc_init) {
+    uint8_t crc = crc_init;
 
-        cdata <<= 6;
-        crc ^= cdata;
-        cdata <<= 1;
-        crc ^= cdata;
+    for(size_t index = 0; index < data_size; ++index) {
+        crc = maxim_crc8_table.value[crc ^ data[index]];
     }
 
     return crc;
 }
 
-uint16_t maxim_crc16(uint8_t value, uint16_t crc) {
-    static const uint8_t odd_parity[16] = {0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0};
-    value = (value ^ static_cast<uint8_t>(crc));
-    crc >>= 8;
-    if((odd_parity[value & 0x0F] ^ odd_parity[value >> 4]) != 0) crc ^= 0xC001;
-    uint16_t cdata = (static_cast<uint16_t>(value) << 6);
-    crc ^= cdata;
-    crc ^= (static_cast<uint16_t>(cdata) << 1);
+uint16_t maxim_crc16(const uint8_t* address, const size_t length, const uint16_t init) {
+    uint16_t crc = init;
+
+    for(size_t index = 0; index < length; ++index) {
+        crc = (crc >> 8) ^ maxim_crc16_table.value[(crc ^ address[index]) & 0xFF];
+    }
+
     return crc;
-}
\ No newline at end of file
+}
+
+uint16_t maxim_crc16(uint8_t value, uint16_t crc) {
+    return (crc >> 8) ^ maxim_crc16_table.value[(crc ^ value) & 0xFF];
+}
+
+size_t maxim_crc8_verify_roms(const uint8_t* roms, size_t count, bool* valid) {
+    size_t valid_count = 0;
+
+    for(size_t i = 0; i < count; i++) {
+        // CRC over the whole ROM including CRC byte is zero
+        bool rom_valid = (maxim_crc8(&roms[i * MAXIM_ROM_SIZE], MAXIM_ROM_SIZE) == 0);
+        if(valid) valid[i] = rom_valid;
+        if(rom_valid) valid_count++;
+    }
+
+    return valid_count;
+}
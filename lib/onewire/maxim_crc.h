@@ -1,6 +1,19 @@
 #pragma once
 #include <stdint.h>
+#include <stddef.h>
 
-uint8_t maxim_crc8(const uint8_t* data, const uint8_t data_size, const uint8_t crc_init = 0);
-uint16_t maxim_crc16(const uint8_t* address, const uint8_t length, const uint16_t init = 0);
-uint16_t maxim_crc16(uint8_t value, uint16_t crc);
\ No newline at end of file
+#define MAXIM_ROM_SIZE 8
+
+uint8_t maxim_crc8(const uint8_t* data, const size_t data_size, const uint8_t crc_init = 0);
+uint16_t maxim_crc16(const uint8_t* address, const size_t length, const uint16_t init = 0);
+uint16_t maxim_crc16(uint8_t value, uint16_t crc);
+
+/**
+ * @brief Verify CRC8 of 1-Wire ROM codes, CRC is stored in the last byte of every ROM
+ * 
+ * @param roms ROM codes, MAXIM_ROM_SIZE bytes each
+ * @param count ROM codes count
+ * @param valid optional per ROM result, count elements
+ * @return size_t valid ROM codes count
+ */
+size_t maxim_crc8_verify_roms(const uint8_t* roms, size_t count, bool* valid = nullptr);
@@ -4,6 +4,8 @@
 #define TAG "SubGhzRaw"
 
 #define SUBGHZ_DOWNLOAD_MAX_SIZE 512
+#define SUBGHZ_RAW_BUFFER_COUNT 3
+#define SUBGHZ_RAW_WRITER_STOP 0xFF
 
 struct SubGhzProtocolRAW {
     SubGhzProtocolCommon common;
@@ -19,6 +21,17 @@ struct SubGhzProtocolRAW {
     bool last_level;
     SubGhzProtocolRAWCallbackEnd callback_end;
     void* context_end;
+
+    // Samples are captured to one buffer while filled ones are written by writer thread
+    int32_t* buffer_pool;
+    uint16_t buffer_len[SUBGHZ_RAW_BUFFER_COUNT];
+    uint32_t buffer_tick[SUBGHZ_RAW_BUFFER_COUNT];
+    uint8_t buffer_cur;
+    osMessageQueueId_t free_queue;
+    osMessageQueueId_t write_queue;
+    FuriThread* writer_thread;
+    volatile size_t sample_captured;
+    SubGhzProtocolRAWWriterStats stats;
 };
 
 typedef enum {
@@ -27,11 +40,62 @@ typedef enum {
     RAWFileIsOpenRead,
 } RAWFilIsOpen;
 
+static int32_t subghz_protocol_raw_writer_thread(void* context) {
+    SubGhzProtocolRAW* instance = context;
+    // Formatting and storage access must not hold back decoding
+    osThreadSetPriority(osThreadGetId(), osPriorityBelowNormal);
+
+    uint8_t index = 0;
+    while(osMessageQueueGet(instance->write_queue, &index, NULL, osWaitForever) == osOK) {
+        if(index == SUBGHZ_RAW_WRITER_STOP) break;
+
+        if(!flipper_format_write_int32(
+               instance->flipper_format,
+               "RAW_Data",
+               &instance->buffer_pool[index * SUBGHZ_DOWNLOAD_MAX_SIZE],
+               instance->buffer_len[index])) {
+            FURI_LOG_E(TAG, "Unable to add RAW_Data");
+        } else {
+            instance->sample_write += instance->buffer_len[index];
+        }
+
+        uint32_t latency = osKernelGetTickCount() - instance->buffer_tick[index];
+        if(latency > instance->stats.write_latency_max) {
+            instance->stats.write_latency_max = latency;
+        }
+        furi_check(osMessageQueuePut(instance->free_queue, &index, 0, 0) == osOK);
+    }
+
+    return 0;
+}
+
+static bool subghz_protocol_raw_buffer_take(SubGhzProtocolRAW* instance) {
+    uint8_t index = 0;
+    if(osMessageQueueGet(instance->free_queue, &index, NULL, 0) != osOK) return false;
+    instance->buffer_cur = index;
+    instance->upload_raw = &instance->buffer_pool[index * SUBGHZ_DOWNLOAD_MAX_SIZE];
+    instance->ind_write = 0;
+    return true;
+}
+
 SubGhzProtocolRAW* subghz_protocol_raw_alloc(void) {
     SubGhzProtocolRAW* instance = malloc(sizeof(SubGhzProtocolRAW));
 
     instance->upload_raw = NULL;
     instance->ind_write = 0;
+    instance->buffer_pool = NULL;
+    instance->sample_write = 0;
+    instance->sample_captured = 0;
+    memset(&instance->stats, 0, sizeof(SubGhzProtocolRAWWriterStats));
+    instance->free_queue = osMessageQueueNew(SUBGHZ_RAW_BUFFER_COUNT, sizeof(uint8_t), NULL);
+    // One more slot for stop request
+    instance->write_queue = osMessageQueueNew(SUBGHZ_RAW_BUFFER_COUNT + 1, sizeof(uint8_t), NULL);
+
+    instance->writer_thread = furi_thread_alloc();
+    furi_thread_set_name(instance->writer_thread, "SubGhzRawWriter");
+    furi_thread_set_stack_size(instance->writer_thread, 2048);
+    furi_thread_set_context(instance->writer_thread, instance);
+    furi_thread_set_callback(instance->writer_thread, subghz_protocol_raw_writer_thread);
 
     instance->last_level = false;
 
@@ -61,6 +125,10 @@ void subghz_protocol_raw_free(SubGhzProtocolRAW* instance) {
     furi_assert(instance);
     string_clear(instance->file_name);
 
+    furi_thread_free(instance->writer_thread);
+    osMessageQueueDelete(instance->write_queue);
+    osMessageQueueDelete(instance->free_queue);
+
     flipper_format_free(instance->flipper_format);
     furi_record_close("storage");
 
@@ -128,16 +196,23 @@ bool subghz_protocol_raw_send_key(
 }
 
 void subghz_protocol_raw_reset(SubGhzProtocolRAW* instance) {
-    instance->ind_write = 0;
+    // Captured samples stay valid, reset during capture means edges were lost by worker
+    if(instance->file_is_open == RAWFileIsOpenWrite) instance->stats.stream_overrun_cnt++;
 }
 
 void subghz_protocol_raw_parse(SubGhzProtocolRAW* instance, bool level, uint32_t duration) {
-    if(instance->upload_raw != NULL) {
+    if(instance->file_is_open == RAWFileIsOpenWrite) {
         if(duration > instance->common.te_short) {
             if(duration > instance->common.te_long) duration = instance->common.te_long;
             if(instance->last_level != level) {
                 instance->last_level = (level ? true : false);
-                instance->upload_raw[instance->ind_write++] = (level ? duration : -duration);
+                if((instance->upload_raw != NULL) || (subghz_protocol_raw_buffer_take(instance))) {
+                    instance->upload_raw[instance->ind_write++] = (level ? duration : -duration);
+                    instance->sample_captured++;
+                } else {
+                    // All buffers are in flight
+                    instance->stats.samples_lost++;
+                }
             }
         }
 
@@ -214,9 +289,21 @@ bool subghz_protocol_raw_save_to_file_init(
             break;
         }
 
-        instance->upload_raw = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
-        instance->file_is_open = RAWFileIsOpenWrite;
+        instance->buffer_pool =
+            malloc(SUBGHZ_RAW_BUFFER_COUNT * SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
+        osMessageQueueReset(instance->free_queue);
+        osMessageQueueReset(instance->write_queue);
+        for(uint8_t i = 0; i < SUBGHZ_RAW_BUFFER_COUNT; i++) {
+            osMessageQueuePut(instance->free_queue, &i, 0, 0);
+        }
+        subghz_protocol_raw_buffer_take(instance);
+
         instance->sample_write = 0;
+        instance->sample_captured = 0;
+        memset(&instance->stats, 0, sizeof(SubGhzProtocolRAWWriterStats));
+        instance->stats.buffers_count = SUBGHZ_RAW_BUFFER_COUNT;
+        furi_thread_start(instance->writer_thread);
+        instance->file_is_open = RAWFileIsOpenWrite;
         init = true;
     } while(0);
 
@@ -228,11 +315,26 @@ bool subghz_protocol_raw_save_to_file_init(
 void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolRAW* instance) {
     furi_assert(instance);
 
-    if(instance->file_is_open == RAWFileIsOpenWrite && instance->ind_write)
-        subghz_protocol_raw_save_to_file_write(instance);
-    if(instance->file_is_open != RAWFileIsOpenClose) {
-        free(instance->upload_raw);
+    if(instance->file_is_open == RAWFileIsOpenWrite) {
+        if(instance->ind_write) subghz_protocol_raw_save_to_file_write(instance);
+        // Writer finishes queued buffers before stop request
+        uint8_t stop = SUBGHZ_RAW_WRITER_STOP;
+        furi_check(osMessageQueuePut(instance->write_queue, &stop, 0, osWaitForever) == osOK);
+        furi_thread_join(instance->writer_thread);
+        FURI_LOG_I(
+            TAG,
+            "Written %u samples, lost %u, overruns %u/%u, max latency %ums, max in flight %u",
+            instance->sample_write,
+            instance->stats.samples_lost,
+            instance->stats.overrun_cnt,
+            instance->stats.stream_overrun_cnt,
+            instance->stats.write_latency_max,
+            instance->stats.buffers_in_flight_max);
+
+        free(instance->buffer_pool);
+        instance->buffer_pool = NULL;
         instance->upload_raw = NULL;
+        instance->ind_write = 0;
     }
 
     flipper_format_file_close(instance->flipper_format);
@@ -243,21 +345,42 @@ bool subghz_protocol_raw_save_to_file_write(SubGhzProtocolRAW* instance) {
     furi_assert(instance);
 
     bool is_write = false;
-    if(instance->file_is_open == RAWFileIsOpenWrite) {
-        if(!flipper_format_write_int32(
-               instance->flipper_format, "RAW_Data", instance->upload_raw, instance->ind_write)) {
-            FURI_LOG_E(TAG, "Unable to add RAW_Data");
-        } else {
-            instance->sample_write += instance->ind_write;
-            instance->ind_write = 0;
-            is_write = true;
+    if((instance->file_is_open == RAWFileIsOpenWrite) && (instance->upload_raw != NULL)) {
+        uint8_t index = instance->buffer_cur;
+        instance->buffer_len[index] = instance->ind_write;
+        instance->buffer_tick[index] = osKernelGetTickCount();
+        furi_check(osMessageQueuePut(instance->write_queue, &index, 0, 0) == osOK);
+        instance->upload_raw = NULL;
+        instance->ind_write = 0;
+        is_write = true;
+
+        uint8_t in_flight = SUBGHZ_RAW_BUFFER_COUNT - osMessageQueueGetCount(instance->free_queue);
+        if(in_flight > instance->stats.buffers_in_flight_max) {
+            instance->stats.buffers_in_flight_max = in_flight;
         }
+        // Samples are dropped until writer returns a buffer
+        if(!subghz_protocol_raw_buffer_take(instance)) instance->stats.overrun_cnt++;
     }
     return is_write;
 }
 
 size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolRAW* instance) {
-    return instance->sample_write + instance->ind_write;
+    return instance->sample_captured;
+}
+
+void subghz_protocol_raw_get_writer_stats(
+    SubGhzProtocolRAW* instance,
+    SubGhzProtocolRAWWriterStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+
+    *stats = instance->stats;
+    stats->buffers_in_flight = 0;
+    if(instance->file_is_open == RAWFileIsOpenWrite) {
+        stats->buffers_in_flight =
+            SUBGHZ_RAW_BUFFER_COUNT - osMessageQueueGetCount(instance->free_queue) -
+            ((instance->upload_raw != NULL) ? 1 : 0);
+    }
 }
 
 bool subghz_protocol_raw_to_load_protocol_from_file(
@@ -6,6 +6,17 @@ typedef void (*SubGhzProtocolRAWCallbackEnd)(void* context);
 
 typedef struct SubGhzProtocolRAW SubGhzProtocolRAW;
 
+/** RAW capture writer backpressure */
+typedef struct {
+    uint8_t buffers_count; /**< capture buffers total */
+    uint8_t buffers_in_flight; /**< filled buffers waiting for write or being written */
+    uint8_t buffers_in_flight_max;
+    uint32_t write_latency_max; /**< max time from buffer fill to write completion, ms */
+    uint32_t overrun_cnt; /**< times all buffers were in flight when current one filled up */
+    uint32_t samples_lost; /**< samples dropped while all buffers were in flight */
+    uint32_t stream_overrun_cnt; /**< edges lost by SubGhzWorker before reaching capture */
+} SubGhzProtocolRAWWriterStats;
+
 /** Allocate SubGhzProtocolRAW
  * 
  * @return SubGhzProtocolRAW* 
@@ -61,10 +72,36 @@ bool subghz_protocol_raw_save_to_file_init(
     const char* dev_name,
     uint32_t frequency,
     const char* preset);
+
+/** Stop capture, wait until all captured samples are written and close file
+ * 
+ * @param instance - SubGhzProtocolRAW instance
+ */
 void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolRAW* instance);
+
+/** Pass current capture buffer to writer thread and switch to a free one
+ * 
+ * @param instance - SubGhzProtocolRAW instance
+ * @return true if buffer was queued for writing
+ */
 bool subghz_protocol_raw_save_to_file_write(SubGhzProtocolRAW* instance);
+
+/** Get count of captured samples
+ * 
+ * @param instance - SubGhzProtocolRAW instance
+ * @return samples count
+ */
 size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolRAW* instance);
 
+/** Get capture writer statistics
+ * 
+ * @param instance - SubGhzProtocolRAW instance
+ * @param stats - SubGhzProtocolRAWWriterStats output
+ */
+void subghz_protocol_raw_get_writer_stats(
+    SubGhzProtocolRAW* instance,
+    SubGhzProtocolRAWWriterStats* stats);
+
 bool subghz_protocol_raw_to_load_protocol_from_file(
     FlipperFormat* flipper_format,
     SubGhzProtocolRAW* instance,
@@ -0,0 +1,351 @@
+#include "subghz_tx_rx_link.h"
+
+#include <furi.h>
+
+#define TAG "SubGhzTxRxLink"
+
+/*
+ * Frame header:
+ * 0 - type in low nibble, flags in high nibble
+ * 1 - sender id
+ * 2 - sequence number, incremented for each new frame, same for retries
+ * 3 - fragment index in high nibble, fragments count - 1 in low nibble
+ * ACK frame carries acknowledged sequence number and id of data sender in payload
+ */
+#define SUBGHZ_TXRX_LINK_TYPE_MASK 0x0F
+#define SUBGHZ_TXRX_LINK_FLAG_ACK_REQUEST 0x10
+
+/** Senders tracked for sequence, least recently heard one is replaced */
+#define SUBGHZ_TXRX_LINK_SOURCES 4
+
+#define SUBGHZ_TXRX_LINK_FRAGMENTS_COUNT(size) \
+    (((size) + SUBGHZ_TXRX_LINK_PAYLOAD_MAX - 1) / SUBGHZ_TXRX_LINK_PAYLOAD_MAX)
+
+typedef enum {
+    SubGhzTxRxLinkFrameData = 0x01,
+    SubGhzTxRxLinkFrameAck = 0x02,
+} SubGhzTxRxLinkFrameType;
+
+typedef struct {
+    bool valid;
+    uint8_t src;
+    uint8_t seq;
+    uint32_t heard;
+} SubGhzTxRxLinkSource;
+
+struct SubGhzTxRxLink {
+    uint8_t id;
+    uint8_t ack_retries;
+    uint32_t ack_timeout;
+
+    // Transmission
+    uint8_t tx_message[SUBGHZ_TXRX_LINK_MESSAGE_MAX];
+    size_t tx_size;
+    uint8_t tx_fragment;
+    uint8_t tx_fragments;
+    uint8_t tx_seq;
+    bool tx_wait_ack;
+    uint8_t tx_retry;
+    uint32_t tx_time;
+
+    bool ack_pending;
+    uint8_t ack_dst;
+    uint8_t ack_seq;
+
+    // Reception
+    SubGhzTxRxLinkSource rx_sources[SUBGHZ_TXRX_LINK_SOURCES];
+
+    bool rx_assembly;
+    uint8_t rx_assembly_src;
+    uint8_t rx_assembly_seq;
+    uint8_t rx_assembly_fragments;
+    uint16_t rx_assembly_mask;
+    size_t rx_assembly_size;
+    uint8_t rx_message[SUBGHZ_TXRX_LINK_MESSAGE_MAX];
+
+    SubGhzTxRxLinkCallback callback;
+    void* context;
+
+    SubGhzTxRxLinkStats stats;
+};
+
+SubGhzTxRxLink* subghz_tx_rx_link_alloc(uint8_t id) {
+    SubGhzTxRxLink* instance = malloc(sizeof(SubGhzTxRxLink));
+    memset(instance, 0, sizeof(SubGhzTxRxLink));
+    instance->id = id;
+    return instance;
+}
+
+void subghz_tx_rx_link_free(SubGhzTxRxLink* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+void subghz_tx_rx_link_reset(SubGhzTxRxLink* instance) {
+    furi_assert(instance);
+    instance->tx_size = 0;
+    instance->tx_wait_ack = false;
+    instance->ack_pending = false;
+    memset(instance->rx_sources, 0, sizeof(instance->rx_sources));
+    instance->rx_assembly = false;
+    memset(&instance->stats, 0, sizeof(SubGhzTxRxLinkStats));
+}
+
+void subghz_tx_rx_link_set_ack(SubGhzTxRxLink* instance, uint8_t retries, uint32_t timeout) {
+    furi_assert(instance);
+    instance->ack_retries = retries;
+    instance->ack_timeout = timeout;
+}
+
+void subghz_tx_rx_link_set_callback(
+    SubGhzTxRxLink* instance,
+    SubGhzTxRxLinkCallback callback,
+    void* context) {
+    furi_assert(instance);
+    instance->callback = callback;
+    instance->context = context;
+}
+
+bool subghz_tx_rx_link_is_tx_idle(SubGhzTxRxLink* instance) {
+    furi_assert(instance);
+    return instance->tx_size == 0;
+}
+
+bool subghz_tx_rx_link_send(SubGhzTxRxLink* instance, const uint8_t* data, size_t size) {
+    furi_assert(instance);
+    if(instance->tx_size || !size || size > SUBGHZ_TXRX_LINK_MESSAGE_MAX) return false;
+
+    memcpy(instance->tx_message, data, size);
+    instance->tx_size = size;
+    instance->tx_fragment = 0;
+    instance->tx_fragments = SUBGHZ_TXRX_LINK_FRAGMENTS_COUNT(size);
+    instance->tx_wait_ack = false;
+    return true;
+}
+
+static void subghz_tx_rx_link_tx_next(SubGhzTxRxLink* instance) {
+    instance->tx_wait_ack = false;
+    instance->tx_fragment++;
+    if(instance->tx_fragment == instance->tx_fragments) {
+        instance->tx_size = 0;
+        instance->stats.tx_messages++;
+    }
+}
+
+static size_t subghz_tx_rx_link_build_data(SubGhzTxRxLink* instance, uint8_t* frame) {
+    size_t offset = instance->tx_fragment * SUBGHZ_TXRX_LINK_PAYLOAD_MAX;
+    size_t payload = MIN(instance->tx_size - offset, (size_t)SUBGHZ_TXRX_LINK_PAYLOAD_MAX);
+
+    frame[0] = SubGhzTxRxLinkFrameData;
+    if(instance->ack_retries) frame[0] |= SUBGHZ_TXRX_LINK_FLAG_ACK_REQUEST;
+    frame[1] = instance->id;
+    frame[2] = instance->tx_seq;
+    frame[3] = (instance->tx_fragment << 4) | (instance->tx_fragments - 1);
+    memcpy(&frame[SUBGHZ_TXRX_LINK_HEADER_SIZE], &instance->tx_message[offset], payload);
+    return SUBGHZ_TXRX_LINK_HEADER_SIZE + payload;
+}
+
+bool subghz_tx_rx_link_get_frame(
+    SubGhzTxRxLink* instance,
+    uint8_t* frame,
+    size_t* size,
+    uint32_t now) {
+    furi_assert(instance);
+    furi_assert(frame);
+    furi_assert(size);
+
+    if(instance->ack_pending) {
+        instance->ack_pending = false;
+        frame[0] = SubGhzTxRxLinkFrameAck;
+        frame[1] = instance->id;
+        frame[2] = instance->ack_seq;
+        frame[3] = 0;
+        frame[4] = instance->ack_dst;
+        *size = SUBGHZ_TXRX_LINK_HEADER_SIZE + 1;
+        instance->stats.tx_frames++;
+        return true;
+    }
+
+    if(instance->tx_wait_ack) {
+        if((now - instance->tx_time) < instance->ack_timeout) return false;
+        if(instance->tx_retry < instance->ack_retries) {
+            instance->tx_retry++;
+            instance->tx_time = now;
+            *size = subghz_tx_rx_link_build_data(instance, frame);
+            instance->stats.tx_frames++;
+            instance->stats.tx_retries++;
+            return true;
+        }
+        // Peer is gone, drop the rest of message
+        FURI_LOG_D(TAG, "No ACK for %u", instance->tx_seq);
+        instance->tx_wait_ack = false;
+        instance->tx_size = 0;
+        instance->stats.tx_failed++;
+    }
+
+    if(!instance->tx_size) return false;
+
+    instance->tx_seq++;
+    *size = subghz_tx_rx_link_build_data(instance, frame);
+    instance->stats.tx_frames++;
+    if(instance->ack_retries) {
+        instance->tx_wait_ack = true;
+        instance->tx_retry = 0;
+        instance->tx_time = now;
+    } else {
+        subghz_tx_rx_link_tx_next(instance);
+    }
+    return true;
+}
+
+// Other node uses our id: its ACKs and sequence would be mixed with ours, so take another one
+static void subghz_tx_rx_link_change_id(SubGhzTxRxLink* instance, uint32_t now) {
+    // Nodes that collided see the conflict at different times, so they don't pick the same id
+    uint8_t id = instance->id + 1 + (now % UINT8_MAX);
+    FURI_LOG_W(TAG, "Id %u is used by other node, switching to %u", instance->id, id);
+    instance->id = id;
+    instance->stats.id_conflicts++;
+    // Receiver tracks frames by sender id, current message is sent again from the start
+    if(instance->tx_size) {
+        instance->tx_fragment = 0;
+        instance->tx_wait_ack = false;
+    }
+}
+
+static void subghz_tx_rx_link_put_ack(
+    SubGhzTxRxLink* instance,
+    const uint8_t* frame,
+    size_t size,
+    uint32_t now) {
+    if(size != SUBGHZ_TXRX_LINK_HEADER_SIZE + 1) {
+        instance->stats.rx_invalid++;
+        return;
+    }
+    if(instance->tx_wait_ack && (frame[2] == instance->tx_seq) &&
+       (frame[SUBGHZ_TXRX_LINK_HEADER_SIZE] == instance->id)) {
+        instance->stats.tx_ack_time_max =
+            MAX(instance->stats.tx_ack_time_max, now - instance->tx_time);
+        subghz_tx_rx_link_tx_next(instance);
+    }
+}
+
+static SubGhzTxRxLinkSource*
+    subghz_tx_rx_link_get_source(SubGhzTxRxLink* instance, uint8_t src) {
+    SubGhzTxRxLinkSource* oldest = &instance->rx_sources[0];
+    for(size_t i = 0; i < SUBGHZ_TXRX_LINK_SOURCES; i++) {
+        SubGhzTxRxLinkSource* source = &instance->rx_sources[i];
+        if(source->valid && (source->src == src)) return source;
+        if(!source->valid) {
+            oldest = source;
+        } else if(oldest->valid && (source->heard < oldest->heard)) {
+            oldest = source;
+        }
+    }
+    oldest->valid = false;
+    oldest->src = src;
+    return oldest;
+}
+
+static void subghz_tx_rx_link_put_data(
+    SubGhzTxRxLink* instance,
+    const uint8_t* frame,
+    size_t size) {
+    uint8_t src = frame[1];
+    uint8_t seq = frame[2];
+    uint8_t fragment = frame[3] >> 4;
+    uint8_t fragments = (frame[3] & 0x0F) + 1;
+    size_t payload = size - SUBGHZ_TXRX_LINK_HEADER_SIZE;
+    size_t offset = fragment * SUBGHZ_TXRX_LINK_PAYLOAD_MAX;
+
+    // All fragments but last are full
+    bool is_last = (fragment == fragments - 1);
+    if((fragment >= fragments) || (!is_last && payload != SUBGHZ_TXRX_LINK_PAYLOAD_MAX) ||
+       (offset + payload > SUBGHZ_TXRX_LINK_MESSAGE_MAX)) {
+        instance->stats.rx_invalid++;
+        return;
+    }
+
+    // Duplicate is acknowledged again, its ACK was lost
+    if(frame[0] & SUBGHZ_TXRX_LINK_FLAG_ACK_REQUEST) {
+        instance->ack_pending = true;
+        instance->ack_dst = src;
+        instance->ack_seq = seq;
+    }
+
+    SubGhzTxRxLinkSource* source = subghz_tx_rx_link_get_source(instance, src);
+    if(source->valid) {
+        uint8_t gap = seq - source->seq - 1;
+        if(gap == UINT8_MAX) {
+            instance->stats.rx_duplicates++;
+            return;
+        } else if(gap < 0x80) {
+            instance->stats.rx_lost += gap;
+        }
+    }
+    source->valid = true;
+    source->seq = seq;
+    source->heard = instance->stats.rx_frames;
+
+    // Fragments of one message have consecutive sequence numbers
+    uint8_t message_seq = seq - fragment;
+    if(!instance->rx_assembly || (instance->rx_assembly_src != src) ||
+       (instance->rx_assembly_seq != message_seq) ||
+       (instance->rx_assembly_fragments != fragments)) {
+        if(instance->rx_assembly) instance->stats.rx_messages_dropped++;
+        instance->rx_assembly = true;
+        instance->rx_assembly_src = src;
+        instance->rx_assembly_seq = message_seq;
+        instance->rx_assembly_fragments = fragments;
+        instance->rx_assembly_mask = 0;
+        instance->rx_assembly_size = 0;
+    }
+
+    memcpy(&instance->rx_message[offset], &frame[SUBGHZ_TXRX_LINK_HEADER_SIZE], payload);
+    instance->rx_assembly_mask |= (1 << fragment);
+    if(is_last) instance->rx_assembly_size = offset + payload;
+
+    if(instance->rx_assembly_mask == (1 << fragments) - 1) {
+        instance->rx_assembly = false;
+        instance->stats.rx_messages++;
+        if(instance->callback) {
+            instance->callback(
+                instance->rx_message, instance->rx_assembly_size, instance->context);
+        }
+    }
+}
+
+void subghz_tx_rx_link_put_frame(
+    SubGhzTxRxLink* instance,
+    const uint8_t* frame,
+    size_t size,
+    float rssi,
+    uint8_t lqi,
+    uint32_t now) {
+    furi_assert(instance);
+    furi_assert(frame);
+
+    uint8_t type = 0;
+    if(size >= SUBGHZ_TXRX_LINK_HEADER_SIZE) type = frame[0] & SUBGHZ_TXRX_LINK_TYPE_MASK;
+    if(((type != SubGhzTxRxLinkFrameData) && (type != SubGhzTxRxLinkFrameAck)) ||
+       (size > SUBGHZ_TXRX_LINK_FRAME_MAX)) {
+        instance->stats.rx_invalid++;
+        return;
+    }
+    if(frame[1] == instance->id) subghz_tx_rx_link_change_id(instance, now);
+
+    instance->stats.rx_frames++;
+    instance->stats.rssi = rssi;
+    instance->stats.lqi = lqi;
+
+    if(type == SubGhzTxRxLinkFrameData) {
+        subghz_tx_rx_link_put_data(instance, frame, size);
+    } else {
+        subghz_tx_rx_link_put_ack(instance, frame, size, now);
+    }
+}
+
+void subghz_tx_rx_link_get_stats(SubGhzTxRxLink* instance, SubGhzTxRxLinkStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    *stats = instance->stats;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max frame size including header, CC1101 variable packet length limit is 255 */
+#define SUBGHZ_TXRX_LINK_FRAME_MAX 240
+#define SUBGHZ_TXRX_LINK_HEADER_SIZE 4
+#define SUBGHZ_TXRX_LINK_PAYLOAD_MAX (SUBGHZ_TXRX_LINK_FRAME_MAX - SUBGHZ_TXRX_LINK_HEADER_SIZE)
+/** Max message size, message is split to fragments of SUBGHZ_TXRX_LINK_PAYLOAD_MAX */
+#define SUBGHZ_TXRX_LINK_MESSAGE_MAX 1024
+
+typedef struct SubGhzTxRxLink SubGhzTxRxLink;
+
+/** Message reassembled from received fragments
+ * @param data message data
+ * @param size message size
+ * @param context callback context
+ */
+typedef void (*SubGhzTxRxLinkCallback)(const uint8_t* data, size_t size, void* context);
+
+typedef struct {
+    uint32_t tx_frames; /**< Frames sent, including ACKs and retries */
+    uint32_t tx_retries; /**< Frames sent again because of missing ACK */
+    uint32_t tx_failed; /**< Messages dropped after all retries */
+    uint32_t tx_messages; /**< Messages sent completely */
+    uint32_t tx_ack_time_max; /**< Max time from frame to its ACK */
+    uint32_t rx_frames; /**< Valid frames received */
+    uint32_t rx_invalid; /**< Frames with bad header or size */
+    uint32_t rx_duplicates; /**< Repeated frames, ACK was lost */
+    uint32_t rx_lost; /**< Frames missing in sequence */
+    uint32_t rx_messages; /**< Messages delivered */
+    uint32_t rx_messages_dropped; /**< Messages with missing fragments */
+    uint32_t id_conflicts; /**< Frames from other node with our id, id is changed */
+    float rssi; /**< RSSI of last frame, dBm */
+    uint8_t lqi; /**< LQI of last frame */
+} SubGhzTxRxLinkStats;
+
+/** Allocate SubGhzTxRxLink
+ * Link splits messages to numbered frames and reassembles them on the other side.
+ * Time is passed by caller, so link has no dependency on radio or OS.
+ * Sequence is tracked for up to 4 senders, but only one message is reassembled at a time:
+ * fragments of messages from different senders must not interleave.
+ *
+ * @param id node id, used to address ACKs and to track sequence of each sender.
+ * Changed by link if frame from other node with the same id is received.
+ * @return SubGhzTxRxLink*
+ */
+SubGhzTxRxLink* subghz_tx_rx_link_alloc(uint8_t id);
+
+/** Free SubGhzTxRxLink
+ *
+ * @param instance SubGhzTxRxLink instance
+ */
+void subghz_tx_rx_link_free(SubGhzTxRxLink* instance);
+
+/** Reset link state and stats
+ *
+ * @param instance SubGhzTxRxLink instance
+ */
+void subghz_tx_rx_link_reset(SubGhzTxRxLink* instance);
+
+/** Enable ACK and retransmission of each frame
+ * Sender waits for ACK before next frame and repeats frame after timeout.
+ * Should be used for point to point link only.
+ *
+ * @param instance SubGhzTxRxLink instance
+ * @param retries retries count, 0 to disable ACK
+ * @param timeout ACK timeout per frame, ms
+ */
+void subghz_tx_rx_link_set_ack(SubGhzTxRxLink* instance, uint8_t retries, uint32_t timeout);
+
+/** Set callback for received messages
+ *
+ * @param instance SubGhzTxRxLink instance
+ * @param callback SubGhzTxRxLinkCallback callback
+ * @param context callback context
+ */
+void subghz_tx_rx_link_set_callback(
+    SubGhzTxRxLink* instance,
+    SubGhzTxRxLinkCallback callback,
+    void* context);
+
+/** Check if link can take new message
+ *
+ * @param instance SubGhzTxRxLink instance
+ * @return true if previous message is sent or dropped
+ */
+bool subghz_tx_rx_link_is_tx_idle(SubGhzTxRxLink* instance);
+
+/** Queue message for transmission
+ *
+ * @param instance SubGhzTxRxLink instance
+ * @param data message data
+ * @param size message size, no more than SUBGHZ_TXRX_LINK_MESSAGE_MAX
+ * @return true if queued
+ */
+bool subghz_tx_rx_link_send(SubGhzTxRxLink* instance, const uint8_t* data, size_t size);
+
+/** Get next frame to transmit
+ * ACKs go first, then retries, then new fragments.
+ *
+ * @param instance SubGhzTxRxLink instance
+ * @param frame buffer of SUBGHZ_TXRX_LINK_FRAME_MAX bytes
+ * @param size frame size
+ * @param now current time, ms
+ * @return true if there is frame to transmit
+ */
+bool subghz_tx_rx_link_get_frame(
+    SubGhzTxRxLink* instance,
+    uint8_t* frame,
+    size_t* size,
+    uint32_t now);
+
+/** Put received frame, callback is called when message is complete
+ *
+ * @param instance SubGhzTxRxLink instance
+ * @param frame frame data
+ * @param size frame size
+ * @param rssi frame RSSI, dBm
+ * @param lqi frame LQI
+ * @param now current time, ms
+ */
+void subghz_tx_rx_link_put_frame(
+    SubGhzTxRxLink* instance,
+    const uint8_t* frame,
+    size_t size,
+    float rssi,
+    uint8_t lqi,
+    uint32_t now);
+
+/** Get link statistics
+ *
+ * @param instance SubGhzTxRxLink instance
+ * @param stats SubGhzTxRxLinkStats to fill
+ */
+void subghz_tx_rx_link_get_stats(SubGhzTxRxLink* instance, SubGhzTxRxLinkStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,18 +1,40 @@
 #include "subghz_tx_rx_worker.h"
 
+#include <cc1101_regs.h>
 #include <stream_buffer.h>
 #include <furi.h>
 
 #define TAG "SubGhzTxRxWorker"
 
 #define SUBGHZ_TXRX_WORKER_BUF_SIZE 2048
-//you can not set more than 62 because it will not fit into the FIFO CC1101
-#define SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE 60
-
 #define SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF 40
 
+// CC1101 FIFO size, preset thresholds are 33 bytes for TX and 32 bytes for RX
+#define SUBGHZ_TXRX_WORKER_FIFO_SIZE 64
+// Max bytes in one SPI FIFO transaction
+#define SUBGHZ_TXRX_WORKER_FIFO_CHUNK 62
+// Air time of one byte at 9.99Kbps, rounded up, ms
+#define SUBGHZ_TXRX_WORKER_BYTE_TIME 1
+// Preamble and sync word air time with margin, ms
+#define SUBGHZ_TXRX_WORKER_SYNC_TIME 20
+// Max sleep without events, ACK timeouts are checked with this period
+#define SUBGHZ_TXRX_WORKER_EVENT_TIMEOUT 10
+
+#define SUBGHZ_TXRX_WORKER_ACK_RETRIES 3
+#define SUBGHZ_TXRX_WORKER_ACK_TIMEOUT \
+    (SUBGHZ_TXRX_LINK_FRAME_MAX * SUBGHZ_TXRX_WORKER_BYTE_TIME + 80)
+
+// Received packet is followed by RSSI and LQI/CRC status bytes
+#define SUBGHZ_TXRX_WORKER_RX_STATUS_SIZE 2
+
+typedef enum {
+    SubGhzTxRxWorkerEvtGdo0 = (1 << 0),
+    SubGhzTxRxWorkerEvtTx = (1 << 1),
+} SubGhzTxRxWorkerEvt;
+
 struct SubGhzTxRxWorker {
     FuriThread* thread;
+    osThreadId_t thread_id;
     StreamBufferHandle_t stream_tx;
     StreamBufferHandle_t stream_rx;
 
@@ -22,6 +44,16 @@ struct SubGhzTxRxWorker {
     SubGhzTxRxWorkerStatus status;
 
     uint32_t frequency;
+    bool ack;
+
+    SubGhzTxRxLink* link;
+    uint8_t message[SUBGHZ_TXRX_LINK_MESSAGE_MAX];
+    uint8_t tx_frame[SUBGHZ_TXRX_LINK_FRAME_MAX];
+    uint8_t rx_frame[SUBGHZ_TXRX_LINK_FRAME_MAX + SUBGHZ_TXRX_WORKER_RX_STATUS_SIZE];
+    size_t rx_size;
+    size_t rx_received;
+
+    SubGhzTxRxWorkerStats stats;
 
     SubGhzTxRxWorkerCallbackHaveRead callback_have_read;
     void* context_have_read;
@@ -38,6 +70,9 @@ bool subghz_tx_rx_worker_write(SubGhzTxRxWorker* instance, uint8_t* data, size_t
             ret = true;
         }
     }
+    if(ret && instance->worker_running) {
+        osThreadFlagsSet(furi_thread_get_thread_id(instance->thread), SubGhzTxRxWorkerEvtTx);
+    }
     return ret;
 }
 
@@ -62,135 +97,259 @@ void subghz_tx_rx_worker_set_callback_have_read(
     instance->context_have_read = context;
 }
 
-bool subghz_tx_rx_worker_rx(SubGhzTxRxWorker* instance, uint8_t* data, uint8_t* size) {
-    uint8_t timeout = 100;
-    bool ret = false;
-    if(instance->status != SubGhzTxRxWorkerStatusRx) {
-        furi_hal_subghz_rx();
-        instance->status = SubGhzTxRxWorkerStatusRx;
-        osDelay(1);
+void subghz_tx_rx_worker_set_ack(SubGhzTxRxWorker* instance, bool enable) {
+    furi_assert(instance);
+    furi_assert(!instance->worker_running);
+    instance->ack = enable;
+}
+
+void subghz_tx_rx_worker_get_stats(SubGhzTxRxWorker* instance, SubGhzTxRxWorkerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    *stats = instance->stats;
+    subghz_tx_rx_link_get_stats(instance->link, &stats->link);
+}
+
+static void subghz_tx_rx_worker_gdo0_isr(void* context) {
+    SubGhzTxRxWorker* instance = context;
+    osThreadFlagsSet(instance->thread_id, SubGhzTxRxWorkerEvtGdo0);
+}
+
+/** Wait for GDO0 level, woken up by GDO0 edge interrupt
+ *
+ * @param level expected level
+ * @param timeout ms
+ * @return true if level is reached
+ */
+static bool subghz_tx_rx_worker_wait_gdo0(bool level, uint32_t timeout) {
+    uint32_t start = osKernelGetTickCount();
+    while(hal_gpio_read(&gpio_cc1101_g0) != level) {
+        uint32_t elapsed = osKernelGetTickCount() - start;
+        if(elapsed >= timeout) return false;
+        osThreadFlagsWait(SubGhzTxRxWorkerEvtGdo0, osFlagsWaitAny, timeout - elapsed);
     }
-    //waiting for reception to complete
-    while(hal_gpio_read(&gpio_cc1101_g0)) {
-        osDelay(1);
-        if(!--timeout) {
-            FURI_LOG_W(TAG, "RX cc1101_g0 timeout");
-            furi_hal_subghz_flush_rx();
-            furi_hal_subghz_rx();
-            break;
-        }
+    return true;
+}
+
+static void subghz_tx_rx_worker_rx_start(SubGhzTxRxWorker* instance) {
+    // GDO0 is set when RX FIFO is above threshold or packet is received
+    furi_hal_subghz_idle();
+    furi_hal_subghz_set_gdo0(CC1101IocfgRxFifoThresholdOrPacket);
+    furi_hal_subghz_flush_rx();
+    furi_hal_subghz_rx();
+    instance->status = SubGhzTxRxWorkerStatusRx;
+    instance->rx_size = 0;
+    instance->rx_received = 0;
+}
+
+static void subghz_tx_rx_worker_rx_packet(SubGhzTxRxWorker* instance) {
+    size_t size = instance->rx_size - SUBGHZ_TXRX_WORKER_RX_STATUS_SIZE;
+    uint8_t rssi_dec = instance->rx_frame[size];
+    uint8_t lqi = instance->rx_frame[size + 1];
+
+    if(!(lqi & 0x80)) {
+        instance->stats.rx_crc_errors++;
+        return;
     }
 
-    if(furi_hal_subghz_rx_pipe_not_empty()) {
-        FURI_LOG_I(
-            TAG, "RSSI: %03.1fdbm LQI: %d", furi_hal_subghz_get_rssi(), furi_hal_subghz_get_lqi());
-        if(furi_hal_subghz_is_rx_data_crc_valid()) {
-            furi_hal_subghz_read_packet(data, size);
-            ret = true;
-        }
-        furi_hal_subghz_flush_rx();
-        furi_hal_subghz_rx();
+    float rssi = rssi_dec;
+    if(rssi_dec >= 128) {
+        rssi = ((rssi - 256.0f) / 2.0f) - 74.0f;
+    } else {
+        rssi = (rssi / 2.0f) - 74.0f;
     }
-    return ret;
+    subghz_tx_rx_link_put_frame(
+        instance->link, instance->rx_frame, size, rssi, lqi & 0x7F, osKernelGetTickCount());
 }
 
-void subghz_tx_rx_worker_tx(SubGhzTxRxWorker* instance, uint8_t* data, size_t size) {
-    uint8_t timeout = 200;
-    if(instance->status != SubGhzTxRxWorkerStatusIDLE) {
-        furi_hal_subghz_idle();
+/** Read RX FIFO, packet may take several reads if it's longer than FIFO
+ *
+ * @param instance SubGhzTxRxWorker instance
+ */
+static void subghz_tx_rx_worker_rx_drain(SubGhzTxRxWorker* instance) {
+    bool overflow = false;
+    uint8_t bytes = furi_hal_subghz_get_rx_bytes(&overflow);
+    if(overflow) {
+        FURI_LOG_W(TAG, "RX FIFO overflow");
+        instance->stats.rx_fifo_overflows++;
+        subghz_tx_rx_worker_rx_start(instance);
+        return;
     }
-    furi_hal_subghz_write_packet(data, size);
-    furi_hal_subghz_tx(); //start send
-    instance->status = SubGhzTxRxWorkerStatusTx;
-    while(!hal_gpio_read(&gpio_cc1101_g0)) { // Wait for GDO0 to be set -> sync transmitted
-        osDelay(1);
-        if(!--timeout) {
-            FURI_LOG_W(TAG, "TX !cc1101_g0 timeout");
-            break;
+
+    if(bytes && !instance->rx_size) {
+        uint8_t size = 0;
+        furi_hal_subghz_read_fifo(&size, 1);
+        bytes--;
+        if(!size || size > SUBGHZ_TXRX_LINK_FRAME_MAX) {
+            instance->stats.rx_crc_errors++;
+            subghz_tx_rx_worker_rx_start(instance);
+            return;
         }
+        instance->rx_size = size + SUBGHZ_TXRX_WORKER_RX_STATUS_SIZE;
+    }
+
+    size_t left = instance->rx_size - instance->rx_received;
+    size_t chunk = MIN((size_t)bytes, left);
+    // Last byte in FIFO must not be read until end of packet
+    if(chunk < left && chunk) chunk--;
+    if(chunk) {
+        furi_hal_subghz_read_fifo(&instance->rx_frame[instance->rx_received], chunk);
+        instance->rx_received += chunk;
+    }
+
+    if(instance->rx_size && (instance->rx_received == instance->rx_size)) {
+        subghz_tx_rx_worker_rx_packet(instance);
+        // Radio is in IDLE after packet
+        subghz_tx_rx_worker_rx_start(instance);
     }
-    while(hal_gpio_read(&gpio_cc1101_g0)) { // Wait for GDO0 to be cleared -> end of packet
-        osDelay(1);
-        if(!--timeout) {
-            FURI_LOG_W(TAG, "TX cc1101_g0 timeout");
-            break;
+}
+
+/** Transmit packet, FIFO is refilled while packet is sent
+ *
+ * @param instance SubGhzTxRxWorker instance
+ * @param data packet data
+ * @param size packet size
+ * @return true if packet is sent
+ */
+static bool subghz_tx_rx_worker_tx(SubGhzTxRxWorker* instance, uint8_t* data, size_t size) {
+    uint8_t head[SUBGHZ_TXRX_WORKER_FIFO_CHUNK];
+    size_t sent = MIN(size, (size_t)SUBGHZ_TXRX_WORKER_FIFO_CHUNK - 1);
+    bool is_long = (sent < size);
+
+    furi_hal_subghz_idle();
+    furi_hal_subghz_flush_tx();
+    // Long packet: GDO0 is cleared when TX FIFO goes below threshold
+    // Short packet: GDO0 is set when sync word is sent and cleared at the end of packet
+    furi_hal_subghz_set_gdo0(is_long ? CC1101IocfgTxFifoThreshold : CC1101IocfgSyncWord);
+    head[0] = size;
+    memcpy(&head[1], data, sent);
+    furi_hal_subghz_write_fifo(head, sent + 1);
+
+    osThreadFlagsClear(SubGhzTxRxWorkerEvtGdo0);
+    bool ret = furi_hal_subghz_tx();
+    instance->status = SubGhzTxRxWorkerStatusTx;
+
+    if(ret && is_long) {
+        while(sent < size) {
+            osThreadFlagsWait(
+                SubGhzTxRxWorkerEvtGdo0,
+                osFlagsWaitAny,
+                SUBGHZ_TXRX_WORKER_SYNC_TIME +
+                    SUBGHZ_TXRX_WORKER_FIFO_SIZE * SUBGHZ_TXRX_WORKER_BYTE_TIME);
+            bool underflow = false;
+            uint8_t bytes = furi_hal_subghz_get_tx_bytes(&underflow);
+            if(underflow) {
+                FURI_LOG_W(TAG, "TX FIFO underflow");
+                instance->stats.tx_fifo_underflows++;
+                ret = false;
+                break;
+            }
+            size_t chunk = MIN((size_t)(SUBGHZ_TXRX_WORKER_FIFO_SIZE - bytes), size - sent);
+            chunk = MIN(chunk, (size_t)SUBGHZ_TXRX_WORKER_FIFO_CHUNK);
+            if(chunk) {
+                furi_hal_subghz_write_fifo(&data[sent], chunk);
+                sent += chunk;
+            }
         }
+        // At least threshold bytes are still in FIFO, so sync word is already sent
+        furi_hal_subghz_set_gdo0(CC1101IocfgSyncWord);
+    } else if(ret) {
+        ret = subghz_tx_rx_worker_wait_gdo0(true, SUBGHZ_TXRX_WORKER_SYNC_TIME);
+    }
+
+    if(ret) {
+        uint32_t timeout = SUBGHZ_TXRX_WORKER_FIFO_SIZE * SUBGHZ_TXRX_WORKER_BYTE_TIME;
+        ret = subghz_tx_rx_worker_wait_gdo0(false, timeout);
+    }
+    if(!ret) {
+        FURI_LOG_W(TAG, "TX timeout");
+        instance->stats.tx_timeouts++;
     }
+
     furi_hal_subghz_idle();
     instance->status = SubGhzTxRxWorkerStatusIDLE;
+    return ret;
+}
+
+static void subghz_tx_rx_worker_link_callback(const uint8_t* data, size_t size, void* context) {
+    SubGhzTxRxWorker* instance = context;
+    if(xStreamBufferSpacesAvailable(instance->stream_rx) < size) {
+        instance->stats.rx_buffer_overflows++;
+        return;
+    }
+
+    bool callback_rx = (instance->callback_have_read &&
+                        xStreamBufferBytesAvailable(instance->stream_rx) == 0);
+    xStreamBufferSend(instance->stream_rx, data, size, SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
+    if(callback_rx) {
+        instance->callback_have_read(instance->context_have_read);
+    }
 }
+
 /** Worker thread
- * 
- * @param context 
- * @return exit code 
+ *
+ * @param context
+ * @return exit code
  */
 static int32_t subghz_tx_rx_worker_thread(void* context) {
     SubGhzTxRxWorker* instance = context;
     FURI_LOG_I(TAG, "Worker start");
 
+    instance->thread_id = osThreadGetId();
+    subghz_tx_rx_link_reset(instance->link);
+    subghz_tx_rx_link_set_ack(
+        instance->link,
+        instance->ack ? SUBGHZ_TXRX_WORKER_ACK_RETRIES : 0,
+        SUBGHZ_TXRX_WORKER_ACK_TIMEOUT);
+    memset(&instance->stats, 0, sizeof(SubGhzTxRxWorkerStats));
+
     furi_hal_subghz_reset();
     furi_hal_subghz_idle();
     furi_hal_subghz_load_preset(FuriHalSubGhzPresetGFSK9_99KbAsync);
     //furi_hal_subghz_load_preset(FuriHalSubGhzPresetMSK99_97KbAsync);
-    hal_gpio_init(&gpio_cc1101_g0, GpioModeInput, GpioPullNo, GpioSpeedLow);
+    hal_gpio_init(&gpio_cc1101_g0, GpioModeInterruptRiseFall, GpioPullNo, GpioSpeedLow);
+    hal_gpio_add_int_callback(&gpio_cc1101_g0, subghz_tx_rx_worker_gdo0_isr, instance);
 
     furi_hal_subghz_set_frequency_and_path(instance->frequency);
-    furi_hal_subghz_flush_rx();
-
-    uint8_t data[SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE + 1] = {0};
-    size_t size_tx = 0;
-    uint8_t size_rx[1] = {0};
-    uint8_t timeout_tx = 0;
-    bool callback_rx = false;
+    subghz_tx_rx_worker_rx_start(instance);
 
+    size_t size = 0;
     while(instance->worker_running) {
-        //transmit
-        size_tx = xStreamBufferBytesAvailable(instance->stream_tx);
-        if(size_tx > 0 && !timeout_tx) {
-            timeout_tx = 10; //20ms
-            if(size_tx > SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE) {
-                xStreamBufferReceive(
-                    instance->stream_tx,
-                    &data,
-                    SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE,
-                    SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
-                subghz_tx_rx_worker_tx(instance, data, SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE);
-            } else {
-                //todo checking that he managed to write all the data to the TX buffer
-                xStreamBufferReceive(
-                    instance->stream_tx, &data, size_tx, SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
-                subghz_tx_rx_worker_tx(instance, data, size_tx);
-            }
-        } else {
-            //recive
-            if(subghz_tx_rx_worker_rx(instance, data, size_rx)) {
-                if(xStreamBufferSpacesAvailable(instance->stream_rx) >= size_rx[0]) {
-                    if(instance->callback_have_read &&
-                       xStreamBufferBytesAvailable(instance->stream_rx) == 0) {
-                        callback_rx = true;
-                    }
-                    //todo checking that he managed to write all the data to the RX buffer
-                    xStreamBufferSend(
-                        instance->stream_rx,
-                        &data,
-                        size_rx[0],
-                        SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
-                    if(callback_rx) {
-                        instance->callback_have_read(instance->context_have_read);
-                        callback_rx = false;
-                    }
-                } else {
-                    //todo RX buffer overflow
-                }
-            }
+        // Take next message
+        if(subghz_tx_rx_link_is_tx_idle(instance->link)) {
+            size = xStreamBufferReceive(
+                instance->stream_tx, instance->message, SUBGHZ_TXRX_LINK_MESSAGE_MAX, 0);
+            if(size) subghz_tx_rx_link_send(instance->link, instance->message, size);
+        }
+
+        // Half duplex: don't interrupt packet being received
+        if(!instance->rx_size &&
+           subghz_tx_rx_link_get_frame(
+               instance->link, instance->tx_frame, &size, osKernelGetTickCount())) {
+            subghz_tx_rx_worker_tx(instance, instance->tx_frame, size);
+            subghz_tx_rx_worker_rx_start(instance);
+            continue;
+        }
+
+        // Sleep until GDO0 edge, new data or end of long packet
+        uint32_t timeout = SUBGHZ_TXRX_WORKER_EVENT_TIMEOUT;
+        if(instance->rx_size) {
+            timeout = (instance->rx_size - instance->rx_received) * SUBGHZ_TXRX_WORKER_BYTE_TIME;
+            timeout = CLAMP(timeout, (uint32_t)SUBGHZ_TXRX_WORKER_EVENT_TIMEOUT, 1UL);
         }
+        osThreadFlagsWait(
+            SubGhzTxRxWorkerEvtGdo0 | SubGhzTxRxWorkerEvtTx, osFlagsWaitAny, timeout);
 
-        if(timeout_tx) timeout_tx--;
-        osDelay(1);
+        // GDO0 stays set while RX FIFO is not empty
+        if(instance->rx_size || hal_gpio_read(&gpio_cc1101_g0)) {
+            subghz_tx_rx_worker_rx_drain(instance);
+        }
     }
 
+    hal_gpio_remove_int_callback(&gpio_cc1101_g0);
     furi_hal_subghz_set_path(FuriHalSubGhzPathIsolate);
     furi_hal_subghz_sleep();
+    instance->status = SubGhzTxRxWorkerStatusIDLE;
 
     FURI_LOG_I(TAG, "Worker stop");
     return 0;
@@ -209,8 +368,13 @@ SubGhzTxRxWorker* subghz_tx_rx_worker_alloc() {
     instance->stream_rx =
         xStreamBufferCreate(sizeof(uint8_t) * SUBGHZ_TXRX_WORKER_BUF_SIZE, sizeof(uint8_t));
 
+    instance->link = subghz_tx_rx_link_alloc(furi_hal_random_get() & 0xFF);
+    subghz_tx_rx_link_set_callback(instance->link, subghz_tx_rx_worker_link_callback, instance);
+
     instance->status = SubGhzTxRxWorkerStatusIDLE;
     instance->worker_stoping = true;
+    instance->ack = false;
+    memset(&instance->stats, 0, sizeof(SubGhzTxRxWorkerStats));
 
     return instance;
 }
@@ -220,6 +384,7 @@ void subghz_tx_rx_worker_free(SubGhzTxRxWorker* instance) {
     furi_assert(!instance->worker_running);
     vStreamBufferDelete(instance->stream_tx);
     vStreamBufferDelete(instance->stream_rx);
+    subghz_tx_rx_link_free(instance->link);
     furi_thread_free(instance->thread);
 
     free(instance);
@@ -249,6 +414,7 @@ void subghz_tx_rx_worker_stop(SubGhzTxRxWorker* instance) {
     furi_assert(instance->worker_running);
 
     instance->worker_running = false;
+    osThreadFlagsSet(furi_thread_get_thread_id(instance->thread), SubGhzTxRxWorkerEvtTx);
 
     furi_thread_join(instance->thread);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <furi_hal.h>
+#include "subghz_tx_rx_link.h"
 
 typedef void (*SubGhzTxRxWorkerCallbackHaveRead)(void* context);
 
@@ -12,7 +13,18 @@ typedef enum {
     SubGhzTxRxWorkerStatusRx,
 } SubGhzTxRxWorkerStatus;
 
+typedef struct {
+    SubGhzTxRxLinkStats link; /**< Framing, loss and signal stats */
+    uint32_t rx_crc_errors; /**< Packets with bad CRC */
+    uint32_t rx_fifo_overflows; /**< Packets lost because RX FIFO was not drained in time */
+    uint32_t rx_buffer_overflows; /**< Messages lost because nobody reads them */
+    uint32_t tx_fifo_underflows; /**< Packets broken because TX FIFO was not refilled in time */
+    uint32_t tx_timeouts; /**< Packets without end of transmission */
+} SubGhzTxRxWorkerStats;
+
 /** SubGhzTxRxWorker, add data to transfer
+ * Data is sent in messages of up to SUBGHZ_TXRX_LINK_MESSAGE_MAX bytes,
+ * message is split to radio packets of up to SUBGHZ_TXRX_LINK_FRAME_MAX bytes
  * 
  * @param instance  SubGhzTxRxWorker instance
  * @param data      *data
@@ -48,6 +60,21 @@ void subghz_tx_rx_worker_set_callback_have_read(
     SubGhzTxRxWorkerCallbackHaveRead callback,
     void* context);
 
+/** Enable ACK and retransmission, must be set before start
+ * Use for point to point link only, broadcast messages are never acknowledged.
+ * 
+ * @param instance SubGhzTxRxWorker instance
+ * @param enable true to enable
+ */
+void subghz_tx_rx_worker_set_ack(SubGhzTxRxWorker* instance, bool enable);
+
+/** Get link statistics
+ * 
+ * @param instance SubGhzTxRxWorker instance
+ * @param stats SubGhzTxRxWorkerStats to fill
+ */
+void subghz_tx_rx_worker_get_stats(SubGhzTxRxWorker* instance, SubGhzTxRxWorkerStats* stats);
+
 /** Allocate SubGhzTxRxWorker
  * 
  * @return SubGhzTxRxWorker* 
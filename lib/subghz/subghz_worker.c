@@ -38,7 +38,10 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
     }
     size_t ret = xStreamBufferSendFromISR(
         instance->stream, &level_duration, sizeof(LevelDuration), &xHigherPriorityTaskWoken);
-    if(sizeof(LevelDuration) != ret) instance->overrun = true;
+    if(sizeof(LevelDuration) != ret) {
+        instance->overrun = true;
+        FURI_TRACE_INSTANT("subghz rx overrun", duration);
+    }
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
@@ -62,6 +65,7 @@ static int32_t subghz_worker_thread_callback(void* context) {
             } else {
                 bool level = level_duration_get_level(level_duration);
                 uint32_t duration = level_duration_get_duration(level_duration);
+                FURI_TRACE_BEGIN("subghz pair", duration);
 
                 if(instance->filter_running) {
                     if((duration < instance->filter_duration) ||
@@ -82,6 +86,7 @@ static int32_t subghz_worker_thread_callback(void* context) {
                     if(instance->pair_callback)
                         instance->pair_callback(instance->context, level, duration);
                 }
+                FURI_TRACE_END("subghz pair", duration);
             }
         }
     }
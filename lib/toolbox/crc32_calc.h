@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Calculate CRC32 (IEEE 802.3, as in zlib and PNG)
+ *
+ * Can be calculated in chunks: pass result of previous call as crc.
+ *
+ * @param crc initial value, 0 for first chunk
+ * @param buffer data
+ * @param size data size
+ * @return CRC32 value
+ */
+uint32_t crc32_calc_buffer(uint32_t crc, const void* buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,160 @@
+#include "hash.h"
+#include "md5.h"
+#include "sha1.h"
+#include "sha256.h"
+#include "crc32_calc.h"
+#include <furi.h>
+#include <furi_hal_crc.h>
+
+/** Shorter updates don't pay for taking CRC unit */
+#define HASH_CRC32_UNIT_SIZE_MIN (64)
+
+struct Hash {
+    HashType type;
+    union {
+        md5_context md5;
+        sha1_context sha1;
+        sha256_context sha256;
+        uint32_t crc32;
+    };
+};
+
+static const struct {
+    const char* name;
+    size_t size;
+} hash_types[HashTypeCount] = {
+    [HashTypeMd5] = {.name = "md5", .size = 16},
+    [HashTypeSha1] = {.name = "sha1", .size = SHA1_DIGEST_SIZE},
+    [HashTypeSha256] = {.name = "sha256", .size = SHA256_DIGEST_SIZE},
+    [HashTypeCrc32] = {.name = "crc32", .size = 4},
+};
+
+Hash* hash_alloc(HashType type) {
+    furi_assert(type < HashTypeCount);
+    Hash* hash = malloc(sizeof(Hash));
+    hash->type = type;
+    hash_reset(hash);
+    return hash;
+}
+
+void hash_free(Hash* hash) {
+    furi_assert(hash);
+    free(hash);
+}
+
+void hash_reset(Hash* hash) {
+    furi_assert(hash);
+    switch(hash->type) {
+    case HashTypeMd5:
+        md5_starts(&hash->md5);
+        break;
+    case HashTypeSha1:
+        sha1_starts(&hash->sha1);
+        break;
+    case HashTypeSha256:
+        sha256_start(&hash->sha256);
+        break;
+    case HashTypeCrc32:
+        hash->crc32 = 0;
+        break;
+    default:
+        furi_crash(NULL);
+    }
+}
+
+void hash_update(Hash* hash, const void* data, size_t size) {
+    furi_assert(hash);
+    switch(hash->type) {
+    case HashTypeMd5:
+        md5_update(&hash->md5, data, size);
+        break;
+    case HashTypeSha1:
+        sha1_update(&hash->sha1, data, size);
+        break;
+    case HashTypeSha256:
+        sha256_update(&hash->sha256, data, size);
+        break;
+    case HashTypeCrc32:
+        if(size >= HASH_CRC32_UNIT_SIZE_MIN) {
+            hash->crc32 = furi_hal_crc32(hash->crc32, data, size);
+        } else {
+            hash->crc32 = crc32_calc_buffer(hash->crc32, data, size);
+        }
+        break;
+    default:
+        furi_crash(NULL);
+    }
+}
+
+bool hash_update_file(Hash* hash, File* file) {
+    furi_assert(hash);
+    furi_assert(file);
+    uint8_t* block = malloc(HASH_FILE_BLOCK_SIZE);
+
+    while(true) {
+        uint16_t read = storage_file_read(file, block, HASH_FILE_BLOCK_SIZE);
+        if(read == 0) break;
+        hash_update(hash, block, read);
+    }
+
+    free(block);
+    return storage_file_get_error(file) == FSE_OK;
+}
+
+size_t hash_finish(Hash* hash, uint8_t* digest) {
+    furi_assert(hash);
+    furi_assert(digest);
+    switch(hash->type) {
+    case HashTypeMd5:
+        md5_finish(&hash->md5, digest);
+        break;
+    case HashTypeSha1:
+        sha1_finish(&hash->sha1, digest);
+        break;
+    case HashTypeSha256:
+        sha256_finish(&hash->sha256, digest);
+        break;
+    case HashTypeCrc32:
+        digest[0] = hash->crc32 >> 24;
+        digest[1] = hash->crc32 >> 16;
+        digest[2] = hash->crc32 >> 8;
+        digest[3] = hash->crc32;
+        break;
+    default:
+        furi_crash(NULL);
+    }
+    return hash_types[hash->type].size;
+}
+
+size_t hash_get_size(HashType type) {
+    furi_assert(type < HashTypeCount);
+    return hash_types[type].size;
+}
+
+const char* hash_get_name(HashType type) {
+    furi_assert(type < HashTypeCount);
+    return hash_types[type].name;
+}
+
+bool hash_get_type(const char* name, HashType* type) {
+    furi_assert(name);
+    furi_assert(type);
+    for(size_t i = 0; i < HashTypeCount; i++) {
+        if(strcmp(name, hash_types[i].name) == 0) {
+            *type = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void hash_digest_to_string(const uint8_t* digest, size_t size, char* string) {
+    furi_assert(digest);
+    furi_assert(string);
+    static const char hex[] = "0123456789abcdef";
+    for(size_t i = 0; i < size; i++) {
+        *string++ = hex[digest[i] >> 4];
+        *string++ = hex[digest[i] & 0xF];
+    }
+    *string = '\0';
+}
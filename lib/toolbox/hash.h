@@ -0,0 +1,110 @@
+/**
+ * @file hash.h
+ * Streaming hash calculation: MD5, SHA-1, SHA-256 and CRC32.
+ *
+ * CRC32 goes to CRC unit on target, digests are calculated in software. Files are read in
+ * sector aligned blocks, so file system reads whole sectors straight into hash buffer.
+ */
+
+#pragma once
+
+#include <storage/storage.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest digest size */
+#define HASH_SIZE_MAX (32)
+/** File read block size, multiple of sector size */
+#define HASH_FILE_BLOCK_SIZE (4096)
+
+typedef enum {
+    HashTypeMd5,
+    HashTypeSha1,
+    HashTypeSha256,
+    HashTypeCrc32, /**< IEEE 802.3, digest is big endian as printed by crc32 tools */
+    HashTypeCount,
+} HashType;
+
+typedef struct Hash Hash;
+
+/** Allocate Hash, calculation is started
+ *
+ * @param type hash type
+ * @return Hash instance
+ */
+Hash* hash_alloc(HashType type);
+
+/** Free Hash
+ *
+ * @param hash Hash instance
+ */
+void hash_free(Hash* hash);
+
+/** Start new calculation
+ *
+ * @param hash Hash instance
+ */
+void hash_reset(Hash* hash);
+
+/** Process data
+ *
+ * @param hash Hash instance
+ * @param data data
+ * @param size data size
+ */
+void hash_update(Hash* hash, const void* data, size_t size);
+
+/** Process file from current position to the end
+ *
+ * @param hash Hash instance
+ * @param file opened file
+ * @return true if whole file was read, file error otherwise
+ */
+bool hash_update_file(Hash* hash, File* file);
+
+/** Finish calculation, hash must be reset before reuse
+ *
+ * @param hash Hash instance
+ * @param digest buffer, at least hash_get_size bytes
+ * @return digest size
+ */
+size_t hash_finish(Hash* hash, uint8_t* digest);
+
+/** Get digest size
+ *
+ * @param type hash type
+ * @return digest size, bytes
+ */
+size_t hash_get_size(HashType type);
+
+/** Get hash name
+ *
+ * @param type hash type
+ * @return name, as used in CLI
+ */
+const char* hash_get_name(HashType type);
+
+/** Find hash type by name
+ *
+ * @param name hash name
+ * @param type found type
+ * @return true if found
+ */
+bool hash_get_type(const char* name, HashType* type);
+
+/** Print digest as lowercase hex string
+ *
+ * @param digest digest
+ * @param size digest size
+ * @param string buffer, at least size * 2 + 1 bytes
+ */
+void hash_digest_to_string(const uint8_t* digest, size_t size, char* string);
+
+#ifdef __cplusplus
+}
+#endif
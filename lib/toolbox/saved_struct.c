@@ -2,8 +2,10 @@
 #include <furi.h>
 #include <stdint.h>
 #include <storage/storage.h>
+#include "settings_journal.h"
 
 #define TAG "SavedStruct"
+#define SAVED_STRUCT_JOURNAL_PATH "/int/.settings.journal"
 
 typedef struct {
     uint8_t magic;
@@ -13,56 +15,22 @@ typedef struct {
     uint32_t timestamp;
 } SavedStructHeader;
 
-bool saved_struct_save(const char* path, void* data, size_t size, uint8_t magic, uint8_t version) {
-    furi_assert(path);
-    furi_assert(data);
-    furi_assert(size);
-    SavedStructHeader header;
-
-    FURI_LOG_I(TAG, "Saving \"%s\"", path);
-
-    // Store
-    Storage* storage = furi_record_open("storage");
-    File* file = storage_file_alloc(storage);
-    bool result = true;
-    bool saved = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
-    if(!saved) {
-        FURI_LOG_E(
-            TAG, "Open failed \"%s\". Error: \'%s\'", path, storage_file_get_error_desc(file));
-        result = false;
+static uint8_t saved_struct_checksum(const void* data, size_t size) {
+    uint8_t checksum = 0;
+    const uint8_t* source = data;
+    for(size_t i = 0; i < size; i++) {
+        checksum += source[i];
     }
-
-    if(result) {
-        // Calculate checksum
-        uint8_t checksum = 0;
-        uint8_t* source = data;
-        for(size_t i = 0; i < size; i++) {
-            checksum += source[i];
-        }
-        // Set header
-        header.magic = magic;
-        header.version = version;
-        header.checksum = checksum;
-        header.flags = 0;
-        header.timestamp = 0;
-
-        uint16_t bytes_count = storage_file_write(file, &header, sizeof(header));
-        bytes_count += storage_file_write(file, data, size);
-
-        if(bytes_count != (size + sizeof(header))) {
-            FURI_LOG_E(
-                TAG, "Write failed \"%s\". Error: \'%s\'", path, storage_file_get_error_desc(file));
-            result = false;
-        }
-    }
-
-    storage_file_close(file);
-    storage_file_free(file);
-    furi_record_close("storage");
-    return result;
+    return checksum;
 }
 
-bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic, uint8_t version) {
+// Files written before settings journal
+static bool saved_struct_load_file(
+    const char* path,
+    void* data,
+    size_t size,
+    uint8_t magic,
+    uint8_t version) {
     FURI_LOG_I(TAG, "Loading \"%s\"", path);
 
     SavedStructHeader header;
@@ -101,12 +69,7 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
     }
 
     if(result) {
-        uint8_t checksum = 0;
-        const uint8_t* source = (const uint8_t*)data_read;
-        for(size_t i = 0; i < size; i++) {
-            checksum += source[i];
-        }
-
+        uint8_t checksum = saved_struct_checksum(data_read, size);
         if(header.checksum != checksum) {
             FURI_LOG_E(
                 TAG, "Checksum(%d != %d) mismatch of file \"%s\"", header.checksum, checksum, path);
@@ -125,3 +88,109 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
 
     return result;
 }
+
+// Shared by all saved structs, so they are stored in one file
+static SettingsJournal* saved_struct_get_journal() {
+    static SettingsJournal* journal = NULL;
+
+    SettingsJournal* current = __atomic_load_n(&journal, __ATOMIC_ACQUIRE);
+    if(!current) {
+        SettingsJournal* instance = settings_journal_alloc(SAVED_STRUCT_JOURNAL_PATH);
+        if(__atomic_compare_exchange_n(
+               &journal, &current, instance, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            current = instance;
+        } else {
+            settings_journal_free(instance);
+        }
+    }
+
+    return current;
+}
+
+bool saved_struct_save(const char* path, void* data, size_t size, uint8_t magic, uint8_t version) {
+    furi_assert(path);
+    furi_assert(data);
+    furi_assert(size);
+
+    FURI_LOG_I(TAG, "Saving \"%s\"", path);
+
+    // Value keeps the same layout as file, header is checked on load
+    uint8_t* value = malloc(sizeof(SavedStructHeader) + size);
+    SavedStructHeader header = {
+        .magic = magic,
+        .version = version,
+        .checksum = saved_struct_checksum(data, size),
+        .flags = 0,
+        .timestamp = 0,
+    };
+    memcpy(value, &header, sizeof(SavedStructHeader));
+    memcpy(&value[sizeof(SavedStructHeader)], data, size);
+
+    SettingsJournal* journal = saved_struct_get_journal();
+    bool migrate = (settings_journal_get_size(journal, path) == 0);
+    bool result = settings_journal_set(journal, path, value, sizeof(SavedStructHeader) + size) &&
+                  settings_journal_commit(journal);
+    free(value);
+
+    if(!result) {
+        FURI_LOG_E(TAG, "Save failed \"%s\"", path);
+    } else if(migrate) {
+        // File from previous firmware is not needed anymore
+        Storage* storage = furi_record_open("storage");
+        storage_common_remove(storage, path);
+        furi_record_close("storage");
+    }
+
+    return result;
+}
+
+bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic, uint8_t version) {
+    furi_assert(path);
+    furi_assert(data);
+    furi_assert(size);
+
+    SettingsJournal* journal = saved_struct_get_journal();
+    if(settings_journal_get_size(journal, path) == 0) {
+        return saved_struct_load_file(path, data, size, magic, version);
+    }
+
+    FURI_LOG_I(TAG, "Loading \"%s\"", path);
+
+    uint8_t* value = malloc(sizeof(SavedStructHeader) + size);
+    SavedStructHeader header;
+    bool result = settings_journal_get(journal, path, value, sizeof(SavedStructHeader) + size);
+    if(!result) {
+        FURI_LOG_E(TAG, "Size mismatch of \"%s\"", path);
+    }
+
+    if(result) {
+        memcpy(&header, value, sizeof(SavedStructHeader));
+        if(header.magic != magic || header.version != version) {
+            FURI_LOG_E(
+                TAG,
+                "Magic(%d != %d) or Version(%d != %d) mismatch of \"%s\"",
+                header.magic,
+                magic,
+                header.version,
+                version,
+                path);
+            result = false;
+        }
+    }
+
+    if(result) {
+        uint8_t checksum = saved_struct_checksum(&value[sizeof(SavedStructHeader)], size);
+        if(header.checksum != checksum) {
+            FURI_LOG_E(
+                TAG, "Checksum(%d != %d) mismatch of \"%s\"", header.checksum, checksum, path);
+            result = false;
+        }
+    }
+
+    if(result) {
+        memcpy(data, &value[sizeof(SavedStructHeader)], size);
+    }
+    free(value);
+
+    return result;
+}
@@ -0,0 +1,597 @@
+#include "settings_journal.h"
+#include "crc32_calc.h"
+#include <furi.h>
+#include <furi_hal_delay.h>
+#include <m-string.h>
+#include <storage/storage.h>
+
+#define TAG "SettingsJournal"
+
+#define SETTINGS_JOURNAL_MAGIC (0x4E524A53UL)
+#define SETTINGS_JOURNAL_VERSION (1)
+#define SETTINGS_JOURNAL_RECORD_MAGIC (0xA55A)
+// Last record of commit, records are applied only when it is read
+#define SETTINGS_JOURNAL_RECORD_FLAG_COMMIT (1 << 0)
+// Journal is compacted when it is larger than this and twice as large as its content
+#define SETTINGS_JOURNAL_COMPACT_SIZE (4096)
+#define SETTINGS_JOURNAL_WRITE_CHUNK (0x4000)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved[3];
+} SettingsJournalHeader;
+
+// Record is followed by key and value bytes [offset, offset + size)
+typedef struct {
+    uint16_t magic;
+    uint8_t flags;
+    uint8_t key_size;
+    uint16_t value_size;
+    uint16_t offset;
+    uint16_t size;
+    uint16_t reserved;
+    // Covers record fields above, key and value bytes
+    uint32_t crc;
+} SettingsJournalRecord;
+
+typedef struct {
+    char* key;
+    uint8_t* value;
+    size_t size;
+    // Changed bytes not committed yet
+    bool staged;
+    size_t staged_start;
+    size_t staged_end;
+} SettingsJournalEntry;
+
+struct SettingsJournal {
+    osMutexId_t mutex;
+    Storage* storage;
+    string_t path;
+    string_t path_tmp;
+    bool loaded;
+    // File doesn't match journal anymore, must be written again
+    bool broken;
+    SettingsJournalEntry* entries;
+    size_t entries_count;
+    // file_size is the end of the last complete commit
+    SettingsJournalStats stats;
+};
+
+SettingsJournal* settings_journal_alloc(const char* path) {
+    furi_assert(path);
+
+    SettingsJournal* journal = malloc(sizeof(SettingsJournal));
+    memset(journal, 0, sizeof(SettingsJournal));
+    journal->mutex = osMutexNew(NULL);
+    furi_check(journal->mutex);
+    journal->storage = furi_record_open("storage");
+    string_init_set_str(journal->path, path);
+    string_init_printf(journal->path_tmp, "%s.tmp", path);
+
+    return journal;
+}
+
+void settings_journal_free(SettingsJournal* journal) {
+    furi_assert(journal);
+
+    for(size_t i = 0; i < journal->entries_count; i++) {
+        free(journal->entries[i].key);
+        free(journal->entries[i].value);
+    }
+    free(journal->entries);
+    string_clear(journal->path_tmp);
+    string_clear(journal->path);
+    furi_record_close("storage");
+    furi_check(osMutexDelete(journal->mutex) == osOK);
+    free(journal);
+}
+
+static SettingsJournalEntry*
+    settings_journal_find(SettingsJournal* journal, const char* key, size_t key_size) {
+    for(size_t i = 0; i < journal->entries_count; i++) {
+        SettingsJournalEntry* entry = &journal->entries[i];
+        if((strlen(entry->key) == key_size) && (memcmp(entry->key, key, key_size) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static SettingsJournalEntry*
+    settings_journal_add(SettingsJournal* journal, const char* key, size_t key_size) {
+    journal->entries =
+        realloc(journal->entries, sizeof(SettingsJournalEntry) * (journal->entries_count + 1));
+    SettingsJournalEntry* entry = &journal->entries[journal->entries_count++];
+    memset(entry, 0, sizeof(SettingsJournalEntry));
+    entry->key = malloc(key_size + 1);
+    memcpy(entry->key, key, key_size);
+    entry->key[key_size] = '\0';
+    return entry;
+}
+
+static uint32_t settings_journal_record_crc(
+    const SettingsJournalRecord* record,
+    const uint8_t* payload,
+    size_t payload_size) {
+    uint32_t crc = crc32_calc_buffer(0, record, offsetof(SettingsJournalRecord, crc));
+    return crc32_calc_buffer(crc, payload, payload_size);
+}
+
+// Apply records of complete commit read from file
+static void
+    settings_journal_apply(SettingsJournal* journal, const uint8_t* batch, size_t batch_size) {
+    size_t position = 0;
+    while(position < batch_size) {
+        // Records are not aligned in batch
+        SettingsJournalRecord record;
+        memcpy(&record, &batch[position], sizeof(record));
+        const char* key = (const char*)&batch[position + sizeof(record)];
+        const uint8_t* data = (const uint8_t*)&key[record.key_size];
+        position += sizeof(record) + record.key_size + record.size;
+
+        SettingsJournalEntry* entry = settings_journal_find(journal, key, record.key_size);
+        if(!entry) entry = settings_journal_add(journal, key, record.key_size);
+        // Journal was reloaded after file appeared elsewhere: staged value is newer and
+        // replaces stored one as a whole
+        if(entry->staged) {
+            entry->staged_start = 0;
+            entry->staged_end = entry->size;
+            continue;
+        }
+        if(entry->size != record.value_size) {
+            // Changed bytes can't be applied to value of other size
+            if(record.size != record.value_size) {
+                FURI_LOG_W(TAG, "Orphan record for \"%s\"", entry->key);
+                continue;
+            }
+            free(entry->value);
+            entry->value = malloc(record.value_size);
+            entry->size = record.value_size;
+        }
+        memcpy(&entry->value[record.offset], data, record.size);
+    }
+}
+
+static void settings_journal_recover(SettingsJournal* journal) {
+    const char* path = string_get_cstr(journal->path);
+    const char* path_tmp = string_get_cstr(journal->path_tmp);
+
+    // Compaction was interrupted: new file is complete only if old one is already removed
+    if(storage_common_stat(journal->storage, path_tmp, NULL) == FSE_OK) {
+        if(storage_common_stat(journal->storage, path, NULL) == FSE_OK) {
+            storage_common_remove(journal->storage, path_tmp);
+        } else {
+            storage_common_rename(journal->storage, path_tmp, path);
+        }
+    }
+}
+
+// Keep unreadable journal for inspection, new one is started in its place
+static bool settings_journal_move_aside(SettingsJournal* journal) {
+    string_t path_bad;
+    string_init_printf(path_bad, "%s.bad", string_get_cstr(journal->path));
+    storage_common_remove(journal->storage, string_get_cstr(path_bad));
+    FS_Error error = storage_common_rename(
+        journal->storage, string_get_cstr(journal->path), string_get_cstr(path_bad));
+    FURI_LOG_E(
+        TAG,
+        "Bad journal \"%s\" moved to \"%s\": %s",
+        string_get_cstr(journal->path),
+        string_get_cstr(path_bad),
+        storage_error_get_desc(error));
+    string_clear(path_bad);
+    return error == FSE_OK;
+}
+
+// Journal is marked loaded only when its file is read or known to be absent
+static bool settings_journal_load(SettingsJournal* journal) {
+    if(journal->loaded) return true;
+
+    settings_journal_recover(journal);
+
+    FS_Error error = storage_common_stat(journal->storage, string_get_cstr(journal->path), NULL);
+    if(error == FSE_NOT_EXIST) {
+        journal->loaded = true;
+        journal->stats.file_size = 0;
+        return true;
+    } else if(error != FSE_OK) {
+        FURI_LOG_E(
+            TAG,
+            "Can't stat \"%s\": %s",
+            string_get_cstr(journal->path),
+            storage_error_get_desc(error));
+        return false;
+    }
+
+    File* file = storage_file_alloc(journal->storage);
+    bool opened =
+        storage_file_open(file, string_get_cstr(journal->path), FSAM_READ, FSOM_OPEN_EXISTING);
+    bool header_ok = false;
+    if(opened) {
+        SettingsJournalHeader header;
+        header_ok = (storage_file_read(file, &header, sizeof(header)) == sizeof(header)) &&
+                    (header.magic == SETTINGS_JOURNAL_MAGIC) &&
+                    (header.version == SETTINGS_JOURNAL_VERSION);
+    } else {
+        FURI_LOG_E(
+            TAG,
+            "Can't open \"%s\": %s",
+            string_get_cstr(journal->path),
+            storage_file_get_error_desc(file));
+    }
+
+    if(header_ok) {
+        uint32_t offset = sizeof(SettingsJournalHeader);
+        journal->stats.file_size = offset;
+        uint8_t* batch = NULL;
+        size_t batch_size = 0;
+
+        // Read up to the first broken record, tail after the last commit is dropped
+        while(true) {
+            SettingsJournalRecord record;
+            if(storage_file_read(file, &record, sizeof(record)) != sizeof(record)) break;
+            if((record.magic != SETTINGS_JOURNAL_RECORD_MAGIC) || (record.key_size == 0) ||
+               (record.value_size > SETTINGS_JOURNAL_VALUE_SIZE_MAX) ||
+               (record.offset + record.size > record.value_size)) {
+                break;
+            }
+
+            size_t payload_size = record.key_size + record.size;
+            batch = realloc(batch, batch_size + sizeof(record) + payload_size);
+            memcpy(&batch[batch_size], &record, sizeof(record));
+            uint8_t* payload = &batch[batch_size + sizeof(record)];
+            if(storage_file_read(file, payload, payload_size) != payload_size) break;
+            if(settings_journal_record_crc(&record, payload, payload_size) != record.crc) {
+                break;
+            }
+
+            batch_size += sizeof(record) + payload_size;
+            offset += sizeof(record) + payload_size;
+            if(record.flags & SETTINGS_JOURNAL_RECORD_FLAG_COMMIT) {
+                settings_journal_apply(journal, batch, batch_size);
+                batch_size = 0;
+                journal->stats.file_size = offset;
+            }
+        }
+
+        free(batch);
+        journal->loaded = true;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    // Opened file without valid header is not ours to append to
+    if(opened && !header_ok && settings_journal_move_aside(journal)) {
+        journal->loaded = true;
+        journal->stats.file_size = 0;
+    }
+
+    if(journal->loaded) {
+        FURI_LOG_I(
+            TAG,
+            "Loaded \"%s\": %u values, %lu bytes",
+            string_get_cstr(journal->path),
+            journal->entries_count,
+            journal->stats.file_size);
+    }
+
+    return journal->loaded;
+}
+
+static size_t settings_journal_record_put(
+    uint8_t* buffer,
+    SettingsJournalEntry* entry,
+    size_t offset,
+    size_t size,
+    uint8_t flags) {
+    SettingsJournalRecord record = {
+        .magic = SETTINGS_JOURNAL_RECORD_MAGIC,
+        .flags = flags,
+        .key_size = strlen(entry->key),
+        .value_size = entry->size,
+        .offset = offset,
+        .size = size,
+        .reserved = 0,
+    };
+    uint8_t* payload = &buffer[sizeof(record)];
+    memcpy(payload, entry->key, record.key_size);
+    memcpy(&payload[record.key_size], &entry->value[offset], size);
+    record.crc = settings_journal_record_crc(&record, payload, record.key_size + size);
+    memcpy(buffer, &record, sizeof(record));
+
+    return sizeof(record) + record.key_size + size;
+}
+
+static size_t settings_journal_header_put(uint8_t* buffer) {
+    SettingsJournalHeader header = {
+        .magic = SETTINGS_JOURNAL_MAGIC,
+        .version = SETTINGS_JOURNAL_VERSION,
+        .reserved = {0},
+    };
+    memcpy(buffer, &header, sizeof(header));
+    return sizeof(header);
+}
+
+static bool settings_journal_write(File* file, const uint8_t* buffer, size_t size) {
+    size_t position = 0;
+    while(position < size) {
+        uint16_t chunk = MIN(size - position, (size_t)SETTINGS_JOURNAL_WRITE_CHUNK);
+        if(storage_file_write(file, &buffer[position], chunk) != chunk) return false;
+        position += chunk;
+    }
+    return true;
+}
+
+// Append records after the last complete commit
+static bool settings_journal_append(SettingsJournal* journal, const uint8_t* buffer, size_t size) {
+    File* file = storage_file_alloc(journal->storage);
+    bool result = false;
+
+    do {
+        if(!storage_file_open(
+               file, string_get_cstr(journal->path), FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+            break;
+        }
+        uint64_t file_size = storage_file_size(file);
+        if(file_size < journal->stats.file_size) {
+            FURI_LOG_E(TAG, "Journal is shorter than expected");
+            journal->broken = true;
+            break;
+        }
+        if((journal->stats.file_size == 0) && (file_size > 0)) {
+            // File appeared after load: read it before writing
+            FURI_LOG_E(TAG, "Journal was created elsewhere");
+            journal->loaded = false;
+            break;
+        }
+        if(!storage_file_seek(file, journal->stats.file_size, true)) break;
+        // Incomplete commit left by power loss or failed write
+        if((file_size > journal->stats.file_size) && !storage_file_truncate(file)) break;
+        if(!settings_journal_write(file, buffer, size)) break;
+        result = true;
+    } while(0);
+
+    if(!result) {
+        FURI_LOG_E(
+            TAG,
+            "Append failed \"%s\". Error: \'%s\'",
+            string_get_cstr(journal->path),
+            storage_file_get_error_desc(file));
+    }
+    if(!storage_file_close(file)) result = false;
+    storage_file_free(file);
+
+    return result;
+}
+
+static size_t settings_journal_get_content_size(SettingsJournal* journal) {
+    size_t size = sizeof(SettingsJournalHeader);
+    for(size_t i = 0; i < journal->entries_count; i++) {
+        SettingsJournalEntry* entry = &journal->entries[i];
+        if(entry->size) {
+            size += sizeof(SettingsJournalRecord) + strlen(entry->key) + entry->size;
+        }
+    }
+    return size;
+}
+
+// Write all values to new file as one commit and replace journal with it
+static bool settings_journal_compact(SettingsJournal* journal) {
+    const char* path = string_get_cstr(journal->path);
+    const char* path_tmp = string_get_cstr(journal->path_tmp);
+
+    size_t size = settings_journal_get_content_size(journal);
+    uint8_t* buffer = malloc(size);
+    size_t position = settings_journal_header_put(buffer);
+    for(size_t i = 0; i < journal->entries_count; i++) {
+        SettingsJournalEntry* entry = &journal->entries[i];
+        if(!entry->size) continue;
+        uint8_t flags = 0;
+        if(position + sizeof(SettingsJournalRecord) + strlen(entry->key) + entry->size == size) {
+            flags = SETTINGS_JOURNAL_RECORD_FLAG_COMMIT;
+        }
+        position += settings_journal_record_put(&buffer[position], entry, 0, entry->size, flags);
+    }
+
+    File* file = storage_file_alloc(journal->storage);
+    bool result = storage_file_open(file, path_tmp, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                  settings_journal_write(file, buffer, size);
+    if(!storage_file_close(file)) result = false;
+    storage_file_free(file);
+    free(buffer);
+
+    if(result) {
+        FS_Error error = storage_common_rename(journal->storage, path_tmp, path);
+        if(error == FSE_EXIST) {
+            // Rename doesn't replace files on FAT, new file is picked up by recovery on load
+            storage_common_remove(journal->storage, path);
+            error = storage_common_rename(journal->storage, path_tmp, path);
+        }
+        result = (error == FSE_OK);
+    }
+
+    if(result) {
+        journal->broken = false;
+        journal->stats.file_size = size;
+        journal->stats.bytes_written += size;
+        journal->stats.compactions++;
+        for(size_t i = 0; i < journal->entries_count; i++) {
+            journal->entries[i].staged = false;
+        }
+    } else {
+        FURI_LOG_E(TAG, "Compaction failed \"%s\"", path);
+        storage_common_remove(journal->storage, path_tmp);
+    }
+
+    return result;
+}
+
+size_t settings_journal_get_size(SettingsJournal* journal, const char* key) {
+    furi_assert(journal);
+    furi_assert(key);
+
+    furi_check(osMutexAcquire(journal->mutex, osWaitForever) == osOK);
+    settings_journal_load(journal);
+    SettingsJournalEntry* entry = settings_journal_find(journal, key, strlen(key));
+    size_t size = entry ? entry->size : 0;
+    furi_check(osMutexRelease(journal->mutex) == osOK);
+
+    return size;
+}
+
+bool settings_journal_get(SettingsJournal* journal, const char* key, void* data, size_t size) {
+    furi_assert(journal);
+    furi_assert(key);
+    furi_assert(data);
+
+    furi_check(osMutexAcquire(journal->mutex, osWaitForever) == osOK);
+    settings_journal_load(journal);
+    SettingsJournalEntry* entry = settings_journal_find(journal, key, strlen(key));
+    bool result = entry && entry->size && (entry->size == size);
+    if(result) {
+        memcpy(data, entry->value, size);
+    }
+    furi_check(osMutexRelease(journal->mutex) == osOK);
+
+    return result;
+}
+
+bool settings_journal_set(
+    SettingsJournal* journal,
+    const char* key,
+    const void* data,
+    size_t size) {
+    furi_assert(journal);
+    furi_assert(key);
+    furi_assert(data);
+    size_t key_size = strlen(key);
+    furi_check(key_size && (key_size <= SETTINGS_JOURNAL_KEY_SIZE_MAX));
+    furi_check(size && (size <= SETTINGS_JOURNAL_VALUE_SIZE_MAX));
+
+    furi_check(osMutexAcquire(journal->mutex, osWaitForever) == osOK);
+    // Value staged before load would be mixed with stored records of the same key
+    if(!settings_journal_load(journal)) {
+        furi_check(osMutexRelease(journal->mutex) == osOK);
+        return false;
+    }
+
+    SettingsJournalEntry* entry = settings_journal_find(journal, key, key_size);
+    if(!entry) entry = settings_journal_add(journal, key, key_size);
+
+    const uint8_t* source = data;
+    size_t start = 0;
+    size_t end = size;
+    if(entry->size != size) {
+        free(entry->value);
+        entry->value = malloc(size);
+        entry->size = size;
+        entry->staged = false;
+    } else {
+        // Only changed range is written
+        while((start < size) && (entry->value[start] == source[start])) start++;
+        while((end > start) && (entry->value[end - 1] == source[end - 1])) end--;
+    }
+
+    if(start < end) {
+        memcpy(&entry->value[start], &source[start], end - start);
+        if(entry->staged) {
+            entry->staged_start = MIN(entry->staged_start, start);
+            entry->staged_end = MAX(entry->staged_end, end);
+        } else {
+            entry->staged = true;
+            entry->staged_start = start;
+            entry->staged_end = end;
+        }
+    }
+
+    furi_check(osMutexRelease(journal->mutex) == osOK);
+    return true;
+}
+
+bool settings_journal_commit(SettingsJournal* journal) {
+    furi_assert(journal);
+
+    furi_check(osMutexAcquire(journal->mutex, osWaitForever) == osOK);
+    // Staged changes are kept until journal can be read
+    bool result = settings_journal_load(journal);
+    uint32_t start = DWT->CYCCNT;
+
+    size_t size = 0;
+    size_t records = 0;
+    size_t changed = 0;
+    for(size_t i = 0; i < journal->entries_count; i++) {
+        SettingsJournalEntry* entry = &journal->entries[i];
+        if(!entry->staged) continue;
+        size_t range = entry->staged_end - entry->staged_start;
+        changed += range;
+        size += sizeof(SettingsJournalRecord) + strlen(entry->key) + range;
+        records++;
+    }
+
+    if(result && records) {
+        if(journal->stats.file_size == 0) size += sizeof(SettingsJournalHeader);
+        uint8_t* buffer = malloc(size);
+        size_t position = 0;
+        if(journal->stats.file_size == 0) position += settings_journal_header_put(buffer);
+        size_t left = records;
+        for(size_t i = 0; i < journal->entries_count; i++) {
+            SettingsJournalEntry* entry = &journal->entries[i];
+            if(!entry->staged) continue;
+            uint8_t flags = (--left == 0) ? SETTINGS_JOURNAL_RECORD_FLAG_COMMIT : 0;
+            position += settings_journal_record_put(
+                &buffer[position],
+                entry,
+                entry->staged_start,
+                entry->staged_end - entry->staged_start,
+                flags);
+        }
+        furi_assert(position == size);
+
+        if(journal->broken) {
+            result = settings_journal_compact(journal);
+        } else {
+            result = settings_journal_append(journal, buffer, size);
+            if(result) {
+                journal->stats.file_size += size;
+                journal->stats.bytes_written += size;
+                for(size_t i = 0; i < journal->entries_count; i++) {
+                    journal->entries[i].staged = false;
+                }
+            } else if(journal->broken) {
+                result = settings_journal_compact(journal);
+            }
+        }
+        free(buffer);
+
+        if(result) {
+            journal->stats.commits++;
+            journal->stats.records += records;
+            journal->stats.bytes_changed += changed;
+
+            // Commit is already stored, failed compaction is retried on next commit
+            size_t content_size = settings_journal_get_content_size(journal);
+            if((journal->stats.file_size > SETTINGS_JOURNAL_COMPACT_SIZE) &&
+               (journal->stats.file_size > content_size * 2)) {
+                settings_journal_compact(journal);
+            }
+        }
+
+        uint32_t time = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
+        journal->stats.commit_time_max = MAX(journal->stats.commit_time_max, time);
+    }
+
+    furi_check(osMutexRelease(journal->mutex) == osOK);
+
+    return result;
+}
+
+void settings_journal_get_stats(SettingsJournal* journal, SettingsJournalStats* stats) {
+    furi_assert(journal);
+    furi_assert(stats);
+
+    furi_check(osMutexAcquire(journal->mutex, osWaitForever) == osOK);
+    *stats = journal->stats;
+    furi_check(osMutexRelease(journal->mutex) == osOK);
+}
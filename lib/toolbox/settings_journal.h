@@ -0,0 +1,96 @@
+/**
+ * @file settings_journal.h
+ * Append-only key-value store for small settings on flash.
+ *
+ * Updates are appended to journal file as CRC32 protected records, only changed bytes of value
+ * are written. Updates staged before commit are written at once and applied all or nothing
+ * after power loss. Journal is compacted into new file when it grows too much.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SETTINGS_JOURNAL_KEY_SIZE_MAX (255)
+#define SETTINGS_JOURNAL_VALUE_SIZE_MAX (4096)
+
+typedef struct SettingsJournal SettingsJournal;
+
+typedef struct {
+    uint32_t commits; /**< Successful commits */
+    uint32_t records; /**< Records appended to journal */
+    uint32_t bytes_changed; /**< Value bytes changed by commits */
+    uint32_t bytes_written; /**< Bytes written to storage, including compaction */
+    uint32_t compactions; /**< Journal compactions */
+    uint32_t commit_time_max; /**< Longest commit, us */
+    uint32_t file_size; /**< Current journal size */
+} SettingsJournalStats;
+
+/** Allocate SettingsJournal, journal file is read on first access
+ *
+ * @param path journal file path
+ * @return SettingsJournal instance
+ */
+SettingsJournal* settings_journal_alloc(const char* path);
+
+/** Free SettingsJournal, uncommitted changes are lost
+ *
+ * @param journal SettingsJournal instance
+ */
+void settings_journal_free(SettingsJournal* journal);
+
+/** Get value size
+ *
+ * @param journal SettingsJournal instance
+ * @param key value key
+ * @return value size, 0 if there is no value
+ */
+size_t settings_journal_get_size(SettingsJournal* journal, const char* key);
+
+/** Get value, including staged changes
+ *
+ * @param journal SettingsJournal instance
+ * @param key value key
+ * @param data buffer for value
+ * @param size value size
+ * @return true if value exists and has the same size
+ */
+bool settings_journal_get(SettingsJournal* journal, const char* key, void* data, size_t size);
+
+/** Stage value change, nothing is written until commit
+ *
+ * @param journal SettingsJournal instance
+ * @param key value key, up to SETTINGS_JOURNAL_KEY_SIZE_MAX chars
+ * @param data value
+ * @param size value size, up to SETTINGS_JOURNAL_VALUE_SIZE_MAX bytes
+ * @return true if staged, false if journal file can't be read
+ */
+bool settings_journal_set(
+    SettingsJournal* journal,
+    const char* key,
+    const void* data,
+    size_t size);
+
+/** Write staged changes with one write
+ *
+ * @param journal SettingsJournal instance
+ * @return true if changes are stored, on failure changes stay staged
+ */
+bool settings_journal_commit(SettingsJournal* journal);
+
+/** Get journal statistics
+ *
+ * @param journal SettingsJournal instance
+ * @param stats statistics
+ */
+void settings_journal_get_stats(SettingsJournal* journal, SettingsJournalStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
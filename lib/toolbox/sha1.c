@@ -0,0 +1,141 @@
+#include "sha1.h"
+#include <string.h>
+
+#define SHA1_ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static inline uint32_t sha1_load_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void sha1_store_be32(uint8_t* p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+// Message schedule is kept as 16 word circular buffer
+#define SHA1_W(t) \
+    (w[(t)&15] = SHA1_ROL(w[((t) + 13) & 15] ^ w[((t) + 8) & 15] ^ w[((t) + 2) & 15] ^ w[(t)&15], 1))
+
+#define SHA1_ROUND(a, b, c, d, e, f, k, x)       \
+    do {                                          \
+        e += SHA1_ROL(a, 5) + f(b, c, d) + k + x; \
+        b = SHA1_ROL(b, 30);                      \
+    } while(0)
+
+#define SHA1_F1(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA1_F2(x, y, z) ((x) ^ (y) ^ (z))
+#define SHA1_F3(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+
+static void sha1_process(sha1_context* ctx, const uint8_t data[SHA1_BLOCK_SIZE]) {
+    uint32_t w[16];
+    for(size_t i = 0; i < 16; i++) {
+        w[i] = sha1_load_be32(&data[i * 4]);
+    }
+
+    uint32_t a = ctx->state[0];
+    uint32_t b = ctx->state[1];
+    uint32_t c = ctx->state[2];
+    uint32_t d = ctx->state[3];
+    uint32_t e = ctx->state[4];
+
+    // Five rounds per step rotate variables back into place
+    size_t t = 0;
+    for(; t < 15; t += 5) {
+        SHA1_ROUND(a, b, c, d, e, SHA1_F1, 0x5A827999, w[t]);
+        SHA1_ROUND(e, a, b, c, d, SHA1_F1, 0x5A827999, w[t + 1]);
+        SHA1_ROUND(d, e, a, b, c, SHA1_F1, 0x5A827999, w[t + 2]);
+        SHA1_ROUND(c, d, e, a, b, SHA1_F1, 0x5A827999, w[t + 3]);
+        SHA1_ROUND(b, c, d, e, a, SHA1_F1, 0x5A827999, w[t + 4]);
+    }
+    SHA1_ROUND(a, b, c, d, e, SHA1_F1, 0x5A827999, w[15]);
+    SHA1_ROUND(e, a, b, c, d, SHA1_F1, 0x5A827999, SHA1_W(16));
+    SHA1_ROUND(d, e, a, b, c, SHA1_F1, 0x5A827999, SHA1_W(17));
+    SHA1_ROUND(c, d, e, a, b, SHA1_F1, 0x5A827999, SHA1_W(18));
+    SHA1_ROUND(b, c, d, e, a, SHA1_F1, 0x5A827999, SHA1_W(19));
+    for(t = 20; t < 40; t += 5) {
+        SHA1_ROUND(a, b, c, d, e, SHA1_F2, 0x6ED9EBA1, SHA1_W(t));
+        SHA1_ROUND(e, a, b, c, d, SHA1_F2, 0x6ED9EBA1, SHA1_W(t + 1));
+        SHA1_ROUND(d, e, a, b, c, SHA1_F2, 0x6ED9EBA1, SHA1_W(t + 2));
+        SHA1_ROUND(c, d, e, a, b, SHA1_F2, 0x6ED9EBA1, SHA1_W(t + 3));
+        SHA1_ROUND(b, c, d, e, a, SHA1_F2, 0x6ED9EBA1, SHA1_W(t + 4));
+    }
+    for(; t < 60; t += 5) {
+        SHA1_ROUND(a, b, c, d, e, SHA1_F3, 0x8F1BBCDC, SHA1_W(t));
+        SHA1_ROUND(e, a, b, c, d, SHA1_F3, 0x8F1BBCDC, SHA1_W(t + 1));
+        SHA1_ROUND(d, e, a, b, c, SHA1_F3, 0x8F1BBCDC, SHA1_W(t + 2));
+        SHA1_ROUND(c, d, e, a, b, SHA1_F3, 0x8F1BBCDC, SHA1_W(t + 3));
+        SHA1_ROUND(b, c, d, e, a, SHA1_F3, 0x8F1BBCDC, SHA1_W(t + 4));
+    }
+    for(; t < 80; t += 5) {
+        SHA1_ROUND(a, b, c, d, e, SHA1_F2, 0xCA62C1D6, SHA1_W(t));
+        SHA1_ROUND(e, a, b, c, d, SHA1_F2, 0xCA62C1D6, SHA1_W(t + 1));
+        SHA1_ROUND(d, e, a, b, c, SHA1_F2, 0xCA62C1D6, SHA1_W(t + 2));
+        SHA1_ROUND(c, d, e, a, b, SHA1_F2, 0xCA62C1D6, SHA1_W(t + 3));
+        SHA1_ROUND(b, c, d, e, a, SHA1_F2, 0xCA62C1D6, SHA1_W(t + 4));
+    }
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+}
+
+void sha1_starts(sha1_context* ctx) {
+    ctx->total[0] = 0;
+    ctx->total[1] = 0;
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xEFCDAB89;
+    ctx->state[2] = 0x98BADCFE;
+    ctx->state[3] = 0x10325476;
+    ctx->state[4] = 0xC3D2E1F0;
+}
+
+void sha1_update(sha1_context* ctx, const uint8_t* input, size_t ilen) {
+    size_t left = ctx->total[0] & (SHA1_BLOCK_SIZE - 1);
+    size_t fill = SHA1_BLOCK_SIZE - left;
+
+    ctx->total[0] += ilen;
+    if(ctx->total[0] < ilen) ctx->total[1]++;
+
+    if(left && ilen >= fill) {
+        memcpy(&ctx->buffer[left], input, fill);
+        sha1_process(ctx, ctx->buffer);
+        input += fill;
+        ilen -= fill;
+        left = 0;
+    }
+
+    // Whole blocks are processed in place
+    for(; ilen >= SHA1_BLOCK_SIZE; ilen -= SHA1_BLOCK_SIZE) {
+        sha1_process(ctx, input);
+        input += SHA1_BLOCK_SIZE;
+    }
+
+    memcpy(&ctx->buffer[left], input, ilen);
+}
+
+void sha1_finish(sha1_context* ctx, uint8_t output[SHA1_DIGEST_SIZE]) {
+    uint8_t length[8];
+    sha1_store_be32(&length[0], (ctx->total[0] >> 29) | (ctx->total[1] << 3));
+    sha1_store_be32(&length[4], ctx->total[0] << 3);
+
+    static const uint8_t padding[SHA1_BLOCK_SIZE] = {0x80};
+    size_t last = ctx->total[0] & (SHA1_BLOCK_SIZE - 1);
+    size_t padding_size = (last < 56) ? (56 - last) : (120 - last);
+    sha1_update(ctx, padding, padding_size);
+    sha1_update(ctx, length, sizeof(length));
+
+    for(size_t i = 0; i < 5; i++) {
+        sha1_store_be32(&output[i * 4], ctx->state[i]);
+    }
+}
+
+void sha1(const uint8_t* input, size_t ilen, uint8_t output[SHA1_DIGEST_SIZE]) {
+    sha1_context ctx;
+    sha1_starts(&ctx);
+    sha1_update(&ctx, input, ilen);
+    sha1_finish(&ctx, output);
+}
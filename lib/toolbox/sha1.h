@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA1_DIGEST_SIZE 20
+#define SHA1_BLOCK_SIZE 64
+
+typedef struct {
+    uint32_t total[2]; /**< bytes processed */
+    uint32_t state[5]; /**< intermediate digest state */
+    uint8_t buffer[SHA1_BLOCK_SIZE]; /**< partial block */
+} sha1_context;
+
+/** Start SHA-1 calculation
+ *
+ * @param ctx context
+ */
+void sha1_starts(sha1_context* ctx);
+
+/** Process data
+ *
+ * @param ctx context
+ * @param input data
+ * @param ilen data size
+ */
+void sha1_update(sha1_context* ctx, const uint8_t* input, size_t ilen);
+
+/** Finish calculation, context must be started again before reuse
+ *
+ * @param ctx context
+ * @param output digest
+ */
+void sha1_finish(sha1_context* ctx, uint8_t output[SHA1_DIGEST_SIZE]);
+
+/** Calculate SHA-1 of buffer
+ *
+ * @param input data
+ * @param ilen data size
+ * @param output digest
+ */
+void sha1(const uint8_t* input, size_t ilen, uint8_t output[SHA1_DIGEST_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,67 @@
+#include "triple_buffer.h"
+#include <furi.h>
+
+#define TRIPLE_BUFFER_INDEX_MASK (0x03)
+#define TRIPLE_BUFFER_FRESH (0x04)
+
+struct TripleBuffer {
+    uint8_t* data;
+    size_t size;
+    // Owned by producer
+    uint8_t back;
+    // Owned by consumer
+    uint8_t front;
+    // Exchanged by both, buffer index and fresh flag
+    uint8_t middle;
+};
+
+TripleBuffer* triple_buffer_alloc(size_t size) {
+    TripleBuffer* instance = malloc(sizeof(TripleBuffer));
+    instance->data = malloc(size * 3);
+    memset(instance->data, 0, size * 3);
+    instance->size = size;
+    instance->back = 0;
+    instance->middle = 1;
+    instance->front = 2;
+    return instance;
+}
+
+void triple_buffer_free(TripleBuffer* instance) {
+    furi_assert(instance);
+    free(instance->data);
+    free(instance);
+}
+
+void* triple_buffer_get_back(TripleBuffer* instance) {
+    furi_assert(instance);
+    return &instance->data[instance->back * instance->size];
+}
+
+bool triple_buffer_publish(TripleBuffer* instance) {
+    furi_assert(instance);
+
+    uint8_t published = instance->back;
+    uint8_t previous = __atomic_exchange_n(
+        &instance->middle, published | TRIPLE_BUFFER_FRESH, __ATOMIC_ACQ_REL);
+    instance->back = previous & TRIPLE_BUFFER_INDEX_MASK;
+
+    // Consumer only reads published buffer, so it can be copied to continue from it
+    memcpy(
+        &instance->data[instance->back * instance->size],
+        &instance->data[published * instance->size],
+        instance->size);
+
+    return previous & TRIPLE_BUFFER_FRESH;
+}
+
+void* triple_buffer_get_front(TripleBuffer* instance) {
+    furi_assert(instance);
+
+    if(__atomic_load_n(&instance->middle, __ATOMIC_ACQUIRE) & TRIPLE_BUFFER_FRESH) {
+        uint8_t previous =
+            __atomic_exchange_n(&instance->middle, instance->front, __ATOMIC_ACQ_REL);
+        instance->front = previous & TRIPLE_BUFFER_INDEX_MASK;
+    }
+
+    return &instance->data[instance->front * instance->size];
+}
@@ -0,0 +1,59 @@
+/**
+ * @file triple_buffer.h
+ * Wait-free single producer, single consumer snapshot exchange.
+ *
+ * Producer writes back buffer and publishes it, consumer takes the latest published buffer.
+ * Neither side waits for other one: buffers are exchanged by atomic swap of middle buffer index.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TripleBuffer TripleBuffer;
+
+/** Allocate TripleBuffer, all buffers are zeroed
+ *
+ * @param size buffer size
+ * @return TripleBuffer instance
+ */
+TripleBuffer* triple_buffer_alloc(size_t size);
+
+/** Free TripleBuffer
+ *
+ * @param instance TripleBuffer instance
+ */
+void triple_buffer_free(TripleBuffer* instance);
+
+/** Get buffer for producer
+ * Buffer holds the latest published data, so it can be updated partially.
+ *
+ * @param instance TripleBuffer instance
+ * @return pointer to back buffer
+ */
+void* triple_buffer_get_back(TripleBuffer* instance);
+
+/** Publish back buffer
+ *
+ * @param instance TripleBuffer instance
+ * @return true if previous published buffer was not taken by consumer
+ */
+bool triple_buffer_publish(TripleBuffer* instance);
+
+/** Get the latest published buffer for consumer
+ * Buffer stays valid and unchanged until next call.
+ *
+ * @param instance TripleBuffer instance
+ * @return pointer to front buffer
+ */
+void* triple_buffer_get_front(TripleBuffer* instance);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+
+import json
+import struct
+
+from flipper.app import App
+
+
+TRACE_MAGIC = 0x43525446
+TRACE_VERSION = 1
+TRACE_DEFAULT_PATH = "/int/.trace"
+
+HEADER_FORMAT = "<IHHIIIIII"
+RECORD_FORMAT = "<IIII"
+THREAD_FORMAT = "<I16s"
+NAME_FORMAT = "<I32s"
+
+# FuriTraceId, keep in sync with core/furi/trace.h
+(
+    ID_NONE,
+    ID_TASK_SWITCHED_IN,
+    ID_ISR_ENTER,
+    ID_ISR_EXIT,
+    ID_MUTEX_WAIT,
+    ID_MUTEX_TAKE,
+    ID_MUTEX_TIMEOUT,
+    ID_SLEEP,
+    ID_SLEEP_TICKS,
+    ID_INSTANT,
+    ID_BEGIN,
+    ID_END,
+) = range(12)
+
+# Chrome trace layout: threads by TCB number, interrupts and sleep on own tracks
+PID = 1
+TID_INTERRUPTS = 0
+TID_SLEEP = -1
+
+
+class TraceDump:
+    def __init__(self, data: bytes):
+        offset = 0
+        (
+            magic,
+            version,
+            record_size,
+            self.core_clock,
+            self.tick_freq,
+            records,
+            self.lost,
+            threads,
+            names,
+        ) = struct.unpack_from(HEADER_FORMAT, data, offset)
+        if magic != TRACE_MAGIC:
+            raise Exception("Not a trace dump")
+        if version != TRACE_VERSION or record_size != struct.calcsize(RECORD_FORMAT):
+            raise Exception(f"Unsupported dump version {version}")
+        offset += struct.calcsize(HEADER_FORMAT)
+
+        self.records = []
+        for _ in range(records):
+            self.records.append(struct.unpack_from(RECORD_FORMAT, data, offset))
+            offset += record_size
+
+        self.threads = {}
+        for _ in range(threads):
+            number, name = struct.unpack_from(THREAD_FORMAT, data, offset)
+            self.threads[number] = self._cstr(name)
+            offset += struct.calcsize(THREAD_FORMAT)
+
+        self.names = {}
+        for _ in range(names):
+            pointer, name = struct.unpack_from(NAME_FORMAT, data, offset)
+            self.names[pointer] = self._cstr(name)
+            offset += struct.calcsize(NAME_FORMAT)
+
+    @staticmethod
+    def _cstr(data: bytes):
+        return data.split(b"\0", 1)[0].decode("ascii", errors="replace")
+
+
+class ChromeTrace:
+    def __init__(self, dump: TraceDump):
+        self.dump = dump
+        self.events = []
+        self.thread_names = dict(dump.threads)
+
+    def _us(self, cycles):
+        return cycles * 1000000 / self.dump.core_clock
+
+    def _event(self, phase, name, tid, cycles, **kwargs):
+        event = {
+            "ph": phase,
+            "name": name,
+            "pid": PID,
+            "tid": tid,
+            "ts": self._us(cycles),
+        }
+        event.update(kwargs)
+        self.events.append(event)
+
+    def _complete(self, name, tid, begin, end, **kwargs):
+        self._event("X", name, tid, begin, dur=self._us(end - begin), **kwargs)
+
+    def _timeline(self):
+        # Unwrap 32-bit cycle counter, preempting writers may be slightly out of order
+        cycles_per_tick = self.dump.core_clock / self.dump.tick_freq
+        timeline = []
+        last_raw = None
+        now = 0
+        sleep_offset = 0
+        sleep_begin = None
+        for timestamp, id, arg0, arg1 in self.dump.records:
+            if last_raw is not None:
+                delta = (timestamp - last_raw) & 0xFFFFFFFF
+                if delta >= 0x80000000:
+                    delta -= 0x100000000
+                now += delta
+            last_raw = timestamp
+            if id == ID_SLEEP:
+                sleep_begin = now
+            elif id == ID_SLEEP_TICKS and sleep_begin is not None:
+                # Cycle counter was stopped, ticks tell how long core slept
+                slept = arg0 * cycles_per_tick - (now - sleep_begin)
+                if slept > 0:
+                    begin = now + sleep_offset
+                    self._complete("sleep", TID_SLEEP, begin, begin + slept)
+                    sleep_offset += slept
+                sleep_begin = None
+            timeline.append((now + sleep_offset, id, arg0, arg1))
+        timeline.sort(key=lambda record: record[0])
+        return timeline
+
+    def _thread_name(self, number, name_head):
+        if number not in self.thread_names:
+            name = TraceDump._cstr(struct.pack("<I", name_head))
+            self.thread_names[number] = f"{name} ({number})"
+        return self.thread_names[number]
+
+    def _event_name(self, pointer):
+        return self.dump.names.get(pointer, f"0x{pointer:08x}")
+
+    def convert(self):
+        thread = None
+        thread_begin = None
+        isr_stack = []
+        mutex_waits = {}
+        last = 0
+
+        for now, id, arg0, arg1 in self._timeline():
+            last = now
+            tid = TID_INTERRUPTS if isr_stack else thread
+            if id == ID_TASK_SWITCHED_IN:
+                if thread is not None:
+                    self._complete("running", thread, thread_begin, now)
+                thread = arg0
+                thread_begin = now
+                self._thread_name(arg0, arg1)
+            elif id == ID_ISR_ENTER:
+                isr_stack.append((arg0, now))
+            elif id == ID_ISR_EXIT:
+                # Records from before dump start may miss their enter
+                if isr_stack and isr_stack[-1][0] == arg0:
+                    _, begin = isr_stack.pop()
+                    self._complete(f"IRQ {arg0 - 16}", TID_INTERRUPTS, begin, now)
+            elif id == ID_MUTEX_WAIT and thread is not None:
+                mutex_waits[(thread, arg0)] = now
+            elif id in (ID_MUTEX_TAKE, ID_MUTEX_TIMEOUT) and thread is not None:
+                begin = mutex_waits.pop((thread, arg0), None)
+                if begin is not None:
+                    result = "taken" if id == ID_MUTEX_TAKE else "timeout"
+                    name = f"mutex 0x{arg0:08x}"
+                    self._complete(name, thread, begin, now, args={"result": result})
+            elif id in (ID_INSTANT, ID_BEGIN, ID_END) and tid is not None:
+                phase = {ID_INSTANT: "i", ID_BEGIN: "B", ID_END: "E"}[id]
+                extra = {"s": "t"} if id == ID_INSTANT else {}
+                name = self._event_name(arg0)
+                self._event(phase, name, tid, now, args={"value": arg1}, **extra)
+
+        if thread is not None:
+            self._complete("running", thread, thread_begin, last)
+
+        metadata = [(TID_INTERRUPTS, "Interrupts"), (TID_SLEEP, "Sleep")]
+        metadata += list(self.thread_names.items())
+        for tid, name in metadata:
+            self._event("M", "thread_name", tid, 0, args={"name": name})
+
+        return {
+            "traceEvents": self.events,
+            "displayTimeUnit": "ns",
+            "otherData": {
+                "core_clock": self.dump.core_clock,
+                "records": len(self.dump.records),
+                "lost": self.dump.lost,
+            },
+        }
+
+
+class Main(App):
+    def init(self):
+        self.subparsers = self.parser.add_subparsers(help="sub-command help")
+
+        self.parser_convert = self.subparsers.add_parser(
+            "convert", help="Convert dump to Chrome trace JSON"
+        )
+        self.parser_convert.add_argument("input", help="Dump saved by `trace save`")
+        self.parser_convert.add_argument("output", help="Chrome trace JSON")
+        self.parser_convert.set_defaults(func=self.convert)
+
+        self.parser_capture = self.subparsers.add_parser(
+            "capture", help="Save dump on Flipper, receive and convert it"
+        )
+        self.parser_capture.add_argument("-p", "--port", help="CDC Port", required=True)
+        self.parser_capture.add_argument(
+            "-f",
+            "--flipper_path",
+            help="Dump path on Flipper",
+            default=TRACE_DEFAULT_PATH,
+        )
+        self.parser_capture.add_argument("output", help="Chrome trace JSON")
+        self.parser_capture.set_defaults(func=self.capture)
+
+    def _write(self, data: bytes):
+        dump = TraceDump(data)
+        records, threads = len(dump.records), len(dump.threads)
+        self.logger.info(f"{records} records, {dump.lost} lost, {threads} threads")
+        with open(self.args.output, "w") as file:
+            json.dump(ChromeTrace(dump).convert(), file)
+        self.logger.info(f"Open {self.args.output} in ui.perfetto.dev")
+        return 0
+
+    def convert(self):
+        with open(self.args.input, "rb") as file:
+            return self._write(file.read())
+
+    def capture(self):
+        from flipper.storage import FlipperStorage
+
+        storage = FlipperStorage(self.args.port)
+        storage.start()
+        command = f'trace save "{self.args.flipper_path}"\r'
+        answer = storage.send_and_wait_prompt(command)
+        self.logger.debug(answer)
+        data = storage.read_file(self.args.flipper_path)
+        storage.stop()
+        if not data:
+            self.logger.error(f"Can't read dump: {storage.last_error}")
+            return 1
+        return self._write(bytes(data))
+
+
+if __name__ == "__main__":
+    Main()()